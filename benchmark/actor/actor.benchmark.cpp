@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+class Receiver {
+public:
+    Receiver(util::RunLoop& loop_)
+        : loop(loop_) {
+    }
+
+    void pong() {
+        if (++received == expected) {
+            loop.stop();
+        }
+    }
+
+    util::RunLoop& loop;
+    int64_t expected = 0;
+    int64_t received = 0;
+};
+
+class Echo {
+public:
+    Echo(ActorRef<Echo>, ActorRef<Receiver> receiver_)
+        : receiver(std::move(receiver_)) {
+    }
+
+    void ping() {
+        receiver.invoke(&Receiver::pong);
+    }
+
+    ActorRef<Receiver> receiver;
+};
+
+} // end namespace
+
+// Round trips between an actor on the main RunLoop and an actor on a ThreadPool.
+static void Actor_RoundTrip(::benchmark::State& state) {
+    util::RunLoop loop;
+    ThreadPool threadPool{ 1 };
+
+    Receiver receiver(loop);
+    auto mailbox = std::make_shared<Mailbox>(loop);
+    Actor<Echo> echo(threadPool, ActorRef<Receiver>(receiver, mailbox));
+
+    while (state.KeepRunning()) {
+        receiver.expected = state.range_x();
+        receiver.received = 0;
+
+        for (int64_t i = 0; i < state.range_x(); ++i) {
+            echo.invoke(&Echo::ping);
+        }
+
+        loop.run();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+// One-way throughput of many producers into a single ThreadPool actor.
+static void Actor_Throughput(::benchmark::State& state) {
+    struct Counter {
+        Counter(ActorRef<Counter>) {}
+
+        void count(std::promise<void>* done, int64_t target) {
+            if (++received == target) {
+                done->set_value();
+            }
+        }
+
+        int64_t received = 0;
+    };
+
+    ThreadPool threadPool{ 1 };
+    Actor<Counter> counter(threadPool);
+
+    int64_t total = 0;
+    while (state.KeepRunning()) {
+        std::promise<void> done;
+        std::future<void> future = done.get_future();
+
+        std::vector<std::thread> producers;
+        for (int n = 0; n < 4; ++n) {
+            producers.emplace_back([&] {
+                for (int64_t i = 0; i < state.range_x(); ++i) {
+                    counter.invoke(&Counter::count, &done, total + 4 * state.range_x());
+                }
+            });
+        }
+
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        future.wait();
+        total += 4 * state.range_x();
+    }
+
+    state.SetItemsProcessed(total);
+}
+
+BENCHMARK(Actor_RoundTrip)->Arg(1)->Arg(100)->Arg(10000);
+BENCHMARK(Actor_Throughput)->Arg(10000);
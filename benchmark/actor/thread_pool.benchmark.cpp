@@ -0,0 +1,312 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+ThreadPool::Strategy strategy(const ::benchmark::State& state) {
+    return state.range(1) ? ThreadPool::Strategy::WorkStealing : ThreadPool::Strategy::SharedQueue;
+}
+
+std::string label(const ::benchmark::State& state) {
+    return util::toString(state.range(0)) + " threads, " +
+        (state.range(1) ? "work stealing" : "shared queue");
+}
+
+// CPU work of roughly a microsecond per unit, that can't be optimized away.
+uint64_t work(std::size_t units) {
+    uint64_t x = units;
+    for (std::size_t i = 0; i < units * 300; i++) {
+        x = x * 6364136223846793005u + 1442695040888963407u;
+    }
+    return x;
+}
+
+// Signals a promise once it has been counted down to zero, from any thread.
+class Countdown {
+public:
+    explicit Countdown(int64_t count)
+        : remaining(count) {
+    }
+
+    void countDown() {
+        if (--remaining == 0) {
+            done.set_value();
+        }
+    }
+
+    void wait() {
+        done.get_future().wait();
+    }
+
+private:
+    std::atomic<int64_t> remaining;
+    std::promise<void> done;
+};
+
+class Player {
+public:
+    Player(ActorRef<Player>) {
+    }
+
+    void setPartner(ActorRef<Player> partner_) {
+        partner.emplace(partner_);
+    }
+
+    void ball(int64_t remaining, Countdown* countdown) {
+        if (remaining == 0) {
+            countdown->countDown();
+        } else {
+            partner->invoke(&Player::ball, remaining - 1, countdown);
+        }
+    }
+
+    optional<ActorRef<Player>> partner;
+};
+
+class Worker {
+public:
+    Worker(ActorRef<Worker>, std::vector<Duration>* latencies_ = nullptr)
+        : latencies(latencies_) {
+    }
+
+    // Records how long the message waited for its turn, if the worker has somewhere to.
+    void process(TimePoint sent, std::size_t units, Countdown* countdown) {
+        if (latencies) {
+            latencies->push_back(Clock::now() - sent);
+        }
+        result += work(units);
+        countdown->countDown();
+    }
+
+    std::vector<Duration>* latencies;
+    uint64_t result = 0;
+};
+
+template <class T>
+T percentile(std::vector<T> values, double p) {
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, std::size_t(p * values.size()))];
+}
+
+double microseconds(Duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+// The phases of a `GeometryTileWorker`: it waits for both the layers and the data of its
+// tile, lays out the buckets, and sends them to the tile on the main thread, which then
+// requests the placement of the symbols.
+class TileWorker;
+
+class TileParent {
+public:
+    TileParent(util::RunLoop& loop_, std::size_t tiles_)
+        : loop(loop_), tiles(tiles_) {
+    }
+
+    void onLayout(std::size_t tile);
+    void onPlacement() {
+        if (++placed == tiles) {
+            loop.stop();
+        }
+    }
+
+    util::RunLoop& loop;
+    const std::size_t tiles;
+    std::size_t placed = 0;
+    std::vector<std::unique_ptr<Actor<TileWorker>>>* workers = nullptr;
+};
+
+class TileWorker {
+public:
+    TileWorker(ActorRef<TileWorker>, ActorRef<TileParent> parent_, std::size_t tile_)
+        : parent(std::move(parent_)), tile(tile_) {
+    }
+
+    void setLayers() {
+        result += work(5);
+        hasLayers = true;
+        layout();
+    }
+
+    void setData() {
+        result += work(50);
+        hasData = true;
+        layout();
+    }
+
+    void setPlacementConfig() {
+        result += work(30);
+        parent.invoke(&TileParent::onPlacement);
+    }
+
+private:
+    void layout() {
+        if (hasLayers && hasData) {
+            result += work(150);
+            parent.invoke(&TileParent::onLayout, tile);
+        }
+    }
+
+    ActorRef<TileParent> parent;
+    const std::size_t tile;
+    bool hasLayers = false;
+    bool hasData = false;
+    uint64_t result = 0;
+};
+
+void TileParent::onLayout(std::size_t tile) {
+    (*workers)[tile]->invoke(&TileWorker::setPlacementConfig);
+}
+
+} // end namespace
+
+// A message bouncing between two actors on the pool: the latency of handing a mailbox from
+// one thread to another, with the pool's other threads idle.
+static void ThreadPool_PingPong(::benchmark::State& state) {
+    ThreadPool threadPool(state.range(0), strategy(state));
+    Actor<Player> a(threadPool);
+    Actor<Player> b(threadPool);
+    a.invoke(&Player::setPartner, b.self());
+    b.invoke(&Player::setPartner, a.self());
+
+    const int64_t roundTrips = 1000;
+    while (state.KeepRunning()) {
+        Countdown countdown(1);
+        a.invoke(&Player::ball, 2 * roundTrips, &countdown);
+        countdown.wait();
+    }
+
+    state.SetLabel(label(state));
+    state.SetItemsProcessed(state.iterations() * roundTrips);
+}
+
+// Messages with a few microseconds of work each, sent from the main thread to many mailboxes.
+static void ThreadPool_FanOut(::benchmark::State& state) {
+    ThreadPool threadPool(state.range(0), strategy(state));
+    const std::size_t mailboxes = 1024;
+    const std::size_t messages = 16;
+
+    std::vector<std::unique_ptr<Actor<Worker>>> workers;
+    for (std::size_t i = 0; i < mailboxes; i++) {
+        workers.push_back(std::make_unique<Actor<Worker>>(threadPool));
+    }
+
+    while (state.KeepRunning()) {
+        Countdown countdown(mailboxes * messages);
+        for (std::size_t i = 0; i < messages; i++) {
+            for (auto& worker : workers) {
+                worker->invoke(&Worker::process, Clock::now(), 4, &countdown);
+            }
+        }
+        countdown.wait();
+    }
+
+    state.SetLabel(label(state));
+    state.SetItemsProcessed(state.iterations() * mailboxes * messages);
+}
+
+// A few busy mailboxes with most of the messages and of the work, and many light ones. The
+// label holds the percentiles of the time the light ones' messages waited for their turn.
+static void ThreadPool_SkewedLoad(::benchmark::State& state) {
+    ThreadPool threadPool(state.range(0), strategy(state));
+    const std::size_t heavyMailboxes = 4;
+    const std::size_t heavyMessages = 500;
+    const std::size_t lightMailboxes = 60;
+    const std::size_t lightMessages = 5;
+
+    std::vector<std::unique_ptr<Actor<Worker>>> heavy;
+    for (std::size_t i = 0; i < heavyMailboxes; i++) {
+        heavy.push_back(std::make_unique<Actor<Worker>>(threadPool));
+    }
+
+    // Only written by the light mailboxes, and read once they are done.
+    std::vector<std::vector<Duration>> latencies(lightMailboxes);
+    std::vector<std::unique_ptr<Actor<Worker>>> light;
+    for (std::size_t i = 0; i < lightMailboxes; i++) {
+        light.push_back(std::make_unique<Actor<Worker>>(threadPool, &latencies[i]));
+    }
+
+    while (state.KeepRunning()) {
+        Countdown countdown(heavyMailboxes * heavyMessages + lightMailboxes * lightMessages);
+        for (std::size_t i = 0; i < heavyMessages; i++) {
+            for (auto& worker : heavy) {
+                worker->invoke(&Worker::process, Clock::now(), 20, &countdown);
+            }
+            if (i % (heavyMessages / lightMessages) == 0) {
+                for (auto& worker : light) {
+                    worker->invoke(&Worker::process, Clock::now(), 1, &countdown);
+                }
+            }
+        }
+        countdown.wait();
+    }
+
+    std::vector<Duration> waits;
+    for (const auto& mailboxLatencies : latencies) {
+        waits.insert(waits.end(), mailboxLatencies.begin(), mailboxLatencies.end());
+    }
+
+    state.SetLabel(label(state) + ", light messages waited " +
+                   util::toString(microseconds(percentile(waits, 0.50))) + " us (p50), " +
+                   util::toString(microseconds(percentile(waits, 0.99))) + " us (p99)");
+    state.SetItemsProcessed(state.iterations() * (heavyMailboxes * heavyMessages + lightMailboxes * lightMessages));
+}
+
+// Tiles loading at once, each with a worker going through the phases of a
+// `GeometryTileWorker`, with a tile on the main RunLoop for each.
+static void ThreadPool_TileWorkers(::benchmark::State& state) {
+    ThreadPool threadPool(state.range(0), strategy(state));
+    util::RunLoop loop;
+    const std::size_t tiles = 64;
+
+    while (state.KeepRunning()) {
+        TileParent parent(loop, tiles);
+        auto mailbox = std::make_shared<Mailbox>(loop);
+        std::vector<std::unique_ptr<Actor<TileWorker>>> workers;
+        parent.workers = &workers;
+        for (std::size_t i = 0; i < tiles; i++) {
+            workers.push_back(std::make_unique<Actor<TileWorker>>(
+                threadPool, ActorRef<TileParent>(parent, mailbox), i));
+        }
+
+        for (auto& worker : workers) {
+            worker->invoke(&TileWorker::setLayers);
+            worker->invoke(&TileWorker::setData);
+        }
+        loop.run();
+
+        state.PauseTiming();
+        workers.clear();
+        state.ResumeTiming();
+    }
+
+    state.SetLabel(label(state));
+    state.SetItemsProcessed(state.iterations() * tiles);
+}
+
+static void ThreadCounts(::benchmark::internal::Benchmark* b) {
+    for (int threads : { 1, 2, 4, 8, 16, 32 }) {
+        b->ArgPair(threads, false);
+        b->ArgPair(threads, true);
+    }
+}
+
+BENCHMARK(ThreadPool_PingPong)->Apply(ThreadCounts)->UseRealTime();
+BENCHMARK(ThreadPool_FanOut)->Apply(ThreadCounts)->UseRealTime();
+BENCHMARK(ThreadPool_SkewedLoad)->Apply(ThreadCounts)->UseRealTime();
+BENCHMARK(ThreadPool_TileWorkers)->Apply(ThreadCounts)->UseRealTime();
@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/annotation/annotation_manager.hpp>
+#include <mbgl/util/geo.hpp>
+
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+constexpr std::size_t markerCount = 200000;
+
+// Markers spread over the map on a grid.
+std::vector<Annotation> markers() {
+    std::vector<Annotation> annotations;
+    annotations.reserve(markerCount);
+    for (std::size_t i = 0; i < markerCount; ++i) {
+        const double longitude = -180.0 + 360.0 * (i % 500) / 500;
+        const double latitude = -80.0 + 160.0 * (i / 500) / (markerCount / 500);
+        annotations.push_back(SymbolAnnotation { Point<double> { longitude, latitude }, "default_marker" });
+    }
+    return annotations;
+}
+
+} // end namespace
+
+static void Annotations_AddOneByOne(::benchmark::State& state) {
+    const auto annotations = markers();
+
+    while (state.KeepRunning()) {
+        AnnotationManager manager { 1.0 };
+        for (const auto& annotation : annotations) {
+            manager.addAnnotation(annotation, 18);
+        }
+    }
+}
+
+static void Annotations_AddBulk(::benchmark::State& state) {
+    const auto annotations = markers();
+
+    while (state.KeepRunning()) {
+        AnnotationManager manager { 1.0 };
+        ::benchmark::DoNotOptimize(manager.addAnnotations(annotations, 18));
+    }
+}
+
+static void Annotations_QuerySymbols(::benchmark::State& state) {
+    AnnotationManager manager { 1.0 };
+    manager.addAnnotations(markers(), 18);
+    const LatLngBounds bounds = LatLngBounds::hull({ 40, -74 }, { 41, -73 });
+
+    while (state.KeepRunning()) {
+        ::benchmark::DoNotOptimize(manager.querySymbolAnnotations(bounds));
+    }
+}
+
+BENCHMARK(Annotations_AddOneByOne);
+BENCHMARK(Annotations_AddBulk);
+BENCHMARK(Annotations_QuerySymbols);
@@ -1,5 +1,6 @@
 #include <benchmark/benchmark.h>
 
+#include <mbgl/benchmark/allocations.hpp>
 #include <mbgl/benchmark/util.hpp>
 #include <mbgl/map/map.hpp>
 #include <mbgl/gl/headless_backend.hpp>
@@ -46,27 +47,48 @@ public:
 static void API_queryRenderedFeaturesAll(::benchmark::State& state) {
     QueryBenchmark bench;
 
+    mbgl::benchmark::AllocationCounter allocations;
     while (state.KeepRunning()) {
         bench.map.queryRenderedFeatures(bench.box);
     }
+
+    state.SetLabel(allocations.label(state));
 }
 
 static void API_queryRenderedFeaturesLayerFromLowDensity(::benchmark::State& state) {
     QueryBenchmark bench;
 
+    mbgl::benchmark::AllocationCounter allocations;
     while (state.KeepRunning()) {
         bench.map.queryRenderedFeatures(bench.box, {{{ "testlayer" }}, {}});
     }
+
+    state.SetLabel(allocations.label(state));
 }
 
 static void API_queryRenderedFeaturesLayerFromHighDensity(::benchmark::State& state) {
     QueryBenchmark bench;
 
+    mbgl::benchmark::AllocationCounter allocations;
     while (state.KeepRunning()) {
         bench.map.queryRenderedFeatures(bench.box, {{{"road-street" }}, {}});
     }
+
+    state.SetLabel(allocations.label(state));
+}
+
+static void API_queryRenderedFeatureIDsAll(::benchmark::State& state) {
+    QueryBenchmark bench;
+
+    mbgl::benchmark::AllocationCounter allocations;
+    while (state.KeepRunning()) {
+        bench.map.queryRenderedFeatureIDs(bench.box);
+    }
+
+    state.SetLabel(allocations.label(state));
 }
 
 BENCHMARK(API_queryRenderedFeaturesAll);
 BENCHMARK(API_queryRenderedFeaturesLayerFromLowDensity);
 BENCHMARK(API_queryRenderedFeaturesLayerFromHighDensity);
+BENCHMARK(API_queryRenderedFeatureIDsAll);
@@ -0,0 +1,189 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/gl/offscreen_view.hpp>
+#include <mbgl/map/backend_scope.hpp>
+#include <mbgl/map/camera.hpp>
+#include <mbgl/map/frame_stats.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Frames are rendered by the benchmark, one for each camera of the path.
+class FrameBackend : public HeadlessBackend {
+public:
+    void invalidate() override {}
+};
+
+double interpolate(double from, double to, double t) {
+    return from + (to - from) * t;
+}
+
+double ease(double t) {
+    return t * t * (3 - 2 * t);
+}
+
+// A scripted camera path over the lower Manhattan tiles of the fixture cache, at 60 frames
+// per second: a pan, a flight with its zoom arc, a rotation and a pitch and back. The
+// cameras are fixed rather than animated, so every run renders the same frames.
+std::vector<CameraOptions> cameraPath() {
+    constexpr std::size_t segment = 120;
+    std::vector<CameraOptions> path;
+
+    auto add = [&] (double lat, double lng, double zoom, double angle, double pitch) {
+        CameraOptions camera;
+        camera.center = LatLng { lat, lng };
+        camera.zoom = zoom;
+        camera.angle = angle;
+        camera.pitch = pitch;
+        path.push_back(camera);
+    };
+
+    for (std::size_t i = 0; i < segment; i++) {
+        const double t = double(i) / segment;
+        add(40.7265, interpolate(-74.000, -73.986, t), 15.5, 0, 0);
+    }
+
+    for (std::size_t i = 0; i < segment; i++) {
+        const double t = ease(double(i) / segment);
+        add(interpolate(40.7265, 40.7245, t), interpolate(-73.986, -73.997, t),
+            interpolate(15.5, 16.5, t) - 0.5 * std::sin(M_PI * t), 0, 0);
+    }
+
+    for (std::size_t i = 0; i < segment; i++) {
+        const double t = ease(double(i) / segment);
+        add(40.7245, -73.997, 16.5, interpolate(0, M_PI / 2, t), 0);
+    }
+
+    for (std::size_t i = 0; i < segment; i++) {
+        const double t = double(i) / segment;
+        add(40.7245, -73.997, 16.5, M_PI / 2, util::PITCH_MAX * std::sin(M_PI * t));
+    }
+
+    return path;
+}
+
+template <class T>
+T percentile(std::vector<T> values, double p) {
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, std::size_t(p * values.size()))];
+}
+
+template <class T, class Convert>
+std::string percentiles(const std::vector<T>& values, Convert convert) {
+    if (values.empty()) {
+        return "null";
+    }
+    return "{\"p50\":" + util::toString(convert(percentile(values, 0.50))) +
+           ",\"p95\":" + util::toString(convert(percentile(values, 0.95))) +
+           ",\"p99\":" + util::toString(convert(percentile(values, 0.99))) + "}";
+}
+
+double milliseconds(Duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+class RenderBenchmark {
+public:
+    RenderBenchmark() {
+        NetworkStatus::Set(NetworkStatus::Status::Offline);
+        fileSource.setAccessToken("foobar");
+
+        map.setStyleJSON(util::read_file("benchmark/fixtures/api/query_style.json"));
+        map.setFrameStatsCallback([this] (const FrameStats& stats) {
+            Duration total = Duration::zero();
+            for (const auto& section : stats.sections) {
+                total += section.gpuTime;
+            }
+            gpuTimes.push_back(total);
+        });
+
+        // Load what the path shows before measuring it. Tiles missing from the fixture
+        // cache fail to load, and are left out of the frames.
+        map.jumpTo(path.front());
+        const auto deadline = Clock::now() + std::chrono::seconds(10);
+        while (!map.isFullyLoaded() && Clock::now() < deadline) {
+            loop.runOnce();
+            renderFrame();
+        }
+        for (const auto& camera : path) {
+            map.jumpTo(camera);
+            loop.runOnce();
+            renderFrame();
+        }
+        gpuTimes.clear();
+    }
+
+    void renderFrame() {
+        BackendScope scope { backend };
+        map.render(view);
+    }
+
+    util::RunLoop loop;
+    FrameBackend backend;
+    OffscreenView view { backend.getContext(), { 1000, 1000 } };
+    DefaultFileSource fileSource { "benchmark/fixtures/api/cache.db", "." };
+    ThreadPool threadPool { 4 };
+    Map map { backend, view.getSize(), 1, fileSource, threadPool, MapMode::Continuous };
+
+    const std::vector<CameraOptions> path = cameraPath();
+
+    // GPU times of the frames, where timer queries are supported. They arrive a few frames
+    // late, so they aren't matched with the frames they belong to.
+    std::vector<Duration> gpuTimes;
+};
+
+} // end namespace
+
+// Each iteration renders the whole camera path. The label holds a JSON object with the
+// percentiles of the CPU and GPU times, in milliseconds, the draw calls and the bytes
+// uploaded of its frames, for use with `--benchmark_format=json`.
+static void API_renderFrames(::benchmark::State& state) {
+    RenderBenchmark bench;
+    gl::Context& context = bench.backend.getContext();
+
+    std::vector<Duration> cpuTimes;
+    std::vector<std::size_t> drawCalls;
+    std::vector<std::size_t> uploadedBytes;
+
+    while (state.KeepRunning()) {
+        for (const auto& camera : bench.path) {
+            bench.map.jumpTo(camera);
+            bench.loop.runOnce();
+
+            const std::size_t drawCallsBefore = context.drawCalls;
+            const std::size_t uploadedBytesBefore = context.uploadedBytes;
+            const TimePoint start = Clock::now();
+            bench.renderFrame();
+            cpuTimes.push_back(Clock::now() - start);
+            drawCalls.push_back(context.drawCalls - drawCallsBefore);
+            uploadedBytes.push_back(context.uploadedBytes - uploadedBytesBefore);
+        }
+    }
+
+    const auto identity = [] (std::size_t value) { return value; };
+    state.SetItemsProcessed(state.iterations() * bench.path.size());
+    state.SetLabel("{\"frames\":" + util::toString(cpuTimes.size()) +
+                   ",\"cpu_ms\":" + percentiles(cpuTimes, milliseconds) +
+                   ",\"gpu_ms\":" + percentiles(bench.gpuTimes, milliseconds) +
+                   ",\"draw_calls\":" + percentiles(drawCalls, identity) +
+                   ",\"upload_bytes\":" + percentiles(uploadedBytes, identity) + "}");
+}
+
+BENCHMARK(API_renderFrames);
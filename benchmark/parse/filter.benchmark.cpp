@@ -2,13 +2,20 @@
 
 #include <mbgl/style/filter.hpp>
 #include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion.hpp>
 #include <mbgl/style/conversion/filter.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
 
 #include <rapidjson/document.h>
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 using namespace mbgl;
 
 style::Filter parse(const char* expression) {
@@ -37,5 +44,96 @@ static void Parse_EvaluateFilter(benchmark::State& state) {
     }
 }
 
+namespace {
+
+// Filters in the style of Mapbox Streets, with the source layer they apply to.
+const std::pair<const char*, const char*> tileFilters[] = {
+    { "road", R"FILTER(["all", ["==", "$type", "LineString"], ["in", "class", "motorway", "trunk", "primary", "secondary", "tertiary", "street", "street_limited", "service", "path"]])FILTER" },
+    { "road", R"FILTER(["all", ["==", "structure", "none"], ["!in", "type", "steps", "corridor", "crossing", "piste"], ["==", "oneway", "true"]])FILTER" },
+    { "building", R"FILTER(["all", ["!=", "type", "building:part"], ["==", "underground", "false"]])FILTER" },
+    { "landuse", R"FILTER(["in", "class", "park", "cemetery", "hospital", "school", "pitch", "sand", "grass", "parking"])FILTER" },
+    { "poi_label", R"FILTER(["all", ["==", "$type", "Point"], ["<=", "scalerank", 2], ["in", "maki", "park", "cemetery", "hospital", "school", "college", "museum", "zoo"]])FILTER" },
+    { "road_label", R"FILTER(["any", ["in", "class", "motorway", "trunk"], ["all", ["==", "class", "primary"], ["<=", "len", 20]]])FILTER" },
+};
+
+struct TileFeatures {
+    std::vector<std::shared_ptr<const std::string>> data;
+    std::vector<std::unique_ptr<VectorTileData>> tiles;
+
+    // The features of the source layer of each of `tileFilters`.
+    std::vector<std::vector<std::unique_ptr<GeometryTileFeature>>> features;
+};
+
+TileFeatures loadTileFeatures() {
+    TileFeatures result;
+    for (const char* fixture : { "benchmark/fixtures/tile/15-9648-12318.vector.pbf",
+                                 "benchmark/fixtures/tile/15-9649-12318.vector.pbf" }) {
+        result.data.push_back(std::make_shared<const std::string>(util::read_file(fixture)));
+        result.tiles.push_back(std::make_unique<VectorTileData>(result.data.back()));
+    }
+
+    for (const auto& tileFilter : tileFilters) {
+        result.features.emplace_back();
+        for (const auto& tile : result.tiles) {
+            if (const GeometryTileLayer* layer = tile->getLayer(tileFilter.first)) {
+                for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+                    result.features.back().push_back(layer->getFeature(i));
+                }
+            }
+        }
+    }
+    return result;
+}
+
+} // end namespace
+
+static void Parse_EvaluateFilterTile(benchmark::State& state) {
+    const TileFeatures tile = loadTileFeatures();
+    std::vector<style::Filter> filters;
+    for (const auto& tileFilter : tileFilters) {
+        filters.push_back(parse(tileFilter.second));
+    }
+
+    std::size_t matches = 0;
+    while (state.KeepRunning()) {
+        for (std::size_t i = 0; i < filters.size(); ++i) {
+            for (const auto& feature : tile.features[i]) {
+                matches += filters[i](*feature);
+            }
+        }
+    }
+    benchmark::DoNotOptimize(matches);
+}
+
+static void Parse_EvaluateCompiledFilterTile(benchmark::State& state) {
+    const TileFeatures tile = loadTileFeatures();
+    std::vector<style::CompiledFilter> filters;
+    for (const auto& tileFilter : tileFilters) {
+        filters.emplace_back(parse(tileFilter.second));
+    }
+
+    std::size_t matches = 0;
+    while (state.KeepRunning()) {
+        for (std::size_t i = 0; i < filters.size(); ++i) {
+            for (const auto& feature : tile.features[i]) {
+                matches += filters[i](*feature);
+            }
+        }
+    }
+    benchmark::DoNotOptimize(matches);
+}
+
+static void Parse_CompileFilter(benchmark::State& state) {
+    const style::Filter filter = parse(tileFilters[0].second);
+
+    while (state.KeepRunning()) {
+        style::CompiledFilter compiled(filter);
+        benchmark::DoNotOptimize(compiled);
+    }
+}
+
 BENCHMARK(Parse_Filter);
 BENCHMARK(Parse_EvaluateFilter);
+BENCHMARK(Parse_EvaluateFilterTile);
+BENCHMARK(Parse_EvaluateCompiledFilterTile);
+BENCHMARK(Parse_CompileFilter);
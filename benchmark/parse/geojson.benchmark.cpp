@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/style/conversion/geojson.hpp>
+#include <mbgl/style/conversion/geojson_reader.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+#include <sys/resource.h>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+using namespace mbgl;
+using namespace mbgl::style::conversion;
+
+namespace {
+
+// A FeatureCollection of parcel-like polygons with a handful of properties each.
+std::string generateParcels(std::size_t count) {
+    std::ostringstream json;
+    json << R"({"type":"FeatureCollection","features":[)";
+    for (std::size_t i = 0; i < count; ++i) {
+        const double x = (i % 1000) * 0.001;
+        const double y = (i / 1000) * 0.001;
+        json << (i ? "," : "")
+             << R"({"type":"Feature","id":)" << i
+             << R"(,"properties":{"owner":"Parcel owner )" << i
+             << R"(","area":)" << (i * 7 % 5000) + 0.5
+             << R"(,"zoning":"R-2","assessed":true},"geometry":{"type":"Polygon","coordinates":[[)";
+        for (std::size_t j = 0; j < 8; ++j) {
+            const double dx = (j == 1 || j == 2) ? 0.0009 : (j >= 3 && j <= 5) ? 0.0005 : 0.0;
+            const double dy = (j >= 2 && j <= 4) ? 0.0009 : (j == 5 || j == 6) ? 0.0004 : 0.0;
+            json << (j ? "," : "") << "[" << x + dx << "," << y + dy << "]";
+        }
+        json << "," << "[" << x << "," << y << "]]]}}";
+    }
+    json << "]}";
+    return json.str();
+}
+
+// Peak resident set size of the process so far. Each benchmark reports how far it grew,
+// so they are registered in order of increasing footprint; `--benchmark_filter` selects
+// one benchmark for a figure that doesn't depend on the others.
+std::size_t peakRSS() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss;
+#else
+    return usage.ru_maxrss * 1024;
+#endif
+}
+
+template <class Parse>
+void runParse(benchmark::State& state, Parse&& parse) {
+    const std::string json = generateParcels(state.range_x());
+    const std::size_t before = peakRSS();
+
+    while (state.KeepRunning()) {
+        Result<GeoJSON> geoJSON = parse(json);
+        benchmark::DoNotOptimize(geoJSON);
+    }
+
+    state.SetBytesProcessed(state.iterations() * json.size());
+    state.SetLabel("peak RSS +" + std::to_string((peakRSS() - before) >> 20) + " MB");
+}
+
+} // end namespace
+
+static void Parse_GeoJSONStream(benchmark::State& state) {
+    runParse(state, [] (const std::string& json) {
+        return parseGeoJSON(json);
+    });
+}
+
+static void Parse_GeoJSONDocument(benchmark::State& state) {
+    runParse(state, [] (const std::string& json) {
+        JSDocument document;
+        document.Parse<0>(json.c_str());
+        return convertGeoJSON<JSValue>(document);
+    });
+}
+
+BENCHMARK(Parse_GeoJSONStream)->Arg(100000);
+BENCHMARK(Parse_GeoJSONDocument)->Arg(100000);
@@ -0,0 +1,182 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/style/parser.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/util/async_request.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/rapidjson.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <memory>
+#include <string>
+
+using namespace mbgl;
+
+namespace {
+
+struct StyleFixture {
+    const char* name;
+    const char* path;
+};
+
+const StyleFixture styles[] = {
+    { "streets-v9", "benchmark/fixtures/api/query_style.json" },
+    { "streets-v8", "benchmark/fixtures/style/streets-v8.json" },
+    { "dark, 151 layers", "benchmark/fixtures/style/dark.json" },
+};
+
+// The sprite, glyphs and sources of the styles are never loaded, so that only the style
+// itself is measured.
+class NullFileSource : public FileSource {
+public:
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override {
+        return std::make_unique<AsyncRequest>();
+    }
+};
+
+// The same style with other colors for a few layers: what switching to a variant of a style,
+// like a night mode, changes.
+std::string variant(std::string json) {
+    const std::string color = "hsl(35, 32%, 91%)";
+    for (std::size_t pos = json.find(color); pos != std::string::npos; pos = json.find(color, pos)) {
+        json.replace(pos, color.size(), "hsl(35, 12%, 20%)");
+    }
+    return json;
+}
+
+class StyleBenchmark {
+public:
+    util::RunLoop loop;
+    NullFileSource fileSource;
+    ThreadPool threadPool { 4 };
+};
+
+} // end namespace
+
+// Only the JSON, into the document that the parser converts the style from.
+static void Parse_StyleJSON(benchmark::State& state) {
+    const StyleFixture& fixture = styles[state.range(0)];
+    const std::string json = util::read_file(fixture.path);
+
+    while (state.KeepRunning()) {
+        JSDocument document;
+        document.Parse<0>(json.c_str());
+        benchmark::DoNotOptimize(document.HasParseError());
+    }
+
+    state.SetLabel(fixture.name);
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+// The JSON, and its conversion into sources and layers; the conversion takes the difference
+// with `Parse_StyleJSON`.
+static void Parse_Style(benchmark::State& state) {
+    const StyleFixture& fixture = styles[state.range(0)];
+    const std::string json = util::read_file(fixture.path);
+
+    while (state.KeepRunning()) {
+        style::Parser parser;
+        benchmark::DoNotOptimize(parser.parse(json));
+    }
+
+    state.SetLabel(fixture.name);
+}
+
+// Like `Parse_Style`, converting the layers on a thread pool as `Style::setJSON` does.
+static void Parse_StyleConcurrently(benchmark::State& state) {
+    const StyleFixture& fixture = styles[state.range(0)];
+    const std::string json = util::read_file(fixture.path);
+    ThreadPool threadPool { 4 };
+
+    while (state.KeepRunning()) {
+        style::Parser parser { threadPool };
+        benchmark::DoNotOptimize(parser.parse(json));
+    }
+
+    state.SetLabel(fixture.name);
+}
+
+// Parsing, and adding the sources and layers to a new style.
+static void Style_SetJSON(benchmark::State& state) {
+    const StyleFixture& fixture = styles[state.range(0)];
+    const std::string json = util::read_file(fixture.path);
+    StyleBenchmark bench;
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        auto style = std::make_unique<style::Style>(bench.threadPool, bench.fileSource, 1.0);
+        state.ResumeTiming();
+
+        style->setJSON(json);
+
+        state.PauseTiming();
+        style.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetLabel(fixture.name);
+}
+
+// The first cascade and evaluation of the properties of a style that was just loaded.
+static void Style_FirstRecalculate(benchmark::State& state) {
+    const StyleFixture& fixture = styles[state.range(0)];
+    const std::string json = util::read_file(fixture.path);
+    StyleBenchmark bench;
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        auto style = std::make_unique<style::Style>(bench.threadPool, bench.fileSource, 1.0);
+        style->setJSON(json);
+        state.ResumeTiming();
+
+        const TimePoint now = Clock::now();
+        style->cascade(now, MapMode::Continuous);
+        style->recalculate(15, now, MapMode::Continuous);
+
+        state.PauseTiming();
+        style.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetLabel(fixture.name);
+}
+
+// Switching back and forth between a style and a variant of it, which keeps the layers and
+// sources they share, and evaluating the properties of the changed style.
+static void Style_Switch(benchmark::State& state) {
+    const std::string json = util::read_file(styles[0].path);
+    const std::string other = variant(json);
+    StyleBenchmark bench;
+
+    style::Style style { bench.threadPool, bench.fileSource, 1.0 };
+    style.setJSON(json);
+    style.cascade(Clock::now(), MapMode::Continuous);
+    style.recalculate(15, Clock::now(), MapMode::Continuous);
+
+    bool switched = false;
+    while (state.KeepRunning()) {
+        switched = !switched;
+        benchmark::DoNotOptimize(style.updateJSON(switched ? other : json));
+
+        const TimePoint now = Clock::now();
+        style.cascade(now, MapMode::Continuous);
+        style.recalculate(15, now, MapMode::Continuous);
+    }
+
+    state.SetLabel(styles[0].name);
+}
+
+static void Styles(benchmark::internal::Benchmark* b) {
+    for (std::size_t i = 0; i < sizeof(styles) / sizeof(styles[0]); i++) {
+        b->Arg(i);
+    }
+}
+
+BENCHMARK(Parse_StyleJSON)->Apply(Styles);
+BENCHMARK(Parse_Style)->Apply(Styles);
+BENCHMARK(Parse_StyleConcurrently)->Apply(Styles);
+BENCHMARK(Style_SetJSON)->Apply(Styles);
+BENCHMARK(Style_FirstRecalculate)->Apply(Styles);
+BENCHMARK(Style_Switch);
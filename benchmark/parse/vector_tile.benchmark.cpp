@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/allocations.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Mapbox Streets v7 tiles of lower Manhattan, rich in building footprints.
+const char* const fixtures[] = {
+    "benchmark/fixtures/tile/15-9648-12318.vector.pbf",
+    "benchmark/fixtures/tile/15-9649-12318.vector.pbf",
+};
+
+const char* const layerNames[] = {
+    "landuse", "waterway", "water", "aeroway", "barrier_line", "building", "landuse_overlay",
+    "tunnel", "road", "bridge", "admin", "place_label", "water_label", "poi_label",
+    "road_label", "housenum_label", "rail_station_label", "contour", "hillshade", "landcover",
+};
+
+std::vector<std::shared_ptr<const std::string>> loadFixtures() {
+    std::vector<std::shared_ptr<const std::string>> result;
+    for (const char* fixture : fixtures) {
+        result.push_back(std::make_shared<const std::string>(util::read_file(fixture)));
+    }
+    return result;
+}
+
+template <class Fn>
+void forEachFeature(const std::vector<std::unique_ptr<VectorTileData>>& tiles, Fn&& fn) {
+    for (const auto& tile : tiles) {
+        for (const char* layerName : layerNames) {
+            const GeometryTileLayer* layer = tile->getLayer(layerName);
+            if (!layer) {
+                continue;
+            }
+            for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+                fn(*layer->getFeature(i));
+            }
+        }
+    }
+}
+
+std::vector<std::unique_ptr<VectorTileData>> parseFixtures() {
+    std::vector<std::unique_ptr<VectorTileData>> tiles;
+    for (auto& data : loadFixtures()) {
+        tiles.push_back(std::make_unique<VectorTileData>(data));
+    }
+    return tiles;
+}
+
+} // end namespace
+
+static void Parse_VectorTile(::benchmark::State& state) {
+    const auto data = loadFixtures();
+
+    mbgl::benchmark::AllocationCounter allocations;
+    while (state.KeepRunning()) {
+        for (const auto& buffer : data) {
+            VectorTileData tile(buffer);
+            for (const char* layerName : layerNames) {
+                ::benchmark::DoNotOptimize(tile.getLayer(layerName));
+            }
+        }
+    }
+
+    state.SetLabel(allocations.label(state));
+}
+
+static void Parse_VectorTileGeometryBuffer(::benchmark::State& state) {
+    const auto tiles = parseFixtures();
+    GeometryBuffer buffer;
+
+    mbgl::benchmark::AllocationCounter allocations;
+    while (state.KeepRunning()) {
+        forEachFeature(tiles, [&] (const GeometryTileFeature& feature) {
+            feature.readGeometries(buffer);
+            ::benchmark::DoNotOptimize(buffer.size());
+        });
+    }
+
+    state.SetLabel(allocations.label(state));
+}
+
+static void Parse_VectorTileGeometryCollection(::benchmark::State& state) {
+    const auto tiles = parseFixtures();
+
+    mbgl::benchmark::AllocationCounter allocations;
+    while (state.KeepRunning()) {
+        forEachFeature(tiles, [&] (const GeometryTileFeature& feature) {
+            ::benchmark::DoNotOptimize(feature.getGeometries());
+        });
+    }
+
+    state.SetLabel(allocations.label(state));
+}
+
+BENCHMARK(Parse_VectorTile);
+BENCHMARK(Parse_VectorTileGeometryBuffer);
+BENCHMARK(Parse_VectorTileGeometryCollection);
@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/renderer/line_bucket.hpp>
+#include <mbgl/style/bucket_parameters.hpp>
+#include <mbgl/style/layers/line_layer_properties.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Mapbox Streets v7 tiles of lower Manhattan.
+const char* const fixtures[] = {
+    "benchmark/fixtures/tile/15-9648-12318.vector.pbf",
+    "benchmark/fixtures/tile/15-9649-12318.vector.pbf",
+};
+
+const char* const lineLayers[] = {
+    "road", "bridge", "tunnel", "admin", "waterway", "barrier_line",
+};
+
+struct LineFeatures {
+    std::vector<std::unique_ptr<VectorTileData>> tiles;
+    std::vector<std::unique_ptr<GeometryTileFeature>> features;
+    std::vector<GeometryBuffer> geometries;
+};
+
+LineFeatures loadLineFeatures() {
+    LineFeatures result;
+    for (const char* fixture : fixtures) {
+        result.tiles.push_back(std::make_unique<VectorTileData>(
+            std::make_shared<const std::string>(util::read_file(fixture))));
+        for (const char* layerName : lineLayers) {
+            const GeometryTileLayer* layer = result.tiles.back()->getLayer(layerName);
+            if (!layer) {
+                continue;
+            }
+            for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+                auto feature = layer->getFeature(i);
+                if (feature->getType() != FeatureType::LineString) {
+                    continue;
+                }
+                result.geometries.emplace_back();
+                feature->readGeometries(result.geometries.back());
+                result.features.push_back(std::move(feature));
+            }
+        }
+    }
+    return result;
+}
+
+void addLineFeatures(benchmark::State& state, style::LineJoinType join) {
+    const LineFeatures lines = loadLineFeatures();
+    const std::atomic<bool> obsolete { false };
+    const style::BucketParameters parameters { { 15, 0, 0 }, MapMode::Continuous, obsolete };
+
+    style::LineLayoutProperties layout;
+    layout.unevaluated.get<style::LineJoin>() = join;
+
+    while (state.KeepRunning()) {
+        LineBucket bucket { parameters, {}, layout };
+        for (std::size_t i = 0; i < lines.features.size(); ++i) {
+            bucket.addFeature(*lines.features[i], lines.geometries[i], i);
+        }
+        benchmark::DoNotOptimize(bucket.vertices.vertexSize());
+    }
+}
+
+} // end namespace
+
+static void Bucket_LineMiter(benchmark::State& state) {
+    addLineFeatures(state, style::LineJoinType::Miter);
+}
+
+static void Bucket_LineRound(benchmark::State& state) {
+    addLineFeatures(state, style::LineJoinType::Round);
+}
+
+BENCHMARK(Bucket_LineMiter);
+BENCHMARK(Bucket_LineRound);
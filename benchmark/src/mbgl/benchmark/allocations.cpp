@@ -0,0 +1,136 @@
+#include <mbgl/benchmark/allocations.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace mbgl {
+namespace benchmark {
+
+namespace {
+
+std::atomic<bool> counted { false };
+std::atomic<std::size_t> allocationCount { 0 };
+std::atomic<std::size_t> allocationBytes { 0 };
+
+void* allocate(std::size_t size) {
+    if (counted.load(std::memory_order_relaxed)) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    while (true) {
+        if (void* ptr = std::malloc(size ? size : 1)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* allocateNoThrow(std::size_t size) noexcept {
+    try {
+        return allocate(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+} // namespace
+
+bool allocationsCounted() {
+    return counted;
+}
+
+void setAllocationsCounted(bool value) {
+    counted = value;
+}
+
+AllocationCounter::AllocationCounter()
+    : allocationsBefore(allocationCount),
+      bytesBefore(allocationBytes) {
+}
+
+void AllocationCounter::pause() {
+    if (!paused) {
+        paused = true;
+        allocationsPaused = allocationCount;
+        bytesPaused = allocationBytes;
+    }
+}
+
+void AllocationCounter::resume() {
+    if (paused) {
+        paused = false;
+        allocationsExcluded += allocationCount - allocationsPaused;
+        bytesExcluded += allocationBytes - bytesPaused;
+    }
+}
+
+std::size_t AllocationCounter::allocations() const {
+    return (paused ? allocationsPaused : allocationCount.load()) - allocationsBefore - allocationsExcluded;
+}
+
+std::size_t AllocationCounter::bytes() const {
+    return (paused ? bytesPaused : allocationBytes.load()) - bytesBefore - bytesExcluded;
+}
+
+std::string AllocationCounter::label(const ::benchmark::State& state, const std::string& prefix) const {
+    if (!counted || !state.iterations()) {
+        return prefix;
+    }
+
+    const double iterations = state.iterations();
+    return (prefix.empty() ? "" : prefix + ", ") +
+        util::toString(allocations() / iterations) + " allocs/iter, " +
+        util::toString(bytes() / iterations) + " bytes/iter";
+}
+
+} // namespace benchmark
+} // namespace mbgl
+
+// Replacements of the global allocation functions, for the whole benchmark binary.
+
+void* operator new(std::size_t size) {
+    return mbgl::benchmark::allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return mbgl::benchmark::allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return mbgl::benchmark::allocateNoThrow(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return mbgl::benchmark::allocateNoThrow(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
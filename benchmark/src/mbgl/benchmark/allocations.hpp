@@ -0,0 +1,44 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <string>
+
+namespace mbgl {
+namespace benchmark {
+
+// Whether allocations are counted, which `--benchmark_allocations` turns on. The benchmark
+// binary replaces the global operator new for this; when it's off, each allocation only
+// costs the check of a flag.
+bool allocationsCounted();
+void setAllocationsCounted(bool);
+
+// Counts the calls to the global operator new, and the bytes they allocate, on every thread,
+// from its construction. Benchmark 1.0 has no counters, so they are reported in the label.
+class AllocationCounter {
+public:
+    AllocationCounter();
+
+    // Leaves out the allocations of the setup between `PauseTiming` and `ResumeTiming`.
+    void pause();
+    void resume();
+
+    std::size_t allocations() const;
+    std::size_t bytes() const;
+
+    // The label, followed by the allocations and bytes per iteration when they are counted.
+    std::string label(const ::benchmark::State&, const std::string& prefix = {}) const;
+
+private:
+    std::size_t allocationsBefore;
+    std::size_t bytesBefore;
+    std::size_t allocationsPaused = 0;
+    std::size_t bytesPaused = 0;
+    std::size_t allocationsExcluded = 0;
+    std::size_t bytesExcluded = 0;
+    bool paused = false;
+};
+
+} // namespace benchmark
+} // namespace mbgl
@@ -1,10 +1,24 @@
 #include <mbgl/benchmark.hpp>
+#include <mbgl/benchmark/allocations.hpp>
 
 #include <benchmark/benchmark.h>
 
+#include <cstring>
+
 namespace mbgl {
 
 int runBenchmark(int argc, char* argv[]) {
+    // Our own flags are taken out before the benchmark library parses the others.
+    int remaining = 1;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--benchmark_allocations") == 0) {
+            benchmark::setAllocationsCounted(true);
+        } else {
+            argv[remaining++] = argv[i];
+        }
+    }
+    argc = remaining;
+
     ::benchmark::Initialize(&argc, argv);
     ::benchmark::RunSpecifiedBenchmarks();
     return 0;
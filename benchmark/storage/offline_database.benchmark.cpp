@@ -0,0 +1,220 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+const std::string directory = "benchmark/fixtures/offline_database/";
+
+// Resources are never evicted unless the benchmark sets a limit.
+constexpr uint64_t unlimited = std::numeric_limits<uint64_t>::max();
+
+constexpr std::size_t batchSize = 1000;
+
+const OfflineTilePyramidRegionDefinition definition {
+    "http://example.com/style.json", LatLngBounds::world(), 0, 16, 1.0
+};
+
+// Tiles of z16, row by row.
+Resource tile(uint64_t i) {
+    return Resource::tile("http://example.com/{z}/{x}/{y}.vector.pbf", 1.0,
+                          int32_t(i % 65536), int32_t(i / 65536), 16, Tileset::Scheme::XYZ);
+}
+
+// Slices of a vector tile, so that they compress like tiles do.
+Response tileResponse(uint64_t i) {
+    static const std::string source = util::read_file("benchmark/fixtures/tile/15-9648-12318.vector.pbf");
+    constexpr std::size_t size = 1024;
+    Response response;
+    response.data = std::make_shared<std::string>(source.substr((i * 7919) % (source.size() - size), size));
+    return response;
+}
+
+// Spreads the reads over the database.
+uint64_t sample(uint64_t i, uint64_t rows) {
+    return (i * 2654435761u) % rows;
+}
+
+void deleteDatabase(const std::string& path) {
+    for (const char* suffix : { "", "-wal", "-shm", "-journal" }) {
+        try {
+            util::deleteFile(path + suffix);
+        } catch (const util::IOException&) {
+        }
+    }
+}
+
+uint64_t fileSize(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return uint64_t(file.tellg());
+}
+
+// A database of the given number of ambient tiles. It is made on the first run, which takes
+// a while for the larger ones, and kept for later runs.
+std::string database(uint64_t rows) {
+    const std::string path = directory + util::toString(rows) + ".db";
+    if (std::ifstream(path).good()) {
+        return path;
+    }
+
+    const std::string partial = path + ".partial";
+    deleteDatabase(partial);
+    {
+        // Written as a region, in a transaction per batch, and then left to the ambient
+        // cache, as if the region had been downloaded and deleted since.
+        OfflineDatabase db(partial, unlimited);
+        OfflineRegion region = db.createRegion(definition, {});
+        std::vector<std::pair<Resource, Response>> batch;
+        for (uint64_t i = 0; i < rows; i++) {
+            batch.emplace_back(tile(i), tileResponse(i));
+            if (batch.size() == 10 * batchSize || i + 1 == rows) {
+                db.putRegionResources(region.getID(), batch);
+                batch.clear();
+            }
+        }
+        db.deleteRegion(std::move(region));
+    }
+    std::rename(partial.c_str(), path.c_str());
+    return path;
+}
+
+// For the benchmarks that write, so that each run starts from the same database.
+std::string workingCopy(uint64_t rows) {
+    const std::string source = database(rows);
+    const std::string copy = directory + "working.db";
+    deleteDatabase(copy);
+    std::ifstream input(source, std::ios::binary);
+    std::ofstream(copy, std::ios::binary) << input.rdbuf();
+    return copy;
+}
+
+} // end namespace
+
+// The first read after opening the database, with none of its statements prepared or pages
+// cached by SQLite. The file may still be cached by the operating system.
+static void OfflineDatabase_GetCold(benchmark::State& state) {
+    const uint64_t rows = state.range(0);
+    const std::string path = database(rows);
+
+    uint64_t i = 0;
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        auto db = std::make_unique<OfflineDatabase>(path, unlimited);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(db->get(tile(sample(i++, rows))));
+
+        state.PauseTiming();
+        db.reset();
+        state.ResumeTiming();
+    }
+}
+
+// Reads of tiles read shortly before, as when panning back and forth.
+static void OfflineDatabase_GetWarm(benchmark::State& state) {
+    const uint64_t rows = state.range(0);
+    OfflineDatabase db(database(rows), unlimited);
+
+    for (uint64_t i = 0; i < batchSize; i++) {
+        db.get(tile(sample(i, rows)));
+    }
+
+    uint64_t i = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(db.get(tile(sample(i++ % batchSize, rows))));
+    }
+}
+
+// Puts of new tiles into a full cache, where each put evicts the least recently used tiles.
+static void OfflineDatabase_PutAmbient(benchmark::State& state) {
+    const uint64_t rows = state.range(0);
+    const bool writeAheadLogging = state.range(1);
+    const std::string path = workingCopy(rows);
+    OfflineDatabase db(path, fileSize(path));
+    db.setWriteAheadLogging(writeAheadLogging);
+
+    uint64_t i = rows;
+    while (state.KeepRunning()) {
+        db.put(tile(i), tileResponse(i));
+        i++;
+    }
+
+    state.SetLabel(writeAheadLogging ? "write-ahead log" : "rollback journal");
+}
+
+// Batches of the tiles of a region being downloaded.
+static void OfflineDatabase_PutRegionResources(benchmark::State& state) {
+    const uint64_t rows = state.range(0);
+    OfflineDatabase db(workingCopy(rows), unlimited);
+    OfflineRegion region = db.createRegion(definition, {});
+
+    uint64_t next = rows;
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        std::vector<std::pair<Resource, Response>> batch;
+        for (std::size_t i = 0; i < batchSize; i++, next++) {
+            batch.emplace_back(tile(next), tileResponse(next));
+        }
+        state.ResumeTiming();
+
+        db.putRegionResources(region.getID(), batch);
+    }
+
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+// Deleting a region of a batch of tiles, along with the background eviction and vacuuming
+// it leaves.
+static void OfflineDatabase_DeleteRegion(benchmark::State& state) {
+    const uint64_t rows = state.range(0);
+    OfflineDatabase db(workingCopy(rows), unlimited);
+
+    uint64_t next = rows;
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        OfflineRegion region = db.createRegion(definition, {});
+        std::vector<std::pair<Resource, Response>> batch;
+        for (std::size_t i = 0; i < batchSize; i++, next++) {
+            batch.emplace_back(tile(next), tileResponse(next));
+        }
+        db.putRegionResources(region.getID(), batch);
+        state.ResumeTiming();
+
+        db.deleteRegion(std::move(region));
+        while (db.evictInBackground(Milliseconds(20))) {
+        }
+    }
+}
+
+static void DatabaseSizes(benchmark::internal::Benchmark* b) {
+    b->Arg(10000);
+    b->Arg(100000);
+    b->Arg(1000000);
+}
+
+static void DatabaseSizesAndJournals(benchmark::internal::Benchmark* b) {
+    for (int rows : { 10000, 100000, 1000000 }) {
+        b->ArgPair(rows, false);
+        b->ArgPair(rows, true);
+    }
+}
+
+BENCHMARK(OfflineDatabase_GetCold)->Apply(DatabaseSizes);
+BENCHMARK(OfflineDatabase_GetWarm)->Apply(DatabaseSizes);
+BENCHMARK(OfflineDatabase_PutAmbient)->Apply(DatabaseSizesAndJournals);
+BENCHMARK(OfflineDatabase_PutRegionResources)->Apply(DatabaseSizes);
+BENCHMARK(OfflineDatabase_DeleteRegion)->Apply(DatabaseSizes);
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/geojson.hpp>
+
+#include <supercluster.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Points scattered around a few hundred centres, like the locations of a global dataset.
+FeatureCollection generatePoints(std::size_t count) {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> longitude(-180, 180);
+    std::uniform_real_distribution<double> latitude(-70, 70);
+    std::normal_distribution<double> spread(0, 2);
+
+    std::vector<mapbox::geometry::point<double>> centres;
+    for (std::size_t i = 0; i < 300; ++i) {
+        centres.push_back({ longitude(generator), latitude(generator) });
+    }
+
+    FeatureCollection features;
+    features.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& centre = centres[i % centres.size()];
+        features.push_back(Feature { mapbox::geometry::point<double> {
+            std::fmod(centre.x + spread(generator) + 540, 360) - 180,
+            std::max(-85.0, std::min(85.0, centre.y + spread(generator)))
+        } });
+    }
+    return features;
+}
+
+} // end namespace
+
+// Indexing a clustered GeoJSON source, with the options GeoJSONSourceWorker uses for the
+// defaults of GeoJSONOptions.
+static void Supercluster_Build(benchmark::State& state) {
+    const FeatureCollection features = generatePoints(state.range_x());
+
+    mapbox::supercluster::Options options;
+    options.maxZoom = 17;
+    options.extent = util::EXTENT;
+    options.radius = std::round(util::EXTENT / util::tileSize * 50);
+
+    while (state.KeepRunning()) {
+        mapbox::supercluster::Supercluster index(features, options);
+        benchmark::DoNotOptimize(index);
+    }
+
+    state.SetItemsProcessed(state.iterations() * features.size());
+}
+
+BENCHMARK(Supercluster_Build)->Arg(1000000);
@@ -0,0 +1,201 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/text/collision_feature.hpp>
+#include <mbgl/text/collision_grid.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/io.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wshadow"
+#ifdef __clang__
+#pragma GCC diagnostic ignored "-Wunknown-pragmas"
+#endif
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wdeprecated-register"
+#pragma GCC diagnostic ignored "-Wshorten-64-to-32"
+#pragma GCC diagnostic ignored "-Wunused-local-typedefs"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <boost/geometry.hpp>
+#include <boost/geometry/geometries/point.hpp>
+#include <boost/geometry/geometries/box.hpp>
+#include <boost/geometry/index/rtree.hpp>
+#pragma GCC diagnostic pop
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Mapbox Streets v7 tiles of lower Manhattan.
+const char* const fixtures[] = {
+    "benchmark/fixtures/tile/15-9648-12318.vector.pbf",
+    "benchmark/fixtures/tile/15-9649-12318.vector.pbf",
+};
+
+const char* const pointLayers[] = {
+    "poi_label", "place_label", "housenum_label", "water_label", "rail_station_label",
+};
+
+const char* const lineLayers[] = {
+    "road_label", "waterway_label",
+};
+
+// Collision features of 12px labels of the features' names, as laid out at z15.
+std::vector<CollisionFeature> loadCollisionFeatures() {
+    const float boxScale = util::EXTENT / util::tileSize;
+    const float padding = 2 * boxScale;
+
+    std::vector<CollisionFeature> result;
+    for (const char* fixture : fixtures) {
+        const VectorTileData data { std::make_shared<const std::string>(util::read_file(fixture)) };
+
+        auto addLayer = [&] (const char* layerName, style::SymbolPlacementType placement) {
+            const GeometryTileLayer* layer = data.getLayer(layerName);
+            if (!layer) {
+                return;
+            }
+            for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+                auto feature = layer->getFeature(i);
+                auto name = feature->getValue("name");
+                const GeometryCollection geometries = feature->getGeometries();
+                if (!name || !name->is<std::string>() || geometries.empty() || geometries[0].empty()) {
+                    continue;
+                }
+
+                const GeometryCoordinates& line = geometries[0];
+                const float width = 7.0f * name->get<std::string>().size();
+                const IndexedSubfeature indexedFeature { i, layerName, layerName, result.size() };
+
+                if (placement == style::SymbolPlacementType::Line) {
+                    if (line.size() < 2) {
+                        continue;
+                    }
+                    const std::size_t segment = (line.size() - 2) / 2;
+                    const Anchor anchor(line[segment].x, line[segment].y, 0, 0.5f, segment);
+                    result.emplace_back(line, anchor, -6, 6, -width / 2, width / 2,
+                                        boxScale, padding, placement, indexedFeature, false);
+                } else {
+                    const Anchor anchor(line[0].x, line[0].y, 0, 0.5f);
+                    result.emplace_back(line, anchor, -6, 6, -width / 2, width / 2,
+                                        boxScale, padding, placement, indexedFeature, false);
+                }
+            }
+        };
+
+        for (const char* layerName : pointLayers) {
+            addLayer(layerName, style::SymbolPlacementType::Point);
+        }
+        for (const char* layerName : lineLayers) {
+            addLayer(layerName, style::SymbolPlacementType::Line);
+        }
+    }
+    return result;
+}
+
+template <class Index>
+void queryAndInsert(benchmark::State& state, const std::vector<CollisionFeature>& features) {
+    while (state.KeepRunning()) {
+        Index index;
+        std::size_t hits = 0;
+        for (const auto& feature : features) {
+            for (const auto& box : feature.boxes) {
+                hits += index.query(box);
+            }
+            for (const auto& box : feature.boxes) {
+                index.insert(box);
+            }
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+}
+
+namespace bg = boost::geometry;
+namespace bgi = bg::index;
+
+// The R-tree that `CollisionTile` used before `CollisionGrid`.
+class RTreeCollisionIndex {
+public:
+    using Point = bg::model::point<float, 2, bg::cs::cartesian>;
+    using Box = bg::model::box<Point>;
+
+    std::size_t query(const CollisionBox& box) const {
+        std::size_t hits = 0;
+        for (auto it = tree.qbegin(bgi::intersects(bbox(box))); it != tree.qend(); ++it) {
+            ++hits;
+        }
+        return hits;
+    }
+
+    void insert(const CollisionBox& box) {
+        tree.insert(std::make_pair(bbox(box), box));
+    }
+
+private:
+    static Box bbox(const CollisionBox& box) {
+        return Box { Point { box.anchor.x + box.x1, box.anchor.y + box.y1 },
+                     Point { box.anchor.x + box.x2, box.anchor.y + box.y2 } };
+    }
+
+    bgi::rtree<std::pair<Box, CollisionBox>, bgi::linear<16, 4>> tree;
+};
+
+class GridCollisionIndex {
+public:
+    using Grid = CollisionGrid<CollisionBox>;
+
+    std::size_t query(const CollisionBox& box) const {
+        std::size_t hits = 0;
+        grid.query(bbox(box), [&] (const Grid::Entry&) {
+            ++hits;
+            return true;
+        });
+        return hits;
+    }
+
+    void insert(const CollisionBox& box) {
+        grid.insert(box, bbox(box));
+    }
+
+private:
+    static Grid::BBox bbox(const CollisionBox& box) {
+        return Grid::BBox { box.anchor.x + box.x1, box.anchor.y + box.y1,
+                            box.anchor.x + box.x2, box.anchor.y + box.y2 };
+    }
+
+    Grid grid { { 0, 0, util::EXTENT, util::EXTENT }, 16 };
+};
+
+} // end namespace
+
+static void CollisionIndex_RTree(benchmark::State& state) {
+    queryAndInsert<RTreeCollisionIndex>(state, loadCollisionFeatures());
+}
+
+static void CollisionIndex_Grid(benchmark::State& state) {
+    queryAndInsert<GridCollisionIndex>(state, loadCollisionFeatures());
+}
+
+static void CollisionTile_Place(benchmark::State& state) {
+    std::vector<CollisionFeature> features = loadCollisionFeatures();
+
+    while (state.KeepRunning()) {
+        CollisionTile tile { PlacementConfig {} };
+        for (auto& feature : features) {
+            const float scale = tile.placeFeature(feature, false, false);
+            tile.insertFeature(feature, scale, false);
+        }
+        benchmark::DoNotOptimize(tile);
+    }
+}
+
+BENCHMARK(CollisionIndex_RTree);
+BENCHMARK(CollisionIndex_Grid);
+BENCHMARK(CollisionTile_Place);
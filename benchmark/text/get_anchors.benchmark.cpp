@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/text/get_anchors.hpp>
+#include <mbgl/text/line_measurements.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// A motorway winding across the tile, with a vertex every 8 units as in overscaled tiles.
+GeometryCoordinates motorway() {
+    GeometryCoordinates line;
+    for (int16_t x = 0; x < util::EXTENT; x += 8) {
+        line.emplace_back(x, int16_t(util::EXTENT / 2 + 1000 * std::sin(x / 300.0)));
+    }
+    return line;
+}
+
+// The layers labelling the motorway: its name, its route shield and its exit numbers.
+const std::size_t layers = 3;
+
+Anchors anchors(const GeometryCoordinates& line, const LineMeasurements& measurements) {
+    return getAnchors(line, measurements, 250 * 8, 45 * util::DEG2RAD, -60, 60, -10, 10, 24, 8, 1);
+}
+
+} // end namespace
+
+static void GetAnchors_Motorway(benchmark::State& state) {
+    const GeometryCoordinates line = motorway();
+
+    while (state.KeepRunning()) {
+        for (std::size_t i = 0; i < layers; ++i) {
+            benchmark::DoNotOptimize(anchors(line, LineMeasurements(line)));
+        }
+    }
+}
+
+static void GetAnchors_MotorwayShared(benchmark::State& state) {
+    const GeometryCoordinates line = motorway();
+
+    while (state.KeepRunning()) {
+        LineMeasurementCache cache;
+        for (std::size_t i = 0; i < layers; ++i) {
+            benchmark::DoNotOptimize(anchors(line, cache.get(line)));
+        }
+    }
+}
+
+static void LineMeasurements_Motorway(benchmark::State& state) {
+    const GeometryCoordinates line = motorway();
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(LineMeasurements(line));
+    }
+}
+
+BENCHMARK(GetAnchors_Motorway);
+BENCHMARK(GetAnchors_MotorwayShared);
+BENCHMARK(LineMeasurements_Motorway);
@@ -0,0 +1,205 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/text/bidi.hpp>
+#include <mbgl/text/glyph_pbf_worker.hpp>
+#include <mbgl/text/glyph_set.hpp>
+#include <mbgl/util/i18n.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+struct Corpus {
+    const char* name;
+    std::vector<std::u16string> labels;
+};
+
+// Place, street and landmark names, with some long enough to wrap onto several lines.
+const Corpus corpora[] = {
+    { "latin", {
+        u"Broadway", u"Avenue des Champs-Élysées", u"Straße des 17. Juni", u"Piazza San Marco",
+        u"Golden Gate National Recreation Area", u"Universitätsklinikum Hamburg-Eppendorf",
+        u"Estación de Madrid Puerta de Atocha", u"Rijksmuseum",
+    } },
+    { "arabic", {
+        u"القاهرة", u"شارع الملك فهد", u"جامعة الملك عبد العزيز", u"مطار دبي الدولي",
+        u"المسجد الحرام", u"حديقة الأزهر", u"شارع 23 يوليو", u"مركز الملك عبدالله المالي",
+    } },
+    { "cjk", {
+        u"北京市", u"长安街", u"北京首都国际机场", u"東京都", u"渋谷スクランブル交差点",
+        u"上海浦东新区世纪大道", u"서울특별시", u"香港（中環）",
+    } },
+    { "devanagari", {
+        u"दिल्ली", u"राष्ट्रपति भवन", u"छत्रपति शिवाजी महाराज टर्मिनस", u"गेटवे ऑफ़ इंडिया",
+        u"इंदिरा गांधी अंतर्राष्ट्रीय हवाई अड्डा", u"मुंबई", u"चाँदनी चौक", u"कनॉट प्लेस",
+    } },
+};
+
+const std::size_t corpusCount = sizeof(corpora) / sizeof(corpora[0]);
+
+// Symbol layout shapes the text after the Arabic letters have been joined.
+std::vector<std::u16string> shapedLabels(const Corpus& corpus) {
+    std::vector<std::u16string> result;
+    for (const auto& label : corpus.labels) {
+        result.push_back(applyArabicShaping(label));
+    }
+    return result;
+}
+
+std::shared_ptr<const std::string> glyphPBF() {
+    static const auto data = std::make_shared<const std::string>(
+        util::read_file("benchmark/fixtures/tile/glyphs.0-255.pbf"));
+    return data;
+}
+
+// The glyphs of the fixture range, and glyphs with typical metrics and no bitmap for the
+// code points of the labels outside of it, so that every label shapes to all of its glyphs.
+GlyphSet glyphSet(const std::vector<std::u16string>& labels) {
+    GlyphSet set;
+    for (auto& glyph : parseGlyphPBF(GlyphRange { 0, 255 }, glyphPBF())) {
+        const uint32_t id = glyph.id;
+        set.insert(id, std::move(glyph));
+    }
+
+    for (const auto& label : labels) {
+        for (char16_t chr : label) {
+            if (set.getSDFs().count(chr)) {
+                continue;
+            }
+            const bool ideographic = util::i18n::allowsIdeographicBreaking(chr);
+            SDFGlyph glyph;
+            glyph.id = chr;
+            glyph.metrics.width = ideographic ? 22 : 14;
+            glyph.metrics.height = 22;
+            glyph.metrics.left = 1;
+            glyph.metrics.top = -4;
+            glyph.metrics.advance = ideographic ? 24 : 14;
+            set.insert(chr, std::move(glyph));
+        }
+    }
+
+    return set;
+}
+
+std::size_t codeUnits(const std::vector<std::u16string>& labels) {
+    std::size_t count = 0;
+    for (const auto& label : labels) {
+        count += label.size();
+    }
+    return count;
+}
+
+} // end namespace
+
+static void Text_ParseGlyphPBF(benchmark::State& state) {
+    const auto data = glyphPBF();
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(parseGlyphPBF(GlyphRange { 0, 255 }, data));
+    }
+
+    state.SetBytesProcessed(state.iterations() * data->size());
+}
+
+static void Text_ArabicShaping(benchmark::State& state) {
+    const Corpus& corpus = corpora[state.range(0)];
+
+    while (state.KeepRunning()) {
+        for (const auto& label : corpus.labels) {
+            benchmark::DoNotOptimize(applyArabicShaping(label));
+        }
+    }
+
+    state.SetLabel(corpus.name);
+    state.SetItemsProcessed(state.iterations() * codeUnits(corpus.labels));
+}
+
+// Reordering into visual order, for labels on a single line.
+static void Text_BiDi(benchmark::State& state) {
+    const Corpus& corpus = corpora[state.range(0)];
+    const std::vector<std::u16string> labels = shapedLabels(corpus);
+    BiDi bidi;
+
+    while (state.KeepRunning()) {
+        for (const auto& label : labels) {
+            benchmark::DoNotOptimize(bidi.processText(label, {}));
+        }
+    }
+
+    state.SetLabel(corpus.name);
+    state.SetItemsProcessed(state.iterations() * codeUnits(labels));
+}
+
+// Shaping as symbol layout does for point labels, with `text-max-width` at its default of
+// 10 ems, or for line labels, which never wrap. Line breaking is part of the former only, so
+// it takes the difference between the two.
+static void Text_Shaping(benchmark::State& state) {
+    const Corpus& corpus = corpora[state.range(0)];
+    const bool wrapped = state.range(1);
+    const std::vector<std::u16string> labels = shapedLabels(corpus);
+    const GlyphSet set = glyphSet(labels);
+    BiDi bidi;
+
+    const float oneEm = 24.0f;
+    while (state.KeepRunning()) {
+        for (const auto& label : labels) {
+            benchmark::DoNotOptimize(set.getShaping(label, wrapped ? 10 * oneEm : 0, 1.2f * oneEm,
+                                                    0.5f, 0.5f, 0.5f, 0, { 0, 0 }, oneEm,
+                                                    WritingModeType::Horizontal, bidi));
+        }
+    }
+
+    state.SetLabel(std::string(corpus.name) + (wrapped ? ", wrapped" : ", single line"));
+    state.SetItemsProcessed(state.iterations() * labels.size());
+}
+
+// The vertical shaping that labels of scripts allowing it get along with the horizontal one.
+static void Text_ShapingVertical(benchmark::State& state) {
+    const Corpus& corpus = corpora[state.range(0)];
+    const std::vector<std::u16string> labels = shapedLabels(corpus);
+    const GlyphSet set = glyphSet(labels);
+    BiDi bidi;
+
+    std::vector<std::u16string> vertical;
+    for (const auto& label : labels) {
+        if (util::i18n::allowsVerticalWritingMode(label)) {
+            vertical.push_back(util::i18n::verticalizePunctuation(label));
+        }
+    }
+
+    const float oneEm = 24.0f;
+    while (state.KeepRunning()) {
+        for (const auto& label : vertical) {
+            benchmark::DoNotOptimize(set.getShaping(label, 10 * oneEm, 1.2f * oneEm,
+                                                    0.5f, 0.5f, 0.5f, 0, { 0, 0 }, oneEm,
+                                                    WritingModeType::Vertical, bidi));
+        }
+    }
+
+    state.SetLabel(corpus.name);
+    state.SetItemsProcessed(state.iterations() * vertical.size());
+}
+
+static void Corpora(benchmark::internal::Benchmark* b) {
+    for (std::size_t i = 0; i < corpusCount; i++) {
+        b->Arg(i);
+    }
+}
+
+static void CorporaWrapped(benchmark::internal::Benchmark* b) {
+    for (std::size_t i = 0; i < corpusCount; i++) {
+        b->ArgPair(i, false);
+        b->ArgPair(i, true);
+    }
+}
+
+BENCHMARK(Text_ParseGlyphPBF);
+BENCHMARK(Text_ArabicShaping)->Apply(Corpora);
+BENCHMARK(Text_BiDi)->Apply(Corpora);
+BENCHMARK(Text_Shaping)->Apply(CorporaWrapped);
+BENCHMARK(Text_ShapingVertical)->Arg(2);
@@ -0,0 +1,387 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/allocations.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/layout/symbol_layout.hpp>
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/sprite/sprite_atlas.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/style/bucket_parameters.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/group_by_layout.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/layers/background_layer.hpp>
+#include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/layers/custom_layer.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/style/layers/symbol_layer_impl.hpp>
+#include <mbgl/style/parser.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/text/glyph_cache.hpp>
+#include <mbgl/text/glyph_pbf_worker.hpp>
+#include <mbgl/text/line_measurements.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/interned_string.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+/*
+   The phases of laying out a tile in `GeometryTileWorker`, timed separately: parsing the tile,
+   building the buckets of each type of layer, indexing their features, and preparing and
+   placing the symbols. Each phase runs the components the worker runs, in the same order and
+   with the same parameters, for the layers a Streets style shows at the zoom level of the tile.
+*/
+
+namespace {
+
+struct LayoutCase {
+    const char* name;
+    const char* fixture;
+    OverscaledTileID id;
+};
+
+// Mapbox Streets v7 tiles: lower Manhattan, and the San Francisco Bay Area at z10 and
+// overscaled to z14, as a map shows a source whose last zoom level is z10.
+const LayoutCase cases[] = {
+    { "urban z16", "benchmark/fixtures/tile/15-9648-12318.vector.pbf", { 16, 15, 9648, 12318 } },
+    { "regional z10", "benchmark/fixtures/tile/10-163-395.vector.pbf", { 10, 10, 163, 395 } },
+    { "regional z14", "benchmark/fixtures/tile/10-163-395.vector.pbf", { 14, 10, 163, 395 } },
+};
+
+const char* const layerTypes[] = {
+    "fill", "line", "circle", "fill-extrusion", "symbol",
+};
+
+const char* layerType(const Layer& layer) {
+    if (layer.is<FillLayer>()) {
+        return layerTypes[0];
+    } else if (layer.is<LineLayer>()) {
+        return layerTypes[1];
+    } else if (layer.is<CircleLayer>()) {
+        return layerTypes[2];
+    } else if (layer.is<FillExtrusionLayer>()) {
+        return layerTypes[3];
+    } else if (layer.is<SymbolLayer>()) {
+        return layerTypes[4];
+    }
+    return "";
+}
+
+// The glyphs of the style's fonts are all drawn from the one range in the fixtures, so that
+// labels are shaped without requests.
+void addGlyphs(const std::string& styleJSON) {
+    Parser parser;
+    parser.parse(styleJSON);
+
+    const auto glyphs = std::make_shared<const GlyphCache::Glyphs>(parseGlyphPBF({ 0, 255 },
+        std::make_shared<const std::string>(util::read_file("benchmark/fixtures/tile/glyphs.0-255.pbf"))));
+    const auto empty = std::make_shared<const GlyphCache::Glyphs>();
+
+    for (const FontStack& fontStack : parser.fontStacks()) {
+        for (uint32_t i = 0; i < GLYPH_RANGES_PER_FONT_STACK; i++) {
+            const GlyphRange range(i * GLYPHS_PER_GLYPH_RANGE, i * GLYPHS_PER_GLYPH_RANGE + GLYPHS_PER_GLYPH_RANGE - 1);
+            GlyphCache::shared().put(Resource::glyphs(parser.glyphURL, fontStack, range).url,
+                                     i == 0 ? glyphs : empty);
+        }
+    }
+}
+
+class LayoutBenchmark {
+public:
+    LayoutBenchmark(const LayoutCase& layoutCase)
+        : id(layoutCase.id),
+          tileData(std::make_shared<const std::string>(util::read_file(layoutCase.fixture))),
+          data(tileData) {
+        NetworkStatus::Set(NetworkStatus::Status::Offline);
+        fileSource.setAccessToken("foobar");
+
+        const std::string json = util::read_file("benchmark/fixtures/api/query_style.json");
+        addGlyphs(json);
+        style.setJSON(json);
+        while (!style.spriteAtlas->isLoaded()) {
+            loop.runOnce();
+        }
+
+        style.cascade(Clock::now(), MapMode::Still);
+        style.recalculate(id.overscaledZ, Clock::now(), MapMode::Still);
+
+        // The layers `GeometryTile::setLayers` gives the worker.
+        for (const Layer* layer : style.getLayers()) {
+            if (layer->is<BackgroundLayer>() ||
+                layer->is<CustomLayer>() ||
+                layer->baseImpl->source != "composite" ||
+                id.overscaledZ < std::floor(layer->baseImpl->minZoom) ||
+                id.overscaledZ >= std::ceil(layer->baseImpl->maxZoom) ||
+                layer->baseImpl->visibility == VisibilityType::None) {
+                continue;
+            }
+            layoutKey(*layer);
+            layers.push_back(layer->baseImpl->clone());
+        }
+
+        for (auto& group : groupByLayout(layers)) {
+            if (data.getLayer(group.at(0)->baseImpl->sourceLayer)) {
+                groups.push_back(std::move(group));
+            }
+        }
+    }
+
+    std::vector<const std::vector<const Layer*>*> groupsOfType(const std::string& type) const {
+        std::vector<const std::vector<const Layer*>*> result;
+        for (const auto& group : groups) {
+            if (layerType(*group.at(0)) == type) {
+                result.push_back(&group);
+            }
+        }
+        return result;
+    }
+
+    // Like `GeometryTileWorker::layoutGroup`, for groups of layers other than symbol layers.
+    std::shared_ptr<Bucket> buildBucket(const std::vector<const Layer*>& group) {
+        const Layer& leader = *group.at(0);
+        const GeometryTileLayer& geometryLayer = *data.getLayer(leader.baseImpl->sourceLayer);
+        const CompiledFilter filter(leader.baseImpl->filter);
+        std::shared_ptr<Bucket> bucket = leader.baseImpl->createBucket(parameters, group);
+
+        for (std::size_t i = 0; i < geometryLayer.featureCount(); i++) {
+            std::unique_ptr<GeometryTileFeature> feature = geometryLayer.getFeature(i);
+            if (!filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); })) {
+                continue;
+            }
+            feature->readGeometries(geometries);
+            bucket->addFeature(*feature, geometries, i);
+        }
+
+        return bucket;
+    }
+
+    std::unique_ptr<SymbolLayout> createSymbolLayout(const std::vector<const Layer*>& group) {
+        const Layer& leader = *group.at(0);
+        return leader.as<SymbolLayer>()->impl->createLayout(parameters, group,
+            *data.getLayer(leader.baseImpl->sourceLayer));
+    }
+
+    // In the order they are placed in, from the top layer down, once their glyphs are loaded.
+    std::vector<std::unique_ptr<SymbolLayout>> createSymbolLayouts() {
+        std::vector<std::unique_ptr<SymbolLayout>> result;
+        const auto symbolGroups = groupsOfType("symbol");
+        for (auto it = symbolGroups.rbegin(); it != symbolGroups.rend(); it++) {
+            result.push_back(createSymbolLayout(**it));
+        }
+
+        while (!std::all_of(result.begin(), result.end(), [&] (const auto& layout) {
+            return layout->canPrepare(*style.glyphAtlas);
+        })) {
+            loop.runOnce();
+        }
+
+        return result;
+    }
+
+    void prepare(std::vector<std::unique_ptr<SymbolLayout>>& layouts) {
+        LineMeasurementCache lineMeasurements;
+        for (auto& layout : layouts) {
+            layout->state = SymbolLayout::Prepared;
+            layout->prepare(reinterpret_cast<uintptr_t>(this), *style.glyphAtlas, lineMeasurements);
+        }
+    }
+
+    util::RunLoop loop;
+    DefaultFileSource fileSource { "benchmark/fixtures/api/cache.db", "." };
+    ThreadPool threadPool { 4 };
+    Style style { threadPool, fileSource, 1.0 };
+
+    const OverscaledTileID id;
+    const std::atomic<bool> obsolete { false };
+    const BucketParameters parameters { id, MapMode::Still, obsolete, nullptr, 1.0 };
+
+    const std::shared_ptr<const std::string> tileData;
+    VectorTileData data;
+
+    std::vector<std::unique_ptr<Layer>> layers;
+
+    // Groups with a source layer in the tile, in style order.
+    std::vector<std::vector<const Layer*>> groups;
+
+    GeometryBuffer geometries;
+};
+
+} // end namespace
+
+static void TileLayout_Parse(::benchmark::State& state) {
+    const LayoutCase& layoutCase = cases[state.range(0)];
+    LayoutBenchmark bench(layoutCase);
+
+    mbgl::benchmark::AllocationCounter allocations;
+    while (state.KeepRunning()) {
+        VectorTileData data(bench.tileData);
+        for (const auto& group : bench.groups) {
+            ::benchmark::DoNotOptimize(data.getLayer(group.at(0)->baseImpl->sourceLayer));
+        }
+    }
+
+    state.SetLabel(allocations.label(state, layoutCase.name));
+}
+
+// Symbol layers collect and shape their features when their layout is created.
+static void TileLayout_Buckets(::benchmark::State& state) {
+    const LayoutCase& layoutCase = cases[state.range(0)];
+    const std::string type = layerTypes[state.range(1)];
+    LayoutBenchmark bench(layoutCase);
+    const auto groups = bench.groupsOfType(type);
+
+    mbgl::benchmark::AllocationCounter allocations;
+    while (state.KeepRunning()) {
+        for (const auto& group : groups) {
+            if (type == "symbol") {
+                ::benchmark::DoNotOptimize(bench.createSymbolLayout(*group));
+            } else {
+                ::benchmark::DoNotOptimize(bench.buildBucket(*group));
+            }
+        }
+    }
+
+    state.SetLabel(allocations.label(state, std::string(layoutCase.name) + " " + type + ", " +
+                                     std::to_string(groups.size()) + " groups"));
+}
+
+static void TileLayout_FeatureIndex(::benchmark::State& state) {
+    const LayoutCase& layoutCase = cases[state.range(0)];
+    LayoutBenchmark bench(layoutCase);
+
+    struct IndexedGroup {
+        std::string bucketName;
+        std::vector<std::string> layerIDs;
+        uint32_t sourceLayerID;
+        uint32_t bucketID;
+        std::vector<std::size_t> indices;
+        std::vector<GeometryBuffer> geometries;
+    };
+
+    // The geometries are read by the buckets' phase.
+    std::vector<IndexedGroup> indexedGroups;
+    for (const auto& group : bench.groups) {
+        const Layer& leader = *group.at(0);
+        if (leader.is<SymbolLayer>()) {
+            continue;
+        }
+
+        indexedGroups.emplace_back();
+        IndexedGroup& indexed = indexedGroups.back();
+        indexed.bucketName = leader.getID();
+        for (const auto& layer : group) {
+            indexed.layerIDs.push_back(layer->getID());
+        }
+        indexed.sourceLayerID = util::internString(leader.baseImpl->sourceLayer);
+        indexed.bucketID = util::internString(leader.getID());
+
+        const GeometryTileLayer& geometryLayer = *bench.data.getLayer(leader.baseImpl->sourceLayer);
+        const CompiledFilter filter(leader.baseImpl->filter);
+        for (std::size_t i = 0; i < geometryLayer.featureCount(); i++) {
+            auto feature = geometryLayer.getFeature(i);
+            if (filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); })) {
+                indexed.indices.push_back(i);
+                indexed.geometries.emplace_back();
+                feature->readGeometries(indexed.geometries.back());
+            }
+        }
+    }
+
+    mbgl::benchmark::AllocationCounter allocations;
+    while (state.KeepRunning()) {
+        FeatureIndex featureIndex;
+        for (const auto& indexed : indexedGroups) {
+            featureIndex.setBucketLayerIDs(indexed.bucketName, indexed.layerIDs);
+            FeatureIndex::Pending pending;
+            for (std::size_t i = 0; i < indexed.indices.size(); i++) {
+                pending.insert(indexed.geometries[i], indexed.indices[i], indexed.sourceLayerID, indexed.bucketID);
+            }
+            featureIndex.insert(pending);
+        }
+        ::benchmark::DoNotOptimize(featureIndex);
+    }
+
+    state.SetLabel(allocations.label(state, layoutCase.name));
+}
+
+static void TileLayout_SymbolPrepare(::benchmark::State& state) {
+    const LayoutCase& layoutCase = cases[state.range(0)];
+    LayoutBenchmark bench(layoutCase);
+
+    mbgl::benchmark::AllocationCounter allocations;
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        allocations.pause();
+        auto layouts = bench.createSymbolLayouts();
+        allocations.resume();
+        state.ResumeTiming();
+
+        bench.prepare(layouts);
+
+        state.PauseTiming();
+        allocations.pause();
+        layouts.clear();
+        bench.style.glyphAtlas->removeGlyphs(reinterpret_cast<uintptr_t>(&bench));
+        allocations.resume();
+        state.ResumeTiming();
+    }
+
+    state.SetLabel(allocations.label(state, layoutCase.name));
+}
+
+static void TileLayout_SymbolPlace(::benchmark::State& state) {
+    const LayoutCase& layoutCase = cases[state.range(0)];
+    LayoutBenchmark bench(layoutCase);
+    auto layouts = bench.createSymbolLayouts();
+    bench.prepare(layouts);
+
+    mbgl::benchmark::AllocationCounter allocations;
+    while (state.KeepRunning()) {
+        CollisionTile collisionTile { PlacementConfig() };
+        for (auto& layout : layouts) {
+            if (layout->hasSymbolInstances()) {
+                ::benchmark::DoNotOptimize(layout->place(collisionTile));
+            }
+        }
+    }
+
+    state.SetLabel(allocations.label(state, layoutCase.name));
+}
+
+static void LayoutCases(::benchmark::internal::Benchmark* b) {
+    for (std::size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        b->Arg(i);
+    }
+}
+
+static void LayoutCasesByLayerType(::benchmark::internal::Benchmark* b) {
+    for (std::size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        for (std::size_t j = 0; j < sizeof(layerTypes) / sizeof(layerTypes[0]); j++) {
+            b->ArgPair(i, j);
+        }
+    }
+}
+
+BENCHMARK(TileLayout_Parse)->Apply(LayoutCases);
+BENCHMARK(TileLayout_Buckets)->Apply(LayoutCasesByLayerType);
+BENCHMARK(TileLayout_FeatureIndex)->Apply(LayoutCases);
+BENCHMARK(TileLayout_SymbolPrepare)->Apply(LayoutCases);
+BENCHMARK(TileLayout_SymbolPlace)->Apply(LayoutCases);
@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/i18n.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Place and street names in the scripts labels are commonly written in.
+const std::vector<std::u16string> labels = {
+    u"Broadway", u"Avenue des Champs-Élysées", u"Straße des 17. Juni", u"Piazza San Marco",
+    u"Москва", u"Невский проспект", u"Αθήνα", u"القاهرة", u"شارع الملك فهد", u"תל אביב-יפו",
+    u"दिल्ली", u"กรุงเทพมหานคร", u"北京市", u"长安街", u"東京都", u"渋谷スクランブル交差点",
+    u"ホテル・ニューオータニ", u"서울특별시", u"세종대로", u"香港（中環）", u"「新宿」駅",
+};
+
+} // end namespace
+
+static void I18n_AllowsWordBreaking(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        std::size_t count = 0;
+        for (const auto& label : labels) {
+            for (char16_t chr : label) {
+                count += util::i18n::allowsWordBreaking(chr) || util::i18n::allowsIdeographicBreaking(chr);
+            }
+        }
+        benchmark::DoNotOptimize(count);
+    }
+}
+
+static void I18n_VerticalOrientation(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        std::size_t count = 0;
+        for (const auto& label : labels) {
+            for (char16_t chr : label) {
+                count += util::i18n::hasUprightVerticalOrientation(chr) + util::i18n::hasRotatedVerticalOrientation(chr);
+            }
+        }
+        benchmark::DoNotOptimize(count);
+    }
+}
+
+static void I18n_AllowsVerticalWritingMode(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        std::size_t count = 0;
+        for (const auto& label : labels) {
+            count += util::i18n::allowsVerticalWritingMode(label);
+        }
+        benchmark::DoNotOptimize(count);
+    }
+}
+
+static void I18n_VerticalizePunctuation(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        for (const auto& label : labels) {
+            benchmark::DoNotOptimize(util::i18n::verticalizePunctuation(label));
+        }
+    }
+}
+
+BENCHMARK(I18n_AllowsWordBreaking);
+BENCHMARK(I18n_VerticalOrientation);
+BENCHMARK(I18n_AllowsVerticalWritingMode);
+BENCHMARK(I18n_VerticalizePunctuation);
@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/premultiply.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// A raster tile of the given size, with gradients in every channel and translucent pixels.
+PremultipliedImage rasterTile(uint32_t size) {
+    PremultipliedImage image({ size, size });
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            uint8_t* pixel = image.data.get() + 4 * (y * size + x);
+            pixel[3] = x < size / 2 ? 255 : (x + y) % 256;
+            pixel[0] = x % 256 * pixel[3] / 255;
+            pixel[1] = y % 256 * pixel[3] / 255;
+            pixel[2] = (x ^ y) % 256 * pixel[3] / 255;
+        }
+    }
+    return image;
+}
+
+} // end namespace
+
+static void Image_Premultiply(benchmark::State& state) {
+    UnassociatedImage image = util::unpremultiply(rasterTile(state.range(0)));
+    while (state.KeepRunning()) {
+        PremultipliedImage result = util::premultiply(std::move(image));
+        image = UnassociatedImage(result.size, std::move(result.data));
+    }
+    state.SetBytesProcessed(state.iterations() * image.bytes());
+}
+
+static void Image_Unpremultiply(benchmark::State& state) {
+    PremultipliedImage image = rasterTile(state.range(0));
+    while (state.KeepRunning()) {
+        UnassociatedImage result = util::unpremultiply(std::move(image));
+        image = PremultipliedImage(result.size, std::move(result.data));
+    }
+    state.SetBytesProcessed(state.iterations() * image.bytes());
+}
+
+static void Image_DecodePNG(benchmark::State& state) {
+    const std::string png = encodePNG(rasterTile(state.range(0)));
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(decodeImage(png));
+    }
+}
+
+static void Image_DecodeUnassociatedPNG(benchmark::State& state) {
+    const std::string png = encodePNG(rasterTile(state.range(0)));
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(decodeUnassociatedImage(png));
+    }
+}
+
+static void Image_EncodePNG(benchmark::State& state) {
+    const PremultipliedImage image = rasterTile(state.range(0));
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(encodePNG(image));
+    }
+}
+
+BENCHMARK(Image_Premultiply)->Arg(512)->Arg(1024);
+BENCHMARK(Image_Unpremultiply)->Arg(512)->Arg(1024);
+BENCHMARK(Image_DecodePNG)->Arg(512)->Arg(1024);
+BENCHMARK(Image_DecodeUnassociatedPNG)->Arg(512)->Arg(1024);
+BENCHMARK(Image_EncodePNG)->Arg(512)->Arg(1024);
@@ -1,6 +1,7 @@
 #include <mbgl/map/map.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
+#include <mbgl/util/trace.hpp>
 #include <mbgl/util/run_loop.hpp>
 
 #include <mbgl/gl/headless_backend.hpp>
@@ -18,8 +19,83 @@
 
 namespace po = boost::program_options;
 
+#include <chrono>
+#include <condition_variable>
 #include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+// A viewport to render in batch mode, one per line of the batch file:
+//
+//     output lon lat zoom [bearing [pitch [width [height]]]]
+//
+// Omitted fields take the values given on the command line.
+struct BatchEntry {
+    std::string output;
+    double lon;
+    double lat;
+    double zoom;
+    double bearing;
+    double pitch;
+    uint32_t width;
+    uint32_t height;
+};
+
+// Encodes and writes images on a thread of its own, while the next ones render.
+class ImageWriter {
+public:
+    ImageWriter() : thread([this] { run(); }) {}
+
+    ~ImageWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        condition.notify_one();
+        thread.join();
+    }
+
+    void write(std::string path, mbgl::PremultipliedImage image) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.emplace_back(std::move(path), std::move(image));
+        }
+        condition.notify_one();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            condition.wait(lock, [this] { return done || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            auto item = std::move(queue.front());
+            queue.pop_front();
+
+            lock.unlock();
+            mbgl::util::write_file(item.first, mbgl::encodePNG(item.second));
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::pair<std::string, mbgl::PremultipliedImage>> queue;
+    bool done = false;
+    std::thread thread;
+};
+
+} // namespace
 
 int main(int argc, char *argv[]) {
     std::string style_path;
@@ -36,6 +112,8 @@ int main(int argc, char *argv[]) {
     std::string asset_root = ".";
     std::vector<std::string> classes;
     std::string token;
+    std::string batch;
+    std::string trace;
     bool debug = false;
 
     po::options_description desc("Allowed options");
@@ -53,6 +131,8 @@ int main(int argc, char *argv[]) {
         ("token,t", po::value(&token)->value_name("key")->default_value(token), "Mapbox access token")
         ("debug", po::bool_switch(&debug)->default_value(debug), "Debug mode")
         ("output,o", po::value(&output)->value_name("file")->default_value(output), "Output file name")
+        ("batch", po::value(&batch)->value_name("file"), "Renders each viewport listed in the file, or on stdin for -, with the same map")
+        ("trace", po::value(&trace)->value_name("file"), "Writes a trace of the rendering to the file, for chrome://tracing; needs WITH_TRACING")
         ("cache,d", po::value(&cache_file)->value_name("file")->default_value(cache_file), "Cache database file name")
         ("assets,d", po::value(&asset_root)->value_name("file")->default_value(asset_root), "Directory to which asset:// URLs will resolve")
     ;
@@ -68,6 +148,19 @@ int main(int argc, char *argv[]) {
 
     using namespace mbgl;
 
+    if (!trace.empty()) {
+        if (!util::trace::available()) {
+            std::cout << "Warning: tracing isn't compiled in; configure with -DWITH_TRACING=ON" << std::endl;
+        }
+        util::trace::start();
+    }
+
+    auto writeTrace = [&] {
+        if (!trace.empty() && !util::trace::write(trace)) {
+            std::cout << "Error: couldn't write " << trace << std::endl;
+        }
+    };
+
     util::RunLoop loop;
     DefaultFileSource fileSource(cache_file, asset_root);
 
@@ -105,6 +198,87 @@ int main(int argc, char *argv[]) {
         map.setDebug(debug ? mbgl::MapDebugOptions::TileBorders | mbgl::MapDebugOptions::ParseStatus : mbgl::MapDebugOptions::NoDebug);
     }
 
+    if (!batch.empty()) {
+        std::ifstream file;
+        if (batch != "-") {
+            file.open(batch);
+            if (!file) {
+                std::cout << "Error: can't open " << batch << std::endl;
+                exit(1);
+            }
+        }
+        std::istream& input = batch == "-" ? std::cin : file;
+
+        std::vector<BatchEntry> entries;
+        std::string line;
+        while (std::getline(input, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            BatchEntry entry { {}, lon, lat, zoom, bearing, pitch, width, height };
+            std::istringstream fields(line);
+            if (!(fields >> entry.output >> entry.lon >> entry.lat >> entry.zoom)) {
+                std::cout << "Error: invalid batch line: " << line << std::endl;
+                exit(1);
+            }
+            fields >> entry.bearing >> entry.pitch >> entry.width >> entry.height;
+            entries.push_back(std::move(entry));
+        }
+
+        // The view is only made again when the size changes.
+        std::unique_ptr<OffscreenView> batchView;
+        ImageWriter writer;
+        std::size_t index = 0;
+        const auto batchStart = std::chrono::steady_clock::now();
+
+        std::function<void ()> renderNext = [&] {
+            if (index == entries.size()) {
+                const auto total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - batchStart);
+                std::cout << "rendered " << entries.size() << " images in " << total.count() << " ms" << std::endl;
+                loop.stop();
+                return;
+            }
+
+            const BatchEntry& entry = entries[index];
+            const Size size { entry.width * pixelRatio, entry.height * pixelRatio };
+            if (!batchView || batchView->getSize() != size) {
+                batchView = std::make_unique<OffscreenView>(backend.getContext(), size);
+            }
+
+            map.setSize({ entry.width, entry.height });
+            map.setLatLngZoom({ entry.lat, entry.lon }, entry.zoom);
+            map.setBearing(entry.bearing);
+            map.setPitch(entry.pitch);
+
+            const auto start = std::chrono::steady_clock::now();
+            map.renderStill(*batchView, [&, start](std::exception_ptr error) {
+                try {
+                    if (error) {
+                        std::rethrow_exception(error);
+                    }
+                } catch(std::exception& e) {
+                    std::cout << "Error: " << entries[index].output << ": " << e.what() << std::endl;
+                    exit(1);
+                }
+
+                writer.write(entries[index].output, batchView->readStillImage());
+
+                const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+                std::cout << entries[index].output << "\t" << elapsed.count() << " ms" << std::endl;
+
+                // Render the next viewport once this render call returns.
+                index++;
+                loop.invoke(renderNext);
+            });
+        };
+
+        renderNext();
+        loop.run();
+        writeTrace();
+
+        return 0;
+    }
+
     map.renderStill(view, [&](std::exception_ptr error) {
         try {
             if (error) {
@@ -120,6 +294,7 @@ int main(int argc, char *argv[]) {
     });
 
     loop.run();
+    writeTrace();
 
     return 0;
 }
@@ -1,20 +1,54 @@
 # Do not edit. Regenerate this with ./scripts/generate-benchmark-files.sh
 
 set(MBGL_BENCHMARK_FILES
+    # actor
+    benchmark/actor/actor.benchmark.cpp
+    benchmark/actor/thread_pool.benchmark.cpp
+
+    # annotation
+    benchmark/annotation/annotation_manager.benchmark.cpp
+
     # api
     benchmark/api/query.benchmark.cpp
+    benchmark/api/render.benchmark.cpp
 
     # include/mbgl
     benchmark/include/mbgl/benchmark.hpp
 
     # parse
     benchmark/parse/filter.benchmark.cpp
+    benchmark/parse/geojson.benchmark.cpp
+    benchmark/parse/style.benchmark.cpp
+    benchmark/parse/vector_tile.benchmark.cpp
+
+    # renderer
+    benchmark/renderer/line_bucket.benchmark.cpp
 
     # src
     benchmark/src/main.cpp
 
     # src/mbgl/benchmark
+    benchmark/src/mbgl/benchmark/allocations.cpp
+    benchmark/src/mbgl/benchmark/allocations.hpp
     benchmark/src/mbgl/benchmark/benchmark.cpp
     benchmark/src/mbgl/benchmark/util.cpp
     benchmark/src/mbgl/benchmark/util.hpp
+
+    # storage
+    benchmark/storage/offline_database.benchmark.cpp
+
+    # style
+    benchmark/style/supercluster.benchmark.cpp
+
+    # text
+    benchmark/text/collision_tile.benchmark.cpp
+    benchmark/text/get_anchors.benchmark.cpp
+    benchmark/text/shaping.benchmark.cpp
+
+    # tile
+    benchmark/tile/layout.benchmark.cpp
+
+    # util
+    benchmark/util/i18n.benchmark.cpp
+    benchmark/util/image.benchmark.cpp
 )
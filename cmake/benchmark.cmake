@@ -19,8 +19,35 @@ target_link_libraries(mbgl-benchmark
 )
 
 target_add_mason_package(mbgl-benchmark PRIVATE benchmark)
+target_add_mason_package(mbgl-benchmark PRIVATE geojson)
+target_add_mason_package(mbgl-benchmark PRIVATE kdbush)
+target_add_mason_package(mbgl-benchmark PRIVATE protozero)
 target_add_mason_package(mbgl-benchmark PRIVATE rapidjson)
+target_add_mason_package(mbgl-benchmark PRIVATE supercluster)
 
 mbgl_platform_benchmark()
 
 create_source_groups(mbgl-benchmark)
+
+# Runs the benchmarks repeatedly and compares them with the results of an earlier run, failing
+# on significant regressions. The baseline is made the same way, with
+# `scripts/benchmark-compare.js run <mbgl-benchmark> <baseline.json>`.
+set(MBGL_BENCHMARK_BASELINE "" CACHE FILEPATH "Benchmark results to compare mbgl-benchmark with")
+set(MBGL_BENCHMARK_THRESHOLD "0.05" CACHE STRING "Relative slowdown above which a benchmark is a regression")
+
+if(MBGL_BENCHMARK_BASELINE)
+    add_custom_command(
+        OUTPUT "${CMAKE_CURRENT_BINARY_DIR}/benchmark-results.json"
+        COMMAND ${NodeJS_EXECUTABLE} scripts/benchmark-compare.js run $<TARGET_FILE:mbgl-benchmark> "${CMAKE_CURRENT_BINARY_DIR}/benchmark-results.json"
+        WORKING_DIRECTORY "${CMAKE_SOURCE_DIR}"
+        DEPENDS mbgl-benchmark
+        COMMENT "Running mbgl-benchmark..."
+    )
+
+    add_custom_target(mbgl-benchmark-compare
+        COMMAND ${NodeJS_EXECUTABLE} scripts/benchmark-compare.js compare "${MBGL_BENCHMARK_BASELINE}" "${CMAKE_CURRENT_BINARY_DIR}/benchmark-results.json" --threshold ${MBGL_BENCHMARK_THRESHOLD}
+        WORKING_DIRECTORY "${CMAKE_SOURCE_DIR}"
+        DEPENDS "${CMAKE_CURRENT_BINARY_DIR}/benchmark-results.json"
+        COMMENT "Comparing the benchmarks with ${MBGL_BENCHMARK_BASELINE}..."
+    )
+endif()
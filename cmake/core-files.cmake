@@ -6,8 +6,13 @@ set(MBGL_CORE_FILES
     src/mbgl/actor/actor_ref.hpp
     src/mbgl/actor/mailbox.cpp
     src/mbgl/actor/mailbox.hpp
+    src/mbgl/actor/message.cpp
     src/mbgl/actor/message.hpp
     src/mbgl/actor/scheduler.hpp
+    src/mbgl/actor/scheduler_stats.cpp
+    src/mbgl/actor/scheduler_stats.hpp
+    src/mbgl/actor/task_group.cpp
+    src/mbgl/actor/task_group.hpp
 
     # algorithm
     src/mbgl/algorithm/covered_by_children.hpp
@@ -69,19 +74,27 @@ set(MBGL_CORE_FILES
     src/mbgl/gl/extension.hpp
     src/mbgl/gl/framebuffer.hpp
     src/mbgl/gl/gl.cpp
+    src/mbgl/gl/half_float.hpp
     src/mbgl/gl/index_buffer.hpp
+    src/mbgl/gl/instancing.cpp
+    src/mbgl/gl/instancing.hpp
     src/mbgl/gl/normalization.hpp
     src/mbgl/gl/object.cpp
     src/mbgl/gl/object.hpp
     src/mbgl/gl/primitives.hpp
     src/mbgl/gl/program.hpp
+    src/mbgl/gl/program_binary.cpp
+    src/mbgl/gl/program_binary.hpp
     src/mbgl/gl/renderbuffer.hpp
     src/mbgl/gl/segment.cpp
     src/mbgl/gl/segment.hpp
+    src/mbgl/gl/shared_resources.hpp
     src/mbgl/gl/state.hpp
     src/mbgl/gl/stencil_mode.cpp
     src/mbgl/gl/stencil_mode.hpp
     src/mbgl/gl/texture.hpp
+    src/mbgl/gl/timer_query.cpp
+    src/mbgl/gl/timer_query.hpp
     src/mbgl/gl/types.hpp
     src/mbgl/gl/uniform.cpp
     src/mbgl/gl/uniform.hpp
@@ -106,14 +119,26 @@ set(MBGL_CORE_FILES
     include/mbgl/map/backend.hpp
     include/mbgl/map/backend_scope.hpp
     include/mbgl/map/camera.hpp
+    include/mbgl/map/frame_stats.hpp
+    include/mbgl/map/gl_resource_stats.hpp
+    include/mbgl/map/layer_profile.hpp
     include/mbgl/map/map.hpp
+    include/mbgl/map/memory_stats.hpp
     include/mbgl/map/mode.hpp
     include/mbgl/map/query.hpp
+    include/mbgl/map/render_stats.hpp
+    include/mbgl/map/rendering_policy.hpp
+    include/mbgl/map/still_image_stats.hpp
+    include/mbgl/map/tile_load_stats.hpp
     include/mbgl/map/view.hpp
     src/mbgl/map/backend.cpp
     src/mbgl/map/backend_scope.cpp
     src/mbgl/map/change.hpp
+    src/mbgl/map/gl_resource_stats.cpp
+    src/mbgl/map/layer_profile.cpp
     src/mbgl/map/map.cpp
+    src/mbgl/map/memory_stats.cpp
+    src/mbgl/map/tile_load_stats.cpp
     src/mbgl/map/transform.cpp
     src/mbgl/map/transform.hpp
     src/mbgl/map/transform_state.cpp
@@ -134,11 +159,16 @@ set(MBGL_CORE_FILES
 
     # programs
     src/mbgl/programs/attributes.hpp
+    src/mbgl/programs/binary_program.cpp
+    src/mbgl/programs/binary_program.hpp
     src/mbgl/programs/circle_program.cpp
     src/mbgl/programs/circle_program.hpp
     src/mbgl/programs/collision_box_program.cpp
     src/mbgl/programs/collision_box_program.hpp
     src/mbgl/programs/debug_program.hpp
+    src/mbgl/programs/extrusion_texture_program.hpp
+    src/mbgl/programs/fill_extrusion_program.cpp
+    src/mbgl/programs/fill_extrusion_program.hpp
     src/mbgl/programs/fill_program.cpp
     src/mbgl/programs/fill_program.hpp
     src/mbgl/programs/line_program.cpp
@@ -148,20 +178,31 @@ set(MBGL_CORE_FILES
     src/mbgl/programs/programs.hpp
     src/mbgl/programs/raster_program.cpp
     src/mbgl/programs/raster_program.hpp
+    src/mbgl/programs/shader_variant.cpp
+    src/mbgl/programs/shader_variant.hpp
     src/mbgl/programs/symbol_program.cpp
     src/mbgl/programs/symbol_program.hpp
     src/mbgl/programs/uniforms.hpp
 
     # renderer
+    src/mbgl/renderer/bucket.cpp
     src/mbgl/renderer/bucket.hpp
     src/mbgl/renderer/circle_bucket.cpp
     src/mbgl/renderer/circle_bucket.hpp
     src/mbgl/renderer/debug_bucket.cpp
     src/mbgl/renderer/debug_bucket.hpp
+    src/mbgl/renderer/fill_batch.cpp
+    src/mbgl/renderer/fill_batch.hpp
     src/mbgl/renderer/fill_bucket.cpp
     src/mbgl/renderer/fill_bucket.hpp
+    src/mbgl/renderer/fill_extrusion_bucket.cpp
+    src/mbgl/renderer/fill_extrusion_bucket.hpp
+    src/mbgl/renderer/fill_triangulation_cache.cpp
+    src/mbgl/renderer/fill_triangulation_cache.hpp
     src/mbgl/renderer/frame_history.cpp
     src/mbgl/renderer/frame_history.hpp
+    src/mbgl/renderer/gpu_timer.cpp
+    src/mbgl/renderer/gpu_timer.hpp
     src/mbgl/renderer/line_bucket.cpp
     src/mbgl/renderer/line_bucket.hpp
     src/mbgl/renderer/paint_parameters.hpp
@@ -172,6 +213,7 @@ set(MBGL_CORE_FILES
     src/mbgl/renderer/painter_clipping.cpp
     src/mbgl/renderer/painter_debug.cpp
     src/mbgl/renderer/painter_fill.cpp
+    src/mbgl/renderer/painter_fill_extrusion.cpp
     src/mbgl/renderer/painter_line.cpp
     src/mbgl/renderer/painter_raster.cpp
     src/mbgl/renderer/painter_symbol.cpp
@@ -183,6 +225,8 @@ set(MBGL_CORE_FILES
     src/mbgl/renderer/render_tile.hpp
     src/mbgl/renderer/symbol_bucket.cpp
     src/mbgl/renderer/symbol_bucket.hpp
+    src/mbgl/renderer/upload_scheduler.cpp
+    src/mbgl/renderer/upload_scheduler.hpp
 
     # shaders
     src/mbgl/shaders/circle.cpp
@@ -191,8 +235,12 @@ set(MBGL_CORE_FILES
     src/mbgl/shaders/collision_box.hpp
     src/mbgl/shaders/debug.cpp
     src/mbgl/shaders/debug.hpp
+    src/mbgl/shaders/extrusion_texture.cpp
+    src/mbgl/shaders/extrusion_texture.hpp
     src/mbgl/shaders/fill.cpp
     src/mbgl/shaders/fill.hpp
+    src/mbgl/shaders/fill_extrusion.cpp
+    src/mbgl/shaders/fill_extrusion.hpp
     src/mbgl/shaders/fill_outline.cpp
     src/mbgl/shaders/fill_outline.hpp
     src/mbgl/shaders/fill_outline_pattern.cpp
@@ -224,14 +272,20 @@ set(MBGL_CORE_FILES
     # storage
     include/mbgl/storage/default_file_source.hpp
     include/mbgl/storage/file_source.hpp
+    include/mbgl/storage/file_source_stats.hpp
     include/mbgl/storage/network_status.hpp
     include/mbgl/storage/offline.hpp
     include/mbgl/storage/online_file_source.hpp
     include/mbgl/storage/resource.hpp
     include/mbgl/storage/response.hpp
     src/mbgl/storage/asset_file_source.hpp
+    src/mbgl/storage/concurrency_limit.cpp
+    src/mbgl/storage/concurrency_limit.hpp
+    src/mbgl/storage/file_source_stats.cpp
+    src/mbgl/storage/file_source_stats_recorder.hpp
     src/mbgl/storage/http_file_source.hpp
     src/mbgl/storage/local_file_source.hpp
+    src/mbgl/storage/mbtiles_file_source.hpp
     src/mbgl/storage/network_status.cpp
     src/mbgl/storage/resource.cpp
     src/mbgl/storage/response.cpp
@@ -247,11 +301,15 @@ set(MBGL_CORE_FILES
     include/mbgl/style/transition_options.hpp
     include/mbgl/style/types.hpp
     include/mbgl/style/undefined.hpp
+    src/mbgl/style/binary_style.cpp
+    src/mbgl/style/binary_style.hpp
     src/mbgl/style/bucket_parameters.cpp
     src/mbgl/style/bucket_parameters.hpp
     src/mbgl/style/cascade_parameters.hpp
     src/mbgl/style/class_dictionary.cpp
     src/mbgl/style/class_dictionary.hpp
+    src/mbgl/style/compiled_filter.cpp
+    src/mbgl/style/compiled_filter.hpp
     src/mbgl/style/cross_faded_property_evaluator.cpp
     src/mbgl/style/cross_faded_property_evaluator.hpp
     src/mbgl/style/data_driven_property_evaluator.hpp
@@ -279,6 +337,8 @@ set(MBGL_CORE_FILES
     src/mbgl/style/source_observer.hpp
     src/mbgl/style/style.cpp
     src/mbgl/style/style.hpp
+    src/mbgl/style/style_optimizer.cpp
+    src/mbgl/style/style_optimizer.hpp
     src/mbgl/style/tile_source_impl.cpp
     src/mbgl/style/tile_source_impl.hpp
     src/mbgl/style/types.cpp
@@ -299,6 +359,8 @@ set(MBGL_CORE_FILES
     include/mbgl/style/conversion/source.hpp
     include/mbgl/style/conversion/tileset.hpp
     include/mbgl/style/conversion/transition_options.hpp
+    src/mbgl/style/conversion/geojson_reader.cpp
+    src/mbgl/style/conversion/geojson_reader.hpp
     src/mbgl/style/conversion/stringify.hpp
 
     # style/function
@@ -367,9 +429,13 @@ set(MBGL_CORE_FILES
     include/mbgl/style/sources/geojson_source.hpp
     include/mbgl/style/sources/raster_source.hpp
     include/mbgl/style/sources/vector_source.hpp
+    src/mbgl/style/sources/geojson_cluster_index.cpp
+    src/mbgl/style/sources/geojson_cluster_index.hpp
     src/mbgl/style/sources/geojson_source.cpp
     src/mbgl/style/sources/geojson_source_impl.cpp
     src/mbgl/style/sources/geojson_source_impl.hpp
+    src/mbgl/style/sources/geojson_source_worker.cpp
+    src/mbgl/style/sources/geojson_source_worker.hpp
     src/mbgl/style/sources/raster_source.cpp
     src/mbgl/style/sources/raster_source_impl.cpp
     src/mbgl/style/sources/raster_source_impl.hpp
@@ -383,6 +449,7 @@ set(MBGL_CORE_FILES
     src/mbgl/text/check_max_angle.hpp
     src/mbgl/text/collision_feature.cpp
     src/mbgl/text/collision_feature.hpp
+    src/mbgl/text/collision_grid.hpp
     src/mbgl/text/collision_tile.cpp
     src/mbgl/text/collision_tile.hpp
     src/mbgl/text/get_anchors.cpp
@@ -392,16 +459,24 @@ set(MBGL_CORE_FILES
     src/mbgl/text/glyph_atlas.cpp
     src/mbgl/text/glyph_atlas.hpp
     src/mbgl/text/glyph_atlas_observer.hpp
+    src/mbgl/text/glyph_cache.cpp
+    src/mbgl/text/glyph_cache.hpp
     src/mbgl/text/glyph_pbf.cpp
     src/mbgl/text/glyph_pbf.hpp
+    src/mbgl/text/glyph_pbf_worker.cpp
+    src/mbgl/text/glyph_pbf_worker.hpp
     src/mbgl/text/glyph_range.hpp
     src/mbgl/text/glyph_set.cpp
     src/mbgl/text/glyph_set.hpp
+    src/mbgl/text/line_measurements.cpp
+    src/mbgl/text/line_measurements.hpp
     src/mbgl/text/placement_config.hpp
     src/mbgl/text/quads.cpp
     src/mbgl/text/quads.hpp
     src/mbgl/text/shaping.cpp
     src/mbgl/text/shaping.hpp
+    src/mbgl/text/shaping_cache.cpp
+    src/mbgl/text/shaping_cache.hpp
 
     # tile
     src/mbgl/tile/geojson_tile.cpp
@@ -412,6 +487,9 @@ set(MBGL_CORE_FILES
     src/mbgl/tile/geometry_tile_data.hpp
     src/mbgl/tile/geometry_tile_worker.cpp
     src/mbgl/tile/geometry_tile_worker.hpp
+    src/mbgl/tile/layer_profiler.hpp
+    src/mbgl/tile/layout_cache.cpp
+    src/mbgl/tile/layout_cache.hpp
     src/mbgl/tile/raster_tile.cpp
     src/mbgl/tile/raster_tile.hpp
     src/mbgl/tile/raster_tile_worker.cpp
@@ -427,6 +505,8 @@ set(MBGL_CORE_FILES
     src/mbgl/tile/tile_observer.hpp
     src/mbgl/tile/vector_tile.cpp
     src/mbgl/tile/vector_tile.hpp
+    src/mbgl/tile/vector_tile_data.cpp
+    src/mbgl/tile/vector_tile_data.hpp
 
     # util
     include/mbgl/util/async_request.hpp
@@ -445,6 +525,7 @@ set(MBGL_CORE_FILES
     include/mbgl/util/geojson.hpp
     include/mbgl/util/geometry.hpp
     include/mbgl/util/image.hpp
+    include/mbgl/util/local_glyph_rasterizer.hpp
     include/mbgl/util/logging.hpp
     include/mbgl/util/noncopyable.hpp
     include/mbgl/util/optional.hpp
@@ -456,6 +537,7 @@ set(MBGL_CORE_FILES
     include/mbgl/util/string.hpp
     include/mbgl/util/tileset.hpp
     include/mbgl/util/timer.hpp
+    include/mbgl/util/trace.hpp
     include/mbgl/util/traits.hpp
     include/mbgl/util/unitbezier.hpp
     include/mbgl/util/util.hpp
@@ -463,6 +545,7 @@ set(MBGL_CORE_FILES
     include/mbgl/util/work_request.hpp
     include/mbgl/util/work_task.hpp
     include/mbgl/util/work_task_impl.hpp
+    src/mbgl/util/async.hpp
     src/mbgl/util/async_task.hpp
     src/mbgl/util/chrono.cpp
     src/mbgl/util/clip_id.cpp
@@ -488,12 +571,16 @@ set(MBGL_CORE_FILES
     src/mbgl/util/i18n.hpp
     src/mbgl/util/ignore.hpp
     src/mbgl/util/indexed_tuple.hpp
+    src/mbgl/util/interned_string.cpp
+    src/mbgl/util/interned_string.hpp
     src/mbgl/util/interpolate.cpp
     src/mbgl/util/interpolate.hpp
     src/mbgl/util/intersection_tests.cpp
     src/mbgl/util/intersection_tests.hpp
     src/mbgl/util/io.cpp
     src/mbgl/util/io.hpp
+    src/mbgl/util/ktx.cpp
+    src/mbgl/util/ktx.hpp
     src/mbgl/util/logging.cpp
     src/mbgl/util/mapbox.cpp
     src/mbgl/util/mapbox.hpp
@@ -520,11 +607,16 @@ set(MBGL_CORE_FILES
     src/mbgl/util/tile_coordinate.hpp
     src/mbgl/util/tile_cover.cpp
     src/mbgl/util/tile_cover.hpp
+    src/mbgl/util/tiny_sdf.cpp
+    src/mbgl/util/tiny_sdf.hpp
     src/mbgl/util/token.hpp
+    src/mbgl/util/trace.cpp
     src/mbgl/util/type_list.hpp
     src/mbgl/util/url.cpp
     src/mbgl/util/url.hpp
     src/mbgl/util/utf.hpp
+    src/mbgl/util/varint.cpp
+    src/mbgl/util/varint.hpp
     src/mbgl/util/version.cpp
     src/mbgl/util/version.hpp
     src/mbgl/util/work_queue.cpp
@@ -19,7 +19,6 @@ target_add_mason_package(mbgl-core PRIVATE rapidjson)
 target_add_mason_package(mbgl-core PRIVATE boost)
 target_add_mason_package(mbgl-core PRIVATE geojson)
 target_add_mason_package(mbgl-core PRIVATE geojsonvt)
-target_add_mason_package(mbgl-core PRIVATE supercluster)
 target_add_mason_package(mbgl-core PRIVATE kdbush)
 target_add_mason_package(mbgl-core PRIVATE earcut)
 target_add_mason_package(mbgl-core PRIVATE protozero)
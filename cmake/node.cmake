@@ -15,6 +15,8 @@ target_sources(mbgl-node
     PRIVATE platform/node/src/node_logging.cpp
     PRIVATE platform/node/src/node_map.hpp
     PRIVATE platform/node/src/node_map.cpp
+    PRIVATE platform/node/src/node_render_pool.hpp
+    PRIVATE platform/node/src/node_render_pool.cpp
     PRIVATE platform/node/src/node_request.hpp
     PRIVATE platform/node/src/node_request.cpp
     PRIVATE platform/node/src/node_feature.hpp
@@ -4,6 +4,8 @@ set(MBGL_TEST_FILES
     # actor
     test/actor/actor.test.cpp
     test/actor/actor_ref.test.cpp
+    test/actor/message.test.cpp
+    test/actor/task_group.test.cpp
 
     # algorithm
     test/algorithm/covered_by_children.test.cpp
@@ -21,16 +23,22 @@ set(MBGL_TEST_FILES
 
     # geometry
     test/geometry/binpack.test.cpp
+    test/geometry/line_atlas.test.cpp
 
     # gl
     test/gl/bucket.test.cpp
+    test/gl/half_float.test.cpp
     test/gl/object.test.cpp
 
     # include/mbgl
     test/include/mbgl/test.hpp
 
+    # layout
+    test/layout/symbol_layout.test.cpp
+
     # map
     test/map/map.test.cpp
+    test/map/tile_load_stats.test.cpp
     test/map/transform.test.cpp
 
     # math
@@ -38,6 +46,15 @@ set(MBGL_TEST_FILES
     test/math/minmax.test.cpp
     test/math/wrap.test.cpp
 
+    # programs
+    test/programs/binary_program.test.cpp
+    test/programs/shader_variant.test.cpp
+
+    # renderer
+    test/renderer/fill_batch.test.cpp
+    test/renderer/gpu_timer.test.cpp
+    test/renderer/upload_scheduler.test.cpp
+
     # sprite
     test/sprite/sprite_atlas.test.cpp
     test/sprite/sprite_image.test.cpp
@@ -62,20 +79,27 @@ set(MBGL_TEST_FILES
 
     # storage
     test/storage/asset_file_source.test.cpp
+    test/storage/concurrency_limit.test.cpp
     test/storage/default_file_source.test.cpp
     test/storage/headers.test.cpp
     test/storage/http_file_source.test.cpp
     test/storage/local_file_source.test.cpp
+    test/storage/mbtiles_file_source.test.cpp
     test/storage/offline.test.cpp
     test/storage/offline_database.test.cpp
     test/storage/offline_download.test.cpp
     test/storage/online_file_source.test.cpp
     test/storage/resource.test.cpp
+    test/storage/response_cache.test.cpp
     test/storage/sqlite.test.cpp
 
+    # style
+    test/style/binary_style.test.cpp
+
     # style/conversion
     test/style/conversion/function.test.cpp
     test/style/conversion/geojson_options.test.cpp
+    test/style/conversion/geojson_reader.test.cpp
     test/style/conversion/layer.test.cpp
     test/style/conversion/stringify.test.cpp
 
@@ -84,26 +108,35 @@ set(MBGL_TEST_FILES
 
     # style/function
     test/style/function/camera_function.test.cpp
+    test/style/function/composite_function.test.cpp
     test/style/function/source_function.test.cpp
 
     # style
+    test/style/geojson_cluster_index.test.cpp
     test/style/group_by_layout.test.cpp
     test/style/paint_property.test.cpp
     test/style/source.test.cpp
     test/style/style.test.cpp
     test/style/style_layer.test.cpp
+    test/style/style_optimizer.test.cpp
     test/style/style_parser.test.cpp
     test/style/tile_source.test.cpp
 
     # text
+    test/text/bidi.test.cpp
+    test/text/collision_grid.test.cpp
     test/text/glyph_atlas.test.cpp
+    test/text/glyph_cache.test.cpp
     test/text/glyph_pbf.test.cpp
     test/text/quads.test.cpp
+    test/text/shaping_cache.test.cpp
 
     # tile
     test/tile/geojson_tile.test.cpp
     test/tile/geometry_tile_data.test.cpp
+    test/tile/layout_cache.test.cpp
     test/tile/raster_tile.test.cpp
+    test/tile/tile_cache.test.cpp
     test/tile/tile_coordinate.test.cpp
     test/tile/tile_id.test.cpp
     test/tile/vector_tile.test.cpp
@@ -111,8 +144,10 @@ set(MBGL_TEST_FILES
     # util
     test/util/async_task.test.cpp
     test/util/geo.test.cpp
+    test/util/grid_index.test.cpp
     test/util/http_timeout.test.cpp
     test/util/image.test.cpp
+    test/util/ktx.test.cpp
     test/util/mapbox.test.cpp
     test/util/memory.test.cpp
     test/util/merge_lines.test.cpp
@@ -127,5 +162,6 @@ set(MBGL_TEST_FILES
     test/util/timer.test.cpp
     test/util/token.test.cpp
     test/util/url.test.cpp
+    test/util/varint.test.cpp
     test/util/work_queue.test.cpp
 )
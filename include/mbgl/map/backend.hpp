@@ -20,6 +20,12 @@ public:
     // Returns the backend's context which manages OpenGL state.
     gl::Context& getContext();
 
+    // Lets the maps of this backend use the compiled shader programs of those of `other`, so
+    // that each program is compiled once for all of them. The GL contexts of both backends
+    // must be in one share group, and be used on one thread. Call it before the map of this
+    // backend is first rendered.
+    void shareResourcesWith(Backend& other);
+
     // Called when the map needs to be rendered; the backend should call Map::render() at some point
     // in the near future. (Not called for Map::renderStill() mode.)
     virtual void invalidate() = 0;
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+/**
+ * GPU time spent on the sections of a rendered frame, in the order they were rendered.
+ * Sections are named "upload" and "clip", and "opaque/<layer id>" and
+ * "translucent/<layer id>" for each layer that was drawn in that render pass.
+ */
+class FrameStats {
+public:
+    class Section {
+    public:
+        std::string name;
+        Duration gpuTime;
+    };
+
+    std::vector<Section> sections;
+};
+
+} // namespace mbgl
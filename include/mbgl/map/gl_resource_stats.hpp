@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace mbgl {
+
+/**
+ * The GL objects held by a map, and the bytes of their storage, by what they are used for.
+ * Bytes are estimated from the sizes and formats asked of the driver, which may pad them.
+ * Programs, shaders and queries aren't counted.
+ */
+class GLResourceStats {
+public:
+    enum class Owner : uint8_t {
+        // The buckets of tiles, by layer type.
+        Fill,
+        FillExtrusion,
+        Line,
+        Circle,
+        Symbol,
+        Raster,
+        // Glyph, sprite and line atlases.
+        Atlas,
+        // Views and textures rendered into offscreen.
+        Offscreen,
+        Other,
+    };
+
+    enum class Type : uint8_t {
+        Buffer,
+        Texture,
+        Renderbuffer,
+        VertexArray,
+        Framebuffer,
+    };
+
+    static constexpr std::size_t OwnerCount = 9;
+    static constexpr std::size_t TypeCount = 5;
+
+    static const char* name(Owner);
+    static const char* name(Type);
+
+    class Usage {
+    public:
+        std::size_t objects = 0;
+        std::size_t bytes = 0;
+    };
+
+    Usage& get(Owner owner, Type type) {
+        return usage[std::size_t(owner)][std::size_t(type)];
+    }
+
+    const Usage& get(Owner owner, Type type) const {
+        return usage[std::size_t(owner)][std::size_t(type)];
+    }
+
+    Usage total(Owner) const;
+    Usage total() const;
+
+    // The most bytes that were held at once.
+    std::size_t highWaterBytes = 0;
+
+private:
+    std::array<std::array<Usage, TypeCount>, OwnerCount> usage {};
+};
+
+} // namespace mbgl
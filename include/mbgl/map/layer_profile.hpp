@@ -0,0 +1,44 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+/**
+ * What laying out the tiles of each style layer cost on the worker threads, summed over the
+ * tiles, while `Map::setLayerProfiling` is on. Layers laid out together, as those sharing
+ * their source layer, filter and layout properties are, are counted under the first of them.
+ * The time of symbol layers includes shaping and placing their symbols, whenever they are
+ * placed again.
+ */
+class LayerProfile {
+public:
+    class Layer {
+    public:
+        // Layouts of the layer, one per tile unless a tile is laid out again.
+        std::size_t layouts = 0;
+        Duration cpuTime = Duration::zero();
+
+        // The features that passed the filter, and the vertices and bytes of the buckets
+        // built from them, as counted before they are uploaded. Instances, as of circles and
+        // symbols drawn with instancing, count as one vertex.
+        std::size_t features = 0;
+        std::size_t vertices = 0;
+        std::size_t bytes = 0;
+
+        Layer& operator+=(const Layer&);
+    };
+
+    // By layer ID.
+    std::map<std::string, Layer> layers;
+
+    // The IDs of the layers, the most CPU time first.
+    std::vector<std::string> byCPUTime() const;
+};
+
+} // namespace mbgl
@@ -10,7 +10,14 @@
 #include <mbgl/annotation/annotation.hpp>
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/map/camera.hpp>
+#include <mbgl/map/frame_stats.hpp>
+#include <mbgl/map/gl_resource_stats.hpp>
+#include <mbgl/map/layer_profile.hpp>
+#include <mbgl/map/memory_stats.hpp>
 #include <mbgl/map/query.hpp>
+#include <mbgl/map/render_stats.hpp>
+#include <mbgl/map/rendering_policy.hpp>
+#include <mbgl/map/still_image_stats.hpp>
 
 #include <cstdint>
 #include <string>
@@ -23,6 +30,7 @@ namespace mbgl {
 class Backend;
 class View;
 class FileSource;
+class LocalGlyphRasterizer;
 class Scheduler;
 class SpriteImage;
 
@@ -41,7 +49,10 @@ public:
                  MapMode mapMode = MapMode::Continuous,
                  GLContextMode contextMode = GLContextMode::Unique,
                  ConstrainMode constrainMode = ConstrainMode::HeightOnly,
-                 ViewportMode viewportMode = ViewportMode::Default);
+                 ViewportMode viewportMode = ViewportMode::Default,
+                 // Directory in which linked shader programs are cached where the driver
+                 // supports it, so that later maps start faster.
+                 optional<std::string> programCacheDir = {});
     ~Map();
 
     // Register a callback that will get called (on the render thread) when all resources have
@@ -49,6 +60,20 @@ public:
     using StillImageCallback = std::function<void (std::exception_ptr)>;
     void renderStill(View&, StillImageCallback callback);
 
+    // Like the above, but gives up waiting for resources once `timeout` has passed. If the
+    // style has loaded by then, the image is rendered from the tiles that have, and the
+    // callback gets a `util::StillImageTimeoutException` either way. Tiles still loading for
+    // the image stop loading. Zero waits as long as it takes.
+    void renderStill(View&, StillImageCallback callback, Duration timeout);
+
+    // Stops the current still image, if there is one: its callback gets a
+    // `util::StillImageCancelledException`, and tiles and glyphs still loading for it stop
+    // loading.
+    void cancelStill();
+
+    // Of the last still image whose callback was called.
+    StillImageStats getStillImageStats() const;
+
     // Triggers a repaint.
     void triggerRepaint();
 
@@ -147,6 +172,8 @@ public:
     LatLng latLngForProjectedMeters(const ProjectedMeters&) const;
     ScreenCoordinate pixelForLatLng(const LatLng&) const;
     LatLng latLngForPixel(const ScreenCoordinate&) const;
+    std::vector<ScreenCoordinate> pixelsForLatLngs(const std::vector<LatLng>&) const;
+    std::vector<LatLng> latLngsForPixels(const std::vector<ScreenCoordinate>&) const;
 
     // Annotations
     void addAnnotationIcon(const std::string&, std::shared_ptr<const SpriteImage>);
@@ -157,6 +184,10 @@ public:
     void updateAnnotation(AnnotationID, const Annotation&);
     void removeAnnotation(AnnotationID);
 
+    // Faster than adding or removing large numbers of annotations one by one.
+    AnnotationIDs addAnnotations(const std::vector<Annotation>&);
+    void removeAnnotations(const AnnotationIDs&);
+
     // Sources
     std::vector<style::Source*> getSources();
     style::Source* getSource(const std::string& sourceID);
@@ -169,6 +200,11 @@ public:
     void addLayer(std::unique_ptr<style::Layer>, const optional<std::string>& beforeLayerID = {});
     std::unique_ptr<style::Layer> removeLayer(const std::string& layerID);
 
+    // Changes to layers between these calls are applied together, with a single layout of the
+    // tiles they affect. Batches nest; one that is open when the style is replaced ends with it.
+    void beginStyleBatch();
+    void endStyleBatch();
+
     // Add image, bound to the style
     void addImage(const std::string&, std::unique_ptr<const SpriteImage>);
     void removeImage(const std::string&);
@@ -184,13 +220,134 @@ public:
     // Feature queries
     std::vector<Feature> queryRenderedFeatures(const ScreenCoordinate&, const QueryOptions& options = {});
     std::vector<Feature> queryRenderedFeatures(const ScreenBox&,        const QueryOptions& options = {});
+
+    // Like queryRenderedFeatures, but skips converting the geometry and properties of features.
+    std::vector<RenderedFeatureID> queryRenderedFeatureIDs(const ScreenCoordinate&, const QueryOptions& options = {});
+    std::vector<RenderedFeatureID> queryRenderedFeatureIDs(const ScreenBox&,        const QueryOptions& options = {});
+
+    // Finds the features of the loaded tiles of a source, whether or not they are rendered.
+    // Features that cross tile boundaries may be returned once for each tile. The chunked
+    // variant passes the features of each tile to `chunk` as soon as they are found, instead
+    // of collecting them all first.
+    std::vector<Feature> querySourceFeatures(const std::string& sourceID, const SourceQueryOptions& options = {});
+    void querySourceFeatures(const std::string& sourceID, const SourceQueryOptions&, const std::function<void (std::vector<Feature>)>& chunk);
     
     AnnotationIDs queryPointAnnotations(const ScreenBox&);
 
+    // The point annotations positioned within the bounds, whether or not they are rendered.
+    AnnotationIDs queryPointAnnotations(const LatLngBounds&);
+
     // Memory
-    void setSourceTileCacheSize(size_t);
+    // Bounds the memory each source spends on tiles kept for reuse once they go out of view,
+    // as counted by their buckets and indices. Unlimited by default, though no more tiles
+    // are kept than a few screenfuls.
+    void setSourceTileCacheBudget(size_t bytes);
+
+    // Frees memory as urgently as `level` asks, e.g. following the trim levels of the platform,
+    // and returns what each response freed. The budget of tiles kept for reuse stays lowered
+    // until it is set again.
+    MemoryPressureResult onMemoryPressure(MemoryPressure level);
+
+    // The same as `onMemoryPressure(MemoryPressure::Critical)`.
     void onLowMemory();
 
+    // What the map holds on the CPU and the GPU, by source and by what it is held for. The
+    // file source's cache is shared with any other map using it.
+    MemoryStats getMemoryStats() const;
+
+    // In pitched views, loads the tiles far from the camera at lower zoom levels, as long as
+    // they are drawn at most `maxError` times as large as those at the center of the screen;
+    // e.g. 1 keeps their detail on screen about the same. Zero, the default, loads every tile
+    // at the zoom level of the center.
+    void setPitchedTileCoverError(double maxError);
+
+    // While the camera is idle and the tiles in view are loaded, loads the tiles around them,
+    // and those of the zoom levels above and below, at the lowest priority, until the tiles
+    // loaded this way add up to `bytes`. Their requests are cancelled as soon as the camera
+    // moves. Setting the budget starts counting again; zero, the default, prefetches nothing.
+    void setTilePrefetchBudget(size_t bytes);
+
+    // Whether tiles index their features for `queryRenderedFeatures`, which finds nothing
+    // while this is off. Maps that are never queried save the time and memory the indices
+    // take. Turning it back on lays out the tiles again. On by default.
+    void setFeatureIndexing(bool);
+    bool getFeatureIndexing() const;
+
+    // Whether styles are simplified as they are loaded, without changing how they render:
+    // camera functions whose stops all have the same value become constants, and layers
+    // that can't draw anything, with an empty zoom range, one below the zoom levels of the
+    // source, or a filter that matches nothing, are neither laid out nor rendered until
+    // they are changed. Applies to the styles loaded after it is set. Off by default.
+    void setStyleOptimization(bool);
+    bool getStyleOptimization() const;
+
+    // Draws the glyphs of CJK ideographs and Hangul syllables with the rasterizer instead of
+    // downloading their glyph ranges, which are the largest; see `LocalGlyphRasterizer`.
+    // Applies to the ranges requested after it is set. None by default.
+    void setLocalGlyphRasterizer(std::shared_ptr<LocalGlyphRasterizer>);
+
+    // Keeps laid out buckets of vector tiles in files in this directory, which must exist, so
+    // that the tiles are drawn from them when they are loaded again, even by another process,
+    // instead of being laid out again. Tiles of layers with data-driven paint properties, and
+    // of symbol layers, are always laid out. Applies to the tiles created after it is set. An
+    // empty path, the default, turns it off.
+    void setLayoutCacheDirectory(const std::string&);
+
+    // Records what laying out the tiles of each style layer costs on the worker threads,
+    // summed over the tiles, to find the layers that make a style slow. Applies to the tiles
+    // created after it is turned on; turning it off discards what was recorded. Off by
+    // default, since it reads the clock around each layer of each tile.
+    void setLayerProfiling(bool);
+    bool getLayerProfiling() const;
+    LayerProfile getLayerProfile() const;
+
+    // Rendering
+    // Limits the time spent uploading newly loaded tiles in a frame; tiles that don't fit are
+    // uploaded in later frames, and parent or child tiles are shown until then. Zero uploads
+    // every tile as soon as it is loaded.
+    void setTileUploadBudget(Duration);
+    Duration getTileUploadBudget() const;
+
+    // Draws the fills of a layer's tiles with one draw call for up to 16 tiles, where the
+    // layer has no pattern, translation or data-driven color and opacity. This saves draw
+    // calls when many tiles with little geometry are shown, at the cost of keeping a copy
+    // of the fill geometry of such tiles. Off by default.
+    void setDrawBatching(bool);
+    bool getDrawBatching() const;
+
+    // Renders each tile of the fill, line and raster layers at the bottom of the style, up to
+    // the first layer of another type or source, into a texture, and while the camera only
+    // pans, draws those textures instead of the layers. Tiles are rendered again when their
+    // buckets or the paint properties of their layers change; zooming, rotating or pitching
+    // the map drops the textures. This trades GPU memory, roughly four bytes per pixel of
+    // each visible tile, for fewer draw calls while panning. Off by default.
+    void setTileRenderCache(bool);
+    bool getTileRenderCache() const;
+
+    // Redraws only the parts of the view that changed since the frames it still holds, as told
+    // by `View::getBufferAge`, where the camera and style stay the same: the tiles whose
+    // buckets changed, such as those of moved annotations, and those that were added or
+    // removed. Around the tiles of symbol and circle layers, a quarter of a tile is redrawn
+    // too; labels and icons that reach further than that may leave stale pixels. Frames
+    // where nothing changed aren't drawn at all. Off by default.
+    void setPartialRedraw(bool);
+    bool getPartialRedraw() const;
+
+    // Limits how often the map repaints to fade labels and show newly loaded tiles, see
+    // `RenderingPolicy`. While a gesture is in progress, the map is rendered at the display's
+    // rate regardless. By default, nothing is limited.
+    void setRenderingPolicy(const RenderingPolicy&);
+    RenderingPolicy getRenderingPolicy() const;
+
+    // Measures the GPU time of every continuously rendered frame where the driver supports
+    // timer queries, and calls back (on the render thread) with the results of each frame
+    // once they're known, usually a few frames later. Pass an empty callback to stop.
+    using FrameStatsCallback = std::function<void (const FrameStats&)>;
+    void setFrameStatsCallback(FrameStatsCallback);
+
+    // Of the last frame rendered, continuously or for a still image.
+    RenderStats getRenderStats() const;
+
     // Debug
     void setDebug(MapDebugOptions);
     void cycleDebugOptions();
@@ -199,6 +356,11 @@ public:
     bool isFullyLoaded() const;
     void dumpDebugLogs() const;
 
+    // The GL objects and memory held by the map's context, by what they're used for, along
+    // with the most memory held at once. New high-water marks are also logged as they pass
+    // further steps of 16 MB.
+    GLResourceStats getGLResourceStats() const;
+
 private:
     class Impl;
     const std::unique_ptr<Impl> impl;
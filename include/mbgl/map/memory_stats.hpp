@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace mbgl {
+
+/**
+ * The memory a map holds on to, by what it is held for. CPU bytes are those of the geometry,
+ * images, indices and data kept in memory; GPU bytes those uploaded from them, as measured
+ * before the upload. The objects holding them, and the allocator's overhead, aren't counted.
+ */
+class MemoryStats {
+public:
+    class Usage {
+    public:
+        std::size_t cpuBytes = 0;
+        std::size_t gpuBytes = 0;
+
+        std::size_t total() const {
+            return cpuBytes + gpuBytes;
+        }
+
+        Usage& operator+=(const Usage& other) {
+            cpuBytes += other.cpuBytes;
+            gpuBytes += other.gpuBytes;
+            return *this;
+        }
+    };
+
+    enum class BucketType : uint8_t {
+        Fill,
+        FillExtrusion,
+        Line,
+        Circle,
+        Symbol,
+        Raster,
+    };
+
+    static constexpr std::size_t BucketTypeCount = 6;
+
+    static const char* name(BucketType);
+
+    class Source {
+    public:
+        // The tiles in use, and those kept in the `TileCache` to be used again.
+        std::size_t tiles = 0;
+        std::size_t cachedTiles = 0;
+
+        // What the buckets of the tiles in use hold, by layer type. Layers sharing a bucket
+        // count it once.
+        std::array<Usage, BucketTypeCount> buckets {};
+
+        // The indices of the tiles in use for `queryRenderedFeatures`.
+        std::size_t featureIndexBytes = 0;
+
+        // The data the tiles in use were parsed from, when they keep it.
+        std::size_t tileDataBytes = 0;
+
+        // All of the above, of the tiles in the cache.
+        Usage cache;
+
+        Usage& bucket(BucketType type) {
+            return buckets[std::size_t(type)];
+        }
+
+        const Usage& bucket(BucketType type) const {
+            return buckets[std::size_t(type)];
+        }
+
+        // Of the tiles in use, without the cache.
+        Usage tileTotal() const;
+        Usage total() const;
+    };
+
+    // By source ID.
+    std::map<std::string, Source> sources;
+
+    Usage glyphAtlas;
+    Usage spriteAtlas;
+    Usage lineAtlas;
+
+    // The labels shaped by the glyph atlas, kept to be placed again.
+    std::size_t shapingCacheBytes = 0;
+
+    // The responses the file source keeps in memory, shared with other maps using it.
+    std::size_t fileSourceCacheBytes = 0;
+
+    Usage total() const;
+};
+
+} // namespace mbgl
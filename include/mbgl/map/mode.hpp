@@ -2,6 +2,7 @@
 
 #include <mbgl/util/traits.hpp>
 
+#include <cstddef>
 #include <cstdint>
 
 namespace mbgl {
@@ -37,6 +38,34 @@ enum class ViewportMode : EnumType {
     FlippedY,
 };
 
+// How urgently the map is asked to free memory, e.g. following the trim levels of the
+// platform. Each level also does what the ones below it do.
+enum class MemoryPressure : EnumType {
+    // Halves the budget of tiles kept for reuse, and drops the copies of uploaded geometry
+    // kept on the CPU.
+    Moderate,
+    // Drops the shaped labels cached by the glyph atlas, the responses cached in memory, and
+    // the textures of the tile render cache.
+    High,
+    // Drops every tile that isn't rendered, along with its GL resources.
+    Critical,
+};
+
+// The bytes each of the responses to memory pressure freed, as the caches measure them.
+struct MemoryPressureResult {
+    std::size_t tileCache = 0;
+    std::size_t retainedGeometry = 0;
+    std::size_t shapingCache = 0;
+    std::size_t responseCache = 0;
+    std::size_t offscreenTiles = 0;
+    std::size_t tileRenderCache = 0;
+
+    std::size_t total() const {
+        return tileCache + retainedGeometry + shapingCache + responseCache + offscreenTiles +
+               tileRenderCache;
+    }
+};
+
 enum class MapDebugOptions : EnumType {
     NoDebug     = 0,
     TileBorders = 1 << 1,
@@ -1,8 +1,13 @@
 #pragma once
 
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/geo.hpp>
 #include <mbgl/style/filter.hpp>
 
+#include <string>
+#include <vector>
+
 namespace mbgl {
 
 /**
@@ -16,4 +21,30 @@ public:
     optional<style::Filter> filter;
 };
 
+/**
+ * Options for Map::querySourceFeatures.
+ */
+class SourceQueryOptions {
+public:
+    /** The source layers to query; by default, those of the style layers using the source */
+    optional<std::vector<std::string>> sourceLayers;
+
+    optional<style::Filter> filter;
+
+    /** Only features whose bounding box intersects these bounds are returned */
+    optional<LatLngBounds> bounds;
+};
+
+/**
+ * A feature found by `Map::queryRenderedFeatureIDs`, without its geometry and properties.
+ */
+class RenderedFeatureID {
+public:
+    /** The style layer the feature is rendered in */
+    std::string layerID;
+
+    /** The feature's ID, if it has one */
+    optional<FeatureIdentifier> featureID;
+};
+
 }
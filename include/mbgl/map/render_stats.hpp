@@ -0,0 +1,52 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+namespace mbgl {
+
+/**
+ * What the last frame rendered by `Map::render` took on the CPU, and what it did with the
+ * GL context. Unlike `FrameStats`, they are known as soon as the frame is rendered.
+ */
+class RenderStats {
+public:
+    // CPU time of the phases of the frame. Updating covers transitions, annotations, relayout,
+    // the first upload of newly loaded tiles and the update of the tiles to render; the
+    // painter covers uploading what's left, and drawing.
+    Duration update = Duration::zero();
+    Duration cascade = Duration::zero();
+    Duration recalculate = Duration::zero();
+    Duration painter = Duration::zero();
+
+    std::size_t drawCalls = 0;
+
+    // Calls that changed the GL state, other than those that switched the program.
+    std::size_t stateChanges = 0;
+    std::size_t programSwitches = 0;
+
+    // The tiles each source rendered, by source ID.
+    std::map<std::string, std::size_t> tiles;
+
+    std::size_t bucketUploads = 0;
+
+    // Into buffers and textures, including the atlases.
+    std::size_t uploadedBytes = 0;
+
+    // Atlases that uploaded new images, of the sprite, glyph, line and annotation atlases.
+    std::size_t atlasUploads = 0;
+
+    // Tiles drawn from the tile render cache, and those of them that had to be rendered
+    // into it first; see `Map::setTileRenderCache`.
+    std::size_t cachedTiles = 0;
+    std::size_t cachedTileRenders = 0;
+
+    // The pixels of the view that were drawn; fewer than all of them in frames that only
+    // redraw what changed, and none in those where nothing did. See `Map::setPartialRedraw`.
+    std::size_t drawnPixels = 0;
+};
+
+} // namespace mbgl
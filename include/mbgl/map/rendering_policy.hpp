@@ -0,0 +1,25 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+namespace mbgl {
+
+/**
+ * How often a continuously rendered map repaints for updates that nobody is waiting on: the
+ * frames that only fade labels and icons in or out, or upload tiles that didn't fit in an
+ * earlier frame, and the frames for newly loaded tiles. Camera and style changes, gestures
+ * and transitions of the camera are always rendered at the display's rate.
+ */
+class RenderingPolicy {
+public:
+    // The least time from the start of one frame to the start of a frame that is only
+    // rendered for such updates, e.g. 1/30 s for at most 30 frames per second. Zero renders
+    // them as soon as the display allows.
+    Duration lowPriorityFrameInterval = Duration::zero();
+
+    // How long a newly loaded tile waits for others before they are shown together in one
+    // frame. Zero shows each tile in the next frame.
+    Duration tileArrivalDelay = Duration::zero();
+};
+
+} // namespace mbgl
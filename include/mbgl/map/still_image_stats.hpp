@@ -0,0 +1,26 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+namespace mbgl {
+
+/**
+ * Where the time of the last still image went, from the call to `Map::renderStill` until its
+ * callback was called.
+ */
+class StillImageStats {
+public:
+    // Until the image could be rendered: until everything it needs had loaded, or its timeout
+    // passed. For images that failed or were cancelled, until then.
+    Duration loading = Duration::zero();
+
+    // Rendering the image, on the render thread. Zero if it wasn't rendered.
+    Duration rendering = Duration::zero();
+
+    Duration total = Duration::zero();
+
+    // Whether the image was rendered from what had loaded when its timeout passed.
+    bool partial = false;
+};
+
+} // namespace mbgl
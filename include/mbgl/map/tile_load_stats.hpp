@@ -0,0 +1,87 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mbgl {
+
+/**
+ * When a tile first went through each phase of loading. Phases the tile hasn't reached yet,
+ * or doesn't have, such as layout for raster tiles or the request for tiles that aren't
+ * loaded from a file source, are unset.
+ */
+class TileTimeline {
+public:
+    // The tile's ID, as "z/x/y=>overscaled z".
+    std::string tile;
+
+    // The first request, and the first response to it, which `fromCache` tells whether it
+    // came from an optional request, i.e. a cache.
+    optional<TimePoint> requested;
+    optional<TimePoint> responded;
+    bool fromCache = false;
+
+    // When the worker had parsed the data's layers, and when the tile got its layout and the
+    // placement of its symbols. For raster tiles, when the tile got the decoded image.
+    optional<TimePoint> parsed;
+    optional<TimePoint> laidOut;
+    optional<TimePoint> placed;
+
+    // The first upload of the tile's buckets, and the first frame the tile was drawn in.
+    optional<TimePoint> uploaded;
+    optional<TimePoint> rendered;
+};
+
+/**
+ * The durations of the loading phases of the tiles a source has rendered, as histograms.
+ * Each tile is counted once, when it's first rendered, in the phases whose ends it has.
+ */
+class TileLoadStats {
+public:
+    enum class Phase : uint8_t {
+        // From the request to the response: the network, or the cache.
+        Request,
+        // From the response until the worker had parsed the data.
+        Parse,
+        // From parsing until the layout reached the tile.
+        Layout,
+        // From the layout until the placement reached the tile.
+        Placement,
+        // From the layout, or for raster tiles parsing, until the first upload.
+        Upload,
+        // From the upload until the tile was drawn.
+        Render,
+        // From the request, or the first phase the tile has, until it was drawn.
+        Total,
+    };
+
+    static constexpr std::size_t PhaseCount = 7;
+
+    static const char* name(Phase);
+
+    // Upper bounds of the histogram buckets; the last bucket is unbounded.
+    static const std::array<Duration, 7> bounds;
+    using Histogram = std::array<uint64_t, 8>;
+
+    const Histogram& get(Phase phase) const {
+        return histograms[std::size_t(phase)];
+    }
+
+    void record(const TileTimeline&);
+
+    // Tiles recorded, and of them, those whose first response came from a cache.
+    uint64_t tiles = 0;
+    uint64_t fromCache = 0;
+
+private:
+    void record(Phase, const optional<TimePoint>& start, const optional<TimePoint>& end);
+
+    std::array<Histogram, PhaseCount> histograms {};
+};
+
+} // namespace mbgl
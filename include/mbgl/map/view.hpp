@@ -2,6 +2,8 @@
 
 #include <mbgl/util/noncopyable.hpp>
 
+#include <cstdint>
+
 namespace mbgl {
 
 class Map;
@@ -15,6 +17,14 @@ public:
     // calling .bind() repeatedly is a no-op and that the appropriate gl::Context values are
     // set to the current state.
     virtual void bind() = 0;
+
+    // How many frames ago the contents of the framebuffer bound by `bind()` were drawn, as with
+    // EGL_EXT_buffer_age: 1 if it still holds the last frame, or 0 if its contents are
+    // undefined, as they are by default. Views that keep their contents between frames let
+    // the map redraw only what changed; see `Map::setPartialRedraw`.
+    virtual uint32_t getBufferAge() const {
+        return 0;
+    }
 };
 
 } // namespace mbgl
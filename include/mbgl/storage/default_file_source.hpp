@@ -1,9 +1,11 @@
 #pragma once
 
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/file_source_stats.hpp>
 #include <mbgl/storage/offline.hpp>
 #include <mbgl/util/constants.hpp>
 
+#include <memory>
 #include <vector>
 
 namespace mbgl {
@@ -12,6 +14,9 @@ namespace util {
 template <typename T> class Thread;
 } // namespace util
 
+class ResponseCache;
+class FileSourceStatsRecorder;
+
 class DefaultFileSource : public FileSource {
 public:
     /*
@@ -38,7 +43,47 @@ public:
 
     void setResourceTransform(std::function<std::string(Resource::Kind, std::string&&)>);
 
+    /*
+     * Responses are also kept in memory, up to the given size, so that resources that
+     * are requested again, by any map using this file source, are served without reading
+     * the database. This limit is independent of maximumCacheSize; zero disables the
+     * memory cache.
+     */
+    void setMaximumMemoryCacheSize(uint64_t);
+
+    struct MemoryCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t size = 0;
+
+        double hitRate() const {
+            return hits + misses ? double(hits) / (hits + misses) : 0;
+        }
+    };
+
+    MemoryCacheStats getMemoryCacheStats() const;
+
+    /*
+     * Counters of the requests, cache lookups and network requests, by kind of resource,
+     * including those of offline downloads. Thread-safe, and answered without waiting for
+     * the file source thread.
+     */
+    FileSourceStats getStats() const;
+
+    /*
+     * By default, every write to the database is synced to disk before the next one, and
+     * reads wait for writes. With write-ahead logging, ambient cache writes are appended to
+     * a log and synced in batches, and reads don't wait for them; a power failure may lose
+     * the most recently cached resources, but not resources of offline regions, which are
+     * still synced as they are downloaded. Requests are then also read from the database on
+     * threads of their own, so that they don't wait for downloads and eviction either.
+     */
+    void setWriteAheadLogging(bool);
+
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+    void setPriority(AsyncRequest&, Resource::Priority) override;
+    std::size_t purgeMemoryCache() override;
+    std::size_t getMemoryCacheSize() const override;
 
     /*
      * Retrieve all regions in the offline database.
@@ -83,6 +128,21 @@ public:
      */
     void setOfflineRegionDownloadState(OfflineRegion&, OfflineRegionDownloadState);
 
+    /*
+     * Resume downloading of regional resources, and revalidate those that expired with
+     * conditional requests. Resources that were not modified are kept as they are, with
+     * new expiration times.
+     */
+    void refreshOfflineRegion(OfflineRegion&);
+
+    /*
+     * Download the glyph ranges of the given codepoints, for every font stack of the style,
+     * into the region, activating its download if it isn't active. For regions that only
+     * include the glyph ranges their tiles use, this adds text that the app shows itself,
+     * or that is expected in later versions of the tiles.
+     */
+    void addOfflineRegionGlyphRange(OfflineRegion&, Range<char16_t> codepoints);
+
     /*
      * Retrieve the current status of the region. The query will be executed
      * asynchronously and the results passed to the given callback, which will be
@@ -109,6 +169,30 @@ public:
      */
     void deleteOfflineRegion(OfflineRegion&&, std::function<void (std::exception_ptr)>);
 
+    /*
+     * Write an offline region, with the resources it uses, to a self-contained database at
+     * the given path, replacing any file there. Provisioning devices by importing it is much
+     * faster than downloading the region on each of them.
+     *
+     * When the operation is complete or encounters an error, the given callback will be
+     * executed on the database thread.
+     */
+    void exportOfflineRegion(OfflineRegion&, const std::string& path,
+                             std::function<void (std::exception_ptr)>) const;
+
+    /*
+     * Add the regions of a database that `exportOfflineRegion` wrote, in batches of a
+     * transaction each. Resources already in this database are shared rather than copied,
+     * and the imported regions are complete, without downloading or revalidating anything
+     * until their resources expire. Imported regions are in an inactive download state.
+     *
+     * The given callback will be executed on the database thread with the imported regions,
+     * or an error, in which case no region was imported.
+     */
+    void importOfflineRegions(const std::string& path,
+                              std::function<void (std::exception_ptr,
+                                                  optional<std::vector<OfflineRegion>>)>);
+
     /*
      * Changing or bypassing this limit without permission from Mapbox is prohibited
      * by the Mapbox Terms of Service.
@@ -140,9 +224,23 @@ public:
     class Impl;
 
 private:
+    class Reader;
+
+    const std::string cachePath;
+
+    // Shared with the implementation, but read from here without waiting for its thread.
+    const std::shared_ptr<ResponseCache> memoryCache;
+    const std::shared_ptr<FileSourceStatsRecorder> stats;
     const std::unique_ptr<util::Thread<Impl>> thread;
+
+    // With write-ahead logging, the threads that read the database for requests, in turn.
+    std::vector<std::unique_ptr<util::Thread<Reader>>> readers;
+    std::size_t nextReader = 0;
+    bool paused = false;
+
     const std::unique_ptr<FileSource> assetFileSource;
     const std::unique_ptr<FileSource> localFileSource;
+    const std::unique_ptr<FileSource> mbtilesFileSource;
     std::string cachedBaseURL = mbgl::util::API_BASE_URL;
     std::string cachedAccessToken;
 };
@@ -6,6 +6,7 @@
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/async_request.hpp>
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 
@@ -24,6 +25,21 @@ public:
     // not be executed.
     virtual std::unique_ptr<AsyncRequest> request(const Resource&, Callback) = 0;
 
+    // Changes the priority of a request returned by this file source, e.g. when the resource
+    // becomes more or less urgent as the viewport moves. This only affects the order in which
+    // waiting requests are started; file sources without such a queue ignore it.
+    virtual void setPriority(AsyncRequest&, Resource::Priority) {}
+
+    // Drops the responses this file source keeps in memory, if any, returning their bytes.
+    virtual std::size_t purgeMemoryCache() {
+        return 0;
+    }
+
+    // The bytes of the responses this file source keeps in memory, if any.
+    virtual std::size_t getMemoryCacheSize() const {
+        return 0;
+    }
+
     // When a file source supports optional requests, it must return true.
     // Optional requests are requests that aren't as urgent, but could be useful, e.g.
     // to cover part of the map while loading. The FileSource should only do cheap actions to
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/util/chrono.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace mbgl {
+
+/*
+    Counters of the requests handled by a file source, by kind of resource, since it was
+    created. They tell how well the cache is sized, and whether requests wait for a network
+    connection, e.g. to tune `maximumCacheSize` for a deployment.
+*/
+class FileSourceStats {
+public:
+    class Counters {
+    public:
+        // Requests made to the file source.
+        uint64_t requests = 0;
+
+        // Lookups in the memory cache and the database that found the resource, and those
+        // that didn't.
+        uint64_t cacheHits = 0;
+        uint64_t cacheMisses = 0;
+
+        // Requests that went to the network, and of them, those that joined an identical
+        // request already in flight instead of taking up another connection.
+        uint64_t networkRequests = 0;
+        uint64_t sharedRequests = 0;
+
+        // Responses from the network: how many were 304 Not Modified, and the bytes of the
+        // bodies of all of them.
+        uint64_t notModified = 0;
+        uint64_t bytes = 0;
+
+        // Summed over the network requests: the time they waited for a connection to be free,
+        // and the time from sending them until their responses arrived.
+        Duration pendingTime = Duration::zero();
+        Duration activeTime = Duration::zero();
+
+        void add(const Counters&);
+    };
+
+    Counters& get(Resource::Kind kind) {
+        return kinds[kind];
+    }
+
+    const Counters& get(Resource::Kind kind) const {
+        return kinds[kind];
+    }
+
+    // Of all kinds together.
+    Counters total() const;
+
+private:
+    std::array<Counters, Resource::Kind::SpriteJSON + 1> kinds;
+};
+
+} // namespace mbgl
@@ -14,6 +14,18 @@ namespace mbgl {
 
 class TileID;
 
+/*
+ * Which glyph ranges of the style's font stacks a region includes: all of them, or only
+ * those needed for the text that its symbol layers take from its vector tiles once they are
+ * downloaded, which for most regions is a few ranges rather than hundreds of megabytes.
+ * More ranges can be added to a region later with
+ * `DefaultFileSource::addOfflineRegionGlyphRange`.
+ */
+enum class OfflineRegionGlyphs : uint8_t {
+    All,
+    Used,
+};
+
 /*
  * An offline region defined by a style URL, geographic bounding box, zoom range, and
  * device pixel ratio.
@@ -27,16 +39,20 @@ class TileID;
  */
 class OfflineTilePyramidRegionDefinition {
 public:
-    OfflineTilePyramidRegionDefinition(std::string, LatLngBounds, double, double, float);
+    OfflineTilePyramidRegionDefinition(std::string, LatLngBounds, double, double, float,
+                                       OfflineRegionGlyphs = OfflineRegionGlyphs::All);
 
     /* Private */
+    Range<uint8_t> coveringZoomRange(SourceType, uint16_t tileSize, const Range<uint8_t>& zoomRange) const;
     std::vector<CanonicalTileID> tileCover(SourceType, uint16_t tileSize, const Range<uint8_t>& zoomRange) const;
+    uint64_t tileCount(SourceType, uint16_t tileSize, const Range<uint8_t>& zoomRange) const;
 
     const std::string styleURL;
     const LatLngBounds bounds;
     const double minZoom;
     const double maxZoom;
     const float pixelRatio;
+    const OfflineRegionGlyphs glyphs;
 };
 
 /*
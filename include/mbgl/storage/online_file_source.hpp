@@ -1,13 +1,21 @@
 #pragma once
 
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/file_source_stats.hpp>
 #include <mbgl/util/constants.hpp>
 
 namespace mbgl {
 
+class FileSourceStatsRecorder;
+
 class OnlineFileSource : public FileSource {
 public:
     OnlineFileSource();
+
+    // Records the stats of its network requests into the given recorder, shared with the
+    // file source that makes them.
+    explicit OnlineFileSource(std::shared_ptr<FileSourceStatsRecorder>);
+
     ~OnlineFileSource() override;
 
     void setAPIBaseURL(const std::string& t) { apiBaseURL = t; }
@@ -21,6 +29,10 @@ public:
     void setResourceTransform(ResourceTransform&& cb);
 
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+    void setPriority(AsyncRequest&, Resource::Priority) override;
+
+    // The network fields of the stats; thread-safe.
+    FileSourceStats getStats() const;
 
 private:
     friend class OnlineFileRequest;
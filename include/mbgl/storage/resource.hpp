@@ -34,9 +34,22 @@ public:
         Required = true,
     };
 
+    // Requests that have to wait for a network connection are made in order of priority.
+    // By default, it depends on the kind of resource: styles and sources come first, then
+    // glyphs and sprites, then tiles. Offline downloads use `Low`.
+    enum Priority : uint8_t {
+        Low = 0,
+        Regular,
+        High,
+        Highest
+    };
+
+    static Priority defaultPriority(Kind);
+
     Resource(Kind kind_, std::string url_, optional<TileData> tileData_ = {}, Necessity necessity_ = Required)
         : kind(kind_),
           necessity(necessity_),
+          priority(defaultPriority(kind_)),
           url(std::move(url_)),
           tileData(std::move(tileData_)) {
     }
@@ -58,6 +71,7 @@ public:
 
     Kind kind;
     Necessity necessity;
+    Priority priority;
     std::string url;
 
     // Includes auxiliary data if this is a tile request.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/util/chrono.hpp>
+#include <mbgl/util/compression.hpp>
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/variant.hpp>
 
@@ -30,6 +31,10 @@ public:
     // The actual data of the response. Present only for non-error, non-notModified responses.
     std::shared_ptr<const std::string> data;
 
+    // How `data` is compressed. Tiles read from the cache may be passed along as they are
+    // stored, to be inflated with `util::decompress` by the thread that uses them.
+    util::Compression compression = util::Compression::None;
+
     optional<Timestamp> modified;
     optional<Timestamp> expires;
     optional<std::string> etag;
@@ -68,9 +68,59 @@ struct Converter<GeoJSONOptions> {
             }
         }
 
+        const auto clusterPropertiesValue = objectMember(value, "clusterProperties");
+        if (clusterPropertiesValue) {
+            if (!isObject(*clusterPropertiesValue)) {
+                return Error{ "GeoJSON source clusterProperties value must be an object" };
+            }
+            optional<Error> error = eachMember(*clusterPropertiesValue, [&] (const std::string& name, const V& property) -> optional<Error> {
+                Result<GeoJSONOptions::ClusterProperty> converted = convertClusterProperty(property);
+                if (!converted) {
+                    return converted.error();
+                }
+                options.clusterProperties.emplace(name, *converted);
+                return {};
+            });
+            if (error) {
+                return *error;
+            }
+        }
+
         return { options };
     }
 
+private:
+    // A cluster property is given as `[operator, ["get", property]]`, where the operator is
+    // one of "+", "min" and "max".
+    template <class V>
+    Result<GeoJSONOptions::ClusterProperty> convertClusterProperty(const V& value) const {
+        const Error error { "GeoJSON source cluster properties must be [\"+\" | \"min\" | \"max\", [\"get\", property]]" };
+        if (!isArray(value) || arrayLength(value) != 2) {
+            return error;
+        }
+
+        optional<std::string> op = toString(arrayMember(value, 0));
+        const auto& get = arrayMember(value, 1);
+        if (!op || !isArray(get) || arrayLength(get) != 2 ||
+            toString(arrayMember(get, 0)) != std::string("get")) {
+            return error;
+        }
+        optional<std::string> property = toString(arrayMember(get, 1));
+        if (!property) {
+            return error;
+        }
+
+        using Operator = GeoJSONOptions::ClusterProperty::Operator;
+        if (*op == "+") {
+            return GeoJSONOptions::ClusterProperty { Operator::Sum, *property };
+        } else if (*op == "min") {
+            return GeoJSONOptions::ClusterProperty { Operator::Min, *property };
+        } else if (*op == "max") {
+            return GeoJSONOptions::ClusterProperty { Operator::Max, *property };
+        }
+        return error;
+    }
+
 };
 
 } // namespace conversion
@@ -6,6 +6,8 @@
 #include <cassert>
 #include <utility>
 #include <map>
+#include <string>
+#include <unordered_map>
 
 namespace mbgl {
 namespace style {
@@ -26,6 +28,7 @@ public:
     CategoricalStops(Stops stops_)
         : stops(std::move(stops_)) {
         assert(stops.size() > 0);
+        index();
     }
 
     optional<T> evaluate(const Value&) const;
@@ -34,6 +37,17 @@ public:
                            const CategoricalStops& rhs) {
         return lhs.stops == rhs.stops;
     }
+
+private:
+    void index();
+
+    // The stops in hash tables by the type of their key, built when constructed: `stops` is not
+    // to be changed afterwards. Strings of features are looked up as they are, without copying
+    // them into a CategoricalValue.
+    std::unordered_map<std::string, T> strings;
+    std::unordered_map<int64_t, T> integers;
+    optional<T> falseValue;
+    optional<T> trueValue;
 };
 
 } // namespace style
@@ -2,6 +2,9 @@
 
 #include <mbgl/style/function/categorical_stops.hpp>
 
+#include <map>
+#include <vector>
+
 namespace mbgl {
 namespace style {
 
@@ -14,16 +17,30 @@ public:
     CompositeCategoricalStops() = default;
     CompositeCategoricalStops(Stops stops_)
         : stops(std::move(stops_)) {
+        for (const auto& stop : stops) {
+            zooms.push_back(stop.first);
+            zoomStops.emplace_back(stop.second);
+        }
+    }
+
+    // The zoom of each stop, in order.
+    const std::vector<float>& getZooms() const {
+        return zooms;
     }
 
-    CategoricalStops<T> innerStops(const std::map<CategoricalValue, T>& stops_) const {
-        return CategoricalStops<T>(stops_);
+    const CategoricalStops<T>& innerStops(std::size_t index) const {
+        return zoomStops[index];
     }
 
     friend bool operator==(const CompositeCategoricalStops& lhs,
                            const CompositeCategoricalStops& rhs) {
         return lhs.stops == rhs.stops;
     }
+
+private:
+    // Built when constructed, like the inner stops themselves.
+    std::vector<float> zooms;
+    std::vector<CategoricalStops<T>> zoomStops;
 };
 
 } // namespace style
@@ -3,6 +3,7 @@
 #include <mbgl/style/function/exponential_stops.hpp>
 
 #include <map>
+#include <vector>
 
 namespace mbgl {
 namespace style {
@@ -19,16 +20,30 @@ public:
     CompositeExponentialStops(Stops stops_, float base_ = 1.0f)
         : stops(std::move(stops_)),
           base(base_) {
+        for (const auto& stop : stops) {
+            zooms.push_back(stop.first);
+            zoomStops.emplace_back(stop.second, base);
+        }
     }
 
-    ExponentialStops<T> innerStops(const std::map<float, T>& stops_) const {
-        return ExponentialStops<T>(stops_, base);
+    // The zoom of each stop, in order.
+    const std::vector<float>& getZooms() const {
+        return zooms;
+    }
+
+    const ExponentialStops<T>& innerStops(std::size_t index) const {
+        return zoomStops[index];
     }
 
     friend bool operator==(const CompositeExponentialStops& lhs,
                            const CompositeExponentialStops& rhs) {
         return lhs.stops == rhs.stops && lhs.base == rhs.base;
     }
+
+private:
+    // Built when constructed, like the inner stops themselves.
+    std::vector<float> zooms;
+    std::vector<ExponentialStops<T>> zoomStops;
 };
 
 } // namespace style
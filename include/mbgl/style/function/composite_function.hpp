@@ -7,8 +7,10 @@
 #include <mbgl/util/range.hpp>
 #include <mbgl/util/variant.hpp>
 
+#include <algorithm>
 #include <string>
 #include <tuple>
+#include <vector>
 
 namespace mbgl {
 
@@ -53,21 +55,18 @@ public:
     coveringRanges(float zoom) const {
         return stops.match(
             [&] (const auto& s) {
-                assert(!s.stops.empty());
-                auto minIt = s.stops.lower_bound(zoom);
-                auto maxIt = s.stops.upper_bound(zoom);
-                if (minIt != s.stops.begin()) {
-                    minIt--;
+                const std::vector<float>& zooms = s.getZooms();
+                assert(!zooms.empty());
+                const std::size_t last = zooms.size() - 1;
+                std::size_t min = std::lower_bound(zooms.begin(), zooms.end(), zoom) - zooms.begin();
+                std::size_t max = std::upper_bound(zooms.begin(), zooms.end(), zoom) - zooms.begin();
+                if (min != 0) {
+                    min--;
                 }
+                max = std::min(max, last);
                 return std::make_tuple(
-                    Range<float> {
-                        minIt == s.stops.end() ? s.stops.rbegin()->first : minIt->first,
-                        maxIt == s.stops.end() ? s.stops.rbegin()->first : maxIt->first
-                    },
-                    Range<InnerStops> {
-                        s.innerStops(minIt == s.stops.end() ? s.stops.rbegin()->second : minIt->second),
-                        s.innerStops(maxIt == s.stops.end() ? s.stops.rbegin()->second : maxIt->second)
-                    }
+                    Range<float> { zooms[min], zooms[max] },
+                    Range<InnerStops> { s.innerStops(min), s.innerStops(max) }
                 );
             }
         );
@@ -76,7 +75,14 @@ public:
     Range<T> evaluate(Range<InnerStops> coveringStops,
                       const GeometryTileFeature& feature,
                       T finalDefaultValue) const {
-        optional<Value> v = feature.getValue(property);
+        optional<Value> storage;
+        return evaluate(coveringStops, feature.findValue(property, storage), finalDefaultValue);
+    }
+
+    // Evaluates the value of the property, or null for features without one.
+    Range<T> evaluate(const Range<InnerStops>& coveringStops,
+                      const Value* v,
+                      T finalDefaultValue) const {
         if (!v) {
             return {
                 defaultValue.value_or(finalDefaultValue),
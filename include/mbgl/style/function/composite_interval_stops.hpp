@@ -3,6 +3,7 @@
 #include <mbgl/style/function/interval_stops.hpp>
 
 #include <map>
+#include <vector>
 
 namespace mbgl {
 namespace style {
@@ -16,16 +17,30 @@ public:
     CompositeIntervalStops() = default;
     CompositeIntervalStops(Stops stops_)
         : stops(std::move(stops_)) {
+        for (const auto& stop : stops) {
+            zooms.push_back(stop.first);
+            zoomStops.emplace_back(stop.second);
+        }
     }
 
-    IntervalStops<T> innerStops(const std::map<float, T>& stops_) const {
-        return IntervalStops<T>(stops_);
+    // The zoom of each stop, in order.
+    const std::vector<float>& getZooms() const {
+        return zooms;
+    }
+
+    const IntervalStops<T>& innerStops(std::size_t index) const {
+        return zoomStops[index];
     }
 
     friend bool operator==(const CompositeIntervalStops& lhs,
                            const CompositeIntervalStops& rhs) {
         return lhs.stops == rhs.stops;
     }
+
+private:
+    // Built when constructed, like the inner stops themselves.
+    std::vector<float> zooms;
+    std::vector<IntervalStops<T>> zoomStops;
 };
 
 } // namespace style
@@ -3,7 +3,10 @@
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/interpolate.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <map>
+#include <vector>
 
 namespace mbgl {
 namespace style {
@@ -20,10 +23,18 @@ public:
     ExponentialStops(Stops stops_, float base_ = 1.0f)
         : stops(std::move(stops_)),
           base(base_) {
+        for (const auto& stop : stops) {
+            if (!inputs.empty()) {
+                const float zoomDiff = stop.first - inputs.back();
+                denominators.push_back(base == 1.0f ? zoomDiff : std::pow(base, zoomDiff) - 1);
+            }
+            inputs.push_back(stop.first);
+            outputs.push_back(stop.second);
+        }
     }
 
     optional<T> evaluate(const Value& value) const {
-        if (stops.empty()) {
+        if (inputs.empty()) {
             assert(false);
             return T();
         }
@@ -33,14 +44,16 @@ public:
             return T();
         }
 
-        auto it = stops.upper_bound(*z);
-        if (it == stops.end()) {
-            return stops.rbegin()->second;
-        } else if (it == stops.begin()) {
-            return stops.begin()->second;
+        const std::size_t i = std::upper_bound(inputs.begin(), inputs.end(), *z) - inputs.begin();
+        if (i == inputs.size()) {
+            return outputs.back();
+        } else if (i == 0) {
+            return outputs.front();
         } else {
-            return util::interpolate(std::prev(it)->second, it->second,
-                util::interpolationFactor(base, { std::prev(it)->first, it->first }, *z));
+            // As util::interpolationFactor, with the powers of the stop ranges computed once.
+            const float zoomProgress = *z - inputs[i - 1];
+            return util::interpolate(outputs[i - 1], outputs[i],
+                (base == 1.0f ? zoomProgress : std::pow(base, zoomProgress) - 1) / denominators[i - 1]);
         }
     }
 
@@ -48,6 +61,13 @@ public:
                            const ExponentialStops& rhs) {
         return lhs.stops == rhs.stops && lhs.base == rhs.base;
     }
+
+private:
+    // The stops in contiguous arrays, built when constructed: `stops` and `base` are not to be
+    // changed afterwards. Between each stop and the next is the denominator of the factor.
+    std::vector<float> inputs;
+    std::vector<T> outputs;
+    std::vector<float> denominators;
 };
 
 } // namespace style
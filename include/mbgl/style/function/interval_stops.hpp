@@ -2,7 +2,9 @@
 
 #include <mbgl/util/feature.hpp>
 
+#include <algorithm>
 #include <map>
+#include <vector>
 
 namespace mbgl {
 namespace style {
@@ -16,10 +18,14 @@ public:
     IntervalStops() = default;
     IntervalStops(Stops stops_)
         : stops(std::move(stops_)) {
+        for (const auto& stop : stops) {
+            inputs.push_back(stop.first);
+            outputs.push_back(stop.second);
+        }
     }
 
     optional<T> evaluate(const Value& value) const {
-        if (stops.empty()) {
+        if (inputs.empty()) {
             assert(false);
             return {};
         }
@@ -29,20 +35,20 @@ public:
             return {};
         }
 
-        auto it = stops.upper_bound(*z);
-        if (it == stops.end()) {
-            return stops.rbegin()->second;
-        } else if (it == stops.begin()) {
-            return stops.begin()->second;
-        } else {
-            return std::prev(it)->second;
-        }
+        const std::size_t i = std::upper_bound(inputs.begin(), inputs.end(), *z) - inputs.begin();
+        return outputs[i == 0 ? 0 : i - 1];
     }
 
     friend bool operator==(const IntervalStops& lhs,
                            const IntervalStops& rhs) {
         return lhs.stops == rhs.stops;
     }
+
+private:
+    // The stops in contiguous arrays, built when constructed: `stops` is not to be changed
+    // afterwards.
+    std::vector<float> inputs;
+    std::vector<T> outputs;
 };
 
 } // namespace style
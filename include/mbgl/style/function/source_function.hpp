@@ -35,7 +35,12 @@ public:
     }
 
     T evaluate(const GeometryTileFeature& feature, T finalDefaultValue) const {
-        optional<Value> v = feature.getValue(property);
+        optional<Value> storage;
+        return evaluate(feature.findValue(property, storage), finalDefaultValue);
+    }
+
+    // Evaluates the value of the property, or null for features without one.
+    T evaluate(const Value* v, T finalDefaultValue) const {
         if (!v) {
             return defaultValue.value_or(finalDefaultValue);
         }
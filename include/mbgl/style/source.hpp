@@ -2,10 +2,12 @@
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/map/tile_load_stats.hpp>
 #include <mbgl/style/types.hpp>
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace mbgl {
 namespace style {
@@ -53,6 +55,20 @@ public:
 
     optional<std::string> getAttribution() const;
 
+    // Simplifies the lines and polygons of the source's tiles as they are laid out, dropping
+    // points that move them by less than this many pixels where tiles are drawn at their own
+    // zoom level. Points and labels are left as they are. Zero, the default, keeps every point.
+    void setSimplificationTolerance(float pixels);
+    float getSimplificationTolerance() const;
+
+    // For debugging slow loads: when the tiles the source holds, not counting those cached for
+    // reuse, went through each phase of loading, ordered by tile ID.
+    std::vector<TileTimeline> getTileTimelines() const;
+
+    // The durations of the loading phases of the tiles the source has rendered, which tell
+    // whether loading is bound by the network, the workers or the GPU.
+    TileLoadStats getTileLoadStats() const;
+
     // Private implementation
     class Impl;
     const std::unique_ptr<Impl> baseImpl;
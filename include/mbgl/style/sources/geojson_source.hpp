@@ -1,28 +1,32 @@
 #pragma once
 
 #include <mbgl/style/source.hpp>
+#include <mbgl/util/feature.hpp>
 #include <mbgl/util/geojson.hpp>
 #include <mbgl/util/optional.hpp>
 
 #include <mapbox/geojson.hpp>
 
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
 namespace mapbox {
 
 namespace geojsonvt {
 class GeoJSONVT;
 } // namespace geojsonvt
 
-namespace supercluster {
-class Supercluster;
-} // namespace supercluster
-
 } // namespace mapbox
 
 namespace mbgl {
 namespace style {
 
-using GeoJSONVTPointer = std::unique_ptr<mapbox::geojsonvt::GeoJSONVT>;
-using SuperclusterPointer = std::unique_ptr<mapbox::supercluster::Supercluster>;
+class GeoJSONClusterIndex;
+
+using GeoJSONVTPointer = std::shared_ptr<mapbox::geojsonvt::GeoJSONVT>;
+using ClusterIndexPointer = std::unique_ptr<GeoJSONClusterIndex>;
 
 struct GeoJSONOptions {
     // GeoJSON-VT options
@@ -34,6 +38,17 @@ struct GeoJSONOptions {
     bool cluster = false;
     uint16_t clusterRadius = 50;
     uint8_t clusterMaxZoom = 17;
+
+    // Properties of clusters, by name, each reduced from a numeric property of the points
+    // of the cluster while the clusters are built. Points without the property are left
+    // out; clusters with none of them don't have the property either.
+    struct ClusterProperty {
+        enum class Operator : uint8_t { Sum, Min, Max };
+
+        Operator op;
+        std::string property;
+    };
+    std::map<std::string, ClusterProperty> clusterProperties;
 };
 
 class GeoJSONSource : public Source {
@@ -43,6 +58,13 @@ public:
     void setURL(const std::string& url);
     void setGeoJSON(const GeoJSON&);
 
+    // Add features, or replace the ones with the same identifier, in the current data.
+    // Only the changed features are re-sliced, and only the tiles they touch are reloaded;
+    // clustered sources are re-indexed in full. Features without an identifier are
+    // ignored.
+    void updateFeatures(const FeatureCollection&);
+    void removeFeatures(const std::vector<FeatureIdentifier>&);
+
     optional<std::string> getURL() const;
 
     // Private implementation
@@ -13,6 +13,19 @@ public:
 
     optional<std::string> getURL() const;
 
+    // Whether tiles share their parsed data with the tiles of other sources, in this map or any
+    // other, that load the same tileset. This saves parsing and memory when several maps show the
+    // same tiles. Off by default; changes apply to tiles loaded afterwards.
+    void setTileDataShared(bool);
+    bool isTileDataShared() const;
+
+    // Whether tiles keep their parsed data after layout. When they don't, they keep only the
+    // buffers they were parsed from, and parse them again for queries and layouts, trading
+    // latency for memory on constrained devices. On by default; changes apply to tiles loaded
+    // afterwards.
+    void setTileDataRetained(bool);
+    bool isTileDataRetained() const;
+
     // Private implementation
 
     class Impl;
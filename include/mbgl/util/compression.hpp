@@ -1,12 +1,29 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
 
 namespace mbgl {
 namespace util {
 
-std::string compress(const std::string& raw);
-std::string decompress(const std::string& raw);
+// Data compressed with a dictionary, of strings it is likely to contain, can only be
+// decompressed with the same dictionary.
+std::string compress(const std::string& raw, const std::string& dictionary = {});
+std::string decompress(const std::string& raw, const std::string& dictionary = {});
+
+// The dictionary that tiles are compressed with, of strings common in vector tiles.
+const std::string& tileDictionary();
+
+// How data that is passed along as it was stored is compressed.
+enum class Compression : uint8_t {
+    None,
+    Deflate,
+    DeflateWithTileDictionary,
+};
+
+// Returns the data itself if it isn't compressed.
+std::shared_ptr<const std::string> decompress(std::shared_ptr<const std::string>, Compression);
 
 } // namespace util
 } // namespace mbgl
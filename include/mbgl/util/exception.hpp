@@ -20,5 +20,15 @@ struct MisuseException : Exception {
     MisuseException(const std::string &msg) : Exception(msg) {}
 };
 
+struct StillImageTimeoutException : Exception {
+    StillImageTimeoutException(const char *msg) : Exception(msg) {}
+    StillImageTimeoutException(const std::string &msg) : Exception(msg) {}
+};
+
+struct StillImageCancelledException : Exception {
+    StillImageCancelledException(const char *msg) : Exception(msg) {}
+    StillImageCancelledException(const std::string &msg) : Exception(msg) {}
+};
+
 } // namespace util
 } // namespace mbgl
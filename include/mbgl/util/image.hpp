@@ -126,6 +126,13 @@ using AlphaImage = Image<ImageAlphaMode::Exclusive>;
 
 // TODO: don't use std::string for binary data.
 PremultipliedImage decodeImage(const std::string&);
+// Decodes into the given image, reusing its buffer if it has the decoded image's size, so that
+// images of the same size, such as raster tiles, can be decoded into buffers that are kept.
+void decodeImage(const std::string&, PremultipliedImage&);
+// Raster tiles are drawn with their alpha as stored, which most decoders output as it is.
+// Decoders that can scale images down while decoding them do so by powers of two, as long as
+// the result is at least the given size.
+UnassociatedImage decodeUnassociatedImage(const std::string&, Size minimumSize = {});
 std::string encodePNG(const PremultipliedImage&);
 
 } // namespace mbgl
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+
+namespace mbgl {
+
+// Draws glyphs with fonts found on the device, so that the largest glyph ranges don't have
+// to be downloaded: those of CJK Unified Ideographs (U+4E00 to U+9FFF) and Hangul Syllables
+// (U+AC00 to U+D7AF). Their signed distance fields are computed from the drawn glyphs.
+//
+// Called on worker threads, possibly several at once.
+class LocalGlyphRasterizer {
+public:
+    // A glyph drawn at 24 pixels, the size of the glyphs in glyph PBFs.
+    struct Glyph {
+        // The coverage of each pixel, cropped to the glyph. Empty for glyphs without pixels.
+        AlphaImage image;
+
+        // Like in glyph PBFs: `left` is from the pen position to the left of the image, `top`
+        // from the baseline up to its top, and `advance` from the pen position to the next.
+        int32_t left = 0;
+        int32_t top = 0;
+        uint32_t advance = 0;
+    };
+
+    virtual ~LocalGlyphRasterizer() = default;
+
+    // The glyph for this code point in a font that stands in for the font stack, if there
+    // is one. Glyphs it returns nothing for are missing from labels, like those missing from
+    // a glyph PBF.
+    virtual optional<Glyph> rasterize(const FontStack&, char16_t) = 0;
+};
+
+} // namespace mbgl
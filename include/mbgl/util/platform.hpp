@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -23,6 +24,14 @@ void setCurrentThreadName(const std::string& name);
 // Makes the current thread low priority.
 void makeThreadLowPriority();
 
+// Sets the scheduling priority of the current thread as a nice value, from -20 (highest) to
+// 19 (lowest). Platforms without nice values map it onto their closest equivalent.
+void setCurrentThreadPriority(int niceness);
+
+// Restricts the current thread to the CPUs selected in the mask (bit i selects CPU i).
+// Returns false if the platform doesn't support it or the call failed.
+bool setCurrentThreadAffinity(uint64_t cpuMask);
+
 // Shows an alpha image with the specified dimensions in a named window.
 void showDebugImage(std::string name, const char *data, size_t width, size_t height);
 
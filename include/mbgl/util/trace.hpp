@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace mbgl {
+namespace util {
+namespace trace {
+
+/*
+    Tracing of where the time of a frame or of a tile goes, in the Trace Event format that
+    chrome://tracing and Perfetto open. It is compiled in with `MBGL_TRACING` (`WITH_TRACING`
+    in CMake); otherwise the macros below expand to nothing and don't evaluate their
+    arguments, and nothing can be recorded.
+
+    Events are only recorded between `start()` and `stop()`. Each thread appends them to a
+    buffer of its own, which `write()` collects; buffers outlive their threads until then.
+*/
+
+// Whether tracing is compiled in.
+bool available();
+
+void start();
+void stop();
+
+bool isRecording();
+
+// Writes the events recorded so far to the file as a JSON trace, and discards them.
+// Returns false if the file couldn't be written.
+bool write(const std::string& path);
+
+// The events recorded so far as a JSON trace, which are discarded.
+std::string flush();
+
+#if MBGL_TRACING
+
+// An ID for matching the beginning and the end of an asynchronous span, or of a flow.
+uint64_t nextID();
+
+// A span on the current thread, for the lifetime of the object.
+class Scope {
+public:
+    Scope(const char* category, const char* name);
+    Scope(const char* category, std::string name);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* category;
+    const char* staticName = nullptr;
+    std::string name;
+    double start = -1;
+};
+
+// Spans that begin and end on any thread, such as those of a file source request.
+void asyncBegin(const char* category, std::string name, uint64_t id);
+void asyncEnd(const char* category, std::string name, uint64_t id);
+
+// Arrows from the span enclosing `flowStart` to the one enclosing the matching `flowEnd`,
+// such as the hops of an actor message from its sender to its receiver.
+void flowStart(const char* category, const char* name, uint64_t id);
+void flowEnd(const char* category, const char* name, uint64_t id);
+
+#define __MBGL_TRACE_NAME2(counter) __MBGL_TRACE_##counter
+#define __MBGL_TRACE_NAME(counter) __MBGL_TRACE_NAME2(counter)
+#define MBGL_TRACE_SCOPE(category, name) ::mbgl::util::trace::Scope __MBGL_TRACE_NAME(__LINE__)(category, name);
+#define MBGL_TRACE_ASYNC_BEGIN(category, name, id) ::mbgl::util::trace::asyncBegin(category, name, id);
+#define MBGL_TRACE_ASYNC_END(category, name, id) ::mbgl::util::trace::asyncEnd(category, name, id);
+#define MBGL_TRACE_FLOW_START(category, name, id) ::mbgl::util::trace::flowStart(category, name, id);
+#define MBGL_TRACE_FLOW_END(category, name, id) ::mbgl::util::trace::flowEnd(category, name, id);
+
+#else
+
+#define MBGL_TRACE_SCOPE(category, name)
+#define MBGL_TRACE_ASYNC_BEGIN(category, name, id)
+#define MBGL_TRACE_ASYNC_END(category, name, id)
+#define MBGL_TRACE_FLOW_START(category, name, id)
+#define MBGL_TRACE_FLOW_END(category, name, id)
+
+#endif
+
+} // namespace trace
+} // namespace util
+} // namespace mbgl
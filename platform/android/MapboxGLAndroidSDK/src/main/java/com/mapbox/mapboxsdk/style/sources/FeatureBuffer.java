@@ -0,0 +1,204 @@
+package com.mapbox.mapboxsdk.style.sources;
+
+import com.google.gson.JsonArray;
+import com.google.gson.JsonElement;
+import com.google.gson.JsonObject;
+import com.google.gson.JsonPrimitive;
+import com.mapbox.services.commons.geojson.Feature;
+import com.mapbox.services.commons.geojson.FeatureCollection;
+import com.mapbox.services.commons.geojson.Geometry;
+import com.mapbox.services.commons.geojson.GeometryCollection;
+import com.mapbox.services.commons.geojson.LineString;
+import com.mapbox.services.commons.geojson.MultiLineString;
+import com.mapbox.services.commons.geojson.MultiPoint;
+import com.mapbox.services.commons.geojson.MultiPolygon;
+import com.mapbox.services.commons.geojson.Point;
+import com.mapbox.services.commons.geojson.Polygon;
+import com.mapbox.services.commons.models.Position;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.Charset;
+import java.util.List;
+import java.util.Map;
+
+/**
+ * Encodes features into a direct {@link ByteBuffer}, which native code decodes in one call
+ * instead of converting each object across JNI. The format is described in
+ * `platform/android/src/geometry/feature_buffer.hpp`.
+ */
+final class FeatureBuffer {
+
+  private static final int VERSION = 1;
+  private static final Charset UTF_8 = Charset.forName("UTF-8");
+
+  // Integers that doubles represent exactly.
+  private static final double MAX_SAFE_INTEGER = 9007199254740991.0;
+
+  private ByteBuffer buffer;
+
+  private FeatureBuffer(int capacity) {
+    buffer = ByteBuffer.allocateDirect(capacity).order(ByteOrder.nativeOrder());
+  }
+
+  /**
+   * Encodes the features.
+   *
+   * @param features the features
+   * @return a direct buffer holding them, from 0 to its position
+   */
+  static ByteBuffer encode(FeatureCollection features) {
+    List<Feature> list = features.getFeatures();
+    FeatureBuffer encoder = new FeatureBuffer(64 + list.size() * 64);
+    encoder.putInt(VERSION);
+    encoder.putInt(list.size());
+    for (Feature feature : list) {
+      encoder.putFeature(feature);
+    }
+    return encoder.buffer;
+  }
+
+  private void ensureRemaining(int bytes) {
+    if (buffer.remaining() < bytes) {
+      ByteBuffer grown = ByteBuffer.allocateDirect(Math.max(buffer.capacity() * 2, buffer.position() + bytes))
+        .order(ByteOrder.nativeOrder());
+      buffer.flip();
+      grown.put(buffer);
+      buffer = grown;
+    }
+  }
+
+  private void putByte(int value) {
+    ensureRemaining(1);
+    buffer.put((byte) value);
+  }
+
+  private void putInt(int value) {
+    ensureRemaining(4);
+    buffer.putInt(value);
+  }
+
+  private void putString(String value) {
+    byte[] bytes = value.getBytes(UTF_8);
+    putInt(bytes.length);
+    ensureRemaining(bytes.length);
+    buffer.put(bytes);
+  }
+
+  private void putPosition(Position position) {
+    ensureRemaining(16);
+    buffer.putDouble(position.getLongitude());
+    buffer.putDouble(position.getLatitude());
+  }
+
+  private void putPositions(List<Position> positions) {
+    putInt(positions.size());
+    ensureRemaining(positions.size() * 16);
+    for (Position position : positions) {
+      buffer.putDouble(position.getLongitude());
+      buffer.putDouble(position.getLatitude());
+    }
+  }
+
+  private void putLines(List<List<Position>> lines) {
+    putInt(lines.size());
+    for (List<Position> line : lines) {
+      putPositions(line);
+    }
+  }
+
+  private void putFeature(Feature feature) {
+    putGeometry(feature.getGeometry());
+    if (feature.getId() != null) {
+      putByte(1);
+      putString(feature.getId());
+    } else {
+      putByte(0);
+    }
+    putObject(feature.getProperties());
+  }
+
+  private void putGeometry(Geometry geometry) {
+    if (geometry instanceof Point) {
+      putByte(1);
+      putPosition(((Point) geometry).getCoordinates());
+    } else if (geometry instanceof MultiPoint) {
+      putByte(2);
+      putPositions(((MultiPoint) geometry).getCoordinates());
+    } else if (geometry instanceof LineString) {
+      putByte(3);
+      putPositions(((LineString) geometry).getCoordinates());
+    } else if (geometry instanceof MultiLineString) {
+      putByte(4);
+      putLines(((MultiLineString) geometry).getCoordinates());
+    } else if (geometry instanceof Polygon) {
+      putByte(5);
+      putLines(((Polygon) geometry).getCoordinates());
+    } else if (geometry instanceof MultiPolygon) {
+      putByte(6);
+      List<List<List<Position>>> polygons = ((MultiPolygon) geometry).getCoordinates();
+      putInt(polygons.size());
+      for (List<List<Position>> polygon : polygons) {
+        putLines(polygon);
+      }
+    } else if (geometry instanceof GeometryCollection) {
+      putByte(7);
+      List<Geometry> geometries = ((GeometryCollection) geometry).getGeometries();
+      putInt(geometries.size());
+      for (Geometry member : geometries) {
+        putGeometry(member);
+      }
+    } else {
+      // Features without a geometry are kept, as an empty one.
+      putByte(7);
+      putInt(0);
+    }
+  }
+
+  private void putObject(JsonObject object) {
+    if (object == null) {
+      putInt(0);
+      return;
+    }
+    putInt(object.entrySet().size());
+    for (Map.Entry<String, JsonElement> entry : object.entrySet()) {
+      putString(entry.getKey());
+      putValue(entry.getValue());
+    }
+  }
+
+  private void putValue(JsonElement element) {
+    if (element == null || element.isJsonNull()) {
+      putByte(0);
+    } else if (element.isJsonPrimitive()) {
+      JsonPrimitive primitive = element.getAsJsonPrimitive();
+      if (primitive.isBoolean()) {
+        putByte(primitive.getAsBoolean() ? 2 : 1);
+      } else if (primitive.isNumber()) {
+        double number = primitive.getAsDouble();
+        if (number == Math.rint(number) && Math.abs(number) <= MAX_SAFE_INTEGER) {
+          putByte(4);
+          ensureRemaining(8);
+          buffer.putLong((long) number);
+        } else {
+          putByte(3);
+          ensureRemaining(8);
+          buffer.putDouble(number);
+        }
+      } else {
+        putByte(5);
+        putString(primitive.getAsString());
+      }
+    } else if (element.isJsonArray()) {
+      JsonArray array = element.getAsJsonArray();
+      putByte(6);
+      putInt(array.size());
+      for (JsonElement member : array) {
+        putValue(member);
+      }
+    } else {
+      putByte(7);
+      putObject(element.getAsJsonObject());
+    }
+  }
+}
@@ -4,6 +4,7 @@ import com.mapbox.services.commons.geojson.Feature;
 import com.mapbox.services.commons.geojson.FeatureCollection;
 
 import java.net.URL;
+import java.nio.ByteBuffer;
 import java.util.ArrayList;
 import java.util.HashMap;
 
@@ -126,7 +127,9 @@ public class GeoJsonSource extends Source {
    */
   public void setGeoJson(FeatureCollection features) {
     checkValidity();
-    setGeoJson(features.toJson());
+    // Encoded in binary, which is much faster than serialising to json and parsing it again
+    ByteBuffer buffer = FeatureBuffer.encode(features);
+    nativeSetFeatureBuffer(buffer, buffer.position());
   }
 
   /**
@@ -173,6 +176,8 @@ public class GeoJsonSource extends Source {
 
   private native void nativeSetGeoJson(Object geoJson);
 
+  private native void nativeSetFeatureBuffer(Object buffer, int length);
+
   @Override
   protected native void finalize() throws Throwable;
 
@@ -48,6 +48,7 @@ macro(mbgl_platform_core)
         PRIVATE platform/android/src/http_file_source.cpp
         PRIVATE platform/default/default_file_source.cpp
         PRIVATE platform/default/local_file_source.cpp
+        PRIVATE platform/default/mbtiles_file_source.cpp
         PRIVATE platform/default/online_file_source.cpp
 
         # Offline
@@ -57,6 +58,8 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/mbgl/storage/offline_database.hpp
         PRIVATE platform/default/mbgl/storage/offline_download.cpp
         PRIVATE platform/default/mbgl/storage/offline_download.hpp
+        PRIVATE platform/default/mbgl/storage/response_cache.cpp
+        PRIVATE platform/default/mbgl/storage/response_cache.hpp
         PRIVATE platform/default/sqlite3.cpp
         PRIVATE platform/default/sqlite3.hpp
 
@@ -164,6 +167,8 @@ macro(mbgl_platform_core)
         # Geometry
         platform/android/src/geometry/feature.cpp
         platform/android/src/geometry/feature.hpp
+        platform/android/src/geometry/feature_buffer.cpp
+        platform/android/src/geometry/feature_buffer.hpp
         platform/android/src/geometry/lat_lng.cpp
         platform/android/src/geometry/lat_lng.hpp
         platform/android/src/geometry/lat_lng_bounds.cpp
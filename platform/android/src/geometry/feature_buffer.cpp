@@ -0,0 +1,318 @@
+#include "feature_buffer.hpp"
+
+#include <mbgl/util/feature.hpp>
+
+#include <cstring>
+#include <string>
+
+namespace mbgl {
+namespace android {
+
+namespace {
+
+// Nested geometry collections, and arrays and objects in properties.
+constexpr uint32_t maxDepth = 64;
+
+class Decoder {
+public:
+    Decoder(const uint8_t* data_, std::size_t length_)
+        : data(data_), length(length_) {
+    }
+
+    template <class T>
+    bool read(T& value) {
+        if (length - position < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    // Guards the reservations made for counts read from the buffer.
+    bool readCount(uint32_t& count, std::size_t minimumSize) {
+        return read(count) && count <= (length - position) / minimumSize;
+    }
+
+    bool readString(std::string& string) {
+        uint32_t size;
+        if (!readCount(size, 1)) {
+            return false;
+        }
+        string.assign(reinterpret_cast<const char*>(data + position), size);
+        position += size;
+        return true;
+    }
+
+    bool readPoint(mapbox::geometry::point<double>& point) {
+        return read(point.x) && read(point.y);
+    }
+
+    template <class Points>
+    bool readPoints(Points& points) {
+        uint32_t count;
+        if (!readCount(count, 2 * sizeof(double))) {
+            return false;
+        }
+        points.resize(count);
+        for (auto& point : points) {
+            readPoint(point);
+        }
+        return true;
+    }
+
+    // Of polygons and multi line strings.
+    template <class Lines>
+    bool readLines(Lines& lines) {
+        uint32_t count;
+        if (!readCount(count, sizeof(uint32_t))) {
+            return false;
+        }
+        lines.resize(count);
+        for (auto& line : lines) {
+            if (!readPoints(line)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool readGeometry(mapbox::geometry::geometry<double>& geometry, uint32_t depth) {
+        uint8_t type;
+        if (!read(type) || depth > maxDepth) {
+            return false;
+        }
+
+        switch (type) {
+        case 1: {
+            mapbox::geometry::point<double> point;
+            if (!readPoint(point)) {
+                return false;
+            }
+            geometry = point;
+            return true;
+        }
+        case 2: {
+            mapbox::geometry::multi_point<double> multiPoint;
+            if (!readPoints(multiPoint)) {
+                return false;
+            }
+            geometry = std::move(multiPoint);
+            return true;
+        }
+        case 3: {
+            mapbox::geometry::line_string<double> lineString;
+            if (!readPoints(lineString)) {
+                return false;
+            }
+            geometry = std::move(lineString);
+            return true;
+        }
+        case 4: {
+            mapbox::geometry::multi_line_string<double> multiLineString;
+            if (!readLines(multiLineString)) {
+                return false;
+            }
+            geometry = std::move(multiLineString);
+            return true;
+        }
+        case 5: {
+            mapbox::geometry::polygon<double> polygon;
+            if (!readLines(polygon)) {
+                return false;
+            }
+            geometry = std::move(polygon);
+            return true;
+        }
+        case 6: {
+            uint32_t count;
+            if (!readCount(count, sizeof(uint32_t))) {
+                return false;
+            }
+            mapbox::geometry::multi_polygon<double> multiPolygon(count);
+            for (auto& polygon : multiPolygon) {
+                if (!readLines(polygon)) {
+                    return false;
+                }
+            }
+            geometry = std::move(multiPolygon);
+            return true;
+        }
+        case 7: {
+            uint32_t count;
+            if (!readCount(count, sizeof(uint8_t))) {
+                return false;
+            }
+            mapbox::geometry::geometry_collection<double> collection;
+            collection.reserve(count);
+            for (uint32_t i = 0; i < count; i++) {
+                mapbox::geometry::geometry<double> member;
+                if (!readGeometry(member, depth + 1)) {
+                    return false;
+                }
+                collection.push_back(std::move(member));
+            }
+            geometry = std::move(collection);
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    bool readProperties(PropertyMap& properties, uint32_t depth) {
+        uint32_t count;
+        if (!readCount(count, sizeof(uint32_t) + sizeof(uint8_t))) {
+            return false;
+        }
+        properties.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            std::string key;
+            Value value;
+            if (!readString(key) || !readValue(value, depth)) {
+                return false;
+            }
+            properties.emplace(std::move(key), std::move(value));
+        }
+        return true;
+    }
+
+    bool readValue(Value& value, uint32_t depth) {
+        uint8_t tag;
+        if (!read(tag) || depth > maxDepth) {
+            return false;
+        }
+
+        switch (tag) {
+        case 0:
+            value = NullValue();
+            return true;
+        case 1:
+        case 2:
+            value = tag == 2;
+            return true;
+        case 3: {
+            double number;
+            if (!read(number)) {
+                return false;
+            }
+            value = number;
+            return true;
+        }
+        case 4: {
+            // Like numbers parsed from JSON: unsigned unless negative.
+            int64_t number;
+            if (!read(number)) {
+                return false;
+            }
+            if (number < 0) {
+                value = number;
+            } else {
+                value = uint64_t(number);
+            }
+            return true;
+        }
+        case 5: {
+            std::string string;
+            if (!readString(string)) {
+                return false;
+            }
+            value = std::move(string);
+            return true;
+        }
+        case 6: {
+            uint32_t count;
+            if (!readCount(count, sizeof(uint8_t))) {
+                return false;
+            }
+            std::vector<Value> array;
+            array.reserve(count);
+            for (uint32_t i = 0; i < count; i++) {
+                Value member;
+                if (!readValue(member, depth + 1)) {
+                    return false;
+                }
+                array.push_back(std::move(member));
+            }
+            value = std::move(array);
+            return true;
+        }
+        case 7: {
+            PropertyMap object;
+            if (!readProperties(object, depth + 1)) {
+                return false;
+            }
+            value = std::move(object);
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    bool readFeature(mapbox::geojson::feature& feature) {
+        uint8_t hasID;
+        if (!readGeometry(feature.geometry, 0) || !read(hasID)) {
+            return false;
+        }
+        if (hasID) {
+            std::string id;
+            if (!readString(id)) {
+                return false;
+            }
+            feature.id = FeatureIdentifier { std::move(id) };
+        }
+        return readProperties(feature.properties, 0);
+    }
+
+    bool atEnd() const {
+        return position == length;
+    }
+
+    std::size_t offset() const {
+        return position;
+    }
+
+private:
+    const uint8_t* const data;
+    const std::size_t length;
+    std::size_t position = 0;
+};
+
+} // namespace
+
+style::conversion::Result<GeoJSON> decodeFeatureBuffer(const uint8_t* data, std::size_t length) {
+    using style::conversion::Error;
+
+    Decoder decoder(data, length);
+
+    uint32_t version;
+    if (!decoder.read(version) || version != 1) {
+        return Error { "unsupported feature buffer version" };
+    }
+
+    // Each feature takes at least an empty geometry, an ID tag and a property count.
+    uint32_t count;
+    if (!decoder.readCount(count, 2 * (1 + sizeof(uint32_t)))) {
+        return Error { "feature buffer truncated" };
+    }
+
+    FeatureCollection features;
+    features.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        mapbox::geojson::feature feature;
+        if (!decoder.readFeature(feature)) {
+            return Error { "invalid feature buffer at byte " + std::to_string(decoder.offset()) };
+        }
+        features.push_back(std::move(feature));
+    }
+
+    if (!decoder.atEnd()) {
+        return Error { "unexpected data after the features" };
+    }
+
+    return GeoJSON { std::move(features) };
+}
+
+} // namespace android
+} // namespace mbgl
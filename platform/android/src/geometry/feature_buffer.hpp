@@ -0,0 +1,33 @@
+#pragma once
+
+#include <mbgl/style/conversion.hpp>
+#include <mbgl/util/geojson.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mbgl {
+namespace android {
+
+/**
+ * Decodes features that `com.mapbox.mapboxsdk.style.sources.FeatureBuffer` wrote into a
+ * direct ByteBuffer, so that a whole collection crosses JNI in one call instead of one
+ * per object. Values are in the byte order of the device:
+ *
+ *   buffer     := u32 version (1), u32 count, feature * count
+ *   feature    := geometry, id, u32 count, (string key, value) * count
+ *   geometry   := u8 1 (Point), f64 longitude, f64 latitude
+ *               | u8 2 (MultiPoint) | u8 3 (LineString), u32 count, (f64, f64) * count
+ *               | u8 4 (MultiLineString) | u8 5 (Polygon), u32 count, line * count
+ *               | u8 6 (MultiPolygon), u32 count, polygon * count
+ *               | u8 7 (GeometryCollection), u32 count, geometry * count
+ *   id         := u8 0 (none) | u8 1, string
+ *   value      := u8 0 (null) | u8 1 (false) | u8 2 (true) | u8 3, f64 | u8 4, i64
+ *               | u8 5, string | u8 6 (array), u32 count, value * count
+ *               | u8 7 (object), u32 count, (string key, value) * count
+ *   string     := u32 length, UTF-8 bytes
+ */
+style::conversion::Result<GeoJSON> decodeFeatureBuffer(const uint8_t* data, std::size_t length);
+
+} // namespace android
+} // namespace mbgl
@@ -1,5 +1,6 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/string.hpp>
+#include <mbgl/util/premultiply.hpp>
 
 #include <string>
 
@@ -19,4 +20,12 @@ PremultipliedImage decodeImage(const std::string& string) {
     return android::Bitmap::GetImage(*env, bitmap);
 }
 
+void decodeImage(const std::string& string, PremultipliedImage& image) {
+    image = decodeImage(string);
+}
+
+UnassociatedImage decodeUnassociatedImage(const std::string& string, Size) {
+    return util::unpremultiply(decodeImage(string));
+}
+
 } // namespace mbgl
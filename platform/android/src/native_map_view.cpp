@@ -1,6 +1,7 @@
 #include "native_map_view.hpp"
 
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <cassert>
 #include <memory>
@@ -10,8 +11,13 @@
 #include <sys/system_properties.h>
 
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
 #include <android/native_window_jni.h>
 
+#ifndef EGL_BUFFER_AGE_EXT
+#define EGL_BUFFER_AGE_EXT 0x313D
+#endif
+
 #include <jni/jni.hpp>
 
 #include <mbgl/gl/context.hpp>
@@ -67,14 +73,8 @@ NativeMapView::NativeMapView(jni::JNIEnv& _env, jni::Object<NativeMapView> _obj,
         pixelRatio, mbgl::android::FileSource::getDefaultFileSource(_env, jFileSource)
         , *threadPool, MapMode::Continuous);
 
-    //Calculate a fitting cache size based on device parameters
-    float zoomFactor   = map->getMaxZoom() - map->getMinZoom() + 1;
-    float cpuFactor    = availableProcessors;
-    float memoryFactor = static_cast<float>(totalMemory) / 1000.0f / 1000.0f / 1000.0f;
-    float sizeFactor   = (static_cast<float>(map->getSize().width)  / mbgl::util::tileSize) *
-        (static_cast<float>(map->getSize().height) / mbgl::util::tileSize);
-
-    map->setSourceTileCacheSize(zoomFactor * cpuFactor * memoryFactor * sizeFactor * 0.5f);
+    // Each source keeps tiles for reuse in up to a sixty-fourth of the device's memory
+    map->setSourceTileCacheBudget(totalMemory / 64);
 }
 
 /**
@@ -98,6 +98,25 @@ void NativeMapView::bind() {
     getContext().viewport = { 0, 0, getFramebufferSize() };
 }
 
+uint32_t NativeMapView::getBufferAge() const {
+    if (display == EGL_NO_DISPLAY || surface == EGL_NO_SURFACE) {
+        return 0;
+    }
+
+    EGLint age = 0;
+    if (hasBufferAge && eglQuerySurface(display, surface, EGL_BUFFER_AGE_EXT, &age)) {
+        return age > 0 ? age : 0;
+    }
+
+    // Without the extension, only a surface that preserves its contents on swap is known to
+    // hold the last frame.
+    EGLint behavior = 0;
+    if (eglQuerySurface(display, surface, EGL_SWAP_BEHAVIOR, &behavior) && behavior == EGL_BUFFER_PRESERVED) {
+        return 1;
+    }
+    return 0;
+}
+
 /**
  * From mbgl::Backend.
  */
@@ -1029,6 +1048,9 @@ void NativeMapView::_initializeDisplay() {
         mbgl::Log::Warning(mbgl::Event::Android, "Running SDK in emulator!");
     }
 
+    const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+    hasBufferAge = extensions && std::strstr(extensions, "EGL_EXT_buffer_age");
+
     if (!eglBindAPI(EGL_OPENGL_ES_API)) {
         mbgl::Log::Error(mbgl::Event::OpenGL, "eglBindAPI(EGL_OPENGL_ES_API) returned error %d", eglGetError());
         throw std::runtime_error("eglBindAPI() failed");
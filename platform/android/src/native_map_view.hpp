@@ -47,6 +47,7 @@ public:
     // mbgl::View //
 
     void bind() override;
+    uint32_t getBufferAge() const override;
 
     // mbgl::Backend //
 
@@ -283,6 +284,8 @@ private:
     EGLSurface surface = EGL_NO_SURFACE;
     EGLContext context = EGL_NO_CONTEXT;
 
+    // Whether the display supports EGL_EXT_buffer_age.
+    bool hasBufferAge = false;
 
     float pixelRatio;
     bool fpsEnabled = false;
@@ -2,6 +2,7 @@
 
 #include "../android_conversion.hpp"
 #include "../conversion/geojson.hpp"
+#include "../../geometry/feature_buffer.hpp"
 #include <mbgl/style/conversion.hpp>
 #include <mbgl/style/conversion/geojson_options.hpp>
 
@@ -38,6 +39,26 @@ namespace android {
         source.as<mbgl::style::GeoJSONSource>()->GeoJSONSource::setGeoJSON(*converted);
     }
 
+    void GeoJSONSource::setFeatureBuffer(jni::JNIEnv& env, jni::Object<> buffer, jni::jint length) {
+        using namespace mbgl::style::conversion;
+
+        // Read in place, without copying the buffer or calling back into Java
+        auto data = static_cast<const uint8_t*>(env.GetDirectBufferAddress(jni::Unwrap(*buffer)));
+        if (!data || length < 0 || length > env.GetDirectBufferCapacity(jni::Unwrap(*buffer))) {
+            mbgl::Log::Error(mbgl::Event::JNI, "Error setting geo json: expected a direct buffer");
+            return;
+        }
+
+        Result<GeoJSON> decoded = android::decodeFeatureBuffer(data, length);
+        if (!decoded) {
+            mbgl::Log::Error(mbgl::Event::JNI, "Error setting geo json: " + decoded.error().message);
+            return;
+        }
+
+        // Update the core source
+        source.as<mbgl::style::GeoJSONSource>()->GeoJSONSource::setGeoJSON(*decoded);
+    }
+
     void GeoJSONSource::setURL(jni::JNIEnv& env, jni::String url) {
         // Update the core source
         source.as<mbgl::style::GeoJSONSource>()->GeoJSONSource::setURL(jni::Make<std::string>(env, url));
@@ -63,6 +84,7 @@ namespace android {
             "initialize",
             "finalize",
             METHOD(&GeoJSONSource::setGeoJSON, "nativeSetGeoJson"),
+            METHOD(&GeoJSONSource::setFeatureBuffer, "nativeSetFeatureBuffer"),
             METHOD(&GeoJSONSource::setURL, "nativeSetUrl")
         );
     }
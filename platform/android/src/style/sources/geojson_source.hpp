@@ -24,6 +24,9 @@ public:
 
     void setGeoJSON(jni::JNIEnv&, jni::Object<>);
 
+    // Takes a direct ByteBuffer, declared as an Object in Java; see `decodeFeatureBuffer`.
+    void setFeatureBuffer(jni::JNIEnv&, jni::Object<>, jni::jint length);
+
     void setURL(jni::JNIEnv&, jni::String);
 
     jni::jobject* createJavaPeer(jni::JNIEnv&);
@@ -1,8 +1,10 @@
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/platform.hpp>
 
+#include <sched.h>
 #include <sys/prctl.h>
 #include <sys/resource.h>
+#include <unistd.h>
 
 // Implementation based on Chromium's platform_thread_android.cc.
 
@@ -33,5 +35,28 @@ void makeThreadLowPriority() {
     setpriority(PRIO_PROCESS, 0, 19);
 }
 
+void setCurrentThreadPriority(int niceness) {
+    if (setpriority(PRIO_PROCESS, gettid(), niceness) != 0) {
+        Log::Warning(Event::General, "Couldn't set thread priority");
+    }
+}
+
+bool setCurrentThreadAffinity(uint64_t cpuMask) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; ++cpu) {
+        if (cpuMask & (uint64_t(1) << cpu)) {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    if (sched_setaffinity(gettid(), sizeof(set), &set) != 0) {
+        Log::Warning(Event::General, "Couldn't set thread affinity");
+        return false;
+    }
+
+    return true;
+}
+
 } // namespace platform
 } // namespace mbgl
@@ -90,13 +90,45 @@ public:
 
             session = [NSURLSession sessionWithConfiguration:sessionConfig];
 
+            // Offline downloads go through connections of their own, fewer of them, which the
+            // system treats as background traffic, so that they don't hold up what the map
+            // is waiting for.
+            NSURLSessionConfiguration* backgroundSessionConfig =
+                [NSURLSessionConfiguration defaultSessionConfiguration];
+            backgroundSessionConfig.timeoutIntervalForResource = 60;
+            backgroundSessionConfig.HTTPMaximumConnectionsPerHost = 2;
+            backgroundSessionConfig.requestCachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+            backgroundSessionConfig.URLCache = nil;
+            backgroundSessionConfig.networkServiceType = NSURLNetworkServiceTypeBackground;
+
+            backgroundSession = [NSURLSession sessionWithConfiguration:backgroundSessionConfig];
+
             userAgent = getUserAgent();
 
             accountType = [[NSUserDefaults standardUserDefaults] integerForKey:@"MGLMapboxAccountType"];
         }
     }
 
+    NSURLSession* sessionForPriority(Resource::Priority priority) const {
+        return priority == Resource::Priority::Low ? backgroundSession : session;
+    }
+
+    static float taskPriority(Resource::Priority priority) {
+        switch (priority) {
+        case Resource::Priority::Highest:
+            return 1.0;
+        case Resource::Priority::High:
+            return NSURLSessionTaskPriorityHigh;
+        case Resource::Priority::Regular:
+            return NSURLSessionTaskPriorityDefault;
+        case Resource::Priority::Low:
+            break;
+        }
+        return NSURLSessionTaskPriorityLow;
+    }
+
     NSURLSession* session = nil;
+    NSURLSession* backgroundSession = nil;
     NSString* userAgent = nil;
     NSInteger accountType = 0;
 
@@ -220,7 +252,7 @@ std::unique_ptr<AsyncRequest> HTTPFileSource::request(const Resource& resource,
 
         [req addValue:impl->userAgent forHTTPHeaderField:@"User-Agent"];
 
-        request->task = [impl->session
+        request->task = [impl->sessionForPriority(resource.priority)
             dataTaskWithRequest:req
               completionHandler:^(NSData* data, NSURLResponse* res, NSError* error) {
                 if (error && [error code] == NSURLErrorCancelled) {
@@ -327,6 +359,8 @@ std::unique_ptr<AsyncRequest> HTTPFileSource::request(const Resource& resource,
                 shared->notify(response);
             }];
 
+        // Styles, sprites and glyphs go ahead of tiles sharing the same connections.
+        request->task.priority = Impl::taskPriority(resource.priority);
         [request->task resume];
     }
 
@@ -1,4 +1,5 @@
 #include <mbgl/util/image+MGLAdditions.hpp>
+#include <mbgl/util/premultiply.hpp>
 
 #import <ImageIO/ImageIO.h>
 
@@ -104,4 +105,12 @@ PremultipliedImage decodeImage(const std::string& source) {
     return MGLPremultipliedImageFromCGImage(*image);
 }
 
+void decodeImage(const std::string& source, PremultipliedImage& image) {
+    image = decodeImage(source);
+}
+
+UnassociatedImage decodeUnassociatedImage(const std::string& source, Size) {
+    return util::unpremultiply(decodeImage(source));
+}
+
 } // namespace mbgl
@@ -3,6 +3,7 @@
 #include <mbgl/util/platform.hpp>
 
 #include <pthread.h>
+#include <pthread/qos.h>
 
 namespace mbgl {
 namespace platform {
@@ -22,5 +23,24 @@ void makeThreadLowPriority() {
     [[NSThread currentThread] setThreadPriority:0.0];
 }
 
+void setCurrentThreadPriority(int niceness) {
+    qos_class_t qos = QOS_CLASS_DEFAULT;
+    if (niceness <= -10) {
+        qos = QOS_CLASS_USER_INTERACTIVE;
+    } else if (niceness < 0) {
+        qos = QOS_CLASS_USER_INITIATED;
+    } else if (niceness > 10) {
+        qos = QOS_CLASS_BACKGROUND;
+    } else if (niceness > 0) {
+        qos = QOS_CLASS_UTILITY;
+    }
+    pthread_set_qos_class_self_np(qos, 0);
+}
+
+bool setCurrentThreadAffinity(uint64_t) {
+    // Darwin has no API for pinning threads to CPUs.
+    return false;
+}
+
 }
 }
@@ -1,4 +1,5 @@
 #include <mbgl/text/bidi.hpp>
+#include <mbgl/util/thread_local.hpp>
 #include <mbgl/util/traits.hpp>
 
 #include <unicode/ubidi.h>
@@ -8,15 +9,48 @@
 
 namespace mbgl {
 
-class BiDiImpl {
+namespace {
+
+// ICU's bidi objects, kept for each thread that lays out text rather than opened for every
+// symbol layout of every tile.
+class UBiDiPair {
 public:
-    BiDiImpl() : bidiText(ubidi_open()), bidiLine(ubidi_open()) {
+    UBiDiPair() : text(ubidi_open()), line(ubidi_open()) {
+    }
+    ~UBiDiPair() {
+        ubidi_close(text);
+        ubidi_close(line);
+    }
+
+    UBiDi* const text;
+    UBiDi* const line;
+};
+
+UBiDiPair& threadUBiDi() {
+    static util::ThreadLocal<UBiDiPair> pairs;
+    if (!pairs.get()) {
+        pairs.set(new UBiDiPair());
     }
-    ~BiDiImpl() {
-        ubidi_close(bidiText);
-        ubidi_close(bidiLine);
+    return *pairs.get();
+}
+
+// Whether the bidirectional algorithm leaves `input` as it is: right-to-left scripts and
+// explicit directional formatting characters all start at U+0590, and there are no other
+// paragraph separators than newlines.
+bool isLeftToRight(const std::u16string& input) {
+    for (const char16_t c : input) {
+        if (c >= 0x0590 || c == u'\r' || (c >= 0x1C && c <= 0x1E) || c == 0x85) {
+            return false;
+        }
     }
+    return true;
+}
+
+} // namespace
 
+class BiDiImpl {
+public:
+    // Those of the thread processing text.
     UBiDi* bidiText = nullptr;
     UBiDi* bidiLine = nullptr;
 };
@@ -27,6 +61,10 @@ BiDi::~BiDi() = default;
 // Takes UTF16 input in logical order and applies Arabic shaping to the input while maintaining
 // logical order. Output won't be intelligible until the bidirectional algorithm is applied
 std::u16string applyArabicShaping(const std::u16string& input) {
+    if (isLeftToRight(input)) {
+        return input; // No Arabic letters.
+    }
+
     UErrorCode errorCode = U_ZERO_ERROR;
 
     const int32_t outputLength =
@@ -89,6 +127,31 @@ std::vector<std::u16string> BiDi::applyLineBreaking(std::set<std::size_t> lineBr
 
 std::vector<std::u16string> BiDi::processText(const std::u16string& input,
                                               std::set<std::size_t> lineBreakPoints) {
+    if (isLeftToRight(input)) {
+        // Each line of a paragraph ending with a newline includes it, as with ICU.
+        for (std::size_t i = 0; i < input.size(); i++) {
+            if (input[i] == u'\n') {
+                lineBreakPoints.insert(i + 1);
+            }
+        }
+        lineBreakPoints.insert(input.size());
+
+        std::vector<std::u16string> lines;
+        lines.reserve(lineBreakPoints.size());
+
+        std::size_t start = 0;
+        for (std::size_t lineBreakPoint : lineBreakPoints) {
+            lines.push_back(input.substr(start, lineBreakPoint - start));
+            start = lineBreakPoint;
+        }
+
+        return lines;
+    }
+
+    UBiDiPair& ubidi = threadUBiDi();
+    impl->bidiText = ubidi.text;
+    impl->bidiLine = ubidi.line;
+
     UErrorCode errorCode = U_ZERO_ERROR;
 
     ubidi_setPara(impl->bidiText, mbgl::utf16char_cast<const UChar*>(input.c_str()), static_cast<int32_t>(input.size()),
@@ -1,13 +1,20 @@
 #include <mbgl/storage/default_file_source.hpp>
 #include <mbgl/storage/asset_file_source.hpp>
 #include <mbgl/storage/local_file_source.hpp>
+#include <mbgl/storage/file_source_stats_recorder.hpp>
+#include <mbgl/storage/mbtiles_file_source.hpp>
 #include <mbgl/storage/online_file_source.hpp>
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/offline_download.hpp>
+#include <mbgl/storage/response_cache.hpp>
 
+#include <mbgl/util/logging.hpp>
 #include <mbgl/util/platform.hpp>
+#include <mbgl/util/string.hpp>
 #include <mbgl/util/url.hpp>
 #include <mbgl/util/thread.hpp>
+#include <mbgl/util/timer.hpp>
+#include <mbgl/util/trace.hpp>
 #include <mbgl/util/work_request.hpp>
 
 #include <cassert>
@@ -24,10 +31,75 @@ bool isAssetURL(const std::string& url) {
 
 namespace mbgl {
 
+namespace {
+
+const Duration evictionDelay = Milliseconds(500);
+const Duration evictionBudget = Milliseconds(20);
+
+// The threads reading the database alongside the file source thread, with write-ahead logging.
+const std::size_t databaseReaders = 2;
+
+// Whether a request is answered from the caches before going online, if at all.
+bool readsCache(const Resource& resource) {
+    const bool hasPrior = resource.priorEtag || resource.priorModified || resource.priorExpires;
+    return !hasPrior || resource.necessity == Resource::Optional;
+}
+
+// Looks the resource up in the memory cache, and then in the database. Return value is the
+// response, if any, and whether it was read from the database.
+std::pair<optional<Response>, bool> lookUp(ResponseCache& memoryCache,
+                                           FileSourceStatsRecorder& stats,
+                                           OfflineDatabase* database,
+                                           const Resource& resource) {
+    auto response = memoryCache.get(resource);
+    bool fromDatabase = false;
+    if (!response && database) {
+        MBGL_TRACE_SCOPE("file source", "offline database get");
+        // Tiles are inflated by the workers that parse them.
+        response = database->getCompressed(resource);
+        if (response) {
+            memoryCache.put(resource, *response);
+            fromDatabase = true;
+        }
+    }
+
+    const bool hit = bool(response);
+    stats.record(resource.kind, [&] (auto& counters) {
+        if (hit) {
+            counters.cacheHits++;
+        } else {
+            counters.cacheMisses++;
+        }
+    });
+
+    return { std::move(response), fromDatabase };
+}
+
+// What the caches answer a request with, if anything.
+optional<Response> cachedResponse(const Resource& resource, optional<Response> response) {
+    if (resource.necessity == Resource::Optional && !response) {
+        // Ensure there's always a response that we can send, so the caller knows that
+        // there's no optional data available in the cache.
+        response.emplace();
+        response->noContent = true;
+        response->error = std::make_unique<Response::Error>(
+            Response::Error::Reason::NotFound, "Not found in offline database");
+    }
+    return response;
+}
+
+} // namespace
+
 class DefaultFileSource::Impl {
 public:
-    Impl(const std::string& cachePath, uint64_t maximumCacheSize)
-        : offlineDatabase(cachePath, maximumCacheSize) {
+    Impl(const std::string& cachePath,
+         uint64_t maximumCacheSize,
+         std::shared_ptr<ResponseCache> memoryCache_,
+         std::shared_ptr<FileSourceStatsRecorder> stats_)
+        : offlineDatabase(cachePath, maximumCacheSize),
+          memoryCache(std::move(memoryCache_)),
+          stats(std::move(stats_)),
+          onlineFileSource(stats) {
     }
 
     void setAPIBaseURL(const std::string& url) {
@@ -90,12 +162,30 @@ public:
         try {
             downloads.erase(region.getID());
             offlineDatabase.deleteRegion(std::move(region));
+            scheduleEviction();
+            callback({});
+        } catch (...) {
+            callback(std::current_exception());
+        }
+    }
+
+    void exportRegion(int64_t regionID, const std::string& path, std::function<void (std::exception_ptr)> callback) {
+        try {
+            offlineDatabase.exportRegion(regionID, path);
             callback({});
         } catch (...) {
             callback(std::current_exception());
         }
     }
 
+    void importRegions(const std::string& path, std::function<void (std::exception_ptr, optional<std::vector<OfflineRegion>>)> callback) {
+        try {
+            callback({}, offlineDatabase.importRegions(path));
+        } catch (...) {
+            callback(std::current_exception(), {});
+        }
+    }
+
     void setRegionObserver(int64_t regionID, std::unique_ptr<OfflineRegionObserver> observer) {
         getDownload(regionID).setObserver(std::move(observer));
     }
@@ -104,22 +194,19 @@ public:
         getDownload(regionID).setState(state);
     }
 
+    void refreshRegion(int64_t regionID) {
+        getDownload(regionID).refresh();
+    }
+
+    void addRegionGlyphRange(int64_t regionID, Range<char16_t> codepoints) {
+        getDownload(regionID).addGlyphRange(codepoints);
+    }
+
     void request(AsyncRequest* req, Resource resource, Callback callback) {
         Resource revalidation = resource;
 
-        const bool hasPrior = resource.priorEtag || resource.priorModified || resource.priorExpires;
-        if (!hasPrior || resource.necessity == Resource::Optional) {
-            auto offlineResponse = offlineDatabase.get(resource);
-
-            if (resource.necessity == Resource::Optional && !offlineResponse) {
-                // Ensure there's always a response that we can send, so the caller knows that
-                // there's no optional data available in the cache.
-                offlineResponse.emplace();
-                offlineResponse->noContent = true;
-                offlineResponse->error = std::make_unique<Response::Error>(
-                    Response::Error::Reason::NotFound, "Not found in offline database");
-            }
-
+        if (readsCache(resource)) {
+            auto offlineResponse = cachedResponse(resource, lookUp(*memoryCache, *stats, &offlineDatabase, resource).first);
             if (offlineResponse) {
                 revalidation.priorModified = offlineResponse->modified;
                 revalidation.priorExpires = offlineResponse->expires;
@@ -128,9 +215,29 @@ public:
             }
         }
 
-        if (resource.necessity == Resource::Required) {
+        requestOnline(req, std::move(revalidation), std::move(callback));
+    }
+
+    // Continues a request that a reader answered from the caches, with what it found.
+    void revalidate(AsyncRequest* req, Resource resource, optional<Response> cached, bool fromDatabase, Callback callback) {
+        if (fromDatabase) {
+            offlineDatabase.recordAccess(resource);
+        }
+
+        if (cached) {
+            resource.priorModified = cached->modified;
+            resource.priorExpires = cached->expires;
+            resource.priorEtag = cached->etag;
+        }
+        requestOnline(req, std::move(resource), std::move(callback));
+    }
+
+    void requestOnline(AsyncRequest* req, Resource revalidation, Callback callback) {
+        if (revalidation.necessity == Resource::Required) {
             tasks[req] = onlineFileSource.request(revalidation, [=] (Response onlineResponse) {
                 this->offlineDatabase.put(revalidation, onlineResponse);
+                this->memoryCache->put(revalidation, onlineResponse);
+                this->scheduleEviction();
                 callback(onlineResponse);
             });
         }
@@ -140,15 +247,46 @@ public:
         tasks.erase(req);
     }
 
+    void setPriority(AsyncRequest* req, Resource::Priority priority) {
+        // Requests answered from the database, or optional ones, have no online request.
+        auto it = tasks.find(req);
+        if (it != tasks.end()) {
+            onlineFileSource.setPriority(*it->second, priority);
+        }
+    }
+
     void setOfflineMapboxTileCountLimit(uint64_t limit) {
         offlineDatabase.setOfflineMapboxTileCountLimit(limit);
     }
 
+    void setWriteAheadLogging(bool enabled) {
+        offlineDatabase.setWriteAheadLogging(enabled);
+    }
+
     void put(const Resource& resource, const Response& response) {
         offlineDatabase.put(resource, response);
+        memoryCache->put(resource, response);
+        scheduleEviction();
     }
 
 private:
+    // Evicts the cache in short steps, so that requests waiting for the database aren't held
+    // up for long.
+    void scheduleEviction() {
+        if (!evicting && offlineDatabase.needsEviction()) {
+            evicting = true;
+            evictionTimer.start(evictionDelay, Duration::zero(), [this] { evict(); });
+        }
+    }
+
+    void evict() {
+        if (offlineDatabase.evictInBackground(evictionBudget)) {
+            evictionTimer.start(Duration::zero(), Duration::zero(), [this] { evict(); });
+        } else {
+            evicting = false;
+        }
+    }
+
     OfflineDownload& getDownload(int64_t regionID) {
         auto it = downloads.find(regionID);
         if (it != downloads.end()) {
@@ -159,18 +297,60 @@ private:
     }
 
     OfflineDatabase offlineDatabase;
+    const std::shared_ptr<ResponseCache> memoryCache;
+    const std::shared_ptr<FileSourceStatsRecorder> stats;
     OnlineFileSource onlineFileSource;
     std::unordered_map<AsyncRequest*, std::unique_ptr<AsyncRequest>> tasks;
     std::unordered_map<int64_t, std::unique_ptr<OfflineDownload>> downloads;
+    util::Timer evictionTimer;
+    bool evicting = false;
+};
+
+// Reads the database through a connection of its own, for requests that would otherwise wait
+// for the writes and eviction on the file source thread. Access times of what it reads are
+// recorded there, as the request continues.
+class DefaultFileSource::Reader {
+public:
+    Reader(const std::string& cachePath,
+           std::shared_ptr<ResponseCache> memoryCache_,
+           std::shared_ptr<FileSourceStatsRecorder> stats_)
+        : memoryCache(std::move(memoryCache_)),
+          stats(std::move(stats_)) {
+        try {
+            database = std::make_unique<OfflineDatabase>(cachePath, OfflineDatabase::ReadOnly());
+        } catch (...) {
+            // Requests are still answered from the memory cache, and then online.
+            Log::Error(Event::Database, "Unable to open the database for reading: %s",
+                       util::toString(std::current_exception()).c_str());
+        }
+    }
+
+    void get(const Resource& resource, std::function<void (optional<Response>, bool fromDatabase)> callback) {
+        auto result = lookUp(*memoryCache, *stats, database.get(), resource);
+        callback(std::move(result.first), result.second);
+    }
+
+    void close() {
+        database.reset();
+    }
+
+private:
+    std::unique_ptr<OfflineDatabase> database;
+    const std::shared_ptr<ResponseCache> memoryCache;
+    const std::shared_ptr<FileSourceStatsRecorder> stats;
 };
 
-DefaultFileSource::DefaultFileSource(const std::string& cachePath,
+DefaultFileSource::DefaultFileSource(const std::string& cachePath_,
                                      const std::string& assetRoot,
                                      uint64_t maximumCacheSize)
-    : thread(std::make_unique<util::Thread<Impl>>(util::ThreadContext{"DefaultFileSource", util::ThreadPriority::Low},
-            cachePath, maximumCacheSize)),
+    : cachePath(cachePath_),
+      memoryCache(std::make_shared<ResponseCache>(util::DEFAULT_MAX_MEMORY_CACHE_SIZE)),
+      stats(std::make_shared<FileSourceStatsRecorder>()),
+      thread(std::make_unique<util::Thread<Impl>>(util::ThreadContext{"DefaultFileSource", util::ThreadPriority::Low},
+            cachePath_, maximumCacheSize, memoryCache, stats)),
       assetFileSource(std::make_unique<AssetFileSource>(assetRoot)),
-      localFileSource(std::make_unique<LocalFileSource>()) {
+      localFileSource(std::make_unique<LocalFileSource>()),
+      mbtilesFileSource(std::make_unique<MBTilesFileSource>()) {
 }
 
 DefaultFileSource::~DefaultFileSource() = default;
@@ -202,12 +382,84 @@ void DefaultFileSource::setResourceTransform(std::function<std::string(Resource:
     });
 }
 
+void DefaultFileSource::setMaximumMemoryCacheSize(uint64_t size) {
+    memoryCache->setMaximumSize(size);
+}
+
+DefaultFileSource::MemoryCacheStats DefaultFileSource::getMemoryCacheStats() const {
+    const auto stats = memoryCache->getStats();
+    MemoryCacheStats result;
+    result.hits = stats.hits;
+    result.misses = stats.misses;
+    result.size = memoryCache->getSize();
+    return result;
+}
+
+FileSourceStats DefaultFileSource::getStats() const {
+    return stats->snapshot();
+}
+
+std::size_t DefaultFileSource::purgeMemoryCache() {
+    const std::size_t size = memoryCache->getSize();
+    memoryCache->clear();
+    return size;
+}
+
+std::size_t DefaultFileSource::getMemoryCacheSize() const {
+    return memoryCache->getSize();
+}
+
+void DefaultFileSource::setWriteAheadLogging(bool enabled) {
+    // Requests the readers have yet to answer are answered first; leaving write-ahead logging
+    // then waits for nothing but the file source thread.
+    for (auto& reader : readers) {
+        if (paused) {
+            reader->resume();
+        }
+        reader->invokeSync(&Reader::close);
+    }
+    readers.clear();
+
+    thread->invoke(&Impl::setWriteAheadLogging, enabled);
+
+    // Each connection to an in-memory database has a database of its own.
+    if (enabled && cachePath != ":memory:") {
+        for (std::size_t i = 0; i < databaseReaders; ++i) {
+            readers.push_back(std::make_unique<util::Thread<Reader>>(
+                util::ThreadContext{"DefaultFileSource reader", util::ThreadPriority::Low},
+                cachePath, memoryCache, stats));
+            if (paused) {
+                readers.back()->pause();
+            }
+        }
+    }
+}
+
 std::unique_ptr<AsyncRequest> DefaultFileSource::request(const Resource& resource, Callback callback) {
     class DefaultFileRequest : public AsyncRequest {
     public:
-        DefaultFileRequest(Resource resource_, FileSource::Callback callback_, util::Thread<DefaultFileSource::Impl>& thread_)
-            : thread(thread_),
-              workRequest(thread.invokeWithCallback(&DefaultFileSource::Impl::request, this, resource_, callback_)) {
+        DefaultFileRequest(Resource resource_, FileSource::Callback callback_,
+                           util::Thread<DefaultFileSource::Impl>& thread_,
+                           util::Thread<DefaultFileSource::Reader>* reader)
+            : thread(thread_) {
+            if (!reader || !readsCache(resource_)) {
+                workRequest = thread.invokeWithCallback(&DefaultFileSource::Impl::request, this, resource_, callback_);
+                return;
+            }
+
+            readRequest = reader->invokeWithCallback(&DefaultFileSource::Reader::get, resource_,
+                [this, resource_, callback_] (optional<Response> cached, bool fromDatabase) {
+                    if (fromDatabase || resource_.necessity == Resource::Required) {
+                        workRequest = thread.invokeWithCallback(&DefaultFileSource::Impl::revalidate,
+                            this, resource_, cached, fromDatabase, callback_);
+                    }
+
+                    // Last, since the callback may cancel the request.
+                    auto response = cachedResponse(resource_, std::move(cached));
+                    if (response) {
+                        callback_(*response);
+                    }
+                });
         }
 
         ~DefaultFileRequest() override {
@@ -215,18 +467,49 @@ std::unique_ptr<AsyncRequest> DefaultFileSource::request(const Resource& resourc
         }
 
         util::Thread<DefaultFileSource::Impl>& thread;
+        std::unique_ptr<AsyncRequest> readRequest;
         std::unique_ptr<AsyncRequest> workRequest;
     };
 
+    stats->record(resource.kind, [] (auto& counters) { counters.requests++; });
+
+#if MBGL_TRACING
+    // From the request to its first response, on the requesting thread.
+    if (util::trace::isRecording()) {
+        const uint64_t traceID = util::trace::nextID();
+        MBGL_TRACE_ASYNC_BEGIN("file source", resource.url, traceID);
+        auto responded = std::make_shared<bool>(false);
+        callback = [callback, traceID, url = resource.url, responded] (Response response) {
+            if (!*responded) {
+                *responded = true;
+                MBGL_TRACE_ASYNC_END("file source", url, traceID);
+            }
+            callback(std::move(response));
+        };
+    }
+#endif
+
     if (isAssetURL(resource.url)) {
         return assetFileSource->request(resource, callback);
     } else if (LocalFileSource::acceptsURL(resource.url)) {
         return localFileSource->request(resource, callback);
+    } else if (MBTilesFileSource::acceptsURL(resource.url)) {
+        return mbtilesFileSource->request(resource, callback);
     } else {
-        return std::make_unique<DefaultFileRequest>(resource, callback, *thread);
+        util::Thread<Reader>* reader = nullptr;
+        if (!readers.empty()) {
+            reader = readers[nextReader++ % readers.size()].get();
+        }
+        return std::make_unique<DefaultFileRequest>(resource, callback, *thread, reader);
     }
 }
 
+void DefaultFileSource::setPriority(AsyncRequest& req, Resource::Priority priority) {
+    // Asset, local and MBTiles requests are never in the request map of the file source thread,
+    // which only compares the address.
+    thread->invoke(&Impl::setPriority, &req, priority);
+}
+
 void DefaultFileSource::listOfflineRegions(std::function<void (std::exception_ptr, optional<std::vector<OfflineRegion>>)> callback) {
     thread->invoke(&Impl::listRegions, callback);
 }
@@ -247,6 +530,16 @@ void DefaultFileSource::deleteOfflineRegion(OfflineRegion&& region, std::functio
     thread->invoke(&Impl::deleteRegion, std::move(region), callback);
 }
 
+void DefaultFileSource::exportOfflineRegion(OfflineRegion& region, const std::string& path,
+                                            std::function<void (std::exception_ptr)> callback) const {
+    thread->invoke(&Impl::exportRegion, region.getID(), path, callback);
+}
+
+void DefaultFileSource::importOfflineRegions(const std::string& path,
+                                             std::function<void (std::exception_ptr, optional<std::vector<OfflineRegion>>)> callback) {
+    thread->invoke(&Impl::importRegions, path, callback);
+}
+
 void DefaultFileSource::setOfflineRegionObserver(OfflineRegion& region, std::unique_ptr<OfflineRegionObserver> observer) {
     thread->invoke(&Impl::setRegionObserver, region.getID(), std::move(observer));
 }
@@ -255,6 +548,14 @@ void DefaultFileSource::setOfflineRegionDownloadState(OfflineRegion& region, Off
     thread->invoke(&Impl::setRegionDownloadState, region.getID(), state);
 }
 
+void DefaultFileSource::refreshOfflineRegion(OfflineRegion& region) {
+    thread->invoke(&Impl::refreshRegion, region.getID());
+}
+
+void DefaultFileSource::addOfflineRegionGlyphRange(OfflineRegion& region, Range<char16_t> codepoints) {
+    thread->invoke(&Impl::addRegionGlyphRange, region.getID(), codepoints);
+}
+
 void DefaultFileSource::getOfflineRegionStatus(OfflineRegion& region, std::function<void (std::exception_ptr, optional<OfflineRegionStatus>)> callback) const {
     thread->invoke(&Impl::getRegionStatus, region.getID(), callback);
 }
@@ -265,10 +566,18 @@ void DefaultFileSource::setOfflineMapboxTileCountLimit(uint64_t limit) const {
 
 void DefaultFileSource::pause() {
     thread->pause();
+    for (auto& reader : readers) {
+        reader->pause();
+    }
+    paused = true;
 }
 
 void DefaultFileSource::resume() {
     thread->resume();
+    for (auto& reader : readers) {
+        reader->resume();
+    }
+    paused = false;
 }
 
 // For testing only:
@@ -4,23 +4,24 @@
 
 namespace mbgl {
 
+// Decoders write into the given image, and only allocate a new one if it has another size.
 #if !defined(__ANDROID__) && !defined(__APPLE__)
-PremultipliedImage decodeWebP(const uint8_t*, size_t);
+void decodeUnassociatedWebP(const uint8_t*, size_t, Size minimumSize, UnassociatedImage&);
 #endif // !defined(__ANDROID__) && !defined(__APPLE__)
+void decodeUnassociatedPNG(const uint8_t*, size_t, UnassociatedImage&);
+void decodeJPEG(const uint8_t*, size_t, Size minimumSize, PremultipliedImage&);
 
-PremultipliedImage decodePNG(const uint8_t*, size_t);
-PremultipliedImage decodeJPEG(const uint8_t*, size_t);
+namespace {
 
-PremultipliedImage decodeImage(const std::string& string) {
-    const uint8_t* data = reinterpret_cast<const uint8_t*>(string.data());
-    const size_t size = string.size();
+enum class ImageType { WebP, PNG, JPEG };
 
+ImageType imageType(const uint8_t* data, const size_t size) {
 #if !defined(__ANDROID__) && !defined(__APPLE__)
     if (size >= 12) {
         uint32_t riff_magic = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
         uint32_t webp_magic = (data[8] << 24) | (data[9] << 16) | (data[10] << 8) | data[11];
         if (riff_magic == 0x52494646 && webp_magic == 0x57454250) {
-            return decodeWebP(data, size);
+            return ImageType::WebP;
         }
     }
 #endif // !defined(__ANDROID__) && !defined(__APPLE__)
@@ -28,18 +29,76 @@ PremultipliedImage decodeImage(const std::string& string) {
     if (size >= 4) {
         uint32_t magic = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
         if (magic == 0x89504E47U) {
-            return decodePNG(data, size);
+            return ImageType::PNG;
         }
     }
 
     if (size >= 2) {
         uint16_t magic = ((data[0] << 8) | data[1]) & 0xffff;
         if (magic == 0xFFD8) {
-            return decodeJPEG(data, size);
+            return ImageType::JPEG;
         }
     }
 
     throw std::runtime_error("unsupported image type");
 }
 
+} // namespace
+
+void decodeImage(const std::string& string, PremultipliedImage& image) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(string.data());
+    const size_t size = string.size();
+
+    switch (imageType(data, size)) {
+#if !defined(__ANDROID__) && !defined(__APPLE__)
+    case ImageType::WebP: {
+        UnassociatedImage result(image.size, std::move(image.data));
+        decodeUnassociatedWebP(data, size, {}, result);
+        image = util::premultiply(std::move(result));
+        break;
+    }
+#endif // !defined(__ANDROID__) && !defined(__APPLE__)
+    case ImageType::PNG: {
+        UnassociatedImage result(image.size, std::move(image.data));
+        decodeUnassociatedPNG(data, size, result);
+        image = util::premultiply(std::move(result));
+        break;
+    }
+    default:
+        decodeJPEG(data, size, {}, image);
+        break;
+    }
+}
+
+PremultipliedImage decodeImage(const std::string& string) {
+    PremultipliedImage image;
+    decodeImage(string, image);
+    return image;
+}
+
+UnassociatedImage decodeUnassociatedImage(const std::string& string, Size minimumSize) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(string.data());
+    const size_t size = string.size();
+
+    UnassociatedImage image;
+    switch (imageType(data, size)) {
+#if !defined(__ANDROID__) && !defined(__APPLE__)
+    case ImageType::WebP:
+        decodeUnassociatedWebP(data, size, minimumSize, image);
+        break;
+#endif // !defined(__ANDROID__) && !defined(__APPLE__)
+    case ImageType::PNG:
+        decodeUnassociatedPNG(data, size, image);
+        break;
+    default: {
+        // JPEGs are opaque, the same with either alpha.
+        PremultipliedImage opaque;
+        decodeJPEG(data, size, minimumSize, opaque);
+        image = UnassociatedImage(opaque.size, std::move(opaque.data));
+        break;
+    }
+    }
+    return image;
+}
+
 } // namespace mbgl
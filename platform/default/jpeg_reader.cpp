@@ -89,7 +89,7 @@ struct jpeg_info_guard {
     jpeg_decompress_struct* i_;
 };
 
-PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
+void decodeJPEG(const uint8_t* data, size_t size, Size minimumSize, PremultipliedImage& image) {
     util::CharArrayBuffer dataBuffer { reinterpret_cast<const char*>(data), size };
     std::istream stream(&dataBuffer);
 
@@ -106,6 +106,15 @@ PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
     if (ret != JPEG_HEADER_OK)
         throw std::runtime_error("JPEG Reader: failed to read header");
 
+    // The DCT scales the image down by up to eight while decoding it.
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = 1;
+    while (minimumSize && cinfo.scale_denom < 8 &&
+           (cinfo.image_width + 2 * cinfo.scale_denom - 1) / (2 * cinfo.scale_denom) >= minimumSize.width &&
+           (cinfo.image_height + 2 * cinfo.scale_denom - 1) / (2 * cinfo.scale_denom) >= minimumSize.height) {
+        cinfo.scale_denom *= 2;
+    }
+
     jpeg_start_decompress(&cinfo);
 
     if (cinfo.out_color_space == JCS_UNKNOWN)
@@ -119,7 +128,10 @@ PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
     size_t components = cinfo.output_components;
     size_t rowStride = components * width;
 
-    PremultipliedImage image({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
+    const Size imageSize { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+    if (image.size != imageSize || !image.data) {
+        image = PremultipliedImage(imageSize);
+    }
     uint8_t* dst = image.data.get();
 
     JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr) &cinfo, JPOOL_IMAGE, rowStride, 1);
@@ -144,7 +156,11 @@ PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
     }
 
     jpeg_finish_decompress(&cinfo);
+}
 
+PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
+    PremultipliedImage image;
+    decodeJPEG(data, size, {}, image);
     return image;
 }
 
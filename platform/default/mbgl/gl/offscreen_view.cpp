@@ -4,8 +4,11 @@
 #include <mbgl/gl/renderbuffer.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 #include <cassert>
+#include <deque>
 
 namespace mbgl {
 
@@ -17,6 +20,7 @@ public:
 
     void bind() {
         if (!framebuffer) {
+            gl::ResourceOwnerScope owner { context, GLResourceStats::Owner::Offscreen };
             color = context.createRenderbuffer<gl::RenderbufferType::RGBA>(size);
             depthStencil = context.createRenderbuffer<gl::RenderbufferType::DepthStencil>(size);
             framebuffer = context.createFramebuffer(*color, *depthStencil);
@@ -27,20 +31,70 @@ public:
         context.viewport = { 0, 0, size };
     }
 
+#if not MBGL_USE_GLES2
+    void startReadStillImage() {
+        if (!pixelBuffers[0]) {
+            pixelBuffers[0] = context.createPixelBuffer();
+            pixelBuffers[1] = context.createPixelBuffer();
+        }
+
+        // With two reads pending already, the oldest one is overwritten.
+        context.startReadFramebuffer(pixelBuffers[next]->get(), size);
+        next = (next + 1) % pixelBuffers.size();
+        pending = std::min<std::size_t>(pending + 1, pixelBuffers.size());
+    }
+
+    PremultipliedImage readStillImage() {
+        if (!pending) {
+            return context.readFramebuffer<PremultipliedImage>(size);
+        }
+
+        const std::size_t oldest = (next + pixelBuffers.size() - pending) % pixelBuffers.size();
+        pending--;
+        return context.readPixelBuffer<PremultipliedImage>(pixelBuffers[oldest]->get(), size);
+    }
+#else
+    // OpenGL ES 2 has no pixel buffer objects; reads are synchronous.
+    void startReadStillImage() {
+        pendingImages.push_back(context.readFramebuffer<PremultipliedImage>(size));
+        if (pendingImages.size() > 2) {
+            pendingImages.pop_front();
+        }
+    }
+
     PremultipliedImage readStillImage() {
-        return context.readFramebuffer<PremultipliedImage>(size);
+        if (pendingImages.empty()) {
+            return context.readFramebuffer<PremultipliedImage>(size);
+        }
+
+        auto image = std::move(pendingImages.front());
+        pendingImages.pop_front();
+        return image;
     }
+#endif // MBGL_USE_GLES2
 
     const Size& getSize() const {
         return size;
     }
 
+    uint32_t getBufferAge() const {
+        return framebuffer ? 1 : 0;
+    }
+
 private:
     gl::Context& context;
     const Size size;
     optional<gl::Framebuffer> framebuffer;
     optional<gl::Renderbuffer<gl::RenderbufferType::RGBA>> color;
     optional<gl::Renderbuffer<gl::RenderbufferType::DepthStencil>> depthStencil;
+
+#if not MBGL_USE_GLES2
+    std::array<optional<gl::UniqueBuffer>, 2> pixelBuffers;
+    std::size_t next = 0;
+    std::size_t pending = 0;
+#else
+    std::deque<PremultipliedImage> pendingImages;
+#endif // MBGL_USE_GLES2
 };
 
 OffscreenView::OffscreenView(gl::Context& context, const Size size)
@@ -53,6 +107,10 @@ void OffscreenView::bind() {
     impl->bind();
 }
 
+void OffscreenView::startReadStillImage() {
+    impl->startReadStillImage();
+}
+
 PremultipliedImage OffscreenView::readStillImage() {
     return impl->readStillImage();
 }
@@ -61,4 +119,8 @@ const Size& OffscreenView::getSize() const {
     return impl->getSize();
 }
 
+uint32_t OffscreenView::getBufferAge() const {
+    return impl->getBufferAge();
+}
+
 } // namespace mbgl
@@ -16,6 +16,16 @@ public:
 
     void bind() override;
 
+    // The framebuffer keeps what was drawn into it, once it is created by the first bind.
+    uint32_t getBufferAge() const override;
+
+    // Starts reading the rendered image, without waiting for the GPU to finish rendering it.
+    // Up to two reads can be pending at once, so that the next image can be rendered while
+    // the previous one is still being read.
+    void startReadStillImage();
+
+    // Returns the oldest pending image, waiting for it if necessary, or reads the rendered
+    // image right away if there is none.
     PremultipliedImage readStillImage();
 
     const Size& getSize() const;
@@ -11,19 +11,21 @@
 namespace mbgl {
 
 OfflineTilePyramidRegionDefinition::OfflineTilePyramidRegionDefinition(
-    std::string styleURL_, LatLngBounds bounds_, double minZoom_, double maxZoom_, float pixelRatio_)
+    std::string styleURL_, LatLngBounds bounds_, double minZoom_, double maxZoom_, float pixelRatio_,
+    OfflineRegionGlyphs glyphs_)
     : styleURL(std::move(styleURL_)),
       bounds(std::move(bounds_)),
       minZoom(minZoom_),
       maxZoom(maxZoom_),
-      pixelRatio(pixelRatio_) {
+      pixelRatio(pixelRatio_),
+      glyphs(glyphs_) {
     if (minZoom < 0 || maxZoom < 0 || maxZoom < minZoom || pixelRatio < 0 ||
         !std::isfinite(minZoom) || std::isnan(maxZoom) || !std::isfinite(pixelRatio)) {
         throw std::invalid_argument("Invalid offline region definition");
     }
 }
 
-std::vector<CanonicalTileID> OfflineTilePyramidRegionDefinition::tileCover(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
+Range<uint8_t> OfflineTilePyramidRegionDefinition::coveringZoomRange(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
     double minZ = std::max<double>(util::coveringZoomLevel(minZoom, type, tileSize), zoomRange.min);
     double maxZ = std::min<double>(util::coveringZoomLevel(maxZoom, type, tileSize), zoomRange.max);
 
@@ -32,9 +34,15 @@ std::vector<CanonicalTileID> OfflineTilePyramidRegionDefinition::tileCover(Sourc
     assert(minZ < std::numeric_limits<uint8_t>::max());
     assert(maxZ < std::numeric_limits<uint8_t>::max());
 
+    return { uint8_t(minZ), uint8_t(maxZ) };
+}
+
+std::vector<CanonicalTileID> OfflineTilePyramidRegionDefinition::tileCover(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
+    const Range<uint8_t> zooms = coveringZoomRange(type, tileSize, zoomRange);
+
     std::vector<CanonicalTileID> result;
 
-    for (uint8_t z = minZ; z <= maxZ; z++) {
+    for (uint8_t z = zooms.min; z <= zooms.max; z++) {
         for (const auto& tile : util::tileCover(bounds, z)) {
             result.emplace_back(tile.canonical);
         }
@@ -43,6 +51,16 @@ std::vector<CanonicalTileID> OfflineTilePyramidRegionDefinition::tileCover(Sourc
     return result;
 }
 
+uint64_t OfflineTilePyramidRegionDefinition::tileCount(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
+    const Range<uint8_t> zooms = coveringZoomRange(type, tileSize, zoomRange);
+
+    uint64_t result = 0;
+    for (uint8_t z = zooms.min; z <= zooms.max; z++) {
+        result += util::tileCount(bounds, z);
+    }
+    return result;
+}
+
 OfflineRegionDefinition decodeOfflineRegionDefinition(const std::string& region) {
     rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> doc;
     doc.Parse<0>(region.c_str());
@@ -54,7 +72,8 @@ OfflineRegionDefinition decodeOfflineRegionDefinition(const std::string& region)
           !doc["bounds"][2].IsDouble() || !doc["bounds"][3].IsDouble() ||
         !doc.HasMember("min_zoom") || !doc["min_zoom"].IsDouble() ||
         (doc.HasMember("max_zoom") && !doc["max_zoom"].IsDouble()) ||
-        !doc.HasMember("pixel_ratio") || !doc["pixel_ratio"].IsDouble()) {
+        !doc.HasMember("pixel_ratio") || !doc["pixel_ratio"].IsDouble() ||
+        (doc.HasMember("glyphs") && !doc["glyphs"].IsString())) {
         throw std::runtime_error("Malformed offline region definition");
     }
 
@@ -65,8 +84,10 @@ OfflineRegionDefinition decodeOfflineRegionDefinition(const std::string& region)
     double minZoom = doc["min_zoom"].GetDouble();
     double maxZoom = doc.HasMember("max_zoom") ? doc["max_zoom"].GetDouble() : INFINITY;
     float pixelRatio = doc["pixel_ratio"].GetDouble();
+    OfflineRegionGlyphs glyphs = doc.HasMember("glyphs") && doc["glyphs"] == "used"
+        ? OfflineRegionGlyphs::Used : OfflineRegionGlyphs::All;
 
-    return { styleURL, bounds, minZoom, maxZoom, pixelRatio };
+    return { styleURL, bounds, minZoom, maxZoom, pixelRatio, glyphs };
 }
 
 std::string encodeOfflineRegionDefinition(const OfflineRegionDefinition& region) {
@@ -89,6 +110,11 @@ std::string encodeOfflineRegionDefinition(const OfflineRegionDefinition& region)
 
     doc.AddMember("pixel_ratio", region.pixelRatio, doc.GetAllocator());
 
+    // Omitted when all glyph ranges are included, as in definitions written before the option.
+    if (region.glyphs == OfflineRegionGlyphs::Used) {
+        doc.AddMember("glyphs", "used", doc.GetAllocator());
+    }
+
     rapidjson::StringBuffer buffer;
     rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
     doc.Accept(writer);
@@ -8,8 +8,117 @@
 
 #include "sqlite3.hpp"
 
+#include <algorithm>
+
 namespace mbgl {
 
+namespace {
+
+// Access times recorded for longer, or for more resources, are written on the next operation.
+constexpr Seconds accessTimeWriteInterval = Seconds(60);
+constexpr std::size_t maximumUnwrittenAccessTimes = 1024;
+
+// A put evicts the least recently used resources when there's no room left. Before that, the
+// cache is evicted in the background, from the high water mark down to the low water mark,
+// in larger batches.
+constexpr uint32_t inlineEvictionBatchSize = 50;
+constexpr uint32_t backgroundEvictionBatchSize = 500;
+constexpr double evictionHighWaterMark = 0.9;
+constexpr double evictionLowWaterMark = 0.75;
+constexpr uint32_t vacuumBatchPages = 256;
+
+// Rows of an imported database are copied in transactions of this many, at most, so that
+// requests waiting for the database are served in between.
+constexpr int64_t importBatchRows = 1000;
+
+// Attaches another database, as `other`, for the lifetime of the object.
+class Attachment {
+public:
+    Attachment(mapbox::sqlite::Database& db_, const std::string& path)
+        : db(db_) {
+        mapbox::sqlite::Statement stmt = db.prepare("ATTACH DATABASE ?1 AS other");
+        stmt.bind(1, path);
+        stmt.run();
+    }
+
+    ~Attachment() {
+        try {
+            db.exec("DETACH DATABASE other");
+        } catch (mapbox::sqlite::Exception& ex) {
+            Log::Error(Event::Database, ex.code, ex.what());
+        }
+    }
+
+private:
+    mapbox::sqlite::Database& db;
+};
+
+// Values of the `compressed` column. Rows written before the dictionary was added are either
+// uncompressed or deflated without one.
+enum Compression : int {
+    Uncompressed = 0,
+    Deflate = 1,
+    DeflateWithTileDictionary = 2,
+};
+
+// Formats that deflate doesn't shrink any further: JPEG, WebP and gzip. PNGs, sprites in
+// particular, are often written with little compression.
+bool isCompressed(const std::string& data) {
+    return data.compare(0, 2, "\377\330") == 0 ||
+           data.compare(0, 4, "RIFF") == 0 ||
+           data.compare(0, 2, "\037\213") == 0;
+}
+
+// Uncompressed data is moved rather than copied.
+std::string decompress(std::string&& data, int compression) {
+    switch (compression) {
+    case Uncompressed:
+        return std::move(data);
+    case DeflateWithTileDictionary:
+        return util::decompress(data, OfflineDatabase::tileDictionary());
+    default:
+        return util::decompress(data);
+    }
+}
+
+} // namespace
+
+const std::string& OfflineDatabase::tileDictionary() {
+    return util::tileDictionary();
+}
+
+uint64_t OfflineRegionTiles::key(int32_t x, int32_t y, uint8_t z) {
+    return uint64_t(z) << 58 | uint64_t(uint32_t(x)) << 29 | uint32_t(y);
+}
+
+optional<uint64_t> OfflineRegionTiles::find(const Resource::TileData& tile) const {
+    auto it = tiles.find({ tile.urlTemplate, tile.pixelRatio });
+    if (it == tiles.end()) {
+        return {};
+    }
+
+    const uint64_t k = key(tile.x, tile.y, tile.z);
+    auto found = std::lower_bound(it->second.begin(), it->second.end(), std::make_pair(k, uint64_t(0)));
+    if (found == it->second.end() || found->first != k) {
+        return {};
+    }
+    return found->second;
+}
+
+bool OfflineRegionTiles::isExpired(const Resource::TileData& tile) const {
+    auto it = expiredTiles.find({ tile.urlTemplate, tile.pixelRatio });
+    return it != expiredTiles.end() &&
+        std::binary_search(it->second.begin(), it->second.end(), key(tile.x, tile.y, tile.z));
+}
+
+std::size_t OfflineRegionTiles::size() const {
+    std::size_t result = 0;
+    for (const auto& entry : tiles) {
+        result += entry.second.size();
+    }
+    return result;
+}
+
 OfflineDatabase::Statement::~Statement() {
     stmt.reset();
     stmt.clearBindings();
@@ -21,11 +130,23 @@ OfflineDatabase::OfflineDatabase(std::string path_, uint64_t maximumCacheSize_)
     ensureSchema();
 }
 
+OfflineDatabase::OfflineDatabase(std::string path_, ReadOnly)
+    : path(std::move(path_)),
+      maximumCacheSize(0),
+      readOnly(true) {
+    connect(mapbox::sqlite::ReadOnly);
+}
+
 OfflineDatabase::~OfflineDatabase() {
     // Deleting these SQLite objects may result in exceptions, but we're in a destructor, so we
     // can't throw anything.
     try {
+        writeAccessTimes();
         statements.clear();
+        if (writeAheadLogging) {
+            // Leaves an empty log behind, rather than one as large as the last checkpoint left it.
+            db->exec("PRAGMA wal_checkpoint(TRUNCATE)");
+        }
         db.reset();
     } catch (mapbox::sqlite::Exception& ex) {
         Log::Error(Event::Database, ex.code, ex.what());
@@ -126,6 +247,32 @@ void OfflineDatabase::migrateToVersion5() {
     db->exec("PRAGMA user_version = 5");
 }
 
+void OfflineDatabase::setWriteAheadLogging(bool enabled) {
+    if (enabled == writeAheadLogging) {
+        return;
+    }
+
+    // The journal mode is stored in the database, and leaving WAL mode checkpoints the log.
+    if (enabled) {
+        db->exec("PRAGMA journal_mode = WAL");
+        db->exec("PRAGMA synchronous = NORMAL");
+    } else {
+        db->exec("PRAGMA journal_mode = DELETE");
+        db->exec("PRAGMA synchronous = FULL");
+    }
+
+    writeAheadLogging = enabled;
+    syncingEachWrite = !enabled;
+}
+
+void OfflineDatabase::syncEachWrite(bool sync) {
+    // Without write-ahead logging, every write is synced anyway.
+    if (writeAheadLogging && sync != syncingEachWrite) {
+        db->exec(sync ? "PRAGMA synchronous = FULL" : "PRAGMA synchronous = NORMAL");
+        syncingEachWrite = sync;
+    }
+}
+
 OfflineDatabase::Statement OfflineDatabase::getStatement(const char * sql) {
     auto it = statements.find(sql);
 
@@ -138,18 +285,104 @@ OfflineDatabase::Statement OfflineDatabase::getStatement(const char * sql) {
 
 optional<Response> OfflineDatabase::get(const Resource& resource) {
     auto result = getInternal(resource);
-    return result ? result->first : optional<Response>();
+    return result ? std::move(result->first) : optional<Response>();
+}
+
+optional<Response> OfflineDatabase::getCompressed(const Resource& resource) {
+    auto result = getInternal(resource, false);
+    return result ? std::move(result->first) : optional<Response>();
 }
 
-optional<std::pair<Response, uint64_t>> OfflineDatabase::getInternal(const Resource& resource) {
+optional<std::pair<Response, uint64_t>> OfflineDatabase::getInternal(const Resource& resource, bool inflate) {
+    optional<std::pair<Response, uint64_t>> result;
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
-        return getTile(*resource.tileData);
+        result = getTile(*resource.tileData, inflate);
+    } else {
+        result = getResource(resource);
+    }
+
+    if (result && !readOnly) {
+        recordAccess(resource);
+    }
+    return result;
+}
+
+void OfflineDatabase::recordAccess(const Resource& resource) {
+    const Timestamp now = util::now();
+    const Timestamp accessed { std::chrono::duration_cast<std::chrono::minutes>(now.time_since_epoch()) };
+
+    if (resource.kind == Resource::Kind::Tile) {
+        const Resource::TileData& tile = *resource.tileData;
+        tileAccessTimes[TileKey { tile.urlTemplate, tile.pixelRatio, tile.x, tile.y, tile.z }] = accessed;
     } else {
-        return getResource(resource);
+        resourceAccessTimes[resource.url] = accessed;
+    }
+
+    if (!firstUnwrittenAccess) {
+        firstUnwrittenAccess = now;
+    }
+
+    writeAccessTimesIfDue();
+}
+
+void OfflineDatabase::writeAccessTimesIfDue() {
+    if (resourceAccessTimes.size() + tileAccessTimes.size() >= maximumUnwrittenAccessTimes ||
+        (firstUnwrittenAccess && util::now() - *firstUnwrittenAccess >= accessTimeWriteInterval)) {
+        writeAccessTimes();
     }
 }
 
+void OfflineDatabase::writeAccessTimes() {
+    // A batch of puts writes them afterwards.
+    if (!firstUnwrittenAccess || inTransaction) {
+        return;
+    }
+
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+
+    // A put since the access may have recorded a later time, to the second.
+    // clang-format off
+    Statement resourceStmt = getStatement(
+        "UPDATE resources SET accessed = max(accessed, ?1) WHERE url = ?2");
+    // clang-format on
+
+    for (const auto& access : resourceAccessTimes) {
+        resourceStmt->bind(1, access.second);
+        resourceStmt->bind(2, access.first);
+        resourceStmt->run();
+        resourceStmt->reset();
+    }
+
+    // clang-format off
+    Statement tileStmt = getStatement(
+        "UPDATE tiles "
+        "SET accessed       = max(accessed, ?1) "
+        "WHERE url_template = ?2 "
+        "  AND pixel_ratio  = ?3 "
+        "  AND x            = ?4 "
+        "  AND y            = ?5 "
+        "  AND z            = ?6 ");
+    // clang-format on
+
+    for (const auto& access : tileAccessTimes) {
+        tileStmt->bind(1, access.second);
+        tileStmt->bind(2, std::get<0>(access.first));
+        tileStmt->bind(3, std::get<1>(access.first));
+        tileStmt->bind(4, std::get<2>(access.first));
+        tileStmt->bind(5, std::get<3>(access.first));
+        tileStmt->bind(6, std::get<4>(access.first));
+        tileStmt->run();
+        tileStmt->reset();
+    }
+
+    transaction.commit();
+
+    resourceAccessTimes.clear();
+    tileAccessTimes.clear();
+    firstUnwrittenAccess = {};
+}
+
 optional<int64_t> OfflineDatabase::hasInternal(const Resource& resource) {
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
@@ -160,6 +393,7 @@ optional<int64_t> OfflineDatabase::hasInternal(const Resource& resource) {
 }
 
 std::pair<bool, uint64_t> OfflineDatabase::put(const Resource& resource, const Response& response) {
+    syncEachWrite(false);
     return putInternal(resource, response, true);
 }
 
@@ -169,13 +403,18 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
     }
 
     std::string compressedData;
-    bool compressed = false;
+    int compression = Uncompressed;
     uint64_t size = 0;
 
     if (response.data) {
-        compressedData = util::compress(*response.data);
-        compressed = compressedData.size() < response.data->size();
-        size = compressed ? compressedData.size() : response.data->size();
+        const bool tile = resource.kind == Resource::Kind::Tile;
+        if (!isCompressed(*response.data)) {
+            compressedData = util::compress(*response.data, tile ? tileDictionary() : std::string());
+        }
+        if (!compressedData.empty() && compressedData.size() < response.data->size()) {
+            compression = tile ? DeflateWithTileDictionary : Deflate;
+        }
+        size = compression != Uncompressed ? compressedData.size() : response.data->size();
     }
 
     if (evict_ && !evict(size)) {
@@ -188,27 +427,18 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
         inserted = putTile(*resource.tileData, response,
-                compressed ? compressedData : *response.data,
-                compressed);
+                compression != Uncompressed ? compressedData : *response.data,
+                compression);
     } else {
         inserted = putResource(resource, response,
-                compressed ? compressedData : *response.data,
-                compressed);
+                compression != Uncompressed ? compressedData : *response.data,
+                compression);
     }
 
     return { inserted, size };
 }
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
-    // clang-format off
-    Statement accessedStmt = getStatement(
-        "UPDATE resources SET accessed = ?1 WHERE url = ?2");
-    // clang-format on
-
-    accessedStmt->bind(1, util::now());
-    accessedStmt->bind(2, resource.url);
-    accessedStmt->run();
-
     // clang-format off
     Statement stmt = getStatement(
         //        0      1        2       3        4
@@ -233,12 +463,9 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
     optional<std::string> data = stmt->get<optional<std::string>>(3);
     if (!data) {
         response.noContent = true;
-    } else if (stmt->get<int>(4)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
-        size = data->length();
     } else {
-        response.data = std::make_shared<std::string>(*data);
         size = data->length();
+        response.data = std::make_shared<std::string>(decompress(std::move(*data), stmt->get<int>(4)));
     }
 
     return std::make_pair(response, size);
@@ -260,7 +487,7 @@ optional<int64_t> OfflineDatabase::hasResource(const Resource& resource) {
 bool OfflineDatabase::putResource(const Resource& resource,
                                   const Response& response,
                                   const std::string& data,
-                                  bool compressed) {
+                                  int compression) {
     if (response.notModified) {
         // clang-format off
         Statement update = getStatement(
@@ -280,8 +507,12 @@ bool OfflineDatabase::putResource(const Resource& resource,
     // We can't use REPLACE because it would change the id value.
 
     // Begin an immediate-mode transaction to ensure that two writers do not attempt
-    // to INSERT a resource at the same moment.
-    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    // to INSERT a resource at the same moment, unless this put is part of a batch,
+    // which already is in one.
+    optional<mapbox::sqlite::Transaction> transaction;
+    if (!inTransaction) {
+        transaction.emplace(*db, mapbox::sqlite::Transaction::Immediate);
+    }
 
     // clang-format off
     Statement update = getStatement(
@@ -308,12 +539,14 @@ bool OfflineDatabase::putResource(const Resource& resource,
         update->bind(7, false);
     } else {
         update->bindBlob(6, data.data(), data.size(), false);
-        update->bind(7, compressed);
+        update->bind(7, compression);
     }
 
     update->run();
     if (update->changes() != 0) {
-        transaction.commit();
+        if (transaction) {
+            transaction->commit();
+        }
         return false;
     }
 
@@ -335,35 +568,18 @@ bool OfflineDatabase::putResource(const Resource& resource,
         insert->bind(8, false);
     } else {
         insert->bindBlob(7, data.data(), data.size(), false);
-        insert->bind(8, compressed);
+        insert->bind(8, compression);
     }
 
     insert->run();
-    transaction.commit();
+    if (transaction) {
+        transaction->commit();
+    }
 
     return true;
 }
 
-optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
-    // clang-format off
-    Statement accessedStmt = getStatement(
-        "UPDATE tiles "
-        "SET accessed       = ?1 "
-        "WHERE url_template = ?2 "
-        "  AND pixel_ratio  = ?3 "
-        "  AND x            = ?4 "
-        "  AND y            = ?5 "
-        "  AND z            = ?6 ");
-    // clang-format on
-
-    accessedStmt->bind(1, util::now());
-    accessedStmt->bind(2, tile.urlTemplate);
-    accessedStmt->bind(3, tile.pixelRatio);
-    accessedStmt->bind(4, tile.x);
-    accessedStmt->bind(5, tile.y);
-    accessedStmt->bind(6, tile.z);
-    accessedStmt->run();
-
+optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile, bool inflate) {
     // clang-format off
     Statement stmt = getStatement(
         //        0      1        2       3        4
@@ -396,12 +612,17 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
     optional<std::string> data = stmt->get<optional<std::string>>(3);
     if (!data) {
         response.noContent = true;
-    } else if (stmt->get<int>(4)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
-        size = data->length();
     } else {
-        response.data = std::make_shared<std::string>(*data);
         size = data->length();
+        const int compression = stmt->get<int>(4);
+        if (inflate || compression == Uncompressed) {
+            response.data = std::make_shared<std::string>(decompress(std::move(*data), compression));
+        } else {
+            response.data = std::make_shared<std::string>(std::move(*data));
+            response.compression = compression == DeflateWithTileDictionary
+                ? util::Compression::DeflateWithTileDictionary
+                : util::Compression::Deflate;
+        }
     }
 
     return std::make_pair(response, size);
@@ -435,7 +656,7 @@ optional<int64_t> OfflineDatabase::hasTile(const Resource::TileData& tile) {
 bool OfflineDatabase::putTile(const Resource::TileData& tile,
                               const Response& response,
                               const std::string& data,
-                              bool compressed) {
+                              int compression) {
     if (response.notModified) {
         // clang-format off
         Statement update = getStatement(
@@ -463,8 +684,12 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
     // We can't use REPLACE because it would change the id value.
 
     // Begin an immediate-mode transaction to ensure that two writers do not attempt
-    // to INSERT a resource at the same moment.
-    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    // to INSERT a resource at the same moment, unless this put is part of a batch,
+    // which already is in one.
+    optional<mapbox::sqlite::Transaction> transaction;
+    if (!inTransaction) {
+        transaction.emplace(*db, mapbox::sqlite::Transaction::Immediate);
+    }
 
     // clang-format off
     Statement update = getStatement(
@@ -497,12 +722,14 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         update->bind(6, false);
     } else {
         update->bindBlob(5, data.data(), data.size(), false);
-        update->bind(6, compressed);
+        update->bind(6, compression);
     }
 
     update->run();
     if (update->changes() != 0) {
-        transaction.commit();
+        if (transaction) {
+            transaction->commit();
+        }
         return false;
     }
 
@@ -527,11 +754,13 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         insert->bind(11, false);
     } else {
         insert->bindBlob(10, data.data(), data.size(), false);
-        insert->bind(11, compressed);
+        insert->bind(11, compression);
     }
 
     insert->run();
-    transaction.commit();
+    if (transaction) {
+        transaction->commit();
+    }
 
     return true;
 }
@@ -591,13 +820,188 @@ void OfflineDatabase::deleteRegion(OfflineRegion&& region) {
     stmt->bind(1, region.getID());
     stmt->run();
 
-    evict(0);
-    db->exec("PRAGMA incremental_vacuum");
+    // The tiles and resources that only this region used are ambient now. Evicting them and
+    // vacuuming the pages its rows took can take a long time for a large region, so that is
+    // left to evictInBackground.
+    if (maintenance == Maintenance::None) {
+        maintenance = Maintenance::Vacuum;
+    }
 
     // Ensure that the cached offlineTileCount value is recalculated.
     offlineMapboxTileCount = {};
 }
 
+void OfflineDatabase::exportRegion(int64_t regionID, const std::string& exportPath) {
+    try {
+        util::deleteFile(exportPath);
+    } catch (util::IOException&) {
+    }
+
+    {
+        // Creates the schema.
+        OfflineDatabase exported(exportPath);
+    }
+
+    Attachment attachment(*db, exportPath);
+    mapbox::sqlite::Transaction transaction(*db);
+
+    // The region, its resources and tiles keep their IDs in the export, which only holds them.
+    // clang-format off
+    const char* queries[] = {
+        "INSERT INTO other.regions (id, definition, description) "
+        "SELECT id, definition, description "
+        "FROM main.regions "
+        "WHERE id = ?1 ",
+
+        "INSERT INTO other.resources (id, url, kind, expires, modified, etag, data, compressed, accessed) "
+        "SELECT id, url, kind, expires, modified, etag, data, compressed, accessed "
+        "FROM main.region_resources, main.resources "
+        "WHERE region_id = ?1 "
+        "AND resource_id = main.resources.id ",
+
+        "INSERT INTO other.region_resources (region_id, resource_id) "
+        "SELECT region_id, resource_id "
+        "FROM main.region_resources "
+        "WHERE region_id = ?1 ",
+
+        "INSERT INTO other.tiles (id, url_template, pixel_ratio, z, x, y, expires, modified, etag, data, compressed, accessed) "
+        "SELECT id, url_template, pixel_ratio, z, x, y, expires, modified, etag, data, compressed, accessed "
+        "FROM main.region_tiles, main.tiles "
+        "WHERE region_id = ?1 "
+        "AND tile_id = main.tiles.id ",
+
+        "INSERT INTO other.region_tiles (region_id, tile_id) "
+        "SELECT region_id, tile_id "
+        "FROM main.region_tiles "
+        "WHERE region_id = ?1 ",
+    };
+    // clang-format on
+
+    for (const char* query : queries) {
+        mapbox::sqlite::Statement stmt = db->prepare(query);
+        stmt.bind(1, regionID);
+        stmt.run();
+    }
+
+    transaction.commit();
+}
+
+std::vector<OfflineRegion> OfflineDatabase::importRegions(const std::string& importPath) {
+    {
+        // Opened first, so that attaching doesn't create a database where there is none.
+        mapbox::sqlite::Database other(importPath, mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement stmt = other.prepare("PRAGMA user_version");
+        stmt.run();
+        if (stmt.get<int>(0) != 5) {
+            throw std::runtime_error("not an offline database of this version");
+        }
+    }
+
+    syncEachWrite(true);
+    Attachment attachment(*db, importPath);
+
+    // Runs a query whose first two parameters bound a range of IDs over all IDs up to the
+    // result of `maxQuery`, a batch of them per transaction.
+    auto inBatches = [&] (const char* query, const char* maxQuery, const auto& bind) {
+        mapbox::sqlite::Statement maxStmt = db->prepare(maxQuery);
+        maxStmt.run();
+        const int64_t maxID = maxStmt.get<int64_t>(0);
+
+        mapbox::sqlite::Statement stmt = db->prepare(query);
+        for (int64_t first = 0; first < maxID; first += importBatchRows) {
+            mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+            stmt.bind(1, first);
+            stmt.bind(2, first + importBatchRows);
+            bind(stmt);
+            stmt.run();
+            stmt.reset();
+            transaction.commit();
+        }
+    };
+    const auto bindNothing = [] (mapbox::sqlite::Statement&) {};
+
+    // Resources and tiles that are already stored are kept as they are, with the validators
+    // they were stored with. Until they are linked to a region, the others are ambient.
+    // clang-format off
+    inBatches(
+        "INSERT OR IGNORE INTO main.resources (url, kind, expires, modified, etag, data, compressed, accessed) "
+        "SELECT url, kind, expires, modified, etag, data, compressed, accessed "
+        "FROM other.resources "
+        "WHERE id > ?1 AND id <= ?2 ",
+        "SELECT max(id) FROM other.resources", bindNothing);
+    inBatches(
+        "INSERT OR IGNORE INTO main.tiles (url_template, pixel_ratio, z, x, y, expires, modified, etag, data, compressed, accessed) "
+        "SELECT url_template, pixel_ratio, z, x, y, expires, modified, etag, data, compressed, accessed "
+        "FROM other.tiles "
+        "WHERE id > ?1 AND id <= ?2 ",
+        "SELECT max(id) FROM other.tiles", bindNothing);
+    // clang-format on
+
+    std::vector<OfflineRegion> result;
+    try {
+        mapbox::sqlite::Statement regionsStmt = db->prepare(
+            "SELECT id, definition, description FROM other.regions");
+        std::vector<std::tuple<int64_t, std::string, std::vector<uint8_t>>> regions;
+        while (regionsStmt.run()) {
+            regions.emplace_back(regionsStmt.get<int64_t>(0),
+                                 regionsStmt.get<std::string>(1),
+                                 regionsStmt.get<std::vector<uint8_t>>(2));
+        }
+
+        for (const auto& region : regions) {
+            const int64_t importedID = std::get<0>(region);
+            result.push_back(createRegion(decodeOfflineRegionDefinition(std::get<1>(region)),
+                                          std::get<2>(region)));
+            const int64_t regionID = result.back().getID();
+
+            const auto bindRegion = [&] (mapbox::sqlite::Statement& stmt) {
+                stmt.bind(3, regionID);
+                stmt.bind(4, importedID);
+            };
+
+            // Rows are matched by URL, and by tile coordinates, through the unique indexes.
+            // clang-format off
+            inBatches(
+                "INSERT OR IGNORE INTO main.region_resources (region_id, resource_id) "
+                "SELECT ?3, main.resources.id "
+                "FROM other.region_resources, other.resources, main.resources "
+                "WHERE other.region_resources.rowid > ?1 AND other.region_resources.rowid <= ?2 "
+                "AND other.region_resources.region_id = ?4 "
+                "AND other.resources.id = other.region_resources.resource_id "
+                "AND main.resources.url = other.resources.url ",
+                "SELECT max(rowid) FROM other.region_resources", bindRegion);
+            inBatches(
+                "INSERT OR IGNORE INTO main.region_tiles (region_id, tile_id) "
+                "SELECT ?3, main.tiles.id "
+                "FROM other.region_tiles, other.tiles, main.tiles "
+                "WHERE other.region_tiles.rowid > ?1 AND other.region_tiles.rowid <= ?2 "
+                "AND other.region_tiles.region_id = ?4 "
+                "AND other.tiles.id = other.region_tiles.tile_id "
+                "AND main.tiles.url_template = other.tiles.url_template "
+                "AND main.tiles.pixel_ratio = other.tiles.pixel_ratio "
+                "AND main.tiles.z = other.tiles.z "
+                "AND main.tiles.x = other.tiles.x "
+                "AND main.tiles.y = other.tiles.y ",
+                "SELECT max(rowid) FROM other.region_tiles", bindRegion);
+            // clang-format on
+        }
+
+        offlineMapboxTileCount = {};
+        if (getOfflineMapboxTileCount() > offlineMapboxTileCountLimit) {
+            throw std::runtime_error("Mapbox tile count limit exceeded");
+        }
+    } catch (...) {
+        // Regions are only imported whole. Their resources are left in the ambient cache.
+        for (auto& region : result) {
+            deleteRegion(std::move(region));
+        }
+        offlineMapboxTileCount = {};
+        throw;
+    }
+
+    return result;
+}
+
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getRegionResource(int64_t regionID, const Resource& resource) {
     auto response = getInternal(resource);
 
@@ -619,7 +1023,39 @@ optional<int64_t> OfflineDatabase::hasRegionResource(int64_t regionID, const Res
 }
 
 uint64_t OfflineDatabase::putRegionResource(int64_t regionID, const Resource& resource, const Response& response) {
+    syncEachWrite(true);
+    return putRegionResourceInternal(regionID, resource, response);
+}
+
+std::vector<uint64_t> OfflineDatabase::putRegionResources(int64_t regionID, const std::vector<std::pair<Resource, Response>>& resources) {
+    syncEachWrite(true);
+
+    std::vector<uint64_t> sizes;
+    sizes.reserve(resources.size());
+
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    inTransaction = true;
+    try {
+        for (const auto& resource : resources) {
+            sizes.push_back(putRegionResourceInternal(regionID, resource.first, resource.second));
+        }
+        inTransaction = false;
+        transaction.commit();
+    } catch (...) {
+        inTransaction = false;
+        // Counted tiles may have been rolled back.
+        offlineMapboxTileCount = {};
+        throw;
+    }
+
+    return sizes;
+}
+
+uint64_t OfflineDatabase::putRegionResourceInternal(int64_t regionID, const Resource& resource, const Response& response) {
     uint64_t size = putInternal(resource, response, false).second;
+    if (response.notModified) {
+        size = hasInternal(resource).value_or(0);
+    }
     bool previouslyUnused = markUsed(regionID, resource);
 
     if (offlineMapboxTileCount
@@ -723,6 +1159,90 @@ OfflineRegionDefinition OfflineDatabase::getRegionDefinition(int64_t regionID) {
     return decodeOfflineRegionDefinition(stmt->get<std::string>(0));
 }
 
+OfflineRegionTiles OfflineDatabase::getRegionTiles(int64_t regionID) {
+    // clang-format off
+    Statement stmt = getStatement(
+        //        0             1        2  3  4       5           6
+        "SELECT url_template, pixel_ratio, x, y, z, length(data), expires "
+        "FROM region_tiles, tiles "
+        "WHERE region_id = ?1 "
+        "AND tile_id = tiles.id "
+        // Like hasRegionResource, which finds no size for tiles without content.
+        "AND data IS NOT NULL ");
+    // clang-format on
+    stmt->bind(1, regionID);
+
+    const Timestamp now = util::now();
+
+    OfflineRegionTiles result;
+    while (stmt->run()) {
+        const std::pair<std::string, uint8_t> tileset { stmt->get<std::string>(0), uint8_t(stmt->get<int>(1)) };
+        const uint64_t key = OfflineRegionTiles::key(stmt->get<int>(2), stmt->get<int>(3), uint8_t(stmt->get<int>(4)));
+        result.tiles[tileset].emplace_back(key, stmt->get<int64_t>(5));
+
+        const optional<Timestamp> expires = stmt->get<optional<Timestamp>>(6);
+        if (expires && *expires <= now) {
+            result.expiredTiles[tileset].push_back(key);
+        }
+    }
+    for (auto& tiles : result.tiles) {
+        std::sort(tiles.second.begin(), tiles.second.end());
+    }
+    for (auto& tiles : result.expiredTiles) {
+        std::sort(tiles.second.begin(), tiles.second.end());
+    }
+    return result;
+}
+
+optional<Response> OfflineDatabase::getValidators(const Resource& resource) {
+    auto validators = [] (Statement& stmt) -> optional<Response> {
+        if (!stmt->run()) {
+            return {};
+        }
+
+        Response response;
+        response.etag     = stmt->get<optional<std::string>>(0);
+        response.expires  = stmt->get<optional<Timestamp>>(1);
+        response.modified = stmt->get<optional<Timestamp>>(2);
+        return response;
+    };
+
+    if (resource.kind == Resource::Kind::Tile) {
+        assert(resource.tileData);
+        const Resource::TileData& tile = *resource.tileData;
+
+        // clang-format off
+        Statement stmt = getStatement(
+            //        0      1        2
+            "SELECT etag, expires, modified "
+            "FROM tiles "
+            "WHERE url_template = ?1 "
+            "  AND pixel_ratio  = ?2 "
+            "  AND x            = ?3 "
+            "  AND y            = ?4 "
+            "  AND z            = ?5 ");
+        // clang-format on
+
+        stmt->bind(1, tile.urlTemplate);
+        stmt->bind(2, tile.pixelRatio);
+        stmt->bind(3, tile.x);
+        stmt->bind(4, tile.y);
+        stmt->bind(5, tile.z);
+        return validators(stmt);
+    }
+
+    // clang-format off
+    Statement stmt = getStatement(
+        //        0      1        2
+        "SELECT etag, expires, modified "
+        "FROM resources "
+        "WHERE url = ?1 ");
+    // clang-format on
+
+    stmt->bind(1, resource.url);
+    return validators(stmt);
+}
+
 OfflineRegionStatus OfflineDatabase::getRegionCompletedStatus(int64_t regionID) {
     OfflineRegionStatus result;
 
@@ -737,6 +1257,21 @@ OfflineRegionStatus OfflineDatabase::getRegionCompletedStatus(int64_t regionID)
     return result;
 }
 
+uint64_t OfflineDatabase::getRegionResourceCount(int64_t regionID, Resource::Kind kind) {
+    // clang-format off
+    Statement stmt = getStatement(
+        "SELECT COUNT(*) "
+        "FROM region_resources, resources "
+        "WHERE region_id = ?1 "
+        "AND resource_id = resources.id "
+        "AND kind = ?2 ");
+    // clang-format on
+    stmt->bind(1, regionID);
+    stmt->bind(2, int(kind));
+    stmt->run();
+    return stmt->get<int64_t>(0);
+}
+
 std::pair<int64_t, int64_t> OfflineDatabase::getCompletedResourceCountAndSize(int64_t regionID) {
     // clang-format off
     Statement stmt = getStatement(
@@ -770,6 +1305,12 @@ T OfflineDatabase::getPragma(const char * sql) {
     return stmt->get<T>(0);
 }
 
+uint64_t OfflineDatabase::usedSize() {
+    const uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
+    const uint64_t pageCount = getPragma<int64_t>("PRAGMA page_count");
+    return pageSize * (pageCount - getPragma<int64_t>("PRAGMA freelist_count"));
+}
+
 // Remove least-recently used resources and tiles until the used database size,
 // as calculated by multiplying the number of in-use pages by the page size, is
 // less than the maximum cache size. Returns false if this condition cannot be
@@ -782,79 +1323,129 @@ T OfflineDatabase::getPragma(const char * sql) {
 // us from calling VACCUM or keeping a running total, which can be costly.
 bool OfflineDatabase::evict(uint64_t neededFreeSize) {
     uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
-    uint64_t pageCount = getPragma<int64_t>("PRAGMA page_count");
-
-    auto usedSize = [&] {
-        return pageSize * (pageCount - getPragma<int64_t>("PRAGMA freelist_count"));
-    };
 
     // The addition of pageSize is a fudge factor to account for non `data` column
     // size, and because pages can get fragmented on the database.
     while (usedSize() + neededFreeSize + pageSize > maximumCacheSize) {
-        // clang-format off
-        Statement accessedStmt = getStatement(
-            "SELECT max(accessed) "
-            "FROM ( "
-            "    SELECT accessed "
-            "    FROM resources "
-            "    LEFT JOIN region_resources "
-            "    ON resource_id = resources.id "
-            "    WHERE resource_id IS NULL "
-            "  UNION ALL "
-            "    SELECT accessed "
-            "    FROM tiles "
-            "    LEFT JOIN region_tiles "
-            "    ON tile_id = tiles.id "
-            "    WHERE tile_id IS NULL "
-            "  ORDER BY accessed ASC LIMIT ?1 "
-            ") "
-        );
-        accessedStmt->bind(1, 50);
-        // clang-format on
-        if (!accessedStmt->run()) {
+        if (!evictOldest(inlineEvictionBatchSize)) {
             return false;
         }
-        Timestamp accessed = accessedStmt->get<Timestamp>(0);
+    }
 
-        // clang-format off
-        Statement stmt1 = getStatement(
-            "DELETE FROM resources "
-            "WHERE id IN ( "
-            "  SELECT id FROM resources "
-            "  LEFT JOIN region_resources "
-            "  ON resource_id = resources.id "
-            "  WHERE resource_id IS NULL "
-            "  AND accessed <= ?1 "
-            ") ");
-        // clang-format on
-        stmt1->bind(1, accessed);
-        stmt1->run();
-        uint64_t changes1 = stmt1->changes();
+    return true;
+}
 
-        // clang-format off
-        Statement stmt2 = getStatement(
-            "DELETE FROM tiles "
-            "WHERE id IN ( "
-            "  SELECT id FROM tiles "
-            "  LEFT JOIN region_tiles "
-            "  ON tile_id = tiles.id "
-            "  WHERE tile_id IS NULL "
-            "  AND accessed <= ?1 "
-            ") ");
-        // clang-format on
-        stmt2->bind(1, accessed);
-        stmt2->run();
-        uint64_t changes2 = stmt2->changes();
+bool OfflineDatabase::evictOldest(uint32_t count) {
+    // Resources are evicted by access time.
+    writeAccessTimes();
 
-        // The cached value of offlineTileCount does not need to be updated
-        // here because only non-offline tiles can be removed by eviction.
+    // clang-format off
+    Statement accessedStmt = getStatement(
+        "SELECT max(accessed) "
+        "FROM ( "
+        "    SELECT accessed "
+        "    FROM resources "
+        "    LEFT JOIN region_resources "
+        "    ON resource_id = resources.id "
+        "    WHERE resource_id IS NULL "
+        "  UNION ALL "
+        "    SELECT accessed "
+        "    FROM tiles "
+        "    LEFT JOIN region_tiles "
+        "    ON tile_id = tiles.id "
+        "    WHERE tile_id IS NULL "
+        "  ORDER BY accessed ASC LIMIT ?1 "
+        ") "
+    );
+    accessedStmt->bind(1, count);
+    // clang-format on
+    if (!accessedStmt->run()) {
+        return false;
+    }
+    Timestamp accessed = accessedStmt->get<Timestamp>(0);
 
-        if (changes1 == 0 && changes2 == 0) {
-            return false;
+    // clang-format off
+    Statement stmt1 = getStatement(
+        "DELETE FROM resources "
+        "WHERE id IN ( "
+        "  SELECT id FROM resources "
+        "  LEFT JOIN region_resources "
+        "  ON resource_id = resources.id "
+        "  WHERE resource_id IS NULL "
+        "  AND accessed <= ?1 "
+        ") ");
+    // clang-format on
+    stmt1->bind(1, accessed);
+    stmt1->run();
+    uint64_t changes1 = stmt1->changes();
+
+    // clang-format off
+    Statement stmt2 = getStatement(
+        "DELETE FROM tiles "
+        "WHERE id IN ( "
+        "  SELECT id FROM tiles "
+        "  LEFT JOIN region_tiles "
+        "  ON tile_id = tiles.id "
+        "  WHERE tile_id IS NULL "
+        "  AND accessed <= ?1 "
+        ") ");
+    // clang-format on
+    stmt2->bind(1, accessed);
+    stmt2->run();
+    uint64_t changes2 = stmt2->changes();
+
+    // The cached value of offlineTileCount does not need to be updated
+    // here because only non-offline tiles can be removed by eviction.
+
+    return changes1 != 0 || changes2 != 0;
+}
+
+bool OfflineDatabase::needsEviction() {
+    return maintenance != Maintenance::None || usedSize() > maximumCacheSize * evictionHighWaterMark;
+}
+
+bool OfflineDatabase::evictInBackground(Duration budget) {
+    const TimePoint deadline = Clock::now() + budget;
+
+    if (maintenance != Maintenance::Evict && usedSize() > maximumCacheSize * evictionHighWaterMark) {
+        maintenance = Maintenance::Evict;
+    } else if (maintenance == Maintenance::None) {
+        return false;
+    }
+
+    while (maintenance == Maintenance::Evict) {
+        if (usedSize() <= maximumCacheSize * evictionLowWaterMark) {
+            maintenance = Maintenance::Vacuum;
+            break;
+        }
+
+        // Written first, so that the transaction below doesn't have to nest another one.
+        writeAccessTimes();
+
+        bool evicted;
+        {
+            mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+            evicted = evictOldest(backgroundEvictionBatchSize);
+            transaction.commit();
+        }
+        if (!evicted) {
+            // Only resources of offline regions are left.
+            maintenance = Maintenance::Vacuum;
+        } else if (Clock::now() >= deadline) {
+            return true;
         }
     }
 
-    return true;
+    // Returns the freed pages to the file system, a few at a time.
+    while (getPragma<int64_t>("PRAGMA freelist_count") > 0) {
+        db->exec("PRAGMA incremental_vacuum(" + util::toString(vacuumBatchPages) + ")");
+        if (Clock::now() >= deadline) {
+            return true;
+        }
+    }
+
+    maintenance = Maintenance::None;
+    return false;
 }
 
 void OfflineDatabase::setOfflineMapboxTileCountLimit(uint64_t limit) {
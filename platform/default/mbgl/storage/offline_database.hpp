@@ -4,12 +4,17 @@
 #include <mbgl/storage/offline.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/mapbox.hpp>
 
 #include <unordered_map>
+#include <map>
 #include <memory>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace mapbox {
 namespace sqlite {
@@ -23,15 +28,52 @@ namespace mbgl {
 class Response;
 class TileID;
 
+// The tiles of an offline region that are stored already, with their sizes. Resuming a
+// download looks tiles up here rather than in the database, one query for all of them.
+class OfflineRegionTiles {
+public:
+    optional<uint64_t> find(const Resource::TileData&) const;
+    std::size_t size() const;
+
+    // Whether a stored tile had expired when the tiles were read.
+    bool isExpired(const Resource::TileData&) const;
+
+private:
+    friend class OfflineDatabase;
+
+    static uint64_t key(int32_t x, int32_t y, uint8_t z);
+
+    // Keys of tiles with their sizes, sorted, by URL template and pixel ratio.
+    std::map<std::pair<std::string, uint8_t>, std::vector<std::pair<uint64_t, uint64_t>>> tiles;
+
+    // Keys of the expired ones, sorted, the same way.
+    std::map<std::pair<std::string, uint8_t>, std::vector<uint64_t>> expiredTiles;
+};
+
 class OfflineDatabase : private util::noncopyable {
 public:
     // Limits affect ambient caching (put) only; resources required by offline
     // regions are exempt.
     OfflineDatabase(std::string path, uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+
+    // Opens an existing database through a connection that only reads it, e.g. on another
+    // thread than the one writing it, which write-ahead logging lets it read alongside. Reads
+    // don't record when resources were accessed then; see `recordAccess`.
+    struct ReadOnly {};
+    OfflineDatabase(std::string path, ReadOnly);
+
     ~OfflineDatabase();
 
     optional<Response> get(const Resource&);
 
+    // Like `get`, but the data of tiles is returned as it is stored, with its `compression`,
+    // so that it is inflated by the thread that uses it rather than the one reading it.
+    optional<Response> getCompressed(const Resource&);
+
+    // Records that a resource was read, for eviction, as `get` does. For the resources that a
+    // read-only connection read.
+    void recordAccess(const Resource&);
+
     // Return value is (inserted, stored size)
     std::pair<bool, uint64_t> put(const Resource&, const Response&);
 
@@ -44,14 +86,56 @@ public:
 
     void deleteRegion(OfflineRegion&&);
 
+    // Writes a new database at the given path, replacing any file there, with the region and
+    // the resources and tiles it uses.
+    void exportRegion(int64_t regionID, const std::string& path);
+
+    // Adds the regions of a database that exportRegion wrote, with their resources, so that
+    // they are complete without downloading anything. Resources that are already stored are
+    // shared rather than copied. Rows are copied in batches of a transaction each. Return
+    // value is the imported regions, with their new IDs.
+    std::vector<OfflineRegion> importRegions(const std::string& path);
+
     // Return value is (response, stored size)
     optional<std::pair<Response, uint64_t>> getRegionResource(int64_t regionID, const Resource&);
     optional<int64_t> hasRegionResource(int64_t regionID, const Resource&);
+    // The stored size of a resource that was not modified is the size it already had.
     uint64_t putRegionResource(int64_t regionID, const Resource&, const Response&);
 
+    // Puts the resources in a single transaction. Return value is the stored size of each.
+    std::vector<uint64_t> putRegionResources(int64_t regionID, const std::vector<std::pair<Resource, Response>>&);
+
+    OfflineRegionTiles getRegionTiles(int64_t regionID);
+
+    // The etag, modification and expiration times of a stored resource, without its data:
+    // what it is revalidated with.
+    optional<Response> getValidators(const Resource&);
+
     OfflineRegionDefinition getRegionDefinition(int64_t regionID);
     OfflineRegionStatus getRegionCompletedStatus(int64_t regionID);
 
+    // The number of resources of the given kind, other than tiles, that the region uses.
+    uint64_t getRegionResourceCount(int64_t regionID, Resource::Kind);
+
+    // By default, the database uses a rollback journal and syncs every write to disk, and reads
+    // wait for writes. With write-ahead logging, writes are appended to a log that readers don't
+    // wait for, and ambient cache writes are only synced at checkpoints, which SQLite runs as the
+    // log grows: a power failure may lose the last of them, but leaves the database consistent.
+    // Resources of offline regions are still synced as they are written.
+    void setWriteAheadLogging(bool);
+
+    // A put only evicts ambient resources when they wouldn't fit otherwise. To keep that from
+    // stalling it, eviction should also run in the background whenever this returns true:
+    // evictInBackground frees space in large batches, well below the maximum cache size, and
+    // then vacuums the database, for the given time at most. Return value is true if there is
+    // work left for another call. Deleting a region also leaves its eviction and vacuuming to
+    // evictInBackground.
+    bool needsEviction();
+    bool evictInBackground(Duration budget);
+
+    // The dictionary that tiles are compressed with, of strings common in vector tiles.
+    static const std::string& tileDictionary();
+
     void setOfflineMapboxTileCountLimit(uint64_t);
     uint64_t getOfflineMapboxTileCountLimit();
     bool offlineMapboxTileCountLimitExceeded();
@@ -64,6 +148,7 @@ private:
     void removeExisting();
     void migrateToVersion3();
     void migrateToVersion5();
+    void syncEachWrite(bool);
 
     class Statement {
     public:
@@ -80,19 +165,20 @@ private:
 
     Statement getStatement(const char *);
 
-    optional<std::pair<Response, uint64_t>> getTile(const Resource::TileData&);
+    optional<std::pair<Response, uint64_t>> getTile(const Resource::TileData&, bool inflate);
     optional<int64_t> hasTile(const Resource::TileData&);
     bool putTile(const Resource::TileData&, const Response&,
-                 const std::string&, bool compressed);
+                 const std::string&, int compression);
 
     optional<std::pair<Response, uint64_t>> getResource(const Resource&);
     optional<int64_t> hasResource(const Resource&);
     bool putResource(const Resource&, const Response&,
-                     const std::string&, bool compressed);
+                     const std::string&, int compression);
 
-    optional<std::pair<Response, uint64_t>> getInternal(const Resource&);
+    optional<std::pair<Response, uint64_t>> getInternal(const Resource&, bool inflate = true);
     optional<int64_t> hasInternal(const Resource&);
     std::pair<bool, uint64_t> putInternal(const Resource&, const Response&, bool evict);
+    uint64_t putRegionResourceInternal(int64_t regionID, const Resource&, const Response&);
 
     // Return value is true iff the resource was previously unused by any other regions.
     bool markUsed(int64_t regionID, const Resource&);
@@ -109,10 +195,37 @@ private:
 
     uint64_t maximumCacheSize;
 
+    bool writeAheadLogging = false;
+    bool syncingEachWrite = true;
+
+    // Set while putting a batch of resources, whose transaction the puts then use.
+    bool inTransaction = false;
+
     uint64_t offlineMapboxTileCountLimit = util::mapbox::DEFAULT_OFFLINE_TILE_COUNT_LIMIT;
     optional<uint64_t> offlineMapboxTileCount;
 
+    uint64_t usedSize();
     bool evict(uint64_t neededFreeSize);
+    bool evictOldest(uint32_t count);
+
+    enum class Maintenance {
+        None,
+        Evict,
+        Vacuum,
+    };
+    Maintenance maintenance = Maintenance::None;
+
+    const bool readOnly = false;
+
+    // Reading a resource records when it was accessed, for eviction. Access times are kept
+    // to the minute, and written in batches, so that reads don't wait for a write each.
+    void writeAccessTimesIfDue();
+    void writeAccessTimes();
+
+    using TileKey = std::tuple<std::string, uint8_t, int32_t, int32_t, int8_t>;
+    std::unordered_map<std::string, Timestamp> resourceAccessTimes;
+    std::map<TileKey, Timestamp> tileAccessTimes;
+    optional<Timestamp> firstUnwrittenAccess;
 };
 
 } // namespace mbgl
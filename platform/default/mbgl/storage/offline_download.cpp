@@ -4,19 +4,76 @@
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/storage/http_file_source.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/parser.hpp>
 #include <mbgl/style/sources/geojson_source_impl.hpp>
 #include <mbgl/style/tile_source_impl.hpp>
+#include <mbgl/text/bidi.hpp>
 #include <mbgl/text/glyph.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/i18n.hpp>
+#include <mbgl/util/logging.hpp>
 #include <mbgl/util/mapbox.hpp>
+#include <mbgl/util/platform.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/tileset.hpp>
+#include <mbgl/util/utf.hpp>
 
+#include <algorithm>
 #include <set>
 
 namespace mbgl {
 
+namespace {
+
+// Most of the time spent storing a tile is in committing the transaction.
+constexpr std::size_t tileBatchSize = 64;
+constexpr Duration tileBatchDelay = Milliseconds(500);
+
+// Revalidations mostly get empty 304 responses, and keep more requests in flight than downloads.
+constexpr std::size_t refreshConcurrency = 4;
+
+// The fields of a symbol layer's text, or nothing if it depends on the properties of features.
+struct TextFields {
+    using Result = optional<std::vector<util::TokenString>>;
+
+    Result operator()(const style::Undefined&) const {
+        return std::vector<util::TokenString>();
+    }
+
+    Result operator()(const std::string& field) const {
+        return std::vector<util::TokenString> { util::TokenString(field) };
+    }
+
+    Result operator()(const style::CameraFunction<std::string>& function) const {
+        std::vector<util::TokenString> fields;
+        function.stops.match([&] (const auto& stops) {
+            for (const auto& stop : stops.stops) {
+                fields.emplace_back(stop.second);
+            }
+        });
+        return fields;
+    }
+
+    template <class Function>
+    Result operator()(const Function&) const {
+        return {};
+    }
+};
+
+GlyphRangeSet glyphRangesOf(Range<char16_t> codepoints) {
+    GlyphRangeSet result;
+    for (uint32_t start = codepoints.min / GLYPHS_PER_GLYPH_RANGE * GLYPHS_PER_GLYPH_RANGE;
+         start <= codepoints.max; start += GLYPHS_PER_GLYPH_RANGE) {
+        result.insert(getGlyphRange(start));
+    }
+    return result;
+}
+
+} // namespace
+
 OfflineDownload::OfflineDownload(int64_t id_,
                                  OfflineRegionDefinition&& definition_,
                                  OfflineDatabase& offlineDatabase_,
@@ -28,7 +85,13 @@ OfflineDownload::OfflineDownload(int64_t id_,
     setObserver(nullptr);
 }
 
-OfflineDownload::~OfflineDownload() = default;
+OfflineDownload::~OfflineDownload() {
+    try {
+        writeTiles();
+    } catch (...) {
+        Log::Error(Event::Database, "Unexpected error storing downloaded tiles: %s", util::toString(std::current_exception()).c_str());
+    }
+}
 
 void OfflineDownload::setObserver(std::unique_ptr<OfflineRegionObserver> observer_) {
     observer = observer_ ? std::move(observer_) : std::make_unique<OfflineRegionObserver>();
@@ -50,6 +113,22 @@ void OfflineDownload::setState(OfflineRegionDownloadState state) {
     observer->statusChanged(status);
 }
 
+void OfflineDownload::refresh() {
+    refreshing = true;
+    setState(OfflineRegionDownloadState::Active);
+}
+
+void OfflineDownload::addGlyphRange(Range<char16_t> codepoints) {
+    addedGlyphRanges.push_back(codepoints);
+
+    if (status.downloadState != OfflineRegionDownloadState::Active) {
+        setState(OfflineRegionDownloadState::Active);
+    } else if (glyphsQueued && !glyphURL.empty()) {
+        queueGlyphRanges(glyphRangesOf(codepoints));
+        continueDownload();
+    }
+}
+
 OfflineRegionStatus OfflineDownload::getStatus() const {
     if (status.downloadState == OfflineRegionDownloadState::Active) {
         return status;
@@ -81,15 +160,15 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
 
             if (urlOrTileset.is<Tileset>()) {
                 result.requiredResourceCount +=
-                    definition.tileCover(type, tileSize, urlOrTileset.get<Tileset>().zoomRange).size();
+                    definition.tileCount(type, tileSize, urlOrTileset.get<Tileset>().zoomRange);
             } else {
                 result.requiredResourceCount += 1;
                 const std::string& url = urlOrTileset.get<std::string>();
                 optional<Response> sourceResponse = offlineDatabase.get(Resource::source(url));
                 if (sourceResponse) {
                     result.requiredResourceCount +=
-                        definition.tileCover(type, tileSize, style::TileSourceImpl::parseTileJSON(
-                            *sourceResponse->data, url, type, tileSize).zoomRange).size();
+                        definition.tileCount(type, tileSize, style::TileSourceImpl::parseTileJSON(
+                            *sourceResponse->data, url, type, tileSize).zoomRange);
                 } else {
                     result.requiredResourceCountIsPrecise = false;
                 }
@@ -114,7 +193,16 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
     }
 
     if (!parser.glyphURL.empty()) {
-        result.requiredResourceCount += parser.fontStacks().size() * GLYPH_RANGES_PER_FONT_STACK;
+        if (definition.glyphs == OfflineRegionGlyphs::All) {
+            result.requiredResourceCount += parser.fontStacks().size() * GLYPH_RANGES_PER_FONT_STACK;
+        } else {
+            // The ranges that the tiles use are only known once they're all downloaded: the
+            // ranges stored so far are all of them if the rest of the region is complete.
+            result.requiredResourceCount += offlineDatabase.getRegionResourceCount(id, Resource::Kind::Glyphs);
+            if (result.completedResourceCount != result.requiredResourceCount) {
+                result.requiredResourceCountIsPrecise = false;
+            }
+        }
     }
 
     if (!parser.spriteURL.empty()) {
@@ -127,6 +215,12 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
 void OfflineDownload::activateDownload() {
     status = OfflineRegionStatus();
     status.downloadState = OfflineRegionDownloadState::Active;
+    storedTiles = offlineDatabase.getRegionTiles(id);
+    textLayers.clear();
+    urlTemplates.clear();
+    usedGlyphRanges.clear();
+    queuedGlyphRanges.clear();
+    glyphsQueued = false;
     status.requiredResourceCount++;
     ensureResource(Resource::style(definition.styleURL), [&](Response styleResponse) {
         status.requiredResourceCountIsPrecise = true;
@@ -134,6 +228,12 @@ void OfflineDownload::activateDownload() {
         style::Parser parser;
         parser.parse(*styleResponse.data);
 
+        glyphURL = parser.glyphURL;
+        fontStacks = parser.fontStacks();
+        if (!glyphURL.empty() && definition.glyphs == OfflineRegionGlyphs::Used) {
+            extractTextLayers(parser);
+        }
+
         for (const auto& source : parser.sources) {
             SourceType type = source->baseImpl->type;
 
@@ -145,8 +245,10 @@ void OfflineDownload::activateDownload() {
                 const variant<std::string, Tileset>& urlOrTileset = tileSource->getURLOrTileset();
                 const uint16_t tileSize = tileSource->getTileSize();
 
+                const std::string sourceID = source->getID();
+
                 if (urlOrTileset.is<Tileset>()) {
-                    queueTiles(type, tileSize, urlOrTileset.get<Tileset>());
+                    queueTiles(type, tileSize, urlOrTileset.get<Tileset>(), sourceID);
                 } else {
                     const std::string& url = urlOrTileset.get<std::string>();
                     status.requiredResourceCountIsPrecise = false;
@@ -155,10 +257,10 @@ void OfflineDownload::activateDownload() {
 
                     ensureResource(Resource::source(url), [=](Response sourceResponse) {
                         queueTiles(type, tileSize, style::TileSourceImpl::parseTileJSON(
-                            *sourceResponse.data, url, type, tileSize));
+                            *sourceResponse.data, url, type, tileSize), sourceID);
 
                         requiredSourceURLs.erase(url);
-                        if (requiredSourceURLs.empty()) {
+                        if (requiredSourceURLs.empty() && glyphsQueued) {
                             status.requiredResourceCountIsPrecise = true;
                         }
                     });
@@ -182,12 +284,13 @@ void OfflineDownload::activateDownload() {
             }
         }
 
-        if (!parser.glyphURL.empty()) {
-            for (const auto& fontStack : parser.fontStacks()) {
-                for (char16_t i = 0; i < GLYPH_RANGES_PER_FONT_STACK; i++) {
-                    queueResource(Resource::glyphs(parser.glyphURL, fontStack, getGlyphRange(i * GLYPHS_PER_GLYPH_RANGE)));
-                }
-            }
+        if (glyphURL.empty() || definition.glyphs == OfflineRegionGlyphs::All) {
+            queueGlyphRanges(glyphRangesOf({ 0, 0xFFFF }));
+            glyphsQueued = true;
+        } else {
+            // Counted as one resource until then, so that the download isn't complete before.
+            status.requiredResourceCount++;
+            status.requiredResourceCountIsPrecise = false;
         }
 
         if (!parser.spriteURL.empty()) {
@@ -217,20 +320,58 @@ void OfflineDownload::activateDownload() {
    the first few errors is fruitless anyway.
 */
 void OfflineDownload::continueDownload() {
-    if (resourcesRemaining.empty() && status.complete()) {
+    // Nothing else is going to complete the batch.
+    if (requests.empty() && !bufferedTiles.empty()) {
+        storeTiles();
+        return;
+    }
+
+    // Once the tiles are stored, their text is known.
+    if (!glyphsQueued && requests.empty() && tilesRemaining.empty()) {
+        GlyphRangeSet ranges = usedGlyphRanges;
+        for (const auto& codepoints : addedGlyphRanges) {
+            const GlyphRangeSet added = glyphRangesOf(codepoints);
+            ranges.insert(added.begin(), added.end());
+        }
+        status.requiredResourceCount--;
+        queueGlyphRanges(ranges);
+        glyphsQueued = true;
+        status.requiredResourceCountIsPrecise = requiredSourceURLs.empty();
+    }
+
+    if (resourcesRemaining.empty() && tilesRemaining.empty() && status.complete()) {
         setState(OfflineRegionDownloadState::Inactive);
         return;
     }
 
-    while (!resourcesRemaining.empty() && requests.size() < HTTPFileSource::maximumConcurrentRequests()) {
-        ensureResource(resourcesRemaining.front());
-        resourcesRemaining.pop_front();
+    const std::size_t maximumRequests = HTTPFileSource::maximumConcurrentRequests() * (refreshing ? refreshConcurrency : 1);
+    while (requests.size() < maximumRequests) {
+        if (!resourcesRemaining.empty()) {
+            ensureResource(resourcesRemaining.front());
+            resourcesRemaining.pop_front();
+        } else if (!tilesRemaining.empty()) {
+            // Tiles are only made into resources as they are requested.
+            const Tileset& tileset = tilesRemaining.front().first;
+            if (optional<UnwrappedTileID> tile = tilesRemaining.front().second.next()) {
+                ensureResource(Resource::tile(tileset.tiles[0], definition.pixelRatio,
+                    tile->canonical.x, tile->canonical.y, tile->canonical.z, tileset.scheme));
+            } else {
+                tilesRemaining.pop_front();
+            }
+        } else {
+            break;
+        }
     }
 }
+}
 
 void OfflineDownload::deactivateDownload() {
+    writeTiles();
     requiredSourceURLs.clear();
     resourcesRemaining.clear();
+    tilesRemaining.clear();
+    storedTiles = {};
+    refreshing = false;
     requests.clear();
 }
 
@@ -239,11 +380,123 @@ void OfflineDownload::queueResource(Resource resource) {
     resourcesRemaining.push_front(std::move(resource));
 }
 
-void OfflineDownload::queueTiles(SourceType type, uint16_t tileSize, const Tileset& tileset) {
-    for (const auto& tile : definition.tileCover(type, tileSize, tileset.zoomRange)) {
-        status.requiredResourceCount++;
-        resourcesRemaining.push_back(
-            Resource::tile(tileset.tiles[0], definition.pixelRatio, tile.x, tile.y, tile.z, tileset.scheme));
+void OfflineDownload::queueTiles(SourceType type, uint16_t tileSize, const Tileset& tileset, const std::string& sourceID) {
+    status.requiredResourceCount += definition.tileCount(type, tileSize, tileset.zoomRange);
+
+    if (type == SourceType::Vector && textLayers.count(sourceID) && !tileset.tiles.empty()) {
+        urlTemplates.emplace(tileset.tiles[0], sourceID);
+    }
+
+    const Range<uint8_t> zooms = definition.coveringZoomRange(type, tileSize, tileset.zoomRange);
+    tilesRemaining.emplace_back(tileset, util::TileCover(definition.bounds, zooms.min, zooms.max));
+}
+
+void OfflineDownload::extractTextLayers(const style::Parser& parser) {
+    for (const auto& layer : parser.layers) {
+        if (!layer->is<style::SymbolLayer>()) {
+            continue;
+        }
+
+        const auto* symbolLayer = layer->as<style::SymbolLayer>();
+        optional<std::vector<util::TokenString>> fields = symbolLayer->getTextField().evaluate(TextFields());
+        if (fields && fields->empty()) {
+            continue;
+        }
+
+        const style::DataDrivenPropertyValue<style::TextTransformType> textTransform = symbolLayer->getTextTransform();
+        const bool transformed = !textTransform.isUndefined() &&
+            textTransform != style::DataDrivenPropertyValue<style::TextTransformType>(style::TextTransformType::None);
+
+        textLayers[symbolLayer->getSourceID()].push_back({ symbolLayer->getSourceLayer(), std::move(fields), transformed });
+    }
+}
+
+void OfflineDownload::collectGlyphRanges(const Resource& resource, std::shared_ptr<const std::string> data) {
+    if (glyphsQueued || resource.kind != Resource::Kind::Tile) {
+        return;
+    }
+
+    auto source = urlTemplates.find(resource.tileData->urlTemplate);
+    if (source == urlTemplates.end()) {
+        return;
+    }
+    const std::vector<TextLayer>& layers = textLayers.at(source->second);
+
+    // Tiles that were stored before, or not modified, are read back.
+    if (!data) {
+        optional<Response> stored = offlineDatabase.get(resource);
+        if (!stored || !stored->data) {
+            return;
+        }
+        data = stored->data;
+    }
+
+    std::unordered_set<std::string> texts;
+    auto addText = [&] (std::string text, bool transformed) {
+        if (transformed) {
+            texts.insert(platform::uppercase(text));
+            texts.insert(platform::lowercase(text));
+        }
+        texts.insert(std::move(text));
+    };
+
+    try {
+        VectorTileData tile(std::move(data));
+        for (const TextLayer& layer : layers) {
+            const GeometryTileLayer* sourceLayer = tile.getLayer(layer.sourceLayer);
+            if (!sourceLayer) {
+                continue;
+            }
+
+            for (std::size_t i = 0; i < sourceLayer->featureCount(); i++) {
+                const auto feature = sourceLayer->getFeature(i);
+                if (layer.fields) {
+                    // Values other than strings are written in ASCII, like a zero.
+                    auto getValue = [&] (const std::string& key) -> std::string {
+                        optional<Value> value = feature->getValue(key);
+                        if (!value) {
+                            return std::string();
+                        }
+                        return value->is<std::string>() ? value->get<std::string>() : "0";
+                    };
+                    for (const auto& field : *layer.fields) {
+                        addText(field.replace(getValue), layer.transformed);
+                    }
+                } else {
+                    for (const auto& property : feature->getProperties()) {
+                        if (property.second.is<std::string>()) {
+                            addText(property.second.get<std::string>(), layer.transformed);
+                        }
+                    }
+                }
+            }
+        }
+    } catch (const std::exception& ex) {
+        Log::Warning(Event::ParseTile, "Unable to read the text of %s: %s", resource.url.c_str(), ex.what());
+        return;
+    }
+
+    for (const auto& text : texts) {
+        for (char16_t chr : applyArabicShaping(util::utf8_to_utf16::convert(text))) {
+            usedGlyphRanges.insert(getGlyphRange(chr));
+            if (char16_t verticalChr = util::i18n::verticalizePunctuation(chr)) {
+                usedGlyphRanges.insert(getGlyphRange(verticalChr));
+            }
+        }
+    }
+}
+
+void OfflineDownload::queueGlyphRanges(const GlyphRangeSet& ranges) {
+    if (glyphURL.empty()) {
+        return;
+    }
+    for (const auto& range : ranges) {
+        if (!queuedGlyphRanges.insert(range).second) {
+            continue;
+        }
+        for (const auto& fontStack : fontStacks) {
+            queueResource(Resource::glyphs(glyphURL, fontStack, range));
+        }
     }
 }
 
@@ -253,20 +506,46 @@ void OfflineDownload::ensureResource(const Resource& resource,
     *workRequestsIt = util::RunLoop::Get()->invokeCancellable([=]() {
         requests.erase(workRequestsIt);
 
+        // While refreshing, a stored resource that expired is revalidated with its validators,
+        // or with its whole stored response, which a 304 response passes on to the callback.
+        optional<Response> stale;
+
         auto getResourceSizeInDatabase = [&] () -> optional<int64_t> {
             if (!callback) {
-                return offlineDatabase.hasRegionResource(id, resource);
+                if (resource.kind == Resource::Kind::Tile) {
+                    if (optional<uint64_t> size = storedTiles.find(*resource.tileData)) {
+                        if (!refreshing || !storedTiles.isExpired(*resource.tileData)) {
+                            return int64_t(*size);
+                        }
+                        stale = offlineDatabase.getValidators(resource);
+                        return {};
+                    }
+                }
+                optional<int64_t> size = offlineDatabase.hasRegionResource(id, resource);
+                if (size && refreshing) {
+                    optional<Response> validators = offlineDatabase.getValidators(resource);
+                    if (validators && !validators->isFresh()) {
+                        stale = std::move(validators);
+                        return {};
+                    }
+                }
+                return size;
             }
             optional<std::pair<Response, uint64_t>> response = offlineDatabase.getRegionResource(id, resource);
             if (!response) {
                 return {};
             }
+            if (refreshing && !response->first.isFresh()) {
+                stale = std::move(response->first);
+                return {};
+            }
             callback(response->first);
             return response->second;
         };
 
         optional<int64_t> offlineResponse = getResourceSizeInDatabase();
         if (offlineResponse) {
+            collectGlyphRanges(resource, nullptr);
             status.completedResourceCount++;
             status.completedResourceSize += *offlineResponse;
             if (resource.kind == Resource::Kind::Tile) {
@@ -283,8 +562,17 @@ void OfflineDownload::ensureResource(const Resource& resource,
             return;
         }
 
+        // Downloads share the online file source with maps, which shouldn't wait for them.
+        Resource download = resource;
+        download.priority = Resource::Low;
+        if (stale) {
+            download.priorEtag = stale->etag;
+            download.priorModified = stale->modified;
+            download.priorExpires = stale->expires;
+        }
+
         auto fileRequestsIt = requests.insert(requests.begin(), nullptr);
-        *fileRequestsIt = onlineFileSource.request(resource, [=](Response onlineResponse) {
+        *fileRequestsIt = onlineFileSource.request(download, [=](Response onlineResponse) {
             if (onlineResponse.error) {
                 observer->responseError(*onlineResponse.error);
                 return;
@@ -293,7 +581,19 @@ void OfflineDownload::ensureResource(const Resource& resource,
             requests.erase(fileRequestsIt);
 
             if (callback) {
-                callback(onlineResponse);
+                if (onlineResponse.notModified && stale) {
+                    Response response = *stale;
+                    response.expires = onlineResponse.expires;
+                    callback(response);
+                } else {
+                    callback(onlineResponse);
+                }
+            }
+
+            if (resource.kind == Resource::Kind::Tile) {
+                collectGlyphRanges(resource, onlineResponse.data);
+                bufferTile(resource, onlineResponse);
+                return;
             }
 
             status.completedResourceCount++;
@@ -315,9 +615,75 @@ void OfflineDownload::ensureResource(const Resource& resource,
     });
 }
 
+void OfflineDownload::bufferTile(const Resource& resource, const Response& response) {
+    bufferedTiles.emplace_back(resource, response);
+    if (util::mapbox::isMapboxURL(resource.url)) {
+        bufferedMapboxTiles++;
+    }
+
+    if (bufferedTiles.size() >= tileBatchSize) {
+        storeTiles();
+        return;
+    }
+
+    if (bufferedTiles.size() == 1) {
+        storeTimer.start(tileBatchDelay, Duration::zero(), [this] {
+            storeTiles();
+        });
+    }
+    continueDownload();
+}
+
+void OfflineDownload::writeTiles() {
+    storeTimer.stop();
+    if (bufferedTiles.empty()) {
+        return;
+    }
+
+    const std::vector<uint64_t> sizes = offlineDatabase.putRegionResources(id, bufferedTiles);
+    for (const uint64_t size : sizes) {
+        status.completedResourceCount++;
+        status.completedResourceSize += size;
+        status.completedTileCount += 1;
+        status.completedTileSize += size;
+    }
+
+    bufferedTiles.clear();
+    bufferedMapboxTiles = 0;
+}
+
+void OfflineDownload::storeTiles() {
+    // The last Mapbox tile is enough to check the limit after storing the batch.
+    auto mapboxTile = std::find_if(bufferedTiles.rbegin(), bufferedTiles.rend(), [] (const auto& tile) {
+        return util::mapbox::isMapboxURL(tile.first.url);
+    });
+    optional<Resource> limitedTile;
+    if (mapboxTile != bufferedTiles.rend()) {
+        limitedTile = mapboxTile->first;
+    }
+
+    writeTiles();
+    observer->statusChanged(status);
+
+    if (limitedTile && checkTileCountLimit(*limitedTile)) {
+        return;
+    }
+
+    continueDownload();
+}
+
 bool OfflineDownload::checkTileCountLimit(const Resource& resource) {
-    if (resource.kind == Resource::Kind::Tile && util::mapbox::isMapboxURL(resource.url) &&
-        offlineDatabase.offlineMapboxTileCountLimitExceeded()) {
+    if (resource.kind != Resource::Kind::Tile || !util::mapbox::isMapboxURL(resource.url)) {
+        return false;
+    }
+
+    // Buffered tiles aren't counted until they're stored: close to the limit, store them first.
+    if (bufferedMapboxTiles &&
+        offlineDatabase.getOfflineMapboxTileCount() + bufferedMapboxTiles >= offlineDatabase.getOfflineMapboxTileCountLimit()) {
+        writeTiles();
+    }
+
+    if (offlineDatabase.offlineMapboxTileCountLimitExceeded()) {
         observer->mapboxTileCountLimitExceeded(offlineDatabase.getOfflineMapboxTileCountLimit());
         setState(OfflineRegionDownloadState::Inactive);
         return true;
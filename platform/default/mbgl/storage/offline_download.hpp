@@ -1,20 +1,30 @@
 #pragma once
 
 #include <mbgl/storage/offline.hpp>
+#include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/text/glyph_range.hpp>
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/util/range.hpp>
+#include <mbgl/util/tile_cover.hpp>
+#include <mbgl/util/tileset.hpp>
+#include <mbgl/util/timer.hpp>
+#include <mbgl/util/token.hpp>
 
 #include <list>
+#include <unordered_map>
 #include <unordered_set>
 #include <memory>
 #include <deque>
+#include <utility>
+#include <vector>
 
 namespace mbgl {
 
-class OfflineDatabase;
 class FileSource;
 class AsyncRequest;
-class Response;
-class Tileset;
 
 namespace style {
 class Parser;
@@ -33,6 +43,20 @@ public:
     void setObserver(std::unique_ptr<OfflineRegionObserver>);
     void setState(OfflineRegionDownloadState);
 
+    /*
+     * Activate the download in refresh mode: stored resources that expired are revalidated
+     * with conditional requests, more of them at once than a download makes, while the others
+     * are complete as they are. Resources that were not modified only have their expiration
+     * times updated. The download returns to the usual mode once it is deactivated.
+     */
+    void refresh();
+
+    /*
+     * Add the glyph ranges of the given codepoints to the region, activating the download
+     * if it isn't active.
+     */
+    void addGlyphRange(Range<char16_t> codepoints);
+
     OfflineRegionStatus getStatus() const;
 
 private:
@@ -48,6 +72,15 @@ private:
     void ensureResource(const Resource&, std::function<void (Response)> = {});
     bool checkTileCountLimit(const Resource& resource);
 
+    /*
+     * Downloaded tiles are stored in batches, each in a single transaction, once enough of
+     * them are buffered, a while after the first of them, or when nothing else is in progress.
+     * They only count as completed once they are stored.
+     */
+    void bufferTile(const Resource&, const Response&);
+    void writeTiles();
+    void storeTiles();
+
     int64_t id;
     OfflineRegionDefinition definition;
     OfflineDatabase& offlineDatabase;
@@ -58,9 +91,44 @@ private:
     std::list<std::unique_ptr<AsyncRequest>> requests;
     std::unordered_set<std::string> requiredSourceURLs;
     std::deque<Resource> resourcesRemaining;
+    std::deque<std::pair<Tileset, util::TileCover>> tilesRemaining;
+
+    // Tiles of the region that were stored before the download was activated.
+    OfflineRegionTiles storedTiles;
+    bool refreshing = false;
+
+    std::vector<std::pair<Resource, Response>> bufferedTiles;
+    uint32_t bufferedMapboxTiles = 0;
+    util::Timer storeTimer;
 
     void queueResource(Resource);
-    void queueTiles(SourceType, uint16_t tileSize, const Tileset&);
+    void queueTiles(SourceType, uint16_t tileSize, const Tileset&, const std::string& sourceID);
+
+    /*
+     * The glyph ranges of the style's font stacks are queued once the style is parsed, or,
+     * with `OfflineRegionGlyphs::Used`, once the tiles are stored: until then, the text that
+     * the symbol layers of each vector source use is collected from its tiles as they're
+     * downloaded or read from the database. Text fields that are source or composite
+     * functions take in every string property of the source layer.
+     */
+    struct TextLayer {
+        std::string sourceLayer;
+        optional<std::vector<util::TokenString>> fields;
+        bool transformed;
+    };
+
+    void extractTextLayers(const style::Parser&);
+    void collectGlyphRanges(const Resource&, std::shared_ptr<const std::string> data);
+    void queueGlyphRanges(const GlyphRangeSet&);
+
+    std::unordered_map<std::string, std::vector<TextLayer>> textLayers;
+    std::unordered_map<std::string, std::string> urlTemplates;
+    std::string glyphURL;
+    std::vector<FontStack> fontStacks;
+    GlyphRangeSet usedGlyphRanges;
+    GlyphRangeSet queuedGlyphRanges;
+    std::vector<Range<char16_t>> addedGlyphRanges;
+    bool glyphsQueued = false;
 };
 
 } // namespace mbgl
@@ -0,0 +1,103 @@
+#include <mbgl/storage/response_cache.hpp>
+
+namespace mbgl {
+
+ResponseCache::ResponseCache(std::size_t maximumSize_)
+    : maximumSize(maximumSize_) {
+}
+
+optional<Response> ResponseCache::get(const Resource& resource) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(resource.url);
+    if (it != entries.end() && !it->second.response.isFresh()) {
+        erase(it);
+        it = entries.end();
+    }
+
+    if (it == entries.end()) {
+        stats.misses++;
+        return {};
+    }
+
+    stats.hits++;
+    lru.splice(lru.begin(), lru, it->second.lru);
+    return it->second.response;
+}
+
+void ResponseCache::put(const Resource& resource, const Response& response) {
+    if (response.error) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(resource.url);
+
+    if (response.notModified) {
+        if (it != entries.end()) {
+            it->second.response.expires = response.expires;
+            if (!it->second.response.isFresh()) {
+                erase(it);
+            }
+        }
+        return;
+    }
+
+    if (it != entries.end()) {
+        erase(it);
+    }
+
+    if (!response.isFresh()) {
+        return;
+    }
+
+    // Roughly, with the overhead of a map node, a list node and the response.
+    const std::size_t entrySize = sizeof(Entry) + 64 + 2 * resource.url.size() +
+        (response.data ? response.data->size() : 0) +
+        (response.etag ? response.etag->size() : 0);
+
+    it = entries.emplace(resource.url, Entry { response, entrySize, {} }).first;
+    lru.push_front(&it->first);
+    it->second.lru = lru.begin();
+    size += entrySize;
+
+    evict();
+}
+
+void ResponseCache::setMaximumSize(std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maximumSize = bytes;
+    evict();
+}
+
+std::size_t ResponseCache::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return size;
+}
+
+ResponseCache::Stats ResponseCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void ResponseCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    lru.clear();
+    size = 0;
+}
+
+void ResponseCache::erase(std::unordered_map<std::string, Entry>::iterator it) {
+    size -= it->second.size;
+    lru.erase(it->second.lru);
+    entries.erase(it);
+}
+
+void ResponseCache::evict() {
+    while (size > maximumSize && !lru.empty()) {
+        erase(entries.find(*lru.back()));
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+/*
+    Responses kept in memory in front of the offline database, by URL, so that resources
+    requested again shortly after, by the same map or another one sharing the file source,
+    skip SQLite. Entries share the data of the responses they were made from. Once they
+    take up more than the maximum size, the least recently used ones are evicted.
+
+    Only fresh, successful responses are kept, and entries are dropped once they expire,
+    so that requests for expired resources go through the database and revalidation as
+    before.
+
+    All methods are thread-safe.
+*/
+class ResponseCache : private util::noncopyable {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+
+        double hitRate() const {
+            return hits + misses ? double(hits) / (hits + misses) : 0;
+        }
+    };
+
+    explicit ResponseCache(std::size_t maximumSize);
+
+    // Counts a hit or a miss.
+    optional<Response> get(const Resource&);
+
+    // Updates the entry for the resource: errors are ignored, and 304 Not Modified
+    // responses refresh the expiration of an existing entry.
+    void put(const Resource&, const Response&);
+
+    void setMaximumSize(std::size_t bytes);
+    std::size_t getSize() const;
+    Stats getStats() const;
+    void clear();
+
+private:
+    struct Entry {
+        Response response;
+        std::size_t size;
+        std::list<const std::string*>::iterator lru;
+    };
+
+    void erase(std::unordered_map<std::string, Entry>::iterator);
+    void evict();
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+
+    // URLs of the entries, from the most to the least recently used.
+    std::list<const std::string*> lru;
+
+    std::size_t size = 0;
+    std::size_t maximumSize;
+    Stats stats;
+};
+
+} // namespace mbgl
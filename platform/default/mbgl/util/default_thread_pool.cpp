@@ -2,31 +2,43 @@
 #include <mbgl/actor/mailbox.hpp>
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/string.hpp>
+#include <mbgl/util/thread_local.hpp>
+
+#include <algorithm>
 
 namespace mbgl {
 
-ThreadPool::ThreadPool(std::size_t count) {
-    threads.reserve(count);
-    for (std::size_t i = 0; i < count; ++i) {
-        threads.emplace_back([this, i]() {
-            platform::setCurrentThreadName(std::string{ "Worker " } + util::toString(i + 1));
+ThreadPool::ThreadPool(std::size_t count, Strategy strategy_)
+    : ThreadPool(count, strategy_, Options()) {
+}
 
-            while (true) {
-                std::unique_lock<std::mutex> lock(mutex);
+ThreadPool::ThreadPool(std::size_t count, Strategy strategy_, Options options)
+    : strategy(strategy_),
+      defaultGroup(std::make_unique<Group>(*this)) {
+    if (strategy == Strategy::WorkStealing) {
+        workers.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            workers.emplace_back(std::make_unique<Worker>(*this, i));
+        }
+    }
 
-                cv.wait(lock, [this] {
-                    return !queue.empty() || terminate;
-                });
+    threads.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        threads.emplace_back([this, i, options]() {
+            platform::setCurrentThreadName(options.namePrefix + util::toString(i + 1));
 
-                if (terminate) {
-                    return;
-                }
+            if (!options.affinity.empty()) {
+                platform::setCurrentThreadAffinity(options.affinity[i % options.affinity.size()]);
+            }
 
-                auto mailbox = queue.front();
-                queue.pop();
-                lock.unlock();
+            if (options.niceness != 0) {
+                platform::setCurrentThreadPriority(options.niceness);
+            }
 
-                Mailbox::maybeReceive(mailbox);
+            if (strategy == Strategy::WorkStealing) {
+                runWorkStealing(*workers[i]);
+            } else {
+                runSharedQueue();
             }
         });
     }
@@ -43,15 +55,288 @@ ThreadPool::~ThreadPool() {
     for (auto& thread : threads) {
         thread.join();
     }
+
+    // The default group refers to the queue state, which is destroyed before it.
+    defaultGroup.reset();
 }
 
 void ThreadPool::schedule(std::weak_ptr<Mailbox> mailbox) {
+    schedule(*defaultGroup, std::move(mailbox));
+}
+
+void ThreadPool::schedule(Group& group, std::weak_ptr<Mailbox> mailbox) {
+    auto locked = mailbox.lock();
+    if (!locked) {
+        return;
+    }
+
+    const Mailbox::Priority priority = locked->getPriority();
+    locked.reset();
+
+    if (strategy == Strategy::SharedQueue) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            group.queue.push(priority, std::move(mailbox));
+            ++group.scheduled;
+            if (!group.isReady) {
+                group.isReady = true;
+                ready.push_back(&group);
+            }
+            ++queued;
+            if (stats.isEnabled()) {
+                stats.recordQueueDepth(queued);
+            }
+        }
+
+        cv.notify_one();
+        return;
+    }
+
+    // Prefer the deque of the calling thread when it is one of ours: a mailbox that
+    // reschedules itself after receiving then stays warm on the same thread.
+    Worker* worker = currentWorker().get();
+    if (!worker || &worker->pool != this) {
+        worker = workers[nextWorker++ % workers.size()].get();
+    }
+
     {
-        std::lock_guard<std::mutex> lock(mutex);
-        queue.push(mailbox);
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->queue.push(priority, std::move(mailbox));
+    }
+
+    // Wake a sleeping thread, if any. Sleepers increment `sleeping` before checking
+    // `pending` under `mutex`, so either they see this item or we see them.
+    const std::size_t depth = ++pending;
+    if (stats.isEnabled()) {
+        stats.recordQueueDepth(depth);
     }
 
-    cv.notify_one();
+    if (sleeping > 0) {
+        { std::lock_guard<std::mutex> lock(mutex); }
+        cv.notify_one();
+    }
+}
+
+util::ThreadLocal<ThreadPool::Worker>& ThreadPool::currentWorker() {
+    static util::ThreadLocal<Worker>& current = *new util::ThreadLocal<Worker>;
+    return current;
+}
+
+void ThreadPool::runSharedQueue() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        std::weak_ptr<Mailbox> mailbox;
+        Group* group = nullptr;
+
+        // A group may have pending mailboxes yet be saturated; it is then picked up by
+        // one of its running threads when that thread comes back here.
+        cv.wait(lock, [&] {
+            return terminate || popFair(mailbox, group);
+        });
+
+        if (terminate) {
+            return;
+        }
+
+        lock.unlock();
+        const TimePoint start = Clock::now();
+        Mailbox::maybeReceive(std::move(mailbox));
+        const Duration elapsed = Clock::now() - start;
+        lock.lock();
+
+        group->busy += elapsed;
+        if (--group->running == 0 && group->closing) {
+            idle.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::popFair(std::weak_ptr<Mailbox>& mailbox, Group*& group) {
+    for (auto it = ready.begin(); it != ready.end(); ++it) {
+        Group& candidate = **it;
+        if (candidate.saturated()) {
+            continue;
+        }
+
+        if (candidate.deficit == 0) {
+            candidate.deficit = std::max<std::size_t>(candidate.quota.weight, 1);
+        }
+
+        candidate.queue.popFront(mailbox);
+        --candidate.deficit;
+        ++candidate.running;
+        ++candidate.turns;
+        --queued;
+
+        // Leave the ring when empty; go to the back of it once the quantum is spent.
+        if (candidate.queue.empty()) {
+            candidate.deficit = 0;
+            candidate.isReady = false;
+            ready.erase(it);
+        } else if (candidate.deficit == 0) {
+            ready.erase(it);
+            ready.push_back(&candidate);
+        }
+
+        group = &candidate;
+        return true;
+    }
+
+    return false;
+}
+
+void ThreadPool::runWorkStealing(Worker& worker) {
+    currentWorker().set(&worker);
+
+    std::weak_ptr<Mailbox> mailbox;
+    while (!terminate) {
+        if (pop(worker, mailbox) || steal(worker, mailbox)) {
+            --pending;
+            Mailbox::maybeReceive(std::move(mailbox));
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        ++sleeping;
+        cv.wait(lock, [this] {
+            return pending > 0 || terminate;
+        });
+        --sleeping;
+    }
+
+    currentWorker().set(nullptr);
+}
+
+bool ThreadPool::pop(Worker& worker, std::weak_ptr<Mailbox>& mailbox) {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    return worker.queue.popFront(mailbox);
+}
+
+bool ThreadPool::steal(Worker& thief, std::weak_ptr<Mailbox>& mailbox) {
+    const std::size_t count = workers.size();
+    if (count < 2) {
+        return false;
+    }
+
+    // Start at a random victim and sweep all others once.
+    const std::size_t start = thief.random() % count;
+    for (std::size_t i = 0; i < count; ++i) {
+        Worker& victim = *workers[(start + i) % count];
+        if (&victim == &thief) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (lock && victim.queue.popBack(mailbox)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+ThreadPool::Group::Group(ThreadPool& pool_)
+    : Group(pool_, Quota()) {
+}
+
+ThreadPool::Group::Group(ThreadPool& pool_, Quota quota_)
+    : pool(pool_), quota(quota_) {
+}
+
+ThreadPool::Group::~Group() {
+    std::unique_lock<std::mutex> lock(pool.mutex);
+
+    if (isReady) {
+        pool.queued -= queue.size();
+        pool.ready.erase(std::find(pool.ready.begin(), pool.ready.end(), this));
+        isReady = false;
+    }
+
+    closing = true;
+    pool.idle.wait(lock, [this] {
+        return running == 0;
+    });
+}
+
+void ThreadPool::Group::schedule(std::weak_ptr<Mailbox> mailbox) {
+    pool.schedule(*this, std::move(mailbox));
+}
+
+void ThreadPool::Group::setQuota(Quota quota_) {
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        quota = quota_;
+    }
+
+    // A higher thread limit may let sleeping threads take this group's mailboxes.
+    pool.cv.notify_all();
+}
+
+std::size_t ThreadPool::Group::getConcurrency() const {
+    const std::size_t threads = pool.getConcurrency();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    return quota.maxThreads != 0 ? std::min(quota.maxThreads, threads) : threads;
+}
+
+ThreadPool::Group::Quota ThreadPool::Group::getQuota() const {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    return quota;
+}
+
+ThreadPool::Group::Usage ThreadPool::Group::getUsage() const {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+
+    Usage usage;
+    usage.scheduled = scheduled;
+    usage.turns = turns;
+    usage.queued = queue.size();
+    usage.running = running;
+    usage.busy = busy;
+    return usage;
+}
+
+bool ThreadPool::Lanes::empty() const {
+    for (const auto& lane : lanes) {
+        if (!lane.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t ThreadPool::Lanes::size() const {
+    std::size_t result = 0;
+    for (const auto& lane : lanes) {
+        result += lane.size();
+    }
+    return result;
+}
+
+void ThreadPool::Lanes::push(Mailbox::Priority priority, std::weak_ptr<Mailbox> mailbox) {
+    lanes[static_cast<std::size_t>(priority)].push_back(std::move(mailbox));
+}
+
+bool ThreadPool::Lanes::popFront(std::weak_ptr<Mailbox>& mailbox) {
+    for (auto it = lanes.rbegin(); it != lanes.rend(); ++it) {
+        if (!it->empty()) {
+            mailbox = std::move(it->front());
+            it->pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::Lanes::popBack(std::weak_ptr<Mailbox>& mailbox) {
+    for (auto it = lanes.rbegin(); it != lanes.rend(); ++it) {
+        if (!it->empty()) {
+            mailbox = std::move(it->back());
+            it->pop_back();
+            return true;
+        }
+    }
+    return false;
 }
 
 } // namespace mbgl
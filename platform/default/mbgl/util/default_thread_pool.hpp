@@ -1,27 +1,220 @@
 #pragma once
 
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/actor/scheduler_stats.hpp>
+#include <mbgl/util/chrono.hpp>
 
+#include <array>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <random>
+#include <string>
 #include <thread>
+#include <vector>
 
 namespace mbgl {
 
+namespace util {
+template <class> class ThreadLocal;
+} // namespace util
+
+/*
+    `ThreadPool` is the default `Scheduler` for worker actors. It supports two
+    strategies for distributing mailboxes over its threads:
+
+    * `SharedQueue` keeps a single FIFO queue behind one mutex. It is simple and
+      fair, but every `schedule` call and every dequeue contends on the same lock.
+
+    * `WorkStealing` gives every thread its own deque. Mailboxes scheduled from
+      a pool thread go to that thread's deque; mailboxes scheduled from outside
+      the pool are distributed round-robin. Idle threads steal from the tail of
+      a randomly chosen victim before going to sleep.
+
+    With either strategy, mailboxes are kept in one FIFO lane per `Mailbox::Priority`,
+    and higher-priority lanes are drained first.
+
+    Both strategies preserve the per-mailbox guarantees described in `Scheduler`:
+    a mailbox is only ever enqueued once at a time, so it is never received on two
+    threads concurrently, and its messages are processed in order.
+
+    Several `Map`s may share one pool. To keep a map with a heavy style from
+    monopolising the threads, give each map its own `ThreadPool::Group` and pass the
+    group as the map's scheduler. With `SharedQueue`, groups are served by deficit
+    round-robin: each group with pending mailboxes receives up to `weight` mailbox
+    turns before the next group is served, and never occupies more than `maxThreads`
+    threads at once. Mailboxes scheduled on the pool itself belong to an implicit
+    default group of weight 1. `WorkStealing` does not partition by group; its groups
+    only forward to the pool.
+*/
+
 class ThreadPool : public Scheduler {
 public:
-    ThreadPool(std::size_t count);
+    enum class Strategy : bool {
+        SharedQueue,
+        WorkStealing
+    };
+
+    struct Options {
+        // Threads are named `namePrefix` followed by their 1-based index, so that profilers
+        // such as perf and systrace attribute time to them. Names are truncated to 15
+        // characters on Linux and Android.
+        std::string namePrefix = "Worker ";
+
+        // CPU affinity masks (bit i selects CPU i). Thread i is pinned to
+        // `affinity[i % affinity.size()]`; an empty vector leaves threads unpinned. Not
+        // supported on Darwin, where it is ignored.
+        std::vector<uint64_t> affinity;
+
+        // Scheduling priority as a nice value from -20 (highest) to 19 (lowest). On Darwin,
+        // it is mapped onto the closest QoS class.
+        int niceness = 0;
+    };
+
+    class Group;
+
+    ThreadPool(std::size_t count, Strategy = Strategy::SharedQueue);
+    ThreadPool(std::size_t count, Strategy, Options);
     ~ThreadPool() override;
 
     void schedule(std::weak_ptr<Mailbox>) override;
 
+    // Stats are disabled by default; enable them with `getStats()->setEnabled(true)`.
+    SchedulerStats* getStats() override {
+        return &stats;
+    }
+
+    std::size_t getConcurrency() const override {
+        return threads.size();
+    }
+
 private:
+    class Lanes {
+    public:
+        bool empty() const;
+        std::size_t size() const;
+        void push(Mailbox::Priority, std::weak_ptr<Mailbox>);
+
+        // Both take from the highest-priority non-empty lane.
+        bool popFront(std::weak_ptr<Mailbox>&);
+        bool popBack(std::weak_ptr<Mailbox>&);
+
+    private:
+        std::array<std::deque<std::weak_ptr<Mailbox>>, 3> lanes;
+    };
+
+    void schedule(Group&, std::weak_ptr<Mailbox>);
+
+    // Takes the next mailbox in deficit round-robin order. Must be called with `mutex` held.
+    bool popFair(std::weak_ptr<Mailbox>&, Group*&);
+
+    struct Worker {
+        Worker(ThreadPool& pool_, std::size_t index_)
+            : pool(pool_), index(index_), random(index_ + 1) {}
+
+        ThreadPool& pool;
+        const std::size_t index;
+        std::minstd_rand random;
+
+        std::mutex mutex;
+        Lanes queue;
+    };
+
+    // The work-stealing worker owned by the current thread, if any.
+    static util::ThreadLocal<Worker>& currentWorker();
+
+    void runSharedQueue();
+    void runWorkStealing(Worker&);
+
+    bool pop(Worker&, std::weak_ptr<Mailbox>&);
+    bool steal(Worker&, std::weak_ptr<Mailbox>&);
+
+    const Strategy strategy;
+    SchedulerStats stats;
     std::vector<std::thread> threads;
-    std::queue<std::weak_ptr<Mailbox>> queue;
+
+    // SharedQueue state. The mutex and condition variable are also used by
+    // WorkStealing to put idle threads to sleep.
+    std::unique_ptr<Group> defaultGroup;
+    std::deque<Group*> ready;
+    std::size_t queued = 0;
     std::mutex mutex;
     std::condition_variable cv;
-    bool terminate { false };
+    std::condition_variable idle;
+    std::atomic<bool> terminate { false };
+
+    // WorkStealing state.
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<std::size_t> pending { 0 };
+    std::atomic<std::size_t> sleeping { 0 };
+    std::atomic<std::size_t> nextWorker { 0 };
+};
+
+/*
+    A `Scheduler` that shares the threads of a `ThreadPool` with the pool's other
+    groups, typically one per `Map`. A group must be destroyed before its pool, and not
+    from one of the pool's threads; destruction waits for mailbox turns of the group
+    that are in progress.
+*/
+class ThreadPool::Group : public Scheduler {
+public:
+    struct Quota {
+        // Mailbox turns this group may take per round while other groups are waiting.
+        std::size_t weight = 1;
+
+        // Maximum number of threads receiving this group's mailboxes at once; 0 is unlimited.
+        std::size_t maxThreads = 0;
+    };
+
+    struct Usage {
+        uint64_t scheduled = 0;
+        uint64_t turns = 0;
+        std::size_t queued = 0;
+        std::size_t running = 0;
+        Duration busy = Duration::zero();
+    };
+
+    Group(ThreadPool&);
+    Group(ThreadPool&, Quota);
+    ~Group() override;
+
+    void schedule(std::weak_ptr<Mailbox>) override;
+
+    SchedulerStats* getStats() override {
+        return pool.getStats();
+    }
+
+    // The pool's thread count, capped by `Quota::maxThreads`.
+    std::size_t getConcurrency() const override;
+
+    void setQuota(Quota);
+    Quota getQuota() const;
+
+    // Only maintained with `Strategy::SharedQueue`.
+    Usage getUsage() const;
+
+private:
+    friend class ThreadPool;
+
+    bool saturated() const {
+        return quota.maxThreads != 0 && running >= quota.maxThreads;
+    }
+
+    ThreadPool& pool;
+
+    // All guarded by `pool.mutex`.
+    Quota quota;
+    Lanes queue;
+    std::size_t deficit = 0;
+    std::size_t running = 0;
+    bool isReady = false;
+    bool closing = false;
+    uint64_t scheduled = 0;
+    uint64_t turns = 0;
+    Duration busy = Duration::zero();
 };
 
 } // namespace mbgl
@@ -0,0 +1,139 @@
+#include <mbgl/storage/mbtiles_file_source.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/thread.hpp>
+#include <mbgl/util/url.hpp>
+
+#include "sqlite3.hpp"
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <cstdlib>
+#include <unordered_map>
+
+namespace {
+
+const char* protocol = "mbtiles://";
+const std::size_t protocolLength = 10;
+
+// Tiles are read through a memory map of the file, up to this size.
+const char* mmapPragma = "PRAGMA mmap_size = 268435456";
+
+} // namespace
+
+namespace mbgl {
+
+class MBTilesFileSource::Impl {
+public:
+    void request(const Resource& resource, FileSource::Callback callback) {
+        Response response;
+
+        try {
+            if (resource.kind == Resource::Kind::Tile && resource.tileData) {
+                // Tile URLs are the URL of the file, followed by `/{z}/{x}/{y}`.
+                std::string url = resource.url;
+                for (int i = 0; i < 3 && url.rfind('/') != std::string::npos; i++) {
+                    url.erase(url.rfind('/'));
+                }
+                getTile(database(url), *resource.tileData, response);
+            } else {
+                getTileJSON(database(resource.url), resource.url, response);
+            }
+        } catch (const mapbox::sqlite::Exception& ex) {
+            response.error = std::make_unique<Response::Error>(
+                ex.code == mapbox::sqlite::Exception::Code::CANTOPEN ? Response::Error::Reason::NotFound
+                                                                      : Response::Error::Reason::Other,
+                ex.what());
+        } catch (...) {
+            response.error = std::make_unique<Response::Error>(
+                Response::Error::Reason::Other,
+                util::toString(std::current_exception()));
+        }
+
+        callback(response);
+    }
+
+private:
+    mapbox::sqlite::Database& database(const std::string& url) {
+        auto it = databases.find(url);
+        if (it == databases.end()) {
+            const std::string path = util::percentDecode(url.substr(protocolLength));
+            auto db = std::make_unique<mapbox::sqlite::Database>(path, mapbox::sqlite::ReadOnly);
+            db->exec(mmapPragma);
+            it = databases.emplace(url, std::move(db)).first;
+        }
+        return *it->second;
+    }
+
+    static void getTile(mapbox::sqlite::Database& db, const Resource::TileData& tile, Response& response) {
+        mapbox::sqlite::Statement stmt = db.prepare(
+            "SELECT tile_data FROM tiles "
+            "WHERE zoom_level = ?1 AND tile_column = ?2 AND tile_row = ?3");
+        stmt.bind(1, tile.z);
+        stmt.bind(2, tile.x);
+        // MBTiles rows are numbered from the bottom.
+        stmt.bind(3, (1 << tile.z) - 1 - tile.y);
+
+        if (stmt.run()) {
+            response.data = std::make_shared<std::string>(stmt.get<std::string>(0));
+        } else {
+            response.noContent = true;
+        }
+    }
+
+    static void getTileJSON(mapbox::sqlite::Database& db, const std::string& url, Response& response) {
+        std::unordered_map<std::string, std::string> metadata;
+        mapbox::sqlite::Statement stmt = db.prepare("SELECT name, value FROM metadata");
+        while (stmt.run()) {
+            metadata.emplace(stmt.get<std::string>(0), stmt.get<std::string>(1));
+        }
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        writer.StartObject();
+        writer.Key("tilejson");
+        writer.String("2.1.0");
+        writer.Key("scheme");
+        writer.String("xyz");
+        writer.Key("tiles");
+        writer.StartArray();
+        writer.String(url + "/{z}/{x}/{y}");
+        writer.EndArray();
+        for (const char* key : { "minzoom", "maxzoom" }) {
+            auto it = metadata.find(key);
+            if (it != metadata.end()) {
+                writer.Key(key);
+                writer.Int(std::atoi(it->second.c_str()));
+            }
+        }
+        for (const char* key : { "name", "attribution" }) {
+            auto it = metadata.find(key);
+            if (it != metadata.end()) {
+                writer.Key(key);
+                writer.String(it->second);
+            }
+        }
+        writer.EndObject();
+
+        response.data = std::make_shared<std::string>(buffer.GetString(), buffer.GetSize());
+    }
+
+    std::unordered_map<std::string, std::unique_ptr<mapbox::sqlite::Database>> databases;
+};
+
+MBTilesFileSource::MBTilesFileSource()
+    : thread(std::make_unique<util::Thread<Impl>>(util::ThreadContext{"MBTilesFileSource", util::ThreadPriority::Low})) {
+}
+
+MBTilesFileSource::~MBTilesFileSource() = default;
+
+std::unique_ptr<AsyncRequest> MBTilesFileSource::request(const Resource& resource, Callback callback) {
+    return thread->invokeWithCallback(&Impl::request, resource, callback);
+}
+
+bool MBTilesFileSource::acceptsURL(const std::string& url) {
+    return url.compare(0, protocolLength, protocol) == 0;
+}
+
+} // namespace mbgl
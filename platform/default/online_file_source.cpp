@@ -1,6 +1,8 @@
 #include <mbgl/storage/online_file_source.hpp>
 #include <mbgl/storage/http_file_source.hpp>
 #include <mbgl/storage/network_status.hpp>
+#include <mbgl/storage/concurrency_limit.hpp>
+#include <mbgl/storage/file_source_stats_recorder.hpp>
 
 #include <mbgl/storage/response.hpp>
 #include <mbgl/util/logging.hpp>
@@ -16,13 +18,32 @@
 #include <mbgl/util/http_timeout.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <list>
+#include <memory>
+#include <string>
 #include <unordered_set>
 #include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
+class OnlineFileRequest;
+
+// An HTTP request, shared by the active requests for the same resource.
+struct OnlineFetch {
+    std::string key;
+    Resource::Kind kind;
+    std::unique_ptr<AsyncRequest> request;
+    TimePoint started;
+
+    // Cancelled requests are set to null, since they may be cancelled while the response
+    // is handed out.
+    std::vector<OnlineFileRequest*> requests;
+    std::size_t subscribers = 0;
+};
+
 class OnlineFileRequest : public AsyncRequest {
 public:
     using Callback = std::function<void (Response)>;
@@ -38,6 +59,8 @@ public:
     OnlineFileSource::Impl& impl;
     Resource resource;
     std::unique_ptr<AsyncRequest> request;
+    OnlineFetch* fetch = nullptr;
+    TimePoint queued;
     util::Timer timer;
     Callback callback;
 
@@ -55,7 +78,8 @@ public:
 
 class OnlineFileSource::Impl {
 public:
-    Impl() {
+    explicit Impl(std::shared_ptr<FileSourceStatsRecorder> stats_)
+        : stats(std::move(stats_)) {
         NetworkStatus::Subscribe(&reachability);
     }
 
@@ -82,24 +106,32 @@ public:
 
     void remove(OnlineFileRequest* request) {
         allRequests.erase(request);
-        if (activeRequests.erase(request)) {
-            activatePendingRequest();
+        if (request->fetch) {
+            unsubscribe(request);
         } else {
             auto it = pendingRequestsMap.find(request);
             if (it != pendingRequestsMap.end()) {
-                pendingRequestsList.erase(it->second);
+                pendingRequests(request->resource.priority).erase(it->second);
                 pendingRequestsMap.erase(it);
             }
         }
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
+        assert(pendingRequestsMap.size() == pendingRequestCount());
     }
 
     void activateOrQueueRequest(OnlineFileRequest* request) {
         assert(allRequests.find(request) != allRequests.end());
-        assert(activeRequests.find(request) == activeRequests.end());
+        assert(!request->fetch);
         assert(!request->request);
 
-        if (activeRequests.size() >= HTTPFileSource::maximumConcurrentRequests()) {
+        // Joining a request in progress doesn't take up another connection.
+        auto it = fetches.find(fetchKey(request->resource));
+        if (it != fetches.end()) {
+            stats->record(request->resource.kind, [] (auto& counters) {
+                counters.networkRequests++;
+                counters.sharedRequests++;
+            });
+            subscribe(request, *it->second);
+        } else if (fetches.size() >= concurrency.get()) {
             queueRequest(request);
         } else {
             activateRequest(request);
@@ -107,34 +139,90 @@ public:
     }
 
     void queueRequest(OnlineFileRequest* request) {
-        auto it = pendingRequestsList.insert(pendingRequestsList.end(), request);
+        request->queued = Clock::now();
+        auto& list = pendingRequests(request->resource.priority);
+        auto it = list.insert(list.end(), request);
         pendingRequestsMap.emplace(request, std::move(it));
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
+        assert(pendingRequestsMap.size() == pendingRequestCount());
     }
 
     void activateRequest(OnlineFileRequest* request) {
-        activeRequests.insert(request);
-        request->request = httpFileSource.request(request->resource, [=] (Response response) {
-            activeRequests.erase(request);
-            activatePendingRequest();
-            request->request.reset();
-            request->completed(response);
+        const std::string key = fetchKey(request->resource);
+        OnlineFetch& fetch = *fetches.emplace(key, std::make_unique<OnlineFetch>()).first->second;
+        fetch.key = key;
+        fetch.kind = request->resource.kind;
+        subscribe(request, fetch);
+        stats->record(fetch.kind, [] (auto& counters) { counters.networkRequests++; });
+
+        fetch.started = Clock::now();
+        fetch.request = httpFileSource.request(request->resource, [this, &fetch] (Response response) {
+            // Requests made from here on start a new fetch.
+            auto it = fetches.find(fetch.key);
+            std::unique_ptr<OnlineFetch> done = std::move(it->second);
+            fetches.erase(it);
+
+            const Duration latency = Clock::now() - done->started;
+            stats->record(done->kind, [&] (auto& counters) {
+                counters.activeTime += latency;
+                if (response.notModified) {
+                    counters.notModified++;
+                }
+                if (response.data) {
+                    counters.bytes += response.data->size();
+                }
+            });
+
+            // Failures, e.g. timeouts, say nothing about how fast the network is.
+            if (!response.error) {
+                concurrency.sample(latency);
+            }
+            activatePendingRequests();
+
+            // Completing a request may delete any of the others, which then unsubscribe.
+            for (std::size_t i = 0; i < done->requests.size(); ++i) {
+                OnlineFileRequest* subscriber = done->requests[i];
+                if (subscriber) {
+                    done->requests[i] = nullptr;
+                    done->subscribers--;
+                    subscriber->fetch = nullptr;
+                    subscriber->completed(response);
+                }
+            }
         });
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
+        assert(pendingRequestsMap.size() == pendingRequestCount());
     }
 
-    void activatePendingRequest() {
-        if (pendingRequestsList.empty()) {
-            return;
-        }
-
-        OnlineFileRequest* request = pendingRequestsList.front();
-        pendingRequestsList.pop_front();
-
-        pendingRequestsMap.erase(request);
+    void activatePendingRequests() {
+        while (fetches.size() < concurrency.get()) {
+            // The oldest of the requests with the highest priority goes first.
+            auto list = std::find_if(pendingRequestsLists.rbegin(), pendingRequestsLists.rend(),
+                                     [] (const auto& requests) { return !requests.empty(); });
+            if (list == pendingRequestsLists.rend()) {
+                break;
+            }
 
-        activateRequest(request);
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
+            OnlineFileRequest* request = list->front();
+            list->pop_front();
+
+            pendingRequestsMap.erase(request);
+
+            const Duration waited = Clock::now() - request->queued;
+            auto it = fetches.find(fetchKey(request->resource));
+            stats->record(request->resource.kind, [&] (auto& counters) {
+                counters.pendingTime += waited;
+                if (it != fetches.end()) {
+                    counters.networkRequests++;
+                    counters.sharedRequests++;
+                }
+            });
+
+            if (it != fetches.end()) {
+                subscribe(request, *it->second);
+            } else {
+                activateRequest(request);
+            }
+        }
+        assert(pendingRequestsMap.size() == pendingRequestCount());
     }
 
     bool isPending(OnlineFileRequest* request) {
@@ -142,14 +230,77 @@ public:
     }
 
     bool isActive(OnlineFileRequest* request) {
-        return activeRequests.find(request) != activeRequests.end();
+        return request->fetch != nullptr;
+    }
+
+    void setPriority(OnlineFileRequest* request, Resource::Priority priority) {
+        if (priority == request->resource.priority) {
+            return;
+        }
+
+        // A pending request moves to the back of the requests with its new priority.
+        auto it = pendingRequestsMap.find(request);
+        if (it != pendingRequestsMap.end()) {
+            pendingRequests(request->resource.priority).erase(it->second);
+            auto& list = pendingRequests(priority);
+            it->second = list.insert(list.end(), request);
+        }
+        request->resource.priority = priority;
     }
 
     void setResourceTransform(ResourceTransform&& transform) {
         resourceTransform = std::move(transform);
     }
 
+    const std::shared_ptr<FileSourceStatsRecorder> stats;
+
 private:
+    // Requests share a fetch only when they would send the same HTTP request: a revalidation
+    // may be answered with "304 Not Modified", which only means something to its own request.
+    static std::string fetchKey(const Resource& resource) {
+        std::string key = resource.url;
+        if (resource.priorEtag) {
+            key += "\netag:" + *resource.priorEtag;
+        }
+        if (resource.priorModified) {
+            key += "\nmodified:" + std::to_string(resource.priorModified->time_since_epoch().count());
+        }
+        return key;
+    }
+
+    std::list<OnlineFileRequest*>& pendingRequests(Resource::Priority priority) {
+        return pendingRequestsLists[priority];
+    }
+
+    std::size_t pendingRequestCount() const {
+        std::size_t count = 0;
+        for (const auto& list : pendingRequestsLists) {
+            count += list.size();
+        }
+        return count;
+    }
+
+    void subscribe(OnlineFileRequest* request, OnlineFetch& fetch) {
+        request->fetch = &fetch;
+        fetch.requests.push_back(request);
+        fetch.subscribers++;
+    }
+
+    // The HTTP request is only cancelled along with the last request sharing it.
+    void unsubscribe(OnlineFileRequest* request) {
+        OnlineFetch& fetch = *request->fetch;
+        request->fetch = nullptr;
+        std::replace(fetch.requests.begin(), fetch.requests.end(), request, static_cast<OnlineFileRequest*>(nullptr));
+
+        if (--fetch.subscribers == 0) {
+            auto it = fetches.find(fetch.key);
+            if (it != fetches.end() && it->second.get() == &fetch) {
+                fetches.erase(it);
+                activatePendingRequests();
+            }
+        }
+    }
+
     void networkIsReachableAgain() {
         for (auto& request : allRequests) {
             request->networkIsReachableAgain();
@@ -162,24 +313,37 @@ private:
      * The lifetime of a request is:
      *
      * 1. Waiting for timeout (revalidation or retry)
-     * 2. Pending (waiting for room in the active set)
-     * 3. Active (open network connection)
+     * 2. Pending (waiting for room in the active set, by priority)
+     * 3. Active (subscribed to an open network connection)
      * 4. Back to #1
      *
-     * Requests in any state are in `allRequests`. Requests in the pending state are in
-     * `pendingRequests`. Requests in the active state are in `activeRequests`.
+     * Requests in any state are in `allRequests`. Requests in the pending state are in the
+     * `pendingRequestsLists` entry for their priority. Requests in the active state have a
+     * `fetch`, which is in `fetches` until its response arrives. The number of fetches is
+     * what's limited, so identical requests made at the same time, e.g. by several maps,
+     * share a single connection. The limit adapts to the latency of the responses, starting
+     * from the one of the HTTP file source.
      */
     std::unordered_set<OnlineFileRequest*> allRequests;
-    std::list<OnlineFileRequest*> pendingRequestsList;
+    std::array<std::list<OnlineFileRequest*>, Resource::Highest + 1> pendingRequestsLists;
     std::unordered_map<OnlineFileRequest*, std::list<OnlineFileRequest*>::iterator> pendingRequestsMap;
-    std::unordered_set<OnlineFileRequest*> activeRequests;
+    std::unordered_map<std::string, std::unique_ptr<OnlineFetch>> fetches;
+    ConcurrencyLimit concurrency {
+        HTTPFileSource::maximumConcurrentRequests(),
+        std::max(HTTPFileSource::maximumConcurrentRequests() / 4, 1u),
+        HTTPFileSource::maximumConcurrentRequests() * 4
+    };
 
     HTTPFileSource httpFileSource;
     util::AsyncTask reachability { std::bind(&Impl::networkIsReachableAgain, this) };
 };
 
 OnlineFileSource::OnlineFileSource()
-    : impl(std::make_unique<Impl>()) {
+    : OnlineFileSource(std::make_shared<FileSourceStatsRecorder>()) {
+}
+
+OnlineFileSource::OnlineFileSource(std::shared_ptr<FileSourceStatsRecorder> stats)
+    : impl(std::make_unique<Impl>(std::move(stats))) {
 }
 
 OnlineFileSource::~OnlineFileSource() = default;
@@ -216,6 +380,14 @@ std::unique_ptr<AsyncRequest> OnlineFileSource::request(const Resource& resource
     return std::make_unique<OnlineFileRequest>(std::move(res), std::move(callback), *impl);
 }
 
+void OnlineFileSource::setPriority(AsyncRequest& req, Resource::Priority priority) {
+    impl->setPriority(&static_cast<OnlineFileRequest&>(req), priority);
+}
+
+FileSourceStats OnlineFileSource::getStats() const {
+    return impl->stats->snapshot();
+}
+
 void OnlineFileSource::setResourceTransform(ResourceTransform&& transform) {
     impl->setResourceTransform(std::move(transform));
 }
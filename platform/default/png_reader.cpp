@@ -62,7 +62,7 @@ struct png_struct_guard {
     png_infopp i_;
 };
 
-PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
+void decodeUnassociatedPNG(const uint8_t* data, size_t size, UnassociatedImage& image) {
     util::CharArrayBuffer dataBuffer { reinterpret_cast<const char*>(data), size };
     std::istream stream(&dataBuffer);
 
@@ -98,7 +98,9 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
     int color_type = 0;
     png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, nullptr, nullptr, nullptr);
 
-    UnassociatedImage image({ width, height });
+    if (image.size != Size(width, height) || !image.data) {
+        image = UnassociatedImage({ width, height });
+    }
 
     if (color_type == PNG_COLOR_TYPE_PALETTE)
         png_set_expand(png_ptr);
@@ -118,25 +120,19 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
 
     png_set_add_alpha(png_ptr, 0xff, PNG_FILLER_AFTER);
 
-    if (png_get_interlace_type(png_ptr,info_ptr) == PNG_INTERLACE_ADAM7) {
-        png_set_interlace_handling(png_ptr); // FIXME: libpng bug?
-        // according to docs png_read_image
-        // "..automatically handles interlacing,
-        // so you don't need to call png_set_interlace_handling()"
-    }
+    // Interlaced images are read in several passes over the rows.
+    const int passes = png_set_interlace_handling(png_ptr);
 
     png_read_update_info(png_ptr, info_ptr);
 
-    // we can read whole image at once
-    // alloc row pointers
-    const std::unique_ptr<png_bytep[]> rows(new png_bytep[height]);
-    for (unsigned row = 0; row < height; ++row)
-        rows[row] = image.data.get() + row * width * 4;
-    png_read_image(png_ptr, rows.get());
+    // Rows are read one at a time, straight into the image.
+    for (int pass = 0; pass < passes; ++pass) {
+        for (png_uint_32 row = 0; row < height; ++row) {
+            png_read_row(png_ptr, image.data.get() + row * width * 4, nullptr);
+        }
+    }
 
     png_read_end(png_ptr, nullptr);
-
-    return util::premultiply(std::move(image));
 }
 
 } // namespace mbgl
@@ -5,6 +5,9 @@
 
 #include <pthread.h>
 #include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 namespace mbgl {
 namespace platform {
@@ -33,5 +36,30 @@ void makeThreadLowPriority() {
     }
 }
 
+void setCurrentThreadPriority(int niceness) {
+    // On Linux, the nice value is a per-thread attribute when addressed by thread ID.
+    const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+    if (setpriority(PRIO_PROCESS, tid, niceness) != 0) {
+        Log::Warning(Event::General, "Couldn't set thread priority");
+    }
+}
+
+bool setCurrentThreadAffinity(uint64_t cpuMask) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; ++cpu) {
+        if (cpuMask & (uint64_t(1) << cpu)) {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        Log::Warning(Event::General, "Couldn't set thread affinity");
+        return false;
+    }
+
+    return true;
+}
+
 } // namespace platform
 } // namespace mbgl
@@ -9,22 +9,47 @@ extern "C"
 
 namespace mbgl {
 
-PremultipliedImage decodeWebP(const uint8_t* data, size_t size) {
-    int width = 0, height = 0;
-    if (WebPGetInfo(data, size, &width, &height) == 0) {
+void decodeUnassociatedWebP(const uint8_t* data, size_t size, Size minimumSize, UnassociatedImage& image) {
+    WebPDecoderConfig config;
+    if (!WebPInitDecoderConfig(&config)) {
+        throw std::runtime_error("failed to initialize WebP decoder");
+    }
+
+    if (WebPGetFeatures(data, size, &config.input) != VP8_STATUS_OK) {
         throw std::runtime_error("failed to retrieve WebP basic header information");
     }
 
-    int stride = width * 4;
-    size_t webpSize = stride * height;
-    auto webp = std::make_unique<uint8_t[]>(webpSize);
+    // The decoder scales the image to any size; by powers of two, like JPEGs are.
+    uint32_t width = config.input.width;
+    uint32_t height = config.input.height;
+    while (minimumSize && (width + 1) / 2 >= minimumSize.width && (height + 1) / 2 >= minimumSize.height) {
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+    }
+    if (width != uint32_t(config.input.width) || height != uint32_t(config.input.height)) {
+        config.options.use_scaling = 1;
+        config.options.scaled_width = width;
+        config.options.scaled_height = height;
+    }
+
+    if (image.size != Size(width, height) || !image.data) {
+        image = UnassociatedImage({ width, height });
+    }
+
+    config.output.colorspace = MODE_RGBA;
+    config.output.u.RGBA.rgba = image.data.get();
+    config.output.u.RGBA.stride = width * 4;
+    config.output.u.RGBA.size = image.bytes();
+    config.output.is_external_memory = 1;
 
-    if (!WebPDecodeRGBAInto(data, size, webp.get(), webpSize, stride)) {
+    if (WebPDecode(data, size, &config) != VP8_STATUS_OK) {
         throw std::runtime_error("failed to decode WebP data");
     }
+}
 
-    UnassociatedImage image({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) },
-                            std::move(webp));
+PremultipliedImage decodeWebP(const uint8_t* data, size_t size) {
+    UnassociatedImage image;
+    decodeUnassociatedWebP(data, size, {}, image);
     return util::premultiply(std::move(image));
 }
 
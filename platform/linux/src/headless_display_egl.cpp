@@ -3,9 +3,77 @@
 #include <mbgl/util/string.hpp>
 
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
 
 namespace mbgl {
 
+namespace {
+
+bool hasExtension(const char* extensions, const char* name) {
+    const std::size_t length = std::strlen(name);
+    for (const char* it = extensions; (it = std::strstr(it, name)); it += length) {
+        if ((it == extensions || it[-1] == ' ') && (it[length] == ' ' || it[length] == '\0')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Prefers a display that needs neither a window system nor one running: a GPU picked by the
+// index in MBGL_EGL_DEVICE (the first one by default), or else Mesa's surfaceless platform.
+EGLDisplay getDisplay() {
+#if !__ANDROID__
+    const char* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (!extensions || !getPlatformDisplay) {
+        return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    if (hasExtension(extensions, "EGL_EXT_device_enumeration") &&
+        hasExtension(extensions, "EGL_EXT_platform_device")) {
+        auto queryDevices = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(
+            eglGetProcAddress("eglQueryDevicesEXT"));
+        EGLint count = 0;
+        if (queryDevices && queryDevices(0, nullptr, &count) && count > 0) {
+            std::vector<EGLDeviceEXT> devices(count);
+            queryDevices(count, devices.data(), &count);
+
+            const char* device = std::getenv("MBGL_EGL_DEVICE");
+            const EGLint index = device ? std::atoi(device) : 0;
+            if (index < 0 || index >= count) {
+                throw std::runtime_error("EGL device " + util::toString(index) + " doesn't exist; " +
+                                         util::toString(count) + " devices are available.\n");
+            }
+
+            EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_DEVICE_EXT, devices[index], nullptr);
+            if (display != EGL_NO_DISPLAY) {
+                return display;
+            }
+        }
+    }
+
+    if (hasExtension(extensions, "EGL_MESA_platform_surfaceless")) {
+        EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (display != EGL_NO_DISPLAY) {
+            return display;
+        }
+    }
+#endif // !__ANDROID__
+
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+} // namespace
+
 class HeadlessDisplay::Impl {
 public:
     Impl();
@@ -16,7 +84,7 @@ public:
 };
 
 HeadlessDisplay::Impl::Impl() {
-    display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    display = getDisplay();
     if (display == EGL_NO_DISPLAY) {
         throw std::runtime_error("Failed to obtain a valid EGL display.\n");
     }
@@ -36,7 +104,12 @@ HeadlessDisplay::Impl::Impl() {
         // Android emulator requires a pixel buffer to generate renderable unit
         // test results.
         EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+#else
+        // Contexts are made current without a surface, so any config will do, including those
+        // of GPU and surfaceless displays, which can't render to windows.
+        EGL_SURFACE_TYPE, 0,
 #endif // __ANDROID__
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
         EGL_NONE
     };
 
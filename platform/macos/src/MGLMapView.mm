@@ -804,14 +804,9 @@ public:
         return;
     }
 
-    CGFloat zoomFactor   = self.maximumZoomLevel - self.minimumZoomLevel + 1;
-    CGFloat cpuFactor    = [NSProcessInfo processInfo].processorCount;
-    CGFloat memoryFactor = (CGFloat)[NSProcessInfo processInfo].physicalMemory / 1000 / 1000 / 1000;
-    CGFloat sizeFactor   = (NSWidth(self.bounds) / mbgl::util::tileSize) * (NSHeight(self.bounds) / mbgl::util::tileSize);
-
-    NSUInteger cacheSize = zoomFactor * cpuFactor * memoryFactor * sizeFactor * 0.5;
-
-    _mbglMap->setSourceTileCacheSize(cacheSize);
+    // Each source keeps tiles for reuse in up to a sixty-fourth of the physical memory; the
+    // number of tiles is bounded by the view's size.
+    _mbglMap->setSourceTileCacheBudget([NSProcessInfo processInfo].physicalMemory / 64);
 }
 
 - (void)setNeedsGLDisplay {
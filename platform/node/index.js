@@ -3,9 +3,8 @@
 // Shim to wrap req.respond while preserving callback-passing API
 
 var mbgl = require('../../lib/mapbox_gl_native.node');
-var constructor = mbgl.Map.prototype.constructor;
 
-var Map = function(options) {
+function shimRequest(options) {
     if (!(options instanceof Object)) {
         throw TypeError("Requires an options object as first argument");
     }
@@ -16,16 +15,31 @@ var Map = function(options) {
 
     var request = options.request;
 
-    return new constructor(Object.assign(options, {
+    return Object.assign(options, {
         request: function(req) {
             request(req, function() {
                 req.respond.apply(req, arguments);
             });
         }
-    }));
+    });
+}
+
+var constructor = mbgl.Map.prototype.constructor;
+
+var Map = function(options) {
+    return new constructor(shimRequest(options));
 };
 
 Map.prototype = mbgl.Map.prototype;
 Map.prototype.constructor = Map;
 
-module.exports = Object.assign(mbgl, { Map: Map });
+var renderPoolConstructor = mbgl.RenderPool.prototype.constructor;
+
+var RenderPool = function(options) {
+    return new renderPoolConstructor(shimRequest(options));
+};
+
+RenderPool.prototype = mbgl.RenderPool.prototype;
+RenderPool.prototype.constructor = RenderPool;
+
+module.exports = Object.assign(mbgl, { Map: Map, RenderPool: RenderPool });
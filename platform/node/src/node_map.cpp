@@ -5,15 +5,20 @@
 #include "node_geojson.hpp"
 
 #include <mbgl/gl/headless_display.hpp>
+#include <mbgl/map/backend_scope.hpp>
 #include <mbgl/util/exception.hpp>
 #include <mbgl/style/conversion/source.hpp>
 #include <mbgl/style/conversion/layer.hpp>
 #include <mbgl/style/conversion/filter.hpp>
 #include <mbgl/sprite/sprite_image.cpp>
 #include <mbgl/map/query.hpp>
+#include <mbgl/util/premultiply.hpp>
 
 #include <unistd.h>
 
+#include <algorithm>
+#include <stdexcept>
+
 #if UV_VERSION_MAJOR == 0 && UV_VERSION_MINOR <= 10
 #define UV_ASYNC_PARAMS(handle) uv_async_t *handle, int
 #else
@@ -22,18 +27,6 @@
 
 namespace node_mbgl {
 
-struct NodeMap::RenderOptions {
-    double zoom = 0;
-    double bearing = 0;
-    double pitch = 0;
-    double latitude = 0;
-    double longitude = 0;
-    unsigned int width = 512;
-    unsigned int height = 512;
-    std::vector<std::string> classes;
-    mbgl::MapDebugOptions debugOptions = mbgl::MapDebugOptions::NoDebug;
-};
-
 Nan::Persistent<v8::Function> NodeMap::constructor;
 
 static std::shared_ptr<mbgl::HeadlessDisplay> sharedDisplay() {
@@ -45,6 +38,107 @@ static const char* releasedMessage() {
     return "Map resources have already been released";
 }
 
+// Hands `data` over to a new Buffer, which frees it once collected.
+static v8::Local<v8::Object> toBuffer(std::unique_ptr<uint8_t[]> data, std::size_t size) {
+    v8::Local<v8::Object> buffer = Nan::NewBuffer(
+        reinterpret_cast<char *>(data.get()), size,
+        [](char *, void * hint) {
+            delete [] reinterpret_cast<uint8_t*>(hint);
+        },
+        data.get()
+    ).ToLocalChecked();
+    data.release();
+    return buffer;
+}
+
+// Slices a rendered metatile into its images, and converts them to the requested format,
+// off the main thread.
+class NodeMap::ImageWorker : public Nan::AsyncWorker {
+public:
+    ImageWorker(Nan::Callback* callback_, mbgl::PremultipliedImage image_, uint32_t metatile_, RenderOptions::Format format_)
+        : AsyncWorker(callback_),
+          image(std::move(image_)),
+          metatile(metatile_),
+          format(format_) {
+    }
+
+    void Execute() override {
+        try {
+            std::vector<mbgl::PremultipliedImage> tiles;
+            if (metatile == 1) {
+                tiles.push_back(std::move(image));
+            } else {
+                // Row by row.
+                const mbgl::Size size { image.size.width / metatile, image.size.height / metatile };
+                for (uint32_t y = 0; y < metatile; ++y) {
+                    for (uint32_t x = 0; x < metatile; ++x) {
+                        mbgl::PremultipliedImage tile(size);
+                        mbgl::PremultipliedImage::copy(image, tile, { x * size.width, y * size.height }, { 0, 0 }, size);
+                        tiles.push_back(std::move(tile));
+                    }
+                }
+            }
+
+            for (auto& tile : tiles) {
+                switch (format) {
+                case RenderOptions::Format::Premultiplied: {
+                    const std::size_t bytes = tile.bytes();
+                    outputs.push_back({ std::move(tile.data), bytes });
+                    break;
+                }
+                case RenderOptions::Format::Unpremultiplied: {
+                    auto unpremultiplied = mbgl::util::unpremultiply(std::move(tile));
+                    const std::size_t bytes = unpremultiplied.bytes();
+                    outputs.push_back({ std::move(unpremultiplied.data), bytes });
+                    break;
+                }
+                case RenderOptions::Format::PNG: {
+                    const std::string png = mbgl::encodePNG(tile);
+                    auto data = std::make_unique<uint8_t[]>(png.size());
+                    std::copy(png.begin(), png.end(), data.get());
+                    outputs.push_back({ std::move(data), png.size() });
+                    break;
+                }
+                }
+            }
+        } catch (const std::exception& ex) {
+            SetErrorMessage(ex.what());
+        }
+    }
+
+    void HandleOKCallback() override {
+        Nan::HandleScope scope;
+
+        v8::Local<v8::Value> result;
+        if (metatile == 1) {
+            result = toBuffer(std::move(outputs.front().data), outputs.front().size);
+        } else {
+            auto images = Nan::New<v8::Array>(outputs.size());
+            for (uint32_t i = 0; i < outputs.size(); ++i) {
+                Nan::Set(images, i, toBuffer(std::move(outputs[i].data), outputs[i].size));
+            }
+            result = images;
+        }
+
+        v8::Local<v8::Value> argv[] = {
+            Nan::Null(),
+            result
+        };
+        callback->Call(2, argv);
+    }
+
+private:
+    struct Output {
+        std::unique_ptr<uint8_t[]> data;
+        std::size_t size;
+    };
+
+    mbgl::PremultipliedImage image;
+    const uint32_t metatile;
+    const RenderOptions::Format format;
+    std::vector<Output> outputs;
+};
+
 void NodeMap::Init(v8::Local<v8::Object> target) {
     v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
 
@@ -269,6 +363,27 @@ NodeMap::RenderOptions NodeMap::ParseOptions(v8::Local<v8::Object> obj) {
         options.height = Nan::Get(obj, Nan::New("height").ToLocalChecked()).ToLocalChecked()->IntegerValue();
     }
 
+    if (Nan::Has(obj, Nan::New("metatile").ToLocalChecked()).FromJust()) {
+        const auto metatile = Nan::Get(obj, Nan::New("metatile").ToLocalChecked()).ToLocalChecked()->IntegerValue();
+        if (metatile < 1 || metatile > 16) {
+            throw std::invalid_argument("Metatile must be between 1 and 16");
+        }
+        options.metatile = metatile;
+    }
+
+    if (Nan::Has(obj, Nan::New("format").ToLocalChecked()).FromJust()) {
+        const std::string format = *Nan::Utf8String(Nan::Get(obj, Nan::New("format").ToLocalChecked()).ToLocalChecked());
+        if (format == "premultiplied") {
+            options.format = RenderOptions::Format::Premultiplied;
+        } else if (format == "unpremultiplied") {
+            options.format = RenderOptions::Format::Unpremultiplied;
+        } else if (format == "png") {
+            options.format = RenderOptions::Format::PNG;
+        } else {
+            throw std::invalid_argument("Format must be 'premultiplied', 'unpremultiplied' or 'png'");
+        }
+    }
+
     if (Nan::Has(obj, Nan::New("classes").ToLocalChecked()).FromJust()) {
         auto classes = Nan::To<v8::Object>(Nan::Get(obj, Nan::New("classes").ToLocalChecked()).ToLocalChecked()).ToLocalChecked().As<v8::Array>();
         const int length = classes->Length();
@@ -321,6 +436,12 @@ NodeMap::RenderOptions NodeMap::ParseOptions(v8::Local<v8::Object> obj) {
  * @param {Array<number>} [options.center=[0,0]] longitude, latitude center
  * of the map
  * @param {number} [options.bearing=0] rotation
+ * @param {number} [options.metatile=1] renders a block of `metatile` × `metatile` images
+ * of the given size at once, centered on `center`, and calls back with an array of them,
+ * row by row. Layout, placement and loading are shared by the whole block, and labels
+ * are placed consistently across the borders within it.
+ * @param {string} [options.format='premultiplied'] the pixels of the image: 'premultiplied'
+ * or 'unpremultiplied' RGBA, or encoded as 'png'. Any conversion happens on a worker thread.
  * @param {Array<string>} [options.classes=[]] style classes
  * @param {Function} callback
  * @returns {undefined} calls callback
@@ -346,7 +467,12 @@ void NodeMap::Render(const Nan::FunctionCallbackInfo<v8::Value>& info) {
         return Nan::ThrowError("Map is currently rendering an image");
     }
 
-    auto options = ParseOptions(Nan::To<v8::Object>(info[0]).ToLocalChecked());
+    RenderOptions options;
+    try {
+        options = ParseOptions(Nan::To<v8::Object>(info[0]).ToLocalChecked());
+    } catch (const std::invalid_argument& ex) {
+        return Nan::ThrowTypeError(ex.what());
+    }
 
     assert(!nodeMap->callback);
     assert(!nodeMap->image.data);
@@ -362,10 +488,12 @@ void NodeMap::Render(const Nan::FunctionCallbackInfo<v8::Value>& info) {
 }
 
 void NodeMap::startRender(NodeMap::RenderOptions options) {
-    map->setSize({ options.width, options.height });
+    metatile = options.metatile;
+    format = options.format;
+    map->setSize({ options.width * metatile, options.height * metatile });
 
-    const mbgl::Size fbSize{ static_cast<uint32_t>(options.width * pixelRatio),
-                             static_cast<uint32_t>(options.height * pixelRatio) };
+    const mbgl::Size fbSize{ static_cast<uint32_t>(options.width * metatile * pixelRatio),
+                             static_cast<uint32_t>(options.height * metatile * pixelRatio) };
     if (!view || view->getSize() != fbSize) {
         view.reset();
         view = std::make_unique<mbgl::OffscreenView>(backend.getContext(), fbSize);
@@ -401,8 +529,9 @@ void NodeMap::startRender(NodeMap::RenderOptions options) {
             error = std::move(eptr);
             uv_async_send(async);
         } else {
-            assert(!image.data);
-            image = view->readStillImage();
+            // Only start reading the image here; it is collected in renderFinished, which
+            // gives the GPU until the next turn of the loop to finish rendering.
+            view->startReadStillImage();
             uv_async_send(async);
         }
     });
@@ -426,6 +555,16 @@ void NodeMap::renderFinished() {
     // of scope.
     Unref();
 
+    if (!error) {
+        assert(!image.data);
+        try {
+            mbgl::BackendScope guard { backend };
+            image = view->readStillImage();
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+
     // Move the callback and image out of the way so that the callback can start a new render call.
     auto cb = std::move(callback);
     auto img = std::move(image);
@@ -454,27 +593,26 @@ void NodeMap::renderFinished() {
 
         cb->Call(1, argv);
     } else if (img.data) {
-        v8::Local<v8::Object> pixels = Nan::NewBuffer(
-            reinterpret_cast<char *>(img.data.get()), img.bytes(),
-            // Retain the data until the buffer is deleted.
-            [](char *, void * hint) {
-                delete [] reinterpret_cast<uint8_t*>(hint);
-            },
-            img.data.get()
-        ).ToLocalChecked();
-        img.data.release();
-
-        v8::Local<v8::Value> argv[] = {
-            Nan::Null(),
-            pixels
-        };
-        cb->Call(2, argv);
+        if (metatile == 1 && format == RenderOptions::Format::Premultiplied) {
+            const std::size_t bytes = img.bytes();
+            v8::Local<v8::Value> argv[] = {
+                Nan::Null(),
+                toBuffer(std::move(img.data), bytes)
+            };
+            cb->Call(2, argv);
+        } else {
+            Nan::AsyncQueueWorker(new ImageWorker(cb.release(), std::move(img), metatile, format));
+        }
     } else {
         v8::Local<v8::Value> argv[] = {
             Nan::Error("Didn't get an image")
         };
         cb->Call(1, argv);
     }
+
+    if (onRenderFinished) {
+        onRenderFinished();
+    }
 }
 
 /**
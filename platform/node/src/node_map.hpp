@@ -13,13 +13,33 @@
 #include <nan.h>
 #pragma GCC diagnostic pop
 
+#include <functional>
+#include <string>
+#include <vector>
+
 namespace node_mbgl {
 
+std::string StringifyStyle(v8::Local<v8::Value> styleHandle);
+
 class NodeMap : public Nan::ObjectWrap,
                 public mbgl::FileSource {
 public:
-    struct RenderOptions;
+    struct RenderOptions {
+        double zoom = 0;
+        double bearing = 0;
+        double pitch = 0;
+        double latitude = 0;
+        double longitude = 0;
+        unsigned int width = 512;
+        unsigned int height = 512;
+        unsigned int metatile = 1;
+        enum class Format { Premultiplied, Unpremultiplied, PNG } format = Format::Premultiplied;
+        std::vector<std::string> classes;
+        mbgl::MapDebugOptions debugOptions = mbgl::MapDebugOptions::NoDebug;
+    };
+
     class RenderWorker;
+    class ImageWorker;
 
     NodeMap(v8::Local<v8::Object>);
     ~NodeMap();
@@ -66,8 +86,16 @@ public:
 
     std::exception_ptr error;
     mbgl::PremultipliedImage image;
+
+    // The number of images on each side of the block being rendered.
+    uint32_t metatile = 1;
+    RenderOptions::Format format = RenderOptions::Format::Premultiplied;
     std::unique_ptr<Nan::Callback> callback;
 
+    // Called once the callback of a render call returns, e.g. by a `NodeRenderPool` to give
+    // the map its next request.
+    std::function<void ()> onRenderFinished;
+
     // Async for delivering the notifications of render completion.
     uv_async_t *async;
 
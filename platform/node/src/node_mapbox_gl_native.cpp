@@ -9,6 +9,7 @@
 
 #include "node_map.hpp"
 #include "node_logging.hpp"
+#include "node_render_pool.hpp"
 #include "node_request.hpp"
 
 void RegisterModule(v8::Local<v8::Object> target, v8::Local<v8::Object> module) {
@@ -19,6 +20,7 @@ void RegisterModule(v8::Local<v8::Object> target, v8::Local<v8::Object> module)
     nodeRunLoop.stop();
 
     node_mbgl::NodeMap::Init(target);
+    node_mbgl::NodeRenderPool::Init(target);
     node_mbgl::NodeRequest::Init();
 
     // Exports Resource constants.
@@ -0,0 +1,260 @@
+#include "node_render_pool.hpp"
+
+#include <mbgl/style/sources/vector_source.hpp>
+#include <mbgl/util/exception.hpp>
+
+#include <cassert>
+
+namespace node_mbgl {
+
+Nan::Persistent<v8::Function> NodeRenderPool::constructor;
+
+static const char* releasedMessage() {
+    return "Render pool resources have already been released";
+}
+
+void NodeRenderPool::Init(v8::Local<v8::Object> target) {
+    v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+
+    tpl->SetClassName(Nan::New("RenderPool").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(2);
+
+    Nan::SetPrototypeMethod(tpl, "load", Load);
+    Nan::SetPrototypeMethod(tpl, "render", Render);
+    Nan::SetPrototypeMethod(tpl, "queueDepth", QueueDepth);
+    Nan::SetPrototypeMethod(tpl, "release", Release);
+
+    constructor.Reset(tpl->GetFunction());
+    Nan::Set(target, Nan::New("RenderPool").ToLocalChecked(), tpl->GetFunction());
+}
+
+/**
+ * A pool of maps rendering the same stylesheet: render calls are queued and run
+ * concurrently, each on the first map to be free.
+ *
+ * @class
+ * @name RenderPool
+ * @param {Object} options the options of a `Map`
+ * @param {number} [options.size=4] the number of maps, each with its own GL context
+ * @example
+ * var pool = new mbgl.RenderPool({ request: function() {}, size: 4 });
+ * pool.load(require('./test/fixtures/style.json'));
+ * pool.render({ zoom: 2 }, function(err, image) {
+ *     if (err) throw err;
+ *     fs.writeFileSync('image.png', image);
+ * });
+ */
+void NodeRenderPool::New(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    if (!info.IsConstructCall()) {
+        return Nan::ThrowTypeError("Use the new operator to create new RenderPool objects");
+    }
+
+    if (info.Length() < 1 || !info[0]->IsObject()) {
+        return Nan::ThrowTypeError("Requires an options object as first argument");
+    }
+
+    auto options = Nan::To<v8::Object>(info[0]).ToLocalChecked();
+
+    int64_t size = 4;
+    if (Nan::Has(options, Nan::New("size").ToLocalChecked()).FromJust()) {
+        auto sizeValue = Nan::Get(options, Nan::New("size").ToLocalChecked()).ToLocalChecked();
+        if (!sizeValue->IsNumber() || sizeValue->IntegerValue() < 1) {
+            return Nan::ThrowError("Options object 'size' property must be a positive number");
+        }
+        size = sizeValue->IntegerValue();
+    }
+
+    auto pool = new NodeRenderPool();
+    pool->Wrap(info.This());
+
+    // The maps check the rest of the options.
+    v8::Local<v8::Value> argv[] = { options };
+    auto mapObjects = Nan::New<v8::Array>(size);
+    for (int64_t i = 0; i < size; ++i) {
+        v8::Local<v8::Object> mapObject;
+        if (!Nan::NewInstance(Nan::New(NodeMap::constructor), 1, argv).ToLocal(&mapObject)) {
+            return;
+        }
+        Nan::Set(mapObjects, i, mapObject);
+
+        auto map = Nan::ObjectWrap::Unwrap<NodeMap>(mapObject);
+        map->onRenderFinished = [pool, map] {
+            pool->idleMaps.push_back(map);
+            pool->dispatch();
+
+            // Taken when the render call was queued.
+            pool->Unref();
+        };
+        pool->maps.push_back(map);
+        pool->idleMaps.push_back(map);
+    }
+    info.This()->SetInternalField(1, mapObjects);
+
+    info.GetReturnValue().Set(info.This());
+}
+
+/**
+ * Load a stylesheet into every map of the pool
+ *
+ * @function
+ * @name load
+ * @param {string|Object} stylesheet either an object or a JSON representation
+ * @returns {undefined} loads stylesheet into the maps
+ * @throws {Error} if stylesheet is missing or invalid, or if the pool is rendering
+ */
+void NodeRenderPool::Load(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    auto pool = Nan::ObjectWrap::Unwrap<NodeRenderPool>(info.Holder());
+    if (pool->maps.empty()) return Nan::ThrowError(releasedMessage());
+
+    if (pool->idleMaps.size() != pool->maps.size()) {
+        return Nan::ThrowError("Render pool is currently rendering");
+    }
+
+    pool->loaded = false;
+
+    if (info.Length() < 1) {
+        return Nan::ThrowError("Requires a map style as first argument");
+    }
+
+    std::string style;
+
+    if (info[0]->IsObject()) {
+        style = StringifyStyle(info[0]);
+    } else if (info[0]->IsString()) {
+        style = *Nan::Utf8String(info[0]);
+    } else {
+        return Nan::ThrowTypeError("First argument must be a string or object");
+    }
+
+    try {
+        for (auto map : pool->maps) {
+            map->loaded = false;
+            map->map->setStyleJSON(style);
+            map->loaded = true;
+
+            for (auto source : map->map->getSources()) {
+                if (source->is<mbgl::style::VectorSource>()) {
+                    source->as<mbgl::style::VectorSource>()->setTileDataShared(true);
+                }
+            }
+        }
+    } catch (const std::exception &ex) {
+        return Nan::ThrowError(ex.what());
+    }
+
+    pool->loaded = true;
+
+    info.GetReturnValue().SetUndefined();
+}
+
+/**
+ * Queue an image to render from the loaded style, with the options of `Map#render`
+ *
+ * @function
+ * @name render
+ * @param {Object} options
+ * @param {Function} callback
+ * @returns {undefined} calls callback once a map has rendered the image
+ * @throws {Error} if stylesheet is not loaded
+ */
+void NodeRenderPool::Render(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    auto pool = Nan::ObjectWrap::Unwrap<NodeRenderPool>(info.Holder());
+    if (pool->maps.empty()) return Nan::ThrowError(releasedMessage());
+
+    if (info.Length() <= 0 || !info[0]->IsObject()) {
+        return Nan::ThrowTypeError("First argument must be an options object");
+    }
+
+    if (info.Length() <= 1 || !info[1]->IsFunction()) {
+        return Nan::ThrowTypeError("Second argument must be a callback function");
+    }
+
+    if (!pool->loaded) {
+        return Nan::ThrowTypeError("Style is not loaded");
+    }
+
+    NodeMap::RenderOptions options;
+    try {
+        options = NodeMap::ParseOptions(Nan::To<v8::Object>(info[0]).ToLocalChecked());
+    } catch (const std::invalid_argument& ex) {
+        return Nan::ThrowTypeError(ex.what());
+    }
+
+    pool->queue.push_back({ std::move(options), std::make_unique<Nan::Callback>(info[1].As<v8::Function>()) });
+
+    // Keeps the pool until the render call finishes; released in `onRenderFinished`, or
+    // once the call fails to start.
+    pool->Ref();
+    pool->dispatch();
+
+    info.GetReturnValue().SetUndefined();
+}
+
+/**
+ * The number of render calls waiting for a map to be free
+ *
+ * @function
+ * @name queueDepth
+ * @returns {number}
+ */
+void NodeRenderPool::QueueDepth(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    auto pool = Nan::ObjectWrap::Unwrap<NodeRenderPool>(info.Holder());
+    info.GetReturnValue().Set(Nan::New(static_cast<double>(pool->queue.size())));
+}
+
+/**
+ * Clean up the resources used by the maps of the pool
+ *
+ * @name release
+ * @returns {undefined}
+ * @throws {Error} if the pool is rendering
+ */
+void NodeRenderPool::Release(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    auto pool = Nan::ObjectWrap::Unwrap<NodeRenderPool>(info.Holder());
+    if (pool->maps.empty()) return Nan::ThrowError(releasedMessage());
+
+    if (!pool->queue.empty() || pool->idleMaps.size() != pool->maps.size()) {
+        return Nan::ThrowError("Render pool is currently rendering");
+    }
+
+    try {
+        for (auto map : pool->maps) {
+            map->onRenderFinished = nullptr;
+            map->release();
+        }
+    } catch (const std::exception &ex) {
+        return Nan::ThrowError(ex.what());
+    }
+
+    pool->maps.clear();
+    pool->idleMaps.clear();
+
+    info.GetReturnValue().SetUndefined();
+}
+
+void NodeRenderPool::dispatch() {
+    while (!queue.empty() && !idleMaps.empty()) {
+        NodeMap* map = idleMaps.back();
+        idleMaps.pop_back();
+        Request request = std::move(queue.front());
+        queue.pop_front();
+
+        assert(!map->callback);
+        map->callback = std::move(request.callback);
+
+        try {
+            map->startRender(std::move(request.options));
+        } catch (mbgl::util::Exception& ex) {
+            auto callback = std::move(map->callback);
+            idleMaps.push_back(map);
+
+            v8::Local<v8::Value> argv[] = {
+                Nan::Error(ex.what())
+            };
+            callback->Call(1, argv);
+            Unref();
+        }
+    }
+}
+
+} // namespace node_mbgl
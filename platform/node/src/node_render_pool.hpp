@@ -0,0 +1,53 @@
+#pragma once
+
+#include "node_map.hpp"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wshadow"
+#include <nan.h>
+#pragma GCC diagnostic pop
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace node_mbgl {
+
+/*
+   A fixed number of maps, each with its own headless context, that load the same style
+   and request resources through the same `request` method. Render calls are queued, and
+   given in order to the maps as they finish their previous one. The maps share the data
+   of the vector tiles they parse.
+*/
+class NodeRenderPool : public Nan::ObjectWrap {
+public:
+    static Nan::Persistent<v8::Function> constructor;
+
+    static void Init(v8::Local<v8::Object>);
+
+    static void New(const Nan::FunctionCallbackInfo<v8::Value>&);
+    static void Load(const Nan::FunctionCallbackInfo<v8::Value>&);
+    static void Render(const Nan::FunctionCallbackInfo<v8::Value>&);
+    static void QueueDepth(const Nan::FunctionCallbackInfo<v8::Value>&);
+    static void Release(const Nan::FunctionCallbackInfo<v8::Value>&);
+
+private:
+    struct Request {
+        NodeMap::RenderOptions options;
+        std::unique_ptr<Nan::Callback> callback;
+    };
+
+    void dispatch();
+
+    // Kept alive by the array of their objects in an internal field of the pool's object.
+    std::vector<NodeMap*> maps;
+    std::vector<NodeMap*> idleMaps;
+
+    // Render calls waiting for a map.
+    std::deque<Request> queue;
+
+    bool loaded = false;
+};
+
+} // namespace node_mbgl
@@ -494,6 +494,66 @@ test('Map', function(t) {
             });
         });
 
+        t.test('returns the images of a metatile', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+            map.render({ width: 256, height: 256, metatile: 2 }, function(err, images) {
+                t.error(err);
+                map.release();
+                t.ok(Array.isArray(images));
+                t.equal(images.length, 4);
+                images.forEach(function(pixels) {
+                    t.ok(pixels instanceof Buffer);
+                    t.equal(pixels.length, 256 * 256 * 4);
+                });
+                t.end();
+            });
+        });
+
+        t.test('returns a PNG', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+            map.render({ format: 'png' }, function(err, png) {
+                t.error(err);
+                map.release();
+                t.ok(png instanceof Buffer);
+                t.equal(png.slice(1, 4).toString(), 'PNG');
+                t.end();
+            });
+        });
+
+        t.test('returns unpremultiplied images of a metatile', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+            map.render({ width: 256, height: 256, metatile: 2, format: 'unpremultiplied' }, function(err, images) {
+                t.error(err);
+                map.release();
+                t.equal(images.length, 4);
+                t.equal(images[3].length, 256 * 256 * 4);
+                t.end();
+            });
+        });
+
+        t.test('requires a known format', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+            t.throws(function() {
+                map.render({ format: 'webp' }, function() {});
+            }, /Format must be 'premultiplied', 'unpremultiplied' or 'png'/);
+            map.release();
+            t.end();
+        });
+
+        t.test('requires a metatile in range', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+            t.throws(function() {
+                map.render({ metatile: 0 }, function() {});
+            }, /Metatile must be between 1 and 16/);
+            map.release();
+            t.end();
+        });
+
         t.test('can be called several times in serial', function(t) {
             var completed = 0;
             var remaining = 10;
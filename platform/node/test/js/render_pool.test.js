@@ -0,0 +1,62 @@
+'use strict';
+
+var test = require('tape');
+var mbgl = require('../../index');
+var fs = require('fs');
+var path = require('path');
+var style = require('../fixtures/style.json');
+
+test('RenderPool', function(t) {
+    var options = {
+        request: function(req, callback) {
+            fs.readFile(path.join(__dirname, '..', req.url), function(err, data) {
+                callback(err, { data: data });
+            });
+        },
+        ratio: 1,
+        size: 2
+    };
+
+    t.test('requires a positive size', function(t) {
+        t.throws(function() {
+            new mbgl.RenderPool({ request: function() {}, size: 0 });
+        }, /Options object 'size' property must be a positive number/);
+
+        t.end();
+    });
+
+    t.test('requires a loaded style', function(t) {
+        var pool = new mbgl.RenderPool(options);
+
+        t.throws(function() {
+            pool.render({}, function() {});
+        }, /Style is not loaded/);
+
+        pool.release();
+        t.end();
+    });
+
+    t.test('renders queued requests concurrently', function(t) {
+        var pool = new mbgl.RenderPool(options);
+        pool.load(style);
+
+        var remaining = 5;
+        for (var i = 0; i < 5; i++) {
+            pool.render({ zoom: i }, function(err, pixels) {
+                t.error(err);
+                t.equal(pixels.length, 512 * 512 * 4);
+                if (--remaining === 0) {
+                    t.equal(pool.queueDepth(), 0);
+                    pool.release();
+                    t.end();
+                }
+            });
+        }
+
+        // Two of them are given to the maps right away.
+        t.equal(pool.queueDepth(), 3);
+        t.throws(function() {
+            pool.release();
+        }, /Render pool is currently rendering/);
+    });
+});
@@ -9,8 +9,11 @@
 #include <QSize>
 #include <QString>
 #include <QStringList>
+#include <QThread>
 
 class QMapboxGLPrivate;
+class QMapboxGLRenderThreadPrivate;
+class QOpenGLContext;
 
 // This header follows the Qt coding style: https://wiki.qt.io/Qt_Coding_Style
 
@@ -228,6 +231,7 @@ public:
 
 public slots:
     void render();
+    void setFramebufferObject(quint32 fbo);
     void connectionEstablished();
 
 signals:
@@ -243,4 +247,41 @@ private:
 
 Q_DECLARE_METATYPE(QMapboxGL::MapChange);
 
+#if QT_VERSION >= 0x050000
+class Q_DECL_EXPORT QMapboxGLRenderThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    QMapboxGLRenderThread(QOpenGLContext *shareContext, const QMapboxGLSettings &,
+                          const QSize &size, qreal pixelRatio);
+    virtual ~QMapboxGLRenderThread();
+
+    void setStyleJson(const QString &);
+    void setStyleUrl(const QString &);
+    void jumpTo(const QMapboxGLCameraOptions &);
+    void moveBy(const QPointF &offset);
+    void scaleBy(double scale, const QPointF &center = QPointF());
+    void setGestureInProgress(bool inProgress);
+    void resize(const QSize &size, const QSize &framebufferSize);
+
+    quint32 lockFrame(QSize *framebufferSize = nullptr);
+    void unlockFrame();
+
+signals:
+    void frameReady();
+    void mapChanged(QMapboxGL::MapChange);
+    void copyrightsChanged(const QString &copyrightsHtml);
+
+protected:
+    void run() override;
+
+private:
+    Q_DISABLE_COPY(QMapboxGLRenderThread)
+
+    QMapboxGLRenderThreadPrivate *d_ptr;
+};
+#endif
+
+
 #endif // QMAPBOXGL_H
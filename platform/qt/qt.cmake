@@ -17,6 +17,7 @@ set(MBGL_QT_FILES
     PRIVATE platform/default/asset_file_source.cpp
     PRIVATE platform/default/default_file_source.cpp
     PRIVATE platform/default/local_file_source.cpp
+    PRIVATE platform/default/mbtiles_file_source.cpp
     PRIVATE platform/default/online_file_source.cpp
 
     # Offline
@@ -25,6 +26,8 @@ set(MBGL_QT_FILES
     PRIVATE platform/default/mbgl/storage/offline_database.hpp
     PRIVATE platform/default/mbgl/storage/offline_download.cpp
     PRIVATE platform/default/mbgl/storage/offline_download.hpp
+    PRIVATE platform/default/mbgl/storage/response_cache.cpp
+    PRIVATE platform/default/mbgl/storage/response_cache.hpp
     PRIVATE platform/default/sqlite3.hpp
 
     # Misc
@@ -64,6 +67,8 @@ add_library(qmapboxgl SHARED
     platform/qt/src/qmapbox.cpp
     platform/qt/src/qmapboxgl.cpp
     platform/qt/src/qmapboxgl_p.hpp
+    platform/qt/src/qmapboxgl_render_thread.cpp
+    platform/qt/src/qmapboxgl_render_thread_p.hpp
     platform/default/mbgl/util/default_styles.hpp
     platform/default/mbgl/util/default_styles.cpp
 )
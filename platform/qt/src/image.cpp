@@ -1,4 +1,5 @@
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/premultiply.hpp>
 
 #include <QBuffer>
 #include <QByteArray>
@@ -60,4 +61,12 @@ PremultipliedImage decodeImage(const std::string& string) {
     return { { static_cast<uint32_t>(image.width()), static_cast<uint32_t>(image.height()) },
              std::move(img) };
 }
+
+void decodeImage(const std::string& string, PremultipliedImage& image) {
+    image = decodeImage(string);
+}
+
+UnassociatedImage decodeUnassociatedImage(const std::string& string, Size) {
+    return util::unpremultiply(decodeImage(string));
+}
 }
@@ -1505,6 +1505,15 @@ void QMapboxGL::render()
     d_ptr->mapObj->render(*d_ptr);
 }
 
+/*!
+    Makes render() draw into the framebuffer object \a fbo, of the framebuffer size given
+    to resize(), instead of the default framebuffer 0.
+*/
+void QMapboxGL::setFramebufferObject(quint32 fbo)
+{
+    d_ptr->fbObject = fbo;
+}
+
 /*!
     Informs the map that the network connection has been established, causing
     all network requests that previously timed out to be retried immediately.
@@ -1573,7 +1582,7 @@ QMapboxGLPrivate::~QMapboxGLPrivate()
 }
 
 void QMapboxGLPrivate::bind() {
-    getContext().bindFramebuffer = 0;
+    getContext().bindFramebuffer = fbObject;
     getContext().viewport = {
         0, 0, { static_cast<uint32_t>(fbSize.width()), static_cast<uint32_t>(fbSize.height()) }
     };
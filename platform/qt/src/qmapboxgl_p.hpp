@@ -41,6 +41,7 @@ public:
     std::shared_ptr<mbgl::ThreadPool> threadPool;
     std::unique_ptr<mbgl::Map> mapObj;
 
+    quint32 fbObject { 0 };
     bool dirty { false };
 
 public slots:
@@ -0,0 +1,267 @@
+#include "qmapboxgl_render_thread_p.hpp"
+
+#if QT_VERSION >= 0x050000
+
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+
+/*!
+    \class QMapboxGLRenderThread
+    \brief The QMapboxGLRenderThread class renders a QMapboxGL on a thread of its own.
+
+    \inmodule Mapbox Qt SDK
+
+    QMapboxGLRenderThread owns a QMapboxGL that lives on a dedicated thread, with an OpenGL
+    context shared with the one of the GUI, so that rendering the map and handling user
+    input don't hold each other up. The map renders into a framebuffer object whenever its
+    contents change, and frameReady() is emitted once a frame is complete. The GUI presents
+    it by drawing the texture returned by lockFrame(), e.g. from a QOpenGLWidget or a
+    QQuickFramebufferObject renderer, and calls unlockFrame() when done with it.
+
+    Changes to the camera and the style are made from the GUI thread through the methods of
+    this class, and are applied by the render thread before its next frame, in order.
+
+    \since 5.0
+*/
+
+/*!
+    Constructs a render thread whose map renders with a context shared with \a shareContext,
+    using \a settings, at \a size and \a pixelRatio. Must be called on the GUI thread. The
+    thread has to be started with start().
+*/
+QMapboxGLRenderThread::QMapboxGLRenderThread(QOpenGLContext *shareContext, const QMapboxGLSettings &settings,
+                                             const QSize &size, qreal pixelRatio)
+    : d_ptr(new QMapboxGLRenderThreadPrivate(this, settings, size, pixelRatio))
+{
+    d_ptr->context = std::make_unique<QOpenGLContext>();
+    d_ptr->context->setFormat(shareContext->format());
+    d_ptr->context->setShareContext(shareContext);
+    d_ptr->context->create();
+
+    d_ptr->surface = std::make_unique<QOffscreenSurface>();
+    d_ptr->surface->setFormat(d_ptr->context->format());
+    d_ptr->surface->create();
+
+    d_ptr->context->moveToThread(this);
+    d_ptr->moveToThread(this);
+}
+
+/*!
+    Stops the thread, and destroys the map and its resources.
+*/
+QMapboxGLRenderThread::~QMapboxGLRenderThread()
+{
+    quit();
+    wait();
+
+    delete d_ptr;
+}
+
+/*!
+    Sets the style of the map to \a style, a JSON string.
+*/
+void QMapboxGLRenderThread::setStyleJson(const QString &style)
+{
+    d_ptr->post([style](QMapboxGL &map) { map.setStyleJson(style); });
+}
+
+/*!
+    Sets the style of the map to the one at \a url.
+*/
+void QMapboxGLRenderThread::setStyleUrl(const QString &url)
+{
+    d_ptr->post([url](QMapboxGL &map) { map.setStyleUrl(url); });
+}
+
+/*!
+    Moves the camera of the map as QMapboxGL::jumpTo() does with \a camera.
+*/
+void QMapboxGLRenderThread::jumpTo(const QMapboxGLCameraOptions &camera)
+{
+    d_ptr->post([camera](QMapboxGL &map) { map.jumpTo(camera); });
+}
+
+/*!
+    Pans the map by \a offset in pixels.
+*/
+void QMapboxGLRenderThread::moveBy(const QPointF &offset)
+{
+    d_ptr->post([offset](QMapboxGL &map) { map.moveBy(offset); });
+}
+
+/*!
+    Scales the map by \a scale around \a center.
+*/
+void QMapboxGLRenderThread::scaleBy(double scale, const QPointF &center)
+{
+    d_ptr->post([scale, center](QMapboxGL &map) { map.scaleBy(scale, center); });
+}
+
+/*!
+    Tells the map whether a gesture is \a inProgress; see QMapboxGL::setGestureInProgress().
+*/
+void QMapboxGLRenderThread::setGestureInProgress(bool inProgress)
+{
+    d_ptr->post([inProgress](QMapboxGL &map) { map.setGestureInProgress(inProgress); });
+}
+
+/*!
+    Resizes the map to \a size, rendered into frames of \a framebufferSize.
+*/
+void QMapboxGLRenderThread::resize(const QSize &size, const QSize &framebufferSize)
+{
+    QMapboxGLRenderThreadPrivate *d = d_ptr;
+    d_ptr->post([d, size, framebufferSize](QMapboxGL &map) {
+        d->size = size;
+        d->fbSize = framebufferSize;
+        map.resize(size, framebufferSize);
+    });
+}
+
+/*!
+    Returns the texture of the last complete frame, in the context group of the
+    context given to the constructor, or 0 if there isn't one yet. Its size is written to
+    \a framebufferSize if given. The render thread doesn't replace the frame until
+    unlockFrame() is called, which must be done in any case.
+*/
+quint32 QMapboxGLRenderThread::lockFrame(QSize *framebufferSize)
+{
+    d_ptr->frameMutex.lock();
+    if (!d_ptr->hasFrame) {
+        return 0;
+    }
+
+    const auto &frame = d_ptr->frames[d_ptr->front];
+    if (framebufferSize) {
+        *framebufferSize = frame->size();
+    }
+    return frame->texture();
+}
+
+/*!
+    Lets the render thread replace the frame returned by lockFrame().
+*/
+void QMapboxGLRenderThread::unlockFrame()
+{
+    d_ptr->frameMutex.unlock();
+}
+
+/*!
+    \fn void QMapboxGLRenderThread::frameReady()
+
+    This signal is emitted, from the render thread, when a new frame is complete.
+
+    \sa lockFrame()
+*/
+
+void QMapboxGLRenderThread::run()
+{
+    d_ptr->initialize();
+    exec();
+    d_ptr->cleanup();
+}
+
+QMapboxGLRenderThreadPrivate::QMapboxGLRenderThreadPrivate(QMapboxGLRenderThread *q, const QMapboxGLSettings &settings_,
+                                                           const QSize &size_, qreal pixelRatio_)
+    : q_ptr(q)
+    , settings(settings_)
+    , size(size_)
+    , fbSize(size_ * pixelRatio_)
+    , pixelRatio(pixelRatio_)
+{
+}
+
+QMapboxGLRenderThreadPrivate::~QMapboxGLRenderThreadPrivate()
+{
+}
+
+void QMapboxGLRenderThreadPrivate::post(std::function<void (QMapboxGL &)> change)
+{
+    bool first;
+    {
+        QMutexLocker lock(&pendingMutex);
+        first = pending.empty();
+        pending.push_back(std::move(change));
+    }
+
+    // One call applies every change posted until it runs.
+    if (first) {
+        QMetaObject::invokeMethod(this, "applyPending", Qt::QueuedConnection);
+    }
+}
+
+void QMapboxGLRenderThreadPrivate::initialize()
+{
+    context->makeCurrent(surface.get());
+
+    map = std::make_unique<QMapboxGL>(nullptr, settings, size, pixelRatio);
+    map->resize(size, fbSize);
+
+    connect(map.get(), SIGNAL(needsRendering()), this, SLOT(render()), Qt::QueuedConnection);
+    connect(map.get(), SIGNAL(mapChanged(QMapboxGL::MapChange)), q_ptr, SIGNAL(mapChanged(QMapboxGL::MapChange)));
+    connect(map.get(), SIGNAL(copyrightsChanged(QString)), q_ptr, SIGNAL(copyrightsChanged(QString)));
+}
+
+void QMapboxGLRenderThreadPrivate::cleanup()
+{
+    context->makeCurrent(surface.get());
+
+    {
+        QMutexLocker lock(&frameMutex);
+        hasFrame = false;
+        frames[0].reset();
+        frames[1].reset();
+    }
+    map.reset();
+
+    context->doneCurrent();
+    context->moveToThread(QCoreApplication::instance()->thread());
+}
+
+void QMapboxGLRenderThreadPrivate::applyPending()
+{
+    std::vector<std::function<void (QMapboxGL &)>> changes;
+    {
+        QMutexLocker lock(&pendingMutex);
+        changes.swap(pending);
+    }
+
+    for (const auto &change : changes) {
+        change(*map);
+    }
+}
+
+void QMapboxGLRenderThreadPrivate::render()
+{
+    if (fbSize.isEmpty()) {
+        return;
+    }
+
+    context->makeCurrent(surface.get());
+
+    // The back frame isn't used by the GUI thread.
+    auto &frame = frames[1 - front];
+    if (!frame || frame->size() != fbSize) {
+        frame = std::make_unique<QOpenGLFramebufferObject>(fbSize, QOpenGLFramebufferObject::CombinedDepthStencil);
+    }
+
+    map->setFramebufferObject(frame->handle());
+    map->render();
+
+    // The texture has to be complete before the GUI's context draws it.
+    context->functions()->glFinish();
+
+    {
+        QMutexLocker lock(&frameMutex);
+        front = 1 - front;
+        hasFrame = true;
+    }
+
+    emit q_ptr->frameReady();
+}
+
+#endif
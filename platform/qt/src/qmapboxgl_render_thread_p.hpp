@@ -0,0 +1,64 @@
+#pragma once
+
+#include "qmapboxgl.hpp"
+
+#if QT_VERSION >= 0x050000
+
+#include <QMutex>
+#include <QObject>
+#include <QSize>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+class QOffscreenSurface;
+class QOpenGLFramebufferObject;
+
+// Lives on the render thread, along with the map and the GL resources it renders with.
+class QMapboxGLRenderThreadPrivate : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QMapboxGLRenderThreadPrivate(QMapboxGLRenderThread *, const QMapboxGLSettings &,
+                                          const QSize &size, qreal pixelRatio);
+    virtual ~QMapboxGLRenderThreadPrivate();
+
+    // Called on any thread; `change` is applied on the render thread before its next frame.
+    void post(std::function<void (QMapboxGL &)> change);
+
+    // Called on the render thread, before and after its event loop.
+    void initialize();
+    void cleanup();
+
+    QMapboxGLRenderThread *q_ptr { nullptr };
+
+    const QMapboxGLSettings settings;
+    QSize size;
+    QSize fbSize;
+    const qreal pixelRatio;
+
+    // Made on the GUI thread, which has to create and destroy the surface.
+    std::unique_ptr<QOpenGLContext> context;
+    std::unique_ptr<QOffscreenSurface> surface;
+
+    std::unique_ptr<QMapboxGL> map;
+
+    // The last complete frame, and the one being rendered.
+    std::unique_ptr<QOpenGLFramebufferObject> frames[2];
+    int front { 0 };
+    bool hasFrame { false };
+
+    // Held by the GUI thread while it draws the front frame, so that it isn't swapped.
+    QMutex frameMutex;
+
+    QMutex pendingMutex;
+    std::vector<std::function<void (QMapboxGL &)>> pending;
+
+public slots:
+    void applyPending();
+    void render();
+};
+
+#endif
@@ -0,0 +1,239 @@
+#!/usr/bin/env node
+'use strict';
+
+// Runs mbgl-benchmark repeatedly and compares its results with a baseline.
+//
+//   benchmark-compare.js run <mbgl-benchmark> <results.json> [--repetitions N] [--filter REGEX]
+//   benchmark-compare.js compare <baseline.json> <results.json> [--threshold 0.05] [--alpha 0.05]
+//
+// `run` writes the CPU and real times of each repetition of each benchmark, in the format
+// described by benchmark/baseline.schema.json. `compare` takes such files, or the JSON output
+// of Google Benchmark, prints a table of the changes, and exits with 1 if a benchmark got
+// slower by more than the threshold with a Mann-Whitney U test significant at the alpha level.
+
+const child_process = require('child_process');
+const fs = require('fs');
+
+const VERSION = 1;
+
+function usage() {
+    console.error('Usage: benchmark-compare.js run <mbgl-benchmark> <results.json> [--repetitions N] [--filter REGEX]');
+    console.error('       benchmark-compare.js compare <baseline.json> <results.json> [--threshold 0.05] [--alpha 0.05]');
+    process.exit(2);
+}
+
+function parseArgs(argv, defaults) {
+    const options = Object.assign({}, defaults);
+    const positional = [];
+    for (let i = 0; i < argv.length; i++) {
+        const match = /^--(\w+)$/.exec(argv[i]);
+        if (match) {
+            if (!(match[1] in defaults) || i + 1 === argv.length) usage();
+            options[match[1]] = argv[++i];
+        } else {
+            positional.push(argv[i]);
+        }
+    }
+    return { positional, options };
+}
+
+// Google Benchmark 1.0 repeats each benchmark in a row and follows the repetitions with their
+// mean and standard deviation, which are left out here.
+function fromGoogleBenchmark(output) {
+    const result = { version: VERSION, context: output.context || {}, benchmarks: {} };
+    for (const run of output.benchmarks) {
+        if (/_(mean|stddev)$/.test(run.name)) continue;
+        const samples = result.benchmarks[run.name] || (result.benchmarks[run.name] = {
+            time_unit: run.time_unit || 'ns',
+            cpu_time: [],
+            real_time: []
+        });
+        samples.cpu_time.push(run.cpu_time);
+        samples.real_time.push(run.real_time);
+    }
+    return result;
+}
+
+function read(path) {
+    const json = JSON.parse(fs.readFileSync(path, 'utf8'));
+    if (Array.isArray(json.benchmarks)) {
+        return fromGoogleBenchmark(json);
+    }
+    if (json.version !== VERSION || typeof json.benchmarks !== 'object') {
+        throw new Error(`${path} is neither Google Benchmark output nor results of version ${VERSION}`);
+    }
+    return json;
+}
+
+function run(binary, path, options) {
+    const args = [
+        '--benchmark_format=json',
+        `--benchmark_repetitions=${options.repetitions}`
+    ];
+    if (options.filter) args.push(`--benchmark_filter=${options.filter}`);
+
+    const output = child_process.execFileSync(binary, args, {
+        encoding: 'utf8',
+        maxBuffer: 64 * 1024 * 1024,
+        stdio: ['ignore', 'pipe', 'inherit']
+    });
+    const results = fromGoogleBenchmark(JSON.parse(output));
+    fs.writeFileSync(path, JSON.stringify(results, null, 2) + '\n');
+    console.log(`Wrote ${Object.keys(results.benchmarks).length} benchmarks to ${path}`);
+}
+
+function median(values) {
+    const sorted = values.slice().sort((a, b) => a - b);
+    const middle = Math.floor(sorted.length / 2);
+    return sorted.length % 2 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+}
+
+// The standard normal distribution function, after Abramowitz and Stegun 7.1.26.
+function normalCDF(z) {
+    const t = 1 / (1 + 0.3275911 * Math.abs(z) / Math.SQRT2);
+    const erf = 1 - t * (0.254829592 + t * (-0.284496736 + t * (1.421413741 +
+        t * (-1.453152027 + t * 1.061405429)))) * Math.exp(-z * z / 2);
+    return z < 0 ? (1 - erf) / 2 : (1 + erf) / 2;
+}
+
+// The number of arrangements of n + m samples for which U of the first n is u, for the exact
+// distribution of small samples without ties.
+function arrangements(n, m, u, memo) {
+    if (u < 0 || u > n * m) return 0;
+    if (n === 0 || m === 0) return u === 0 ? 1 : 0;
+    const key = `${n},${m},${u}`;
+    if (!(key in memo)) {
+        memo[key] = arrangements(n - 1, m, u - m, memo) + arrangements(n, m - 1, u, memo);
+    }
+    return memo[key];
+}
+
+// The two-sided p-value of the Mann-Whitney U test of whether the samples come from the
+// same distribution.
+function mannWhitney(a, b) {
+    const n = a.length;
+    const m = b.length;
+    if (n === 0 || m === 0) return 1;
+
+    const all = a.map((value) => ({ value, first: true }))
+        .concat(b.map((value) => ({ value, first: false })))
+        .sort((x, y) => x.value - y.value);
+
+    // Ranks, with the mean rank for ties.
+    let rankSum = 0;
+    let tieCorrection = 0;
+    for (let i = 0; i < all.length;) {
+        let j = i;
+        while (j < all.length && all[j].value === all[i].value) j++;
+        const rank = (i + 1 + j) / 2;
+        for (let k = i; k < j; k++) {
+            if (all[k].first) rankSum += rank;
+        }
+        const ties = j - i;
+        tieCorrection += ties * ties * ties - ties;
+        i = j;
+    }
+
+    const u = rankSum - n * (n + 1) / 2;
+
+    if (tieCorrection === 0 && n + m <= 40) {
+        const memo = {};
+        let total = 0;
+        let below = 0;
+        for (let k = 0; k <= n * m; k++) {
+            const count = arrangements(n, m, k, memo);
+            total += count;
+            if (k <= Math.min(u, n * m - u)) below += count;
+        }
+        return Math.min(1, 2 * below / total);
+    }
+
+    const mean = n * m / 2;
+    const variance = n * m / 12 * ((n + m + 1) - tieCorrection / ((n + m) * (n + m - 1)));
+    if (variance === 0) return 1;
+    const z = (Math.abs(u - mean) - 0.5) / Math.sqrt(variance);
+    return Math.min(1, 2 * (1 - normalCDF(z)));
+}
+
+function pad(text, width, right) {
+    text = String(text);
+    const padding = ' '.repeat(Math.max(0, width - text.length));
+    return right ? padding + text : text + padding;
+}
+
+function compare(baselinePath, resultsPath, options) {
+    const baseline = read(baselinePath);
+    const results = read(resultsPath);
+    const threshold = Number(options.threshold);
+    const alpha = Number(options.alpha);
+
+    const rows = [];
+    const regressions = [];
+    for (const name of Object.keys(results.benchmarks)) {
+        const current = results.benchmarks[name];
+        const previous = baseline.benchmarks[name];
+        if (!previous) {
+            rows.push([name, '', median(current.cpu_time).toFixed(0), '', '', 'new']);
+            continue;
+        }
+        if (previous.time_unit !== current.time_unit) {
+            rows.push([name, '', '', '', '', `unit changed from ${previous.time_unit}`]);
+            continue;
+        }
+
+        const before = median(previous.cpu_time);
+        const after = median(current.cpu_time);
+        const change = before ? after / before - 1 : 0;
+        const p = mannWhitney(previous.cpu_time, current.cpu_time);
+
+        let verdict = '';
+        if (p < alpha && Math.abs(change) > threshold) {
+            verdict = change > 0 ? 'REGRESSION' : 'improvement';
+        } else if (Math.abs(change) > threshold) {
+            verdict = 'not significant';
+        }
+        if (verdict === 'REGRESSION') regressions.push(name);
+
+        rows.push([
+            name,
+            `${before.toFixed(0)} ${current.time_unit}`,
+            `${after.toFixed(0)} ${current.time_unit}`,
+            `${change >= 0 ? '+' : ''}${(change * 100).toFixed(1)}%`,
+            p.toFixed(3),
+            verdict
+        ]);
+    }
+    for (const name of Object.keys(baseline.benchmarks)) {
+        if (!results.benchmarks[name]) rows.push([name, '', '', '', '', 'missing']);
+    }
+
+    const header = ['Benchmark', 'Baseline', 'Current', 'Change', 'p', ''];
+    const widths = header.map((title, column) =>
+        Math.max.apply(null, [title.length].concat(rows.map((row) => String(row[column]).length))));
+    const format = (row) => row.map((cell, column) =>
+        pad(cell, widths[column], column > 0 && column < 5)).join('  ').trimRight();
+
+    console.log(format(header));
+    console.log(widths.map((width) => '-'.repeat(width)).join('  ').trimRight());
+    rows.forEach((row) => console.log(format(row)));
+    console.log('');
+    console.log(`Median CPU times; changes above ${(threshold * 100).toFixed(1)}% with p < ${alpha} are flagged.`);
+
+    if (regressions.length) {
+        console.log(`${regressions.length} regression(s): ${regressions.join(', ')}`);
+        process.exit(1);
+    }
+}
+
+const command = process.argv[2];
+if (command === 'run') {
+    const args = parseArgs(process.argv.slice(3), { repetitions: '10', filter: '' });
+    if (args.positional.length !== 2) usage();
+    run(args.positional[0], args.positional[1], args.options);
+} else if (command === 'compare') {
+    const args = parseArgs(process.argv.slice(3), { threshold: '0.05', alpha: '0.05' });
+    if (args.positional.length !== 2) usage();
+    compare(args.positional[0], args.positional[1], args.options);
+} else {
+    usage();
+}
@@ -12,7 +12,9 @@ require('./style-code');
     'circle',
     'collision_box',
     'debug',
+    'extrusion_texture',
     'fill',
+    'fill_extrusion',
     'fill_outline',
     'fill_outline_pattern',
     'fill_pattern',
@@ -6,6 +6,7 @@
 #include <mbgl/util/noncopyable.hpp>
 
 #include <memory>
+#include <typeinfo>
 
 namespace mbgl {
 
@@ -48,7 +49,7 @@ class Actor : public util::noncopyable {
 public:
     template <class... Args>
     Actor(Scheduler& scheduler, Args&&... args_)
-        : mailbox(std::make_shared<Mailbox>(scheduler)),
+        : mailbox(std::make_shared<Mailbox>(scheduler, typeid(Object).name())),
           object(self(), std::forward<Args>(args_)...) {
     }
 
@@ -61,6 +62,14 @@ public:
         mailbox->push(actor::makeMessage(object, fn, std::forward<Args>(args)...));
     }
 
+    void setPriority(Mailbox::Priority priority) {
+        mailbox->setPriority(priority);
+    }
+
+    void setDrainPolicy(Mailbox::DrainPolicy policy) {
+        mailbox->setDrainPolicy(policy);
+    }
+
     ActorRef<std::decay_t<Object>> self() {
         return ActorRef<std::decay_t<Object>>(object, mailbox);
     }
@@ -1,53 +1,142 @@
 #include <mbgl/actor/mailbox.hpp>
 #include <mbgl/actor/message.hpp>
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/actor/scheduler_stats.hpp>
+#include <mbgl/util/trace.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <thread>
 
 namespace mbgl {
 
-Mailbox::Mailbox(Scheduler& scheduler_)
-    : scheduler(scheduler_) {
+namespace {
+
+class StubMessage : public Message {
+public:
+    void operator()() override {}
+};
+
+} // namespace
+
+Mailbox::Mailbox(Scheduler& scheduler_, const char* name_)
+    : scheduler(scheduler_),
+      name(name_),
+      stub(std::make_unique<StubMessage>()),
+      head(stub.get()),
+      tail(stub.get()) {
+}
+
+Mailbox::~Mailbox() {
+    // Free messages that were never received, e.g. because the mailbox was closed.
+    while (size > 0) {
+        Message* message = dequeue();
+        if (!message) {
+            break;
+        }
+        delete message;
+        --size;
+    }
+}
+
+void Mailbox::setPriority(Priority priority_) {
+    priority = priority_;
+}
+
+Mailbox::Priority Mailbox::getPriority() const {
+    return priority;
+}
+
+void Mailbox::setDrainPolicy(DrainPolicy policy) {
+    drainMessages = std::max<std::size_t>(policy.maxMessages, 1);
+    drainBudget = policy.budget.count();
 }
 
 void Mailbox::push(std::unique_ptr<Message> message) {
     assert(!closing);
 
-    std::lock_guard<std::mutex> queueLock(queueMutex);
-    bool wasEmpty = queue.empty();
-    queue.push(std::move(message));
-    if (wasEmpty) {
+    SchedulerStats* stats = scheduler.getStats();
+    if (stats && stats->isEnabled()) {
+        message->enqueued = Clock::now();
+    }
+
+#if MBGL_TRACING
+    if (util::trace::isRecording()) {
+        message->traceID = util::trace::nextID();
+        MBGL_TRACE_FLOW_START("actor", name ? name : "message", message->traceID);
+    }
+#endif
+
+    enqueue(message.release());
+    if (size++ == 0) {
         scheduler.schedule(shared_from_this());
     }
 }
 
 void Mailbox::close() {
-    // Block until the scheduler is guaranteed not to be executing receive().
-    std::lock_guard<std::mutex> closingLock(closingMutex);
     closing = true;
+
+    // Block until the scheduler is guaranteed not to be executing receive().
+    while (receiving) {
+        std::this_thread::yield();
+    }
 }
 
 void Mailbox::receive() {
-    std::lock_guard<std::mutex> closingLock(closingMutex);
+    receiving = true;
 
-    if (closing) {
-        return;
+    const std::size_t maxMessages = drainMessages;
+    const Duration budget(drainBudget.load());
+    const TimePoint start = budget > Duration::zero() ? Clock::now() : TimePoint();
+
+    SchedulerStats* stats = scheduler.getStats();
+    if (stats && !stats->isEnabled()) {
+        stats = nullptr;
     }
 
-    std::unique_ptr<Message> message;
-    bool wasEmpty;
+    // `size` is only decremented once this turn is over, so that pushes made while we are
+    // processing don't hand the mailbox to the scheduler a second time.
+    std::size_t processed = 0;
+    do {
+        if (closing) {
+            receiving = false;
+            return;
+        }
 
-    {
-        std::lock_guard<std::mutex> queueLock(queueMutex);
-        assert(!queue.empty());
-        message = std::move(queue.front());
-        queue.pop();
-        wasEmpty = queue.empty();
-    }
+        // `size` was incremented after the message was linked in, but another producer
+        // that started earlier may still be between its exchange and its link; wait for it.
+        Message* message;
+        while (!(message = dequeue())) {
+            std::this_thread::yield();
+        }
+
+        MBGL_TRACE_SCOPE("actor", name ? name : "message");
+#if MBGL_TRACING
+        if (message->traceID) {
+            MBGL_TRACE_FLOW_END("actor", name ? name : "message", message->traceID);
+        }
+#endif
+
+        if (stats) {
+            const TimePoint begin = Clock::now();
+            if (message->enqueued != TimePoint()) {
+                stats->recordLatency(begin - message->enqueued);
+            }
+            (*message)();
+            stats->recordExecution(name, Clock::now() - begin);
+        } else {
+            (*message)();
+        }
+
+        delete message;
+        ++processed;
+    } while (processed < maxMessages &&
+             size > processed &&
+             (budget == Duration::zero() || Clock::now() - start < budget));
 
-    (*message)();
+    receiving = false;
 
-    if (!wasEmpty) {
+    if (size.fetch_sub(processed) > processed) {
         scheduler.schedule(shared_from_this());
     }
 }
@@ -58,4 +147,44 @@ void Mailbox::maybeReceive(std::weak_ptr<Mailbox> mailbox) {
     }
 }
 
+void Mailbox::enqueue(Message* message) {
+    message->next.store(nullptr, std::memory_order_relaxed);
+    Message* prev = head.exchange(message, std::memory_order_acq_rel);
+    prev->next.store(message, std::memory_order_release);
+}
+
+Message* Mailbox::dequeue() {
+    Message* first = tail;
+    Message* next = first->next.load(std::memory_order_acquire);
+
+    if (first == stub.get()) {
+        if (!next) {
+            return nullptr;
+        }
+        tail = first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        tail = next;
+        return first;
+    }
+
+    if (first != head.load(std::memory_order_acquire)) {
+        // A producer is in the middle of linking a new message.
+        return nullptr;
+    }
+
+    // `first` is the last message; put the stub behind it so it can be unlinked.
+    enqueue(stub.get());
+
+    next = first->next.load(std::memory_order_acquire);
+    if (next) {
+        tail = next;
+        return first;
+    }
+
+    return nullptr;
+}
+
 } // namespace mbgl
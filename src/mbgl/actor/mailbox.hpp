@@ -1,8 +1,10 @@
 #pragma once
 
+#include <mbgl/util/chrono.hpp>
+
+#include <atomic>
+#include <cstdint>
 #include <memory>
-#include <mutex>
-#include <queue>
 
 namespace mbgl {
 
@@ -11,7 +13,34 @@ class Message;
 
 class Mailbox : public std::enable_shared_from_this<Mailbox> {
 public:
-    Mailbox(Scheduler&);
+    // `name` is used to attribute execution time in `SchedulerStats` and must have static
+    // storage duration. `Actor<O>` passes the (implementation-defined) type name of `O`.
+    Mailbox(Scheduler&, const char* name = nullptr);
+    ~Mailbox();
+
+    // A hint to the scheduler about how urgently this mailbox should be processed,
+    // relative to other mailboxes on the same scheduler. Schedulers that don't
+    // support priorities ignore it. Changing the priority never reorders messages
+    // within the mailbox; it takes effect the next time the mailbox is scheduled.
+    enum class Priority : uint8_t {
+        Low,
+        Normal,
+        High,
+    };
+
+    void setPriority(Priority);
+    Priority getPriority() const;
+
+    // By default, receive() processes a single message and then hands the mailbox back to
+    // the scheduler, so that other mailboxes get a turn. A mailbox for a chatty actor can
+    // instead process up to `maxMessages` queued messages per turn, stopping early once
+    // `budget` has elapsed (a zero budget means no time limit).
+    struct DrainPolicy {
+        std::size_t maxMessages = 1;
+        Duration budget = Duration::zero();
+    };
+
+    void setDrainPolicy(DrainPolicy);
 
     void push(std::unique_ptr<Message>);
 
@@ -23,11 +52,34 @@ public:
 private:
     Scheduler& scheduler;
 
-    std::mutex closingMutex;
-    bool closing { false };
+    std::atomic<Priority> priority { Priority::Normal };
+
+    const char* const name;
+
+    std::atomic<std::size_t> drainMessages { 1 };
+    std::atomic<Duration::rep> drainBudget { 0 };
+
+    // `closing` and `receiving` together implement the blocking semantics of close():
+    // receive() announces itself before checking `closing`, and close() waits for
+    // any announced receive() to finish after setting it.
+    std::atomic<bool> closing { false };
+    std::atomic<bool> receiving { false };
+
+    // Intrusive multi-producer/single-consumer queue linked through `Message::next`
+    // (Vyukov). Producers only touch `head`; the single consumer (whichever thread
+    // the scheduler runs receive() on) owns `tail`. `stub` is a permanent dummy node
+    // that keeps the list non-empty.
+    void enqueue(Message*);
+    Message* dequeue();
+
+    std::unique_ptr<Message> stub;
+    std::atomic<Message*> head;
+    Message* tail;
 
-    std::mutex queueMutex;
-    std::queue<std::unique_ptr<Message>> queue;
+    // Number of messages pushed but not yet fully processed. The mailbox is handed to
+    // the scheduler exactly when this goes from 0 to 1, and rescheduled by receive()
+    // while it stays positive, so it is never in the scheduler's queue twice.
+    std::atomic<std::size_t> size { 0 };
 };
 
 } // namespace mbgl
@@ -0,0 +1,161 @@
+#include <mbgl/actor/message.hpp>
+#include <mbgl/util/thread_local.hpp>
+
+#include <mutex>
+#include <new>
+
+namespace mbgl {
+namespace actor {
+
+namespace {
+
+constexpr std::size_t sizeClasses[] = { 64, 128, 256 };
+constexpr std::size_t sizeClassCount = sizeof(sizeClasses) / sizeof(sizeClasses[0]);
+
+// Number of free blocks per size class a thread may hold before returning a batch.
+constexpr std::size_t threadCacheLimit = 256;
+// Number of blocks moved between a thread cache and the shared pool at once.
+constexpr std::size_t batchSize = 64;
+
+std::size_t sizeClassFor(std::size_t size) {
+    for (std::size_t i = 0; i < sizeClassCount; ++i) {
+        if (size <= sizeClasses[i]) {
+            return i;
+        }
+    }
+    return sizeClassCount;
+}
+
+struct Block {
+    Block* next;
+};
+
+struct FreeList {
+    Block* head = nullptr;
+    std::size_t count = 0;
+
+    void push(Block* block) {
+        block->next = head;
+        head = block;
+        ++count;
+    }
+
+    Block* pop() {
+        Block* block = head;
+        if (block) {
+            head = block->next;
+            --count;
+        }
+        return block;
+    }
+
+    // Moves up to `n` blocks from this list to `other`.
+    void transfer(FreeList& other, std::size_t n) {
+        while (n-- && head) {
+            other.push(pop());
+        }
+    }
+};
+
+std::atomic<uint64_t> allocations { 0 };
+std::atomic<uint64_t> reused { 0 };
+std::atomic<uint64_t> oversized { 0 };
+
+class SharedPool {
+public:
+    void fill(FreeList& list, std::size_t sizeClass) {
+        std::lock_guard<std::mutex> lock(mutex);
+        lists[sizeClass].transfer(list, batchSize);
+    }
+
+    void drain(FreeList& list, std::size_t sizeClass, std::size_t n) {
+        std::lock_guard<std::mutex> lock(mutex);
+        list.transfer(lists[sizeClass], n);
+    }
+
+private:
+    std::mutex mutex;
+    FreeList lists[sizeClassCount];
+};
+
+// Intentionally leaked, so that thread caches can return blocks during static destruction.
+SharedPool& sharedPool = *new SharedPool;
+
+class ThreadCache {
+public:
+    ~ThreadCache() {
+        for (std::size_t i = 0; i < sizeClassCount; ++i) {
+            sharedPool.drain(lists[i], i, lists[i].count);
+        }
+    }
+
+    void* allocate(std::size_t sizeClass) {
+        FreeList& list = lists[sizeClass];
+        if (!list.head) {
+            sharedPool.fill(list, sizeClass);
+        }
+        if (Block* block = list.pop()) {
+            reused.fetch_add(1, std::memory_order_relaxed);
+            return block;
+        }
+        return ::operator new(sizeClasses[sizeClass]);
+    }
+
+    void deallocate(void* ptr, std::size_t sizeClass) {
+        FreeList& list = lists[sizeClass];
+        list.push(static_cast<Block*>(ptr));
+        if (list.count > threadCacheLimit) {
+            sharedPool.drain(list, sizeClass, batchSize);
+        }
+    }
+
+private:
+    FreeList lists[sizeClassCount];
+};
+
+util::ThreadLocal<ThreadCache>& threadCache = *new util::ThreadLocal<ThreadCache>;
+
+ThreadCache& currentThreadCache() {
+    ThreadCache* cache = threadCache.get();
+    if (!cache) {
+        // Deleted by ThreadLocal when the thread exits.
+        cache = new ThreadCache;
+        threadCache.set(cache);
+    }
+    return *cache;
+}
+
+} // namespace
+
+void* allocateMessage(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    const std::size_t sizeClass = sizeClassFor(size);
+    if (sizeClass == sizeClassCount) {
+        oversized.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    return currentThreadCache().allocate(sizeClass);
+}
+
+void deallocateMessage(void* ptr, std::size_t size) {
+    const std::size_t sizeClass = sizeClassFor(size);
+    if (sizeClass == sizeClassCount) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    currentThreadCache().deallocate(ptr, sizeClass);
+}
+
+MessageAllocationStats messageAllocationStats() {
+    MessageAllocationStats stats;
+    stats.allocations = allocations.load(std::memory_order_relaxed);
+    stats.reused = reused.load(std::memory_order_relaxed);
+    stats.oversized = oversized.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace actor
+} // namespace mbgl
@@ -1,9 +1,40 @@
 #pragma once
 
+#include <mbgl/util/chrono.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
 #include <utility>
 
 namespace mbgl {
 
+namespace actor {
+
+// Messages are allocated from a pool of fixed-size blocks instead of the general purpose
+// heap. Each thread keeps a small cache of free blocks per size class, and exchanges
+// batches of blocks with a shared pool when its cache runs empty or overflows, so that
+// messages allocated on one thread and freed on another (the common case) are recycled
+// without taking a lock for every message. Messages larger than the biggest size class
+// fall back to the regular heap.
+void* allocateMessage(std::size_t size);
+void deallocateMessage(void* ptr, std::size_t size);
+
+struct MessageAllocationStats {
+    // Total number of messages allocated.
+    uint64_t allocations = 0;
+    // Allocations served from a recycled block.
+    uint64_t reused = 0;
+    // Allocations too large for the pool, served by the regular heap.
+    uint64_t oversized = 0;
+};
+
+MessageAllocationStats messageAllocationStats();
+
+} // namespace actor
+
 // A movable type-erasing function wrapper. This allows to store arbitrary invokable
 // things (like std::function<>, or the result of a movable-only std::bind()) in the queue.
 // Source: http://stackoverflow.com/a/29642072/331379
@@ -11,6 +42,27 @@ class Message {
 public:
     virtual ~Message() = default;
     virtual void operator()() = 0;
+
+    static void* operator new(std::size_t size) {
+        return actor::allocateMessage(size);
+    }
+
+    static void operator delete(void* ptr, std::size_t size) {
+        actor::deallocateMessage(ptr, size);
+    }
+
+private:
+    // Intrusive link used by the lock-free queue in `Mailbox`.
+    friend class Mailbox;
+    std::atomic<Message*> next { nullptr };
+
+    // Time at which the message was pushed, if the scheduler records stats.
+    TimePoint enqueued;
+
+#if MBGL_TRACING
+    // The flow from the sender to the receiver, if it was pushed while tracing.
+    uint64_t traceID = 0;
+#endif
 };
 
 template <class Object, class MemberFn, class ArgsTuple>
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 
 namespace mbgl {
 
 class Mailbox;
+class SchedulerStats;
 
 /*
     A `Scheduler` is responsible for coordinating the processing of messages by
@@ -19,7 +21,8 @@ class Mailbox;
         concurrency within a mailbox
 
       Subject to these constraints, processing can happen on whatever thread in the
-      pool is available.
+      pool is available. Mailboxes with a higher `Mailbox::Priority` are processed
+      before those with a lower one.
 
     * `RunLoop` is a `Scheduler` that is typically used to create a mailbox and
       `ActorRef` for an object that lives on the main thread and is not itself wrapped
@@ -33,6 +36,16 @@ class Scheduler {
 public:
     virtual ~Scheduler() = default;
     virtual void schedule(std::weak_ptr<Mailbox>) = 0;
+
+    // Instrumentation for this scheduler, or nullptr if it doesn't record any.
+    virtual SchedulerStats* getStats() {
+        return nullptr;
+    }
+
+    // The number of mailboxes this scheduler may process at once.
+    virtual std::size_t getConcurrency() const {
+        return 1;
+    }
 };
 
 } // namespace mbgl
@@ -0,0 +1,102 @@
+#include <mbgl/actor/scheduler_stats.hpp>
+#include <mbgl/util/logging.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+namespace {
+
+using Microseconds = std::chrono::microseconds;
+
+long long toMicroseconds(Duration duration) {
+    return static_cast<long long>(std::chrono::duration_cast<Microseconds>(duration).count());
+}
+
+} // namespace
+
+const std::array<Duration, 6> SchedulerStats::latencyBounds = {{
+    Microseconds(10), Microseconds(100), Milliseconds(1), Milliseconds(10), Milliseconds(100), Seconds(1)
+}};
+
+SchedulerStats::SchedulerStats() {
+    reset();
+}
+
+void SchedulerStats::setEnabled(bool enabled_) {
+    enabled = enabled_;
+}
+
+void SchedulerStats::recordQueueDepth(std::size_t depth) {
+    queueDepth.store(depth, std::memory_order_relaxed);
+
+    std::size_t max = maxQueueDepth.load(std::memory_order_relaxed);
+    while (depth > max && !maxQueueDepth.compare_exchange_weak(max, depth, std::memory_order_relaxed)) {
+    }
+}
+
+void SchedulerStats::recordLatency(Duration duration) {
+    const auto it = std::upper_bound(latencyBounds.begin(), latencyBounds.end(), duration);
+    latency[it - latencyBounds.begin()].fetch_add(1, std::memory_order_relaxed);
+}
+
+void SchedulerStats::recordExecution(const char* actor, Duration duration) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ActorStats& stats = actors[actor];
+    stats.messages++;
+    stats.total += duration;
+    stats.max = std::max(stats.max, duration);
+}
+
+SchedulerStats::Snapshot SchedulerStats::snapshot() const {
+    Snapshot result;
+    result.queueDepth = queueDepth.load(std::memory_order_relaxed);
+    result.maxQueueDepth = maxQueueDepth.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < latency.size(); ++i) {
+        result.latency[i] = latency[i].load(std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& pair : actors) {
+        result.actors.emplace(pair.first ? pair.first : "(unnamed)", pair.second);
+    }
+    return result;
+}
+
+void SchedulerStats::reset() {
+    queueDepth = 0;
+    maxQueueDepth = 0;
+    for (auto& bucket : latency) {
+        bucket = 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    actors.clear();
+}
+
+void SchedulerStats::dumpDebugLogs() const {
+    const Snapshot stats = snapshot();
+
+    Log::Info(Event::General, "Scheduler::queueDepth: %llu (max %llu)",
+              static_cast<unsigned long long>(stats.queueDepth),
+              static_cast<unsigned long long>(stats.maxQueueDepth));
+
+    static const char* const labels[] = {
+        "<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s"
+    };
+    for (std::size_t i = 0; i < stats.latency.size(); ++i) {
+        Log::Info(Event::General, "Scheduler::latency %s: %llu", labels[i],
+                  static_cast<unsigned long long>(stats.latency[i]));
+    }
+
+    for (const auto& pair : stats.actors) {
+        const auto& actor = pair.second;
+        Log::Info(Event::General, "Scheduler::actor %s: %llu messages, %lldus total, %lldus max",
+                  pair.first.c_str(),
+                  static_cast<unsigned long long>(actor.messages),
+                  toMicroseconds(actor.total),
+                  toMicroseconds(actor.max));
+    }
+}
+
+} // namespace mbgl
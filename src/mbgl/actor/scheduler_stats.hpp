@@ -0,0 +1,70 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+/*
+    Optional instrumentation for a `Scheduler`. When enabled, mailboxes processed by the
+    scheduler record how long each message waited between being pushed and being received,
+    and how long it took to execute, tagged by the type of the receiving actor. The scheduler
+    itself records the depth of its queue.
+
+    Recording is thread-safe. Stats are disabled by default, in which case mailboxes skip
+    all timing calls.
+*/
+
+class SchedulerStats {
+public:
+    // Upper bounds of the latency histogram buckets; the last bucket is unbounded.
+    static const std::array<Duration, 6> latencyBounds;
+    using Histogram = std::array<uint64_t, 7>;
+
+    struct ActorStats {
+        uint64_t messages = 0;
+        Duration total = Duration::zero();
+        Duration max = Duration::zero();
+    };
+
+    struct Snapshot {
+        std::size_t queueDepth = 0;
+        std::size_t maxQueueDepth = 0;
+        Histogram latency {};
+        std::unordered_map<std::string, ActorStats> actors;
+    };
+
+    SchedulerStats();
+
+    void setEnabled(bool);
+    bool isEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    void recordQueueDepth(std::size_t);
+    void recordLatency(Duration);
+    void recordExecution(const char* actor, Duration);
+
+    Snapshot snapshot() const;
+    void reset();
+
+    void dumpDebugLogs() const;
+
+private:
+    std::atomic<bool> enabled { false };
+    std::atomic<std::size_t> queueDepth;
+    std::atomic<std::size_t> maxQueueDepth;
+    std::array<std::atomic<uint64_t>, 7> latency;
+
+    // Keyed by the actor's type name, which has static storage duration.
+    mutable std::mutex mutex;
+    std::unordered_map<const char*, ActorStats> actors;
+};
+
+} // namespace mbgl
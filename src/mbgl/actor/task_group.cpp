@@ -0,0 +1,108 @@
+#include <mbgl/actor/task_group.hpp>
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/actor/message.hpp>
+#include <mbgl/actor/scheduler.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mbgl {
+
+namespace {
+
+class Batch {
+public:
+    Batch(std::size_t count_, const TaskGroup::Task& task_)
+        : count(count_), task(task_) {
+    }
+
+    // Claims and runs tasks until none are left. Once a task has failed, the remaining
+    // ones are still claimed, so that they are accounted for, but not run.
+    void work(std::size_t lane) {
+        std::size_t i;
+        while ((i = next++) < count) {
+            if (!failed) {
+                try {
+                    task(i, lane);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                    failed = true;
+                }
+            }
+
+            if (++settled == count) {
+                std::lock_guard<std::mutex> lock(mutex);
+                cv.notify_all();
+            }
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return settled == count; });
+    }
+
+    std::exception_ptr getError() const {
+        return error;
+    }
+
+private:
+    const std::size_t count;
+    const TaskGroup::Task& task;
+
+    std::atomic<std::size_t> next { 0 };
+    std::atomic<std::size_t> settled { 0 };
+    std::atomic<bool> failed { false };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::exception_ptr error;
+};
+
+} // namespace
+
+TaskGroup::TaskGroup(Scheduler& scheduler_)
+    : scheduler(scheduler_),
+      maxHelpers(std::max<std::size_t>(scheduler.getConcurrency(), 1) - 1) {
+}
+
+void TaskGroup::run(std::size_t count, const Task& task) {
+    if (count == 0) {
+        return;
+    }
+
+    Batch batch(count, task);
+
+    // Each helper gets a mailbox of its own, so that the scheduler may run them all at
+    // once. The mailboxes are only referenced weakly by the scheduler; those that haven't
+    // had a turn by the time the batch is complete are dropped along with it.
+    std::vector<std::shared_ptr<Mailbox>> helpers;
+    const std::size_t helperCount = std::min(maxHelpers, count - 1);
+    helpers.reserve(helperCount);
+    for (std::size_t lane = 1; lane <= helperCount; ++lane) {
+        helpers.push_back(std::make_shared<Mailbox>(scheduler, "TaskGroup"));
+        helpers.back()->push(actor::makeMessage(batch, &Batch::work, lane));
+    }
+
+    batch.work(0);
+    batch.wait();
+
+    // A helper may still be on its way out of `Batch::work`.
+    for (auto& helper : helpers) {
+        helper->close();
+    }
+
+    if (batch.getError()) {
+        std::rethrow_exception(batch.getError());
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <functional>
+
+namespace mbgl {
+
+class Scheduler;
+
+/*
+    Spreads a batch of independent tasks over a `Scheduler`, so that an actor receiving one
+    expensive message can use threads that would otherwise sit idle, and waits for the
+    whole batch.
+
+    The calling thread takes part in the batch: it claims tasks just like the helpers it
+    hands to the scheduler, and only ever waits for tasks that a helper has already
+    started. A batch therefore completes even when the scheduler has no idle thread, or
+    when the caller occupies the scheduler's only thread; helpers that get a turn after
+    the last task was claimed find nothing left to do.
+
+    Tasks run concurrently with each other and must not share unsynchronised state. Each
+    task is told which lane runs it: lane 0 is the calling thread, and the others are
+    helpers. A lane runs one task at a time, so per-lane scratch state can be used without
+    locking. There is one helper less than `Scheduler::getConcurrency()`.
+*/
+class TaskGroup : private util::noncopyable {
+public:
+    explicit TaskGroup(Scheduler&);
+
+    using Task = std::function<void (std::size_t task, std::size_t lane)>;
+
+    // Calls `task(i, lane)` once for every i in [0, count), and returns once all calls have
+    // returned. If any of them throws, the remaining tasks are skipped and the first
+    // exception is rethrown.
+    void run(std::size_t count, const Task&);
+
+    std::size_t lanes() const {
+        return maxHelpers + 1;
+    }
+
+private:
+    Scheduler& scheduler;
+    const std::size_t maxHelpers;
+};
+
+} // namespace mbgl
@@ -12,6 +12,8 @@
 
 #include <boost/function_output_iterator.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 using namespace style;
@@ -43,9 +45,24 @@ AnnotationID AnnotationManager::addAnnotation(const Annotation& annotation, cons
     Annotation::visit(annotation, [&] (const auto& annotation_) {
         this->add(id, annotation_, maxZoom);
     });
+    indexSymbols();
     return id;
 }
 
+AnnotationIDs AnnotationManager::addAnnotations(const std::vector<Annotation>& annotations, const uint8_t maxZoom) {
+    AnnotationIDs ids;
+    ids.reserve(annotations.size());
+    for (const auto& annotation : annotations) {
+        AnnotationID id = nextID++;
+        Annotation::visit(annotation, [&] (const auto& annotation_) {
+            this->add(id, annotation_, maxZoom);
+        });
+        ids.push_back(id);
+    }
+    indexSymbols();
+    return ids;
+}
+
 Update AnnotationManager::updateAnnotation(const AnnotationID& id, const Annotation& annotation, const uint8_t maxZoom) {
     return Annotation::visit(annotation, [&] (const auto& annotation_) {
         return this->update(id, annotation_, maxZoom);
@@ -53,10 +70,13 @@ Update AnnotationManager::updateAnnotation(const AnnotationID& id, const Annotat
 }
 
 void AnnotationManager::removeAnnotation(const AnnotationID& id) {
-    if (symbolAnnotations.find(id) != symbolAnnotations.end()) {
-        symbolTree.remove(symbolAnnotations.at(id));
-        symbolAnnotations.erase(id);
+    auto it = symbolAnnotations.find(id);
+    if (it != symbolAnnotations.end()) {
+        invalidate(*it->second);
+        symbolTree.remove(it->second.get());
+        symbolAnnotations.erase(it);
     } else if (shapeAnnotations.find(id) != shapeAnnotations.end()) {
+        invalidateAll();
         obsoleteShapeAnnotationLayers.insert(shapeAnnotations.at(id)->layerID);
         shapeAnnotations.erase(id);
     } else {
@@ -64,28 +84,91 @@ void AnnotationManager::removeAnnotation(const AnnotationID& id) {
     }
 }
 
+void AnnotationManager::removeAnnotations(const AnnotationIDs& ids) {
+    std::size_t symbols = 0;
+    for (const auto& id : ids) {
+        symbols += symbolAnnotations.count(id);
+    }
+
+    if (2 * symbols <= symbolAnnotations.size()) {
+        for (const auto& id : ids) {
+            removeAnnotation(id);
+        }
+        return;
+    }
+
+    // The index is dropped before the annotations it points to.
+    symbolTree.clear();
+    for (const auto& id : ids) {
+        auto it = symbolAnnotations.find(id);
+        if (it == symbolAnnotations.end()) {
+            removeAnnotation(id);
+            continue;
+        }
+        invalidate(*it->second);
+        symbolAnnotations.erase(it);
+    }
+    rebuildSymbolTree();
+}
+
+AnnotationIDs AnnotationManager::querySymbolAnnotations(const LatLngBounds& bounds) const {
+    AnnotationIDs ids;
+    symbolTree.query(boost::geometry::index::intersects(bounds),
+        boost::make_function_output_iterator([&](const SymbolAnnotationImpl* impl) {
+            ids.push_back(impl->id);
+        }));
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
 void AnnotationManager::add(const AnnotationID& id, const SymbolAnnotation& annotation, const uint8_t) {
-    auto impl = std::make_shared<SymbolAnnotationImpl>(id, annotation);
-    symbolTree.insert(impl);
-    symbolAnnotations.emplace(id, impl);
+    // Indexed by `indexSymbols`, once the batch being added is complete.
+    auto& impl = symbolAnnotations.emplace(id, std::make_unique<SymbolAnnotationImpl>(id, annotation)).first->second;
+    unindexedSymbols.push_back(impl.get());
+    invalidate(*impl);
+}
+
+void AnnotationManager::indexSymbols() {
+    if (unindexedSymbols.size() > symbolTree.size()) {
+        // Bulk loading packs the tree, which makes it faster to query, too.
+        rebuildSymbolTree();
+    } else {
+        for (const auto& impl : unindexedSymbols) {
+            symbolTree.insert(impl);
+        }
+    }
+    unindexedSymbols.clear();
+}
+
+void AnnotationManager::rebuildSymbolTree() {
+    std::vector<const SymbolAnnotationImpl*> impls;
+    impls.reserve(symbolAnnotations.size());
+    for (const auto& pair : symbolAnnotations) {
+        impls.push_back(pair.second.get());
+    }
+    symbolTree = SymbolAnnotationTree(impls.begin(), impls.end());
+    unindexedSymbols.clear();
 }
 
 void AnnotationManager::add(const AnnotationID& id, const LineAnnotation& annotation, const uint8_t maxZoom) {
     ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
         std::make_unique<LineAnnotationImpl>(id, annotation, maxZoom)).first->second;
     obsoleteShapeAnnotationLayers.erase(impl.layerID);
+    invalidateAll();
 }
 
 void AnnotationManager::add(const AnnotationID& id, const FillAnnotation& annotation, const uint8_t maxZoom) {
     ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
         std::make_unique<FillAnnotationImpl>(id, annotation, maxZoom)).first->second;
     obsoleteShapeAnnotationLayers.erase(impl.layerID);
+    invalidateAll();
 }
 
 void AnnotationManager::add(const AnnotationID& id, const StyleSourcedAnnotation& annotation, const uint8_t maxZoom) {
     ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
         std::make_unique<StyleSourcedAnnotationImpl>(id, annotation, maxZoom)).first->second;
     obsoleteShapeAnnotationLayers.erase(impl.layerID);
+    invalidateAll();
 }
 
 Update AnnotationManager::update(const AnnotationID& id, const SymbolAnnotation& annotation, const uint8_t maxZoom) {
@@ -149,6 +232,7 @@ void AnnotationManager::removeAndAdd(const AnnotationID& id, const Annotation& a
     Annotation::visit(annotation, [&] (const auto& annotation_) {
         this->add(id, annotation_, maxZoom);
     });
+    indexSymbols();
 }
 
 std::unique_ptr<AnnotationTileData> AnnotationManager::getTileData(const CanonicalTileID& tileID) {
@@ -205,10 +289,51 @@ void AnnotationManager::updateStyle(Style& style) {
     obsoleteShapeAnnotationLayers.clear();
 }
 
+void AnnotationManager::invalidate(const SymbolAnnotationImpl& impl) {
+    // Past this many, checking the positions against each tile costs more than refreshing all.
+    static constexpr std::size_t maxInvalidPositions = 1024;
+
+    if (allTilesInvalid) {
+        return;
+    }
+    if (invalidPositions.size() == maxInvalidPositions) {
+        invalidateAll();
+        return;
+    }
+    const Point<double>& p = impl.annotation.geometry;
+    invalidPositions.emplace_back(p.y, p.x);
+}
+
+void AnnotationManager::invalidateAll() {
+    allTilesInvalid = true;
+    invalidPositions.clear();
+}
+
+bool AnnotationManager::isInvalid(const CanonicalTileID& tileID) const {
+    if (allTilesInvalid) {
+        return true;
+    }
+    const LatLngBounds tileBounds(tileID);
+    return std::any_of(invalidPositions.begin(), invalidPositions.end(), [&] (const LatLng& position) {
+        return tileBounds.contains(position);
+    });
+}
+
 void AnnotationManager::updateData() {
+    const bool hasAnnotations = !symbolAnnotations.empty() || !shapeAnnotations.empty();
+    if (hasAnnotations != hadAnnotations) {
+        invalidateAll();
+        hadAnnotations = hasAnnotations;
+    }
+
     for (auto& tile : tiles) {
-        tile->setData(getTileData(tile->id.canonical));
+        if (isInvalid(tile->id.canonical)) {
+            tile->setData(getTileData(tile->id.canonical));
+        }
     }
+
+    invalidPositions.clear();
+    allTilesInvalid = false;
 }
 
 void AnnotationManager::addTile(AnnotationTile& tile) {
@@ -32,12 +32,22 @@ public:
     Update updateAnnotation(const AnnotationID&, const Annotation&, const uint8_t maxZoom);
     void removeAnnotation(const AnnotationID&);
 
+    // Like adding or removing annotations one by one, but when a batch outnumbers the symbol
+    // annotations it leaves in place, the symbol index is bulk loaded instead of updated.
+    AnnotationIDs addAnnotations(const std::vector<Annotation>&, const uint8_t maxZoom);
+    void removeAnnotations(const AnnotationIDs&);
+
+    // The symbol annotations positioned within the bounds, in ID order.
+    AnnotationIDs querySymbolAnnotations(const LatLngBounds&) const;
+
     void addIcon(const std::string& name, std::shared_ptr<const SpriteImage>);
     void removeIcon(const std::string& name);
     double getTopOffsetPixelsForIcon(const std::string& name);
     SpriteAtlas& getSpriteAtlas() { return spriteAtlas; }
 
     void updateStyle(style::Style&);
+
+    // Refreshes the data of the tiles touched by the changes since the last call.
     void updateData();
 
     void addTile(AnnotationTile&);
@@ -59,21 +69,42 @@ private:
 
     void removeAndAdd(const AnnotationID&, const Annotation&, const uint8_t);
 
+    // Marks the tiles containing a symbol annotation's position as needing new data.
+    void invalidate(const SymbolAnnotationImpl&);
+    void invalidateAll();
+    bool isInvalid(const CanonicalTileID&) const;
+
+    // Adds the symbol annotations added since the last call to the index.
+    void indexSymbols();
+    void rebuildSymbolTree();
+
     std::unique_ptr<AnnotationTileData> getTileData(const CanonicalTileID&);
 
     AnnotationID nextID = 0;
 
-    using SymbolAnnotationTree = boost::geometry::index::rtree<std::shared_ptr<const SymbolAnnotationImpl>, boost::geometry::index::rstar<16, 4>>;
+    // Indexes the annotations owned by `symbolAnnotations`, so that queries don't copy
+    // shared pointers.
+    using SymbolAnnotationTree = boost::geometry::index::rtree<const SymbolAnnotationImpl*, boost::geometry::index::rstar<16, 4>>;
     // Unlike std::unordered_map, std::map is guaranteed to sort by AnnotationID, ensuring that older annotations are below newer annotations.
     // <https://github.com/mapbox/mapbox-gl-native/issues/5691>
-    using SymbolAnnotationMap = std::map<AnnotationID, std::shared_ptr<SymbolAnnotationImpl>>;
+    using SymbolAnnotationMap = std::map<AnnotationID, std::unique_ptr<SymbolAnnotationImpl>>;
     using ShapeAnnotationMap = std::map<AnnotationID, std::unique_ptr<ShapeAnnotationImpl>>;
 
     SymbolAnnotationTree symbolTree;
     SymbolAnnotationMap symbolAnnotations;
+    std::vector<const SymbolAnnotationImpl*> unindexedSymbols;
     ShapeAnnotationMap shapeAnnotations;
     std::unordered_set<std::string> obsoleteShapeAnnotationLayers;
     std::unordered_set<AnnotationTile*> tiles;
+
+    // Changes since the last `updateData`. Shape annotations are tiled by geojson-vt, with a
+    // buffer and wrapped around the antimeridian, so changing one invalidates every tile.
+    std::vector<LatLng> invalidPositions;
+    bool allTilesInvalid = false;
+
+    // Whether there were annotations at the last `updateData`; tiles don't have any data
+    // while there are none.
+    bool hadAnnotations = false;
     SpriteAtlas spriteAtlas;
 };
 
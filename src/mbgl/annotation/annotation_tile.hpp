@@ -18,8 +18,6 @@ public:
                    const style::UpdateParameters&);
     ~AnnotationTile() override;
 
-    void setNecessity(Necessity) final;
-
 private:
     AnnotationManager& annotationManager;
 };
@@ -47,15 +47,15 @@ public:
 
 } // namespace mbgl
 
-// Tell Boost Geometry how to access a std::shared_ptr<mbgl::SymbolAnnotation> object.
+// Tell Boost Geometry how to access a mbgl::SymbolAnnotationImpl object through a pointer.
 namespace boost {
 namespace geometry {
 namespace index {
 
 template <>
-struct indexable<std::shared_ptr<const mbgl::SymbolAnnotationImpl>> {
+struct indexable<const mbgl::SymbolAnnotationImpl*> {
     using result_type = mbgl::LatLng;
-    mbgl::LatLng operator()(const std::shared_ptr<const mbgl::SymbolAnnotationImpl>& v) const {
+    mbgl::LatLng operator()(const mbgl::SymbolAnnotationImpl* v) const {
         const mbgl::Point<double>& p = v->annotation.geometry;
         return mbgl::LatLng(p.y, p.x);
     }
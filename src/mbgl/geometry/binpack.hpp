@@ -2,6 +2,7 @@
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/rect.hpp>
+#include <cassert>
 #include <cstdint>
 #include <list>
 
@@ -11,8 +12,22 @@ template <typename T>
 class BinPack : private util::noncopyable {
 public:
     BinPack(T width, T height)
-        : free(1, Rect<uint16_t>{ 0, 0, width, height }) {}
+        : binWidth(width), binHeight(height), free(1, Rect<uint16_t>{ 0, 0, width, height }) {}
 public:
+    // Makes the bin larger. Existing allocations keep their place; the new space to the
+    // right and at the bottom is added to the free list.
+    void grow(T width, T height) {
+        assert(width >= binWidth && height >= binHeight);
+        if (width > binWidth) {
+            release(Rect<T>{ binWidth, 0, T(width - binWidth), binHeight });
+        }
+        if (height > binHeight) {
+            release(Rect<T>{ 0, binHeight, width, T(height - binHeight) });
+        }
+        binWidth = width;
+        binHeight = height;
+    }
+
     Rect<T> allocate(T width, T height) {
         // Find the smallest free rect angle
         auto smallest = free.end();
@@ -95,6 +110,8 @@ public:
     };
 
 private:
+    T binWidth;
+    T binHeight;
     std::list<Rect<T>> free;
 };
 
@@ -4,6 +4,7 @@
 #include <mbgl/style/layer_impl.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/text/collision_tile.hpp>
+#include <mbgl/tile/layout_cache.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/math.hpp>
 #include <mbgl/math/minmax.hpp>
@@ -15,21 +16,90 @@
 
 #include <cassert>
 #include <string>
+#include <type_traits>
 
 namespace mbgl {
 
+static_assert(std::is_trivially_copyable<IndexedSubfeature>::value, "expected trivially copyable IndexedSubfeature");
+
 FeatureIndex::FeatureIndex()
     : grid(util::EXTENT, 16, 0) {
 }
 
-void FeatureIndex::insert(const GeometryCollection& geometries,
-                          std::size_t index,
-                          const std::string& sourceLayerName,
-                          const std::string& bucketName) {
+namespace {
+
+template <class Fn>
+void forEachRingBox(const GeometryBuffer& geometries, Fn&& fn) {
     for (const auto& ring : geometries) {
-        grid.insert(IndexedSubfeature { index, sourceLayerName, bucketName, sortIndex++ },
-                    mapbox::geometry::envelope(ring));
+        if (ring.empty()) {
+            continue;
+        }
+
+        GridIndex<IndexedSubfeature>::BBox bbox { ring.front(), ring.front() };
+        for (const auto& point : ring) {
+            bbox.min.x = std::min(bbox.min.x, point.x);
+            bbox.min.y = std::min(bbox.min.y, point.y);
+            bbox.max.x = std::max(bbox.max.x, point.x);
+            bbox.max.y = std::max(bbox.max.y, point.y);
+        }
+
+        fn(bbox);
+    }
+}
+
+} // namespace
+
+void FeatureIndex::insert(const GeometryBuffer& geometries,
+                          std::size_t index,
+                          uint32_t sourceLayerID,
+                          uint32_t bucketID) {
+    forEachRingBox(geometries, [&] (const auto& bbox) {
+        grid.insert(IndexedSubfeature { index, sourceLayerID, bucketID, sortIndex++ }, bbox);
+    });
+}
+
+void FeatureIndex::insert(const Pending& pending) {
+    for (const auto& entry : pending.entries) {
+        IndexedSubfeature subfeature = entry.first;
+        subfeature.sortIndex = sortIndex++;
+        grid.insert(std::move(subfeature), entry.second);
+    }
+}
+
+void FeatureIndex::Pending::insert(const GeometryBuffer& geometries,
+                                   std::size_t index,
+                                   uint32_t sourceLayerID,
+                                   uint32_t bucketID) {
+    forEachRingBox(geometries, [&] (const auto& bbox) {
+        entries.emplace_back(IndexedSubfeature { index, sourceLayerID, bucketID, 0 }, bbox);
+    });
+}
+
+void FeatureIndex::Pending::write(LayoutWriter& writer) const {
+    writer.write<uint64_t>(entries.size());
+    for (const auto& entry : entries) {
+        writer.write<uint64_t>(entry.first.index);
+        writer.write(entry.second.min);
+        writer.write(entry.second.max);
+    }
+}
+
+bool FeatureIndex::Pending::read(LayoutReader& reader, uint32_t sourceLayerID, uint32_t bucketID) {
+    uint64_t count;
+    if (!reader.read(count)) {
+        return false;
+    }
+    entries.reserve(count);
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t index;
+        GridIndex<IndexedSubfeature>::BBox::point_type min, max;
+        if (!reader.read(index) || !reader.read(min) || !reader.read(max)) {
+            return false;
+        }
+        entries.emplace_back(IndexedSubfeature { std::size_t(index), sourceLayerID, bucketID, 0 },
+                             GridIndex<IndexedSubfeature>::BBox { min, max });
     }
+    return true;
 }
 
 static bool vectorContains(const std::vector<std::string>& vector, const std::string& s) {
@@ -60,6 +130,7 @@ void FeatureIndex::query(
         const double tileSize,
         const double scale,
         const QueryOptions& queryOptions,
+        const FeatureDetail detail,
         const GeometryTileData& geometryTileData,
         const CanonicalTileID& tileID,
         const style::Style& style,
@@ -69,7 +140,11 @@ void FeatureIndex::query(
 
     const float pixelsToTileUnits = util::EXTENT / tileSize / scale;
     const int16_t additionalRadius = std::min<int16_t>(util::EXTENT, std::ceil(style.getQueryRadius() * pixelsToTileUnits));
-    std::vector<IndexedSubfeature> features = grid.query({ box.min - additionalRadius, box.max + additionalRadius });
+    std::vector<IndexedSubfeature> features;
+    grid.query({ box.min - additionalRadius, box.max + additionalRadius }, [&] (const IndexedSubfeature& feature) {
+        features.push_back(feature);
+        return true;
+    });
 
     std::sort(features.begin(), features.end(), topDown);
     size_t previousSortIndex = std::numeric_limits<size_t>::max();
@@ -79,7 +154,7 @@ void FeatureIndex::query(
         if (indexedFeature.sortIndex == previousSortIndex) continue;
         previousSortIndex = indexedFeature.sortIndex;
 
-        addFeature(result, indexedFeature, queryGeometry, queryOptions, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
+        addFeature(result, indexedFeature, queryGeometry, queryOptions, detail, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
     }
 
     // Query symbol features, if they've been placed.
@@ -90,7 +165,7 @@ void FeatureIndex::query(
     std::vector<IndexedSubfeature> symbolFeatures = collisionTile->queryRenderedSymbols(queryGeometry, scale);
     std::sort(symbolFeatures.begin(), symbolFeatures.end(), topDownSymbols);
     for (const auto& symbolFeature : symbolFeatures) {
-        addFeature(result, symbolFeature, queryGeometry, queryOptions, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
+        addFeature(result, symbolFeature, queryGeometry, queryOptions, detail, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
     }
 }
 
@@ -99,18 +174,19 @@ void FeatureIndex::addFeature(
     const IndexedSubfeature& indexedFeature,
     const GeometryCoordinates& queryGeometry,
     const QueryOptions& options,
+    const FeatureDetail detail,
     const GeometryTileData& geometryTileData,
     const CanonicalTileID& tileID,
     const style::Style& style,
     const float bearing,
     const float pixelsToTileUnits) const {
 
-    auto& layerIDs = bucketLayerIDs.at(indexedFeature.bucketName);
+    auto& layerIDs = bucketLayerIDs.at(indexedFeature.bucketID);
     if (options.layerIDs && !vectorsIntersect(layerIDs, *options.layerIDs)) {
         return;
     }
 
-    auto sourceLayer = geometryTileData.getLayer(indexedFeature.sourceLayerName);
+    auto sourceLayer = geometryTileData.getLayer(indexedFeature.sourceLayerName());
     assert(sourceLayer);
 
     auto geometryTileFeature = sourceLayer->getFeature(indexedFeature.index);
@@ -132,7 +208,7 @@ void FeatureIndex::addFeature(
             continue;
         }
 
-        result[layerID].push_back(convertFeature(*geometryTileFeature, tileID));
+        result[layerID].push_back(convertFeature(*geometryTileFeature, tileID, detail));
     }
 }
 
@@ -159,7 +235,7 @@ optional<GeometryCoordinates> FeatureIndex::translateQueryGeometry(
 }
 
 void FeatureIndex::setBucketLayerIDs(const std::string& bucketName, const std::vector<std::string>& layerIDs) {
-    bucketLayerIDs[bucketName] = layerIDs;
+    bucketLayerIDs[util::internString(bucketName)] = layerIDs;
 }
 
 } // namespace mbgl
@@ -3,15 +3,19 @@
 #include <mbgl/style/types.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/util/grid_index.hpp>
+#include <mbgl/util/interned_string.hpp>
 #include <mbgl/util/feature.hpp>
 
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 namespace mbgl {
 
 class QueryOptions;
+class LayoutWriter;
+class LayoutReader;
 
 namespace style {
 class Style;
@@ -20,12 +24,21 @@ class Style;
 class CollisionTile;
 class CanonicalTileID;
 
+// Names are interned, so that subfeatures are trivially copyable.
 class IndexedSubfeature {
 public:
     IndexedSubfeature() = delete;
+    IndexedSubfeature(std::size_t index_, const std::string& sourceLayerName, const std::string& bucketName, size_t sortIndex_)
+        : IndexedSubfeature(index_, util::internString(sourceLayerName), util::internString(bucketName), sortIndex_) {}
+    IndexedSubfeature(std::size_t index_, uint32_t sourceLayerID_, uint32_t bucketID_, size_t sortIndex_)
+        : index(index_), sourceLayerID(sourceLayerID_), bucketID(bucketID_), sortIndex(sortIndex_) {}
+
+    const std::string& sourceLayerName() const { return util::internedString(sourceLayerID); }
+    const std::string& bucketName() const { return util::internedString(bucketID); }
+
     std::size_t index;
-    std::string sourceLayerName;
-    std::string bucketName;
+    uint32_t sourceLayerID;
+    uint32_t bucketID;
     size_t sortIndex;
 };
 
@@ -33,7 +46,25 @@ class FeatureIndex {
 public:
     FeatureIndex();
 
-    void insert(const GeometryCollection&, std::size_t index, const std::string& sourceLayerName, const std::string& bucketName);
+    // Subfeatures collected apart from the index, so that layers can be laid out
+    // concurrently. They are ordered as if inserted at the time they are merged.
+    class Pending {
+    public:
+        void insert(const GeometryBuffer&, std::size_t index, uint32_t sourceLayerID, uint32_t bucketID);
+
+        // For a `LayoutCache`. Subfeatures are written without the names of their source
+        // layer and bucket, which are the same for a whole layer group.
+        void write(LayoutWriter&) const;
+        bool read(LayoutReader&, uint32_t sourceLayerID, uint32_t bucketID);
+
+    private:
+        friend class FeatureIndex;
+        std::vector<std::pair<IndexedSubfeature, GridIndex<IndexedSubfeature>::BBox>> entries;
+    };
+
+    // The source layer and bucket are given by their interned names.
+    void insert(const GeometryBuffer&, std::size_t index, uint32_t sourceLayerID, uint32_t bucketID);
+    void insert(const Pending&);
 
     void query(
             std::unordered_map<std::string, std::vector<Feature>>& result,
@@ -42,6 +73,7 @@ public:
             const double tileSize,
             const double scale,
             const QueryOptions& options,
+            FeatureDetail,
             const GeometryTileData&,
             const CanonicalTileID&,
             const style::Style&,
@@ -56,12 +88,18 @@ public:
 
     void setBucketLayerIDs(const std::string& bucketName, const std::vector<std::string>& layerIDs);
 
+    // Roughly, of the grid of subfeatures.
+    std::size_t getByteSize() const {
+        return sizeof(FeatureIndex) + grid.byteSize();
+    }
+
 private:
     void addFeature(
             std::unordered_map<std::string, std::vector<Feature>>& result,
             const IndexedSubfeature&,
             const GeometryCoordinates& queryGeometry,
             const QueryOptions& options,
+            FeatureDetail,
             const GeometryTileData&,
             const CanonicalTileID&,
             const style::Style&,
@@ -71,6 +109,7 @@ private:
     GridIndex<IndexedSubfeature> grid;
     unsigned int sortIndex = 0;
 
-    std::unordered_map<std::string, std::vector<std::string>> bucketLayerIDs;
+    // By interned bucket name.
+    std::unordered_map<uint32_t, std::vector<std::string>> bucketLayerIDs;
 };
 } // namespace mbgl
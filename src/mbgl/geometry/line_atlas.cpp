@@ -5,14 +5,18 @@
 
 #include <boost/functional/hash.hpp>
 
-#include <sstream>
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <sstream>
 
 namespace mbgl {
 
+constexpr uint32_t LineAtlas::maxHeight;
+
 LineAtlas::LineAtlas(const Size size)
-    : image(size),
-      dirty(true) {
+    : image(size) {
+    freeRows.emplace(0, size.height);
 }
 
 LineAtlas::~LineAtlas() = default;
@@ -26,26 +30,102 @@ LinePatternPos LineAtlas::getDashPosition(const std::vector<float>& dasharray,
     }
 
     // Note: We're not handling hash collisions here.
-    const auto it = positions.find(key);
-    if (it == positions.end()) {
-        auto inserted = positions.emplace(key, addDash(dasharray, patternCap));
-        assert(inserted.second);
-        return inserted.first->second;
-    } else {
-        return it->second;
+    const auto it = entries.find(key);
+    if (it != entries.end()) {
+        lru.splice(lru.begin(), lru, it->second.lru);
+        return position(it->second);
     }
-}
 
-LinePatternPos LineAtlas::addDash(const std::vector<float>& dasharray, LinePatternCap patternCap) {
-    const uint8_t n = patternCap == LinePatternCap::Round ? 7 : 0;
-    const uint8_t dashheight = 2 * n + 1;
-    const uint8_t offset = 128;
+    const uint32_t height = patternCap == LinePatternCap::Round ? 15 : 1;
+
+    optional<uint32_t> row = allocate(height);
+    while (!row && image.size.height < maxHeight) {
+        grow();
+        row = allocate(height);
+    }
+
+    // Keep the most recently used pattern; it may be the other half of a cross-fade.
+    while (!row && lru.size() > 1) {
+        const auto victim = entries.find(lru.back());
+        release(victim->second.row, victim->second.height);
+        entries.erase(victim);
+        lru.pop_back();
+        ++evictions;
+        row = allocate(height);
+    }
 
-    if (nextRow + dashheight > image.size.height) {
+    if (!row) {
         Log::Warning(Event::OpenGL, "line atlas bitmap overflow");
         return LinePatternPos();
     }
 
+    lru.push_front(key);
+    const Entry entry { *row, height, addDash(dasharray, patternCap, *row), lru.begin() };
+    entries.emplace(key, entry);
+    return position(entry);
+}
+
+LinePatternPos LineAtlas::position(const Entry& entry) const {
+    const uint32_t n = (entry.height - 1) / 2;
+
+    LinePatternPos result;
+    result.y = (0.5 + entry.row + n) / image.size.height;
+    result.height = (2.0 * n) / image.size.height;
+    result.width = entry.width;
+    return result;
+}
+
+optional<uint32_t> LineAtlas::allocate(uint32_t height) {
+    for (auto it = freeRows.begin(); it != freeRows.end(); ++it) {
+        if (it->second >= height) {
+            const uint32_t row = it->first;
+            const uint32_t remaining = it->second - height;
+            freeRows.erase(it);
+            if (remaining) {
+                freeRows.emplace(row + height, remaining);
+            }
+            return row;
+        }
+    }
+    return {};
+}
+
+void LineAtlas::release(uint32_t row, uint32_t height) {
+    auto it = freeRows.emplace(row, height).first;
+
+    auto next = std::next(it);
+    if (next != freeRows.end() && row + height == next->first) {
+        it->second += next->second;
+        freeRows.erase(next);
+    }
+
+    if (it != freeRows.begin()) {
+        auto previous = std::prev(it);
+        if (previous->first + previous->second == row) {
+            previous->second += it->second;
+            freeRows.erase(it);
+        }
+    }
+}
+
+void LineAtlas::grow() {
+    const uint32_t oldHeight = image.size.height;
+    AlphaImage grown({ image.size.width, std::min(oldHeight * 2, maxHeight) });
+    grown.fill(0);
+    AlphaImage::copy(image, grown, { 0, 0 }, { 0, 0 }, image.size);
+
+    release(oldHeight, grown.size.height - oldHeight);
+    image = std::move(grown);
+
+    // The texture is recreated at the new size, with all of the image.
+    dirtyRegions.clear();
+}
+
+float LineAtlas::addDash(const std::vector<float>& dasharray, LinePatternCap patternCap, uint32_t nextRow) {
+    const uint8_t n = patternCap == LinePatternCap::Round ? 7 : 0;
+    const uint8_t dashheight = 2 * n + 1;
+    const uint8_t offset = 128;
+
     float length = 0;
     for (const float part : dasharray) {
         length += part;
@@ -105,30 +185,40 @@ LinePatternPos LineAtlas::addDash(const std::vector<float>& dasharray, LinePatte
         }
     }
 
-    LinePatternPos position;
-    position.y = (0.5 + nextRow + n) / image.size.height;
-    position.height = (2.0 * n) / image.size.height;
-    position.width = length;
+    dirtyRegions.emplace_back(0, nextRow, image.size.width, dashheight);
 
-    nextRow += dashheight;
-
-    dirty = true;
-
-    return position;
+    return length;
 }
 
 Size LineAtlas::getSize() const {
     return image.size;
 }
 
+MemoryStats::Usage LineAtlas::getMemoryUsage() const {
+    MemoryStats::Usage result;
+    result.cpuBytes = image.bytes();
+    result.gpuBytes = texture ? texture->size.area() * image.channels : 0;
+    return result;
+}
+
 void LineAtlas::upload(gl::Context& context, gl::TextureUnit unit) {
-    if (!texture) {
+    gl::ResourceOwnerScope owner { context, GLResourceStats::Owner::Atlas };
+
+    if (!texture || texture->size != image.size) {
         texture = context.createTexture(image, unit);
-    } else if (dirty) {
-        context.updateTexture(*texture, image, unit);
+    } else {
+        context.updateTextureRegions(*texture, image, std::move(dirtyRegions), unit);
     }
+    dirtyRegions.clear();
+}
 
-    dirty = false;
+void LineAtlas::dumpDebugLogs() const {
+    uint32_t freeCount = 0;
+    for (const auto& rows : freeRows) {
+        freeCount += rows.second;
+    }
+    Log::Info(Event::General, "LineAtlas: %zu patterns, %u of %u rows used, %zu evicted",
+              entries.size(), image.size.height - freeCount, image.size.height, evictions);
 }
 
 void LineAtlas::bind(gl::Context& context, gl::TextureUnit unit) {
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <mbgl/map/memory_stats.hpp>
 #include <mbgl/gl/texture.hpp>
 #include <mbgl/gl/object.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/rect.hpp>
 
+#include <list>
+#include <map>
 #include <vector>
 #include <unordered_map>
 #include <memory>
@@ -27,6 +31,16 @@ enum class LinePatternCap : bool {
     Round = true,
 };
 
+/*
+    Dash patterns are rendered into rows of a texture the first time they are drawn. When
+    the texture is full, its height doubles, up to `maxHeight`; after that, the patterns
+    that were drawn least recently make room for new ones.
+
+    Patterns are only used while a layer is drawn: a `LinePatternPos` is valid until the
+    next call to `getDashPosition` for a pattern that isn't in the atlas yet, except for
+    the one returned just before that call, which is never evicted. This is enough for
+    the two patterns of a cross-faded line.
+*/
 class LineAtlas {
 public:
     LineAtlas(Size);
@@ -36,20 +50,49 @@ public:
     void bind(gl::Context&, gl::TextureUnit unit);
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
+    // only the rows of patterns added since the last upload are sent, unless the atlas has
+    // grown since.
     void upload(gl::Context&, gl::TextureUnit unit);
 
     LinePatternPos getDashPosition(const std::vector<float>&, LinePatternCap);
-    LinePatternPos addDash(const std::vector<float>& dasharray, LinePatternCap);
 
     Size getSize() const;
 
+    // The bytes of the image on the CPU, and of the texture it was uploaded into.
+    MemoryStats::Usage getMemoryUsage() const;
+
+    void dumpDebugLogs() const;
+
+    static constexpr uint32_t maxHeight = 2048;
+
 private:
-    const AlphaImage image;
-    bool dirty;
+    struct Entry {
+        uint32_t row;
+        uint32_t height;
+        float width;
+        std::list<size_t>::iterator lru;
+    };
+
+    LinePatternPos position(const Entry&) const;
+    optional<uint32_t> allocate(uint32_t height);
+    void release(uint32_t row, uint32_t height);
+    void grow();
+    float addDash(const std::vector<float>& dasharray, LinePatternCap, uint32_t row);
+
+    AlphaImage image;
     mbgl::optional<gl::Texture> texture;
-    uint32_t nextRow = 0;
-    std::unordered_map<size_t, LinePatternPos> positions;
+    std::unordered_map<size_t, Entry> entries;
+
+    // Keys of the entries, from the most to the least recently used.
+    std::list<size_t> lru;
+
+    // Unused rows, by their first row, with the number of rows that follow.
+    std::map<uint32_t, uint32_t> freeRows;
+
+    // Rows that changed since the last upload.
+    std::vector<Rect<uint16_t>> dirtyRegions;
+
+    std::size_t evictions = 0;
 };
 
 } // namespace mbgl
@@ -1,12 +1,29 @@
 #include <mbgl/gl/attribute.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/gl.hpp>
+#include <mbgl/gl/half_float.hpp>
+#include <mbgl/gl/instancing.hpp>
 #include <mbgl/gl/normalization.hpp>
 
+#include <type_traits>
+
 namespace mbgl {
 namespace gl {
 
 static_assert(offsetof(Normalized<uint8_t>, value) == 0, "unexpected normalized offset");
+static_assert(sizeof(HalfFloat) == 2, "unexpected half float size");
+
+#if MBGL_USE_GLES2
+#ifndef GL_HALF_FLOAT_OES
+#define GL_HALF_FLOAT_OES 0x8D61
+#endif
+constexpr GLenum HalfFloatType = GL_HALF_FLOAT_OES;
+#else
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT 0x140B
+#endif
+constexpr GLenum HalfFloatType = GL_HALF_FLOAT;
+#endif // MBGL_USE_GLES2
 
 AttributeLocation bindAttributeLocation(ProgramID id, AttributeLocation location, const char* name) {
     MBGL_CHECK_ERROR(glBindAttribLocation(id, location, name));
@@ -34,15 +51,21 @@ void VariableAttributeBinding<T, N>::bind(Context& context,
     if (oldBinding == *this) {
         return;
     }
+    assert(!halfFloat || (std::is_same<T, float>::value && context.supportsHalfFloatAttributes()));
     context.vertexBuffer = vertexBuffer;
     MBGL_CHECK_ERROR(glEnableVertexAttribArray(location));
     MBGL_CHECK_ERROR(glVertexAttribPointer(
         location,
         static_cast<GLint>(N),
-        static_cast<GLenum>(DataTypeOf<T>),
+        halfFloat ? HalfFloatType : static_cast<GLenum>(DataTypeOf<T>),
         static_cast<GLboolean>(IsNormalized<T>),
         static_cast<GLsizei>(vertexSize),
         reinterpret_cast<GLvoid*>(attributeOffset + (vertexSize * vertexOffset))));
+    // The divisor is part of the vertex array state; per-vertex bindings reset it rather
+    // than inheriting one. Without instancing, every divisor stays at its default of 0.
+    if (context.supportsInstancing()) {
+        MBGL_CHECK_ERROR(VertexAttribDivisor(location, static_cast<GLuint>(divisor)));
+    }
 }
 
 template class VariableAttributeBinding<uint8_t, 1>;
@@ -12,30 +12,45 @@
 namespace mbgl {
 namespace gl {
 
+// With `halfFloat`, the values of a float attribute are stored as `HalfFloat`s; see
+// `Context::supportsHalfFloatAttributes`.
 template <class T, std::size_t N>
 class VariableAttributeBinding {
 public:
     VariableAttributeBinding(BufferID vertexBuffer_,
                              std::size_t vertexSize_,
-                             std::size_t attributeOffset_)
+                             std::size_t attributeOffset_,
+                             std::size_t divisor_ = 0,
+                             bool halfFloat_ = false)
         : vertexBuffer(vertexBuffer_),
           vertexSize(vertexSize_),
-          attributeOffset(attributeOffset_)
+          attributeOffset(attributeOffset_),
+          divisor(divisor_),
+          halfFloat(halfFloat_)
         {}
 
     void bind(Context&, AttributeLocation, optional<VariableAttributeBinding<T, N>>&, std::size_t vertexOffset) const;
 
+    // The same binding, advancing once per instance instead of once per vertex.
+    VariableAttributeBinding perInstance() const {
+        return { vertexBuffer, vertexSize, attributeOffset, 1, halfFloat };
+    }
+
     friend bool operator==(const VariableAttributeBinding& lhs,
                            const VariableAttributeBinding& rhs) {
         return lhs.vertexBuffer == rhs.vertexBuffer
             && lhs.vertexSize == rhs.vertexSize
-            && lhs.attributeOffset == rhs.attributeOffset;
+            && lhs.attributeOffset == rhs.attributeOffset
+            && lhs.divisor == rhs.divisor
+            && lhs.halfFloat == rhs.halfFloat;
     }
 
 private:
     BufferID vertexBuffer;
     std::size_t vertexSize;
     std::size_t attributeOffset;
+    std::size_t divisor;
+    bool halfFloat;
 };
 
 template <class T, std::size_t N>
@@ -81,6 +96,14 @@ public:
             binding.bind(context, location, oldBinding, vertexOffset);
         });
     }
+
+    // Constant bindings are left as they are; they apply to every instance anyway.
+    static Binding perInstance(const Binding& binding) {
+        if (binding.template is<VariableBinding>()) {
+            return binding.template get<VariableBinding>().perInstance();
+        }
+        return binding;
+    }
 };
 
 #define MBGL_DEFINE_ATTRIBUTE(type_, n_, name_) \
@@ -217,6 +240,8 @@ public:
     template <class A>
     static constexpr std::size_t Index = TypeIndex<A, As...>::value;
 
+    static constexpr std::size_t Count = sizeof...(As);
+
     static Locations locations(const ProgramID& id) {
         return Locations { bindAttributeLocation(id, Index<As>, As::name())... };
     }
@@ -229,11 +254,17 @@ public:
             typename As::VariableBinding {
                 buffer.buffer,
                 sizeof(Vertex),
-                Vertex::attributeOffsets[Index<As>]
+                buffer.byteOffset + Vertex::attributeOffsets[Index<As>]
             }...
         };
     }
 
+    // Returns `bindings` with every variable binding advancing once per instance, for
+    // attributes read from a buffer of instances.
+    static Bindings perInstance(const Bindings& bindings) {
+        return Bindings { As::perInstance(bindings.template get<As>())... };
+    }
+
     static void bind(Context& context,
                      const Locations& locations,
                      VariableBindings& oldBindings,
@@ -1,12 +1,20 @@
 #include <mbgl/map/view.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/gl.hpp>
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/instancing.hpp>
+#include <mbgl/gl/program_binary.hpp>
+#include <mbgl/gl/timer_query.hpp>
 #include <mbgl/gl/vertex_array.hpp>
 #include <mbgl/util/traits.hpp>
 #include <mbgl/util/std.hpp>
+#include <mbgl/util/ktx.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <algorithm>
 #include <cstring>
+#include <iterator>
+#include <tuple>
 
 namespace mbgl {
 namespace gl {
@@ -23,21 +31,32 @@ static_assert(underlying_type(PrimitiveType::TriangleStrip) == GL_TRIANGLE_STRIP
 static_assert(underlying_type(PrimitiveType::TriangleFan) == GL_TRIANGLE_FAN, "OpenGL type mismatch");
 
 static_assert(std::is_same<ProgramID, GLuint>::value, "OpenGL type mismatch");
+static_assert(std::is_same<BinaryProgramFormat, GLenum>::value, "OpenGL type mismatch");
 static_assert(std::is_same<ShaderID, GLuint>::value, "OpenGL type mismatch");
 static_assert(std::is_same<BufferID, GLuint>::value, "OpenGL type mismatch");
 static_assert(std::is_same<TextureID, GLuint>::value, "OpenGL type mismatch");
 static_assert(std::is_same<VertexArrayID, GLuint>::value, "OpenGL type mismatch");
 static_assert(std::is_same<FramebufferID, GLuint>::value, "OpenGL type mismatch");
 static_assert(std::is_same<RenderbufferID, GLuint>::value, "OpenGL type mismatch");
+static_assert(std::is_same<QueryID, GLuint>::value, "OpenGL type mismatch");
 
 static_assert(std::is_same<std::underlying_type_t<TextureFormat>, GLenum>::value, "OpenGL type mismatch");
 static_assert(underlying_type(TextureFormat::RGBA) == GL_RGBA, "OpenGL type mismatch");
 static_assert(underlying_type(TextureFormat::Alpha) == GL_ALPHA, "OpenGL type mismatch");
 
+Context::Context()
+    : sharedResources(std::make_shared<SharedResources>()) {
+}
+
 Context::~Context() {
     reset();
 }
 
+void Context::shareWith(Context& other) {
+    sharedResources = other.sharedResources;
+    sharing = other.sharing = true;
+}
+
 UniqueShader Context::createShader(ShaderType type, const std::string& source) {
     UniqueShader result { MBGL_CHECK_ERROR(glCreateShader(static_cast<GLenum>(type))), { this } };
 
@@ -64,7 +83,7 @@ UniqueShader Context::createShader(ShaderType type, const std::string& source) {
 }
 
 UniqueProgram Context::createProgram(ShaderID vertexShader, ShaderID fragmentShader) {
-    UniqueProgram result { MBGL_CHECK_ERROR(glCreateProgram()), { this } };
+    UniqueProgram result { MBGL_CHECK_ERROR(glCreateProgram()), { sharedResources } };
 
     MBGL_CHECK_ERROR(glAttachShader(result, vertexShader));
     MBGL_CHECK_ERROR(glAttachShader(result, fragmentShader));
@@ -92,25 +111,191 @@ void Context::linkProgram(ProgramID program_) {
     throw std::runtime_error("program failed to link");
 }
 
-UniqueBuffer Context::createVertexBuffer(const void* data, std::size_t size) {
-    BufferID id = 0;
-    MBGL_CHECK_ERROR(glGenBuffers(1, &id));
-    UniqueBuffer result { std::move(id), { this } };
-    vertexBuffer = result;
-    MBGL_CHECK_ERROR(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+bool Context::supportsProgramBinaries() const {
+    return gl::GetProgramBinary &&
+           gl::ProgramBinary &&
+           !disableProgramBinaryExtension;
+}
+
+std::string Context::getDriverDescription() const {
+    std::string result;
+    for (const GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        if (const auto string = reinterpret_cast<const char*>(MBGL_CHECK_ERROR(glGetString(name)))) {
+            result += string;
+        }
+        result += '\n';
+    }
+    return result;
+}
+
+optional<std::pair<BinaryProgramFormat, std::string>> Context::getBinaryProgram(ProgramID program_) const {
+    assert(supportsProgramBinaries());
+    GLint binaryLength = 0;
+    MBGL_CHECK_ERROR(glGetProgramiv(program_, GL_PROGRAM_BINARY_LENGTH, &binaryLength));
+    if (binaryLength <= 0) {
+        return {};
+    }
+
+    std::string binary;
+    binary.resize(binaryLength);
+    GLenum binaryFormat;
+    MBGL_CHECK_ERROR(gl::GetProgramBinary(program_, binaryLength, &binaryLength, &binaryFormat,
+                                          const_cast<char*>(binary.data())));
+    if (size_t(binaryLength) != binary.size()) {
+        return {};
+    }
+    return { { binaryFormat, std::move(binary) } };
+}
+
+UniqueProgram Context::createProgram(BinaryProgramFormat binaryFormat, const std::string& binary) {
+    assert(supportsProgramBinaries());
+    UniqueProgram result { MBGL_CHECK_ERROR(glCreateProgram()), { sharedResources } };
+    MBGL_CHECK_ERROR(gl::ProgramBinary(result, static_cast<GLenum>(binaryFormat), binary.data(),
+                                       static_cast<GLint>(binary.size())));
+
+    // A binary from another driver version fails to link, which is not a GL error.
+    GLint status;
+    MBGL_CHECK_ERROR(glGetProgramiv(result, GL_LINK_STATUS, &status));
+    if (status != GL_TRUE) {
+        throw std::runtime_error("program binary was rejected");
+    }
+
     return result;
 }
 
-UniqueBuffer Context::createIndexBuffer(const void* data, std::size_t size) {
+void Context::bindBuffer(const BufferTarget target, const BufferID id) {
+    if (target == BufferTarget::Vertex) {
+        vertexBuffer = id;
+    } else {
+        // The element array binding is part of the vertex array state.
+        vertexArrayObject = 0;
+        elementBuffer = id;
+    }
+}
+
+std::pair<UniqueBuffer, std::size_t> Context::createBuffer(const BufferTarget target, const void* data, const std::size_t size) {
+    const GLenum glTarget = target == BufferTarget::Index ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
+
+    if (size == 0 || size > SharedBufferRangeMax) {
+        BufferID id = 0;
+        MBGL_CHECK_ERROR(glGenBuffers(1, &id));
+        UniqueBuffer result { std::move(id), { this, 0, 0 } };
+        bindBuffer(target, result.get());
+        MBGL_CHECK_ERROR(glBufferData(glTarget, size, data, GL_STATIC_DRAW));
+        trackResource(GLResourceStats::Type::Buffer, result.get(), size);
+        if (data) {
+            uploadedBytes += size;
+        }
+        return { std::move(result), 0 };
+    }
+
+    // Ranges start at multiples of four bytes, which suits any vertex attribute or index.
+    const std::size_t rangeSize = (size + 3) & ~std::size_t(3);
+
+    auto& ids = sharedBufferIDs[std::size_t(resourceOwner)][std::size_t(target)];
+    SharedBuffer* shared = nullptr;
+    std::map<std::size_t, std::size_t>::iterator range;
+    for (const BufferID id : ids) {
+        SharedBuffer& candidate = sharedBuffers.at(id);
+        range = std::find_if(candidate.freeRanges.begin(), candidate.freeRanges.end(), [&] (const auto& free) {
+            return free.second >= rangeSize;
+        });
+        if (range != candidate.freeRanges.end()) {
+            shared = &candidate;
+            break;
+        }
+    }
+
+    if (!shared) {
+        BufferID id = 0;
+        MBGL_CHECK_ERROR(glGenBuffers(1, &id));
+        bindBuffer(target, id);
+        MBGL_CHECK_ERROR(glBufferData(glTarget, SharedBufferSize, nullptr, GL_STATIC_DRAW));
+        trackResource(GLResourceStats::Type::Buffer, id, SharedBufferSize);
+
+        shared = &sharedBuffers.emplace(id, SharedBuffer {
+            UniqueBuffer { BufferID(id), { this, 0, 0 } },
+            resourceOwner,
+            target,
+            {{ 0, SharedBufferSize }},
+            0
+        }).first->second;
+        ids.push_back(id);
+        range = shared->freeRanges.begin();
+    }
+
+    const std::size_t offset = range->first;
+    const std::size_t remaining = range->second - rangeSize;
+    shared->freeRanges.erase(range);
+    if (remaining) {
+        shared->freeRanges.emplace(offset + rangeSize, remaining);
+    }
+    shared->usedBytes += rangeSize;
+
+    const BufferID id = shared->buffer.get();
+    bindBuffer(target, id);
+    MBGL_CHECK_ERROR(glBufferSubData(glTarget, offset, size, data));
+    uploadedBytes += size;
+    return { UniqueBuffer { BufferID(id), { this, offset, rangeSize } }, offset };
+}
+
+UniqueBuffer Context::createStreamBuffer(const BufferTarget target, const void* data, const std::size_t size) {
     BufferID id = 0;
     MBGL_CHECK_ERROR(glGenBuffers(1, &id));
-    UniqueBuffer result { std::move(id), { this } };
-    vertexArrayObject = 0;
-    elementBuffer = result;
-    MBGL_CHECK_ERROR(glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+    UniqueBuffer result { std::move(id), { this, 0, 0 } };
+    updateStreamBuffer(target, result.get(), data, size);
     return result;
 }
 
+void Context::updateStreamBuffer(const BufferTarget target, const BufferID id, const void* data, const std::size_t size) {
+    const GLenum glTarget = target == BufferTarget::Index ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
+    bindBuffer(target, id);
+    // Respecifying the storage without data detaches it from pending draws, which keep
+    // reading the previous contents.
+    MBGL_CHECK_ERROR(glBufferData(glTarget, size, nullptr, GL_STREAM_DRAW));
+    if (size) {
+        MBGL_CHECK_ERROR(glBufferSubData(glTarget, 0, size, data));
+    }
+    trackResource(GLResourceStats::Type::Buffer, id, size);
+    uploadedBytes += size;
+}
+
+void Context::freeSharedBufferRange(const BufferID id, const std::size_t offset, const std::size_t size) {
+    const auto it = sharedBuffers.find(id);
+    if (it == sharedBuffers.end()) {
+        // Released by `reset`.
+        return;
+    }
+
+    SharedBuffer& shared = it->second;
+    shared.usedBytes -= size;
+
+    // Empty buffers are released, but for the last one of their owner and target, which is
+    // kept for the next data.
+    auto& ids = sharedBufferIDs[std::size_t(shared.owner)][std::size_t(shared.target)];
+    if (shared.usedBytes == 0 && ids.size() > 1) {
+        ids.erase(std::find(ids.begin(), ids.end(), id));
+        sharedBuffers.erase(it);
+        return;
+    }
+
+    std::size_t start = offset;
+    std::size_t end = offset + size;
+    auto next = shared.freeRanges.upper_bound(offset);
+    if (next != shared.freeRanges.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == start) {
+            start = previous->first;
+            shared.freeRanges.erase(previous);
+        }
+    }
+    if (next != shared.freeRanges.end() && next->first == end) {
+        end += next->second;
+        shared.freeRanges.erase(next);
+    }
+    shared.freeRanges.emplace(start, end - start);
+}
+
 UniqueTexture Context::createTexture() {
     if (pooledTextures.empty()) {
         pooledTextures.resize(TextureMax);
@@ -119,7 +304,117 @@ UniqueTexture Context::createTexture() {
 
     TextureID id = pooledTextures.back();
     pooledTextures.pop_back();
-    return UniqueTexture{ std::move(id), { this } };
+    trackResource(GLResourceStats::Type::Texture, id, 0);
+    return UniqueTexture{ std::move(id), { this, 0 } };
+}
+
+optional<SharedTexture> Context::createSharedTexture(const Size size, const void* data, TextureUnit unit) {
+    const uint32_t side = size.width;
+    if (size.height != side || side < SharedTextureSlotMin || side > SharedTextureSlotMax || (side & (side - 1))) {
+        return {};
+    }
+
+    if (!maxTextureSize) {
+        GLint value = 0;
+        MBGL_CHECK_ERROR(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &value));
+        maxTextureSize = value;
+    }
+    const uint32_t pageSide = side * SharedTextureSlots;
+    if (pageSide > uint32_t(*maxTextureSize)) {
+        return {};
+    }
+
+    auto& ids = sharedTextureIDs[side];
+    SharedTexturePage* page = nullptr;
+    for (const TextureID id : ids) {
+        SharedTexturePage& candidate = sharedTextures.at(id);
+        if (candidate.usedCount < candidate.usedSlots.size()) {
+            page = &candidate;
+            break;
+        }
+    }
+
+    if (!page) {
+        Texture pageTexture = createTexture(Size { pageSide, pageSide }, TextureFormat::RGBA, unit);
+        const TextureID id = pageTexture.texture.get();
+        page = &sharedTextures.emplace(id, SharedTexturePage {
+            std::move(pageTexture),
+            std::vector<bool>(SharedTextureSlots * SharedTextureSlots),
+            0,
+            false
+        }).first->second;
+        ids.push_back(id);
+    }
+
+    const std::size_t slot = std::find(page->usedSlots.begin(), page->usedSlots.end(), false) - page->usedSlots.begin();
+    page->usedSlots[slot] = true;
+    page->usedCount++;
+    page->mipmapsDirty = true;
+
+    const uint16_t x = (slot % SharedTextureSlots) * side;
+    const uint16_t y = (slot / SharedTextureSlots) * side;
+    const TextureID id = page->texture.texture.get();
+    updateTextureRegion(id, x, y, size, data, TextureFormat::RGBA, unit);
+
+    const float scale = (side - 1.0f) / pageSide;
+    return SharedTexture {
+        size,
+        UniqueTexture { TextureID(id), { this, slot + 1 } },
+        {{ (x + 0.5f) / pageSide, (y + 0.5f) / pageSide }},
+        {{ scale, scale }}
+    };
+}
+
+void Context::freeSharedTextureSlot(const TextureID id, const std::size_t slot) {
+    const auto it = sharedTextures.find(id);
+    if (it == sharedTextures.end()) {
+        // Released by `reset`.
+        return;
+    }
+
+    SharedTexturePage& page = it->second;
+    page.usedSlots[slot] = false;
+    page.usedCount--;
+
+    // Unlike shared buffers, empty textures are all released; they are much larger.
+    if (page.usedCount == 0) {
+        auto& ids = sharedTextureIDs[page.texture.size.width / SharedTextureSlots];
+        ids.erase(std::find(ids.begin(), ids.end(), id));
+        sharedTextures.erase(it);
+    }
+}
+
+void Context::bindTexture(SharedTexture& obj, TextureUnit unit, TextureFilter filter, TextureMipMap mipmap) {
+    const auto it = sharedTextures.find(obj.texture.get());
+    assert(it != sharedTextures.end());
+    SharedTexturePage& page = it->second;
+
+    if (mipmap == TextureMipMap::Yes && page.mipmapsDirty) {
+        activeTexture = unit;
+        texture[unit] = page.texture.texture;
+        MBGL_CHECK_ERROR(glGenerateMipmap(GL_TEXTURE_2D));
+        // Generated again for every image placed in it, the smaller levels still only add a
+        // third.
+        trackResource(GLResourceStats::Type::Texture, page.texture.texture.get(),
+                      std::size_t(page.texture.size.area()) * 4 * 4 / 3);
+        page.mipmapsDirty = false;
+    }
+
+    bindTexture(page.texture, unit, filter, mipmap);
+}
+
+bool Context::supportsCompressedTextureFormat(const uint32_t format) {
+    if (!compressedTextureFormats) {
+        GLint count = 0;
+        MBGL_CHECK_ERROR(glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count));
+        std::vector<GLint> formats(count);
+        if (count > 0) {
+            MBGL_CHECK_ERROR(glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data()));
+        }
+        compressedTextureFormats.emplace(formats.begin(), formats.end());
+    }
+    return std::find(compressedTextureFormats->begin(), compressedTextureFormats->end(), format) !=
+           compressedTextureFormats->end();
 }
 
 bool Context::supportsVertexArrays() const {
@@ -129,16 +424,101 @@ bool Context::supportsVertexArrays() const {
            !disableVAOExtension;
 }
 
-UniqueVertexArray Context::createVertexArray() {
+bool Context::supportsInstancing() const {
+    return gl::VertexAttribDivisor &&
+           gl::DrawElementsInstanced &&
+           supportsVertexArrays() &&
+           !disableInstancingExtension;
+}
+
+bool Context::supportsWideIndices() const {
+#if MBGL_USE_GLES2
+    return HasExtension("GL_OES_element_index_uint") &&
+           !disableWideIndexExtension;
+#else
+    return !disableWideIndexExtension;
+#endif // MBGL_USE_GLES2
+}
+
+bool Context::supportsHalfFloatAttributes() const {
+#if MBGL_USE_GLES2
+    return HasExtension("GL_OES_vertex_half_float") &&
+           !disableHalfFloatExtension;
+#else
+    return HasExtension("GL_ARB_half_float_vertex") &&
+           !disableHalfFloatExtension;
+#endif // MBGL_USE_GLES2
+}
+
+bool Context::supportsTimerQueries() const {
+    return gl::GenQueries &&
+           gl::DeleteQueries &&
+           gl::BeginQuery &&
+           gl::EndQuery &&
+           gl::GetQueryObjectuiv &&
+           gl::GetQueryObjectui64v &&
+           !disableTimerQueryExtension;
+}
+
+UniqueQuery Context::createQuery() {
+    assert(supportsTimerQueries());
+    QueryID id = 0;
+    MBGL_CHECK_ERROR(gl::GenQueries(1, &id));
+    return UniqueQuery(std::move(id), { this });
+}
+
+void Context::beginTimerQuery(QueryID id) {
+    assert(supportsTimerQueries());
+    MBGL_CHECK_ERROR(gl::BeginQuery(GL_TIME_ELAPSED, id));
+}
+
+void Context::endTimerQuery() {
+    assert(supportsTimerQueries());
+    MBGL_CHECK_ERROR(gl::EndQuery(GL_TIME_ELAPSED));
+}
+
+bool Context::isQueryResultAvailable(QueryID id) const {
+    assert(supportsTimerQueries());
+    GLuint available = GL_FALSE;
+    MBGL_CHECK_ERROR(gl::GetQueryObjectuiv(id, GL_QUERY_RESULT_AVAILABLE, &available));
+    return available != GL_FALSE;
+}
+
+Duration Context::getTimerQueryResult(QueryID id) const {
+    assert(supportsTimerQueries());
+    uint64_t nanoseconds = 0;
+    MBGL_CHECK_ERROR(gl::GetQueryObjectui64v(id, GL_QUERY_RESULT, &nanoseconds));
+    return std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(nanoseconds));
+}
+
+bool Context::checkTimerDisjoint() const {
+    // GL_ARB_timer_query has no way to report disjoint events.
+    if (!gl::GetInteger64vDisjoint) {
+        return false;
+    }
+    GLint disjoint = GL_FALSE;
+    MBGL_CHECK_ERROR(glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint));
+    return disjoint != GL_FALSE;
+}
+
+UniqueVertexArray Context::createVertexArray(const std::size_t attributeCount) {
     assert(supportsVertexArrays());
     VertexArrayID id = 0;
-    MBGL_CHECK_ERROR(gl::GenVertexArrays(1, &id));
-    return UniqueVertexArray(std::move(id), { this });
+    auto& pool = pooledVertexArrays[attributeCount];
+    if (!pool.empty()) {
+        id = pool.back();
+        pool.pop_back();
+    } else {
+        MBGL_CHECK_ERROR(gl::GenVertexArrays(1, &id));
+    }
+    trackResource(GLResourceStats::Type::VertexArray, id, 0);
+    return UniqueVertexArray(std::move(id), { this, attributeCount });
 }
 
 UniqueFramebuffer Context::createFramebuffer() {
     FramebufferID id = 0;
     MBGL_CHECK_ERROR(glGenFramebuffers(1, &id));
+    trackResource(GLResourceStats::Type::Framebuffer, id, 0);
     return UniqueFramebuffer{ std::move(id), { this } };
 }
 
@@ -150,6 +530,8 @@ UniqueRenderbuffer Context::createRenderbuffer(const RenderbufferType type, cons
     bindRenderbuffer = renderbuffer;
     MBGL_CHECK_ERROR(
         glRenderbufferStorage(GL_RENDERBUFFER, static_cast<GLenum>(type), size.width, size.height));
+    // Both types hold four bytes per pixel.
+    trackResource(GLResourceStats::Type::Renderbuffer, renderbuffer.get(), std::size_t(size.area()) * 4);
     return renderbuffer;
 }
 
@@ -180,6 +562,48 @@ std::unique_ptr<uint8_t[]> Context::readFramebuffer(const Size size, const Textu
 }
 
 #if not MBGL_USE_GLES2
+UniqueBuffer Context::createPixelBuffer() {
+    BufferID id = 0;
+    MBGL_CHECK_ERROR(glGenBuffers(1, &id));
+    trackResource(GLResourceStats::Type::Buffer, id, 0);
+    return UniqueBuffer { std::move(id), { this, 0, 0 } };
+}
+
+void Context::startReadFramebuffer(const BufferID pixelBuffer, const Size size) {
+    pixelStorePack = { 1 };
+
+    // The pixel pack buffer binding isn't tracked, since nothing else uses it; leaving it
+    // bound would send every other framebuffer read into the buffer.
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer));
+    MBGL_CHECK_ERROR(glBufferData(GL_PIXEL_PACK_BUFFER, size.width * size.height * 4, nullptr, GL_STREAM_READ));
+    trackResource(GLResourceStats::Type::Buffer, pixelBuffer, std::size_t(size.area()) * 4);
+    MBGL_CHECK_ERROR(glReadPixels(0, 0, size.width, size.height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+}
+
+std::unique_ptr<uint8_t[]> Context::readPixelBuffer(const BufferID pixelBuffer, const Size size, const bool flip) {
+    const size_t stride = size.width * 4;
+    auto data = std::make_unique<uint8_t[]>(stride * size.height);
+
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer));
+    const auto pixels = reinterpret_cast<const uint8_t*>(
+        MBGL_CHECK_ERROR(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY)));
+    if (!pixels) {
+        MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+        throw std::runtime_error("failed to map pixel buffer");
+    }
+
+    // Flip while copying out of the mapped buffer, rather than swapping rows afterwards.
+    for (uint32_t i = 0; i < size.height; i++) {
+        const uint32_t row = flip ? size.height - 1 - i : i;
+        std::memcpy(data.get() + row * stride, pixels + i * stride, stride);
+    }
+
+    MBGL_CHECK_ERROR(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+    return data;
+}
+
 void Context::drawPixels(const Size size, const void* data, TextureFormat format) {
     pixelStoreUnpack = { 1 };
     if (format != TextureFormat::RGBA) {
@@ -297,6 +721,36 @@ Context::createTexture(const Size size, const void* data, TextureFormat format,
     return obj;
 }
 
+Texture Context::createTexture(const CompressedImage& image, TextureUnit unit) {
+    assert(!image.levels.empty());
+    auto obj = createTexture();
+    activeTexture = unit;
+    texture[unit] = obj;
+    MBGL_CHECK_ERROR(glCompressedTexImage2D(GL_TEXTURE_2D, 0, image.format, image.size.width,
+                                            image.size.height, 0, image.levels.front().size,
+                                            image.levels.front().data));
+    trackResource(GLResourceStats::Type::Texture, obj.get(), image.levels.front().size);
+    uploadedBytes += image.levels.front().size;
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    return { image.size, std::move(obj) };
+}
+
+void Context::generateMipmap(Texture& obj, TextureUnit unit) {
+    activeTexture = unit;
+    texture[unit] = obj.texture;
+    MBGL_CHECK_ERROR(glGenerateMipmap(GL_TEXTURE_2D));
+
+    // The smaller levels add a third.
+    auto& textures = trackedResources[std::size_t(GLResourceStats::Type::Texture)];
+    const auto it = textures.find(obj.texture.get());
+    if (it != textures.end()) {
+        trackResource(GLResourceStats::Type::Texture, obj.texture.get(), it->second.bytes * 4 / 3);
+    }
+}
+
 void Context::updateTexture(
     TextureID id, const Size size, const void* data, TextureFormat format, TextureUnit unit) {
     activeTexture = unit;
@@ -304,6 +758,59 @@ void Context::updateTexture(
     MBGL_CHECK_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLenum>(format), size.width,
                                   size.height, 0, static_cast<GLenum>(format), GL_UNSIGNED_BYTE,
                                   data));
+    const std::size_t bytes = std::size_t(size.area()) * (format == TextureFormat::RGBA ? 4 : 1);
+    trackResource(GLResourceStats::Type::Texture, id, bytes);
+    if (data) {
+        uploadedBytes += bytes;
+    }
+}
+
+void Context::updateTextureRegion(TextureID id,
+                                  const uint16_t x,
+                                  const uint16_t y,
+                                  const Size size,
+                                  const void* data,
+                                  TextureFormat format,
+                                  TextureUnit unit) {
+    activeTexture = unit;
+    texture[unit] = id;
+    MBGL_CHECK_ERROR(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, size.width, size.height,
+                                     static_cast<GLenum>(format), GL_UNSIGNED_BYTE, data));
+    uploadedBytes += std::size_t(size.area()) * (format == TextureFormat::RGBA ? 4 : 1);
+}
+
+static uint32_t area(const Rect<uint16_t>& rect) {
+    return uint32_t(rect.w) * rect.h;
+}
+
+// Merges regions that overlap or touch into their bounding box, as long as that doesn't
+// more than double the pixels to upload. Atlases mostly pack an image next to the one
+// added before it, so a burst of new images goes up in a few calls.
+std::vector<Rect<uint16_t>> Context::coalesceRegions(std::vector<Rect<uint16_t>> regions) {
+    std::sort(regions.begin(), regions.end(), [] (const auto& a, const auto& b) {
+        return std::tie(a.y, a.x) < std::tie(b.y, b.x);
+    });
+
+    std::vector<Rect<uint16_t>> result;
+    for (const auto& region : regions) {
+        if (!result.empty()) {
+            auto& last = result.back();
+            const uint16_t x0 = std::min(last.x, region.x);
+            const uint16_t y0 = std::min(last.y, region.y);
+            const uint16_t x1 = std::max(last.x + last.w, region.x + region.w);
+            const uint16_t y1 = std::max(last.y + last.h, region.y + region.h);
+            const Rect<uint16_t> merged { x0, y0, uint16_t(x1 - x0), uint16_t(y1 - y0) };
+
+            const bool touching = region.x <= last.x + last.w && last.x <= region.x + region.w &&
+                                  region.y <= last.y + last.h && last.y <= region.y + region.h;
+            if (touching && area(merged) <= 2 * (area(last) + area(region))) {
+                last = merged;
+                continue;
+            }
+        }
+        result.push_back(region);
+    }
+    return result;
 }
 
 void Context::bindTexture(Texture& obj,
@@ -349,9 +856,59 @@ void Context::bindTexture(Texture& obj,
     }
 }
 
+void Context::trackResource(GLResourceStats::Type type, uint32_t id, std::size_t bytes) {
+    auto result = trackedResources[std::size_t(type)].emplace(id, TrackedResource { resourceOwner, 0 });
+    TrackedResource& resource = result.first->second;
+    GLResourceStats::Usage& usage = resourceStats.get(resource.owner, type);
+    if (result.second) {
+        usage.objects++;
+    }
+
+    usage.bytes = usage.bytes - resource.bytes + bytes;
+    resourceBytes = resourceBytes - resource.bytes + bytes;
+    resource.bytes = bytes;
+
+    if (resourceBytes > resourceStats.highWaterBytes) {
+        resourceStats.highWaterBytes = resourceBytes;
+
+        // Logged in steps, rather than for every object uploaded.
+        constexpr std::size_t step = 16 * 1024 * 1024;
+        if (resourceBytes >= loggedHighWaterBytes + step) {
+            loggedHighWaterBytes = resourceBytes;
+            Log::Info(Event::OpenGL, "GL resources reached %zu kB", resourceBytes / 1024);
+        }
+    }
+}
+
+void Context::untrackResource(GLResourceStats::Type type, uint32_t id) {
+    auto& resources = trackedResources[std::size_t(type)];
+    const auto it = resources.find(id);
+    if (it == resources.end()) {
+        return;
+    }
+
+    GLResourceStats::Usage& usage = resourceStats.get(it->second.owner, type);
+    usage.objects--;
+    usage.bytes -= it->second.bytes;
+    resourceBytes -= it->second.bytes;
+    resources.erase(it);
+}
+
 void Context::reset() {
+    sharedBufferIDs = {};
+    sharedBuffers.clear();
+    sharedTextureIDs.clear();
+    sharedTextures.clear();
     std::copy(pooledTextures.begin(), pooledTextures.end(), std::back_inserter(abandonedTextures));
     pooledTextures.resize(0);
+    for (const auto& recycled : recycledVertexArrays) {
+        abandonedVertexArrays.push_back(recycled.first);
+    }
+    recycledVertexArrays.clear();
+    for (const auto& pool : pooledVertexArrays) {
+        std::copy(pool.second.begin(), pool.second.end(), std::back_inserter(abandonedVertexArrays));
+    }
+    pooledVertexArrays.clear();
     performCleanup();
 }
 
@@ -362,6 +919,8 @@ void Context::setDirtyState() {
     stencilMask.setDirty();
     stencilTest.setDirty();
     stencilOp.setDirty();
+    scissorTest.setDirty();
+    scissor.setDirty();
     depthRange.setDirty();
     depthMask.setDirty();
     depthTest.setDirty();
@@ -399,6 +958,9 @@ void Context::clear(optional<mbgl::Color> color,
                     optional<int32_t> stencil) {
     GLbitfield mask = 0;
 
+    // Clears cover the whole framebuffer.
+    scissorTest = false;
+
     if (color) {
         mask |= GL_COLOR_BUFFER_BIT;
         clearColor = *color;
@@ -482,24 +1044,54 @@ void Context::setColorMode(const ColorMode& color) {
     colorMask = color.mask;
 }
 
+namespace {
+
+std::size_t indexSize(DataType indexType) {
+    assert(indexType == DataType::UnsignedShort || indexType == DataType::UnsignedInteger);
+    return indexType == DataType::UnsignedInteger ? sizeof(uint32_t) : sizeof(uint16_t);
+}
+
+} // namespace
+
 void Context::draw(PrimitiveType primitiveType,
+                   DataType indexType,
                    std::size_t indexOffset,
                    std::size_t indexLength) {
     MBGL_CHECK_ERROR(glDrawElements(
         static_cast<GLenum>(primitiveType),
         static_cast<GLsizei>(indexLength),
-        GL_UNSIGNED_SHORT,
-        reinterpret_cast<GLvoid*>(sizeof(uint16_t) * indexOffset)));
+        static_cast<GLenum>(indexType),
+        reinterpret_cast<GLvoid*>(indexSize(indexType) * indexOffset)));
+    drawCalls++;
+}
+
+void Context::drawInstanced(PrimitiveType primitiveType,
+                            DataType indexType,
+                            std::size_t indexOffset,
+                            std::size_t indexLength,
+                            std::size_t instanceCount) {
+    assert(supportsInstancing());
+    MBGL_CHECK_ERROR(gl::DrawElementsInstanced(
+        static_cast<GLenum>(primitiveType),
+        static_cast<GLsizei>(indexLength),
+        static_cast<GLenum>(indexType),
+        reinterpret_cast<GLvoid*>(indexSize(indexType) * indexOffset),
+        static_cast<GLsizei>(instanceCount)));
+    drawCalls++;
 }
 
 void Context::performCleanup() {
+    std::vector<ProgramID> abandonedPrograms;
+    {
+        std::lock_guard<std::mutex> lock(sharedResources->mutex);
+        std::swap(abandonedPrograms, sharedResources->abandonedPrograms);
+    }
     for (auto id : abandonedPrograms) {
         if (program == id) {
             program.setDirty();
         }
         MBGL_CHECK_ERROR(glDeleteProgram(id));
     }
-    abandonedPrograms.clear();
 
     for (auto id : abandonedShaders) {
         MBGL_CHECK_ERROR(glDeleteShader(id));
@@ -528,6 +1120,31 @@ void Context::performCleanup() {
         abandonedTextures.clear();
     }
 
+    if (!recycledVertexArrays.empty()) {
+        assert(supportsVertexArrays());
+        // Pointing the attributes at no buffer releases those the array referenced. They
+        // are all bound again by the array's next user.
+        vertexBuffer = 0;
+        for (const auto& recycled : recycledVertexArrays) {
+            auto& pool = pooledVertexArrays[recycled.second];
+            if (pool.size() >= VertexArrayPoolMax) {
+                abandonedVertexArrays.push_back(recycled.first);
+                continue;
+            }
+
+            vertexArrayObject = recycled.first;
+            for (GLuint location = 0; location < recycled.second; ++location) {
+                MBGL_CHECK_ERROR(glDisableVertexAttribArray(location));
+                MBGL_CHECK_ERROR(glVertexAttribPointer(location, 1, GL_FLOAT, GL_FALSE, 0, nullptr));
+            }
+            MBGL_CHECK_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+            pool.push_back(recycled.first);
+        }
+        recycledVertexArrays.clear();
+        vertexArrayObject = 0;
+        elementBuffer.setDirty();
+    }
+
     if (!abandonedVertexArrays.empty()) {
         assert(supportsVertexArrays());
         for (const auto id : abandonedVertexArrays) {
@@ -556,6 +1173,12 @@ void Context::performCleanup() {
                                                abandonedRenderbuffers.data()));
         abandonedRenderbuffers.clear();
     }
+
+    if (!abandonedQueries.empty()) {
+        assert(supportsTimerQueries());
+        MBGL_CHECK_ERROR(gl::DeleteQueries(int(abandonedQueries.size()), abandonedQueries.data()));
+        abandonedQueries.clear();
+    }
 }
 
 } // namespace gl
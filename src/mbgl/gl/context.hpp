@@ -13,51 +13,226 @@
 #include <mbgl/gl/depth_mode.hpp>
 #include <mbgl/gl/stencil_mode.hpp>
 #include <mbgl/gl/color_mode.hpp>
+#include <mbgl/gl/uniform.hpp>
+#include <mbgl/gl/shared_resources.hpp>
+#include <mbgl/map/gl_resource_stats.hpp>
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/util/rect.hpp>
 
 
+#include <cassert>
 #include <functional>
 #include <memory>
 #include <vector>
 #include <array>
 #include <string>
 #include <unordered_map>
+#include <map>
+#include <utility>
 
 namespace mbgl {
 
 class View;
+class CompressedImage;
 
 namespace gl {
 
+template <class>
+class SegmentVector;
+
 constexpr size_t TextureMax = 64;
 
+// The most vertex arrays kept for reuse, for each number of attributes.
+constexpr size_t VertexArrayPoolMax = 256;
+
+// Shared buffers are this large, and hold data of at most `SharedBufferRangeMax` bytes.
+constexpr size_t SharedBufferSize = 1024 * 1024;
+constexpr size_t SharedBufferRangeMax = 64 * 1024;
+
+// Shared textures hold this many slots a side, each for a square image with a side that is a
+// power of two from `SharedTextureSlotMin` to `SharedTextureSlotMax` pixels.
+constexpr uint16_t SharedTextureSlots = 4;
+constexpr uint16_t SharedTextureSlotMin = 64;
+constexpr uint16_t SharedTextureSlotMax = 512;
+
 class Context : private util::noncopyable {
 public:
+    Context();
     ~Context();
 
+    // Makes this context share the programs and registered objects of `other`, which it
+    // must be able to use: their GL contexts must be in one share group. They must also not
+    // be used on two threads at once, since shared programs keep their uniforms for all of
+    // them. Call it before this context creates any program.
+    void shareWith(Context& other);
+
+    bool sharesResources() const {
+        return sharing;
+    }
+
+    // Returns the object registered under `key` by this context or one it shares with, or
+    // registers the one returned by `create`; see `SharedResources::get`.
+    template <class T, class Fn>
+    std::shared_ptr<T> getSharedResource(const std::string& key, Fn&& create) {
+        return sharedResources->get<T>(key, std::forward<Fn>(create));
+    }
+
     UniqueShader createShader(ShaderType type, const std::string& source);
     UniqueProgram createProgram(ShaderID vertexShader, ShaderID fragmentShader);
     void linkProgram(ProgramID);
+
+    // Program binaries can only be loaded by the driver that produced them; the description
+    // identifies it.
+    bool supportsProgramBinaries() const;
+    std::string getDriverDescription() const;
+    optional<std::pair<BinaryProgramFormat, std::string>> getBinaryProgram(ProgramID) const;
+
+    // Restores a linked program from a binary returned by `getBinaryProgram`. Throws if the
+    // driver rejects it.
+    UniqueProgram createProgram(BinaryProgramFormat, const std::string& binary);
     UniqueTexture createTexture();
 
+    // Whether textures can be created from images in the given compressed format, one of
+    // those the driver reports in GL_COMPRESSED_TEXTURE_FORMATS.
+    bool supportsCompressedTextureFormat(uint32_t format);
+
     bool supportsVertexArrays() const;
-    UniqueVertexArray createVertexArray();
 
+    // Returns an array for binding `attributeCount` attributes, at locations 0 to
+    // `attributeCount - 1`, reusing one released by another user of as many attributes where
+    // possible: binding all of them overwrites every part of the array's state that's in use.
+    // Creating and deleting arrays is slow with some drivers, and tiles churn through them.
+    UniqueVertexArray createVertexArray(std::size_t attributeCount);
+
+    // Instanced draws rely on vertex array objects to keep attribute divisors from leaking
+    // into other draws.
+    bool supportsInstancing() const;
+
+    // Whether indices can be 32 bit wide. This is part of desktop OpenGL, and an extension
+    // of OpenGL ES 2.
+    bool supportsWideIndices() const;
+
+    // Whether float vertex attributes can be read from buffers of `HalfFloat`s.
+    bool supportsHalfFloatAttributes() const;
+
+    // Timer queries measure the GPU time spent on the commands between the start and the end
+    // of the query. Only one can be active at a time, and results become available some time
+    // after the commands were submitted.
+    bool supportsTimerQueries() const;
+    UniqueQuery createQuery();
+    void beginTimerQuery(QueryID);
+    void endTimerQuery();
+    bool isQueryResultAvailable(QueryID) const;
+    Duration getTimerQueryResult(QueryID) const;
+
+    // Returns whether the GPU has had a disjoint event, such as a change of its clock
+    // frequency, since this was last called. Results of queries that were active in the
+    // meantime are meaningless.
+    bool checkTimerDisjoint() const;
+
+    // Data of up to `SharedBufferRangeMax` bytes is placed in a buffer shared with other
+    // small data of the same owner (see `ResourceOwnerScope`), rather than in a buffer of
+    // its own, so that the many small buckets of tiles take up a few large buffers.
     template <class Vertex, class DrawMode>
     VertexBuffer<Vertex, DrawMode> createVertexBuffer(VertexVector<Vertex, DrawMode>&& v) {
+        auto buffer = createBuffer(BufferTarget::Vertex, v.data(), v.byteSize());
         return VertexBuffer<Vertex, DrawMode> {
             v.vertexSize(),
-            createVertexBuffer(v.data(), v.byteSize())
+            std::move(buffer.first),
+            buffer.second
         };
     }
 
     template <class DrawMode>
     IndexBuffer<DrawMode> createIndexBuffer(IndexVector<DrawMode>&& v) {
+        auto buffer = createBuffer(BufferTarget::Index, v.data(), v.byteSize());
         return IndexBuffer<DrawMode> {
-            createIndexBuffer(v.data(), v.byteSize())
+            std::move(buffer.first),
+            DataType::UnsignedShort,
+            buffer.second / sizeof(uint16_t)
         };
     }
 
+    // Uploads the indices of `segments`. Each segment holds at most 65536 vertices, so that
+    // its indices fit 16 bits; where indices can be wider, the segments are merged into one
+    // that is drawn with a single call.
+    template <class DrawMode, class Attributes>
+    IndexBuffer<DrawMode> createIndexBuffer(IndexVector<DrawMode>&& v, SegmentVector<Attributes>& segments) {
+        if (segments.size() < 2 || !supportsWideIndices()) {
+            return createIndexBuffer(std::move(v));
+        }
+
+        const auto& first = segments.front();
+        const auto& last = segments.back();
+
+        // Merging needs the segments' indices to follow each other.
+        std::size_t indexEnd = first.indexOffset;
+        for (const auto& segment : segments) {
+            if (segment.indexOffset != indexEnd || segment.vertexOffset < first.vertexOffset) {
+                return createIndexBuffer(std::move(v));
+            }
+            indexEnd += segment.indexLength;
+        }
+
+        std::vector<uint32_t> indices(v.data(), v.data() + v.indexSize());
+        for (const auto& segment : segments) {
+            const auto base = static_cast<uint32_t>(segment.vertexOffset - first.vertexOffset);
+            for (std::size_t i = segment.indexOffset; i < segment.indexOffset + segment.indexLength; ++i) {
+                indices[i] += base;
+            }
+        }
+
+        const std::size_t vertexOffset = first.vertexOffset;
+        const std::size_t indexOffset = first.indexOffset;
+        const std::size_t vertexLength = last.vertexOffset + last.vertexLength - vertexOffset;
+        segments.clear();
+        segments.emplace_back(vertexOffset, indexOffset, vertexLength, indexEnd - indexOffset);
+
+        auto buffer = createBuffer(BufferTarget::Index, indices.data(), indices.size() * sizeof(uint32_t));
+        return IndexBuffer<DrawMode> {
+            std::move(buffer.first),
+            DataType::UnsignedInteger,
+            buffer.second / sizeof(uint32_t)
+        };
+    }
+
+    // Buffers of data that is re-uploaded while earlier contents may still be drawn from,
+    // with `updateVertexBuffer` and `updateIndexBuffer`. They never share their storage:
+    // each update orphans it, so that the driver hands out fresh memory instead of waiting
+    // for the draws of previous frames to finish.
+    template <class Vertex, class DrawMode>
+    VertexBuffer<Vertex, DrawMode> createStreamVertexBuffer(VertexVector<Vertex, DrawMode>&& v) {
+        return VertexBuffer<Vertex, DrawMode> {
+            v.vertexSize(),
+            createStreamBuffer(BufferTarget::Vertex, v.data(), v.byteSize()),
+            0
+        };
+    }
+
+    template <class DrawMode>
+    IndexBuffer<DrawMode> createStreamIndexBuffer(IndexVector<DrawMode>&& v) {
+        return IndexBuffer<DrawMode> {
+            createStreamBuffer(BufferTarget::Index, v.data(), v.byteSize()),
+            DataType::UnsignedShort,
+            0
+        };
+    }
+
+    template <class Vertex, class DrawMode>
+    void updateVertexBuffer(VertexBuffer<Vertex, DrawMode>& buffer, VertexVector<Vertex, DrawMode>&& v) {
+        assert(buffer.byteOffset == 0);
+        updateStreamBuffer(BufferTarget::Vertex, buffer.buffer, v.data(), v.byteSize());
+        buffer.vertexCount = v.vertexSize();
+    }
+
+    template <class DrawMode>
+    void updateIndexBuffer(IndexBuffer<DrawMode>& buffer, IndexVector<DrawMode>&& v) {
+        assert(buffer.indexOffset == 0 && buffer.indexType == DataType::UnsignedShort);
+        updateStreamBuffer(BufferTarget::Index, buffer.buffer, v.data(), v.byteSize());
+    }
+
     template <RenderbufferType type>
     Renderbuffer<type> createRenderbuffer(const Size size) {
         static_assert(type == RenderbufferType::RGBA || type == RenderbufferType::DepthStencil,
@@ -82,6 +257,19 @@ public:
     }
 
 #if not MBGL_USE_GLES2
+    UniqueBuffer createPixelBuffer();
+
+    // Starts reading the framebuffer into a pixel buffer, and returns without waiting for
+    // rendering to finish. The GPU is only waited for when the pixels are collected with
+    // `readPixelBuffer`, so other work can be done in between.
+    void startReadFramebuffer(BufferID pixelBuffer, Size);
+
+    template <typename Image>
+    Image readPixelBuffer(BufferID pixelBuffer, const Size size, bool flip = true) {
+        static_assert(Image::channels == 4, "pixel buffers hold RGBA data");
+        return { size, readPixelBuffer(pixelBuffer, size, flip) };
+    }
+
     template <typename Image>
     void drawPixels(const Image& image) {
         auto format = image.channels == 4 ? TextureFormat::RGBA : TextureFormat::Alpha;
@@ -103,6 +291,36 @@ public:
         obj.size = image.size;
     }
 
+    // Replaces the part of the texture at the given offset with the image, which must fit
+    // within it. The rest of the texture is left alone.
+    template <typename Image>
+    void updateTextureRegion(Texture& obj, const Image& image, uint16_t x, uint16_t y, TextureUnit unit = 0) {
+        assert(x + image.size.width <= obj.size.width && y + image.size.height <= obj.size.height);
+        auto format = image.channels == 4 ? TextureFormat::RGBA : TextureFormat::Alpha;
+        updateTextureRegion(obj.texture.get(), x, y, image.size, image.data.get(), format, unit);
+    }
+
+    // Uploads the given regions of an image to the same places in the texture, which must
+    // have the image's size. Regions that touch are merged first, as long as that doesn't
+    // add many pixels. OpenGL ES 2 can't upload part of a row, so each region is copied
+    // out of the image.
+    template <typename Image>
+    void updateTextureRegions(Texture& obj, const Image& image, std::vector<Rect<uint16_t>> regions, TextureUnit unit = 0) {
+        assert(obj.size == image.size);
+        for (const auto& region : coalesceRegions(std::move(regions))) {
+            Image patch({ region.w, region.h });
+            Image::copy(image, patch, { region.x, region.y }, { 0, 0 }, patch.size);
+            updateTextureRegion(obj, patch, region.x, region.y, unit);
+        }
+    }
+
+    // Creates a texture from the full sized level of a compressed image, in a supported format.
+    Texture createTexture(const CompressedImage&, TextureUnit unit = 0);
+
+    // Generates the mipmap levels of a texture from its full sized level. OpenGL ES 2 can only
+    // do this for sizes that are powers of two.
+    void generateMipmap(Texture&, TextureUnit unit = 0);
+
     // Creates an empty texture with the specified dimensions.
     Texture createTexture(const Size size,
                           TextureFormat format = TextureFormat::RGBA,
@@ -110,6 +328,23 @@ public:
         return { size, createTexture(size, nullptr, format, unit) };
     }
 
+    // Images that fit a slot of a shared texture (see `SharedTextureSlots`) are placed in
+    // one, with up to 15 other images of their size, rather than in a texture of their own,
+    // so that the many tiles drawn one after another bind a few textures. Returns nothing
+    // for other images.
+    template <typename Image>
+    optional<SharedTexture> createSharedTexture(const Image& image, TextureUnit unit = 0) {
+        static_assert(Image::channels == 4, "shared textures are RGBA");
+        return createSharedTexture(image.size, image.data.get(), unit);
+    }
+
+    // Binds the texture the image shares, generating its mipmaps first if they are to be
+    // used and images were placed in it since they were last generated.
+    void bindTexture(SharedTexture&,
+                     TextureUnit = 0,
+                     TextureFilter = TextureFilter::Nearest,
+                     TextureMipMap = TextureMipMap::No);
+
     void bindTexture(Texture&,
                      TextureUnit = 0,
                      TextureFilter = TextureFilter::Nearest,
@@ -132,9 +367,16 @@ public:
     void setColorMode(const ColorMode&);
 
     void draw(PrimitiveType,
+              DataType indexType,
               std::size_t indexOffset,
               std::size_t indexLength);
 
+    void drawInstanced(PrimitiveType,
+                       DataType indexType,
+                       std::size_t indexOffset,
+                       std::size_t indexLength,
+                       std::size_t instanceCount);
+
     // Actually remove the objects we marked as abandoned with the above methods.
     // Only call this while the OpenGL context is exclusive to this thread.
     void performCleanup();
@@ -145,65 +387,106 @@ public:
 
     bool empty() const {
         return pooledTextures.empty()
-            && abandonedPrograms.empty()
+            && sharedTextures.empty()
+            && pooledVertexArrays.empty()
+            && recycledVertexArrays.empty()
+            && sharedBuffers.empty()
+            && sharedResources->abandonedPrograms.empty()
             && abandonedShaders.empty()
             && abandonedBuffers.empty()
             && abandonedTextures.empty()
             && abandonedVertexArrays.empty()
-            && abandonedFramebuffers.empty();
+            && abandonedFramebuffers.empty()
+            && abandonedQueries.empty();
     }
 
     void setDirtyState();
 
-    State<value::ActiveTexture> activeTexture;
-    State<value::BindFramebuffer> bindFramebuffer;
-    State<value::Viewport> viewport;
-    std::array<State<value::BindTexture>, 2> texture;
-    State<value::BindVertexArray> vertexArrayObject;
-    State<value::Program> program;
-    State<value::BindVertexBuffer> vertexBuffer;
-    State<value::BindElementBuffer> elementBuffer;
+    // Accumulates over the lifetime of the context; reset it to measure a span of frames.
+    UniformCounts uniformCounts;
+
+    // Draw calls made, and bytes of data uploaded into buffers and textures. Like
+    // `uniformCounts`, they accumulate over the lifetime of the context.
+    std::size_t drawCalls = 0;
+    std::size_t uploadedBytes = 0;
+
+    // Buckets uploaded, and calls that changed the GL state: those that switched the program,
+    // and all the others. They accumulate as well.
+    std::size_t bucketUploads = 0;
+    std::size_t programSwitches = 0;
+    std::size_t stateChanges = 0;
+
+    // The objects alive, counted from their creation until they are abandoned. Textures
+    // returned to the pool aren't counted, though their storage is only freed once reused.
+    const GLResourceStats& getResourceStats() const {
+        return resourceStats;
+    }
+
+    // What the objects created from now on are counted for; see `ResourceOwnerScope`.
+    GLResourceStats::Owner resourceOwner = GLResourceStats::Owner::Other;
+
+    State<value::ActiveTexture> activeTexture { stateChanges };
+    State<value::BindFramebuffer> bindFramebuffer { stateChanges };
+    State<value::Viewport> viewport { stateChanges };
+    State<value::ScissorTest> scissorTest { stateChanges };
+    State<value::Scissor> scissor { stateChanges };
+    std::array<State<value::BindTexture>, 2> texture {{ State<value::BindTexture>(stateChanges), State<value::BindTexture>(stateChanges) }};
+    State<value::BindVertexArray> vertexArrayObject { stateChanges };
+    State<value::Program> program { programSwitches };
+    State<value::BindVertexBuffer> vertexBuffer { stateChanges };
+    State<value::BindElementBuffer> elementBuffer { stateChanges };
 
 #if not MBGL_USE_GLES2
-    State<value::PixelZoom> pixelZoom;
-    State<value::RasterPos> rasterPos;
-    State<value::PixelStorePack> pixelStorePack;
-    State<value::PixelStoreUnpack> pixelStoreUnpack;
-    State<value::PixelTransferDepth> pixelTransferDepth;
-    State<value::PixelTransferStencil> pixelTransferStencil;
+    State<value::PixelZoom> pixelZoom { stateChanges };
+    State<value::RasterPos> rasterPos { stateChanges };
+    State<value::PixelStorePack> pixelStorePack { stateChanges };
+    State<value::PixelStoreUnpack> pixelStoreUnpack { stateChanges };
+    State<value::PixelTransferDepth> pixelTransferDepth { stateChanges };
+    State<value::PixelTransferStencil> pixelTransferStencil { stateChanges };
 #endif // MBGL_USE_GLES2
 
 private:
-    State<value::StencilFunc> stencilFunc;
-    State<value::StencilMask> stencilMask;
-    State<value::StencilTest> stencilTest;
-    State<value::StencilOp> stencilOp;
-    State<value::DepthRange> depthRange;
-    State<value::DepthMask> depthMask;
-    State<value::DepthTest> depthTest;
-    State<value::DepthFunc> depthFunc;
-    State<value::Blend> blend;
-    State<value::BlendEquation> blendEquation;
-    State<value::BlendFunc> blendFunc;
-    State<value::BlendColor> blendColor;
-    State<value::ColorMask> colorMask;
-    State<value::ClearDepth> clearDepth;
-    State<value::ClearColor> clearColor;
-    State<value::ClearStencil> clearStencil;
-    State<value::LineWidth> lineWidth;
-    State<value::BindRenderbuffer> bindRenderbuffer;
+    State<value::StencilFunc> stencilFunc { stateChanges };
+    State<value::StencilMask> stencilMask { stateChanges };
+    State<value::StencilTest> stencilTest { stateChanges };
+    State<value::StencilOp> stencilOp { stateChanges };
+    State<value::DepthRange> depthRange { stateChanges };
+    State<value::DepthMask> depthMask { stateChanges };
+    State<value::DepthTest> depthTest { stateChanges };
+    State<value::DepthFunc> depthFunc { stateChanges };
+    State<value::Blend> blend { stateChanges };
+    State<value::BlendEquation> blendEquation { stateChanges };
+    State<value::BlendFunc> blendFunc { stateChanges };
+    State<value::BlendColor> blendColor { stateChanges };
+    State<value::ColorMask> colorMask { stateChanges };
+    State<value::ClearDepth> clearDepth { stateChanges };
+    State<value::ClearColor> clearColor { stateChanges };
+    State<value::ClearStencil> clearStencil { stateChanges };
+    State<value::LineWidth> lineWidth { stateChanges };
+    State<value::BindRenderbuffer> bindRenderbuffer { stateChanges };
 #if not MBGL_USE_GLES2
-    State<value::PointSize> pointSize;
+    State<value::PointSize> pointSize { stateChanges };
 #endif // MBGL_USE_GLES2
 
-    UniqueBuffer createVertexBuffer(const void* data, std::size_t size);
-    UniqueBuffer createIndexBuffer(const void* data, std::size_t size);
+    enum class BufferTarget : uint8_t { Vertex, Index };
+
+    // Returns the buffer holding the data, and the byte offset of the data in it.
+    std::pair<UniqueBuffer, std::size_t> createBuffer(BufferTarget, const void* data, std::size_t size);
+    void bindBuffer(BufferTarget, BufferID);
+    UniqueBuffer createStreamBuffer(BufferTarget, const void* data, std::size_t size);
+    void updateStreamBuffer(BufferTarget, BufferID, const void* data, std::size_t size);
+    void freeSharedBufferRange(BufferID, std::size_t offset, std::size_t size);
     UniqueTexture createTexture(Size size, const void* data, TextureFormat, TextureUnit);
+    optional<SharedTexture> createSharedTexture(Size, const void* data, TextureUnit);
+    void freeSharedTextureSlot(TextureID, std::size_t slot);
     void updateTexture(TextureID, Size size, const void* data, TextureFormat, TextureUnit);
+    void updateTextureRegion(TextureID, uint16_t x, uint16_t y, Size size, const void* data, TextureFormat, TextureUnit);
+    static std::vector<Rect<uint16_t>> coalesceRegions(std::vector<Rect<uint16_t>>);
     UniqueFramebuffer createFramebuffer();
     UniqueRenderbuffer createRenderbuffer(RenderbufferType, Size size);
     std::unique_ptr<uint8_t[]> readFramebuffer(Size, TextureFormat, bool flip);
 #if not MBGL_USE_GLES2
+    std::unique_ptr<uint8_t[]> readPixelBuffer(BufferID, Size, bool flip);
     void drawPixels(Size size, const void* data, TextureFormat);
 #endif // MBGL_USE_GLES2
 
@@ -214,20 +497,98 @@ private:
     friend detail::VertexArrayDeleter;
     friend detail::FramebufferDeleter;
     friend detail::RenderbufferDeleter;
+    friend detail::QueryDeleter;
 
     std::vector<TextureID> pooledTextures;
 
-    std::vector<ProgramID> abandonedPrograms;
+    // Released arrays, and their attribute counts, are detached from their buffers before
+    // they are pooled, so that the buffers can be freed.
+    std::vector<std::pair<VertexArrayID, std::size_t>> recycledVertexArrays;
+    std::unordered_map<std::size_t, std::vector<VertexArrayID>> pooledVertexArrays;
+    optional<std::vector<uint32_t>> compressedTextureFormats;
+
+    // Counts an object for the current owner, or changes the bytes of one already counted.
+    void trackResource(GLResourceStats::Type, uint32_t id, std::size_t bytes);
+    void untrackResource(GLResourceStats::Type, uint32_t id);
+
+    struct TrackedResource {
+        GLResourceStats::Owner owner;
+        std::size_t bytes;
+    };
+
+    // By object type, since each type has IDs of its own.
+    std::array<std::unordered_map<uint32_t, TrackedResource>, GLResourceStats::TypeCount> trackedResources;
+    GLResourceStats resourceStats;
+    std::size_t resourceBytes = 0;
+    std::size_t loggedHighWaterBytes = 0;
+
+    std::shared_ptr<SharedResources> sharedResources;
+    bool sharing = false;
+
     std::vector<ShaderID> abandonedShaders;
     std::vector<BufferID> abandonedBuffers;
     std::vector<TextureID> abandonedTextures;
     std::vector<VertexArrayID> abandonedVertexArrays;
     std::vector<FramebufferID> abandonedFramebuffers;
     std::vector<RenderbufferID> abandonedRenderbuffers;
+    std::vector<QueryID> abandonedQueries;
+
+    // Declared after the abandoned objects, so that the buffers are abandoned if destroyed
+    // along with the context.
+    struct SharedBuffer {
+        UniqueBuffer buffer;
+        GLResourceStats::Owner owner;
+        BufferTarget target;
+        // The free ranges, by offset, with their sizes. Neighbouring free ranges are merged.
+        std::map<std::size_t, std::size_t> freeRanges;
+        std::size_t usedBytes;
+    };
+
+    std::unordered_map<BufferID, SharedBuffer> sharedBuffers;
+
+    // The IDs of `sharedBuffers`, by owner and target, in the order ranges are looked for.
+    std::array<std::array<std::vector<BufferID>, 2>, GLResourceStats::OwnerCount> sharedBufferIDs;
+
+    struct SharedTexturePage {
+        Texture texture;
+        std::vector<bool> usedSlots;
+        std::size_t usedCount;
+        bool mipmapsDirty;
+    };
+
+    std::unordered_map<TextureID, SharedTexturePage> sharedTextures;
+
+    // The IDs of `sharedTextures`, by the side of their slots, in the order slots are looked
+    // for.
+    std::unordered_map<uint16_t, std::vector<TextureID>> sharedTextureIDs;
+    optional<int32_t> maxTextureSize;
 
 public:
     // For testing
     bool disableVAOExtension = false;
+    bool disableInstancingExtension = false;
+    bool disableProgramBinaryExtension = false;
+    bool disableTimerQueryExtension = false;
+    bool disableHalfFloatExtension = false;
+    bool disableWideIndexExtension = false;
+};
+
+// Counts the objects a context creates during its lifetime for `owner`. Scopes nest.
+class ResourceOwnerScope : private util::noncopyable {
+public:
+    ResourceOwnerScope(Context& context_, GLResourceStats::Owner owner)
+        : context(context_),
+          previous(context.resourceOwner) {
+        context.resourceOwner = owner;
+    }
+
+    ~ResourceOwnerScope() {
+        context.resourceOwner = previous;
+    }
+
+private:
+    Context& context;
+    const GLResourceStats::Owner previous;
 };
 
 } // namespace gl
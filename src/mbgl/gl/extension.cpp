@@ -24,11 +24,13 @@ ExtensionFunctionBase::ExtensionFunctionBase(std::initializer_list<Probe> probes
 } // namespace detail
 
 static std::once_flag initializeExtensionsOnce;
+static std::string extensionNames;
 
 void InitializeExtensions(glProc (*getProcAddress)(const char*)) {
     std::call_once(initializeExtensionsOnce, [getProcAddress] {
         if (const char* extensions =
                 reinterpret_cast<const char*>(MBGL_CHECK_ERROR(glGetString(GL_EXTENSIONS)))) {
+            extensionNames = extensions;
             for (auto fn : detail::extensionFunctions()) {
                 for (auto probe : fn.second) {
                     if (strstr(extensions, probe.first) != nullptr) {
@@ -41,5 +43,9 @@ void InitializeExtensions(glProc (*getProcAddress)(const char*)) {
     });
 }
 
+bool HasExtension(const char* name) {
+    return strstr(extensionNames.c_str(), name) != nullptr;
+}
+
 } // namespace gl
 } // namespace mbgl
@@ -9,6 +9,10 @@ namespace gl {
 using glProc = void (*)();
 void InitializeExtensions(glProc (*getProcAddress)(const char*));
 
+// Whether the driver advertises an extension, for extensions that don't add functions.
+// Always false before `InitializeExtensions` was called.
+bool HasExtension(const char* name);
+
 namespace detail {
 
 class ExtensionFunctionBase {
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace mbgl {
+namespace gl {
+
+// An IEEE 754 half precision float, as read by vertex attributes of type GL_HALF_FLOAT. Its
+// range and precision are those of a `mediump` shader variable: values are rounded to 11
+// significant bits, and magnitudes beyond 65504 are clamped.
+class HalfFloat {
+public:
+    uint16_t value;
+
+    HalfFloat() : value(0) {}
+
+    explicit HalfFloat(float f)
+        : value(fromFloat(f)) {
+    }
+
+    float toFloat() const {
+        const uint32_t sign = uint32_t(value & 0x8000) << 16;
+        const uint32_t exponent = (value >> 10) & 0x1F;
+        const uint32_t mantissa = value & 0x3FF;
+
+        if (exponent == 0) {
+            const float subnormal = std::ldexp(float(mantissa), -24);
+            return sign ? -subnormal : subnormal;
+        }
+
+        const uint32_t bits = exponent == 0x1F
+            ? sign | 0x7F800000 | (mantissa << 13)
+            : sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+private:
+    static uint16_t fromFloat(float f) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+
+        const uint16_t sign = (bits >> 16) & 0x8000;
+        const int32_t exponent = int32_t((bits >> 23) & 0xFF) - 127 + 15;
+        uint32_t mantissa = bits & 0x7FFFFF;
+
+        if (exponent == 0xFF - 127 + 15) {
+            // Infinity stays infinite, and NaN stays NaN.
+            return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+        }
+
+        if (exponent <= 0) {
+            if (exponent < -10) {
+                return sign;
+            }
+            mantissa |= 0x800000;
+            const uint32_t shift = 14 - exponent;
+            uint32_t half = mantissa >> shift;
+            if ((mantissa >> (shift - 1)) & 1) {
+                ++half;
+            }
+            return sign | half;
+        }
+
+        uint32_t half = (uint32_t(exponent) << 10) | (mantissa >> 13);
+        if (mantissa & 0x1000) {
+            // A carry into the exponent is still the correctly rounded value.
+            ++half;
+        }
+        return sign | (half >= 0x7C00 ? 0x7BFF : half);
+    }
+};
+
+inline bool operator==(const HalfFloat& lhs, const HalfFloat& rhs) {
+    return lhs.value == rhs.value;
+}
+
+} // namespace gl
+} // namespace mbgl
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <mbgl/gl/object.hpp>
+#include <mbgl/gl/types.hpp>
 #include <mbgl/gl/draw_mode.hpp>
 #include <mbgl/util/ignore.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
 
 namespace mbgl {
@@ -23,6 +26,27 @@ public:
     std::size_t indexSize() const { return v.size(); }
     std::size_t byteSize() const { return v.size() * sizeof(uint16_t); }
 
+    // Makes room for `n` more indices; see VertexVector::reserveAdditional.
+    void reserveAdditional(std::size_t n) {
+        if (v.size() + n > v.capacity()) {
+            v.reserve(std::max(v.size() + n, v.capacity() * 2));
+        }
+    }
+
+    // Adds `delta` to the indices from position `from` on, for indices that were added
+    // relative to a base vertex which wasn't known yet.
+    void offset(std::size_t from, uint16_t delta) {
+        for (std::size_t i = from; i < v.size(); ++i) {
+            v[i] += delta;
+        }
+    }
+
+    // Replaces the indices; see VertexVector::assign.
+    void assign(std::vector<uint16_t> indices) {
+        assert(indices.size() % groupSize == 0);
+        v = std::move(indices);
+    }
+
     bool empty() const { return v.empty(); }
     const uint16_t* data() const { return v.data(); }
 
@@ -34,6 +58,13 @@ template <class DrawMode>
 class IndexBuffer {
 public:
     UniqueBuffer buffer;
+
+    // `UnsignedShort`, or `UnsignedInteger` for the merged segments of
+    // `Context::createIndexBuffer`.
+    DataType indexType = DataType::UnsignedShort;
+
+    // Where the indices start in `buffer`, which may hold other data too, counted in indices.
+    std::size_t indexOffset = 0;
 };
 
 } // namespace gl
@@ -0,0 +1,18 @@
+#include <mbgl/gl/instancing.hpp>
+
+namespace mbgl {
+namespace gl {
+
+ExtensionFunction<void(GLuint index, GLuint divisor)>
+    VertexAttribDivisor({ { "GL_ARB_instanced_arrays", "glVertexAttribDivisorARB" },
+                          { "GL_ANGLE_instanced_arrays", "glVertexAttribDivisorANGLE" },
+                          { "GL_EXT_instanced_arrays", "glVertexAttribDivisorEXT" } });
+
+ExtensionFunction<void(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices, GLsizei primcount)>
+    DrawElementsInstanced({ { "GL_ARB_draw_instanced", "glDrawElementsInstancedARB" },
+                            { "GL_ANGLE_instanced_arrays", "glDrawElementsInstancedANGLE" },
+                            { "GL_EXT_instanced_arrays", "glDrawElementsInstancedEXT" },
+                            { "GL_EXT_draw_instanced", "glDrawElementsInstancedEXT" } });
+
+} // namespace gl
+} // namespace mbgl
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+
+namespace mbgl {
+namespace gl {
+
+extern ExtensionFunction<void(GLuint index, GLuint divisor)> VertexAttribDivisor;
+extern ExtensionFunction<void(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices, GLsizei primcount)> DrawElementsInstanced;
+
+} // namespace gl
+} // namespace mbgl
@@ -8,8 +8,9 @@ namespace gl {
 namespace detail {
 
 void ProgramDeleter::operator()(ProgramID id) const {
-    assert(context);
-    context->abandonedPrograms.push_back(id);
+    assert(resources);
+    std::lock_guard<std::mutex> lock(resources->mutex);
+    resources->abandonedPrograms.push_back(id);
 }
 
 void ShaderDeleter::operator()(ShaderID id) const {
@@ -19,11 +20,21 @@ void ShaderDeleter::operator()(ShaderID id) const {
 
 void BufferDeleter::operator()(BufferID id) const {
     assert(context);
+    if (size) {
+        context->freeSharedBufferRange(id, offset, size);
+        return;
+    }
+    context->untrackResource(GLResourceStats::Type::Buffer, id);
     context->abandonedBuffers.push_back(id);
 }
 
 void TextureDeleter::operator()(TextureID id) const {
     assert(context);
+    if (slot) {
+        context->freeSharedTextureSlot(id, slot - 1);
+        return;
+    }
+    context->untrackResource(GLResourceStats::Type::Texture, id);
     if (context->pooledTextures.size() >= TextureMax) {
         context->abandonedTextures.push_back(id);
     } else {
@@ -33,19 +44,27 @@ void TextureDeleter::operator()(TextureID id) const {
 
 void VertexArrayDeleter::operator()(VertexArrayID id) const {
     assert(context);
-    context->abandonedVertexArrays.push_back(id);
+    context->untrackResource(GLResourceStats::Type::VertexArray, id);
+    context->recycledVertexArrays.emplace_back(id, attributeCount);
 }
 
 void FramebufferDeleter::operator()(FramebufferID id) const {
     assert(context);
+    context->untrackResource(GLResourceStats::Type::Framebuffer, id);
     context->abandonedFramebuffers.push_back(id);
 }
 
 void RenderbufferDeleter::operator()(RenderbufferID id) const {
     assert(context);
+    context->untrackResource(GLResourceStats::Type::Renderbuffer, id);
     context->abandonedRenderbuffers.push_back(id);
 }
 
+void QueryDeleter::operator()(QueryID id) const {
+    assert(context);
+    context->abandonedQueries.push_back(id);
+}
+
 } // namespace detail
 } // namespace gl
 } // namespace mbgl
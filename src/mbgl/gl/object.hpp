@@ -4,15 +4,21 @@
 
 #include <unique_resource.hpp>
 
+#include <cstddef>
+#include <memory>
+
 namespace mbgl {
 namespace gl {
 
 class Context;
+class SharedResources;
 
 namespace detail {
 
 struct ProgramDeleter {
-    Context* context;
+    // Programs are shared by the contexts of a share group, and may outlive the one that
+    // created them; whichever of them cleans up next deletes them.
+    std::shared_ptr<SharedResources> resources;
     void operator()(ProgramID) const;
 };
 
@@ -23,16 +29,26 @@ struct ShaderDeleter {
 
 struct BufferDeleter {
     Context* context;
+    // For data in a shared buffer, the range it takes up, which is freed instead of the
+    // buffer. Zero sized for buffers of their own.
+    std::size_t offset;
+    std::size_t size;
     void operator()(BufferID) const;
 };
 
 struct TextureDeleter {
     Context* context;
+    // For images in a shared texture, the slot they take up plus one, which is freed instead
+    // of the texture. Zero for textures of their own.
+    std::size_t slot;
     void operator()(TextureID) const;
 };
 
 struct VertexArrayDeleter {
     Context* context;
+    // Arrays are pooled by the number of attributes they were made for; see
+    // `Context::createVertexArray`.
+    std::size_t attributeCount;
     void operator()(VertexArrayID) const;
 };
 
@@ -46,6 +62,11 @@ struct RenderbufferDeleter {
     void operator()(RenderbufferID) const;
 };
 
+struct QueryDeleter {
+    Context* context;
+    void operator()(QueryID) const;
+};
+
 } // namespace detail
 
 using UniqueProgram = std_experimental::unique_resource<ProgramID, detail::ProgramDeleter>;
@@ -55,6 +76,7 @@ using UniqueTexture = std_experimental::unique_resource<TextureID, detail::Textu
 using UniqueVertexArray = std_experimental::unique_resource<VertexArrayID, detail::VertexArrayDeleter>;
 using UniqueFramebuffer = std_experimental::unique_resource<FramebufferID, detail::FramebufferDeleter>;
 using UniqueRenderbuffer = std_experimental::unique_resource<RenderbufferID, detail::RenderbufferDeleter>;
+using UniqueQuery = std_experimental::unique_resource<QueryID, detail::QueryDeleter>;
 
 } // namespace gl
 } // namespace mbgl
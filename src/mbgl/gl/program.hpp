@@ -8,7 +8,10 @@
 #include <mbgl/gl/attribute.hpp>
 #include <mbgl/gl/uniform.hpp>
 
+#include <mbgl/util/optional.hpp>
+
 #include <string>
+#include <utility>
 
 namespace mbgl {
 namespace gl {
@@ -24,11 +27,20 @@ public:
     using AttributeBindings = typename Attributes::Bindings;
 
     Program(Context& context, const std::string& vertexSource, const std::string& fragmentSource)
-        : vertexShader(context.createShader(ShaderType::Vertex, vertexSource)),
-          fragmentShader(context.createShader(ShaderType::Fragment, fragmentSource)),
-          program(context.createProgram(vertexShader, fragmentShader)),
+        : Program(context,
+                  context.createShader(ShaderType::Vertex, vertexSource),
+                  context.createShader(ShaderType::Fragment, fragmentSource)) {}
+
+    // Restores a program saved with `getBinaryProgram`. Attribute locations are bound in the
+    // same order as when it was linked, so they are the same as in the binary.
+    Program(Context& context, BinaryProgramFormat binaryFormat, const std::string& binary)
+        : program(context.createProgram(binaryFormat, binary)),
           attributeLocations(Attributes::locations(program)),
-          uniformsState((context.linkProgram(program), Uniforms::state(program))) {}
+          uniformsState(Uniforms::state(program)) {}
+
+    optional<std::pair<BinaryProgramFormat, std::string>> getBinaryProgram(const Context& context) const {
+        return context.getBinaryProgram(program);
+    }
 
     template <class DrawMode>
     void draw(Context& context,
@@ -49,7 +61,7 @@ public:
 
         context.program = program;
 
-        Uniforms::bind(uniformsState, std::move(uniformValues));
+        context.uniformCounts.record(Uniforms::count, Uniforms::bind(uniformsState, std::move(uniformValues)));
 
         for (const auto& segment : segments) {
             segment.bind(context,
@@ -58,14 +70,57 @@ public:
                          attributeBindings);
 
             context.draw(drawMode.primitiveType,
-                         segment.indexOffset,
+                         indexBuffer.indexType,
+                         indexBuffer.indexOffset + segment.indexOffset,
                          segment.indexLength);
         }
     }
 
+    // Draws `instanceCount` instances of each segment. Bindings that advance per instance
+    // must have been made with `Attributes::perInstance`.
+    template <class DrawMode>
+    void drawInstanced(Context& context,
+                       DrawMode drawMode,
+                       DepthMode depthMode,
+                       StencilMode stencilMode,
+                       ColorMode colorMode,
+                       UniformValues&& uniformValues,
+                       AttributeBindings&& attributeBindings,
+                       const IndexBuffer<DrawMode>& indexBuffer,
+                       const SegmentVector<Attributes>& segments,
+                       std::size_t instanceCount) {
+        static_assert(std::is_same<Primitive, typename DrawMode::Primitive>::value, "incompatible draw mode");
+
+        context.setDrawMode(drawMode);
+        context.setDepthMode(depthMode);
+        context.setStencilMode(stencilMode);
+        context.setColorMode(colorMode);
+
+        context.program = program;
+
+        context.uniformCounts.record(Uniforms::count, Uniforms::bind(uniformsState, std::move(uniformValues)));
+
+        for (const auto& segment : segments) {
+            segment.bind(context,
+                         indexBuffer.buffer,
+                         attributeLocations,
+                         attributeBindings);
+
+            context.drawInstanced(drawMode.primitiveType,
+                                  indexBuffer.indexType,
+                                  indexBuffer.indexOffset + segment.indexOffset,
+                                  segment.indexLength,
+                                  instanceCount);
+        }
+    }
+
 private:
-    UniqueShader vertexShader;
-    UniqueShader fragmentShader;
+    // The shaders are only needed until the program is linked.
+    Program(Context& context, UniqueShader&& vertexShader, UniqueShader&& fragmentShader)
+        : program(context.createProgram(vertexShader, fragmentShader)),
+          attributeLocations(Attributes::locations(program)),
+          uniformsState((context.linkProgram(program), Uniforms::state(program))) {}
+
     UniqueProgram program;
 
     typename Attributes::Locations attributeLocations;
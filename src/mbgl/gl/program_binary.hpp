@@ -0,0 +1,18 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+
+// Same value in GL_OES_get_program_binary and GL_ARB_get_program_binary.
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+
+namespace mbgl {
+namespace gl {
+
+extern ExtensionFunction<void(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, GLvoid* binary)> GetProgramBinary;
+extern ExtensionFunction<void(GLuint program, GLenum binaryFormat, const GLvoid* binary, GLint length)> ProgramBinary;
+
+} // namespace gl
+} // namespace mbgl
@@ -36,7 +36,7 @@ public:
               const typename Attributes::Bindings& attributeBindings_) const {
         if (context.supportsVertexArrays()) {
             if (!vao) {
-                vao = context.createVertexArray();
+                vao = context.createVertexArray(Attributes::Count);
                 context.vertexBuffer.setDirty();
             }
             context.vertexArrayObject = *vao;
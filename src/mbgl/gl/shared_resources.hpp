@@ -0,0 +1,54 @@
+#pragma once
+
+#include <mbgl/gl/types.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+namespace gl {
+
+class Context;
+
+namespace detail {
+struct ProgramDeleter;
+} // namespace detail
+
+// What the contexts of one GL share group have in common: objects registered by any of them,
+// and the program objects they abandoned, which any of them may delete. A context that doesn't
+// share with others has one of its own; see `Context::shareWith`.
+class SharedResources : private util::noncopyable {
+public:
+    // Returns the object registered under `key`, or registers the one returned by `create`.
+    // Objects stay registered for as long as anyone holds them.
+    template <class T, class Fn>
+    std::shared_ptr<T> get(const std::string& key, Fn&& create) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = resources.begin(); it != resources.end();) {
+            it = it->second.expired() ? resources.erase(it) : std::next(it);
+        }
+
+        std::weak_ptr<void>& entry = resources[key];
+        if (auto existing = entry.lock()) {
+            return std::static_pointer_cast<T>(existing);
+        }
+        std::shared_ptr<T> created = create();
+        entry = created;
+        return created;
+    }
+
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, std::weak_ptr<void>> resources;
+    std::vector<ProgramID> abandonedPrograms;
+
+    friend Context;
+    friend detail::ProgramDeleter;
+};
+
+} // namespace gl
+} // namespace mbgl
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 namespace mbgl {
 namespace gl {
 
@@ -12,13 +14,24 @@ namespace gl {
 //     static void Set(const Type& value);
 //     static Type Get();
 // };
+//
+// When given a counter, it counts the calls that actually changed the state.
 template <typename T>
 class State {
 public:
+    State() = default;
+
+    explicit State(std::size_t& changes_)
+        : changes(&changes_) {
+    }
+
     void operator=(const typename T::Type& value) {
         if (*this != value) {
             setCurrentValue(value);
             T::Set(currentValue);
+            if (changes) {
+                (*changes)++;
+            }
         }
     }
 
@@ -52,6 +65,7 @@ public:
 private:
     typename T::Type currentValue = T::Default;
     bool dirty = true;
+    std::size_t* changes = nullptr;
 };
 
 // Helper struct that stores the current state and restores it upon destruction. You should not use
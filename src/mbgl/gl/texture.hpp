@@ -3,6 +3,8 @@
 #include <mbgl/gl/object.hpp>
 #include <mbgl/util/size.hpp>
 
+#include <array>
+
 namespace mbgl {
 namespace gl {
 
@@ -16,5 +18,19 @@ public:
     TextureWrap wrapY = TextureWrap::Clamp;
 };
 
+// An image in a slot of a texture it shares with other images of its size; see
+// `Context::createSharedTexture`. The slot is freed when this is destroyed.
+class SharedTexture {
+public:
+    Size size;
+    // The ID of the shared texture.
+    UniqueTexture texture;
+    // Maps texture coordinates of the image to those of the shared texture, from the center
+    // of its first texel to that of its last, so that linear filtering doesn't reach into
+    // the neighbouring slots.
+    std::array<float, 2> offset;
+    std::array<float, 2> scale;
+};
+
 } // namespace gl
 } // namespace mbgl
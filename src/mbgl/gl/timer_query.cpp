@@ -0,0 +1,34 @@
+#include <mbgl/gl/timer_query.hpp>
+
+namespace mbgl {
+namespace gl {
+
+ExtensionFunction<void(GLsizei n, GLuint* ids)>
+    GenQueries({ { "GL_EXT_disjoint_timer_query", "glGenQueriesEXT" },
+                 { "GL_ARB_timer_query", "glGenQueries" } });
+
+ExtensionFunction<void(GLsizei n, const GLuint* ids)>
+    DeleteQueries({ { "GL_EXT_disjoint_timer_query", "glDeleteQueriesEXT" },
+                    { "GL_ARB_timer_query", "glDeleteQueries" } });
+
+ExtensionFunction<void(GLenum target, GLuint id)>
+    BeginQuery({ { "GL_EXT_disjoint_timer_query", "glBeginQueryEXT" },
+                 { "GL_ARB_timer_query", "glBeginQuery" } });
+
+ExtensionFunction<void(GLenum target)>
+    EndQuery({ { "GL_EXT_disjoint_timer_query", "glEndQueryEXT" },
+               { "GL_ARB_timer_query", "glEndQuery" } });
+
+ExtensionFunction<void(GLuint id, GLenum pname, GLuint* params)>
+    GetQueryObjectuiv({ { "GL_EXT_disjoint_timer_query", "glGetQueryObjectuivEXT" },
+                        { "GL_ARB_timer_query", "glGetQueryObjectuiv" } });
+
+ExtensionFunction<void(GLuint id, GLenum pname, uint64_t* params)>
+    GetQueryObjectui64v({ { "GL_EXT_disjoint_timer_query", "glGetQueryObjectui64vEXT" },
+                          { "GL_ARB_timer_query", "glGetQueryObjectui64v" } });
+
+ExtensionFunction<void(GLenum pname, int64_t* data)>
+    GetInteger64vDisjoint({ { "GL_EXT_disjoint_timer_query", "glGetInteger64vEXT" } });
+
+} // namespace gl
+} // namespace mbgl
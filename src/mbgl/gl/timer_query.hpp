@@ -0,0 +1,37 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+
+#include <cstdint>
+
+// Same values in GL_EXT_disjoint_timer_query and GL_ARB_timer_query.
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+#ifndef GL_GPU_DISJOINT_EXT
+#define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+
+namespace mbgl {
+namespace gl {
+
+extern ExtensionFunction<void(GLsizei n, GLuint* ids)> GenQueries;
+extern ExtensionFunction<void(GLsizei n, const GLuint* ids)> DeleteQueries;
+extern ExtensionFunction<void(GLenum target, GLuint id)> BeginQuery;
+extern ExtensionFunction<void(GLenum target)> EndQuery;
+extern ExtensionFunction<void(GLuint id, GLenum pname, GLuint* params)> GetQueryObjectuiv;
+extern ExtensionFunction<void(GLuint id, GLenum pname, uint64_t* params)> GetQueryObjectui64v;
+
+// Only GL_EXT_disjoint_timer_query has it; GL_GPU_DISJOINT_EXT can only be queried if it is
+// available.
+extern ExtensionFunction<void(GLenum pname, int64_t* data)> GetInteger64vDisjoint;
+
+} // namespace gl
+} // namespace mbgl
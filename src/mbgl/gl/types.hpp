@@ -14,6 +14,8 @@ using TextureID = uint32_t;
 using VertexArrayID = uint32_t;
 using FramebufferID = uint32_t;
 using RenderbufferID = uint32_t;
+using QueryID = uint32_t;
+using BinaryProgramFormat = uint32_t;
 
 using AttributeLocation = int32_t;
 using UniformLocation = int32_t;
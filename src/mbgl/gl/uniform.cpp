@@ -51,6 +51,15 @@ void bindUniform<std::array<double, 16>>(UniformLocation location, const std::ar
     MBGL_CHECK_ERROR(glUniformMatrix4fv(location, 1, GL_FALSE, util::convert<float>(t).data()));
 }
 
+template <>
+void bindUniform<std::vector<std::array<double, 16>>>(UniformLocation location, const std::vector<std::array<double, 16>>& t) {
+    std::vector<float> values;
+    values.reserve(t.size() * 16);
+    for (const auto& matrix : t) {
+        values.insert(values.end(), matrix.begin(), matrix.end());
+    }
+    MBGL_CHECK_ERROR(glUniformMatrix4fv(location, t.size(), GL_FALSE, values.data()));
+}
 
 template <>
 void bindUniform<bool>(UniformLocation location, const bool& t) {
@@ -6,7 +6,9 @@
 #include <mbgl/util/indexed_tuple.hpp>
 
 #include <array>
+#include <cstddef>
 #include <functional>
+#include <vector>
 
 namespace mbgl {
 namespace gl {
@@ -26,13 +28,19 @@ class Uniform {
 public:
     using Value = UniformValue<Tag, T>;
 
+    // Remembers the value last bound to the program, so that draws only bind values that
+    // changed. Any `T` with `!=` can be compared this way, including matrices, colors and
+    // arrays of them.
     class State {
     public:
-        void operator=(const Value& value) {
+        // Returns whether the value differed and was bound.
+        bool assign(const Value& value) {
             if (!current || *current != value.t) {
                 current = value.t;
                 bindUniform(location, value.t);
+                return true;
             }
+            return false;
         }
 
         UniformLocation location;
@@ -49,6 +57,11 @@ using UniformVector = Uniform<Tag, std::array<T, N>>;
 template <class Tag, class T, size_t N>
 using UniformMatrix = Uniform<Tag, std::array<T, N*N>>;
 
+// An array of uniforms, bound all at once. Its location is that of the first element; the
+// shader may declare more elements than are bound.
+template <class Tag, class T>
+using UniformArray = Uniform<Tag, std::vector<T>>;
+
 #define MBGL_DEFINE_UNIFORM_SCALAR(type_, name_) \
     struct name_ : ::mbgl::gl::UniformScalar<name_, type_> { static auto name() { return #name_; } }
 
@@ -58,6 +71,9 @@ using UniformMatrix = Uniform<Tag, std::array<T, N*N>>;
 #define MBGL_DEFINE_UNIFORM_MATRIX(type_, n_, name_) \
     struct name_ : ::mbgl::gl::UniformMatrix<name_, type_, n_> { static auto name() { return #name_; } }
 
+#define MBGL_DEFINE_UNIFORM_MATRIX_ARRAY(type_, n_, name_) \
+    struct name_ : ::mbgl::gl::UniformArray<name_, std::array<type_, n_*n_>> { static auto name() { return #name_; } }
+
 UniformLocation uniformLocation(ProgramID, const char * name);
 
 template <class... Us>
@@ -71,11 +87,29 @@ public:
         return State { { uniformLocation(id, Us::name()) }... };
     }
 
-    static void bind(State& state, Values&& values) {
-        util::ignore({ (state.template get<Us>() = values.template get<Us>(), 0)... });
+    static constexpr std::size_t count = sizeof...(Us);
+
+    // Returns the number of values that were bound; the others were unchanged.
+    static std::size_t bind(State& state, Values&& values) {
+        std::size_t bound = 0;
+        util::ignore({ (bound += state.template get<Us>().assign(values.template get<Us>()), 0)... });
+        return bound;
     }
 };
 
+// How many uniform values draws have bound, and how many they skipped because the program
+// already had them.
+class UniformCounts {
+public:
+    void record(std::size_t total, std::size_t changed) {
+        bound += changed;
+        skipped += total - changed;
+    }
+
+    std::size_t bound = 0;
+    std::size_t skipped = 0;
+};
+
 
 namespace detail {
 
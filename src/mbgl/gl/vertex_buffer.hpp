@@ -5,6 +5,8 @@
 #include <mbgl/gl/draw_mode.hpp>
 #include <mbgl/util/ignore.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
 
 namespace mbgl {
@@ -25,6 +27,38 @@ public:
     std::size_t vertexSize() const { return v.size(); }
     std::size_t byteSize() const { return v.size() * sizeof(Vertex); }
 
+    // Makes room for `n` more vertices. Capacity grows at least geometrically, so that
+    // reserving ahead of each of many small batches doesn't reallocate for every one.
+    void reserveAdditional(std::size_t n) {
+        if (v.size() + n > v.capacity()) {
+            v.reserve(std::max(v.size() + n, v.capacity() * 2));
+        }
+    }
+
+    // Appends copies of `vertex` until there are `n` vertices.
+    void extend(std::size_t n, const Vertex& vertex) {
+        static_assert(groupSize == 1, "extending by single vertices");
+        if (n > v.size()) {
+            v.insert(v.end(), n - v.size(), vertex);
+        }
+    }
+
+    // Replaces every vertex with `n` consecutive copies of it.
+    void repeatEach(std::size_t n) {
+        std::vector<Vertex> repeated;
+        repeated.reserve(v.size() * n);
+        for (const auto& vertex : v) {
+            repeated.insert(repeated.end(), n, vertex);
+        }
+        v = std::move(repeated);
+    }
+
+    // Replaces the vertices, e.g. with those of a bucket read from a `LayoutCache`.
+    void assign(std::vector<Vertex> vertices) {
+        assert(vertices.size() % groupSize == 0);
+        v = std::move(vertices);
+    }
+
     bool empty() const { return v.empty(); }
     const Vertex* data() const { return v.data(); }
 
@@ -40,6 +74,9 @@ public:
 
     std::size_t vertexCount;
     UniqueBuffer buffer;
+
+    // Where the vertices start in `buffer`, which may hold other data too.
+    std::size_t byteOffset;
 };
 
 } // namespace gl
@@ -1,59 +1,144 @@
 #include <mbgl/layout/merge_lines.hpp>
 #include <mbgl/layout/symbol_feature.hpp>
 
-#include <boost/functional/hash.hpp>
+#include <cassert>
+#include <cstdint>
+#include <limits>
 
 namespace mbgl {
 namespace util {
 
-// Map of key -> index into features
-using Index = std::unordered_map<size_t, size_t>;
-
-size_t mergeFromRight(std::vector<SymbolFeature>& features,
-                      Index& rightIndex,
-                      Index::iterator left,
-                      size_t rightKey,
-                      GeometryCollection& geom) {
-
-    const size_t index = left->second;
-    rightIndex.erase(left);
-    rightIndex[rightKey] = index;
-    features[index].geometry[0].pop_back();
-    features[index].geometry[0].insert(
-        features[index].geometry[0].end(), geom[0].begin(), geom[0].end());
-    geom[0].clear();
-    return index;
-}
+namespace {
+
+constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
 
-size_t mergeFromLeft(std::vector<SymbolFeature>& features,
-                     Index& leftIndex,
-                     Index::iterator right,
-                     size_t leftKey,
-                     GeometryCollection& geom) {
-
-    const size_t index = right->second;
-    leftIndex.erase(right);
-    leftIndex[leftKey] = index;
-    geom[0].pop_back();
-    geom[0].insert(
-        geom[0].end(), features[index].geometry[0].begin(), features[index].geometry[0].end());
-    features[index].geometry[0].clear();
-    std::swap(features[index].geometry[0], geom[0]);
-    return index;
+std::size_t tableSize(std::size_t entries) {
+    // A power of two, at most half full.
+    std::size_t size = 16;
+    while (size < 2 * entries) {
+        size *= 2;
+    }
+    return size;
 }
 
-size_t getKey(const std::u16string& text, const GeometryCoordinate& coord) {
-    auto hash = std::hash<std::u16string>()(text);
-    boost::hash_combine(hash, coord.x);
-    boost::hash_combine(hash, coord.y);
+uint64_t mix(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
     return hash;
 }
 
+// Assigns the same ID, the index of its first feature, to every feature with a given label.
+class TextIDs {
+public:
+    explicit TextIDs(std::size_t features)
+        : slots(tableSize(features), none),
+          mask(slots.size() - 1) {
+    }
+
+    uint32_t get(const std::vector<SymbolFeature>& features, uint32_t index) {
+        const std::u16string& text = *features[index].text;
+        for (std::size_t i = std::hash<std::u16string>()(text) & mask;; i = (i + 1) & mask) {
+            if (slots[i] == none) {
+                slots[i] = index;
+                return index;
+            }
+            if (*features[slots[i]].text == text) {
+                return slots[i];
+            }
+        }
+    }
+
+private:
+    std::vector<uint32_t> slots;
+    const std::size_t mask;
+};
+
+// An open addressing map from a label and an end point of its line to a chain of lines.
+// Entries are never rehashed: the table is sized for every insertion a merge can make.
+class EndIndex {
+public:
+    explicit EndIndex(std::size_t insertions)
+        : slots(tableSize(insertions)),
+          mask(slots.size() - 1) {
+    }
+
+    static uint64_t key(uint32_t text, const GeometryCoordinate& point) {
+        return uint64_t(text) << 32 | uint64_t(uint16_t(point.x)) << 16 | uint16_t(point.y);
+    }
+
+    uint32_t find(uint64_t key) const {
+        for (std::size_t i = mix(key) & mask;; i = (i + 1) & mask) {
+            if (slots[i].value == none) {
+                return none;
+            }
+            if (slots[i].value != removed && slots[i].key == key) {
+                return slots[i].value;
+            }
+        }
+    }
+
+    void set(uint64_t key, uint32_t value) {
+        std::size_t free = slots.size();
+        for (std::size_t i = mix(key) & mask;; i = (i + 1) & mask) {
+            if (slots[i].value == none) {
+                slots[free < slots.size() ? free : i] = { key, value };
+                return;
+            }
+            if (slots[i].value == removed) {
+                if (free == slots.size()) {
+                    free = i;
+                }
+            } else if (slots[i].key == key) {
+                slots[i].value = value;
+                return;
+            }
+        }
+    }
+
+    void erase(uint64_t key) {
+        for (std::size_t i = mix(key) & mask;; i = (i + 1) & mask) {
+            if (slots[i].value == none) {
+                return;
+            }
+            if (slots[i].value != removed && slots[i].key == key) {
+                slots[i].value = removed;
+                return;
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t removed = none - 1;
+
+    struct Slot {
+        uint64_t key = 0;
+        uint32_t value = none;
+    };
+
+    std::vector<Slot> slots;
+    const std::size_t mask;
+};
+
+} // namespace
+
 void mergeLines(std::vector<SymbolFeature>& features) {
-    Index leftIndex;
-    Index rightIndex;
+    assert(features.size() < std::numeric_limits<uint32_t>::max() - 1);
+    const uint32_t count = features.size();
+
+    // First, the lines to merge are linked into chains, without touching their geometry.
+    // Each chain is held by one of its lines, which receives the merged geometry.
+    std::vector<uint32_t> next(count, none);
+    std::vector<uint32_t> head(count, none);
+    std::vector<uint32_t> tail(count, none);
+
+    TextIDs textIDs { count };
 
-    for (size_t k = 0; k < features.size(); k++) {
+    // Each line adds at most one entry to each index.
+    EndIndex leftIndex { count };
+    EndIndex rightIndex { count };
+
+    for (uint32_t k = 0; k < count; k++) {
         SymbolFeature& feature = features[k];
         GeometryCollection& geometry = feature.geometry;
 
@@ -61,35 +146,71 @@ void mergeLines(std::vector<SymbolFeature>& features) {
             continue;
         }
 
-        const size_t leftKey = getKey(*feature.text, geometry[0].front());
-        const size_t rightKey = getKey(*feature.text, geometry[0].back());
+        const uint32_t text = textIDs.get(features, k);
+        const uint64_t leftKey = EndIndex::key(text, geometry[0].front());
+        const uint64_t rightKey = EndIndex::key(text, geometry[0].back());
 
-        const auto left = rightIndex.find(leftKey);
-        const auto right = leftIndex.find(rightKey);
+        // The chains ending where this line starts, and starting where it ends.
+        const uint32_t left = rightIndex.find(leftKey);
+        const uint32_t right = leftIndex.find(rightKey);
 
-        if (left != rightIndex.end() && right != leftIndex.end() && left->second != right->second) {
+        if (left != none && right != none && left != right) {
             // found lines with the same text adjacent to both ends of the current line, merge all
             // three
-            size_t j = mergeFromLeft(features, leftIndex, right, leftKey, geometry);
-            size_t i = mergeFromRight(features, rightIndex, left, rightKey, features[j].geometry);
+            next[tail[left]] = k;
+            next[k] = head[right];
+            tail[left] = tail[right];
+            head[right] = none;
 
-            leftIndex.erase(leftKey);
-            rightIndex.erase(rightKey);
-            rightIndex[getKey(*feature.text, features[i].geometry[0].back())] = i;
+            leftIndex.erase(rightKey);
+            rightIndex.erase(leftKey);
+            rightIndex.set(EndIndex::key(text, features[tail[left]].geometry[0].back()), left);
 
-        } else if (left != rightIndex.end()) {
+        } else if (left != none) {
             // found mergeable line adjacent to the start of the current line, merge
-            mergeFromRight(features, rightIndex, left, rightKey, geometry);
+            next[tail[left]] = k;
+            tail[left] = k;
+
+            rightIndex.erase(leftKey);
+            rightIndex.set(rightKey, left);
 
-        } else if (right != leftIndex.end()) {
+        } else if (right != none) {
             // found mergeable line adjacent to the end of the current line, merge
-            mergeFromLeft(features, leftIndex, right, leftKey, geometry);
+            next[k] = head[right];
+            head[right] = k;
+
+            leftIndex.erase(rightKey);
+            leftIndex.set(leftKey, right);
 
         } else {
             // no adjacent lines, add as a new item
-            leftIndex[leftKey] = k;
-            rightIndex[rightKey] = k;
+            head[k] = k;
+            tail[k] = k;
+            leftIndex.set(leftKey, k);
+            rightIndex.set(rightKey, k);
+        }
+    }
+
+    // Then the geometry of each chain is spliced into its holder, with a single allocation.
+    // Adjacent lines share their end points, which are only kept once.
+    for (uint32_t k = 0; k < count; k++) {
+        if (head[k] == none || (head[k] == k && next[k] == none)) {
+            continue;
+        }
+
+        std::size_t size = 1;
+        for (uint32_t i = head[k]; i != none; i = next[i]) {
+            size += features[i].geometry[0].size() - 1;
+        }
+
+        GeometryCoordinates line;
+        line.reserve(size);
+        for (uint32_t i = head[k]; i != none; i = next[i]) {
+            GeometryCoordinates& segment = features[i].geometry[0];
+            line.insert(line.end(), segment.begin() + (line.empty() ? 0 : 1), segment.end());
+            segment.clear();
         }
+        features[k].geometry[0] = std::move(line);
     }
 }
 
@@ -2,8 +2,6 @@
 
 #include <mbgl/tile/geometry_tile_data.hpp>
 
-#include <unordered_map>
-#include <string>
 #include <vector>
 
 namespace mbgl {
@@ -12,18 +10,9 @@ class SymbolFeature;
 
 namespace util {
 
-unsigned int mergeFromRight(std::vector<SymbolFeature> &features,
-                            std::unordered_map<std::string, unsigned int> &rightIndex,
-                            std::unordered_map<std::string, unsigned int>::iterator left,
-                            std::string &rightKey,
-                            GeometryCollection &geom);
-
-unsigned int mergeFromLeft(std::vector<SymbolFeature> &features,
-                           std::unordered_map<std::string, unsigned int> &leftIndex,
-                           std::string &leftKey,
-                           std::unordered_map<std::string, unsigned int>::iterator right,
-                           GeometryCollection &geom);
-
+// Joins lines with the same text that share end points, such as the segments of a road, so
+// that their labels can be placed along the whole line. The merged geometry ends up in one of
+// the features, and the first line of the others is left empty.
 void mergeLines(std::vector<SymbolFeature> &features);
 
 } // end namespace util
@@ -17,6 +17,7 @@ public:
     
     FeatureType getType() const override { return feature->getType(); }
     optional<Value> getValue(const std::string& key) const override { return feature->getValue(key); };
+    const Value* findValue(const std::string& key, optional<Value>& storage) const override { return feature->findValue(key, storage); };
     std::unordered_map<std::string,Value> getProperties() const override { return feature->getProperties(); };
     optional<FeatureIdentifier> getID() const override { return feature->getID(); };
     GeometryCollection getGeometries() const override { return geometry; };
@@ -2,13 +2,14 @@
 #include <mbgl/layout/merge_lines.hpp>
 #include <mbgl/layout/clip_lines.hpp>
 #include <mbgl/renderer/symbol_bucket.hpp>
-#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/bucket_parameters.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/get_anchors.hpp>
+#include <mbgl/text/line_measurements.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/util/constants.hpp>
@@ -18,6 +19,7 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/i18n.hpp>
+#include <mbgl/util/interned_string.hpp>
 #include <mbgl/math/clamp.hpp>
 #include <mbgl/math/minmax.hpp>
 #include <mbgl/math/log2.hpp>
@@ -26,6 +28,8 @@
 
 #include <mapbox/polylabel.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 using namespace style;
@@ -36,9 +40,12 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
                            SpriteAtlas& spriteAtlas_)
     : sourceLayerName(sourceLayer.getName()),
       bucketName(layers.at(0)->getID()),
+      sourceLayerID(util::internString(sourceLayerName)),
+      bucketID(util::internString(bucketName)),
       overscaling(parameters.tileID.overscaleFactor()),
       zoom(parameters.tileID.overscaledZ),
       mode(parameters.mode),
+      obsolete(parameters.obsolete),
       spriteAtlas(spriteAtlas_),
       tileSize(util::tileSize * overscaling),
       tilePixelRatio(float(util::EXTENT) / tileSize) {
@@ -93,11 +100,27 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
         ));
     }
 
+    // Constant text fields and icon images are split into their tokens once for all features.
+    optional<util::TokenString> textField;
+    if (layout.get<TextField>().isConstant()) {
+        textField.emplace(*layout.get<TextField>().constant());
+    }
+    const util::TokenString iconImage { layout.get<IconImage>() };
+
+    // Features often share their text, such as the pieces of a street: each distinct text is
+    // transformed and shaped once per transform, and its glyph ranges collected once.
+    std::unordered_map<std::string, std::u16string> texts[3];
+
     // Determine and load glyph ranges
+    const CompiledFilter filter(leader.filter);
     const size_t featureCount = sourceLayer.featureCount();
     for (size_t i = 0; i < featureCount; ++i) {
+        if (obsolete) {
+            return;
+        }
+
         auto feature = sourceLayer.getFeature(i);
-        if (!leader.filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); }))
+        if (!filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); }))
             continue;
         
         SymbolFeature ft(std::move(feature));
@@ -122,32 +145,39 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
         };
         
         if (hasText) {
-            std::string u8string = layout.evaluate<TextField>(zoom, ft);
-            if (layout.get<TextField>().isConstant()) {
-                u8string = util::replaceTokens(u8string, getValue);
-            }
-            
+            std::string u8string = textField
+                ? textField->replace(getValue)
+                : layout.evaluate<TextField>(zoom, ft);
+
             auto textTransform = layout.evaluate<TextTransform>(zoom, ft);
 
-            if (textTransform == TextTransformType::Uppercase) {
-                u8string = platform::uppercase(u8string);
-            } else if (textTransform == TextTransformType::Lowercase) {
-                u8string = platform::lowercase(u8string);
-            }
+            auto& transformed = texts[static_cast<uint8_t>(textTransform)];
+            auto it = transformed.find(u8string);
+            if (it == transformed.end()) {
+                std::string transformedString = u8string;
+                if (textTransform == TextTransformType::Uppercase) {
+                    transformedString = platform::uppercase(transformedString);
+                } else if (textTransform == TextTransformType::Lowercase) {
+                    transformedString = platform::lowercase(transformedString);
+                }
 
-            ft.text = applyArabicShaping(util::utf8_to_utf16::convert(u8string));
+                it = transformed.emplace(std::move(u8string),
+                    applyArabicShaping(util::utf8_to_utf16::convert(transformedString))).first;
 
-            // Loop through all characters of this text and collect unique codepoints.
-            for (char16_t chr : *ft.text) {
-                ranges.insert(getGlyphRange(chr));
-                if (char16_t verticalChr = util::i18n::verticalizePunctuation(chr)) {
-                    ranges.insert(getGlyphRange(verticalChr));
+                // Loop through all characters of this text and collect unique codepoints.
+                for (char16_t chr : it->second) {
+                    ranges.insert(getGlyphRange(chr));
+                    if (char16_t verticalChr = util::i18n::verticalizePunctuation(chr)) {
+                        ranges.insert(getGlyphRange(verticalChr));
+                    }
                 }
             }
+
+            ft.text = it->second;
         }
 
         if (hasIcon) {
-            ft.icon = util::replaceTokens(layout.get<IconImage>(), getValue);
+            ft.icon = iconImage.replace(getValue);
         }
 
         if (ft.text || ft.icon) {
@@ -157,6 +187,74 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
 
     if (layout.get<SymbolPlacement>() == SymbolPlacementType::Line) {
         util::mergeLines(features);
+    } else if (!mayOverlap()) {
+        removeHiddenDuplicates();
+    }
+}
+
+// A point symbol with the same text and icon, at the same anchor, as one before it in the layer
+// has the same collision boxes. It collides with that symbol at every scale, angle and pitch,
+// and with everything that symbol collides with. So it can't be placed, whether that symbol is
+// placed or not, and is dropped here rather than shaped and placed for nothing. Where
+// label density is extreme, many features are such duplicates.
+void SymbolLayout::removeHiddenDuplicates() {
+    struct Candidate {
+        const SymbolFeature* feature;
+        std::array<float, 2> iconOffset;
+        float iconRotate;
+    };
+
+    // The candidates kept so far, by anchor.
+    std::unordered_map<uint32_t, std::vector<Candidate>> anchors;
+
+    for (auto& feature : features) {
+        if (obsolete) {
+            return;
+        }
+
+        if (feature.getType() != FeatureType::Point) {
+            continue;
+        }
+
+        Candidate candidate { &feature, {{ 0, 0 }}, 0 };
+        if (feature.icon) {
+            candidate.iconOffset = layout.evaluate<IconOffset>(zoom, feature);
+            candidate.iconRotate = layout.evaluate<IconRotate>(zoom, feature);
+        }
+
+        for (auto& points : feature.geometry) {
+            GeometryCoordinates kept;
+            for (const auto& point : points) {
+                auto& others = anchors[uint32_t(uint16_t(point.x)) << 16 | uint16_t(point.y)];
+                const bool hidden = std::any_of(others.begin(), others.end(), [&] (const Candidate& other) {
+                    return other.feature->text == feature.text &&
+                           other.feature->icon == feature.icon &&
+                           other.iconOffset == candidate.iconOffset &&
+                           other.iconRotate == candidate.iconRotate;
+                });
+                if (!hidden) {
+                    others.push_back(candidate);
+                    kept.push_back(point);
+                }
+            }
+            points = std::move(kept);
+        }
+
+        feature.geometry.erase(std::remove_if(feature.geometry.begin(), feature.geometry.end(),
+                                              [] (const auto& points) { return points.empty(); }),
+                               feature.geometry.end());
+    }
+}
+
+void SymbolLayout::updatePaintProperties(const std::vector<const Layer*>& layers) {
+    for (const auto& layer : layers) {
+        auto it = layerPaintProperties.find(layer->getID());
+        if (it != layerPaintProperties.end()) {
+            it->second = std::make_pair(
+                layer->as<SymbolLayer>()->impl->iconPaintProperties(),
+                layer->as<SymbolLayer>()->impl->textPaintProperties()
+            );
+        }
     }
 }
 
@@ -182,7 +280,8 @@ bool SymbolLayout::canPrepare(GlyphAtlas& glyphAtlas) {
 }
 
 void SymbolLayout::prepare(uintptr_t tileUID,
-                           GlyphAtlas& glyphAtlas) {
+                           GlyphAtlas& glyphAtlas,
+                           LineMeasurementCache& lineMeasurements) {
     float horizontalAlign = 0.5;
     float verticalAlign = 0.5;
 
@@ -225,11 +324,16 @@ void SymbolLayout::prepare(uintptr_t tileUID,
         0.5;
 
     auto glyphSet = glyphAtlas.getGlyphSet(layout.get<TextFont>());
+    ShapingCache& shapingCache = glyphAtlas.getShapingCache();
 
     const bool textAlongLine = layout.get<TextRotationAlignment>() == AlignmentType::Map &&
         layout.get<SymbolPlacement>() == SymbolPlacementType::Line;
 
     for (auto it = features.begin(); it != features.end(); ++it) {
+        if (obsolete) {
+            return;
+        }
+
         auto& feature = *it;
         if (feature.geometry.empty()) continue;
 
@@ -241,8 +345,9 @@ void SymbolLayout::prepare(uintptr_t tileUID,
         if (feature.text) {
             auto getShaping = [&] (const std::u16string& text, WritingModeType writingMode) {
                 const float oneEm = 24.0f;
-                const Shaping result = glyphSet->getShaping(
-                    /* string */ text,
+                ShapingCache::Key key {
+                    /* text */ text,
+                    /* fontStack */ layout.get<TextFont>(),
                     /* maxWidth: ems */ layout.get<SymbolPlacement>() != SymbolPlacementType::Line ?
                         layout.get<TextMaxWidth>() * oneEm : 0,
                     /* lineHeight: ems */ layout.get<TextLineHeight>() * oneEm,
@@ -252,15 +357,24 @@ void SymbolLayout::prepare(uintptr_t tileUID,
                     /* spacing: ems */ layout.get<TextLetterSpacing>() * oneEm,
                     /* translate */ Point<float>(layout.get<TextOffset>()[0], layout.get<TextOffset>()[1]),
                     /* verticalHeight */ oneEm,
-                    /* writingMode */ writingMode,
-                    /* bidirectional algorithm object */ bidi);
+                    /* writingMode */ writingMode
+                };
+
+                optional<Shaping> result = shapingCache.get(key);
+                if (!result) {
+                    result = glyphSet->getShaping(key.text, key.maxWidth, key.lineHeight,
+                                                  key.horizontalAlign, key.verticalAlign, key.justify,
+                                                  key.spacing, key.translate, key.verticalHeight,
+                                                  key.writingMode, bidi);
+                    shapingCache.put(key, *result);
+                }
 
                 // Add the glyphs we need for this label to the glyph atlas.
-                if (result) {
+                if (*result) {
                     glyphAtlas.addGlyphs(tileUID, text, layout.get<TextFont>(), glyphSet, face);
                 }
 
-                return result;
+                return std::move(*result);
             };
 
             shapedTextOrientations.first = getShaping(*feature.text, WritingModeType::Horizontal);
@@ -291,7 +405,7 @@ void SymbolLayout::prepare(uintptr_t tileUID,
 
         // if either shapedText or icon position is present, add the feature
         if (shapedTextOrientations.first || shapedIcon) {
-            addFeature(std::distance(features.begin(), it), feature, shapedTextOrientations, shapedIcon, face);
+            addFeature(std::distance(features.begin(), it), feature, shapedTextOrientations, shapedIcon, face, lineMeasurements);
         }
         
         feature.geometry.clear();
@@ -304,7 +418,8 @@ void SymbolLayout::addFeature(const std::size_t index,
                               const SymbolFeature& feature,
                               const std::pair<Shaping, Shaping>& shapedTextOrientations,
                               const PositionedIcon& shapedIcon,
-                              const GlyphPositions& face) {
+                              const GlyphPositions& face,
+                              LineMeasurementCache& lineMeasurements) {
     const float minScale = 0.5f;
     const float glyphSize = 24.0f;
 
@@ -324,7 +439,7 @@ void SymbolLayout::addFeature(const std::size_t index,
                                                   ? SymbolPlacementType::Point
                                                   : layout.get<SymbolPlacement>();
     const float textRepeatDistance = symbolSpacing / 2;
-    IndexedSubfeature indexedFeature = {feature.index, sourceLayerName, bucketName, symbolInstances.size()};
+    IndexedSubfeature indexedFeature = {feature.index, sourceLayerID, bucketID, symbolInstances.size()};
 
     auto addSymbolInstance = [&] (const GeometryCoordinates& line, Anchor& anchor) {
         // https://github.com/mapbox/vector-tile-spec/tree/master/2.1#41-layers
@@ -359,6 +474,7 @@ void SymbolLayout::addFeature(const std::size_t index,
         auto clippedLines = util::clipLines(feature.geometry, 0, 0, util::EXTENT, util::EXTENT);
         for (const auto& line : clippedLines) {
             Anchors anchors = getAnchors(line,
+                                         lineMeasurements.get(line),
                                          symbolSpacing,
                                          textMaxAngle,
                                          (shapedTextOrientations.second ?: shapedTextOrientations.first).left,
@@ -421,29 +537,19 @@ bool SymbolLayout::anchorIsTooClose(const std::u16string& text, const float repe
     return false;
 }
 
-std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile) {
-    auto bucket = std::make_unique<SymbolBucket>(layout, layerPaintProperties, zoom, sdfIcons, iconsNeedLinear);
-
-    // Calculate which labels can be shown and when they can be shown and
-    // create the bufers used for rendering.
-
-    const SymbolPlacementType textPlacement = layout.get<TextRotationAlignment>() != AlignmentType::Map
-                                                  ? SymbolPlacementType::Point
-                                                  : layout.get<SymbolPlacement>();
-    const SymbolPlacementType iconPlacement = layout.get<IconRotationAlignment>() != AlignmentType::Map
-                                                  ? SymbolPlacementType::Point
-                                                  : layout.get<SymbolPlacement>();
-
-    const bool mayOverlap = layout.get<TextAllowOverlap>() || layout.get<IconAllowOverlap>() ||
+bool SymbolLayout::mayOverlap() const {
+    return layout.get<TextAllowOverlap>() || layout.get<IconAllowOverlap>() ||
         layout.get<TextIgnorePlacement>() || layout.get<IconIgnorePlacement>();
+}
 
-    const bool keepUpright = layout.get<TextKeepUpright>();
+std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile) {
+    auto bucket = std::make_unique<SymbolBucket>(layout, layerPaintProperties, zoom, sdfIcons, iconsNeedLinear);
 
     // Sort symbols by their y position on the canvas so that they lower symbols
     // are drawn on top of higher symbols.
     // Don't sort symbols that won't overlap because it isn't necessary and
     // because it causes more labels to pop in and out when rotating.
-    if (mayOverlap) {
+    if (mayOverlap()) {
         const float sin = std::sin(collisionTile.config.angle);
         const float cos = std::cos(collisionTile.config.angle);
 
@@ -456,7 +562,68 @@ std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile)
         });
     }
 
+    // Every glyph and icon gets its quad, whether it is placed or not: which of them
+    // are shown is up to the placement, so that it can change without a new bucket.
+    for (SymbolInstance &symbolInstance : symbolInstances) {
+        if (obsolete) {
+            return nullptr;
+        }
+
+        if (symbolInstance.hasText) {
+            for (const auto& symbol : symbolInstance.glyphQuads) {
+                addSymbol(bucket->text, symbol);
+            }
+        }
+
+        if (symbolInstance.hasIcon && symbolInstance.iconQuad) {
+            addSymbol(bucket->icon, *symbolInstance.iconQuad);
+        }
+
+        const auto& feature = features.at(symbolInstance.featureIndex);
+        for (auto& pair : bucket->paintPropertyBinders) {
+            pair.second.first.populateVertexVectors(feature, bucket->icon.instanceCount);
+            pair.second.second.populateVertexVectors(feature, bucket->text.instanceCount);
+        }
+    }
+
+    std::shared_ptr<SymbolBucketPlacement> placement = updatePlacement(collisionTile);
+    if (!placement) {
+        return nullptr;
+    }
+
+    bucket->setPlacement(std::move(placement));
+    placedAngle = collisionTile.config.angle;
+
+    return bucket;
+}
+
+bool SymbolLayout::canUpdatePlacement(const PlacementConfig& config) const {
+    if (state != Placed) {
+        return false;
+    }
+
+    // Symbols that may overlap were sorted for the angle they were placed at.
+    return !hasSymbolInstances() || !mayOverlap() || (placedAngle && *placedAngle == config.angle);
+}
+
+std::unique_ptr<SymbolBucketPlacement> SymbolLayout::updatePlacement(CollisionTile& collisionTile) {
+    auto placement = std::make_unique<SymbolBucketPlacement>();
+
+    // Calculate which labels can be shown and when they can be shown.
+
+    const SymbolPlacementType textPlacement = layout.get<TextRotationAlignment>() != AlignmentType::Map
+                                                  ? SymbolPlacementType::Point
+                                                  : layout.get<SymbolPlacement>();
+    const SymbolPlacementType iconPlacement = layout.get<IconRotationAlignment>() != AlignmentType::Map
+                                                  ? SymbolPlacementType::Point
+                                                  : layout.get<SymbolPlacement>();
+
+    const bool keepUpright = layout.get<TextKeepUpright>();
+
     for (SymbolInstance &symbolInstance : symbolInstances) {
+        if (obsolete) {
+            return nullptr;
+        }
 
         const bool hasText = symbolInstance.hasText;
         const bool hasIcon = symbolInstance.hasIcon;
@@ -487,118 +654,100 @@ std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile)
         }
 
 
-        // Insert final placement into collision tree and add glyphs/icons to buffers
+        // Insert final placement into collision tree and show or hide the glyphs/icons
 
         if (hasText) {
             const float placementZoom = util::max(util::log2(glyphScale) + zoom, 0.0f);
             collisionTile.insertFeature(symbolInstance.textCollisionFeature, glyphScale, layout.get<TextIgnorePlacement>());
-            if (glyphScale < collisionTile.maxScale) {
-                for (const auto& symbol : symbolInstance.glyphQuads) {
-                    addSymbol(
-                        bucket->text, symbol, placementZoom,
-                        keepUpright, textPlacement, collisionTile.config.angle, symbolInstance.writingModes);
-                }
+            const bool placed = glyphScale < collisionTile.maxScale;
+            for (const auto& symbol : symbolInstance.glyphQuads) {
+                addPlacement(
+                    placement->text, symbol, placed, placementZoom,
+                    keepUpright, textPlacement, collisionTile.config.angle, symbolInstance.writingModes);
             }
         }
 
         if (hasIcon) {
             const float placementZoom = util::max(util::log2(iconScale) + zoom, 0.0f);
             collisionTile.insertFeature(symbolInstance.iconCollisionFeature, iconScale, layout.get<IconIgnorePlacement>());
-            if (iconScale < collisionTile.maxScale && symbolInstance.iconQuad) {
-                addSymbol(
-                    bucket->icon, *symbolInstance.iconQuad, placementZoom,
+            if (symbolInstance.iconQuad) {
+                addPlacement(
+                    placement->icon, *symbolInstance.iconQuad, iconScale < collisionTile.maxScale, placementZoom,
                     keepUpright, iconPlacement, collisionTile.config.angle, symbolInstance.writingModes);
             }
         }
-        
-        const auto& feature = features.at(symbolInstance.featureIndex);
-        for (auto& pair : bucket->paintPropertyBinders) {
-            pair.second.first.populateVertexVectors(feature, bucket->icon.vertices.vertexSize());
-            pair.second.second.populateVertexVectors(feature, bucket->text.vertices.vertexSize());
-        }
     }
 
     if (collisionTile.config.debug) {
-        addToDebugBuffers(collisionTile, *bucket);
+        addToDebugBuffers(collisionTile, *placement);
     }
 
-    return bucket;
+    return placement;
 }
 
 template <typename Buffer>
-void SymbolLayout::addSymbol(Buffer& buffer,
-                             const SymbolQuad& symbol,
-                             const float placementZoom,
-                             const bool keepUpright,
-                             const style::SymbolPlacementType placement,
-                             const float placementAngle,
-                             const WritingModeType writingModes) {
-    constexpr const uint16_t vertexLength = 4;
-
-    const auto &tl = symbol.tl;
-    const auto &tr = symbol.tr;
-    const auto &bl = symbol.bl;
-    const auto &br = symbol.br;
+void SymbolLayout::addSymbol(Buffer& buffer, const SymbolQuad& symbol) {
     const auto &tex = symbol.tex;
 
-    float minZoom = util::max(zoom + util::log2(symbol.minScale), placementZoom);
-    float maxZoom = util::min(zoom + util::log2(symbol.maxScale), util::MAX_ZOOM_F);
-    const auto &anchorPoint = symbol.anchorPoint;
-
-    // drop incorrectly oriented glyphs
-    const float a = std::fmod(symbol.anchorAngle + placementAngle + M_PI, M_PI * 2);
-    if (writingModes & WritingModeType::Vertical) {
-        if (placement == style::SymbolPlacementType::Line && symbol.writingMode == WritingModeType::Vertical) {
-            if (keepUpright && placement == style::SymbolPlacementType::Line && (a <= (M_PI * 5 / 4) || a > (M_PI * 7 / 4)))
-                return;
-        } else if (keepUpright && placement == style::SymbolPlacementType::Line && (a <= (M_PI * 3 / 4) || a > (M_PI * 5 / 4)))
-            return;
-    } else if (keepUpright && placement == style::SymbolPlacementType::Line &&
-        (a <= M_PI / 2 || a > M_PI * 3 / 2)) {
-        return;
-    }
+    const float maxZoom = util::min(zoom + util::log2(symbol.maxScale), util::MAX_ZOOM_F);
 
-    if (maxZoom <= minZoom)
-        return;
+    // Encode angle of glyph
+    uint8_t glyphAngle = std::round((symbol.glyphAngle / (M_PI * 2)) * 256);
 
-    // Lower min zoom so that while fading out the label
-    // it can be shown outside of collision-free zoom levels
-    if (minZoom == placementZoom) {
-        minZoom = 0;
-    }
+    // The bottom right corner follows from the others; the bucket expands the quad into
+    // vertices on upload if it can't be drawn as an instance.
+    buffer.instances.emplace_back(SymbolInstanceAttributes::vertex(symbol.anchorPoint,
+                        symbol.tl, symbol.tr, symbol.bl, tex.x, tex.y, tex.w, tex.h,
+                        maxZoom, glyphAngle));
+    buffer.instanceCount++;
+}
 
-    if (buffer.segments.empty() || buffer.segments.back().vertexLength + vertexLength > std::numeric_limits<uint16_t>::max()) {
-        buffer.segments.emplace_back(buffer.vertices.vertexSize(), buffer.triangles.indexSize());
-    }
+template <typename Vertices>
+void SymbolLayout::addPlacement(Vertices& vertices,
+                                const SymbolQuad& symbol,
+                                const bool placed,
+                                const float placementZoom,
+                                const bool keepUpright,
+                                const style::SymbolPlacementType placement,
+                                const float placementAngle,
+                                const WritingModeType writingModes) {
+    const auto vertex = [&] {
+        if (!placed) {
+            return SymbolPlacementAttributes::hidden();
+        }
 
-    // We're generating triangle fans, so we always start with the first
-    // coordinate in this polygon.
-    auto& segment = buffer.segments.back();
-    assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
-    uint16_t index = segment.vertexLength;
+        float minZoom = util::max(zoom + util::log2(symbol.minScale), placementZoom);
+        float maxZoom = util::min(zoom + util::log2(symbol.maxScale), util::MAX_ZOOM_F);
+
+        // hide incorrectly oriented glyphs
+        const float a = std::fmod(symbol.anchorAngle + placementAngle + M_PI, M_PI * 2);
+        if (writingModes & WritingModeType::Vertical) {
+            if (placement == style::SymbolPlacementType::Line && symbol.writingMode == WritingModeType::Vertical) {
+                if (keepUpright && placement == style::SymbolPlacementType::Line && (a <= (M_PI * 5 / 4) || a > (M_PI * 7 / 4)))
+                    return SymbolPlacementAttributes::hidden();
+            } else if (keepUpright && placement == style::SymbolPlacementType::Line && (a <= (M_PI * 3 / 4) || a > (M_PI * 5 / 4)))
+                return SymbolPlacementAttributes::hidden();
+        } else if (keepUpright && placement == style::SymbolPlacementType::Line &&
+            (a <= M_PI / 2 || a > M_PI * 3 / 2)) {
+            return SymbolPlacementAttributes::hidden();
+        }
 
-    // Encode angle of glyph
-    uint8_t glyphAngle = std::round((symbol.glyphAngle / (M_PI * 2)) * 256);
+        if (maxZoom <= minZoom)
+            return SymbolPlacementAttributes::hidden();
+
+        // Lower min zoom so that while fading out the label
+        // it can be shown outside of collision-free zoom levels
+        if (minZoom == placementZoom) {
+            minZoom = 0;
+        }
+
+        return SymbolPlacementAttributes::vertex(minZoom, placementZoom);
+    }();
 
-    // coordinates (2 triangles)
-    buffer.vertices.emplace_back(SymbolLayoutAttributes::vertex(anchorPoint, tl, tex.x, tex.y,
-                        minZoom, maxZoom, placementZoom, glyphAngle));
-    buffer.vertices.emplace_back(SymbolLayoutAttributes::vertex(anchorPoint, tr, tex.x + tex.w, tex.y,
-                        minZoom, maxZoom, placementZoom, glyphAngle));
-    buffer.vertices.emplace_back(SymbolLayoutAttributes::vertex(anchorPoint, bl, tex.x, tex.y + tex.h,
-                        minZoom, maxZoom, placementZoom, glyphAngle));
-    buffer.vertices.emplace_back(SymbolLayoutAttributes::vertex(anchorPoint, br, tex.x + tex.w, tex.y + tex.h,
-                        minZoom, maxZoom, placementZoom, glyphAngle));
-
-    // add the two triangles, referencing the four coordinates we just inserted.
-    buffer.triangles.emplace_back(index + 0, index + 1, index + 2);
-    buffer.triangles.emplace_back(index + 1, index + 2, index + 3);
-
-    segment.vertexLength += vertexLength;
-    segment.indexLength += 6;
+    vertices.emplace_back(vertex);
 }
 
-void SymbolLayout::addToDebugBuffers(CollisionTile& collisionTile, SymbolBucket& bucket) {
+void SymbolLayout::addToDebugBuffers(CollisionTile& collisionTile, SymbolBucketPlacement& placement) {
 
     if (!hasSymbolInstances()) {
         return;
@@ -606,7 +755,7 @@ void SymbolLayout::addToDebugBuffers(CollisionTile& collisionTile, SymbolBucket&
 
     const float yStretch = collisionTile.yStretch;
 
-    auto& collisionBox = bucket.collisionBox;
+    auto& collisionBox = placement.collisionBox;
 
     for (const SymbolInstance &symbolInstance : symbolInstances) {
         auto populateCollisionBox = [&](const auto& feature) {
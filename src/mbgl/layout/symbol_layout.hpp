@@ -1,12 +1,15 @@
 #pragma once
 
 #include <mbgl/map/mode.hpp>
+#include <mbgl/text/placement_config.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 #include <mbgl/layout/symbol_feature.hpp>
 #include <mbgl/layout/symbol_instance.hpp>
 #include <mbgl/text/bidi.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
+#include <mbgl/util/optional.hpp>
 
+#include <atomic>
 #include <memory>
 #include <map>
 #include <unordered_set>
@@ -18,7 +21,9 @@ class GeometryTileLayer;
 class CollisionTile;
 class SpriteAtlas;
 class GlyphAtlas;
+class LineMeasurementCache;
 class SymbolBucket;
+class SymbolBucketPlacement;
 class Anchor;
 
 namespace style {
@@ -36,13 +41,38 @@ public:
 
     bool canPrepare(GlyphAtlas&);
 
+    // Lines are measured in the cache, which can be shared by the layouts of a tile.
     void prepare(uintptr_t tileUID,
-                 GlyphAtlas&);
+                 GlyphAtlas&,
+                 LineMeasurementCache&);
 
+    // Returns nullptr if the tile became obsolete during placement.
     std::unique_ptr<SymbolBucket> place(CollisionTile&);
 
+    // Whether the bucket last returned by `place` can be placed for `config` by replacing
+    // its placement with the one of `updatePlacement`, instead of placing it again.
+    bool canUpdatePlacement(const PlacementConfig& config) const;
+
+    // Computes the placement of the symbols of the bucket last returned by `place` anew,
+    // keeping their layout. Returns nullptr if the tile became obsolete during placement.
+    std::unique_ptr<SymbolBucketPlacement> updatePlacement(CollisionTile&);
+
     bool hasSymbolInstances() const;
 
+    // The ID of the first of the layers this layout is for.
+    const std::string& getBucketName() const {
+        return bucketName;
+    }
+
+    // The features that passed the filter.
+    std::size_t featureCount() const {
+        return features.size();
+    }
+
+    // Refreshes `layerPaintProperties` when the layout is retained for a new set of layers
+    // with the same layout.
+    void updatePaintProperties(const std::vector<const style::Layer*>&);
+
     enum State {
         Pending,  // Waiting for the necessary glyphs or icons to be available.
         Prepared, // The potential positions of text and icons have been determined.
@@ -59,24 +89,39 @@ private:
                     const SymbolFeature&,
                     const std::pair<Shaping, Shaping>& shapedTextOrientations,
                     const PositionedIcon& shapedIcon,
-                    const GlyphPositions& face);
+                    const GlyphPositions& face,
+                    LineMeasurementCache&);
 
     bool anchorIsTooClose(const std::u16string& text, const float repeatDistance, const Anchor&);
     std::map<std::u16string, std::vector<Anchor>> compareText;
 
-    void addToDebugBuffers(CollisionTile&, SymbolBucket&);
+    bool mayOverlap() const;
 
-    // Adds placed items to the buffer.
+    void removeHiddenDuplicates();
+
+    void addToDebugBuffers(CollisionTile&, SymbolBucketPlacement&);
+
+    // Adds the quad of an item to the buffer.
     template <typename Buffer>
-    void addSymbol(Buffer&, const SymbolQuad&, float scale,
-                    const bool keepUpright, const style::SymbolPlacementType, const float placementAngle,
-                    WritingModeType writingModes);
+    void addSymbol(Buffer&, const SymbolQuad&);
+
+    // Adds the placement of the quad of an item, hiding it if it isn't `placed` or
+    // shown at the angle.
+    template <typename Vertices>
+    void addPlacement(Vertices&, const SymbolQuad&, bool placed, float placementZoom,
+                      const bool keepUpright, const style::SymbolPlacementType, const float placementAngle,
+                      WritingModeType writingModes);
 
     const std::string sourceLayerName;
     const std::string bucketName;
+
+    // The interned names, for indexing features.
+    const uint32_t sourceLayerID;
+    const uint32_t bucketID;
     const float overscaling;
     const float zoom;
     const MapMode mode;
+    const std::atomic<bool>& obsolete;
 
     style::SymbolLayoutProperties::Evaluated layout;
     float textMaxSize;
@@ -93,6 +138,9 @@ private:
     std::vector<SymbolInstance> symbolInstances;
     std::vector<SymbolFeature> features;
 
+    // The angle that `symbolInstances` were last placed at.
+    optional<float> placedAngle;
+
     BiDi bidi; // Consider moving this up to geometry tile worker to reduce reinstantiation costs; use of BiDi/ubiditransform object must be constrained to one thread
 };
 
@@ -12,6 +12,10 @@ gl::Context& Backend::getContext() {
     return *context;
 }
 
+void Backend::shareResourcesWith(Backend& other) {
+    context->shareWith(*other.context);
+}
+
 Backend::~Backend() = default;
 
 void Backend::notifyMapChange(MapChange) {
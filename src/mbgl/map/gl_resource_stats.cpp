@@ -0,0 +1,53 @@
+#include <mbgl/map/gl_resource_stats.hpp>
+
+namespace mbgl {
+
+constexpr std::size_t GLResourceStats::OwnerCount;
+constexpr std::size_t GLResourceStats::TypeCount;
+
+const char* GLResourceStats::name(Owner owner) {
+    switch (owner) {
+    case Owner::Fill: return "fill";
+    case Owner::FillExtrusion: return "fill-extrusion";
+    case Owner::Line: return "line";
+    case Owner::Circle: return "circle";
+    case Owner::Symbol: return "symbol";
+    case Owner::Raster: return "raster";
+    case Owner::Atlas: return "atlas";
+    case Owner::Offscreen: return "offscreen";
+    case Owner::Other: return "other";
+    }
+    return "";
+}
+
+const char* GLResourceStats::name(Type type) {
+    switch (type) {
+    case Type::Buffer: return "buffer";
+    case Type::Texture: return "texture";
+    case Type::Renderbuffer: return "renderbuffer";
+    case Type::VertexArray: return "vertex array";
+    case Type::Framebuffer: return "framebuffer";
+    }
+    return "";
+}
+
+GLResourceStats::Usage GLResourceStats::total(Owner owner) const {
+    Usage result;
+    for (const auto& typeUsage : usage[std::size_t(owner)]) {
+        result.objects += typeUsage.objects;
+        result.bytes += typeUsage.bytes;
+    }
+    return result;
+}
+
+GLResourceStats::Usage GLResourceStats::total() const {
+    Usage result;
+    for (std::size_t owner = 0; owner < OwnerCount; ++owner) {
+        const Usage ownerUsage = total(Owner(owner));
+        result.objects += ownerUsage.objects;
+        result.bytes += ownerUsage.bytes;
+    }
+    return result;
+}
+
+} // namespace mbgl
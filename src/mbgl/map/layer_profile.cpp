@@ -0,0 +1,28 @@
+#include <mbgl/map/layer_profile.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+LayerProfile::Layer& LayerProfile::Layer::operator+=(const Layer& other) {
+    layouts += other.layouts;
+    cpuTime += other.cpuTime;
+    features += other.features;
+    vertices += other.vertices;
+    bytes += other.bytes;
+    return *this;
+}
+
+std::vector<std::string> LayerProfile::byCPUTime() const {
+    std::vector<std::string> result;
+    result.reserve(layers.size());
+    for (const auto& pair : layers) {
+        result.push_back(pair.first);
+    }
+    std::stable_sort(result.begin(), result.end(), [&] (const std::string& a, const std::string& b) {
+        return layers.at(a).cpuTime > layers.at(b).cpuTime;
+    });
+    return result;
+}
+
+} // namespace mbgl
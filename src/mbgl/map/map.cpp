@@ -13,20 +13,28 @@
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/style/update_parameters.hpp>
 #include <mbgl/renderer/painter.hpp>
+#include <mbgl/renderer/upload_scheduler.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/tile/layer_profiler.hpp>
+#include <mbgl/tile/layout_cache.hpp>
 #include <mbgl/util/projection.hpp>
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/exception.hpp>
 #include <mbgl/util/async_task.hpp>
+#include <mbgl/util/timer.hpp>
 #include <mbgl/util/mapbox.hpp>
 #include <mbgl/util/tile_coordinate.hpp>
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/actor/scheduler_stats.hpp>
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/math/log2.hpp>
 
+#include <limits>
+
 namespace mbgl {
 
 using namespace style;
@@ -44,6 +52,10 @@ struct StillImageRequest {
 
     View& view;
     Map::StillImageCallback callback;
+    const TimePoint start = Clock::now();
+
+    // Set once the timeout has passed; the image is then rendered as soon as the style is.
+    bool timedOut = false;
 };
 
 class Map::Impl : public style::Observer {
@@ -56,17 +68,28 @@ public:
          MapMode,
          GLContextMode,
          ConstrainMode,
-         ViewportMode);
+         ViewportMode,
+         optional<std::string> programCacheDir);
 
     void onSourceAttributionChanged(style::Source&, const std::string&) override;
     void onUpdate(Update) override;
+    void onTileChanged(style::Source&, const OverscaledTileID&) override;
     void onStyleLoaded() override;
     void onStyleError() override;
     void onResourceError(std::exception_ptr) override;
 
+    // Like `onUpdate`, for updates that nobody is waiting on: the repaint is put off by
+    // `delay`, or until the frame interval of the rendering policy has passed, and shared
+    // with the other updates that come in meanwhile.
+    void onLowPriorityUpdate(Update, Duration delay);
+
     void render(View&);
     void renderStill();
 
+    // Calls the callback of the still image, and drops what is still loading for it if
+    // it didn't complete.
+    void finishStill(std::exception_ptr, Duration rendering = Duration::zero());
+
     void loadStyleJSON(const std::string&);
 
     Map& map;
@@ -80,6 +103,7 @@ public:
     const MapMode mode;
     const GLContextMode contextMode;
     const float pixelRatio;
+    const optional<std::string> programCacheDir;
 
     MapDebugOptions debugOptions { MapDebugOptions::NoDebug };
 
@@ -88,6 +112,11 @@ public:
     std::unique_ptr<AnnotationManager> annotationManager;
     std::unique_ptr<Painter> painter;
     std::unique_ptr<Style> style;
+    UploadScheduler uploadScheduler;
+    bool drawBatching = false;
+    bool tileRenderCache = false;
+    bool partialRedraw = false;
+    FrameStatsCallback frameStatsCallback;
 
     std::string styleURL;
     std::string styleJSON;
@@ -96,13 +125,43 @@ public:
 
     std::unique_ptr<AsyncRequest> styleRequest;
 
-    size_t sourceCacheSize;
+    size_t sourceCacheBudget = std::numeric_limits<size_t>::max();
+    double tileCoverError = 0;
+    bool featureIndexing = true;
+    bool styleOptimization = false;
+    std::shared_ptr<LocalGlyphRasterizer> localGlyphRasterizer;
+    std::shared_ptr<LayoutCache> layoutCache;
+    std::shared_ptr<LayerProfiler> layerProfiler;
+    size_t prefetchBudget = 0;
+    size_t prefetchedBytes = 0;
     bool loading = false;
 
     util::AsyncTask asyncInvalidate;
+    RenderingPolicy renderingPolicy;
+    TimePoint lastFrame;
+    util::Timer lowPriorityTimer;
+    bool lowPriorityUpdatePending = false;
     std::unique_ptr<StillImageRequest> stillImageRequest;
+    util::Timer stillImageTimer;
+    StillImageStats stillImageStats;
+    RenderStats renderStats;
 };
 
+namespace {
+
+// The counters of the context that `RenderStats` takes the difference of over a frame.
+RenderStats contextCounts(const gl::Context& context) {
+    RenderStats counts;
+    counts.drawCalls = context.drawCalls;
+    counts.stateChanges = context.stateChanges;
+    counts.programSwitches = context.programSwitches;
+    counts.bucketUploads = context.bucketUploads;
+    counts.uploadedBytes = context.uploadedBytes;
+    return counts;
+}
+
+} // namespace
+
 Map::Map(Backend& backend,
          const Size size,
          const float pixelRatio,
@@ -111,7 +170,8 @@ Map::Map(Backend& backend,
          MapMode mapMode,
          GLContextMode contextMode,
          ConstrainMode constrainMode,
-         ViewportMode viewportMode)
+         ViewportMode viewportMode,
+         optional<std::string> programCacheDir)
     : impl(std::make_unique<Impl>(*this,
                                   backend,
                                   pixelRatio,
@@ -120,7 +180,8 @@ Map::Map(Backend& backend,
                                   mapMode,
                                   contextMode,
                                   constrainMode,
-                                  viewportMode)) {
+                                  viewportMode,
+                                  std::move(programCacheDir))) {
     impl->transform.resize(size);
 }
 
@@ -132,7 +193,8 @@ Map::Impl::Impl(Map& map_,
                 MapMode mode_,
                 GLContextMode contextMode_,
                 ConstrainMode constrainMode_,
-                ViewportMode viewportMode_)
+                ViewportMode viewportMode_,
+                optional<std::string> programCacheDir_)
     : map(map_),
       backend(backend_),
       fileSource(fileSource_),
@@ -143,6 +205,7 @@ Map::Impl::Impl(Map& map_,
       mode(mode_),
       contextMode(contextMode_),
       pixelRatio(pixelRatio_),
+      programCacheDir(std::move(programCacheDir_)),
       annotationManager(std::make_unique<AnnotationManager>(pixelRatio)),
       asyncInvalidate([this] {
           if (mode == MapMode::Continuous) {
@@ -166,6 +229,10 @@ Map::~Map() {
 }
 
 void Map::renderStill(View& view, StillImageCallback callback) {
+    renderStill(view, std::move(callback), Duration::zero());
+}
+
+void Map::renderStill(View& view, StillImageCallback callback, Duration timeout) {
     if (!callback) {
         Log::Error(Event::General, "StillImageCallback not set");
         return;
@@ -192,9 +259,49 @@ void Map::renderStill(View& view, StillImageCallback callback) {
     }
 
     impl->stillImageRequest = std::make_unique<StillImageRequest>(view, std::move(callback));
+    if (timeout > Duration::zero()) {
+        impl->stillImageTimer.start(timeout, Duration::zero(), [this] {
+            if (!impl->stillImageRequest) {
+                return;
+            }
+            if (!impl->style->loaded) {
+                impl->finishStill(std::make_exception_ptr(util::StillImageTimeoutException("Still image timed out before the style loaded")));
+                return;
+            }
+            impl->stillImageRequest->timedOut = true;
+            impl->onUpdate(Update::Repaint);
+        });
+    }
     impl->onUpdate(Update::Repaint);
 }
 
+void Map::cancelStill() {
+    if (impl->stillImageRequest) {
+        impl->finishStill(std::make_exception_ptr(util::StillImageCancelledException("Still image cancelled")));
+    }
+}
+
+StillImageStats Map::getStillImageStats() const {
+    return impl->stillImageStats;
+}
+
+void Map::Impl::finishStill(std::exception_ptr error, Duration rendering) {
+    auto request = std::move(stillImageRequest);
+    stillImageTimer.stop();
+
+    const TimePoint now = Clock::now();
+    stillImageStats.total = now - request->start;
+    stillImageStats.rendering = rendering;
+    stillImageStats.loading = stillImageStats.total - rendering;
+    stillImageStats.partial = error && rendering > Duration::zero();
+
+    if (error && style) {
+        style->cancelLoading();
+    }
+
+    request->callback(error);
+}
+
 void Map::Impl::renderStill() {
     if (!stillImageRequest) {
         return;
@@ -220,6 +327,12 @@ void Map::Impl::render(View& view) {
 
     TimePoint timePoint = Clock::now();
 
+    // The context's counters before this frame, to tell what it added.
+    gl::Context& context = backend.getContext();
+    const RenderStats contextBefore = contextCounts(context);
+    Duration cascadeTime = Duration::zero();
+    Duration recalculateTime = Duration::zero();
+
     auto flags = transform.updateTransitions(timePoint);
 
     updateFlags |= flags;
@@ -234,17 +347,28 @@ void Map::Impl::render(View& view) {
     }
 
     if (updateFlags & Update::Classes) {
+        const TimePoint start = Clock::now();
         style->cascade(timePoint, mode);
+        cascadeTime = Clock::now() - start;
     }
 
     if (updateFlags & Update::Classes || updateFlags & Update::RecalculateStyle) {
+        const TimePoint start = Clock::now();
         style->recalculate(transform.getZoom(), timePoint, mode);
+        recalculateTime = Clock::now() - start;
     }
 
     if (updateFlags & Update::Layout) {
         style->relayout();
     }
 
+    // Still images are only rendered once everything is loaded, so there is no frame to
+    // spread the uploads over; the painter uploads all tiles there.
+    if (mode == MapMode::Continuous) {
+        uploadScheduler.startFrame();
+        style->uploadTiles(uploadScheduler, backend.getContext());
+    }
+
     style::UpdateParameters parameters(pixelRatio,
                                        debugOptions,
                                        transform.getState(),
@@ -253,16 +377,42 @@ void Map::Impl::render(View& view) {
                                        mode,
                                        *annotationManager,
                                        *style);
+    parameters.transitionStates = transform.getTransitionStates();
+    parameters.tileCoverError = tileCoverError;
+    if (mode == MapMode::Continuous && prefetchedBytes < prefetchBudget &&
+        !transform.inTransition() && !transform.isGestureInProgress()) {
+        parameters.prefetchBytes = prefetchBudget - prefetchedBytes;
+    }
 
     style->updateTiles(parameters);
+    prefetchedBytes += style->takePrefetchedBytes();
 
     updateFlags = Update::Nothing;
 
     if (!painter) {
-        painter = std::make_unique<Painter>(backend.getContext(), transform.getState(), pixelRatio);
+        painter = std::make_unique<Painter>(backend.getContext(), transform.getState(), pixelRatio, programCacheDir);
     }
 
+    const TimePoint updateEnd = Clock::now();
+
+    // Called once the painter has rendered the frame.
+    auto recordRenderStats = [&] {
+        const RenderStats contextAfter = contextCounts(context);
+        renderStats = painter->getRenderStats();
+        renderStats.update = updateEnd - timePoint - cascadeTime - recalculateTime;
+        renderStats.cascade = cascadeTime;
+        renderStats.recalculate = recalculateTime;
+        renderStats.painter = Clock::now() - updateEnd;
+        renderStats.drawCalls = contextAfter.drawCalls - contextBefore.drawCalls;
+        renderStats.stateChanges = contextAfter.stateChanges - contextBefore.stateChanges;
+        renderStats.programSwitches = contextAfter.programSwitches - contextBefore.programSwitches;
+        renderStats.bucketUploads = contextAfter.bucketUploads - contextBefore.bucketUploads;
+        renderStats.uploadedBytes = contextAfter.uploadedBytes - contextBefore.uploadedBytes;
+    };
+
     if (mode == MapMode::Continuous) {
+        lastFrame = timePoint;
+
         if (renderState == RenderState::Never) {
             backend.notifyMapChange(MapChangeWillStartRenderingMap);
         }
@@ -273,12 +423,23 @@ void Map::Impl::render(View& view) {
                               pixelRatio,
                               mode,
                               contextMode,
-                              debugOptions };
+                              debugOptions,
+                              drawBatching,
+                              tileRenderCache,
+                              partialRedraw,
+                              bool(frameStatsCallback) };
 
         painter->render(*style,
                         frameData,
                         view,
                         annotationManager->getSpriteAtlas());
+        recordRenderStats();
+
+        for (const auto& stats : painter->collectFrameStats()) {
+            if (frameStatsCallback) {
+                frameStatsCallback(stats);
+            }
+        }
 
         painter->cleanup();
 
@@ -299,34 +460,48 @@ void Map::Impl::render(View& view) {
 
         if (style->hasTransitions()) {
             flags |= Update::RecalculateStyle;
-        } else if (painter->needsAnimation()) {
-            flags |= Update::Repaint;
         }
 
         // Only schedule an update if we need to paint another frame due to transitions or
-        // animations that are still in progress
+        // animations that are still in progress. Fading labels and deferred uploads don't
+        // need the full frame rate.
         if (flags != Update::Nothing) {
             onUpdate(flags);
+        } else if (painter->needsAnimation() || uploadScheduler.hasDeferred()) {
+            onLowPriorityUpdate(Update::Repaint, Duration::zero());
         }
-    } else if (stillImageRequest && style->isLoaded()) {
+    } else if (stillImageRequest && (style->isLoaded() || (stillImageRequest->timedOut && style->loaded))) {
+        const bool complete = style->isLoaded();
+        const TimePoint renderStart = Clock::now();
         FrameData frameData { timePoint,
                               pixelRatio,
                               mode,
                               contextMode,
-                              debugOptions };
+                              debugOptions,
+                              drawBatching,
+                              tileRenderCache,
+                              partialRedraw,
+                              false };
 
         try {
             painter->render(*style,
                             frameData,
                             view,
                             annotationManager->getSpriteAtlas());
+            recordRenderStats();
         } catch (...) {
             Log::Error(Event::General, "Exception in render: %s", util::toString(std::current_exception()).c_str());
             exit(1);
         }
 
-        auto request = std::move(stillImageRequest);
-        request->callback(nullptr);
+        // The geometry kept for batching fills is all uploaded by now; without batching,
+        // they are drawn on their own in the next image as well.
+        if (!drawBatching) {
+            style->releaseRetainedData();
+        }
+
+        finishStill(complete ? nullptr : std::make_exception_ptr(util::StillImageTimeoutException("Still image timed out; rendered from the resources that had loaded")),
+                    Clock::now() - renderStart);
 
         painter->cleanup();
     }
@@ -346,9 +521,18 @@ void Map::setStyleURL(const std::string& url) {
     impl->styleRequest = nullptr;
     impl->styleURL = url;
     impl->styleJSON.clear();
-    impl->styleMutated = false;
 
-    impl->style = std::make_unique<Style>(impl->fileSource, impl->pixelRatio);
+    // A loaded style is kept until the new one arrives, to be updated to it.
+    if (!impl->style || !impl->style->loaded || impl->styleMutated) {
+        impl->style = std::make_unique<Style>(impl->scheduler, impl->fileSource, impl->pixelRatio);
+        impl->style->setSourceTileCacheBudget(impl->sourceCacheBudget);
+        impl->style->setFeatureIndexing(impl->featureIndexing);
+        impl->style->optimizeLayers = impl->styleOptimization;
+        impl->style->glyphAtlas->setLocalGlyphRasterizer(impl->localGlyphRasterizer);
+        impl->style->layoutCache = impl->layoutCache;
+        impl->style->layerProfiler = impl->layerProfiler;
+        impl->styleMutated = false;
+    }
 
     impl->styleRequest = impl->fileSource.request(Resource::style(impl->styleURL), [this](Response res) {
         // Once we get a fresh style, or the style is mutated, stop revalidating.
@@ -357,7 +541,7 @@ void Map::setStyleURL(const std::string& url) {
         }
 
         // Don't allow a loaded, mutated style to be overwritten with a new version.
-        if (impl->styleMutated && impl->style->loaded) {
+        if (impl->styleMutated && impl->style->loaded && !impl->styleJSON.empty()) {
             return;
         }
 
@@ -389,17 +573,29 @@ void Map::setStyleJSON(const std::string& json) {
 
     impl->styleURL.clear();
     impl->styleJSON.clear();
-    impl->styleMutated = false;
-
-    impl->style = std::make_unique<Style>(impl->fileSource, impl->pixelRatio);
 
     impl->loadStyleJSON(json);
 }
 
 void Map::Impl::loadStyleJSON(const std::string& json) {
-    style->setObserver(this);
-    style->setJSON(json);
+    // A loaded style that hasn't been mutated is updated in place, keeping the sources and
+    // layers the two styles share, with their tiles. Any other is replaced.
+    const bool updated = style && style->loaded && !styleMutated && style->updateJSON(json);
+    if (!updated) {
+        if (!style || style->loaded) {
+            style = std::make_unique<Style>(scheduler, fileSource, pixelRatio);
+            style->setSourceTileCacheBudget(sourceCacheBudget);
+            style->setFeatureIndexing(featureIndexing);
+            style->optimizeLayers = styleOptimization;
+            style->glyphAtlas->setLocalGlyphRasterizer(localGlyphRasterizer);
+            style->layoutCache = layoutCache;
+            style->layerProfiler = layerProfiler;
+        }
+        style->setObserver(this);
+        style->setJSON(json);
+    }
     styleJSON = json;
+    styleMutated = false;
 
     // force style cascade, causing all pending transitions to complete.
     style->cascade(Clock::now(), mode);
@@ -412,7 +608,7 @@ void Map::Impl::loadStyleJSON(const std::string& json) {
         map.setPitch(map.getDefaultPitch());
     }
 
-    onUpdate(Update::Classes | Update::RecalculateStyle | Update::AnnotationStyle);
+    onUpdate(Update::Classes | Update::RecalculateStyle | Update::Layout | Update::AnnotationStyle);
 }
 
 std::string Map::getStyleURL() const {
@@ -778,6 +974,14 @@ LatLng Map::latLngForPixel(const ScreenCoordinate& pixel) const {
     return impl->transform.screenCoordinateToLatLng(pixel);
 }
 
+std::vector<ScreenCoordinate> Map::pixelsForLatLngs(const std::vector<LatLng>& latLngs) const {
+    return impl->transform.latLngsToScreenCoordinates(latLngs);
+}
+
+std::vector<LatLng> Map::latLngsForPixels(const std::vector<ScreenCoordinate>& pixels) const {
+    return impl->transform.screenCoordinatesToLatLngs(pixels);
+}
+
 #pragma mark - Annotations
 
 void Map::addAnnotationIcon(const std::string& name, std::shared_ptr<const SpriteImage> sprite) {
@@ -807,8 +1011,29 @@ void Map::removeAnnotation(AnnotationID annotation) {
     impl->onUpdate(Update::AnnotationStyle | Update::AnnotationData);
 }
 
+AnnotationIDs Map::addAnnotations(const std::vector<Annotation>& annotations) {
+    auto result = impl->annotationManager->addAnnotations(annotations, getMaxZoom());
+    impl->onUpdate(Update::AnnotationStyle | Update::AnnotationData);
+    return result;
+}
+
+void Map::removeAnnotations(const AnnotationIDs& annotations) {
+    impl->annotationManager->removeAnnotations(annotations);
+    impl->onUpdate(Update::AnnotationStyle | Update::AnnotationData);
+}
+
 #pragma mark - Feature query api
 
+static ScreenLineString boxGeometry(const ScreenBox& box) {
+    return {
+        box.min,
+        { box.max.x, box.min.y },
+        box.max,
+        { box.min.x, box.max.y },
+        box.min
+    };
+}
+
 std::vector<Feature> Map::queryRenderedFeatures(const ScreenCoordinate& point, const QueryOptions& options) {
     if (!impl->style) return {};
 
@@ -823,28 +1048,56 @@ std::vector<Feature> Map::queryRenderedFeatures(const ScreenBox& box, const Quer
     if (!impl->style) return {};
 
     return impl->style->queryRenderedFeatures(
-        {
-            box.min,
-            { box.max.x, box.min.y },
-            box.max,
-            { box.min.x, box.max.y },
-            box.min
-        },
+        boxGeometry(box),
+        impl->transform.getState(),
+        options
+    );
+}
+
+std::vector<RenderedFeatureID> Map::queryRenderedFeatureIDs(const ScreenCoordinate& point, const QueryOptions& options) {
+    if (!impl->style) return {};
+
+    return impl->style->queryRenderedFeatureIDs(
+        { point },
+        impl->transform.getState(),
+        options
+    );
+}
+
+std::vector<RenderedFeatureID> Map::queryRenderedFeatureIDs(const ScreenBox& box, const QueryOptions& options) {
+    if (!impl->style) return {};
+
+    return impl->style->queryRenderedFeatureIDs(
+        boxGeometry(box),
         impl->transform.getState(),
         options
     );
 }
 
+std::vector<Feature> Map::querySourceFeatures(const std::string& sourceID, const SourceQueryOptions& options) {
+    std::vector<Feature> result;
+    querySourceFeatures(sourceID, options, [&] (std::vector<Feature> features) {
+        std::move(features.begin(), features.end(), std::back_inserter(result));
+    });
+    return result;
+}
+
+void Map::querySourceFeatures(const std::string& sourceID, const SourceQueryOptions& options, const std::function<void (std::vector<Feature>)>& chunk) {
+    if (!impl->style) return;
+
+    impl->style->querySourceFeatures(sourceID, options, chunk);
+}
+
 AnnotationIDs Map::queryPointAnnotations(const ScreenBox& box) {
     QueryOptions options;
     options.layerIDs = {{ AnnotationManager::PointLayerID }};
-    auto features = queryRenderedFeatures(box, options);
+    auto features = queryRenderedFeatureIDs(box, options);
     std::set<AnnotationID> set;
     for (auto &feature : features) {
-        assert(feature.id);
-        assert(feature.id->is<uint64_t>());
-        assert(feature.id->get<uint64_t>() <= std::numeric_limits<AnnotationID>::max());
-        set.insert(static_cast<AnnotationID>(feature.id->get<uint64_t>()));
+        assert(feature.featureID);
+        assert(feature.featureID->is<uint64_t>());
+        assert(feature.featureID->get<uint64_t>() <= std::numeric_limits<AnnotationID>::max());
+        set.insert(static_cast<AnnotationID>(feature.featureID->get<uint64_t>()));
     }
     AnnotationIDs ids;
     ids.reserve(set.size());
@@ -852,6 +1105,10 @@ AnnotationIDs Map::queryPointAnnotations(const ScreenBox& box) {
     return ids;
 }
 
+AnnotationIDs Map::queryPointAnnotations(const LatLngBounds& bounds) {
+    return impl->annotationManager->querySymbolAnnotations(bounds);
+}
+
 #pragma mark - Style API
 
 std::vector<style::Source*> Map::getSources() {
@@ -919,6 +1176,18 @@ std::unique_ptr<Layer> Map::removeLayer(const std::string& id) {
     return removedLayer;
 }
 
+void Map::beginStyleBatch() {
+    if (impl->style) {
+        impl->style->beginUpdateBatch();
+    }
+}
+
+void Map::endStyleBatch() {
+    if (impl->style) {
+        impl->style->endUpdateBatch();
+    }
+}
+
 void Map::addImage(const std::string& name, std::unique_ptr<const SpriteImage> image) {
     if (!impl->style) {
         return;
@@ -1065,24 +1334,174 @@ std::vector<std::string> Map::getClasses() const {
     return {};
 }
 
-void Map::setSourceTileCacheSize(size_t size) {
-    if (size != impl->sourceCacheSize) {
-        impl->sourceCacheSize = size;
+void Map::setSourceTileCacheBudget(size_t bytes) {
+    if (bytes != impl->sourceCacheBudget) {
+        impl->sourceCacheBudget = bytes;
         if (!impl->style) return;
-        impl->style->setSourceTileCacheSize(size);
+        impl->style->setSourceTileCacheBudget(bytes);
         impl->backend.invalidate();
     }
 }
 
-void Map::onLowMemory() {
-    if (impl->painter) {
+void Map::setPitchedTileCoverError(double maxError) {
+    if (maxError != impl->tileCoverError) {
+        impl->tileCoverError = maxError;
+        impl->onUpdate(Update::Repaint);
+    }
+}
+
+void Map::setTilePrefetchBudget(size_t bytes) {
+    impl->prefetchBudget = bytes;
+    impl->prefetchedBytes = 0;
+    impl->onUpdate(Update::Repaint);
+}
+
+void Map::setFeatureIndexing(bool enabled) {
+    if (enabled != impl->featureIndexing) {
+        impl->featureIndexing = enabled;
+        if (!impl->style) return;
+        impl->style->setFeatureIndexing(enabled);
+        impl->backend.invalidate();
+    }
+}
+
+bool Map::getFeatureIndexing() const {
+    return impl->featureIndexing;
+}
+
+void Map::setStyleOptimization(bool enabled) {
+    impl->styleOptimization = enabled;
+    if (impl->style) {
+        impl->style->optimizeLayers = enabled;
+    }
+}
+
+bool Map::getStyleOptimization() const {
+    return impl->styleOptimization;
+}
+
+void Map::setLocalGlyphRasterizer(std::shared_ptr<LocalGlyphRasterizer> rasterizer) {
+    impl->localGlyphRasterizer = std::move(rasterizer);
+    if (impl->style) {
+        impl->style->glyphAtlas->setLocalGlyphRasterizer(impl->localGlyphRasterizer);
+    }
+}
+
+void Map::setLayoutCacheDirectory(const std::string& directory) {
+    impl->layoutCache = directory.empty() ? nullptr : std::make_shared<LayoutCache>(directory);
+    if (impl->style) {
+        impl->style->layoutCache = impl->layoutCache;
+    }
+}
+
+void Map::setLayerProfiling(bool enabled) {
+    if (enabled == bool(impl->layerProfiler)) {
+        return;
+    }
+    impl->layerProfiler = enabled ? std::make_shared<LayerProfiler>() : nullptr;
+    if (impl->style) {
+        impl->style->layerProfiler = impl->layerProfiler;
+    }
+}
+
+bool Map::getLayerProfiling() const {
+    return bool(impl->layerProfiler);
+}
+
+LayerProfile Map::getLayerProfile() const {
+    return impl->layerProfiler ? impl->layerProfiler->snapshot() : LayerProfile();
+}
+
+void Map::setTileUploadBudget(Duration budget) {
+    impl->uploadScheduler.setBudget(budget);
+}
+
+Duration Map::getTileUploadBudget() const {
+    return impl->uploadScheduler.getBudget();
+}
+
+void Map::setDrawBatching(bool enabled) {
+    if (impl->drawBatching != enabled) {
+        impl->drawBatching = enabled;
+        impl->onUpdate(Update::Repaint);
+    }
+}
+
+bool Map::getDrawBatching() const {
+    return impl->drawBatching;
+}
+
+void Map::setTileRenderCache(bool enabled) {
+    if (impl->tileRenderCache != enabled) {
+        impl->tileRenderCache = enabled;
+        impl->onUpdate(Update::Repaint);
+    }
+}
+
+bool Map::getTileRenderCache() const {
+    return impl->tileRenderCache;
+}
+
+void Map::setPartialRedraw(bool enabled) {
+    if (impl->partialRedraw != enabled) {
+        impl->partialRedraw = enabled;
+        impl->onUpdate(Update::Repaint);
+    }
+}
+
+bool Map::getPartialRedraw() const {
+    return impl->partialRedraw;
+}
+
+void Map::setRenderingPolicy(const RenderingPolicy& policy) {
+    impl->renderingPolicy = policy;
+}
+
+RenderingPolicy Map::getRenderingPolicy() const {
+    return impl->renderingPolicy;
+}
+
+void Map::setFrameStatsCallback(FrameStatsCallback callback) {
+    impl->frameStatsCallback = std::move(callback);
+}
+
+RenderStats Map::getRenderStats() const {
+    return impl->renderStats;
+}
+
+MemoryPressureResult Map::onMemoryPressure(MemoryPressure level) {
+    MemoryPressureResult result;
+    if (impl->style) {
+        impl->style->onMemoryPressure(level, result);
+        impl->backend.invalidate();
+    }
+    if (level >= MemoryPressure::High) {
+        result.responseCache = impl->fileSource.purgeMemoryCache();
+    }
+    if (level >= MemoryPressure::High && impl->painter) {
+        // Rendered again as the tiles are shown.
+        result.tileRenderCache = impl->painter->releaseTileRenderCache();
+        impl->backend.invalidate();
+    }
+    if (level == MemoryPressure::Critical && impl->painter) {
+        // Deletes the GL objects of the tiles just dropped.
         BackendScope guard(impl->backend);
         impl->painter->cleanup();
     }
+    return result;
+}
+
+void Map::onLowMemory() {
+    onMemoryPressure(MemoryPressure::Critical);
+}
+
+MemoryStats Map::getMemoryStats() const {
+    MemoryStats result;
     if (impl->style) {
-        impl->style->onLowMemory();
-        impl->backend.invalidate();
+        impl->style->addMemoryUsage(result);
     }
+    result.fileSourceCacheBytes = impl->fileSource.getMemoryCacheSize();
+    return result;
 }
 
 void Map::Impl::onSourceAttributionChanged(style::Source&, const std::string&) {
@@ -1092,6 +1511,42 @@ void Map::Impl::onSourceAttributionChanged(style::Source&, const std::string&) {
 void Map::Impl::onUpdate(Update flags) {
     updateFlags |= flags;
     asyncInvalidate.send();
+
+    // The frame asked for now renders what was put off too.
+    if (lowPriorityUpdatePending) {
+        lowPriorityTimer.stop();
+        lowPriorityUpdatePending = false;
+    }
+}
+
+void Map::Impl::onLowPriorityUpdate(Update flags, Duration delay) {
+    updateFlags |= flags;
+    if (lowPriorityUpdatePending) {
+        return;
+    }
+
+    // Still images wait for nothing, and gestures and camera transitions render every frame
+    // anyway.
+    if (mode != MapMode::Continuous || transform.isGestureInProgress() || transform.inTransition()) {
+        delay = Duration::zero();
+    } else {
+        delay = std::max(delay, renderingPolicy.lowPriorityFrameInterval - (Clock::now() - lastFrame));
+    }
+
+    if (delay <= Duration::zero()) {
+        asyncInvalidate.send();
+        return;
+    }
+
+    lowPriorityUpdatePending = true;
+    lowPriorityTimer.start(delay, Duration::zero(), [this] {
+        lowPriorityUpdatePending = false;
+        asyncInvalidate.send();
+    });
+}
+
+void Map::Impl::onTileChanged(style::Source&, const OverscaledTileID&) {
+    onLowPriorityUpdate(Update::Repaint, renderingPolicy.tileArrivalDelay);
 }
 
 void Map::Impl::onStyleLoaded() {
@@ -1104,11 +1559,14 @@ void Map::Impl::onStyleError() {
 
 void Map::Impl::onResourceError(std::exception_ptr error) {
     if (mode == MapMode::Still && stillImageRequest) {
-        auto request = std::move(stillImageRequest);
-        request->callback(error);
+        finishStill(error);
     }
 }
 
+GLResourceStats Map::getGLResourceStats() const {
+    return impl->backend.getContext().getResourceStats();
+}
+
 void Map::dumpDebugLogs() const {
     Log::Info(Event::General, "--------------------------------------------------------------------------------");
     Log::Info(Event::General, "MapContext::styleURL: %s", impl->styleURL.c_str());
@@ -1117,6 +1575,48 @@ void Map::dumpDebugLogs() const {
     } else {
         Log::Info(Event::General, "no style loaded");
     }
+    const gl::UniformCounts& uniformCounts = impl->backend.getContext().uniformCounts;
+    Log::Info(Event::OpenGL, "Uniform values: %zu bound, %zu unchanged",
+              uniformCounts.bound, uniformCounts.skipped);
+    Log::Info(Event::OpenGL, "Draw calls: %zu, %zu kB uploaded",
+              impl->backend.getContext().drawCalls, impl->backend.getContext().uploadedBytes / 1024);
+    const GLResourceStats resourceStats = getGLResourceStats();
+    for (std::size_t owner = 0; owner < GLResourceStats::OwnerCount; ++owner) {
+        for (std::size_t type = 0; type < GLResourceStats::TypeCount; ++type) {
+            const auto& usage = resourceStats.get(GLResourceStats::Owner(owner), GLResourceStats::Type(type));
+            if (usage.objects) {
+                Log::Info(Event::OpenGL, "GL resources: %s %s: %zu, %zu kB",
+                          GLResourceStats::name(GLResourceStats::Owner(owner)),
+                          GLResourceStats::name(GLResourceStats::Type(type)),
+                          usage.objects, usage.bytes / 1024);
+            }
+        }
+    }
+    Log::Info(Event::OpenGL, "GL resources: %zu kB, at most %zu kB",
+              resourceStats.total().bytes / 1024, resourceStats.highWaterBytes / 1024);
+    const MemoryStats memoryStats = getMemoryStats();
+    for (const auto& pair : memoryStats.sources) {
+        const MemoryStats::Usage tiles = pair.second.tileTotal();
+        Log::Info(Event::General, "Memory: source %s: %zu tiles, %zu kB CPU, %zu kB GPU; %zu cached, %zu kB",
+                  pair.first.c_str(), pair.second.tiles, tiles.cpuBytes / 1024, tiles.gpuBytes / 1024,
+                  pair.second.cachedTiles, pair.second.cache.total() / 1024);
+    }
+    Log::Info(Event::General, "Memory: %zu kB CPU, %zu kB GPU",
+              memoryStats.total().cpuBytes / 1024, memoryStats.total().gpuBytes / 1024);
+    if (impl->layerProfiler) {
+        const LayerProfile profile = getLayerProfile();
+        for (const auto& layerID : profile.byCPUTime()) {
+            const LayerProfile::Layer& layer = profile.layers.at(layerID);
+            Log::Info(Event::General, "Layer %s: %.1f ms in %zu layouts, %zu features, %zu vertices, %zu kB",
+                      layerID.c_str(), std::chrono::duration<double, std::milli>(layer.cpuTime).count(),
+                      layer.layouts, layer.features, layer.vertices, layer.bytes / 1024);
+        }
+    }
+    if (SchedulerStats* stats = impl->scheduler.getStats()) {
+        if (stats->isEnabled()) {
+            stats->dumpDebugLogs();
+        }
+    }
     Log::Info(Event::General, "--------------------------------------------------------------------------------");
 }
 
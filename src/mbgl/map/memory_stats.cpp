@@ -0,0 +1,46 @@
+#include <mbgl/map/memory_stats.hpp>
+
+namespace mbgl {
+
+constexpr std::size_t MemoryStats::BucketTypeCount;
+
+const char* MemoryStats::name(BucketType type) {
+    switch (type) {
+    case BucketType::Fill: return "fill";
+    case BucketType::FillExtrusion: return "fill-extrusion";
+    case BucketType::Line: return "line";
+    case BucketType::Circle: return "circle";
+    case BucketType::Symbol: return "symbol";
+    case BucketType::Raster: return "raster";
+    }
+    return "";
+}
+
+MemoryStats::Usage MemoryStats::Source::tileTotal() const {
+    Usage result;
+    for (const auto& usage : buckets) {
+        result += usage;
+    }
+    result.cpuBytes += featureIndexBytes + tileDataBytes;
+    return result;
+}
+
+MemoryStats::Usage MemoryStats::Source::total() const {
+    Usage result = tileTotal();
+    result += cache;
+    return result;
+}
+
+MemoryStats::Usage MemoryStats::total() const {
+    Usage result;
+    for (const auto& pair : sources) {
+        result += pair.second.total();
+    }
+    result += glyphAtlas;
+    result += spriteAtlas;
+    result += lineAtlas;
+    result.cpuBytes += shapingCacheBytes + fileSourceCacheBytes;
+    return result;
+}
+
+} // namespace mbgl
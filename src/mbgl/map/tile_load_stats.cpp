@@ -0,0 +1,59 @@
+#include <mbgl/map/tile_load_stats.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+constexpr std::size_t TileLoadStats::PhaseCount;
+
+const std::array<Duration, 7> TileLoadStats::bounds = {{
+    Milliseconds(1), Milliseconds(5), Milliseconds(20), Milliseconds(50),
+    Milliseconds(200), Seconds(1), Seconds(5)
+}};
+
+const char* TileLoadStats::name(Phase phase) {
+    switch (phase) {
+    case Phase::Request: return "request";
+    case Phase::Parse: return "parse";
+    case Phase::Layout: return "layout";
+    case Phase::Placement: return "placement";
+    case Phase::Upload: return "upload";
+    case Phase::Render: return "render";
+    case Phase::Total: return "total";
+    }
+    return "";
+}
+
+void TileLoadStats::record(const TileTimeline& timeline) {
+    tiles++;
+    if (timeline.fromCache) {
+        fromCache++;
+    }
+
+    record(Phase::Request, timeline.requested, timeline.responded);
+    record(Phase::Parse, timeline.responded, timeline.parsed);
+    record(Phase::Layout, timeline.parsed, timeline.laidOut);
+    record(Phase::Placement, timeline.laidOut, timeline.placed);
+    record(Phase::Upload, timeline.laidOut ? timeline.laidOut : timeline.parsed, timeline.uploaded);
+    record(Phase::Render, timeline.uploaded, timeline.rendered);
+
+    for (const auto& start : { timeline.requested, timeline.responded, timeline.parsed,
+                               timeline.laidOut, timeline.uploaded }) {
+        if (start) {
+            record(Phase::Total, start, timeline.rendered);
+            break;
+        }
+    }
+}
+
+void TileLoadStats::record(Phase phase, const optional<TimePoint>& start, const optional<TimePoint>& end) {
+    if (!start || !end) {
+        return;
+    }
+    // Phases may overlap; e.g. a tile is uploaded before its symbols are placed.
+    const Duration duration = std::max(Duration::zero(), *end - *start);
+    const auto it = std::upper_bound(bounds.begin(), bounds.end(), duration);
+    histograms[std::size_t(phase)][it - bounds.begin()]++;
+}
+
+} // namespace mbgl
@@ -568,6 +568,19 @@ void Transform::startTransition(const CameraOptions& camera,
         anchorLatLng = state.screenCoordinateToLatLng(*anchor);
     }
 
+    // The frame function is evaluated ahead of time on a copy of the state, which is then
+    // restored.
+    transitionStates.clear();
+    if (isAnimated) {
+        const TransformState current = state;
+        for (const double k : { 1.0, 0.5 }) {
+            frame(k);
+            if (anchor) state.moveLatLng(anchorLatLng, *anchor);
+            transitionStates.push_back(state);
+            state = current;
+        }
+    }
+
     transitionStart = Clock::now();
     transitionDuration = duration;
 
@@ -603,6 +616,7 @@ void Transform::startTransition(const CameraOptions& camera,
     };
 
     transitionFinishFn = [isAnimated, animation, this] {
+        transitionStates.clear();
         state.panning = false;
         state.scaling = false;
         state.rotating = false;
@@ -659,4 +673,28 @@ LatLng Transform::screenCoordinateToLatLng(const ScreenCoordinate& point) const
     return state.screenCoordinateToLatLng(flippedPoint).wrapped();
 }
 
+std::vector<ScreenCoordinate> Transform::latLngsToScreenCoordinates(const std::vector<LatLng>& latLngs) const {
+    // As above, with the center looked up once.
+    const LatLng center = getLatLng();
+    std::vector<ScreenCoordinate> result;
+    result.reserve(latLngs.size());
+    for (const auto& latLng : latLngs) {
+        LatLng unwrappedLatLng = latLng.wrapped();
+        unwrappedLatLng.unwrapForShortestPath(center);
+        ScreenCoordinate point = state.latLngToScreenCoordinate(unwrappedLatLng);
+        point.y = state.size.height - point.y;
+        result.push_back(point);
+    }
+    return result;
+}
+
+std::vector<LatLng> Transform::screenCoordinatesToLatLngs(const std::vector<ScreenCoordinate>& points) const {
+    std::vector<LatLng> result;
+    result.reserve(points.size());
+    for (const auto& point : points) {
+        result.push_back(screenCoordinateToLatLng(point));
+    }
+    return result;
+}
+
 } // namespace mbgl
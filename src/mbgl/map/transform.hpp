@@ -13,6 +13,7 @@
 #include <cstdint>
 #include <cmath>
 #include <functional>
+#include <vector>
 
 namespace mbgl {
 
@@ -148,6 +149,10 @@ public:
     Duration getTransitionDuration() const { return transitionDuration; }
     void cancelTransitions();
 
+    // The viewport an animation ends at, then the one halfway there, for loading their tiles
+    // ahead of the camera. Empty unless an animation is in progress.
+    const std::vector<TransformState>& getTransitionStates() const { return transitionStates; }
+
     // Gesture
     void setGestureInProgress(bool);
     bool isGestureInProgress() const { return state.isGestureInProgress(); }
@@ -161,6 +166,8 @@ public:
     // Conversion and projection
     ScreenCoordinate latLngToScreenCoordinate(const LatLng&) const;
     LatLng screenCoordinateToLatLng(const ScreenCoordinate&) const;
+    std::vector<ScreenCoordinate> latLngsToScreenCoordinates(const std::vector<LatLng>&) const;
+    std::vector<LatLng> screenCoordinatesToLatLngs(const std::vector<ScreenCoordinate>&) const;
 
 private:
     std::function<void(MapChange)> callback;
@@ -176,6 +183,7 @@ private:
     Duration transitionDuration;
     std::function<Update(const TimePoint)> transitionFrameFn;
     std::function<void()> transitionFinishFn;
+    std::vector<TransformState> transitionStates;
 };
 
 } // namespace mbgl
@@ -26,7 +26,50 @@ void TransformState::matrixFor(mat4& matrix, const UnwrappedTileID& tileID) cons
     matrix::scale(matrix, matrix, s / util::EXTENT, s / util::EXTENT, 1);
 }
 
+void TransformState::matrixFor(mat4& matrix, const UnwrappedTileID& tileID, const mat4& projMatrix) const {
+    const uint64_t tileScale = 1ull << tileID.canonical.z;
+    const double s = Projection::worldSize(scale) / tileScale;
+    const double tx = int64_t(tileID.canonical.x + tileID.wrap * tileScale) * s;
+    const double ty = int64_t(tileID.canonical.y) * s;
+    const double ts = s / util::EXTENT;
+
+    // The tile matrix only scales and translates, so most of the products are zeros.
+    for (std::size_t i = 0; i < 4; ++i) {
+        const double a0 = projMatrix[i], a1 = projMatrix[4 + i], a2 = projMatrix[8 + i], a3 = projMatrix[12 + i];
+        matrix[i] = a0 * ts;
+        matrix[4 + i] = a1 * ts;
+        matrix[8 + i] = a2;
+        matrix[12 + i] = a0 * tx + a1 * ty + a3;
+    }
+}
+
 void TransformState::getProjMatrix(mat4& projMatrix) const {
+    projMatrix = getMatrices().projMatrix;
+}
+
+const TransformState::Matrices& TransformState::getMatrices() const {
+    if (matrices && matrices->size == size && matrices->x == x && matrices->y == y &&
+        matrices->angle == angle && matrices->scale == scale && matrices->fov == fov &&
+        matrices->pitch == pitch && matrices->orientation == orientation &&
+        matrices->viewportMode == viewportMode) {
+        return *matrices;
+    }
+
+    Matrices result { size, x, y, angle, scale, fov, pitch, orientation, viewportMode, {}, {}, {}, false };
+    computeProjMatrix(result.projMatrix);
+
+    mat4& coordinateMatrix = result.coordinatePointMatrix;
+    coordinateMatrix = result.projMatrix;
+    const float s = Projection::worldSize(scale) / std::pow(2, getZoom());
+    matrix::scale(coordinateMatrix, coordinateMatrix, s, s, 1);
+    matrix::multiply(coordinateMatrix, getPixelMatrix(), coordinateMatrix);
+    result.invertible = !matrix::invert(result.invertedCoordinatePointMatrix, coordinateMatrix);
+
+    matrices = result;
+    return *matrices;
+}
+
+void TransformState::computeProjMatrix(mat4& projMatrix) const {
 
      // Find the distance from the center point [width/2, height/2] to the
     // center top point [width/2, 0] in Z units, using the law of sines.
@@ -220,7 +263,7 @@ ScreenCoordinate TransformState::latLngToScreenCoordinate(const LatLng& latLng)
         return {};
     }
 
-    mat4 mat = coordinatePointMatrix(getZoom());
+    const mat4& mat = getMatrices().coordinatePointMatrix;
     vec4 p;
     Point<double> pt = Projection::project(latLng, scale) / double(util::tileSize);
     vec4 c = {{ pt.x, pt.y, 0, 1 }};
@@ -234,12 +277,9 @@ LatLng TransformState::screenCoordinateToLatLng(const ScreenCoordinate& point, L
     }
 
     float targetZ = 0;
-    mat4 mat = coordinatePointMatrix(getZoom());
-
-    mat4 inverted;
-    bool err = matrix::invert(inverted, mat);
-
-    if (err) throw std::runtime_error("failed to invert coordinatePointMatrix");
+    const Matrices& cached = getMatrices();
+    if (!cached.invertible) throw std::runtime_error("failed to invert coordinatePointMatrix");
+    const mat4& inverted = cached.invertedCoordinatePointMatrix;
 
     double flippedY = size.height - point.y;
 
@@ -267,13 +307,22 @@ LatLng TransformState::screenCoordinateToLatLng(const ScreenCoordinate& point, L
     return Projection::unproject(util::interpolate(p0, p1, t), scale / util::tileSize, wrapMode);
 }
 
-mat4 TransformState::coordinatePointMatrix(double z) const {
-    mat4 proj;
-    getProjMatrix(proj);
-    float s = Projection::worldSize(scale) / std::pow(2, z);
-    matrix::scale(proj, proj, s, s, 1);
-    matrix::multiply(proj, getPixelMatrix(), proj);
-    return proj;
+std::vector<ScreenCoordinate> TransformState::latLngsToScreenCoordinates(const std::vector<LatLng>& latLngs) const {
+    std::vector<ScreenCoordinate> result;
+    result.reserve(latLngs.size());
+    for (const auto& latLng : latLngs) {
+        result.push_back(latLngToScreenCoordinate(latLng));
+    }
+    return result;
+}
+
+std::vector<LatLng> TransformState::screenCoordinatesToLatLngs(const std::vector<ScreenCoordinate>& points, LatLng::WrapMode wrapMode) const {
+    std::vector<LatLng> result;
+    result.reserve(points.size());
+    for (const auto& point : points) {
+        result.push_back(screenCoordinateToLatLng(point, wrapMode));
+    }
+    return result;
 }
 
 mat4 TransformState::getPixelMatrix() const {
@@ -6,11 +6,13 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/projection.hpp>
 #include <mbgl/util/mat4.hpp>
+#include <mbgl/util/optional.hpp>
 #include <mbgl/util/size.hpp>
 
 #include <cstdint>
 #include <array>
 #include <limits>
+#include <vector>
 
 namespace mbgl {
 
@@ -24,6 +26,9 @@ public:
 
     // Matrix
     void matrixFor(mat4&, const UnwrappedTileID&) const;
+    // The matrix of the tile, with the given projection matrix applied: the same as
+    // multiplying them, for a fraction of the operations.
+    void matrixFor(mat4&, const UnwrappedTileID&, const mat4& projMatrix) const;
     void getProjMatrix(mat4& matrix) const;
 
     // Dimensions
@@ -70,6 +75,8 @@ public:
     // Conversion
     ScreenCoordinate latLngToScreenCoordinate(const LatLng&) const;
     LatLng screenCoordinateToLatLng(const ScreenCoordinate&, LatLng::WrapMode = LatLng::Unwrapped) const;
+    std::vector<ScreenCoordinate> latLngsToScreenCoordinates(const std::vector<LatLng>&) const;
+    std::vector<LatLng> screenCoordinatesToLatLngs(const std::vector<ScreenCoordinate>&, LatLng::WrapMode = LatLng::Unwrapped) const;
 
     double zoomScale(double zoom) const;
     double scaleZoom(double scale) const;
@@ -87,9 +94,25 @@ private:
     // logical dimensions
     Size size;
 
-    mat4 coordinatePointMatrix(double z) const;
+    void computeProjMatrix(mat4&) const;
     mat4 getPixelMatrix() const;
 
+    // The matrices of the state they were last computed for. Frames and conversions
+    // between screen and map coordinates share them until the state changes.
+    struct Matrices {
+        Size size;
+        double x, y, angle, scale, fov, pitch;
+        NorthOrientation orientation;
+        ViewportMode viewportMode;
+
+        mat4 projMatrix;
+        mat4 coordinatePointMatrix;
+        mat4 invertedCoordinatePointMatrix;
+        bool invertible;
+    };
+    const Matrices& getMatrices() const;
+    mutable optional<Matrices> matrices;
+
     /** Recenter the map so that the given coordinate is located at the given
         point on screen. */
     void moveLatLng(const LatLng&, const ScreenCoordinate&);
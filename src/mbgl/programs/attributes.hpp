@@ -14,6 +14,7 @@ namespace attributes {
 MBGL_DEFINE_ATTRIBUTE(int16_t, 2, a_pos);
 MBGL_DEFINE_ATTRIBUTE(int16_t, 2, a_extrude);
 MBGL_DEFINE_ATTRIBUTE(uint16_t, 2, a_texture_pos);
+MBGL_DEFINE_ATTRIBUTE(int16_t, 4, a_normal_ed);
 
 template <std::size_t N>
 struct a_data : gl::Attribute<uint8_t, N> {
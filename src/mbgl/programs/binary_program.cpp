@@ -0,0 +1,56 @@
+#include <mbgl/programs/binary_program.hpp>
+
+#include <protozero/pbf_reader.hpp>
+#include <protozero/pbf_writer.hpp>
+
+#include <stdexcept>
+#include <utility>
+
+namespace mbgl {
+
+BinaryProgram::BinaryProgram(std::string&& data) {
+    bool hasFormat = false, hasCode = false;
+    protozero::pbf_reader pbf(data);
+    while (pbf.next()) {
+        switch (pbf.tag()) {
+        case 1: // format
+            binaryFormat = pbf.get_uint32();
+            hasFormat = true;
+            break;
+        case 2: // code
+            binaryCode = pbf.get_bytes();
+            hasCode = true;
+            break;
+        case 3: // identifier
+            binaryIdentifier = pbf.get_string();
+            break;
+        default:
+            pbf.skip();
+            break;
+        }
+    }
+
+    if (!hasFormat || !hasCode) {
+        throw std::runtime_error("binary program is missing required fields");
+    }
+}
+
+BinaryProgram::BinaryProgram(gl::BinaryProgramFormat binaryFormat_,
+                             std::string&& binaryCode_,
+                             std::string binaryIdentifier_)
+    : binaryFormat(binaryFormat_),
+      binaryCode(std::move(binaryCode_)),
+      binaryIdentifier(std::move(binaryIdentifier_)) {
+}
+
+std::string BinaryProgram::serialize() const {
+    std::string data;
+    data.reserve(32 + binaryCode.size() + binaryIdentifier.size());
+    protozero::pbf_writer pbf(data);
+    pbf.add_uint32(1 /* format */, binaryFormat);
+    pbf.add_bytes(2 /* code */, binaryCode);
+    pbf.add_string(3 /* identifier */, binaryIdentifier);
+    return data;
+}
+
+} // namespace mbgl
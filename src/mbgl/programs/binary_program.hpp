@@ -0,0 +1,39 @@
+#pragma once
+
+#include <mbgl/gl/types.hpp>
+
+#include <string>
+
+namespace mbgl {
+
+// A linked program as saved in the program cache, along with what it was built from.
+class BinaryProgram {
+public:
+    // Parses a serialized program; throws if it is malformed.
+    explicit BinaryProgram(std::string&& data);
+
+    BinaryProgram(gl::BinaryProgramFormat, std::string&& code, std::string identifier);
+
+    std::string serialize() const;
+
+    gl::BinaryProgramFormat format() const {
+        return binaryFormat;
+    }
+
+    const std::string& code() const {
+        return binaryCode;
+    }
+
+    // Identifies the shader sources and the driver the program was built with; a program
+    // is only usable if both are unchanged.
+    const std::string& identifier() const {
+        return binaryIdentifier;
+    }
+
+private:
+    gl::BinaryProgramFormat binaryFormat = 0;
+    std::string binaryCode;
+    std::string binaryIdentifier;
+};
+
+} // namespace mbgl
@@ -1,7 +1,29 @@
 #include <mbgl/programs/circle_program.hpp>
 
+#include <cassert>
+
 namespace mbgl {
 
 static_assert(sizeof(CircleLayoutVertex) == 4, "expected CircleLayoutVertex size");
+static_assert(sizeof(CircleQuadVertex) == 4, "expected CircleQuadVertex size");
+static_assert(sizeof(CircleInstanceVertex) == 4, "expected CircleInstanceVertex size");
+
+namespace shaders {
+
+static std::string instancedVertexSource() {
+    const std::string declaration = "attribute vec2 a_pos;\n";
+    std::string source = circle::vertexSource;
+    assert(source.find(declaration) != std::string::npos);
+    source.replace(source.find(declaration), declaration.size(),
+        "attribute vec2 a_extrude;\n"
+        "attribute vec2 a_center;\n"
+        "#define a_pos (a_center + a_extrude)\n");
+    return source;
+}
+
+const char* circle_instanced::name = "circle_instanced";
+const std::string circle_instanced::vertexSource = instancedVertexSource();
+const char* circle_instanced::fragmentSource = circle::fragmentSource;
 
+} // namespace shaders
 } // namespace mbgl
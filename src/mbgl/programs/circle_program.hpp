@@ -7,12 +7,31 @@
 #include <mbgl/util/geometry.hpp>
 #include <mbgl/style/layers/circle_layer_properties.hpp>
 
+#include <string>
+
 namespace mbgl {
 
 namespace uniforms {
 MBGL_DEFINE_UNIFORM_SCALAR(bool, u_scale_with_map);
 } // namespace uniforms
 
+namespace attributes {
+MBGL_DEFINE_ATTRIBUTE(int16_t, 2, a_center);
+} // namespace attributes
+
+namespace shaders {
+
+// The circle shaders, with `a_pos` put together from the circle's `a_center` and the
+// corner of the shared quad in `a_extrude`, so that the rest of the program stays as is.
+class circle_instanced {
+public:
+    static const char* name;
+    static const std::string vertexSource;
+    static const char* fragmentSource;
+};
+
+} // namespace shaders
+
 class CircleProgram : public Program<
     shaders::circle,
     gl::Triangle,
@@ -43,7 +62,58 @@ public:
     }
 };
 
+/*
+    Draws every circle of a bucket as an instance of one quad. Per vertex, `a_extrude` is
+    the corner of the quad, 0 or 1 on each axis; per instance, `a_center` is the circle's
+    position times two, and the paint attributes hold one value per circle. Adding them
+    gives the `a_pos` of `CircleProgram::vertex`.
+*/
+class CircleInstancedProgram : public Program<
+    shaders::circle_instanced,
+    gl::Triangle,
+    gl::Attributes<
+        attributes::a_extrude,
+        attributes::a_center>,
+    gl::Uniforms<
+        uniforms::u_matrix,
+        uniforms::u_scale_with_map,
+        uniforms::u_extrude_scale>,
+    style::CirclePaintProperties>
+{
+public:
+    using Program::Program;
+
+    using QuadAttributes = gl::Attributes<attributes::a_extrude>;
+    using QuadVertex = QuadAttributes::Vertex;
+
+    using InstanceAttributes = gl::Attributes<attributes::a_center>;
+    using InstanceVertex = InstanceAttributes::Vertex;
+
+    static QuadVertex quadVertex(int16_t ex, int16_t ey) {
+        return QuadVertex { {{ ex, ey }} };
+    }
+
+    static InstanceVertex instanceVertex(Point<int16_t> p) {
+        return InstanceVertex {
+            {{
+                static_cast<int16_t>(p.x * 2),
+                static_cast<int16_t>(p.y * 2)
+            }}
+        };
+    }
+
+    static LayoutAttributes::Bindings layoutBindings(const gl::VertexBuffer<QuadVertex>& quad,
+                                                     const gl::VertexBuffer<InstanceVertex>& instances) {
+        return QuadAttributes::allVariableBindings(quad)
+            .concat(InstanceAttributes::perInstance(InstanceAttributes::allVariableBindings(instances)));
+    }
+};
+
 using CircleLayoutVertex = CircleProgram::LayoutVertex;
 using CircleAttributes = CircleProgram::Attributes;
 
+using CircleQuadVertex = CircleInstancedProgram::QuadVertex;
+using CircleInstanceVertex = CircleInstancedProgram::InstanceVertex;
+using CircleInstancedAttributes = CircleInstancedProgram::Attributes;
+
 } // namespace mbgl
@@ -0,0 +1,27 @@
+#include <mbgl/programs/fill_extrusion_program.hpp>
+#include <mbgl/util/constants.hpp>
+
+namespace mbgl {
+
+static_assert(sizeof(FillExtrusionLayoutVertex) == 12, "expected FillExtrusionLayoutVertex size");
+
+FillExtrusionUniforms::Values FillExtrusionUniforms::values(mat4 matrix) {
+    // The light's position in spherical coordinates: its distance from the center, its
+    // azimuth from the top of the viewport, and its angle from straight up.
+    const float radial = 1.15f;
+    const float azimuthal = (210.0f + 90.0f) * util::DEG2RAD;
+    const float polar = 30.0f * util::DEG2RAD;
+
+    return FillExtrusionUniforms::Values {
+        uniforms::u_matrix::Value{ matrix },
+        uniforms::u_lightcolor::Value{ {{ 1.0f, 1.0f, 1.0f }} },
+        uniforms::u_lightpos::Value{ {{
+            radial * std::cos(azimuthal) * std::sin(polar),
+            radial * std::sin(azimuthal) * std::sin(polar),
+            radial * std::cos(polar)
+        }} },
+        uniforms::u_lightintensity::Value{ 0.5f }
+    };
+}
+
+} // namespace mbgl
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <mbgl/programs/program.hpp>
+#include <mbgl/programs/attributes.hpp>
+#include <mbgl/programs/uniforms.hpp>
+#include <mbgl/shaders/fill_extrusion.hpp>
+#include <mbgl/util/geometry.hpp>
+#include <mbgl/util/mat4.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer_properties.hpp>
+
+#include <cmath>
+#include <cstdint>
+
+namespace mbgl {
+
+namespace uniforms {
+MBGL_DEFINE_UNIFORM_VECTOR(float, 3, u_lightcolor);
+MBGL_DEFINE_UNIFORM_VECTOR(float, 3, u_lightpos);
+MBGL_DEFINE_UNIFORM_SCALAR(float, u_lightintensity);
+} // namespace uniforms
+
+struct FillExtrusionLayoutAttributes : gl::Attributes<
+    attributes::a_pos,
+    attributes::a_normal_ed>
+{};
+
+struct FillExtrusionUniforms : gl::Uniforms<
+    uniforms::u_matrix,
+    uniforms::u_lightcolor,
+    uniforms::u_lightpos,
+    uniforms::u_lightintensity>
+{
+    // Lit by the style specification's default light, anchored to the viewport, until
+    // styles can set one.
+    static Values values(mat4 matrix);
+};
+
+class FillExtrusionProgram : public Program<
+    shaders::fill_extrusion,
+    gl::Triangle,
+    FillExtrusionLayoutAttributes,
+    FillExtrusionUniforms,
+    style::FillExtrusionPaintProperties>
+{
+public:
+    using Program::Program;
+
+    // The normal is a unit vector, which the shader takes in units of 1/16384. Its x
+    // component is rounded to an even number to hold `top`, which places the vertex at the
+    // extrusion's height rather than at its base. `edgeDistance` is how far along its ring
+    // the vertex of a wall is, in tile units.
+    static LayoutVertex layoutVertex(Point<int16_t> p, double nx, double ny, double nz, bool top, int16_t edgeDistance) {
+        const double factor = std::pow(2, 13);
+
+        return LayoutVertex {
+            {{
+                p.x,
+                p.y
+            }},
+            {{
+                // The multiplication by 2 is to make room for the top bit.
+                static_cast<int16_t>(std::floor(nx * factor) * 2 + top),
+                static_cast<int16_t>(ny * factor * 2),
+                static_cast<int16_t>(nz * factor * 2),
+
+                edgeDistance
+            }}
+        };
+    }
+};
+
+using FillExtrusionLayoutVertex = FillExtrusionProgram::LayoutVertex;
+using FillExtrusionAttributes = FillExtrusionProgram::Attributes;
+
+} // namespace mbgl
@@ -3,12 +3,64 @@
 #include <mbgl/style/cross_faded_property_evaluator.hpp>
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/map/transform_state.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <cassert>
 
 namespace mbgl {
 
 using namespace style;
 
 static_assert(sizeof(FillLayoutVertex) == 4, "expected FillLayoutVertex size");
+static_assert(sizeof(FillBatchedLayoutVertex) == 6, "expected FillBatchedLayoutVertex size");
+
+constexpr std::size_t FillBatchedProgram::maxTiles;
+
+namespace shaders {
+
+static void replace(std::string& source, const std::string& from, const std::string& to) {
+    assert(source.find(from) != std::string::npos);
+    source.replace(source.find(from), from.size(), to);
+}
+
+static std::string batchedVertexSource() {
+    std::string source = fill::vertexSource;
+    replace(source, "uniform mat4 u_matrix;\n",
+        "uniform mat4 u_matrices[" + util::toString(FillBatchedProgram::maxTiles) + "];\n"
+        "attribute float a_tile;\n"
+        "varying highp vec2 v_tile_pos;\n");
+    replace(source, "gl_Position = u_matrix * vec4(a_pos, 0, 1);",
+        "gl_Position = u_matrices[int(a_tile)] * vec4(a_pos, 0, 1);\n"
+        "    v_tile_pos = a_pos;");
+    return source;
+}
+
+static std::string batchedFragmentSource() {
+    std::string source = fill::fragmentSource;
+    // The tile's extent is half-open, so that pixels on the edge between two tiles are
+    // only drawn once.
+    replace(source, "varying lowp float opacity;\n",
+        "varying lowp float opacity;\n"
+        "#if defined(GL_ES) && !defined(GL_FRAGMENT_PRECISION_HIGH)\n"
+        "varying mediump vec2 v_tile_pos;\n"
+        "#else\n"
+        "varying highp vec2 v_tile_pos;\n"
+        "#endif\n");
+    replace(source, "void main() {\n",
+        "void main() {\n"
+        "    if (any(lessThan(v_tile_pos, vec2(0.0))) ||\n"
+        "        any(greaterThanEqual(v_tile_pos, vec2(" + util::toString(util::EXTENT) + ".0)))) {\n"
+        "        discard;\n"
+        "    }\n");
+    return source;
+}
+
+const char* fill_batched::name = "fill_batched";
+const std::string fill_batched::vertexSource = batchedVertexSource();
+const std::string fill_batched::fragmentSource = batchedFragmentSource();
+
+} // namespace shaders
 
 FillPatternUniforms::Values
 FillPatternUniforms::values(mat4 matrix,
@@ -25,14 +25,31 @@ template <class> class Faded;
 } // namespace style
 
 namespace uniforms {
-MBGL_DEFINE_UNIFORM_SCALAR(Size,     u_world);
 MBGL_DEFINE_UNIFORM_SCALAR(float,    u_scale_a);
 MBGL_DEFINE_UNIFORM_SCALAR(float,    u_scale_b);
 MBGL_DEFINE_UNIFORM_SCALAR(float,    u_tile_units_to_pixels);
 MBGL_DEFINE_UNIFORM_VECTOR(float, 2, u_pixel_coord_upper);
 MBGL_DEFINE_UNIFORM_VECTOR(float, 2, u_pixel_coord_lower);
+MBGL_DEFINE_UNIFORM_MATRIX_ARRAY(double, 4, u_matrices);
 } // namespace uniforms
 
+namespace attributes {
+MBGL_DEFINE_ATTRIBUTE(uint16_t, 1, a_tile);
+} // namespace attributes
+
+namespace shaders {
+
+// The fill shaders, with `u_matrix` picked per vertex from `u_matrices` by `a_tile`, and
+// fragments outside of the vertex's tile discarded.
+class fill_batched {
+public:
+    static const char* name;
+    static const std::string vertexSource;
+    static const std::string fragmentSource;
+};
+
+} // namespace shaders
+
 struct FillLayoutAttributes : gl::Attributes<
     attributes::a_pos>
 {};
@@ -121,7 +138,42 @@ public:
     using Program::Program;
 };
 
+/*
+    Draws the fills of up to `maxTiles` tiles of a layer at once. `a_tile` is the index of
+    the vertex's tile in `u_matrices`. Tiles are clipped to their own extent in the shader,
+    instead of with the stencil buffer, which is only equivalent for tiles that no other
+    rendered tile of the source overlaps.
+*/
+class FillBatchedProgram : public Program<
+    shaders::fill_batched,
+    gl::Triangle,
+    gl::Attributes<
+        attributes::a_pos,
+        attributes::a_tile>,
+    gl::Uniforms<
+        uniforms::u_matrices,
+        uniforms::u_world>,
+    style::FillPaintProperties>
+{
+public:
+    using Program::Program;
+
+    // WebGL and OpenGL ES 2 guarantee 128 vertex uniform vectors; this leaves half of them
+    // for the matrices.
+    static constexpr std::size_t maxTiles = 16;
+
+    static LayoutVertex layoutVertex(const FillProgram::LayoutVertex& vertex, uint16_t tile) {
+        return LayoutVertex {
+            vertex.a1,
+            {{ tile }}
+        };
+    }
+};
+
 using FillLayoutVertex = FillProgram::LayoutVertex;
 using FillAttributes = FillProgram::Attributes;
 
+using FillBatchedLayoutVertex = FillBatchedProgram::LayoutVertex;
+using FillBatchedAttributes = FillBatchedProgram::Attributes;
+
 } // namespace mbgl
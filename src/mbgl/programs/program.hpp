@@ -1,10 +1,17 @@
 #pragma once
 
 #include <mbgl/gl/program.hpp>
+#include <mbgl/programs/binary_program.hpp>
 #include <mbgl/programs/program_parameters.hpp>
+#include <mbgl/programs/shader_variant.hpp>
 #include <mbgl/programs/attributes.hpp>
 #include <mbgl/style/paint_property.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/logging.hpp>
+#include <mbgl/util/string.hpp>
 
+#include <functional>
+#include <map>
 #include <sstream>
 #include <cassert>
 
@@ -29,13 +36,66 @@ public:
     using AllUniforms = gl::ConcatenateUniforms<Uniforms, PaintUniforms>;
 
     using ProgramType = gl::Program<Primitive, Attributes, AllUniforms>;
+    using Variant = typename PaintPropertyBinders::Variant;
 
-    ProgramType program;
+    // Variants are compiled when first drawn with, so the constructor only keeps the
+    // parameters to compile them with.
+    explicit Program(const ProgramParameters& programParameters_)
+        : programParameters(programParameters_)
+        {}
 
-    Program(gl::Context& context, const ProgramParameters& programParameters)
-        : program(context, vertexSource(programParameters), fragmentSource(programParameters))
+    Program(gl::Context&, const ProgramParameters& programParameters_)
+        : Program(programParameters_)
         {}
 
+    // The program specialized for the paint properties whose bit in `variant` is clear, which
+    // don't interpolate between zoom levels; see `PaintPropertyBinders::variant`.
+    ProgramType& get(gl::Context& context, Variant variant) {
+        auto it = variants.find(variant);
+        if (it == variants.end()) {
+            it = variants.emplace(variant, createProgram(context, programParameters, variant)).first;
+        }
+        return it->second;
+    }
+
+    // Loads the program from the cache when it holds one linked from the same sources by
+    // the same driver, and compiles it otherwise, adding it to the cache.
+    static ProgramType createProgram(gl::Context& context, const ProgramParameters& parameters, Variant variant) {
+        const std::string vertex = vertexSource(parameters, variant);
+        const std::string fragment = fragmentSource(parameters);
+
+        const std::string name = std::string(Shaders::name) + "." + util::toString(variant);
+        const optional<std::string> cachePath = parameters.cachePath(name.c_str());
+        if (!cachePath || !context.supportsProgramBinaries()) {
+            return ProgramType { context, vertex, fragment };
+        }
+
+        const std::string identifier = util::toString(std::hash<std::string>()(vertex + fragment)) +
+                                       "\n" + context.getDriverDescription();
+
+        if (optional<std::string> cached = util::readFile(*cachePath)) {
+            try {
+                const BinaryProgram binaryProgram(std::move(*cached));
+                if (binaryProgram.identifier() == identifier) {
+                    return ProgramType { context, binaryProgram.format(), binaryProgram.code() };
+                }
+            } catch (const std::exception& error) {
+                Log::Warning(Event::OpenGL, "Cached program %s is unusable: %s", Shaders::name, error.what());
+            }
+        }
+
+        ProgramType result { context, vertex, fragment };
+        try {
+            if (auto binary = result.getBinaryProgram(context)) {
+                util::write_file(*cachePath,
+                                 BinaryProgram(binary->first, std::move(binary->second), identifier).serialize());
+            }
+        } catch (const std::exception& error) {
+            Log::Warning(Event::OpenGL, "Failed to cache program %s: %s", Shaders::name, error.what());
+        }
+        return result;
+    }
+
     static std::string pixelRatioDefine(const ProgramParameters& parameters) {
         std::ostringstream pixelRatioSS;
         pixelRatioSS.imbue(std::locale("C"));
@@ -53,8 +113,15 @@ public:
         return source;
     }
 
-    static std::string vertexSource(const ProgramParameters& parameters) {
-        return pixelRatioDefine(parameters) + Shaders::vertexSource;
+    static std::string vertexSource(const ProgramParameters& parameters, Variant variant) {
+        const std::vector<std::string> names = PaintPropertyBinders::attributeNames();
+        std::vector<std::string> constant;
+        for (std::size_t i = 0; i < names.size(); i++) {
+            if (!(variant & (Variant(1) << i))) {
+                constant.push_back(names[i]);
+            }
+        }
+        return pixelRatioDefine(parameters) + specializeVertexSource(Shaders::vertexSource, constant);
     }
 
     template <class DrawMode>
@@ -70,7 +137,7 @@ public:
               const PaintPropertyBinders& paintPropertyBinders,
               const typename PaintProperties::Evaluated& currentProperties,
               float currentZoom) {
-        program.draw(
+        get(context, paintPropertyBinders.variant(currentProperties)).draw(
             context,
             std::move(drawMode),
             std::move(depthMode),
@@ -84,6 +151,73 @@ public:
             segments
         );
     }
+
+    // As above, with the layout bindings supplied by the caller, for layout attributes that
+    // come from more than one buffer.
+    template <class DrawMode>
+    void draw(gl::Context& context,
+              DrawMode drawMode,
+              gl::DepthMode depthMode,
+              gl::StencilMode stencilMode,
+              gl::ColorMode colorMode,
+              UniformValues&& uniformValues,
+              typename LayoutAttributes::Bindings&& layoutBindings,
+              const gl::IndexBuffer<DrawMode>& indexBuffer,
+              const gl::SegmentVector<Attributes>& segments,
+              const PaintPropertyBinders& paintPropertyBinders,
+              const typename PaintProperties::Evaluated& currentProperties,
+              float currentZoom) {
+        get(context, paintPropertyBinders.variant(currentProperties)).draw(
+            context,
+            std::move(drawMode),
+            std::move(depthMode),
+            std::move(stencilMode),
+            std::move(colorMode),
+            uniformValues
+                .concat(paintPropertyBinders.uniformValues(currentZoom)),
+            layoutBindings
+                .concat(paintPropertyBinders.attributeBindings(currentProperties)),
+            indexBuffer,
+            segments
+        );
+    }
+
+    // Draws `instanceCount` instances of the geometry in `indexBuffer`. The layout bindings
+    // are supplied by the caller, since they come from more than one buffer; paint
+    // attributes hold one value per instance.
+    template <class DrawMode>
+    void drawInstanced(gl::Context& context,
+                       DrawMode drawMode,
+                       gl::DepthMode depthMode,
+                       gl::StencilMode stencilMode,
+                       gl::ColorMode colorMode,
+                       UniformValues&& uniformValues,
+                       typename LayoutAttributes::Bindings&& layoutBindings,
+                       std::size_t instanceCount,
+                       const gl::IndexBuffer<DrawMode>& indexBuffer,
+                       const gl::SegmentVector<Attributes>& segments,
+                       const PaintPropertyBinders& paintPropertyBinders,
+                       const typename PaintProperties::Evaluated& currentProperties,
+                       float currentZoom) {
+        get(context, paintPropertyBinders.variant(currentProperties)).drawInstanced(
+            context,
+            std::move(drawMode),
+            std::move(depthMode),
+            std::move(stencilMode),
+            std::move(colorMode),
+            uniformValues
+                .concat(paintPropertyBinders.uniformValues(currentZoom)),
+            layoutBindings
+                .concat(PaintAttributes::perInstance(paintPropertyBinders.attributeBindings(currentProperties))),
+            indexBuffer,
+            segments,
+            instanceCount
+        );
+    }
+
+private:
+    const ProgramParameters programParameters;
+    std::map<Variant, ProgramType> variants;
 };
 
 } // namespace mbgl
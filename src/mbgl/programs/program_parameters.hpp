@@ -1,16 +1,35 @@
 #pragma once
 
+#include <mbgl/util/optional.hpp>
+
+#include <string>
+#include <utility>
+
 namespace mbgl {
 
 class ProgramParameters {
 public:
-    ProgramParameters(float pixelRatio_ = 1.0, bool overdraw_ = false)
+    ProgramParameters(float pixelRatio_ = 1.0,
+                      bool overdraw_ = false,
+                      optional<std::string> cacheDir_ = {})
       : pixelRatio(pixelRatio_),
-        overdraw(overdraw_) {}
+        overdraw(overdraw_),
+        cacheDir(std::move(cacheDir_)) {}
+
+    // Where the binary of the named program is cached, if programs are cached.
+    optional<std::string> cachePath(const char* name) const {
+        if (!cacheDir) {
+            return {};
+        }
+        return *cacheDir + "/com.mapbox.gl.shader." + name + (overdraw ? ".overdraw.pbf" : ".pbf");
+    }
 
     float pixelRatio;
     bool overdraw;
+
+    // Directory in which linked programs are saved, so that later runs can skip compiling
+    // them. Caching is disabled without one.
+    optional<std::string> cacheDir;
 };
 
 } // namespace mbgl
-
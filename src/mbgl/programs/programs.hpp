@@ -2,49 +2,91 @@
 
 #include <mbgl/programs/circle_program.hpp>
 #include <mbgl/programs/fill_program.hpp>
+#include <mbgl/programs/fill_extrusion_program.hpp>
+#include <mbgl/programs/extrusion_texture_program.hpp>
 #include <mbgl/programs/line_program.hpp>
 #include <mbgl/programs/raster_program.hpp>
 #include <mbgl/programs/symbol_program.hpp>
 #include <mbgl/programs/debug_program.hpp>
 #include <mbgl/programs/collision_box_program.hpp>
 #include <mbgl/programs/program_parameters.hpp>
+#include <mbgl/util/optional.hpp>
 
 namespace mbgl {
 
+// Each program is compiled the first time it is used, so that a style only pays for the
+// programs its layers need. They are compiled by the context they are drawn with, so they can
+// be shared by the contexts of a share group.
 class Programs {
 public:
-    Programs(gl::Context& context, const ProgramParameters& programParameters)
-        : circle(context, programParameters),
-          fill(context, programParameters),
-          fillPattern(context, programParameters),
-          fillOutline(context, programParameters),
-          fillOutlinePattern(context, programParameters),
-          line(context, programParameters),
-          lineSDF(context, programParameters),
-          linePattern(context, programParameters),
-          raster(context, programParameters),
-          symbolIcon(context, programParameters),
-          symbolIconSDF(context, programParameters),
-          symbolGlyph(context, programParameters),
-          debug(context, ProgramParameters(programParameters.pixelRatio, false)),
-          collisionBox(context, ProgramParameters(programParameters.pixelRatio, false)) {
+    explicit Programs(const ProgramParameters& programParameters_)
+        : programParameters(programParameters_),
+          debugParameters(programParameters.pixelRatio, false, programParameters.cacheDir) {
     }
 
-    CircleProgram circle;
-    FillProgram fill;
-    FillPatternProgram fillPattern;
-    FillOutlineProgram fillOutline;
-    FillOutlinePatternProgram fillOutlinePattern;
-    LineProgram line;
-    LineSDFProgram lineSDF;
-    LinePatternProgram linePattern;
-    RasterProgram raster;
-    SymbolIconProgram symbolIcon;
-    SymbolSDFIconProgram symbolIconSDF;
-    SymbolSDFTextProgram symbolGlyph;
-
-    DebugProgram debug;
-    CollisionBoxProgram collisionBox;
+    CircleProgram& circle() { return get(circleProgram); }
+    CircleInstancedProgram& circleInstanced() { return get(circleInstancedProgram); }
+    FillProgram& fill() { return get(fillProgram); }
+    FillBatchedProgram& fillBatched() { return get(fillBatchedProgram); }
+    FillPatternProgram& fillPattern() { return get(fillPatternProgram); }
+    FillOutlineProgram& fillOutline() { return get(fillOutlineProgram); }
+    FillOutlinePatternProgram& fillOutlinePattern() { return get(fillOutlinePatternProgram); }
+    FillExtrusionProgram& fillExtrusion() { return get(fillExtrusionProgram); }
+    ExtrusionTextureProgram& extrusionTexture() { return get(extrusionTextureProgram); }
+    LineProgram& line() { return get(lineProgram); }
+    LineSDFProgram& lineSDF() { return get(lineSDFProgram); }
+    LinePatternProgram& linePattern() { return get(linePatternProgram); }
+    RasterProgram& raster() { return get(rasterProgram); }
+    SymbolIconProgram& symbolIcon() { return get(symbolIconProgram); }
+    SymbolSDFIconProgram& symbolIconSDF() { return get(symbolIconSDFProgram); }
+    SymbolSDFTextProgram& symbolGlyph() { return get(symbolGlyphProgram); }
+    SymbolIconInstancedProgram& symbolIconInstanced() { return get(symbolIconInstancedProgram); }
+    SymbolSDFIconInstancedProgram& symbolIconSDFInstanced() { return get(symbolIconSDFInstancedProgram); }
+    SymbolSDFTextInstancedProgram& symbolGlyphInstanced() { return get(symbolGlyphInstancedProgram); }
+
+    // Debug programs never use the overdraw inspector.
+    DebugProgram& debug() { return get(debugProgram, debugParameters); }
+    CollisionBoxProgram& collisionBox() { return get(collisionBoxProgram, debugParameters); }
+
+private:
+    template <class P>
+    P& get(optional<P>& program) {
+        return get(program, programParameters);
+    }
+
+    template <class P>
+    P& get(optional<P>& program, const ProgramParameters& parameters) {
+        if (!program) {
+            program.emplace(parameters);
+        }
+        return *program;
+    }
+
+    const ProgramParameters programParameters;
+    const ProgramParameters debugParameters;
+
+    optional<CircleProgram> circleProgram;
+    optional<CircleInstancedProgram> circleInstancedProgram;
+    optional<FillProgram> fillProgram;
+    optional<FillBatchedProgram> fillBatchedProgram;
+    optional<FillPatternProgram> fillPatternProgram;
+    optional<FillOutlineProgram> fillOutlineProgram;
+    optional<FillOutlinePatternProgram> fillOutlinePatternProgram;
+    optional<FillExtrusionProgram> fillExtrusionProgram;
+    optional<ExtrusionTextureProgram> extrusionTextureProgram;
+    optional<LineProgram> lineProgram;
+    optional<LineSDFProgram> lineSDFProgram;
+    optional<LinePatternProgram> linePatternProgram;
+    optional<RasterProgram> rasterProgram;
+    optional<SymbolIconProgram> symbolIconProgram;
+    optional<SymbolSDFIconProgram> symbolIconSDFProgram;
+    optional<SymbolSDFTextProgram> symbolGlyphProgram;
+    optional<SymbolIconInstancedProgram> symbolIconInstancedProgram;
+    optional<SymbolSDFIconInstancedProgram> symbolIconSDFInstancedProgram;
+    optional<SymbolSDFTextInstancedProgram> symbolGlyphInstancedProgram;
+
+    optional<DebugProgram> debugProgram;
+    optional<CollisionBoxProgram> collisionBoxProgram;
 };
 
 } // namespace mbgl
@@ -21,6 +21,8 @@ MBGL_DEFINE_UNIFORM_SCALAR(float, u_contrast_factor);
 MBGL_DEFINE_UNIFORM_SCALAR(float, u_scale_parent);
 MBGL_DEFINE_UNIFORM_VECTOR(float, 3, u_spin_weights);
 MBGL_DEFINE_UNIFORM_VECTOR(float, 2, u_tl_parent);
+MBGL_DEFINE_UNIFORM_VECTOR(float, 2, u_tex_offset);
+MBGL_DEFINE_UNIFORM_VECTOR(float, 2, u_tex_scale);
 } // namespace uniforms
 
 class RasterProgram : public Program<
@@ -42,7 +44,9 @@ class RasterProgram : public Program<
         uniforms::u_spin_weights,
         uniforms::u_buffer_scale,
         uniforms::u_scale_parent,
-        uniforms::u_tl_parent>,
+        uniforms::u_tl_parent,
+        uniforms::u_tex_offset,
+        uniforms::u_tex_scale>,
     style::RasterPaintProperties>
 {
 public:
@@ -0,0 +1,62 @@
+#include <mbgl/programs/shader_variant.hpp>
+
+namespace mbgl {
+
+namespace {
+
+bool isIdentifierChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// The positions of `name` in `source` as a whole identifier.
+std::vector<std::size_t> findIdentifier(const std::string& source, const std::string& name) {
+    std::vector<std::size_t> result;
+    for (std::size_t pos = source.find(name); pos != std::string::npos; pos = source.find(name, pos + 1)) {
+        const std::size_t end = pos + name.size();
+        if ((pos == 0 || !isIdentifierChar(source[pos - 1])) &&
+            (end == source.size() || !isIdentifierChar(source[end]))) {
+            result.push_back(pos);
+        }
+    }
+    return result;
+}
+
+// Removes the line declaring `name`, if that is the only place it is used.
+void removeUnusedDeclaration(std::string& source, const std::string& name) {
+    const std::vector<std::size_t> uses = findIdentifier(source, name);
+    if (uses.size() != 1) {
+        return;
+    }
+    const std::size_t begin = source.rfind('\n', uses.front());
+    const std::size_t end = source.find('\n', uses.front());
+    const std::size_t lineBegin = begin == std::string::npos ? 0 : begin + 1;
+    const std::string line = source.substr(lineBegin, end == std::string::npos ? std::string::npos : end - lineBegin);
+    if (line.compare(0, 8, "uniform ") == 0 || line.compare(0, 10, "attribute ") == 0) {
+        source.erase(lineBegin, end == std::string::npos ? std::string::npos : end + 1 - lineBegin);
+    }
+}
+
+} // namespace
+
+std::string specializeVertexSource(std::string source, const std::vector<std::string>& attributes) {
+    for (const auto& attribute : attributes) {
+        const std::string min = attribute + "_min";
+        const std::string max = attribute + "_max";
+        const std::string t = attribute + "_t";
+        const std::string mix = "mix(" + min + ", " + max + ", " + t + ")";
+
+        bool mixed = false;
+        for (std::size_t pos = source.find(mix); pos != std::string::npos; pos = source.find(mix, pos)) {
+            source.replace(pos, mix.size(), min);
+            mixed = true;
+        }
+
+        if (mixed) {
+            removeUnusedDeclaration(source, max);
+            removeUnusedDeclaration(source, t);
+        }
+    }
+    return source;
+}
+
+} // namespace mbgl
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// Specializes a generated vertex shader for paint properties that don't interpolate between
+// zoom levels, given the names of their attributes: `mix(a_name_min, a_name_max, a_name_t)`
+// becomes `a_name_min`, and the declarations of `a_name_max` and `a_name_t` are left out
+// once nothing else uses them, so that the attribute isn't fetched and the mix isn't run.
+// Attributes that the source doesn't mix are left as they are.
+std::string specializeVertexSource(std::string source, const std::vector<std::string>& attributes);
+
+} // namespace mbgl
@@ -4,11 +4,74 @@
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/util/enum.hpp>
 
+#include <cassert>
+
 namespace mbgl {
 
 using namespace style;
 
 static_assert(sizeof(SymbolLayoutVertex) == 16, "expected SymbolLayoutVertex size");
+static_assert(sizeof(SymbolPlacementVertex) == 2, "expected SymbolPlacementVertex size");
+static_assert(sizeof(SymbolQuadVertex) == 4, "expected SymbolQuadVertex size");
+static_assert(sizeof(SymbolInstanceVertex) == 28, "expected SymbolInstanceVertex size");
+
+namespace shaders {
+
+static void replace(std::string& source, const std::string& from, const std::string& to) {
+    assert(source.find(from) != std::string::npos);
+    source.replace(source.find(from), from.size(), to);
+}
+
+static std::string placedVertexSource(const char* vertexSource) {
+    std::string source = vertexSource;
+    replace(source, "attribute vec4 a_data;\n",
+        "attribute vec4 a_data;\n"
+        "attribute vec2 a_placement;\n");
+    replace(source, "mediump float a_labelminzoom = a_data[0];",
+        "mediump float a_labelminzoom = a_placement[0];");
+    replace(source, "mediump float a_minzoom = a_zoom[0];",
+        "mediump float a_minzoom = a_placement[1];");
+    replace(source, "v_fade_tex = vec2(a_labelminzoom / 255.0, 0.0);\n",
+        "v_fade_tex = vec2(a_labelminzoom / 255.0, 0.0);\n"
+        "    if (a_minzoom >= 255.0) {\n"
+        "        gl_Position = vec4(-2.0, -2.0, -2.0, 1.0);\n"
+        "    }\n");
+    return source;
+}
+
+static std::string instancedVertexSource(const char* vertexSource) {
+    std::string source = placedVertexSource(vertexSource);
+    replace(source,
+        "attribute vec2 a_pos;\n"
+        "attribute vec2 a_offset;\n"
+        "attribute vec2 a_texture_pos;\n",
+        "attribute vec2 a_extrude;\n"
+        "attribute vec2 a_pos;\n"
+        "attribute vec2 a_offset_tl;\n"
+        "attribute vec4 a_offset_tr_bl;\n"
+        "attribute vec4 a_texture_rect;\n"
+        "#define a_offset (a_offset_tl + a_extrude.x * (a_offset_tr_bl.xy - a_offset_tl) + a_extrude.y * (a_offset_tr_bl.zw - a_offset_tl))\n"
+        "#define a_texture_pos mix(a_texture_rect.xy, a_texture_rect.zw, a_extrude)\n");
+    return source;
+}
+
+const char* symbol_icon_placed::name = "symbol_icon_placed";
+const std::string symbol_icon_placed::vertexSource = placedVertexSource(symbol_icon::vertexSource);
+const char* symbol_icon_placed::fragmentSource = symbol_icon::fragmentSource;
+
+const char* symbol_sdf_placed::name = "symbol_sdf_placed";
+const std::string symbol_sdf_placed::vertexSource = placedVertexSource(symbol_sdf::vertexSource);
+const char* symbol_sdf_placed::fragmentSource = symbol_sdf::fragmentSource;
+
+const char* symbol_icon_instanced::name = "symbol_icon_instanced";
+const std::string symbol_icon_instanced::vertexSource = instancedVertexSource(symbol_icon::vertexSource);
+const char* symbol_icon_instanced::fragmentSource = symbol_icon::fragmentSource;
+
+const char* symbol_sdf_instanced::name = "symbol_sdf_instanced";
+const std::string symbol_sdf_instanced::vertexSource = instancedVertexSource(symbol_sdf::vertexSource);
+const char* symbol_sdf_instanced::fragmentSource = symbol_sdf::fragmentSource;
+
+} // namespace shaders
 
 template <class Values, class...Args>
 Values makeValues(const style::SymbolPropertyValues& values,
@@ -12,6 +12,7 @@
 
 #include <cmath>
 #include <array>
+#include <string>
 
 namespace mbgl {
 
@@ -34,19 +35,61 @@ MBGL_DEFINE_UNIFORM_SCALAR(float, u_font_scale);
 MBGL_DEFINE_UNIFORM_SCALAR(float, u_gamma_scale);
 } // namespace uniforms
 
+namespace attributes {
+MBGL_DEFINE_ATTRIBUTE(uint8_t, 2, a_placement);
+MBGL_DEFINE_ATTRIBUTE(int16_t, 2, a_offset_tl);
+MBGL_DEFINE_ATTRIBUTE(int16_t, 4, a_offset_tr_bl);
+MBGL_DEFINE_ATTRIBUTE(uint16_t, 4, a_texture_rect);
+} // namespace attributes
+
+namespace shaders {
+
+// The symbol shaders, with the zoom levels that depend on placement read from
+// `a_placement` instead of `a_data`, and hidden vertices moved out of clip space.
+class symbol_icon_placed {
+public:
+    static const char* name;
+    static const std::string vertexSource;
+    static const char* fragmentSource;
+};
+
+class symbol_sdf_placed {
+public:
+    static const char* name;
+    static const std::string vertexSource;
+    static const char* fragmentSource;
+};
+
+// The placed shaders, with `a_offset` and `a_texture_pos` put together from the corner of
+// the shared quad in `a_extrude` and the quad's corners, so that the rest stays as is.
+class symbol_icon_instanced {
+public:
+    static const char* name;
+    static const std::string vertexSource;
+    static const char* fragmentSource;
+};
+
+class symbol_sdf_instanced {
+public:
+    static const char* name;
+    static const std::string vertexSource;
+    static const char* fragmentSource;
+};
+
+} // namespace shaders
+
 struct SymbolLayoutAttributes : gl::Attributes<
     attributes::a_pos,
     attributes::a_offset<2>,
     attributes::a_texture_pos,
     attributes::a_data<4>>
 {
+    // The zoom levels that depend on placement are left out; see `SymbolPlacementAttributes`.
     static Vertex vertex(Point<float> a,
                          Point<float> o,
                          uint16_t tx,
                          uint16_t ty,
-                         float minzoom,
                          float maxzoom,
-                         float labelminzoom,
                          uint8_t labelangle) {
         return Vertex {
             {{
@@ -62,27 +105,150 @@ struct SymbolLayoutAttributes : gl::Attributes<
                 static_cast<uint16_t>(ty / 4)
             }},
             {{
-                static_cast<uint8_t>(labelminzoom * 10), // 1/10 zoom levels: z16 == 160
+                0,
                 static_cast<uint8_t>(labelangle),
-                static_cast<uint8_t>(minzoom * 10),
-                static_cast<uint8_t>(::fmin(maxzoom, 25) * 10)
+                0,
+                static_cast<uint8_t>(::fmin(maxzoom, 25) * 10) // 1/10 zoom levels: z16 == 160
             }}
         };
     }
 };
 
+/*
+    The part of a symbol vertex that depends on placement, kept in a buffer parallel to the
+    layout vertices so that a new placement replaces only this buffer: the zoom level from
+    which the label is placed and the one from which the vertex is shown, in tenths of zoom
+    levels. A vertex with a minimum zoom level of 255 is hidden.
+*/
+struct SymbolPlacementAttributes : gl::Attributes<
+    attributes::a_placement>
+{
+    static Vertex vertex(float minzoom, float labelminzoom) {
+        return Vertex {
+            {{
+                static_cast<uint8_t>(labelminzoom * 10),
+                static_cast<uint8_t>(minzoom * 10)
+            }}
+        };
+    }
+
+    static Vertex hidden() {
+        return Vertex {
+            {{ 0, 255 }}
+        };
+    }
+};
+
+/*
+    A glyph or icon quad, drawn as an instance of the painter's quad rather than as four
+    vertices of its own: the anchor, the offsets of three corners in 1/64 pixels (the
+    fourth follows, since quads are parallelograms), the corners of its texture and the
+    `a_data` of `SymbolLayoutAttributes`. Placement and paint attributes hold one value
+    per quad.
+*/
+struct SymbolInstanceAttributes : gl::Attributes<
+    attributes::a_pos,
+    attributes::a_offset_tl,
+    attributes::a_offset_tr_bl,
+    attributes::a_texture_rect,
+    attributes::a_data<4>>
+{
+    static Vertex vertex(Point<float> a,
+                         Point<float> tl,
+                         Point<float> tr,
+                         Point<float> bl,
+                         uint16_t tx,
+                         uint16_t ty,
+                         uint16_t tw,
+                         uint16_t th,
+                         float maxzoom,
+                         uint8_t labelangle) {
+        const auto layout = SymbolLayoutAttributes::vertex(a, tl, tx, ty, maxzoom, labelangle);
+        const auto right = SymbolLayoutAttributes::vertex(a, tr, tx + tw, ty + th, maxzoom, labelangle);
+        const auto bottom = SymbolLayoutAttributes::vertex(a, bl, tx, ty, maxzoom, labelangle);
+        return Vertex {
+            layout.a1,
+            layout.a2,
+            {{ right.a2[0], right.a2[1], bottom.a2[0], bottom.a2[1] }},
+            {{ layout.a3[0], layout.a3[1], right.a3[0], right.a3[1] }},
+            layout.a4
+        };
+    }
+
+    // The vertex of `SymbolLayoutAttributes` at a corner of the quad, for drawing without
+    // instancing.
+    static SymbolLayoutAttributes::Vertex corner(const Vertex& quad, bool right, bool bottom) {
+        const auto& tl = quad.a2;
+        const auto& trbl = quad.a3;
+        return SymbolLayoutAttributes::Vertex {
+            quad.a1,
+            {{
+                static_cast<int16_t>(tl[0] + right * (trbl[0] - tl[0]) + bottom * (trbl[2] - tl[0])),
+                static_cast<int16_t>(tl[1] + right * (trbl[1] - tl[1]) + bottom * (trbl[3] - tl[1]))
+            }},
+            {{
+                right ? quad.a4[2] : quad.a4[0],
+                bottom ? quad.a4[3] : quad.a4[1]
+            }},
+            quad.a5
+        };
+    }
+};
+
+using SymbolProgramLayoutAttributes = gl::ConcatenateAttributes<SymbolLayoutAttributes, SymbolPlacementAttributes>;
+
+inline SymbolProgramLayoutAttributes::Bindings
+symbolLayoutBindings(const gl::VertexBuffer<SymbolLayoutAttributes::Vertex>& layout,
+                     const gl::VertexBuffer<SymbolPlacementAttributes::Vertex>& placement) {
+    return SymbolLayoutAttributes::allVariableBindings(layout)
+        .concat(SymbolPlacementAttributes::allVariableBindings(placement));
+}
+
+using SymbolQuadAttributes = gl::Attributes<attributes::a_extrude>;
+
+using SymbolInstancedLayoutAttributes = gl::ConcatenateAttributes<
+    SymbolQuadAttributes,
+    gl::ConcatenateAttributes<SymbolInstanceAttributes, SymbolPlacementAttributes>>;
+
+inline SymbolInstancedLayoutAttributes::Bindings
+symbolInstancedLayoutBindings(const gl::VertexBuffer<SymbolQuadAttributes::Vertex>& quad,
+                              const gl::VertexBuffer<SymbolInstanceAttributes::Vertex>& instances,
+                              const gl::VertexBuffer<SymbolPlacementAttributes::Vertex>& placement) {
+    return SymbolQuadAttributes::allVariableBindings(quad)
+        .concat(SymbolInstanceAttributes::perInstance(SymbolInstanceAttributes::allVariableBindings(instances)))
+        .concat(SymbolPlacementAttributes::perInstance(SymbolPlacementAttributes::allVariableBindings(placement)));
+}
+
+using SymbolIconUniforms = gl::Uniforms<
+    uniforms::u_matrix,
+    uniforms::u_extrude_scale,
+    uniforms::u_texsize,
+    uniforms::u_zoom,
+    uniforms::u_rotate_with_map,
+    uniforms::u_texture,
+    uniforms::u_fadetexture>;
+
+using SymbolSDFUniforms = gl::Uniforms<
+    uniforms::u_matrix,
+    uniforms::u_extrude_scale,
+    uniforms::u_texsize,
+    uniforms::u_zoom,
+    uniforms::u_rotate_with_map,
+    uniforms::u_texture,
+    uniforms::u_fadetexture,
+    uniforms::u_font_scale,
+    uniforms::u_gamma_scale,
+    uniforms::u_pitch,
+    uniforms::u_bearing,
+    uniforms::u_aspect_ratio,
+    uniforms::u_pitch_with_map,
+    uniforms::u_is_halo>;
+
 class SymbolIconProgram : public Program<
-    shaders::symbol_icon,
+    shaders::symbol_icon_placed,
     gl::Triangle,
-    SymbolLayoutAttributes,
-    gl::Uniforms<
-        uniforms::u_matrix,
-        uniforms::u_extrude_scale,
-        uniforms::u_texsize,
-        uniforms::u_zoom,
-        uniforms::u_rotate_with_map,
-        uniforms::u_texture,
-        uniforms::u_fadetexture>,
+    SymbolProgramLayoutAttributes,
+    SymbolIconUniforms,
     style::IconPaintProperties>
 {
 public:
@@ -102,51 +268,21 @@ enum class SymbolSDFPart {
 
 template <class PaintProperties>
 class SymbolSDFProgram : public Program<
-    shaders::symbol_sdf,
+    shaders::symbol_sdf_placed,
     gl::Triangle,
-    SymbolLayoutAttributes,
-    gl::Uniforms<
-        uniforms::u_matrix,
-        uniforms::u_extrude_scale,
-        uniforms::u_texsize,
-        uniforms::u_zoom,
-        uniforms::u_rotate_with_map,
-        uniforms::u_texture,
-        uniforms::u_fadetexture,
-        uniforms::u_font_scale,
-        uniforms::u_gamma_scale,
-        uniforms::u_pitch,
-        uniforms::u_bearing,
-        uniforms::u_aspect_ratio,
-        uniforms::u_pitch_with_map,
-        uniforms::u_is_halo>,
+    SymbolProgramLayoutAttributes,
+    SymbolSDFUniforms,
     PaintProperties>
 {
 public:
-    using BaseProgram = Program<shaders::symbol_sdf,
+    using BaseProgram = Program<shaders::symbol_sdf_placed,
         gl::Triangle,
-        SymbolLayoutAttributes,
-        gl::Uniforms<
-            uniforms::u_matrix,
-            uniforms::u_extrude_scale,
-            uniforms::u_texsize,
-            uniforms::u_zoom,
-            uniforms::u_rotate_with_map,
-            uniforms::u_texture,
-            uniforms::u_fadetexture,
-            uniforms::u_font_scale,
-            uniforms::u_gamma_scale,
-            uniforms::u_pitch,
-            uniforms::u_bearing,
-            uniforms::u_aspect_ratio,
-            uniforms::u_pitch_with_map,
-            uniforms::u_is_halo>,
+        SymbolProgramLayoutAttributes,
+        SymbolSDFUniforms,
         PaintProperties>;
-    
+
     using UniformValues = typename BaseProgram::UniformValues;
-    
 
-    
     using BaseProgram::BaseProgram;
 
     static UniformValues uniformValues(const style::SymbolPropertyValues&,
@@ -157,11 +293,49 @@ public:
                                        const SymbolSDFPart);
 };
 
+// The instanced counterparts of the programs above, with the same uniform values.
+class SymbolIconInstancedProgram : public Program<
+    shaders::symbol_icon_instanced,
+    gl::Triangle,
+    SymbolInstancedLayoutAttributes,
+    SymbolIconUniforms,
+    style::IconPaintProperties>
+{
+public:
+    using Program::Program;
+};
+
+template <class PaintProperties>
+class SymbolSDFInstancedProgram : public Program<
+    shaders::symbol_sdf_instanced,
+    gl::Triangle,
+    SymbolInstancedLayoutAttributes,
+    SymbolSDFUniforms,
+    PaintProperties>
+{
+public:
+    using BaseProgram = Program<shaders::symbol_sdf_instanced,
+        gl::Triangle,
+        SymbolInstancedLayoutAttributes,
+        SymbolSDFUniforms,
+        PaintProperties>;
+
+    using BaseProgram::BaseProgram;
+};
+
 using SymbolSDFIconProgram = SymbolSDFProgram<style::IconPaintProperties>;
 using SymbolSDFTextProgram = SymbolSDFProgram<style::TextPaintProperties>;
+using SymbolSDFIconInstancedProgram = SymbolSDFInstancedProgram<style::IconPaintProperties>;
+using SymbolSDFTextInstancedProgram = SymbolSDFInstancedProgram<style::TextPaintProperties>;
 
 using SymbolLayoutVertex = SymbolLayoutAttributes::Vertex;
+using SymbolPlacementVertex = SymbolPlacementAttributes::Vertex;
 using SymbolIconAttributes = SymbolIconProgram::Attributes;
 using SymbolTextAttributes = SymbolSDFTextProgram::Attributes;
 
+using SymbolQuadVertex = SymbolQuadAttributes::Vertex;
+using SymbolInstanceVertex = SymbolInstanceAttributes::Vertex;
+using SymbolIconInstancedAttributes = SymbolIconInstancedProgram::Attributes;
+using SymbolTextInstancedAttributes = SymbolSDFTextInstancedProgram::Attributes;
+
 } // namespace mbgl
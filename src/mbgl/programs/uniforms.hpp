@@ -2,6 +2,7 @@
 
 #include <mbgl/gl/uniform.hpp>
 #include <mbgl/util/color.hpp>
+#include <mbgl/util/size.hpp>
 
 namespace mbgl {
 namespace uniforms {
@@ -12,6 +13,7 @@ MBGL_DEFINE_UNIFORM_MATRIX(double, 4, u_matrix);
 MBGL_DEFINE_UNIFORM_SCALAR(float, u_opacity);
 MBGL_DEFINE_UNIFORM_SCALAR(Color, u_color);
 MBGL_DEFINE_UNIFORM_SCALAR(float, u_blur);
+MBGL_DEFINE_UNIFORM_SCALAR(Size, u_world);
 
 MBGL_DEFINE_UNIFORM_SCALAR(float, u_zoom);
 MBGL_DEFINE_UNIFORM_SCALAR(float, u_pitch);
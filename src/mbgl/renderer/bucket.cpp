@@ -0,0 +1,15 @@
+#include <mbgl/renderer/bucket.hpp>
+
+namespace mbgl {
+
+namespace {
+
+std::atomic<uint64_t> nextSerial { 0 };
+
+} // namespace
+
+Bucket::Bucket()
+    : serial(nextSerial++) {
+}
+
+} // namespace mbgl
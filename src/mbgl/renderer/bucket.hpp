@@ -1,16 +1,21 @@
 #pragma once
 
+#include <mbgl/map/memory_stats.hpp>
 #include <mbgl/renderer/render_pass.hpp>
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 
 #include <atomic>
+#include <cassert>
 
 namespace mbgl {
 
 class Painter;
 class PaintParameters;
 class RenderTile;
+class LayoutWriter;
+class LayoutReader;
 
 namespace gl {
 class Context;
@@ -22,11 +27,17 @@ class Layer;
 
 class Bucket : private util::noncopyable {
 public:
-    Bucket() = default;
+    Bucket();
     virtual ~Bucket() = default;
 
+    // Tells this bucket apart from any other, including those that were allocated at the same
+    // address before.
+    const uint64_t serial;
+
+    // `index` is the feature's index in its source layer.
     virtual void addFeature(const GeometryTileFeature&,
-                            const GeometryCollection&) {};
+                            const GeometryBuffer&,
+                            std::size_t /* index */) {};
 
     // As long as this bucket has a Prepare render pass, this function is getting called. Typically,
     // this only happens once when the bucket is being rendered for the first time.
@@ -42,8 +53,64 @@ public:
         return !uploaded;
     }
 
+    // The bytes of vertices, indices, attributes or images this bucket was built with, which
+    // `upload` moves to the GPU at about the same size. Measured the first time it is asked
+    // for, which has to be before the upload.
+    std::size_t getByteSize() const {
+        if (!byteSize) {
+            assert(!uploaded);
+            byteSize = measureByteSize();
+        }
+        return *byteSize;
+    }
+
+    // The vertices this bucket was built with, counting an instance as one. Like the bytes,
+    // only known before the upload.
+    virtual std::size_t getVertexCount() const = 0;
+
+    // Writes what `read` needs to restore this bucket into a `LayoutCache`, before it is
+    // uploaded. Returns false for buckets that can't be restored, e.g. since they hold
+    // attribute values of data-driven paint properties.
+    virtual bool write(LayoutWriter&) const {
+        return false;
+    }
+
+    // Restores what was written into this newly created bucket, made for the same layers.
+    // Returns false if it doesn't fit them; the bucket must then be discarded.
+    virtual bool read(LayoutReader&) {
+        return false;
+    }
+
+    // Frees what this bucket keeps on the CPU once it is uploaded, if anything, at the cost of
+    // whatever that is kept for. Returns the bytes freed.
+    virtual std::size_t releaseRetainedData() {
+        return 0;
+    }
+
+    // Adds what this bucket holds on the CPU and, once it is uploaded, on the GPU, to the
+    // usage of its type of layer.
+    virtual void addMemoryUsage(MemoryStats::Source&) const = 0;
+
 protected:
+    virtual std::size_t measureByteSize() const = 0;
+
+    // Before the upload, all of the bytes are on the CPU; after it, those given are still
+    // kept there, and the rest went to the GPU at about the size measured in the meantime.
+    MemoryStats::Usage memoryUsage(std::size_t retainedBytes = 0) const {
+        MemoryStats::Usage result;
+        if (!uploaded) {
+            result.cpuBytes = getByteSize();
+        } else {
+            result.cpuBytes = retainedBytes;
+            result.gpuBytes = byteSize ? *byteSize : 0;
+        }
+        return result;
+    }
+
     std::atomic<bool> uploaded { false };
+
+private:
+    mutable optional<std::size_t> byteSize;
 };
 
 } // namespace mbgl
@@ -21,8 +21,16 @@ CircleBucket::CircleBucket(const BucketParameters& parameters, const std::vector
 }
 
 void CircleBucket::upload(gl::Context& context) {
-    vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    indexBuffer = context.createIndexBuffer(std::move(triangles));
+    gl::ResourceOwnerScope owner { context, GLResourceStats::Owner::Circle };
+
+    if (context.supportsInstancing()) {
+        instanceBuffer = context.createVertexBuffer(std::move(instances));
+        instancedSegments.emplace_back(0, 0, 4, 6);
+    } else {
+        expandQuads();
+        vertexBuffer = context.createVertexBuffer(std::move(vertices));
+        indexBuffer = context.createIndexBuffer(std::move(triangles), segments);
+    }
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(context);
@@ -39,14 +47,30 @@ void CircleBucket::render(Painter& painter,
 }
 
 bool CircleBucket::hasData() const {
-    return !segments.empty();
+    return instanceCount > 0;
 }
 
-void CircleBucket::addFeature(const GeometryTileFeature& feature,
-                              const GeometryCollection& geometry) {
-    constexpr const uint16_t vertexLength = 4;
+std::size_t CircleBucket::getVertexCount() const {
+    return instances.vertexSize() + vertices.vertexSize();
+}
+
+void CircleBucket::addMemoryUsage(MemoryStats::Source& source) const {
+    source.bucket(MemoryStats::BucketType::Circle) += memoryUsage();
+}
 
-    for (auto& circle : geometry) {
+std::size_t CircleBucket::measureByteSize() const {
+    // Instances expanded into quads on upload are counted as the quads.
+    std::size_t result = instances.byteSize() + vertices.byteSize() + triangles.byteSize();
+    for (const auto& pair : paintPropertyBinders) {
+        result += pair.second.byteSize();
+    }
+    return result;
+}
+
+void CircleBucket::addFeature(const GeometryTileFeature& feature,
+                              const GeometryBuffer& geometry,
+                              std::size_t) {
+    for (const auto& circle : geometry) {
         for(auto& point : circle) {
             auto x = point.x;
             auto y = point.y;
@@ -57,41 +81,60 @@ void CircleBucket::addFeature(const GeometryTileFeature& feature,
             if ((mode != MapMode::Still) &&
                 (x < 0 || x >= util::EXTENT || y < 0 || y >= util::EXTENT)) continue;
 
-            if (segments.empty() || segments.back().vertexLength + vertexLength > std::numeric_limits<uint16_t>::max()) {
-                // Move to a new segments because the old one can't hold the geometry.
-                segments.emplace_back(vertices.vertexSize(), triangles.indexSize());
-            }
-
-            // this geometry will be of the Point type, and we'll derive
-            // two triangles from it.
-            //
-            // ┌─────────┐
-            // │ 4     3 │
-            // │         │
-            // │ 1     2 │
-            // └─────────┘
-            //
-            vertices.emplace_back(CircleProgram::vertex(point, -1, -1)); // 1
-            vertices.emplace_back(CircleProgram::vertex(point,  1, -1)); // 2
-            vertices.emplace_back(CircleProgram::vertex(point,  1,  1)); // 3
-            vertices.emplace_back(CircleProgram::vertex(point, -1,  1)); // 4
-
-            auto& segment = segments.back();
-            assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
-            uint16_t index = segment.vertexLength;
-
-            // 1, 2, 3
-            // 1, 4, 3
-            triangles.emplace_back(index, index + 1, index + 2);
-            triangles.emplace_back(index, index + 3, index + 2);
-
-            segment.vertexLength += vertexLength;
-            segment.indexLength += 6;
+            instances.emplace_back(CircleInstancedProgram::instanceVertex(point));
         }
     }
 
+    instanceCount = instances.vertexSize();
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(feature, instanceCount);
+    }
+}
+
+void CircleBucket::expandQuads() {
+    constexpr const uint16_t vertexLength = 4;
+
+    for (std::size_t i = 0; i < instances.vertexSize(); ++i) {
+        const auto& center = instances.data()[i].a1;
+        const Point<int16_t> point(center[0] / 2, center[1] / 2);
+
+        if (segments.empty() || segments.back().vertexLength + vertexLength > std::numeric_limits<uint16_t>::max()) {
+            // Move to a new segments because the old one can't hold the geometry.
+            segments.emplace_back(vertices.vertexSize(), triangles.indexSize());
+        }
+
+        // this geometry will be of the Point type, and we'll derive
+        // two triangles from it.
+        //
+        // ┌─────────┐
+        // │ 4     3 │
+        // │         │
+        // │ 1     2 │
+        // └─────────┘
+        //
+        vertices.emplace_back(CircleProgram::vertex(point, -1, -1)); // 1
+        vertices.emplace_back(CircleProgram::vertex(point,  1, -1)); // 2
+        vertices.emplace_back(CircleProgram::vertex(point,  1,  1)); // 3
+        vertices.emplace_back(CircleProgram::vertex(point, -1,  1)); // 4
+
+        auto& segment = segments.back();
+        assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
+        uint16_t index = segment.vertexLength;
+
+        // 1, 2, 3
+        // 1, 4, 3
+        triangles.emplace_back(index, index + 1, index + 2);
+        triangles.emplace_back(index, index + 3, index + 2);
+
+        segment.vertexLength += vertexLength;
+        segment.indexLength += 6;
+    }
+
+    instances = {};
+
     for (auto& pair : paintPropertyBinders) {
-        pair.second.populateVertexVectors(feature, vertices.vertexSize());
+        pair.second.repeatVertices(vertexLength);
     }
 }
 
@@ -20,12 +20,24 @@ public:
     CircleBucket(const style::BucketParameters&, const std::vector<const style::Layer*>&);
 
     void addFeature(const GeometryTileFeature&,
-                    const GeometryCollection&) override;
+                    const GeometryBuffer&,
+                    std::size_t) override;
     bool hasData() const override;
+    void addMemoryUsage(MemoryStats::Source&) const override;
+    std::size_t getVertexCount() const override;
 
     void upload(gl::Context&) override;
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
 
+    // One entry per circle, as are the paint property binders' vertex vectors.
+    gl::VertexVector<CircleInstanceVertex> instances;
+    std::size_t instanceCount = 0;
+
+    // Drawn as instances of the painter's quad, if the context supports it.
+    optional<gl::VertexBuffer<CircleInstanceVertex>> instanceBuffer;
+    gl::SegmentVector<CircleInstancedAttributes> instancedSegments;
+
+    // Otherwise, each circle is expanded into a quad of its own on upload.
     gl::VertexVector<CircleLayoutVertex> vertices;
     gl::IndexVector<gl::Triangles> triangles;
     gl::SegmentVector<CircleAttributes> segments;
@@ -36,6 +48,12 @@ public:
     std::unordered_map<std::string, CircleProgram::PaintPropertyBinders> paintPropertyBinders;
 
     const MapMode mode;
+
+protected:
+    std::size_t measureByteSize() const override;
+
+private:
+    void expandQuads();
 };
 
 } // namespace mbgl
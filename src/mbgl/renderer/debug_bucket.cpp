@@ -16,12 +16,22 @@ DebugBucket::DebugBucket(const OverscaledTileID& id,
                          optional<Timestamp> modified_,
                          optional<Timestamp> expires_,
                          MapDebugOptions debugMode_,
-                         gl::Context& context)
-    : renderable(renderable_),
-      complete(complete_),
-      modified(std::move(modified_)),
-      expires(std::move(expires_)),
-      debugMode(debugMode_) {
+                         gl::Context& context) {
+    update(id, renderable_, complete_, std::move(modified_), std::move(expires_), debugMode_, context);
+}
+
+void DebugBucket::update(const OverscaledTileID& id,
+                         const bool renderable_,
+                         const bool complete_,
+                         optional<Timestamp> modified_,
+                         optional<Timestamp> expires_,
+                         MapDebugOptions debugMode_,
+                         gl::Context& context) {
+    renderable = renderable_;
+    complete = complete_;
+    modified = std::move(modified_);
+    expires = std::move(expires_);
+    debugMode = debugMode_;
 
     gl::VertexVector<FillLayoutVertex> vertices;
     gl::IndexVector<gl::Lines> indices;
@@ -74,10 +84,17 @@ DebugBucket::DebugBucket(const OverscaledTileID& id,
         addText(expiresText, 50, baseline + 200, 5);
     }
 
+    segments.clear();
     segments.emplace_back(0, 0, vertices.vertexSize(), indices.indexSize());
 
-    vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    indexBuffer = context.createIndexBuffer(std::move(indices));
+    // The text changes as the tile loads, so the buffers are streamed into.
+    if (!vertexBuffer) {
+        vertexBuffer = context.createStreamVertexBuffer(std::move(vertices));
+        indexBuffer = context.createStreamIndexBuffer(std::move(indices));
+    } else {
+        context.updateVertexBuffer(*vertexBuffer, std::move(vertices));
+        context.updateIndexBuffer(*indexBuffer, std::move(indices));
+    }
 }
 
 } // namespace mbgl
@@ -27,11 +27,20 @@ public:
                 MapDebugOptions,
                 gl::Context&);
 
-    const bool renderable;
-    const bool complete;
-    const optional<Timestamp> modified;
-    const optional<Timestamp> expires;
-    const MapDebugOptions debugMode;
+    // Re-uploads the text for a new state of the tile, into the same buffers.
+    void update(const OverscaledTileID& id,
+                bool renderable,
+                bool complete,
+                optional<Timestamp> modified,
+                optional<Timestamp> expires,
+                MapDebugOptions,
+                gl::Context&);
+
+    bool renderable;
+    bool complete;
+    optional<Timestamp> modified;
+    optional<Timestamp> expires;
+    MapDebugOptions debugMode;
 
     gl::SegmentVector<DebugAttributes> segments;
     optional<gl::VertexBuffer<DebugLayoutVertex>> vertexBuffer;
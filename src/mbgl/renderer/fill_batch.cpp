@@ -0,0 +1,66 @@
+#include <mbgl/renderer/fill_batch.hpp>
+#include <mbgl/renderer/fill_bucket.hpp>
+#include <mbgl/gl/context.hpp>
+
+#include <cassert>
+#include <limits>
+
+namespace mbgl {
+
+void FillBatch::update(gl::Context& context, const std::vector<const FillBucket*>& buckets) {
+    assert(buckets.size() <= FillBatchedProgram::maxTiles);
+
+    std::vector<uint64_t> current;
+    current.reserve(buckets.size());
+    for (const FillBucket* bucket : buckets) {
+        current.push_back(bucket->serial);
+    }
+    if (current == serials && vertexBuffer) {
+        return;
+    }
+
+    gl::VertexVector<FillBatchedLayoutVertex> vertices;
+    gl::IndexVector<gl::Triangles> triangles;
+    segments.clear();
+
+    for (std::size_t tile = 0; tile < buckets.size(); ++tile) {
+        const FillBucket& bucket = *buckets[tile];
+        assert(bucket.retainsGeometry);
+
+        const FillLayoutVertex* bucketVertices = bucket.vertices.data();
+        const uint16_t* bucketIndices = bucket.triangles.data();
+
+        vertices.reserveAdditional(bucket.vertices.vertexSize());
+        triangles.reserveAdditional(bucket.triangles.indexSize());
+
+        for (const auto& segment : bucket.triangleSegments) {
+            if (segments.empty() || segments.back().vertexLength + segment.vertexLength > std::numeric_limits<uint16_t>::max()) {
+                segments.emplace_back(vertices.vertexSize(), triangles.indexSize());
+            }
+
+            auto& merged = segments.back();
+            const std::size_t base = merged.vertexLength;
+
+            for (std::size_t i = 0; i < segment.vertexLength; ++i) {
+                vertices.emplace_back(FillBatchedProgram::layoutVertex(
+                    bucketVertices[segment.vertexOffset + i], static_cast<uint16_t>(tile)));
+            }
+
+            const uint16_t* indices = bucketIndices + segment.indexOffset;
+            for (std::size_t i = 0; i < segment.indexLength; i += 3) {
+                triangles.emplace_back(static_cast<uint16_t>(base + indices[i]),
+                                       static_cast<uint16_t>(base + indices[i + 1]),
+                                       static_cast<uint16_t>(base + indices[i + 2]));
+            }
+
+            merged.vertexLength += segment.vertexLength;
+            merged.indexLength += segment.indexLength;
+        }
+    }
+
+    vertexBuffer = context.createVertexBuffer(std::move(vertices));
+    indexBuffer = context.createIndexBuffer(std::move(triangles));
+    serials = std::move(current);
+}
+
+} // namespace mbgl
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <mbgl/gl/vertex_buffer.hpp>
+#include <mbgl/gl/index_buffer.hpp>
+#include <mbgl/gl/segment.hpp>
+#include <mbgl/programs/fill_program.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+class FillBucket;
+
+namespace gl {
+class Context;
+} // namespace gl
+
+/*
+    The fill triangles of several tiles of a layer, merged into one vertex and index buffer
+    so that `FillBatchedProgram` draws them with as few calls as there are segments. Each
+    vertex carries the index of its tile in the list the batch was made from.
+
+    The buffers are kept as long as the batch is updated with the same buckets in the same
+    order, which is the case from frame to frame until tiles are added or removed.
+*/
+class FillBatch {
+public:
+    // Merges the retained geometry of `buckets` (see `FillBucket::retainsGeometry`), unless
+    // the batch already holds exactly these buckets.
+    void update(gl::Context&, const std::vector<const FillBucket*>& buckets);
+
+    optional<gl::VertexBuffer<FillBatchedLayoutVertex>> vertexBuffer;
+    optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
+    gl::SegmentVector<FillBatchedAttributes> segments;
+
+private:
+    // The serial numbers of the merged buckets; a new bucket may be allocated at the
+    // address of one that is gone.
+    std::vector<uint64_t> serials;
+};
+
+} // namespace mbgl
@@ -4,22 +4,12 @@
 #include <mbgl/style/bucket_parameters.hpp>
 #include <mbgl/style/layers/fill_layer.hpp>
 #include <mbgl/style/layers/fill_layer_impl.hpp>
+#include <mbgl/tile/layout_cache.hpp>
+#include <mbgl/util/constants.hpp>
 
-#include <mapbox/earcut.hpp>
-
+#include <algorithm>
 #include <cassert>
-
-namespace mapbox {
-namespace util {
-template <> struct nth<0, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.x; };
-};
-
-template <> struct nth<1, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.y; };
-};
-} // namespace util
-} // namespace mapbox
+#include <utility>
 
 namespace mbgl {
 
@@ -27,7 +17,50 @@ using namespace style;
 
 struct GeometryTooLongException : std::exception {};
 
-FillBucket::FillBucket(const BucketParameters& parameters, const std::vector<const Layer*>& layers) {
+constexpr std::size_t FillBucket::maxBatchedVertices;
+
+namespace {
+
+// Whether a polygon is a rectangle that contains the tile's extent, as the polygons of
+// oceans and land cover often are once clipped to the tile's buffer: it has no holes,
+// and each of its edges runs along a side of a bounding box that contains the extent.
+bool coversTileExtent(const GeometryPolygonView& polygon) {
+    if (polygon.size() != 1 || polygon[0].size() < 4) {
+        return false;
+    }
+
+    const GeometryCoordinatesView& ring = polygon[0];
+    int16_t minX = ring[0].x, minY = ring[0].y, maxX = ring[0].x, maxY = ring[0].y;
+    for (const auto& point : ring) {
+        minX = std::min(minX, point.x);
+        minY = std::min(minY, point.y);
+        maxX = std::max(maxX, point.x);
+        maxY = std::max(maxY, point.y);
+    }
+    if (minX > 0 || minY > 0 || maxX < util::EXTENT || maxY < util::EXTENT) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < ring.size(); i++) {
+        const GeometryCoordinate& a = ring[i];
+        const GeometryCoordinate& b = ring[(i + 1) % ring.size()];
+        const bool alongSide = (a.x == b.x && (a.x == minX || a.x == maxX)) ||
+                               (a.y == b.y && (a.y == minY || a.y == maxY));
+        if (!alongSide) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+FillBucket::FillBucket(const BucketParameters& parameters, const std::vector<const Layer*>& layers)
+    : triangulations(parameters.triangulations) {
+    if (!layers.empty()) {
+        sourceLayer = layers.front()->baseImpl->sourceLayer;
+    }
+
     for (const auto& layer : layers) {
         paintPropertyBinders.emplace(layer->getID(),
             FillProgram::PaintPropertyBinders(
@@ -37,8 +70,20 @@ FillBucket::FillBucket(const BucketParameters& parameters, const std::vector<con
 }
 
 void FillBucket::addFeature(const GeometryTileFeature& feature,
-                            const GeometryCollection& geometry) {
-    for (auto& polygon : classifyRings(geometry)) {
+                            const GeometryBuffer& geometry,
+                            std::size_t index) {
+    const FillTriangulationCache::Triangulation* cached =
+        triangulations ? triangulations->find(sourceLayer, index) : nullptr;
+    FillTriangulationCache::Triangulation triangulation;
+
+    std::vector<GeometryPolygonView> polygons = classifyRings(geometry);
+    for (std::size_t p = 0; p < polygons.size(); p++) {
+        auto& polygon = polygons[p];
+
+        if (!coversExtent && coversTileExtent(polygon)) {
+            coversExtent = true;
+        }
+
         // Optimize polygons with many interior rings for earcut tesselation.
         limitHoles(polygon, 500);
 
@@ -78,7 +123,10 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
             lineSegment.indexLength += nVertices * 2;
         }
 
-        std::vector<uint32_t> indices = mapbox::earcut(polygon);
+        if (!cached) {
+            triangulation.push_back(FillTriangulationCache::triangulate(polygon));
+        }
+        const std::vector<uint32_t>& indices = cached ? (*cached)[p] : triangulation.back();
 
         std::size_t nIndicies = indices.size();
         assert(nIndicies % 3 == 0);
@@ -101,15 +149,27 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
         triangleSegment.indexLength += nIndicies;
     }
 
+    if (triangulations && !cached) {
+        triangulations->insert(sourceLayer, index, std::move(triangulation));
+    }
+
     for (auto& pair : paintPropertyBinders) {
         pair.second.populateVertexVectors(feature, vertices.vertexSize());
     }
 }
 
 void FillBucket::upload(gl::Context& context) {
-    vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    lineIndexBuffer = context.createIndexBuffer(std::move(lines));
-    triangleIndexBuffer = context.createIndexBuffer(std::move(triangles));
+    gl::ResourceOwnerScope owner { context, GLResourceStats::Owner::Fill };
+
+    retainsGeometry = vertices.vertexSize() <= maxBatchedVertices;
+    if (retainsGeometry) {
+        vertexBuffer = context.createVertexBuffer(gl::VertexVector<FillLayoutVertex>(vertices));
+        triangleIndexBuffer = context.createIndexBuffer(gl::IndexVector<gl::Triangles>(triangles));
+    } else {
+        vertexBuffer = context.createVertexBuffer(std::move(vertices));
+        triangleIndexBuffer = context.createIndexBuffer(std::move(triangles), triangleSegments);
+    }
+    lineIndexBuffer = context.createIndexBuffer(std::move(lines), lineSegments);
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(context);
@@ -129,4 +189,75 @@ bool FillBucket::hasData() const {
     return !triangleSegments.empty() || !lineSegments.empty();
 }
 
+bool FillBucket::write(LayoutWriter& writer) const {
+    for (const auto& pair : paintPropertyBinders) {
+        if (!pair.second.isConstant()) {
+            return false;
+        }
+    }
+
+    writer.write(coversExtent);
+    writer.writeArray(vertices.data(), vertices.vertexSize());
+    writer.writeArray(lines.data(), lines.indexSize());
+    writer.writeArray(triangles.data(), triangles.indexSize());
+    writer.writeSegments(lineSegments);
+    writer.writeSegments(triangleSegments);
+    return true;
+}
+
+bool FillBucket::read(LayoutReader& reader) {
+    for (const auto& pair : paintPropertyBinders) {
+        if (!pair.second.isConstant()) {
+            return false;
+        }
+    }
+
+    std::vector<FillLayoutVertex> vertices_;
+    std::vector<uint16_t> lines_;
+    std::vector<uint16_t> triangles_;
+    if (!reader.read(coversExtent) ||
+        !reader.readArray(vertices_) ||
+        !reader.readArray(lines_) || lines_.size() % 2 != 0 ||
+        !reader.readArray(triangles_) || triangles_.size() % 3 != 0 ||
+        !reader.readSegments(lineSegments) ||
+        !reader.readSegments(triangleSegments)) {
+        return false;
+    }
+
+    vertices.assign(std::move(vertices_));
+    lines.assign(std::move(lines_));
+    triangles.assign(std::move(triangles_));
+    return true;
+}
+
+std::size_t FillBucket::releaseRetainedData() {
+    if (!uploaded || !retainsGeometry) {
+        return 0;
+    }
+
+    // The bucket is drawn on its own from then on.
+    const std::size_t result = vertices.byteSize() + triangles.byteSize();
+    vertices = {};
+    triangles = {};
+    retainsGeometry = false;
+    return result;
+}
+
+std::size_t FillBucket::getVertexCount() const {
+    return vertices.vertexSize();
+}
+
+void FillBucket::addMemoryUsage(MemoryStats::Source& source) const {
+    source.bucket(MemoryStats::BucketType::Fill) +=
+        memoryUsage(retainsGeometry ? vertices.byteSize() + triangles.byteSize() : 0);
+}
+
+std::size_t FillBucket::measureByteSize() const {
+    std::size_t result = vertices.byteSize() + lines.byteSize() + triangles.byteSize();
+    for (const auto& pair : paintPropertyBinders) {
+        result += pair.second.byteSize();
+    }
+    return result;
+}
+
 } // namespace mbgl
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/renderer/bucket.hpp>
+#include <mbgl/renderer/fill_triangulation_cache.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/gl/vertex_buffer.hpp>
 #include <mbgl/gl/index_buffer.hpp>
@@ -8,6 +9,8 @@
 #include <mbgl/programs/fill_program.hpp>
 #include <mbgl/style/layers/fill_layer_properties.hpp>
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace mbgl {
@@ -21,12 +24,29 @@ public:
     FillBucket(const style::BucketParameters&, const std::vector<const style::Layer*>&);
 
     void addFeature(const GeometryTileFeature&,
-                    const GeometryCollection&) override;
+                    const GeometryBuffer&,
+                    std::size_t index) override;
     bool hasData() const override;
+    void addMemoryUsage(MemoryStats::Source&) const override;
+    std::size_t getVertexCount() const override;
+    bool write(LayoutWriter&) const override;
+    bool read(LayoutReader&) override;
+    std::size_t releaseRetainedData() override;
 
     void upload(gl::Context&) override;
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
 
+    // Buckets with at most this many vertices keep `vertices`, `triangles` and
+    // `triangleSegments` after uploading them, so that their fill can be merged with other
+    // tiles' into a `FillBatch`. Larger buckets are drawn on their own.
+    static constexpr std::size_t maxBatchedVertices = 8192;
+
+    bool retainsGeometry = false;
+
+    // Whether one of the polygons covers the whole tile extent, so that an opaque fill of
+    // this bucket hides whatever is drawn beneath it in the tile.
+    bool coversExtent = false;
+
     gl::VertexVector<FillLayoutVertex> vertices;
     gl::IndexVector<gl::Lines> lines;
     gl::IndexVector<gl::Triangles> triangles;
@@ -38,6 +58,13 @@ public:
     optional<gl::IndexBuffer<gl::Triangles>> triangleIndexBuffer;
 
     std::unordered_map<std::string, FillProgram::PaintPropertyBinders> paintPropertyBinders;
+
+protected:
+    std::size_t measureByteSize() const override;
+
+private:
+    FillTriangulationCache* triangulations = nullptr;
+    std::string sourceLayer;
 };
 
 } // namespace mbgl
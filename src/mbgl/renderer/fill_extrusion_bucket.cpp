@@ -0,0 +1,187 @@
+#include <mbgl/renderer/fill_extrusion_bucket.hpp>
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/programs/fill_extrusion_program.hpp>
+#include <mbgl/style/bucket_parameters.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer_impl.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/geometry.hpp>
+#include <mbgl/util/math.hpp>
+
+#include <cassert>
+#include <limits>
+
+namespace mbgl {
+
+using namespace style;
+
+namespace {
+
+struct GeometryTooLongException : std::exception {};
+
+// Whether an edge runs along the outside of the tile's buffer, where polygons are clipped,
+// so that its wall would be hidden by a neighbouring tile's extrusion.
+bool isBoundaryEdge(const GeometryCoordinate& p1, const GeometryCoordinate& p2) {
+    return (p1.x == p2.x && (p1.x < 0 || p1.x > util::EXTENT)) ||
+           (p1.y == p2.y && (p1.y < 0 || p1.y > util::EXTENT));
+}
+
+} // namespace
+
+FillExtrusionBucket::FillExtrusionBucket(const BucketParameters& parameters, const std::vector<const Layer*>& layers)
+    : triangulations(parameters.triangulations) {
+    if (!layers.empty()) {
+        sourceLayer = layers.front()->baseImpl->sourceLayer;
+    }
+
+    for (const auto& layer : layers) {
+        paintPropertyBinders.emplace(layer->getID(),
+            FillExtrusionProgram::PaintPropertyBinders(
+                layer->as<FillExtrusionLayer>()->impl->paint.evaluated,
+                parameters.tileID.overscaledZ));
+    }
+}
+
+void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
+                                     const GeometryBuffer& geometry,
+                                     std::size_t index) {
+    const FillTriangulationCache::Triangulation* cached =
+        triangulations ? triangulations->find(sourceLayer, index) : nullptr;
+    FillTriangulationCache::Triangulation triangulation;
+
+    const std::size_t maxVertices = std::numeric_limits<uint16_t>::max();
+
+    std::vector<GeometryPolygonView> polygons = classifyRings(geometry);
+    for (std::size_t p = 0; p < polygons.size(); p++) {
+        auto& polygon = polygons[p];
+
+        // Limited as fills do, so that their triangulations are interchangeable.
+        limitHoles(polygon, 500);
+
+        std::size_t totalVertices = 0;
+        for (const auto& ring : polygon) {
+            totalVertices += ring.size();
+            if (totalVertices > maxVertices)
+                throw GeometryTooLongException();
+        }
+
+        // The roof, whose vertices come in the order that its triangulation refers to.
+        if (!cached) {
+            triangulation.push_back(FillTriangulationCache::triangulate(polygon));
+        }
+        const std::vector<uint32_t>& roof = cached ? (*cached)[p] : triangulation.back();
+        assert(roof.size() % 3 == 0);
+
+        if (triangleSegments.empty() || triangleSegments.back().vertexLength + totalVertices > maxVertices) {
+            triangleSegments.emplace_back(vertices.vertexSize(), indices.indexSize());
+        }
+
+        auto& roofSegment = triangleSegments.back();
+        const uint16_t roofIndex = roofSegment.vertexLength;
+
+        for (const auto& ring : polygon) {
+            for (const auto& point : ring) {
+                vertices.emplace_back(FillExtrusionProgram::layoutVertex(point, 0, 0, 1, true, 0));
+            }
+        }
+
+        for (std::size_t i = 0; i < roof.size(); i += 3) {
+            indices.emplace_back(roofIndex + roof[i],
+                                 roofIndex + roof[i + 1],
+                                 roofIndex + roof[i + 2]);
+        }
+
+        roofSegment.vertexLength += totalVertices;
+        roofSegment.indexLength += roof.size();
+
+        // The walls, each a quad of its own.
+        for (const auto& ring : polygon) {
+            int16_t edgeDistance = 0;
+
+            for (std::size_t i = 1; i < ring.size(); i++) {
+                const GeometryCoordinate& p1 = ring[i];
+                const GeometryCoordinate& p2 = ring[i - 1];
+                if (isBoundaryEdge(p1, p2)) {
+                    continue;
+                }
+
+                const Point<double> d1 = convertPoint<double>(p1);
+                const Point<double> d2 = convertPoint<double>(p2);
+                const Point<double> perp = util::unit(util::perp(d1 - d2));
+                const int16_t dist = static_cast<int16_t>(util::dist<double>(d1, d2));
+                if (edgeDistance + dist > std::numeric_limits<int16_t>::max()) {
+                    edgeDistance = 0;
+                }
+
+                if (triangleSegments.back().vertexLength + 4 > maxVertices) {
+                    triangleSegments.emplace_back(vertices.vertexSize(), indices.indexSize());
+                }
+
+                auto& wallSegment = triangleSegments.back();
+                const uint16_t wallIndex = wallSegment.vertexLength;
+
+                vertices.emplace_back(FillExtrusionProgram::layoutVertex(p1, perp.x, perp.y, 0, false, edgeDistance));
+                vertices.emplace_back(FillExtrusionProgram::layoutVertex(p1, perp.x, perp.y, 0, true, edgeDistance));
+                edgeDistance += dist;
+                vertices.emplace_back(FillExtrusionProgram::layoutVertex(p2, perp.x, perp.y, 0, false, edgeDistance));
+                vertices.emplace_back(FillExtrusionProgram::layoutVertex(p2, perp.x, perp.y, 0, true, edgeDistance));
+
+                indices.emplace_back(wallIndex, wallIndex + 1, wallIndex + 2);
+                indices.emplace_back(wallIndex + 1, wallIndex + 2, wallIndex + 3);
+
+                wallSegment.vertexLength += 4;
+                wallSegment.indexLength += 6;
+            }
+        }
+    }
+
+    if (triangulations && !cached) {
+        triangulations->insert(sourceLayer, index, std::move(triangulation));
+    }
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(feature, vertices.vertexSize());
+    }
+}
+
+void FillExtrusionBucket::upload(gl::Context& context) {
+    gl::ResourceOwnerScope owner { context, GLResourceStats::Owner::FillExtrusion };
+
+    vertexBuffer = context.createVertexBuffer(std::move(vertices));
+    indexBuffer = context.createIndexBuffer(std::move(indices), triangleSegments);
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.upload(context);
+    }
+
+    uploaded = true;
+}
+
+void FillExtrusionBucket::render(Painter& painter,
+                                 PaintParameters& parameters,
+                                 const Layer& layer,
+                                 const RenderTile& tile) {
+    painter.renderFillExtrusion(parameters, *this, *layer.as<FillExtrusionLayer>(), tile);
+}
+
+bool FillExtrusionBucket::hasData() const {
+    return !triangleSegments.empty();
+}
+
+std::size_t FillExtrusionBucket::getVertexCount() const {
+    return vertices.vertexSize();
+}
+
+void FillExtrusionBucket::addMemoryUsage(MemoryStats::Source& source) const {
+    source.bucket(MemoryStats::BucketType::FillExtrusion) += memoryUsage();
+}
+
+std::size_t FillExtrusionBucket::measureByteSize() const {
+    std::size_t result = vertices.byteSize() + indices.byteSize();
+    for (const auto& pair : paintPropertyBinders) {
+        result += pair.second.byteSize();
+    }
+    return result;
+}
+
+} // namespace mbgl
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/renderer/fill_triangulation_cache.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/gl/vertex_buffer.hpp>
+#include <mbgl/gl/index_buffer.hpp>
+#include <mbgl/gl/segment.hpp>
+#include <mbgl/programs/fill_extrusion_program.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer_properties.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+namespace style {
+class BucketParameters;
+} // namespace style
+
+// The roofs and walls of the extruded polygons of a tile. A roof is its polygon's
+// triangulation, shared with fills of the same features; each edge of a ring that doesn't
+// run along the outside of the tile's buffer gets a wall of two triangles.
+class FillExtrusionBucket : public Bucket {
+public:
+    FillExtrusionBucket(const style::BucketParameters&, const std::vector<const style::Layer*>&);
+
+    void addFeature(const GeometryTileFeature&,
+                    const GeometryBuffer&,
+                    std::size_t index) override;
+    bool hasData() const override;
+    void addMemoryUsage(MemoryStats::Source&) const override;
+    std::size_t getVertexCount() const override;
+
+    void upload(gl::Context&) override;
+    void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
+
+    gl::VertexVector<FillExtrusionLayoutVertex> vertices;
+    gl::IndexVector<gl::Triangles> indices;
+    gl::SegmentVector<FillExtrusionAttributes> triangleSegments;
+
+    optional<gl::VertexBuffer<FillExtrusionLayoutVertex>> vertexBuffer;
+    optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
+
+    std::unordered_map<std::string, FillExtrusionProgram::PaintPropertyBinders> paintPropertyBinders;
+
+protected:
+    std::size_t measureByteSize() const override;
+
+private:
+    FillTriangulationCache* triangulations = nullptr;
+    std::string sourceLayer;
+};
+
+} // namespace mbgl
@@ -0,0 +1,124 @@
+#include <mbgl/renderer/fill_triangulation_cache.hpp>
+
+#include <mapbox/earcut.hpp>
+
+#include <utility>
+
+namespace mapbox {
+namespace util {
+template <> struct nth<0, mbgl::GeometryCoordinate> {
+    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.x; };
+};
+
+template <> struct nth<1, mbgl::GeometryCoordinate> {
+    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.y; };
+};
+} // namespace util
+} // namespace mapbox
+
+namespace mbgl {
+
+namespace {
+
+// Triangulates a polygon without holes whose ring is convex, such as most building footprints,
+// as a fan around its first vertex. Returns false for any other polygon, which is left to
+// earcut.
+bool triangulateConvex(const GeometryPolygonView& polygon, std::vector<uint32_t>& indices) {
+    if (polygon.size() != 1) {
+        return false;
+    }
+
+    const GeometryCoordinatesView& ring = polygon[0];
+    std::size_t n = ring.size();
+    if (n > 1 && ring[0] == ring[n - 1]) {
+        // The closing vertex is added to the bucket, but needn't be part of a triangle.
+        n--;
+    }
+    if (n < 3) {
+        return false;
+    }
+
+    // All turns must go the same way, and the ring must go around only once: following its
+    // edges, the x and y directions then each change sign at most twice.
+    int turn = 0;
+    int xChanges = 0;
+    int yChanges = 0;
+    int xDirection = 0;
+    int yDirection = 0;
+
+    for (std::size_t i = 0; i < n; i++) {
+        const GeometryCoordinate& a = ring[i];
+        const GeometryCoordinate& b = ring[(i + 1) % n];
+        const GeometryCoordinate& c = ring[(i + 2) % n];
+
+        const int64_t cross = int64_t(b.x - a.x) * (c.y - b.y) - int64_t(b.y - a.y) * (c.x - b.x);
+        if (cross != 0) {
+            const int sign = cross > 0 ? 1 : -1;
+            if (turn != 0 && sign != turn) {
+                return false;
+            }
+            turn = sign;
+        }
+
+        const int dx = (b.x > a.x) - (b.x < a.x);
+        if (dx != 0) {
+            xChanges += xDirection != 0 && dx != xDirection;
+            xDirection = dx;
+        }
+        const int dy = (b.y > a.y) - (b.y < a.y);
+        if (dy != 0) {
+            yChanges += yDirection != 0 && dy != yDirection;
+            yDirection = dy;
+        }
+    }
+
+    if (turn == 0 || xChanges > 2 || yChanges > 2) {
+        return false;
+    }
+
+    indices.clear();
+    indices.reserve((n - 2) * 3);
+    for (uint32_t i = 1; i + 1 < n; i++) {
+        indices.push_back(0);
+        indices.push_back(i);
+        indices.push_back(i + 1);
+    }
+    return true;
+}
+
+} // namespace
+
+std::vector<uint32_t> FillTriangulationCache::triangulate(const GeometryPolygonView& polygon) {
+    std::vector<uint32_t> indices;
+    if (!triangulateConvex(polygon, indices)) {
+        indices = mapbox::earcut(polygon);
+    }
+    return indices;
+}
+
+const FillTriangulationCache::Triangulation* FillTriangulationCache::find(const std::string& sourceLayer,
+                                                                        std::size_t index) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto layer = layers.find(sourceLayer);
+    if (layer == layers.end()) {
+        return nullptr;
+    }
+
+    // Elements of an unordered_map stay in place when others are inserted.
+    auto it = layer->second.find(index);
+    return it != layer->second.end() ? &it->second : nullptr;
+}
+
+void FillTriangulationCache::insert(const std::string& sourceLayer, std::size_t index, Triangulation triangulation) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // Two layers may have triangulated the same feature at once; both results are the same.
+    layers[sourceLayer].emplace(index, std::move(triangulation));
+}
+
+void FillTriangulationCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    layers.clear();
+}
+
+} // namespace mbgl
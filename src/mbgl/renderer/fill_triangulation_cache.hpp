@@ -0,0 +1,44 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+/*
+   The triangulations of the polygons of a tile's features, kept by the tile's worker for
+   as long as its data doesn't change. Fill layers that are laid out again, e.g. after a
+   filter change, reuse them instead of triangulating the same geometry again, as do fill
+   extrusion layers for the roofs of the same features.
+
+   Layers of a tile may be laid out concurrently, so access is synchronised.
+*/
+class FillTriangulationCache : private util::noncopyable {
+public:
+    // Triangle indices for each polygon of a feature, relative to the polygon's first vertex.
+    using Triangulation = std::vector<std::vector<uint32_t>>;
+
+    // Returns the triangulation of the feature at `index` of `sourceLayer`, if there is one.
+    // It remains valid until the cache is cleared.
+    const Triangulation* find(const std::string& sourceLayer, std::size_t index) const;
+
+    void insert(const std::string& sourceLayer, std::size_t index, Triangulation);
+    void clear();
+
+    // Triangulates a polygon, whose holes have been limited as fills do, as a fan if it is
+    // convex and has no holes, and with earcut otherwise.
+    static std::vector<uint32_t> triangulate(const GeometryPolygonView&);
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, std::unordered_map<std::size_t, Triangulation>> layers;
+};
+
+} // namespace mbgl
@@ -39,15 +39,17 @@ void FrameHistory::record(const TimePoint& now, float zoom, const Duration& dura
     for (int16_t z = 0; z <= 255; z++) {
         std::chrono::duration<float> timeDiff = now - changeTimes[z];
         int32_t opacityChange = (duration == Milliseconds(0) ? 1 : (timeDiff / duration)) * 255;
-        if (z <= zoomIndex) {
-            opacities.data[z] = util::min(255, changeOpacities[z] + opacityChange);
-        } else {
-            opacities.data[z] = util::max(0, changeOpacities[z] - opacityChange);
+        const uint8_t opacity = z <= zoomIndex
+            ? util::min(255, changeOpacities[z] + opacityChange)
+            : util::max(0, changeOpacities[z] - opacityChange);
+
+        // Once fading is done, e.g. in every still image, frames upload nothing.
+        if (opacity != opacities.data[z]) {
+            opacities.data[z] = opacity;
+            dirty = true;
         }
     }
 
-    dirty = true;
-
     if (zoomIndex != previousZoomIndex) {
         previousZoomIndex = zoomIndex;
         previousTime = now;
@@ -61,17 +63,24 @@ bool FrameHistory::needsAnimation(const Duration& duration) const {
 }
 
 void FrameHistory::upload(gl::Context& context, uint32_t unit) {
-    if (!texture) {
-        texture = context.createTexture(opacities, unit);
-    } else if (dirty) {
-        context.updateTexture(*texture, opacities, unit);
+    if (!dirty && textures[current]) {
+        return;
+    }
+
+    // Opacities change every frame while zooming; each upload goes to the texture that was
+    // used the longest ago, which the draws of recent frames no longer read.
+    current = (current + 1) % textures.size();
+    if (!textures[current]) {
+        textures[current] = context.createTexture(opacities, unit);
+    } else {
+        context.updateTexture(*textures[current], opacities, unit);
     }
     dirty = false;
 }
 
 void FrameHistory::bind(gl::Context& context, uint32_t unit) {
     upload(context, unit);
-    context.bindTexture(*texture, unit);
+    context.bindTexture(*textures[current], unit);
 }
 
 } // namespace mbgl
@@ -34,7 +34,8 @@ private:
     bool firstFrame = true;
     bool dirty = true;
 
-    mbgl::optional<gl::Texture> texture;
+    std::array<mbgl::optional<gl::Texture>, 3> textures;
+    std::size_t current = 0;
 };
 
 } // namespace mbgl
@@ -0,0 +1,89 @@
+#include <mbgl/renderer/gpu_timer.hpp>
+#include <mbgl/gl/context.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+constexpr std::size_t GPUTimer::maxPendingFrames;
+
+GPUTimer::GPUTimer(gl::Context& context_)
+    : context(context_) {
+    assert(context.supportsTimerQueries());
+}
+
+void GPUTimer::startSection(std::string name) {
+    endSection();
+    current.push_back({ std::move(name), takeQuery() });
+    context.beginTimerQuery(current.back().query);
+    active = true;
+}
+
+void GPUTimer::endSection() {
+    if (active) {
+        context.endTimerQuery();
+        active = false;
+    }
+}
+
+void GPUTimer::endFrame() {
+    endSection();
+    if (current.empty()) {
+        return;
+    }
+
+    pending.push_back(std::move(current));
+    current.clear();
+
+    if (pending.size() > maxPendingFrames) {
+        recycle(pending.front());
+        pending.pop_front();
+    }
+}
+
+std::vector<FrameStats> GPUTimer::collect() {
+    std::vector<FrameStats> result;
+
+    if (context.checkTimerDisjoint()) {
+        for (auto& frame : pending) {
+            recycle(frame);
+        }
+        pending.clear();
+        return result;
+    }
+
+    // Queries complete in order, so the last section of a frame completes after the others.
+    while (!pending.empty() && context.isQueryResultAvailable(pending.front().back().query)) {
+        Frame& frame = pending.front();
+
+        FrameStats stats;
+        stats.sections.reserve(frame.size());
+        for (auto& section : frame) {
+            stats.sections.push_back({ std::move(section.name), context.getTimerQueryResult(section.query) });
+        }
+        result.push_back(std::move(stats));
+
+        recycle(frame);
+        pending.pop_front();
+    }
+
+    return result;
+}
+
+gl::UniqueQuery GPUTimer::takeQuery() {
+    if (queries.empty()) {
+        return context.createQuery();
+    }
+    gl::UniqueQuery query = std::move(queries.back());
+    queries.pop_back();
+    return query;
+}
+
+void GPUTimer::recycle(Frame& frame) {
+    for (auto& section : frame) {
+        queries.push_back(std::move(section.query));
+    }
+    frame.clear();
+}
+
+} // namespace mbgl
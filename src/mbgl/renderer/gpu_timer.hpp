@@ -0,0 +1,58 @@
+#pragma once
+
+#include <mbgl/gl/object.hpp>
+#include <mbgl/map/frame_stats.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+namespace gl {
+class Context;
+} // namespace gl
+
+/*
+    Measures the GPU time of named sections of frames with timer queries. The GPU runs
+    behind the CPU, so the results of a frame become available a few frames later; `collect`
+    returns the stats of every frame whose results have arrived, oldest first.
+
+    Timer queries can't nest, so starting a section ends the one before it. Frames whose
+    results haven't arrived after `maxPendingFrames` frames, and those that were in flight
+    during a disjoint event, are dropped.
+*/
+class GPUTimer : private util::noncopyable {
+public:
+    explicit GPUTimer(gl::Context&);
+
+    void startSection(std::string name);
+    void endSection();
+
+    // Ends the current frame; its sections are reported by a later call to `collect`.
+    void endFrame();
+
+    std::vector<FrameStats> collect();
+
+    static constexpr std::size_t maxPendingFrames = 8;
+
+private:
+    struct Section {
+        std::string name;
+        gl::UniqueQuery query;
+    };
+
+    using Frame = std::vector<Section>;
+
+    gl::UniqueQuery takeQuery();
+    void recycle(Frame&);
+
+    gl::Context& context;
+    Frame current;
+    bool active = false;
+    std::deque<Frame> pending;
+    std::vector<gl::UniqueQuery> queries;
+};
+
+} // namespace mbgl
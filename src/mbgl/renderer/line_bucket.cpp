@@ -3,20 +3,63 @@
 #include <mbgl/style/layers/line_layer.hpp>
 #include <mbgl/style/bucket_parameters.hpp>
 #include <mbgl/style/layers/line_layer_impl.hpp>
+#include <mbgl/style/property_evaluator.hpp>
+#include <mbgl/style/data_driven_property_evaluator.hpp>
+#include <mbgl/tile/layout_cache.hpp>
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/constants.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 
 namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+// Lines narrower than this, in device pixels, look the same with bevel or miter joins and butt
+// caps as with round ones, which take more vertices.
+const float ROUND_JOIN_MIN_WIDTH = 2.0f;
+
+// The widest the layers draw the lines of a tile at zoom `z`, which is shown up to `z + 1`,
+// assuming widths change monotonically in between. Infinite without layers, or if the gap
+// width depends on the feature.
+float maxLineWidth(const std::vector<const Layer*>& layers, float z) {
+    if (layers.empty()) {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    float result = 0;
+    for (const auto& layer : layers) {
+        const LinePaintProperties::Unevaluated& paint = layer->as<LineLayer>()->impl->paint.unevaluated;
+        const auto& gapWidth = paint.get<LineGapWidth>().getValue();
+        if (gapWidth.isDataDriven()) {
+            return std::numeric_limits<float>::infinity();
+        }
+
+        for (const float zoom : { z, z + 1 }) {
+            const PropertyEvaluationParameters parameters(zoom);
+            const float width = paint.get<LineWidth>().getValue()
+                .evaluate(PropertyEvaluator<float>(parameters, LineWidth::defaultValue()));
+            const float gap = gapWidth
+                .evaluate(DataDrivenPropertyEvaluator<float>(parameters, LineGapWidth::defaultValue()))
+                .constantOr(0);
+            result = std::max(result, gap > 0 ? gap + 2 * width : width);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
 LineBucket::LineBucket(const BucketParameters& parameters,
                        const std::vector<const Layer*>& layers,
                        const style::LineLayoutProperties& layout_)
     : layout(layout_.evaluate(PropertyEvaluationParameters(parameters.tileID.overscaledZ))),
-      overscaling(parameters.tileID.overscaleFactor()) {
+      overscaling(parameters.tileID.overscaleFactor()),
+      simpleJoins(maxLineWidth(layers, parameters.tileID.overscaledZ) * parameters.pixelRatio < ROUND_JOIN_MIN_WIDTH) {
     for (const auto& layer : layers) {
         paintPropertyBinders.emplace(layer->getID(),
             LineProgram::PaintPropertyBinders(
@@ -26,8 +69,18 @@ LineBucket::LineBucket(const BucketParameters& parameters,
 }
 
 void LineBucket::addFeature(const GeometryTileFeature& feature,
-                            const GeometryCollection& geometryCollection) {
-    for (auto& line : geometryCollection) {
+                            const GeometryBuffer& geometry,
+                            std::size_t) {
+    // Reserve room for the whole feature up front; every vertex but the first two of each
+    // run completes one triangle.
+    std::size_t vertexBound = 0;
+    for (const auto& line : geometry) {
+        vertexBound += maxVertices(line.size());
+    }
+    vertices.reserveAdditional(vertexBound);
+    triangles.reserveAdditional(vertexBound * 3);
+
+    for (const auto& line : geometry) {
         addGeometry(line);
     }
 
@@ -61,7 +114,7 @@ const float LINE_DISTANCE_SCALE = 1.0 / 2.0;
 // The maximum line distance, in tile units, that fits in the buffer.
 const float MAX_LINE_DISTANCE = std::pow(2, LINE_DISTANCE_BUFFER_BITS) / LINE_DISTANCE_SCALE;
 
-void LineBucket::addGeometry(const GeometryCoordinates& coordinates) {
+void LineBucket::addGeometry(const GeometryCoordinatesView& coordinates) {
     const std::size_t len = [&coordinates] {
         std::size_t l = coordinates.size();
         // If the line has duplicate vertices at the end, adjust length to remove them.
@@ -89,8 +142,9 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates) {
         return;
     }
 
-    const LineCapType beginCap = layout.get<LineCap>();
-    const LineCapType endCap = closed ? LineCapType::Butt : LineCapType(layout.get<LineCap>());
+    const LineCapType cap = simpleJoins && layout.get<LineCap>() == LineCapType::Round ? LineCapType::Butt : LineCapType(layout.get<LineCap>());
+    const LineCapType beginCap = cap;
+    const LineCapType endCap = closed ? LineCapType::Butt : cap;
 
     double distance = 0;
     bool startOfLine = true;
@@ -108,8 +162,10 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates) {
         nextNormal = util::perp(util::unit(convertPoint<double>(firstCoordinate - *currentCoordinate)));
     }
 
+    // Triangles are added with indices relative to the line's first vertex, and moved to
+    // their segment's base once all of the line's vertices are known.
     const std::size_t startVertex = vertices.vertexSize();
-    std::vector<TriangleElement> triangleStore;
+    const std::size_t startIndex = triangles.indexSize();
 
     for (std::size_t i = 0; i < len; ++i) {
         if (closed && i == len - 1) {
@@ -184,7 +240,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates) {
             if (prevSegmentLength > 2.0 * sharpCornerOffset) {
                 GeometryCoordinate newPrevVertex = *currentCoordinate - convertPoint<int16_t>(util::round(convertPoint<double>(*currentCoordinate - *prevCoordinate) * (sharpCornerOffset / prevSegmentLength)));
                 distance += util::dist<double>(newPrevVertex, *prevCoordinate);
-                addCurrentVertex(newPrevVertex, distance, *prevNormal, 0, 0, false, startVertex, triangleStore);
+                addCurrentVertex(newPrevVertex, distance, *prevNormal, 0, 0, false, startVertex);
                 prevCoordinate = newPrevVertex;
             }
         }
@@ -195,7 +251,9 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates) {
         const LineCapType currentCap = nextCoordinate ? beginCap : endCap;
 
         if (middleVertex) {
-            if (currentJoin == LineJoinType::Round) {
+            if (currentJoin == LineJoinType::Round && simpleJoins) {
+                currentJoin = LineJoinType::Bevel;
+            } else if (currentJoin == LineJoinType::Round) {
                 if (miterLength < layout.get<LineRoundLimit>()) {
                     currentJoin = LineJoinType::Miter;
                 } else if (miterLength <= 2) {
@@ -228,8 +286,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates) {
 
         if (middleVertex && currentJoin == LineJoinType::Miter) {
             joinNormal = joinNormal * miterLength;
-            addCurrentVertex(*currentCoordinate, distance, joinNormal, 0, 0, false, startVertex,
-                             triangleStore);
+            addCurrentVertex(*currentCoordinate, distance, joinNormal, 0, 0, false, startVertex);
 
         } else if (middleVertex && currentJoin == LineJoinType::FlipBevel) {
             // miter is too big, flip the direction to make a beveled join
@@ -244,11 +301,9 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates) {
                 joinNormal = util::perp(joinNormal) * bevelLength * direction;
             }
 
-            addCurrentVertex(*currentCoordinate, distance, joinNormal, 0, 0, false, startVertex,
-                             triangleStore);
+            addCurrentVertex(*currentCoordinate, distance, joinNormal, 0, 0, false, startVertex);
 
-            addCurrentVertex(*currentCoordinate, distance, joinNormal * -1.0, 0, 0, false, startVertex,
-                             triangleStore);
+            addCurrentVertex(*currentCoordinate, distance, joinNormal * -1.0, 0, 0, false, startVertex);
         } else if (middleVertex && (currentJoin == LineJoinType::Bevel || currentJoin == LineJoinType::FakeRound)) {
             const bool lineTurnsLeft = (prevNormal->x * nextNormal->y - prevNormal->y * nextNormal->x) > 0;
             const float offset = -std::sqrt(miterLength * miterLength - 1);
@@ -265,8 +320,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates) {
 
             // Close previous segement with bevel
             if (!startOfLine) {
-                addCurrentVertex(*currentCoordinate, distance, *prevNormal, offsetA, offsetB, false,
-                                 startVertex, triangleStore);
+                addCurrentVertex(*currentCoordinate, distance, *prevNormal, offsetA, offsetB, false, startVertex);
             }
 
             if (currentJoin == LineJoinType::FakeRound) {
@@ -281,41 +335,38 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates) {
 
                 for (int m = 0; m < n; m++) {
                     auto approxFractionalJoinNormal = util::unit(*nextNormal * ((m + 1.0) / (n + 1.0)) + *prevNormal);
-                    addPieSliceVertex(*currentCoordinate, distance, approxFractionalJoinNormal, lineTurnsLeft, startVertex, triangleStore);
+                    addPieSliceVertex(*currentCoordinate, distance, approxFractionalJoinNormal, lineTurnsLeft, startVertex);
                 }
 
-                addPieSliceVertex(*currentCoordinate, distance, joinNormal, lineTurnsLeft, startVertex, triangleStore);
+                addPieSliceVertex(*currentCoordinate, distance, joinNormal, lineTurnsLeft, startVertex);
 
                 for (int k = n - 1; k >= 0; k--) {
                     auto approxFractionalJoinNormal = util::unit(*prevNormal * ((k + 1.0) / (n + 1.0)) + *nextNormal);
-                    addPieSliceVertex(*currentCoordinate, distance, approxFractionalJoinNormal, lineTurnsLeft, startVertex, triangleStore);
+                    addPieSliceVertex(*currentCoordinate, distance, approxFractionalJoinNormal, lineTurnsLeft, startVertex);
                 }
             }
 
             // Start next segment
             if (nextCoordinate) {
                 addCurrentVertex(*currentCoordinate, distance, *nextNormal, -offsetA, -offsetB,
-                                 false, startVertex, triangleStore);
+                                 false, startVertex);
             }
 
         } else if (!middleVertex && currentCap == LineCapType::Butt) {
             if (!startOfLine) {
                 // Close previous segment with a butt
-                addCurrentVertex(*currentCoordinate, distance, *prevNormal, 0, 0, false,
-                                 startVertex, triangleStore);
+                addCurrentVertex(*currentCoordinate, distance, *prevNormal, 0, 0, false, startVertex);
             }
 
             // Start next segment with a butt
             if (nextCoordinate) {
-                addCurrentVertex(*currentCoordinate, distance, *nextNormal, 0, 0, false,
-                                 startVertex, triangleStore);
+                addCurrentVertex(*currentCoordinate, distance, *nextNormal, 0, 0, false, startVertex);
             }
 
         } else if (!middleVertex && currentCap == LineCapType::Square) {
             if (!startOfLine) {
                 // Close previous segment with a square cap
-                addCurrentVertex(*currentCoordinate, distance, *prevNormal, 1, 1, false,
-                                 startVertex, triangleStore);
+                addCurrentVertex(*currentCoordinate, distance, *prevNormal, 1, 1, false, startVertex);
 
                 // The segment is done. Unset vertices to disconnect segments.
                 e1 = e2 = -1;
@@ -323,19 +374,16 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates) {
 
             // Start next segment
             if (nextCoordinate) {
-                addCurrentVertex(*currentCoordinate, distance, *nextNormal, -1, -1, false,
-                                 startVertex, triangleStore);
+                addCurrentVertex(*currentCoordinate, distance, *nextNormal, -1, -1, false, startVertex);
             }
 
         } else if (middleVertex ? currentJoin == LineJoinType::Round : currentCap == LineCapType::Round) {
             if (!startOfLine) {
                 // Close previous segment with a butt
-                addCurrentVertex(*currentCoordinate, distance, *prevNormal, 0, 0, false,
-                                 startVertex, triangleStore);
+                addCurrentVertex(*currentCoordinate, distance, *prevNormal, 0, 0, false, startVertex);
 
                 // Add round cap or linejoin at end of segment
-                addCurrentVertex(*currentCoordinate, distance, *prevNormal, 1, 1, true, startVertex,
-                                 triangleStore);
+                addCurrentVertex(*currentCoordinate, distance, *prevNormal, 1, 1, true, startVertex);
 
                 // The segment is done. Unset vertices to disconnect segments.
                 e1 = e2 = -1;
@@ -345,10 +393,9 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates) {
             if (nextCoordinate) {
                 // Add round cap before first segment
                 addCurrentVertex(*currentCoordinate, distance, *nextNormal, -1, -1, true,
-                                 startVertex, triangleStore);
+                                 startVertex);
 
-                addCurrentVertex(*currentCoordinate, distance, *nextNormal, 0, 0, false,
-                                 startVertex, triangleStore);
+                addCurrentVertex(*currentCoordinate, distance, *nextNormal, 0, 0, false, startVertex);
             }
         }
 
@@ -357,7 +404,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates) {
             if (nextSegmentLength > 2 * sharpCornerOffset) {
                 GeometryCoordinate newCurrentVertex = *currentCoordinate + convertPoint<int16_t>(util::round(convertPoint<double>(*nextCoordinate - *currentCoordinate) * (sharpCornerOffset / nextSegmentLength)));
                 distance += util::dist<double>(newCurrentVertex, *currentCoordinate);
-                addCurrentVertex(newCurrentVertex, distance, *nextNormal, 0, 0, false, startVertex, triangleStore);
+                addCurrentVertex(newCurrentVertex, distance, *nextNormal, 0, 0, false, startVertex);
                 currentCoordinate = newCurrentVertex;
             }
         }
@@ -369,19 +416,31 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates) {
     const std::size_t vertexCount = endVertex - startVertex;
 
     if (segments.empty() || segments.back().vertexLength + vertexCount > std::numeric_limits<uint16_t>::max()) {
-        segments.emplace_back(startVertex, triangles.indexSize());
+        segments.emplace_back(startVertex, startIndex);
     }
 
     auto& segment = segments.back();
     assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
     uint16_t index = segment.vertexLength;
 
-    for (const auto& triangle : triangleStore) {
-        triangles.emplace_back(index + triangle.a, index + triangle.b, index + triangle.c);
+    if (index != 0) {
+        triangles.offset(startIndex, index);
     }
 
     segment.vertexLength += vertexCount;
-    segment.indexLength += triangleStore.size() * 3;
+    segment.indexLength += triangles.indexSize() - startIndex;
+}
+
+std::size_t LineBucket::maxVertices(std::size_t length) const {
+    // A coordinate at a sharp corner is moved off it on both sides, with a vertex pair each.
+    const std::size_t sharpCorner = 4;
+
+    // Then it gets a join, or a cap at the ends of the line, of at most two vertex pairs;
+    // miter joins may fall back to bevels. A round join may be a fake round one instead,
+    // with up to nine pie slices between its two vertex pairs.
+    const std::size_t join = layout.get<LineJoin>() == LineJoinType::Round && !simpleJoins ? 13 : 4;
+
+    return length * (sharpCorner + join);
 }
 
 void LineBucket::addCurrentVertex(const GeometryCoordinate& currentCoordinate,
@@ -390,15 +449,14 @@ void LineBucket::addCurrentVertex(const GeometryCoordinate& currentCoordinate,
                                   double endLeft,
                                   double endRight,
                                   bool round,
-                                  std::size_t startVertex,
-                                  std::vector<TriangleElement>& triangleStore) {
+                                  std::size_t startVertex) {
     Point<double> extrude = normal;
     if (endLeft)
         extrude = extrude - (util::perp(normal) * endLeft);
     vertices.emplace_back(LineProgram::layoutVertex(currentCoordinate, extrude, { round, false }, endLeft, distance * LINE_DISTANCE_SCALE));
     e3 = vertices.vertexSize() - 1 - startVertex;
     if (e1 >= 0 && e2 >= 0) {
-        triangleStore.emplace_back(e1, e2, e3);
+        triangles.emplace_back(e1, e2, e3);
     }
     e1 = e2;
     e2 = e3;
@@ -409,7 +467,7 @@ void LineBucket::addCurrentVertex(const GeometryCoordinate& currentCoordinate,
     vertices.emplace_back(LineProgram::layoutVertex(currentCoordinate, extrude, { round, true }, -endRight, distance * LINE_DISTANCE_SCALE));
     e3 = vertices.vertexSize() - 1 - startVertex;
     if (e1 >= 0 && e2 >= 0) {
-        triangleStore.emplace_back(e1, e2, e3);
+        triangles.emplace_back(e1, e2, e3);
     }
     e1 = e2;
     e2 = e3;
@@ -420,7 +478,7 @@ void LineBucket::addCurrentVertex(const GeometryCoordinate& currentCoordinate,
     // to `linesofar`.
     if (distance > MAX_LINE_DISTANCE / 2.0f) {
         distance = 0;
-        addCurrentVertex(currentCoordinate, distance, normal, endLeft, endRight, round, startVertex, triangleStore);
+        addCurrentVertex(currentCoordinate, distance, normal, endLeft, endRight, round, startVertex);
     }
 }
 
@@ -428,13 +486,12 @@ void LineBucket::addPieSliceVertex(const GeometryCoordinate& currentVertex,
                                    double distance,
                                    const Point<double>& extrude,
                                    bool lineTurnsLeft,
-                                   std::size_t startVertex,
-                                   std::vector<TriangleElement>& triangleStore) {
+                                   std::size_t startVertex) {
     Point<double> flippedExtrude = extrude * (lineTurnsLeft ? -1.0 : 1.0);
     vertices.emplace_back(LineProgram::layoutVertex(currentVertex, flippedExtrude, { false, lineTurnsLeft }, 0, distance * LINE_DISTANCE_SCALE));
     e3 = vertices.vertexSize() - 1 - startVertex;
     if (e1 >= 0 && e2 >= 0) {
-        triangleStore.emplace_back(e1, e2, e3);
+        triangles.emplace_back(e1, e2, e3);
     }
 
     if (lineTurnsLeft) {
@@ -445,8 +502,10 @@ void LineBucket::addPieSliceVertex(const GeometryCoordinate& currentVertex,
 }
 
 void LineBucket::upload(gl::Context& context) {
+    gl::ResourceOwnerScope owner { context, GLResourceStats::Owner::Line };
+
     vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    indexBuffer = context.createIndexBuffer(std::move(triangles));
+    indexBuffer = context.createIndexBuffer(std::move(triangles), segments);
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(context);
@@ -466,4 +525,57 @@ bool LineBucket::hasData() const {
     return !segments.empty();
 }
 
+bool LineBucket::write(LayoutWriter& writer) const {
+    for (const auto& pair : paintPropertyBinders) {
+        if (!pair.second.isConstant()) {
+            return false;
+        }
+    }
+
+    // Joins and caps depend on the line width, which isn't part of the key.
+    writer.write(simpleJoins);
+    writer.writeArray(vertices.data(), vertices.vertexSize());
+    writer.writeArray(triangles.data(), triangles.indexSize());
+    writer.writeSegments(segments);
+    return true;
+}
+
+bool LineBucket::read(LayoutReader& reader) {
+    for (const auto& pair : paintPropertyBinders) {
+        if (!pair.second.isConstant()) {
+            return false;
+        }
+    }
+
+    bool simpleJoins_;
+    std::vector<LineLayoutVertex> vertices_;
+    std::vector<uint16_t> triangles_;
+    if (!reader.read(simpleJoins_) || simpleJoins_ != simpleJoins ||
+        !reader.readArray(vertices_) ||
+        !reader.readArray(triangles_) || triangles_.size() % 3 != 0 ||
+        !reader.readSegments(segments)) {
+        return false;
+    }
+
+    vertices.assign(std::move(vertices_));
+    triangles.assign(std::move(triangles_));
+    return true;
+}
+
+std::size_t LineBucket::getVertexCount() const {
+    return vertices.vertexSize();
+}
+
+void LineBucket::addMemoryUsage(MemoryStats::Source& source) const {
+    source.bucket(MemoryStats::BucketType::Line) += memoryUsage();
+}
+
+std::size_t LineBucket::measureByteSize() const {
+    std::size_t result = vertices.byteSize() + triangles.byteSize();
+    for (const auto& pair : paintPropertyBinders) {
+        result += pair.second.byteSize();
+    }
+    return result;
+}
+
 } // namespace mbgl
@@ -23,8 +23,13 @@ public:
                const style::LineLayoutProperties&);
 
     void addFeature(const GeometryTileFeature&,
-                    const GeometryCollection&) override;
+                    const GeometryBuffer&,
+                    std::size_t) override;
     bool hasData() const override;
+    void addMemoryUsage(MemoryStats::Source&) const override;
+    std::size_t getVertexCount() const override;
+    bool write(LayoutWriter&) const override;
+    bool read(LayoutReader&) override;
 
     void upload(gl::Context&) override;
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
@@ -40,25 +45,31 @@ public:
 
     std::unordered_map<std::string, LineProgram::PaintPropertyBinders> paintPropertyBinders;
 
+protected:
+    std::size_t measureByteSize() const override;
+
 private:
-    void addGeometry(const GeometryCoordinates& line);
+    void addGeometry(const GeometryCoordinatesView& line);
+
+    // An upper bound of the number of vertices `addGeometry` adds for a line of `length`
+    // coordinates, barring resets of the line distance.
+    std::size_t maxVertices(std::size_t length) const;
 
-    struct TriangleElement {
-        TriangleElement(uint16_t a_, uint16_t b_, uint16_t c_) : a(a_), b(b_), c(c_) {}
-        uint16_t a, b, c;
-    };
     void addCurrentVertex(const GeometryCoordinate& currentVertex, double& distance,
             const Point<double>& normal, double endLeft, double endRight, bool round,
-            std::size_t startVertex, std::vector<LineBucket::TriangleElement>& triangleStore);
+            std::size_t startVertex);
     void addPieSliceVertex(const GeometryCoordinate& currentVertex, double distance,
-            const Point<double>& extrude, bool lineTurnsLeft, std::size_t startVertex,
-            std::vector<TriangleElement>& triangleStore);
+            const Point<double>& extrude, bool lineTurnsLeft, std::size_t startVertex);
 
     std::ptrdiff_t e1;
     std::ptrdiff_t e2;
     std::ptrdiff_t e3;
 
     const uint32_t overscaling;
+
+    // Whether round joins and caps are drawn as bevel or miter joins and butt caps, for lines
+    // too narrow to tell them apart.
+    const bool simpleJoins;
 };
 
 } // namespace mbgl
@@ -1,6 +1,7 @@
 #include <mbgl/renderer/painter.hpp>
 #include <mbgl/renderer/paint_parameters.hpp>
 #include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/renderer/fill_bucket.hpp>
 
 #include <mbgl/style/source.hpp>
 #include <mbgl/style/source_impl.hpp>
@@ -14,6 +15,13 @@
 #include <mbgl/style/layer_impl.hpp>
 
 #include <mbgl/style/layers/background_layer.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/fill_layer_impl.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer.hpp>
+#include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/style/layers/raster_layer.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/layers/custom_layer.hpp>
 #include <mbgl/style/layers/custom_layer_impl.hpp>
 
@@ -30,12 +38,15 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/mat3.hpp>
 #include <mbgl/util/string.hpp>
+#include <mbgl/util/trace.hpp>
 
 #include <mbgl/util/offscreen_texture.hpp>
 
 #include <cassert>
+#include <cmath>
 #include <algorithm>
 #include <iostream>
+#include <limits>
 #include <unordered_set>
 
 namespace mbgl {
@@ -77,26 +88,63 @@ static gl::VertexVector<RasterLayoutVertex> rasterVertices() {
     return result;
 }
 
-Painter::Painter(gl::Context& context_, const TransformState& state_, float pixelRatio)
+// The corners of the viewport, as fractions of its size, in the same order as `tileVertices`
+// so that they share its indices.
+static gl::VertexVector<ExtrusionTextureLayoutVertex> extrusionTextureVertices() {
+    gl::VertexVector<ExtrusionTextureLayoutVertex> result;
+    result.emplace_back(ExtrusionTextureProgram::layoutVertex({ 0, 0 }));
+    result.emplace_back(ExtrusionTextureProgram::layoutVertex({ 1, 0 }));
+    result.emplace_back(ExtrusionTextureProgram::layoutVertex({ 0, 1 }));
+    result.emplace_back(ExtrusionTextureProgram::layoutVertex({ 1, 1 }));
+    return result;
+}
+
+// The corners in the same order as `tileVertices`, so that they share its indices. Symbol
+// quads list their corners in this order too.
+static gl::VertexVector<CircleQuadVertex> quadVertices() {
+    gl::VertexVector<CircleQuadVertex> result;
+    result.emplace_back(CircleInstancedProgram::quadVertex(0, 0));
+    result.emplace_back(CircleInstancedProgram::quadVertex(1, 0));
+    result.emplace_back(CircleInstancedProgram::quadVertex(0, 1));
+    result.emplace_back(CircleInstancedProgram::quadVertex(1, 1));
+    return result;
+}
+
+// Painters with the same parameters use the same programs, if their contexts share them.
+static std::shared_ptr<Programs> sharedPrograms(gl::Context& context, const ProgramParameters& parameters) {
+    const std::string key = "programs/" + util::toString(parameters.pixelRatio) +
+        (parameters.overdraw ? "/overdraw/" : "/") + parameters.cacheDir.value_or("");
+    return context.getSharedResource<Programs>(key, [&] {
+        return std::make_shared<Programs>(parameters);
+    });
+}
+
+Painter::Painter(gl::Context& context_,
+                 const TransformState& state_,
+                 float pixelRatio,
+                 const optional<std::string>& programCacheDir)
     : context(context_),
       state(state_),
       tileVertexBuffer(context.createVertexBuffer(tileVertices())),
       rasterVertexBuffer(context.createVertexBuffer(rasterVertices())),
+      quadVertexBuffer(context.createVertexBuffer(quadVertices())),
       tileTriangleIndexBuffer(context.createIndexBuffer(tileTriangleIndices())),
-      tileBorderIndexBuffer(context.createIndexBuffer(tileLineStripIndices())) {
+      tileBorderIndexBuffer(context.createIndexBuffer(tileLineStripIndices())),
+      extrusionTextureVertexBuffer(context.createVertexBuffer(extrusionTextureVertices())) {
 
     tileTriangleSegments.emplace_back(0, 0, 4, 6);
     tileBorderSegments.emplace_back(0, 0, 4, 5);
     rasterSegments.emplace_back(0, 0, 4, 6);
+    extrusionTextureSegments.emplace_back(0, 0, 4, 6);
 
     gl::debugging::enable();
 
-    ProgramParameters programParameters{ pixelRatio, false };
-    programs = std::make_unique<Programs>(context, programParameters);
+    ProgramParameters programParameters{ pixelRatio, false, programCacheDir };
+    programs = sharedPrograms(context, programParameters);
 #ifndef NDEBUG
 
-    ProgramParameters programParametersOverdraw{ pixelRatio, true };
-    overdrawPrograms = std::make_unique<Programs>(context, programParametersOverdraw);
+    ProgramParameters programParametersOverdraw{ pixelRatio, true, programCacheDir };
+    overdrawPrograms = sharedPrograms(context, programParametersOverdraw);
 #endif
 }
 
@@ -106,14 +154,24 @@ bool Painter::needsAnimation() const {
     return frameHistory.needsAnimation(util::DEFAULT_FADE_DURATION);
 }
 
+std::vector<FrameStats> Painter::collectFrameStats() {
+    return gpuTimer ? gpuTimer->collect() : std::vector<FrameStats>();
+}
+
 void Painter::cleanup() {
     context.performCleanup();
 }
 
 void Painter::render(const Style& style, const FrameData& frame_, View& view, SpriteAtlas& annotationSpriteAtlas) {
+    MBGL_TRACE_SCOPE("render", "frame");
+
     frame = frame_;
     if (frame.contextMode == GLContextMode::Shared) {
         context.setDirtyState();
+    } else if (context.sharesResources()) {
+        // Another context may have deleted the program last used by this one since, and the
+        // name may have been reused.
+        context.program.setDirty();
     }
 
     PaintParameters parameters {
@@ -125,14 +183,30 @@ void Painter::render(const Style& style, const FrameData& frame_, View& view, Sp
         view
     };
 
+    if (frame.measureGPUTime && context.supportsTimerQueries()) {
+        if (!gpuTimer) {
+            gpuTimer = std::make_unique<GPUTimer>(context);
+        }
+    } else {
+        gpuTimer.reset();
+    }
+
+    previousFillBatches = std::move(fillBatches);
+    fillBatches.clear();
+
     glyphAtlas = style.glyphAtlas.get();
     spriteAtlas = style.spriteAtlas.get();
     lineAtlas = style.lineAtlas.get();
 
-    RenderData renderData = style.getRenderData(frame.debugOptions, state.getAngle());
+    const RenderData& renderData = style.getRenderData(frame.debugOptions, state.getAngle());
     const std::vector<RenderItem>& order = renderData.order;
     const std::unordered_set<Source*>& sources = renderData.sources;
 
+    renderStats = {};
+    for (const auto& source : sources) {
+        renderStats.tiles[source->getID()] = source->baseImpl->getRenderTiles().size();
+    }
+
     // Update the default matrices to the current viewport dimensions.
     state.getProjMatrix(projMatrix);
 
@@ -149,19 +223,59 @@ void Painter::render(const Style& style, const FrameData& frame_, View& view, Sp
     // Uploads all required buffers and images before we do any actual rendering.
     {
         MBGL_DEBUG_GROUP("upload");
+        MBGL_TRACE_SCOPE("render", "upload");
+        if (gpuTimer) { gpuTimer->startSection("upload"); }
+
+        auto countAtlasUpload = [&] (auto upload) {
+            const std::size_t uploadedBytes = context.uploadedBytes;
+            upload();
+            if (context.uploadedBytes != uploadedBytes) {
+                renderStats.atlasUploads++;
+            }
+        };
 
-        spriteAtlas->upload(context, 0);
-
-        lineAtlas->upload(context, 0);
-        glyphAtlas->upload(context, 0);
+        countAtlasUpload([&] { spriteAtlas->upload(context, 0); });
+        countAtlasUpload([&] { lineAtlas->upload(context, 0); });
+        countAtlasUpload([&] { glyphAtlas->upload(context, 0); });
         frameHistory.upload(context, 0);
-        annotationSpriteAtlas.upload(context, 0);
+        countAtlasUpload([&] { annotationSpriteAtlas.upload(context, 0); });
 
         for (const auto& item : order) {
             if (item.bucket && item.bucket->needsUpload()) {
                 item.bucket->upload(context);
+                context.bucketUploads++;
             }
         }
+
+        if (gpuTimer) { gpuTimer->endSection(); }
+    }
+
+    // - REDRAW REGION ---------------------------------------------------------------------------
+    // Finds what changed since the frame the view holds, so that only that is drawn.
+    if (frame.partialRedraw) {
+        const uint32_t bufferAge = view.getBufferAge();
+        view.bind();
+        redrawRegion = findRedrawRegion(view, renderData, bufferAge);
+    } else {
+        redrawRegion = {};
+        if (!changedRegions.empty()) {
+            viewContents = {};
+            changedRegions.clear();
+        }
+    }
+
+    if (redrawRegion && !redrawRegion->size) {
+        // The view still shows this frame.
+        if (gpuTimer) { gpuTimer->endFrame(); }
+        return;
+    }
+
+    // - 3D PASS -----------------------------------------------------------------------------------
+    // Renders fill extrusions into offscreen textures, before anything is drawn into the view.
+    {
+        MBGL_DEBUG_GROUP("3d");
+        MBGL_TRACE_SCOPE("render", "3d");
+        render3D(parameters, order);
     }
 
     // - CLEAR -------------------------------------------------------------------------------------
@@ -170,6 +284,9 @@ void Painter::render(const Style& style, const FrameData& frame_, View& view, Sp
     {
         MBGL_DEBUG_GROUP("clear");
         view.bind();
+        clipToRedrawRegion();
+        renderStats.drawnPixels = redrawRegion ? redrawRegion->size.area()
+                                               : context.viewport.getCurrentValue().size.area();
         context.clear(paintMode() == PaintMode::Overdraw
                         ? Color::black()
                         : renderData.backgroundColor,
@@ -181,24 +298,48 @@ void Painter::render(const Style& style, const FrameData& frame_, View& view, Sp
     // Draws the clipping masks to the stencil buffer.
     {
         MBGL_DEBUG_GROUP("clip");
+        if (gpuTimer) { gpuTimer->startSection("clip"); }
+
+        // Clip IDs are only assigned again with new render data. The masks are drawn every
+        // frame, since the stencil buffer is cleared with it and they follow the camera.
+        if (renderData.revision != clipIDsRevision) {
+            algorithm::ClipIDGenerator generator;
+            for (const auto& source : sources) {
+                source->baseImpl->updateClipIDs(generator);
+            }
+            stencils = generator.getStencils();
+            clipIDsRevision = renderData.revision;
+        }
 
-        // Update all clipping IDs.
-        algorithm::ClipIDGenerator generator;
         for (const auto& source : sources) {
-            source->baseImpl->startRender(generator, projMatrix, state);
+            source->baseImpl->startRender(projMatrix, state);
         }
 
-        MBGL_DEBUG_GROUP("clipping masks");
-
-        for (const auto& stencil : generator.getStencils()) {
-            MBGL_DEBUG_GROUP(std::string{ "mask: " } + util::toString(stencil.first));
-            renderClippingMask(stencil.first, stencil.second);
+        // Without rotation or pitch, a tile covers an axis-aligned rectangle of the screen.
+        // When no tile of a source overlaps another, that rectangle is the tile's clip
+        // region, and no stencil masks are needed.
+        scissorClipping = state.getAngle() == 0 && state.getPitch() == 0 &&
+            !(frame.debugOptions & MapDebugOptions::StencilClip) &&
+            std::all_of(sources.begin(), sources.end(), [] (const Source* source) {
+                return source->baseImpl->tilesClippedToExtent();
+            });
+
+        if (!scissorClipping) {
+            MBGL_DEBUG_GROUP("clipping masks");
+
+            for (const auto& stencil : stencils) {
+                MBGL_DEBUG_GROUP(std::string{ "mask: " } + util::toString(stencil.first));
+                renderClippingMask(stencil.first, stencil.second);
+            }
         }
+
+        if (gpuTimer) { gpuTimer->endSection(); }
     }
 
 #if not MBGL_USE_GLES2 and not defined(NDEBUG)
     if (frame.debugOptions & MapDebugOptions::StencilClip) {
         renderClipMasks(parameters);
+        if (gpuTimer) { gpuTimer->endFrame(); }
         return;
     }
 #endif
@@ -206,29 +347,60 @@ void Painter::render(const Style& style, const FrameData& frame_, View& view, Sp
     // Actually render the layers
     if (debug::renderTree) { Log::Info(Event::Render, "{"); indent++; }
 
+    cullOccludedItems(order);
+    const std::vector<RenderItem>& visible = visibleItems;
+
+    // - TILE CACHE PASS ---------------------------------------------------------------------------
+    // Renders the tiles drawn from the tile render cache whose textures are out of date. The
+    // items in `cached` are then drawn with the textures, in place of the layers.
+    std::pair<std::size_t, std::size_t> cached { 0, 0 };
+    if (frame.tileRenderCache) {
+        MBGL_DEBUG_GROUP("tile cache");
+        MBGL_TRACE_SCOPE("render", "tile cache");
+        cached = updateTileRenderCache(parameters, style, visible);
+    } else if (!cachedTiles.empty()) {
+        releaseTileRenderCache();
+    }
+
     // TODO: Correctly compute the number of layers recursively beforehand.
-    depthRangeSize = 1 - (order.size() + 2) * numSublayers * depthEpsilon;
+    depthRangeSize = 1 - (visible.size() + 2) * numSublayers * depthEpsilon;
+
+    const uint32_t layers = static_cast<uint32_t>(visible.size());
 
     // - OPAQUE PASS -------------------------------------------------------------------------------
     // Render everything top-to-bottom by using reverse iterators. Render opaque objects first.
     renderPass(parameters,
                RenderPass::Opaque,
-               order.rbegin(), order.rend(),
+               visible.rbegin(), visible.rend() - cached.second,
                0, 1);
+    renderPass(parameters,
+               RenderPass::Opaque,
+               visible.rend() - cached.first, visible.rend(),
+               layers - static_cast<uint32_t>(cached.first), 1);
 
     // - TRANSLUCENT PASS --------------------------------------------------------------------------
     // Make a second pass, rendering translucent objects. This time, we render bottom-to-top.
     renderPass(parameters,
                RenderPass::Translucent,
-               order.begin(), order.end(),
-               static_cast<uint32_t>(order.size()) - 1, -1);
+               visible.begin(), visible.begin() + cached.first,
+               layers - 1, -1);
+    if (cached.first != cached.second) {
+        renderCachedTiles(parameters, layers - 1 - static_cast<uint32_t>(cached.first));
+    }
+    renderPass(parameters,
+               RenderPass::Translucent,
+               visible.begin() + cached.second, visible.end(),
+               layers - 1 - static_cast<uint32_t>(cached.second), -1);
 
     if (debug::renderTree) { Log::Info(Event::Render, "}"); indent--; }
 
+    if (gpuTimer) { gpuTimer->endFrame(); }
+
     // - DEBUG PASS --------------------------------------------------------------------------------
     // Renders debug overlays.
     {
         MBGL_DEBUG_GROUP("debug");
+        clipToRedrawRegion();
 
         // Finalize the rendering, e.g. by calling debug render calls per tile.
         // This guarantees that we have at least one function per tile called.
@@ -256,9 +428,278 @@ void Painter::render(const Style& style, const FrameData& frame_, View& view, Sp
         context.texture[0] = 0;
 
         context.vertexArrayObject = 0;
+        context.scissorTest = false;
+    }
+}
+
+void Painter::cullOccludedItems(const std::vector<RenderItem>& order) {
+    // An opaque, untranslated fill hides everything beneath it within its tile if one of its
+    // polygons covers the tile, and nothing else of its source is drawn inside the tile.
+    auto coversTile = [] (const RenderItem& item) {
+        if (!item.tile || !item.tile->clippedToExtent || !item.layer.is<FillLayer>() ||
+            !static_cast<const FillBucket&>(*item.bucket).coversExtent) {
+            return false;
+        }
+        const FillPaintProperties::Evaluated& properties = item.layer.as<FillLayer>()->impl->paint.evaluated;
+        const std::array<float, 2>& translate = properties.get<FillTranslate>();
+        return properties.get<FillPattern>().from.empty()
+            && properties.get<FillColor>().isConstant()
+            && properties.get<FillColor>().constantOr(Color()).a >= 1.0f
+            && properties.get<FillOpacity>().isConstant()
+            && properties.get<FillOpacity>().constantOr(0) >= 1.0f
+            && translate[0] == 0 && translate[1] == 0;
+    };
+
+    // Only these layers are drawn within their tile's clip region. Circles and symbols can
+    // extend into neighbouring tiles.
+    auto clippedToTile = [] (const RenderItem& item) {
+        return item.tile &&
+            (item.layer.is<FillLayer>() || item.layer.is<LineLayer>() || item.layer.is<RasterLayer>());
+    };
+
+    coveredTiles.clear();
+    occludedItems.assign(order.size(), false);
+
+    for (std::size_t i = order.size(); i-- > 0;) {
+        const RenderItem& item = order[i];
+        occludedItems[i] = clippedToTile(item) &&
+            std::any_of(coveredTiles.begin(), coveredTiles.end(), [&] (const UnwrappedTileID& id) {
+                return item.tile->id == id || item.tile->id.isChildOf(id);
+            });
+        if (!occludedItems[i] && coversTile(item)) {
+            coveredTiles.push_back(item.tile->id);
+        }
+    }
+
+    visibleItems.clear();
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        if (!occludedItems[i]) {
+            visibleItems.push_back(order[i]);
+        }
     }
 }
 
+// Larger textures would take long to render again, and may exceed what the GPU supports.
+static constexpr uint32_t maxCachedTileSize = 2048;
+
+std::pair<std::size_t, std::size_t> Painter::updateTileRenderCache(PaintParameters& parameters,
+                                                                   const Style& style,
+                                                                   const std::vector<RenderItem>& visible) {
+    cachedTileOrder.clear();
+
+    // Layers beneath those of the cache, such as backgrounds, are drawn as usual.
+    std::size_t begin = 0;
+    while (begin < visible.size() && !visible[begin].tile) {
+        begin++;
+    }
+
+    // Fills, lines and rasters are clipped to their tile, and look the same wherever the tile
+    // is in the view. The layers of one source only, since their tiles don't overlap.
+    auto cacheable = [&] (const RenderItem& item) {
+        return item.tile && item.bucket &&
+            item.layer.baseImpl->source == visible[begin].layer.baseImpl->source &&
+            (item.layer.is<FillLayer>() || item.layer.is<LineLayer>() || item.layer.is<RasterLayer>());
+    };
+    std::size_t end = begin;
+    while (end < visible.size() && cacheable(visible[end])) {
+        end++;
+    }
+
+    // The textures are drawn as they were rendered, which only matches the layers while the
+    // camera doesn't rotate or pitch, and the style doesn't animate.
+    bool usable = begin != end &&
+        frame.mapMode == MapMode::Continuous &&
+        paintMode() == PaintMode::Regular &&
+        state.getAngle() == 0 && state.getPitch() == 0 &&
+        !style.hasTransitions() &&
+        spriteAtlas->isLoaded();
+
+    // The tiles in the order of their first items, with their items in the render order.
+    std::vector<const RenderTile*> tiles;
+    std::map<UnwrappedTileID, std::vector<const RenderItem*>> tileItems;
+    for (std::size_t i = begin; usable && i < end; ++i) {
+        auto& items = tileItems[visible[i].tile->id];
+        if (items.empty()) {
+            tiles.push_back(visible[i].tile);
+            // As many pixels as the tile covers in the view.
+            const double pixels = util::tileSize * state.getScale() / (1u << visible[i].tile->id.canonical.z) * frame.pixelRatio;
+            usable = pixels >= 1 && pixels <= maxCachedTileSize;
+        }
+        items.push_back(&visible[i]);
+    }
+
+    auto key = std::make_tuple(state.getZoom(), frame.pixelRatio,
+                               usable ? visible[begin].layer.baseImpl->source : std::string());
+    if (!usable || key != tileRenderCacheKey) {
+        releaseTileRenderCache();
+        tileRenderCacheKey = std::move(key);
+    }
+    if (!usable) {
+        return { begin, begin };
+    }
+
+    // Textures are only kept for the tiles drawn from the cache in this frame.
+    auto previousTiles = std::move(cachedTiles);
+    cachedTiles.clear();
+
+    std::unique_ptr<GPUTimer> timer;
+    const optional<ViewRegion> viewRedrawRegion = redrawRegion;
+    const std::array<float, 2> viewPixelsToGLUnits = pixelsToGLUnits;
+    const bool viewScissorClipping = scissorClipping;
+    const bool viewDrawBatching = frame.drawBatching;
+
+    for (const RenderTile* tile : tiles) {
+        const std::vector<const RenderItem*>& items = tileItems[tile->id];
+
+        std::vector<std::pair<uint64_t, uint64_t>> signature;
+        signature.reserve(items.size());
+        for (const RenderItem* item : items) {
+            signature.emplace_back(item->layer.baseImpl->evaluation, item->bucket->serial);
+        }
+
+        const double pixels = util::tileSize * state.getScale() / (1u << tile->id.canonical.z) * frame.pixelRatio;
+        const auto width = static_cast<uint32_t>(std::ceil(pixels));
+
+        CachedTile entry;
+        auto previous = previousTiles.find(tile->id);
+        if (previous != previousTiles.end()) {
+            entry = std::move(previous->second);
+        }
+
+        if (!entry.texture || entry.texture->getSize().width != width || entry.items != signature) {
+            MBGL_DEBUG_GROUP(util::toString(tile->id));
+
+            if (!timer) {
+                // The layers' own sections would be mixed up with those of the view.
+                timer = std::move(gpuTimer);
+                if (timer) { timer->startSection("tile cache"); }
+                scissorClipping = true;
+                frame.drawBatching = false;
+                redrawRegion = {};
+            }
+
+            auto depthStencil = cachedTileDepthStencils.find(width);
+            if (depthStencil == cachedTileDepthStencils.end()) {
+                gl::ResourceOwnerScope owner { context, GLResourceStats::Owner::Offscreen };
+                depthStencil = cachedTileDepthStencils.emplace(width,
+                    context.createRenderbuffer<gl::RenderbufferType::DepthStencil>(Size { width, width })).first;
+            }
+            if (!entry.texture || entry.texture->getSize().width != width) {
+                entry.texture = std::make_unique<OffscreenTexture>(context, Size { width, width }, depthStencil->second);
+            }
+            entry.extent = static_cast<uint32_t>(std::round(util::EXTENT * width / pixels));
+            entry.items = std::move(signature);
+
+            entry.texture->bind();
+            context.clear(Color { 0.0f, 0.0f, 0.0f, 0.0f }, 1.0f, 0);
+
+            // The tile as if it were the whole view, with the texture's pixels matching those
+            // of the view.
+            RenderTile target { tile->id, tile->tile };
+            matrix::ortho(target.matrix, 0, entry.extent, entry.extent, 0, 0, 1);
+            target.clippedToExtent = tile->clippedToExtent;
+            pixelsToGLUnits = {{ 2.0f * frame.pixelRatio / width, -2.0f * frame.pixelRatio / width }};
+
+            std::vector<RenderItem> targetItems;
+            targetItems.reserve(items.size());
+            for (const RenderItem* item : items) {
+                targetItems.emplace_back(item->layer, &target, item->bucket);
+            }
+            const std::vector<RenderItem>& order = targetItems;
+
+            depthRangeSize = 1 - (order.size() + 2) * numSublayers * depthEpsilon;
+            renderPass(parameters,
+                       RenderPass::Opaque,
+                       order.rbegin(), order.rend(),
+                       0, 1);
+            renderPass(parameters,
+                       RenderPass::Translucent,
+                       order.begin(), order.end(),
+                       static_cast<uint32_t>(order.size()) - 1, -1);
+
+            renderStats.cachedTileRenders++;
+        }
+
+        const CachedTile& stored = cachedTiles.emplace(tile->id, std::move(entry)).first->second;
+        cachedTileOrder.emplace_back(tile, &stored);
+    }
+
+    if (renderStats.cachedTileRenders) {
+        if (timer) { timer->endSection(); }
+        gpuTimer = std::move(timer);
+        pixelsToGLUnits = viewPixelsToGLUnits;
+        scissorClipping = viewScissorClipping;
+        frame.drawBatching = viewDrawBatching;
+        redrawRegion = viewRedrawRegion;
+        clipToRedrawRegion();
+        parameters.view.bind();
+    }
+
+    renderStats.cachedTiles = cachedTileOrder.size();
+    return { begin, end };
+}
+
+void Painter::renderCachedTiles(PaintParameters& parameters, uint32_t layer) {
+    MBGL_DEBUG_GROUP("tile cache");
+
+    static const style::PaintProperties<>::Evaluated properties {};
+    static const ExtrusionTextureProgram::PaintPropertyBinders paintAttributeData(properties, 0);
+
+    pass = RenderPass::Translucent;
+    currentLayer = layer;
+
+    if (gpuTimer) { gpuTimer->startSection("translucent/tile cache"); }
+
+    // Drawn like extrusion textures, with the quad stretched over the tile's extent. The
+    // texture's pixels match those of the view, apart from a subpixel offset of the tile.
+    for (const auto& cached : cachedTileOrder) {
+        const RenderTile& tile = *cached.first;
+        const CachedTile& entry = *cached.second;
+
+        context.bindTexture(entry.texture->getTexture(), 0, gl::TextureFilter::Nearest);
+
+        parameters.programs.extrusionTexture().draw(
+            context,
+            gl::Triangles(),
+            depthModeForSublayer(0, gl::DepthMode::ReadOnly),
+            stencilModeForClipping(tile),
+            colorModeForRenderPass(),
+            ExtrusionTextureProgram::UniformValues {
+                uniforms::u_matrix::Value{ tile.matrix },
+                uniforms::u_world::Value{ Size { entry.extent, entry.extent } },
+                uniforms::u_image::Value{ 0 },
+                uniforms::u_opacity::Value{ 1.0f }
+            },
+            extrusionTextureVertexBuffer,
+            tileTriangleIndexBuffer,
+            extrusionTextureSegments,
+            paintAttributeData,
+            properties,
+            state.getZoom()
+        );
+    }
+
+    clipToRedrawRegion();
+
+    if (gpuTimer) { gpuTimer->endSection(); }
+}
+
+std::size_t Painter::releaseTileRenderCache() {
+    std::size_t bytes = 0;
+    for (const auto& entry : cachedTiles) {
+        bytes += entry.second.texture->getSize().area() * 4;
+    }
+    for (const auto& depthStencil : cachedTileDepthStencils) {
+        bytes += depthStencil.second.size.area() * 4;
+    }
+
+    // The textures go before the depth and stencil buffers they were rendered with.
+    cachedTileOrder.clear();
+    cachedTiles.clear();
+    cachedTileDepthStencils.clear();
+    return bytes;
+}
+
 template <class Iterator>
 void Painter::renderPass(PaintParameters& parameters,
                          RenderPass pass_,
@@ -273,6 +714,9 @@ void Painter::renderPass(PaintParameters& parameters,
                   pass == RenderPass::Opaque ? "opaque" : "translucent");
     }
 
+    // The items of a layer are adjacent in the render order, and timed together.
+    const Layer* timedLayer = nullptr;
+
     for (; it != end; ++it, i += increment) {
         currentLayer = i;
 
@@ -282,6 +726,16 @@ void Painter::renderPass(PaintParameters& parameters,
         if (!layer.baseImpl->hasRenderPass(pass))
             continue;
 
+        MBGL_TRACE_SCOPE("render", (pass == RenderPass::Opaque ? "opaque/" : "translucent/") + layer.baseImpl->id);
+
+        // Draws that clip to their tile narrow the scissor rectangle down to the tile.
+        clipToRedrawRegion();
+
+        if (gpuTimer && &layer != timedLayer) {
+            gpuTimer->startSection((pass == RenderPass::Opaque ? "opaque/" : "translucent/") + layer.baseImpl->id);
+            timedLayer = &layer;
+        }
+
         if (layer.is<BackgroundLayer>()) {
             MBGL_DEBUG_GROUP("background");
             renderBackground(parameters, *layer.as<BackgroundLayer>());
@@ -300,21 +754,214 @@ void Painter::renderPass(PaintParameters& parameters,
             // the viewport or Framebuffer.
             parameters.view.bind();
             context.setDirtyState();
+        } else if (layer.is<FillExtrusionLayer>()) {
+            MBGL_DEBUG_GROUP(layer.baseImpl->id + " - texture");
+
+            // The layer's tiles were all rendered into its texture in the 3D pass.
+            while (std::next(it) != end && &std::next(it)->layer == &layer) {
+                ++it;
+                i += increment;
+            }
+
+            renderExtrusionTexture(parameters, *layer.as<FillExtrusionLayer>());
+        } else if (frame.drawBatching && layer.is<FillLayer>()) {
+            MBGL_DEBUG_GROUP(layer.baseImpl->id + " - batched");
+
+            // The items of a layer are adjacent in the render order.
+            batchedItems.clear();
+            batchedItems.emplace_back(&item, i);
+            while (std::next(it) != end && &std::next(it)->layer == &layer) {
+                ++it;
+                i += increment;
+                batchedItems.emplace_back(&*it, i);
+            }
+
+            renderFills(parameters, *layer.as<FillLayer>(), batchedItems);
         } else {
             MBGL_DEBUG_GROUP(layer.baseImpl->id + " - " + util::toString(item.tile->id));
             item.bucket->render(*this, parameters, layer, *item.tile);
         }
     }
 
+    if (gpuTimer) {
+        gpuTimer->endSection();
+    }
+
     if (debug::renderTree) {
         Log::Info(Event::Render, "%*s%s", --indent * 4, "", "}");
     }
 }
 
+// The buffer ages up to which only what changed is redrawn; views holding older frames are
+// drawn in full.
+static constexpr std::size_t maxBufferAge = 3;
+
+optional<Painter::ViewRegion> Painter::findRedrawRegion(const View& view,
+                                                        const RenderData& renderData,
+                                                        uint32_t bufferAge) {
+    const ViewRegion viewport = context.viewport.getCurrentValue();
+
+    ViewContents contents;
+    contents.view = &view;
+    contents.matrix = projMatrix;
+    contents.viewport = viewport;
+    contents.backgroundColor = renderData.backgroundColor;
+
+    // Symbols fade after the zoom level changes, new atlas images may be drawn anywhere, and
+    // custom layers may draw anything at all.
+    bool bounded = frame.mapMode == MapMode::Continuous &&
+        frame.debugOptions == MapDebugOptions::NoDebug &&
+        !frameHistory.needsAnimation(util::DEFAULT_FADE_DURATION) &&
+        renderStats.atlasUploads == 0;
+
+    for (const auto& item : renderData.order) {
+        const uint64_t evaluation = item.layer.baseImpl->evaluation;
+        if (contents.layers.empty() || contents.layers.back() != evaluation) {
+            contents.layers.push_back(evaluation);
+        }
+        if (item.layer.is<CustomLayer>()) {
+            bounded = false;
+        }
+        if (item.tile && item.bucket) {
+            int32_t reach = 0;
+            if (item.layer.is<SymbolLayer>() || item.layer.is<CircleLayer>()) {
+                reach = util::EXTENT / 4;
+            } else if (item.layer.is<FillExtrusionLayer>()) {
+                reach = -1;
+            }
+            contents.items.emplace(std::make_pair(evaluation, item.tile->id),
+                                   std::make_pair(item.bucket->serial, reach));
+        }
+    }
+
+    bounded = bounded &&
+        viewContents.view == &view &&
+        viewContents.matrix == contents.matrix &&
+        viewContents.viewport == contents.viewport &&
+        viewContents.backgroundColor == contents.backgroundColor &&
+        viewContents.layers == contents.layers;
+
+    // The window coordinates that the changed items covered or cover now.
+    std::array<double, 2> min {{ std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() }};
+    std::array<double, 2> max {{ -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() }};
+    auto add = [&] (const UnwrappedTileID& id, int32_t reach) {
+        if (reach < 0) {
+            bounded = false;
+            return;
+        }
+        const mat4 matrix = matrixForTile(id);
+        for (const double x : { -reach, util::EXTENT + reach }) {
+            for (const double y : { -reach, util::EXTENT + reach }) {
+                vec4 corner;
+                matrix::transformMat4(corner, {{ x, y, 0, 1 }}, matrix);
+                if (corner[3] <= 0) {
+                    // Behind the camera.
+                    bounded = false;
+                    return;
+                }
+                const std::array<double, 2> window {{
+                    viewport.x + (corner[0] / corner[3] + 1) / 2 * viewport.size.width,
+                    viewport.y + (corner[1] / corner[3] + 1) / 2 * viewport.size.height
+                }};
+                for (std::size_t i = 0; i < 2; ++i) {
+                    min[i] = std::min(min[i], window[i]);
+                    max[i] = std::max(max[i], window[i]);
+                }
+            }
+        }
+    };
+
+    // Both are sorted by layer and tile.
+    auto previous = viewContents.items.begin();
+    auto current = contents.items.begin();
+    while (bounded && (previous != viewContents.items.end() || current != contents.items.end())) {
+        if (current == contents.items.end() ||
+            (previous != viewContents.items.end() && previous->first < current->first)) {
+            add(previous->first.second, previous->second.second);
+            ++previous;
+        } else if (previous == viewContents.items.end() || current->first < previous->first) {
+            add(current->first.second, current->second.second);
+            ++current;
+        } else {
+            if (previous->second.first != current->second.first) {
+                add(previous->first.second, previous->second.second);
+                add(current->first.second, current->second.second);
+            }
+            ++previous;
+            ++current;
+        }
+    }
+
+    viewContents = std::move(contents);
+
+    optional<ViewRegion> changed;
+    if (bounded) {
+        changed = ViewRegion { viewport.x, viewport.y, { 0, 0 } };
+        const std::array<double, 2> viewportMin {{ double(viewport.x), double(viewport.y) }};
+        const std::array<double, 2> viewportMax {{ viewportMin[0] + viewport.size.width,
+                                                   viewportMin[1] + viewport.size.height }};
+        for (std::size_t i = 0; i < 2; ++i) {
+            min[i] = std::max(std::floor(min[i]), viewportMin[i]);
+            max[i] = std::min(std::ceil(max[i]), viewportMax[i]);
+        }
+        if (min[0] < max[0] && min[1] < max[1]) {
+            changed = ViewRegion {
+                static_cast<int32_t>(min[0]),
+                static_cast<int32_t>(min[1]),
+                { static_cast<uint32_t>(max[0] - min[0]), static_cast<uint32_t>(max[1] - min[1]) }
+            };
+        }
+    }
+
+    changedRegions.push_front(changed);
+    if (changedRegions.size() > maxBufferAge) {
+        changedRegions.pop_back();
+    }
+
+    if (bufferAge == 0 || bufferAge > changedRegions.size()) {
+        return {};
+    }
+
+    // What changed in the frames after the one the view holds.
+    ViewRegion result { viewport.x, viewport.y, { 0, 0 } };
+    for (std::size_t i = 0; i < bufferAge; ++i) {
+        if (!changedRegions[i]) {
+            return {};
+        }
+        const ViewRegion& region = *changedRegions[i];
+        if (!region.size) {
+            continue;
+        }
+        if (!result.size) {
+            result = region;
+            continue;
+        }
+        const int32_t x = std::min(result.x, region.x);
+        const int32_t y = std::min(result.y, region.y);
+        const int32_t right = std::max<int32_t>(result.x + result.size.width, region.x + region.size.width);
+        const int32_t top = std::max<int32_t>(result.y + result.size.height, region.y + region.size.height);
+        result = ViewRegion { x, y, { static_cast<uint32_t>(right - x), static_cast<uint32_t>(top - y) } };
+    }
+
+    // Scissoring saves little when most of the view is drawn anyway.
+    if (result.size.area() * 2 > viewport.size.area()) {
+        return {};
+    }
+    return result;
+}
+
+void Painter::clipToRedrawRegion() {
+    if (redrawRegion) {
+        context.scissorTest = true;
+        context.scissor = *redrawRegion;
+    } else {
+        context.scissorTest = false;
+    }
+}
+
 mat4 Painter::matrixForTile(const UnwrappedTileID& tileID) {
     mat4 matrix;
-    state.matrixFor(matrix, tileID);
-    matrix::multiply(matrix, projMatrix, matrix);
+    state.matrixFor(matrix, tileID, projMatrix);
     return matrix;
 }
 
@@ -324,7 +971,46 @@ gl::DepthMode Painter::depthModeForSublayer(uint8_t n, gl::DepthMode::Mask mask)
     return gl::DepthMode { gl::DepthMode::LessEqual, mask, { nearDepth, farDepth } };
 }
 
-gl::StencilMode Painter::stencilModeForClipping(const ClipID& id) const {
+gl::StencilMode Painter::stencilModeForClipping(const RenderTile& tile) {
+    if (scissorClipping) {
+        const auto viewport = context.viewport.getCurrentValue();
+
+        // The corners of the tile in window coordinates.
+        std::array<double, 2> min, max;
+        for (std::size_t i = 0; i < 2; ++i) {
+            vec4 corner;
+            const double extent = double(i) * util::EXTENT;
+            matrix::transformMat4(corner, {{ extent, extent, 0, 1 }}, tile.matrix);
+            (i == 0 ? min : max) = {{
+                std::round(viewport.x + (corner[0] / corner[3] + 1) / 2 * viewport.size.width),
+                std::round(viewport.y + (corner[1] / corner[3] + 1) / 2 * viewport.size.height)
+            }};
+        }
+        for (std::size_t i = 0; i < 2; ++i) {
+            if (min[i] > max[i]) {
+                std::swap(min[i], max[i]);
+            }
+        }
+        if (redrawRegion) {
+            const std::array<double, 2> regionMin {{ double(redrawRegion->x), double(redrawRegion->y) }};
+            const std::array<double, 2> regionMax {{ regionMin[0] + redrawRegion->size.width,
+                                                     regionMin[1] + redrawRegion->size.height }};
+            for (std::size_t i = 0; i < 2; ++i) {
+                min[i] = std::max(min[i], regionMin[i]);
+                max[i] = std::max(min[i], std::min(max[i], regionMax[i]));
+            }
+        }
+
+        context.scissorTest = true;
+        context.scissor = {
+            static_cast<int32_t>(min[0]),
+            static_cast<int32_t>(min[1]),
+            { static_cast<uint32_t>(max[0] - min[0]), static_cast<uint32_t>(max[1] - min[1]) }
+        };
+        return gl::StencilMode::disabled();
+    }
+
+    const ClipID& id = tile.clip;
     return gl::StencilMode {
         gl::StencilMode::Equal { static_cast<uint32_t>(id.mask.to_ulong()) },
         static_cast<int32_t>(id.reference.to_ulong()),
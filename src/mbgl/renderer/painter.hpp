@@ -1,17 +1,23 @@
 #pragma once
 
+#include <mbgl/map/render_stats.hpp>
 #include <mbgl/map/transform_state.hpp>
 
 #include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/clip_id.hpp>
 
 #include <mbgl/renderer/frame_history.hpp>
 #include <mbgl/renderer/render_item.hpp>
 #include <mbgl/renderer/bucket.hpp>
+#include <mbgl/renderer/fill_batch.hpp>
+#include <mbgl/renderer/gpu_timer.hpp>
 
 #include <mbgl/gl/context.hpp>
+#include <mbgl/programs/circle_program.hpp>
 #include <mbgl/programs/debug_program.hpp>
 #include <mbgl/programs/program_parameters.hpp>
 #include <mbgl/programs/fill_program.hpp>
+#include <mbgl/programs/extrusion_texture_program.hpp>
 #include <mbgl/programs/raster_program.hpp>
 
 #include <mbgl/style/style.hpp>
@@ -19,11 +25,17 @@
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/constants.hpp>
+#include <mbgl/util/offscreen_texture.hpp>
 
 #include <array>
+#include <deque>
 #include <vector>
 #include <set>
 #include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 
 namespace mbgl {
 
@@ -37,6 +49,7 @@ class Tile;
 
 class DebugBucket;
 class FillBucket;
+class FillExtrusionBucket;
 class LineBucket;
 class CircleBucket;
 class SymbolBucket;
@@ -51,6 +64,7 @@ namespace style {
 class Style;
 class Source;
 class FillLayer;
+class FillExtrusionLayer;
 class LineLayer;
 class CircleLayer;
 class SymbolLayer;
@@ -64,11 +78,15 @@ struct FrameData {
     MapMode mapMode;
     GLContextMode contextMode;
     MapDebugOptions debugOptions;
+    bool drawBatching;
+    bool tileRenderCache;
+    bool partialRedraw;
+    bool measureGPUTime;
 };
 
 class Painter : private util::noncopyable {
 public:
-    Painter(gl::Context&, const TransformState&, float pixelRatio);
+    Painter(gl::Context&, const TransformState&, float pixelRatio, const optional<std::string>& programCacheDir);
     ~Painter();
 
     void render(const style::Style&,
@@ -81,6 +99,12 @@ public:
     void renderClippingMask(const UnwrappedTileID&, const ClipID&);
     void renderTileDebug(const RenderTile&);
     void renderFill(PaintParameters&, FillBucket&, const style::FillLayer&, const RenderTile&);
+
+    // Renders the tiles of a fill layer, drawing the fills of those that can be batched
+    // with `FillBatchedProgram`. Each item comes with its index in the render order.
+    void renderFills(PaintParameters&, const style::FillLayer&,
+                     const std::vector<std::pair<const RenderItem*, uint32_t>>&);
+    void renderFillExtrusion(PaintParameters&, FillExtrusionBucket&, const style::FillExtrusionLayer&, const RenderTile&);
     void renderLine(PaintParameters&, LineBucket&, const style::LineLayer&, const RenderTile&);
     void renderCircle(PaintParameters&, CircleBucket&, const style::CircleLayer&, const RenderTile&);
     void renderSymbol(PaintParameters&, SymbolBucket&, const style::SymbolLayer&, const RenderTile&);
@@ -96,18 +120,70 @@ public:
 
     bool needsAnimation() const;
 
+    // The GPU time of frames rendered with `FrameData::measureGPUTime`, once it is known.
+    std::vector<FrameStats> collectFrameStats();
+
+    // The tiles and atlas uploads of the last frame; `Map` fills in the rest.
+    const RenderStats& getRenderStats() const {
+        return renderStats;
+    }
+
+    // Drops the textures of the tile render cache, returning their bytes.
+    std::size_t releaseTileRenderCache();
+
 private:
     std::vector<RenderItem> determineRenderOrder(const style::Style&);
 
+    // Fills `visibleItems` with the items that aren't hidden by an opaque fill covering their
+    // whole tile above them. Requires the tiles' clip regions to be up to date.
+    void cullOccludedItems(const std::vector<RenderItem>&);
+
     template <class Iterator>
     void renderPass(PaintParameters&,
                     RenderPass,
                     Iterator it, Iterator end,
                     uint32_t i, int8_t increment);
 
+    // Renders each fill extrusion layer of the render order into a texture of its own, with a
+    // depth buffer so that only the nearest surface is kept at each pixel. The textures are
+    // then drawn in the translucent pass with `renderExtrusionTexture`.
+    void render3D(PaintParameters&, const std::vector<RenderItem>&);
+    void renderExtrusionTexture(PaintParameters&, const style::FillExtrusionLayer&);
+
+    // Finds the items of the visible ones that the tile render cache draws in this frame,
+    // and renders the tiles whose textures are missing or out of date. Returns the range of
+    // those items, which is empty when the cache can't be used in this frame. Requires the
+    // tiles' clip regions and matrices to be up to date.
+    std::pair<std::size_t, std::size_t> updateTileRenderCache(PaintParameters&, const style::Style&,
+                                                              const std::vector<RenderItem>&);
+
+    // Draws the textures of the cached tiles in the translucent pass, at the depth of the
+    // given layer.
+    void renderCachedTiles(PaintParameters&, uint32_t layer);
+
+    // Draws the outlines of a fill without a pattern, and unless `drawTriangles` is false,
+    // its triangles.
+    void renderSolidFill(PaintParameters&, FillBucket&, const style::FillLayer&, const RenderTile&,
+                         bool drawTriangles);
+
+    // A region of the view, in window coordinates.
+    using ViewRegion = gl::value::Viewport::Type;
+
+    // Records what the bound view shows in this frame, and finds the region that changed
+    // since the frame it holds, `bufferAge` frames ago. Returns nothing if that isn't known,
+    // and all of the view is to be drawn.
+    optional<ViewRegion> findRedrawRegion(const View&, const RenderData&, uint32_t bufferAge);
+
+    // Turns the scissor test off or, in frames that only redraw part of the view, limits
+    // drawing to that part.
+    void clipToRedrawRegion();
+
     mat4 matrixForTile(const UnwrappedTileID&);
     gl::DepthMode depthModeForSublayer(uint8_t n, gl::DepthMode::Mask) const;
-    gl::StencilMode stencilModeForClipping(const ClipID&) const;
+
+    // Clips draws to a tile's clip region: with its stencil mask or, in frames that clip
+    // with scissor rectangles, by setting the scissor rectangle to the tile's extent.
+    gl::StencilMode stencilModeForClipping(const RenderTile&);
     gl::ColorMode colorModeForRenderPass() const;
 
 #ifndef NDEBUG
@@ -144,6 +220,13 @@ private:
 
     int numSublayers = 3;
     uint32_t currentLayer;
+
+    // Whether this frame clips tiles with scissor rectangles rather than stencil masks.
+    bool scissorClipping = false;
+
+    // The stencil masks of the clip IDs assigned for the render data of this revision.
+    uint64_t clipIDsRevision = 0;
+    std::map<UnwrappedTileID, ClipID> stencils;
     float depthRangeSize;
     const float depthEpsilon = 1.0f / (1 << 16);
 
@@ -153,13 +236,20 @@ private:
 
     FrameHistory frameHistory;
 
-    std::unique_ptr<Programs> programs;
+    // Only exists while frames are measured, and timer queries are supported.
+    std::unique_ptr<GPUTimer> gpuTimer;
+    RenderStats renderStats;
+
+    // Shared with the painters of contexts that share resources with this one.
+    std::shared_ptr<Programs> programs;
 #ifndef NDEBUG
-    std::unique_ptr<Programs> overdrawPrograms;
+    std::shared_ptr<Programs> overdrawPrograms;
 #endif
 
     gl::VertexBuffer<FillLayoutVertex> tileVertexBuffer;
     gl::VertexBuffer<RasterLayoutVertex> rasterVertexBuffer;
+    // The quad that circles and symbols are drawn as instances of.
+    gl::VertexBuffer<CircleQuadVertex> quadVertexBuffer;
 
     gl::IndexBuffer<gl::Triangles> tileTriangleIndexBuffer;
     gl::IndexBuffer<gl::LineStrip> tileBorderIndexBuffer;
@@ -167,6 +257,64 @@ private:
     gl::SegmentVector<FillAttributes> tileTriangleSegments;
     gl::SegmentVector<DebugAttributes> tileBorderSegments;
     gl::SegmentVector<RasterAttributes> rasterSegments;
+
+    // The quad that extrusion textures are drawn with, covering the viewport.
+    gl::VertexBuffer<ExtrusionTextureLayoutVertex> extrusionTextureVertexBuffer;
+    gl::SegmentVector<ExtrusionTextureAttributes> extrusionTextureSegments;
+
+    // The textures that fill extrusion layers were rendered into in this frame, by layer ID,
+    // sharing one depth buffer of the viewport's size. They are kept for as long as their
+    // layer is rendered and the viewport keeps its size.
+    optional<gl::Renderbuffer<gl::RenderbufferType::DepthStencil>> extrusionDepthStencil;
+    std::unordered_map<std::string, std::unique_ptr<OffscreenTexture>> extrusionTextures;
+
+    // The tile render cache, for the zoom level, pixel ratio and source it was rendered for.
+    // A tile's texture is kept for as long as the tile is drawn from the cache, and the items
+    // it was rendered from, by the evaluation of their layer and the serial of their bucket,
+    // stay the same. Textures of the same size share a depth and stencil buffer, by width.
+    struct CachedTile {
+        std::unique_ptr<OffscreenTexture> texture;
+        // The tile units covered by the texture, which has about as many pixels as the tile
+        // covers in the view.
+        uint32_t extent = 0;
+        std::vector<std::pair<uint64_t, uint64_t>> items;
+    };
+    std::tuple<double, float, std::string> tileRenderCacheKey;
+    std::map<uint32_t, gl::Renderbuffer<gl::RenderbufferType::DepthStencil>> cachedTileDepthStencils;
+    std::map<UnwrappedTileID, CachedTile> cachedTiles;
+
+    // What the view showed after the last frame, to find what changed in the next one: the
+    // layers by their evaluation, and the items of their tiles with the serial of their
+    // bucket and how far they draw beyond the tile, in tile units, or -1 if that's unbounded.
+    struct ViewContents {
+        const View* view = nullptr;
+        mat4 matrix;
+        ViewRegion viewport;
+        Color backgroundColor;
+        std::vector<uint64_t> layers;
+        std::map<std::pair<uint64_t, UnwrappedTileID>, std::pair<uint64_t, int32_t>> items;
+    };
+    ViewContents viewContents;
+
+    // The regions that changed in the last frames, newest first, or nothing for those in
+    // which all of the view may have.
+    std::deque<optional<ViewRegion>> changedRegions;
+
+    // The part of the view drawn in this frame, unless it is all of it.
+    optional<ViewRegion> redrawRegion;
+
+    // Batches by layer ID. Those of layers that weren't batched in the previous frame are
+    // dropped at the start of the next one.
+    std::unordered_map<std::string, std::vector<FillBatch>> fillBatches;
+    std::unordered_map<std::string, std::vector<FillBatch>> previousFillBatches;
+
+    // Per-frame item lists, kept to reuse their storage.
+    std::vector<RenderItem> visibleItems;
+    std::vector<bool> occludedItems;
+    std::vector<UnwrappedTileID> coveredTiles;
+    std::vector<std::pair<const RenderItem*, uint32_t>> batchedItems;
+    std::vector<std::pair<const RenderItem*, float>> extrusionItems;
+    std::vector<std::pair<const RenderTile*, const CachedTile*>> cachedTileOrder;
 };
 
 } // namespace mbgl
@@ -23,35 +23,58 @@ void Painter::renderCircle(PaintParameters& parameters,
     const CirclePaintProperties::Evaluated& properties = layer.impl->paint.evaluated;
     const bool scaleWithMap = properties.get<CirclePitchScale>() == CirclePitchScaleType::Map;
 
-    parameters.programs.circle.draw(
-        context,
-        gl::Triangles(),
-        depthModeForSublayer(0, gl::DepthMode::ReadOnly),
-        frame.mapMode == MapMode::Still
-            ? stencilModeForClipping(tile.clip)
-            : gl::StencilMode::disabled(),
-        colorModeForRenderPass(),
-        CircleProgram::UniformValues {
-            uniforms::u_matrix::Value{
-                tile.translatedMatrix(properties.get<CircleTranslate>(),
-                                      properties.get<CircleTranslateAnchor>(),
-                                      state)
-            },
-            uniforms::u_scale_with_map::Value{ scaleWithMap },
-            uniforms::u_extrude_scale::Value{ scaleWithMap
-                ? std::array<float, 2> {{
-                    pixelsToGLUnits[0] * state.getCameraToCenterDistance(),
-                    pixelsToGLUnits[1] * state.getCameraToCenterDistance()
-                  }}
-                : pixelsToGLUnits }
+    const auto depthMode = depthModeForSublayer(0, gl::DepthMode::ReadOnly);
+    const auto stencilMode = frame.mapMode == MapMode::Still
+        ? stencilModeForClipping(tile)
+        : gl::StencilMode::disabled();
+
+    CircleProgram::UniformValues uniformValues {
+        uniforms::u_matrix::Value{
+            tile.translatedMatrix(properties.get<CircleTranslate>(),
+                                  properties.get<CircleTranslateAnchor>(),
+                                  state)
         },
-        *bucket.vertexBuffer,
-        *bucket.indexBuffer,
-        bucket.segments,
-        bucket.paintPropertyBinders.at(layer.getID()),
-        properties,
-        state.getZoom()
-    );
+        uniforms::u_scale_with_map::Value{ scaleWithMap },
+        uniforms::u_extrude_scale::Value{ scaleWithMap
+            ? std::array<float, 2> {{
+                pixelsToGLUnits[0] * state.getCameraToCenterDistance(),
+                pixelsToGLUnits[1] * state.getCameraToCenterDistance()
+              }}
+            : pixelsToGLUnits }
+    };
+
+    if (bucket.instanceBuffer) {
+        parameters.programs.circleInstanced().drawInstanced(
+            context,
+            gl::Triangles(),
+            depthMode,
+            stencilMode,
+            colorModeForRenderPass(),
+            std::move(uniformValues),
+            CircleInstancedProgram::layoutBindings(quadVertexBuffer, *bucket.instanceBuffer),
+            bucket.instanceCount,
+            tileTriangleIndexBuffer,
+            bucket.instancedSegments,
+            bucket.paintPropertyBinders.at(layer.getID()),
+            properties,
+            state.getZoom()
+        );
+    } else {
+        parameters.programs.circle().draw(
+            context,
+            gl::Triangles(),
+            depthMode,
+            stencilMode,
+            colorModeForRenderPass(),
+            std::move(uniformValues),
+            *bucket.vertexBuffer,
+            *bucket.indexBuffer,
+            bucket.segments,
+            bucket.paintPropertyBinders.at(layer.getID()),
+            properties,
+            state.getZoom()
+        );
+    }
 }
 
 } // namespace mbgl
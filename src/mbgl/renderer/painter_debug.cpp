@@ -24,11 +24,11 @@ void Painter::renderTileDebug(const RenderTile& renderTile) {
     static const DebugProgram::PaintPropertyBinders paintAttibuteData(properties, 0);
 
     auto draw = [&] (Color color, const auto& vertexBuffer, const auto& indexBuffer, const auto& segments, auto drawMode) {
-        programs->debug.draw(
+        programs->debug().draw(
             context,
             drawMode,
             gl::DepthMode::disabled(),
-            stencilModeForClipping(renderTile.clip),
+            stencilModeForClipping(renderTile),
             gl::ColorMode::unblended(),
             DebugProgram::UniformValues {
                 uniforms::u_matrix::Value{ renderTile.matrix },
@@ -45,14 +45,18 @@ void Painter::renderTileDebug(const RenderTile& renderTile) {
 
     if (frame.debugOptions & (MapDebugOptions::Timestamps | MapDebugOptions::ParseStatus)) {
         Tile& tile = renderTile.tile;
-        if (!tile.debugBucket || tile.debugBucket->renderable != tile.isRenderable() ||
-            tile.debugBucket->complete != tile.isComplete() ||
-            !(tile.debugBucket->modified == tile.modified) ||
-            !(tile.debugBucket->expires == tile.expires) ||
-            tile.debugBucket->debugMode != frame.debugOptions) {
+        if (!tile.debugBucket) {
             tile.debugBucket = std::make_unique<DebugBucket>(
                 tile.id, tile.isRenderable(), tile.isComplete(), tile.modified,
                 tile.expires, frame.debugOptions, context);
+        } else if (tile.debugBucket->renderable != tile.isRenderable() ||
+                   tile.debugBucket->complete != tile.isComplete() ||
+                   !(tile.debugBucket->modified == tile.modified) ||
+                   !(tile.debugBucket->expires == tile.expires) ||
+                   tile.debugBucket->debugMode != frame.debugOptions) {
+            tile.debugBucket->update(
+                tile.id, tile.isRenderable(), tile.isComplete(), tile.modified,
+                tile.expires, frame.debugOptions, context);
         }
 
         draw(Color::white(),
@@ -1,6 +1,8 @@
 #include <mbgl/renderer/painter.hpp>
 #include <mbgl/renderer/paint_parameters.hpp>
 #include <mbgl/renderer/fill_bucket.hpp>
+#include <mbgl/renderer/fill_batch.hpp>
+#include <mbgl/renderer/render_item.hpp>
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/style/layers/fill_layer.hpp>
 #include <mbgl/style/layers/fill_layer_impl.hpp>
@@ -9,6 +11,8 @@
 #include <mbgl/programs/fill_program.hpp>
 #include <mbgl/util/convert.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 using namespace style;
@@ -42,7 +46,7 @@ void Painter::renderFill(PaintParameters& parameters,
                 context,
                 drawMode,
                 depthModeForSublayer(sublayer, gl::DepthMode::ReadWrite),
-                stencilModeForClipping(tile.clip),
+                stencilModeForClipping(tile),
                 colorModeForRenderPass(),
                 FillPatternUniforms::values(
                     tile.translatedMatrix(properties.get<FillTranslate>(),
@@ -65,7 +69,7 @@ void Painter::renderFill(PaintParameters& parameters,
         };
 
         draw(0,
-             parameters.programs.fillPattern,
+             parameters.programs.fillPattern(),
              gl::Triangles(),
              *bucket.triangleIndexBuffer,
              bucket.triangleSegments);
@@ -75,65 +79,183 @@ void Painter::renderFill(PaintParameters& parameters,
         }
 
         draw(2,
-             parameters.programs.fillOutlinePattern,
+             parameters.programs.fillOutlinePattern(),
              gl::Lines { 2.0f },
              *bucket.lineIndexBuffer,
              bucket.lineSegments);
     } else {
-        auto draw = [&] (uint8_t sublayer,
-                         auto& program,
-                         const auto& drawMode,
-                         const auto& indexBuffer,
-                         const auto& segments) {
-            program.draw(
-                context,
-                drawMode,
-                depthModeForSublayer(sublayer, gl::DepthMode::ReadWrite),
-                stencilModeForClipping(tile.clip),
-                colorModeForRenderPass(),
-                FillProgram::UniformValues {
-                    uniforms::u_matrix::Value{
-                        tile.translatedMatrix(properties.get<FillTranslate>(),
-                                              properties.get<FillTranslateAnchor>(),
-                                              state)
-                    },
-                    uniforms::u_world::Value{ context.viewport.getCurrentValue().size },
+        renderSolidFill(parameters, bucket, layer, tile, true);
+    }
+}
+
+void Painter::renderSolidFill(PaintParameters& parameters,
+                              FillBucket& bucket,
+                              const FillLayer& layer,
+                              const RenderTile& tile,
+                              bool drawTriangles) {
+    const FillPaintProperties::Evaluated& properties = layer.impl->paint.evaluated;
+
+    auto draw = [&] (uint8_t sublayer,
+                     auto& program,
+                     const auto& drawMode,
+                     const auto& indexBuffer,
+                     const auto& segments) {
+        program.draw(
+            context,
+            drawMode,
+            depthModeForSublayer(sublayer, gl::DepthMode::ReadWrite),
+            stencilModeForClipping(tile),
+            colorModeForRenderPass(),
+            FillProgram::UniformValues {
+                uniforms::u_matrix::Value{
+                    tile.translatedMatrix(properties.get<FillTranslate>(),
+                                          properties.get<FillTranslateAnchor>(),
+                                          state)
                 },
-                *bucket.vertexBuffer,
-                indexBuffer,
-                segments,
-                bucket.paintPropertyBinders.at(layer.getID()),
-                properties,
-                state.getZoom()
-            );
-        };
+                uniforms::u_world::Value{ context.viewport.getCurrentValue().size },
+            },
+            *bucket.vertexBuffer,
+            indexBuffer,
+            segments,
+            bucket.paintPropertyBinders.at(layer.getID()),
+            properties,
+            state.getZoom()
+        );
+    };
+
+    if (properties.get<FillAntialias>() && !layer.impl->paint.unevaluated.get<FillOutlineColor>().isUndefined() && pass == RenderPass::Translucent) {
+        draw(2,
+             parameters.programs.fillOutline(),
+             gl::Lines { 2.0f },
+             *bucket.lineIndexBuffer,
+             bucket.lineSegments);
+    }
 
-        if (properties.get<FillAntialias>() && !layer.impl->paint.unevaluated.get<FillOutlineColor>().isUndefined() && pass == RenderPass::Translucent) {
-            draw(2,
-                 parameters.programs.fillOutline,
-                 gl::Lines { 2.0f },
-                 *bucket.lineIndexBuffer,
-                 bucket.lineSegments);
+    // Only draw the fill when it's opaque and we're drawing opaque fragments,
+    // or when it's translucent and we're drawing translucent fragments.
+    if (drawTriangles && (properties.get<FillColor>().constantOr(Color()).a >= 1.0f
+      && properties.get<FillOpacity>().constantOr(0) >= 1.0f) == (pass == RenderPass::Opaque)) {
+        draw(1,
+             parameters.programs.fill(),
+             gl::Triangles(),
+             *bucket.triangleIndexBuffer,
+             bucket.triangleSegments);
+    }
+
+    if (properties.get<FillAntialias>() && layer.impl->paint.unevaluated.get<FillOutlineColor>().isUndefined() && pass == RenderPass::Translucent) {
+        draw(2,
+             parameters.programs.fillOutline(),
+             gl::Lines { 2.0f },
+             *bucket.lineIndexBuffer,
+             bucket.lineSegments);
+    }
+}
+
+void Painter::renderFills(PaintParameters& parameters,
+                          const FillLayer& layer,
+                          const std::vector<std::pair<const RenderItem*, uint32_t>>& items) {
+    const FillPaintProperties::Evaluated& properties = layer.impl->paint.evaluated;
+
+    const bool opaque = properties.get<FillColor>().constantOr(Color()).a >= 1.0f
+                     && properties.get<FillOpacity>().constantOr(0) >= 1.0f;
+    const std::array<float, 2>& translate = properties.get<FillTranslate>();
+
+    // All tiles of a batch share the paint attributes of one bucket, so they must be
+    // constant. The shader clips to the untranslated tile extent, while the stencil mask is
+    // drawn where the translated geometry ends up on screen.
+    const bool batchable = properties.get<FillPattern>().from.empty()
+        && properties.get<FillColor>().isConstant()
+        && properties.get<FillOpacity>().isConstant()
+        && translate[0] == 0 && translate[1] == 0
+        && opaque == (pass == RenderPass::Opaque);
+
+    struct BatchedTile {
+        FillBucket& bucket;
+        const RenderTile& tile;
+        uint32_t layerIndex;
+    };
+    std::vector<BatchedTile> batched;
+
+    for (const auto& item : items) {
+        auto& bucket = static_cast<FillBucket&>(*item.first->bucket);
+        const RenderTile& tile = *item.first->tile;
+        if (batchable && bucket.retainsGeometry && tile.clippedToExtent) {
+            batched.push_back({ bucket, tile, item.second });
+        } else {
+            currentLayer = item.second;
+            renderFill(parameters, bucket, layer, tile);
         }
+    }
+
+    if (batched.empty()) {
+        return;
+    }
 
-        // Only draw the fill when it's opaque and we're drawing opaque fragments,
-        // or when it's translucent and we're drawing translucent fragments.
-        if ((properties.get<FillColor>().constantOr(Color()).a >= 1.0f
-          && properties.get<FillOpacity>().constantOr(0) >= 1.0f) == (pass == RenderPass::Opaque)) {
-            draw(1,
-                 parameters.programs.fill,
-                 gl::Triangles(),
-                 *bucket.triangleIndexBuffer,
-                 bucket.triangleSegments);
+    // Outlines are still drawn per tile, on the same side of the fill as `renderFill`
+    // draws them. Tiles that are batched don't overlap, so this only changes the order of
+    // draws that don't cover the same pixels.
+    auto drawOutlines = [&] {
+        for (const auto& entry : batched) {
+            currentLayer = entry.layerIndex;
+            renderSolidFill(parameters, entry.bucket, layer, entry.tile, false);
         }
+    };
+
+    const bool outlineFirst = !layer.impl->paint.unevaluated.get<FillOutlineColor>().isUndefined();
+    if (outlineFirst) {
+        drawOutlines();
+    }
+
+    auto& batches = fillBatches[layer.getID()];
+    auto previous = previousFillBatches.find(layer.getID());
+    if (previous != previousFillBatches.end()) {
+        batches = std::move(previous->second);
+        previousFillBatches.erase(previous);
+    }
 
-        if (properties.get<FillAntialias>() && layer.impl->paint.unevaluated.get<FillOutlineColor>().isUndefined() && pass == RenderPass::Translucent) {
-            draw(2,
-                 parameters.programs.fillOutline,
-                 gl::Lines { 2.0f },
-                 *bucket.lineIndexBuffer,
-                 bucket.lineSegments);
+    const std::size_t maxTiles = FillBatchedProgram::maxTiles;
+    batches.resize((batched.size() + maxTiles - 1) / maxTiles);
+
+    // The batched shader clips to each tile's extent by itself.
+    clipToRedrawRegion();
+
+    for (std::size_t i = 0; i < batches.size(); ++i) {
+        const std::size_t begin = i * maxTiles;
+        const std::size_t end = std::min(begin + maxTiles, batched.size());
+
+        std::vector<const FillBucket*> buckets;
+        std::vector<mat4> matrices;
+        for (std::size_t j = begin; j < end; ++j) {
+            buckets.push_back(&batched[j].bucket);
+            matrices.push_back(batched[j].tile.matrix);
         }
+
+        FillBatch& batch = batches[i];
+        batch.update(context, buckets);
+
+        currentLayer = batched[begin].layerIndex;
+
+        parameters.programs.fillBatched().draw(
+            context,
+            gl::Triangles(),
+            depthModeForSublayer(1, gl::DepthMode::ReadWrite),
+            gl::StencilMode::disabled(),
+            colorModeForRenderPass(),
+            FillBatchedProgram::UniformValues {
+                uniforms::u_matrices::Value{ std::move(matrices) },
+                uniforms::u_world::Value{ context.viewport.getCurrentValue().size },
+            },
+            *batch.vertexBuffer,
+            *batch.indexBuffer,
+            batch.segments,
+            batched[begin].bucket.paintPropertyBinders.at(layer.getID()),
+            properties,
+            state.getZoom()
+        );
+    }
+
+    if (!outlineFirst) {
+        drawOutlines();
     }
 }
 
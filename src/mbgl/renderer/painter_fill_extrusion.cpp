@@ -0,0 +1,164 @@
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/renderer/paint_parameters.hpp>
+#include <mbgl/renderer/fill_extrusion_bucket.hpp>
+#include <mbgl/renderer/render_item.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer_impl.hpp>
+#include <mbgl/map/view.hpp>
+#include <mbgl/programs/programs.hpp>
+#include <mbgl/programs/fill_extrusion_program.hpp>
+#include <mbgl/programs/extrusion_texture_program.hpp>
+#include <mbgl/util/projection.hpp>
+#include <mbgl/gl/debugging.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+using namespace style;
+
+void Painter::render3D(PaintParameters& parameters, const std::vector<RenderItem>& order) {
+    // Textures are only kept for the layers that are rendered again.
+    auto previousTextures = std::move(extrusionTextures);
+    extrusionTextures.clear();
+
+    optional<Size> size;
+
+    for (auto it = order.begin(); it != order.end();) {
+        const Layer& layer = it->layer;
+        const auto layerEnd = std::find_if(it, order.end(), [&] (const RenderItem& item) {
+            return &item.layer != &layer;
+        });
+
+        if (!layer.is<FillExtrusionLayer>() || !layer.baseImpl->hasRenderPass(RenderPass::Pass3D)) {
+            it = layerEnd;
+            continue;
+        }
+
+        MBGL_DEBUG_GROUP(layer.baseImpl->id);
+
+        if (!size) {
+            if (gpuTimer) { gpuTimer->startSection("3d"); }
+
+            parameters.view.bind();
+            size = context.viewport.getCurrentValue().size;
+
+            if (!extrusionDepthStencil || extrusionDepthStencil->size != *size) {
+                gl::ResourceOwnerScope owner { context, GLResourceStats::Owner::Offscreen };
+                extrusionDepthStencil = context.createRenderbuffer<gl::RenderbufferType::DepthStencil>(*size);
+                previousTextures.clear();
+            }
+        }
+
+        std::unique_ptr<OffscreenTexture> texture;
+        auto previous = previousTextures.find(layer.baseImpl->id);
+        if (previous != previousTextures.end()) {
+            texture = std::move(previous->second);
+        } else {
+            texture = std::make_unique<OffscreenTexture>(context, *size, *extrusionDepthStencil);
+        }
+
+        texture->bind();
+        context.clear(Color { 0.0f, 0.0f, 0.0f, 0.0f }, 1.0f, {});
+
+        // Nearest tiles first, so that the depth test rejects more of the fragments of the
+        // tiles behind them. The w of a tile's center is its distance along the view.
+        extrusionItems.clear();
+        for (; it != layerEnd; ++it) {
+            if (it->tile && it->bucket) {
+                vec4 center;
+                matrix::transformMat4(center, {{ util::EXTENT / 2.0, util::EXTENT / 2.0, 0, 1 }}, it->tile->matrix);
+                extrusionItems.emplace_back(&*it, center[3]);
+            }
+        }
+        std::sort(extrusionItems.begin(), extrusionItems.end(), [] (const auto& a, const auto& b) {
+            return a.second < b.second;
+        });
+
+        for (const auto& item : extrusionItems) {
+            MBGL_DEBUG_GROUP(layer.baseImpl->id + " - " + util::toString(item.first->tile->id));
+            item.first->bucket->render(*this, parameters, layer, *item.first->tile);
+        }
+
+        extrusionTextures.emplace(layer.baseImpl->id, std::move(texture));
+    }
+
+    if (size && gpuTimer) {
+        gpuTimer->endSection();
+    }
+}
+
+void Painter::renderFillExtrusion(PaintParameters& parameters,
+                                  FillExtrusionBucket& bucket,
+                                  const FillExtrusionLayer& layer,
+                                  const RenderTile& tile) {
+    if (pass != RenderPass::Pass3D) {
+        return;
+    }
+
+    const FillExtrusionPaintProperties::Evaluated& properties = layer.impl->paint.evaluated;
+
+    mat4 matrix = tile.translatedMatrix(properties.get<FillExtrusionTranslate>(),
+                                        properties.get<FillExtrusionTranslateAnchor>(),
+                                        state);
+
+    // Heights are in meters, and the projection's z units in pixels.
+    const double metersPerPixel = Projection::getMetersPerPixelAtLatitude(state.getLatLng().latitude(), state.getZoom());
+    matrix::scale(matrix, matrix, 1, 1, 1 / metersPerPixel);
+
+    parameters.programs.fillExtrusion().draw(
+        context,
+        gl::Triangles(),
+        gl::DepthMode { gl::DepthMode::LessEqual, gl::DepthMode::ReadWrite, { 0.0f, 1.0f } },
+        gl::StencilMode::disabled(),
+        colorModeForRenderPass(),
+        FillExtrusionUniforms::values(matrix),
+        *bucket.vertexBuffer,
+        *bucket.indexBuffer,
+        bucket.triangleSegments,
+        bucket.paintPropertyBinders.at(layer.getID()),
+        properties,
+        state.getZoom()
+    );
+}
+
+void Painter::renderExtrusionTexture(PaintParameters& parameters, const FillExtrusionLayer& layer) {
+    auto it = extrusionTextures.find(layer.getID());
+    if (it == extrusionTextures.end()) {
+        return;
+    }
+
+    static const style::PaintProperties<>::Evaluated properties {};
+    static const ExtrusionTextureProgram::PaintPropertyBinders paintAttributeData(properties, 0);
+
+    OffscreenTexture& texture = *it->second;
+    const Size size = texture.getSize();
+
+    mat4 matrix;
+    matrix::ortho(matrix, 0, size.width, size.height, 0, 0, 1);
+
+    context.bindTexture(texture.getTexture(), 0, gl::TextureFilter::Nearest);
+
+    parameters.programs.extrusionTexture().draw(
+        context,
+        gl::Triangles(),
+        gl::DepthMode::disabled(),
+        gl::StencilMode::disabled(),
+        colorModeForRenderPass(),
+        ExtrusionTextureProgram::UniformValues {
+            uniforms::u_matrix::Value{ matrix },
+            uniforms::u_world::Value{ size },
+            uniforms::u_image::Value{ 0 },
+            uniforms::u_opacity::Value{ layer.impl->paint.evaluated.get<FillExtrusionOpacity>() }
+        },
+        extrusionTextureVertexBuffer,
+        tileTriangleIndexBuffer,
+        extrusionTextureSegments,
+        paintAttributeData,
+        properties,
+        state.getZoom()
+    );
+}
+
+} // namespace mbgl
@@ -28,7 +28,7 @@ void Painter::renderLine(PaintParameters& parameters,
             context,
             gl::Triangles(),
             depthModeForSublayer(0, gl::DepthMode::ReadOnly),
-            stencilModeForClipping(tile.clip),
+            stencilModeForClipping(tile),
             colorModeForRenderPass(),
             std::move(uniformValues),
             *bucket.vertexBuffer,
@@ -48,7 +48,7 @@ void Painter::renderLine(PaintParameters& parameters,
 
         lineAtlas->bind(context, 0);
 
-        draw(parameters.programs.lineSDF,
+        draw(parameters.programs.lineSDF(),
              LineSDFProgram::uniformValues(
                  properties,
                  frame.pixelRatio,
@@ -69,7 +69,7 @@ void Painter::renderLine(PaintParameters& parameters,
 
         spriteAtlas->bind(true, context, 0);
 
-        draw(parameters.programs.linePattern,
+        draw(parameters.programs.linePattern(),
              LinePatternProgram::uniformValues(
                  properties,
                  tile,
@@ -79,7 +79,7 @@ void Painter::renderLine(PaintParameters& parameters,
                  *posB));
 
     } else {
-        draw(parameters.programs.line,
+        draw(parameters.programs.line(),
              LineProgram::uniformValues(
                  properties,
                  tile,
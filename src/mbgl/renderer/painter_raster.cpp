@@ -51,11 +51,22 @@ void Painter::renderRaster(PaintParameters& parameters,
     const RasterPaintProperties::Evaluated& properties = layer.impl->paint.evaluated;
     const RasterProgram::PaintPropertyBinders paintAttributeData(properties, 0);
 
-    assert(bucket.texture);
-    context.bindTexture(*bucket.texture, 0, gl::TextureFilter::Linear);
-    context.bindTexture(*bucket.texture, 1, gl::TextureFilter::Linear);
+    const gl::TextureMipMap mipmap = bucket.mipmapped ? gl::TextureMipMap::Yes : gl::TextureMipMap::No;
+    std::array<float, 2> texOffset {{ 0.0f, 0.0f }};
+    std::array<float, 2> texScale {{ 1.0f, 1.0f }};
+    if (bucket.sharedTexture) {
+        // Binding the texture the previous tile was drawn from again changes no state.
+        context.bindTexture(*bucket.sharedTexture, 0, gl::TextureFilter::Linear, mipmap);
+        context.bindTexture(*bucket.sharedTexture, 1, gl::TextureFilter::Linear, mipmap);
+        texOffset = bucket.sharedTexture->offset;
+        texScale = bucket.sharedTexture->scale;
+    } else {
+        assert(bucket.texture);
+        context.bindTexture(*bucket.texture, 0, gl::TextureFilter::Linear, mipmap);
+        context.bindTexture(*bucket.texture, 1, gl::TextureFilter::Linear, mipmap);
+    }
 
-    parameters.programs.raster.draw(
+    parameters.programs.raster().draw(
         context,
         gl::Triangles(),
         depthModeForSublayer(0, gl::DepthMode::ReadOnly),
@@ -75,6 +86,8 @@ void Painter::renderRaster(PaintParameters& parameters,
             uniforms::u_buffer_scale::Value{ 1.0f },
             uniforms::u_scale_parent::Value{ 1.0f },
             uniforms::u_tl_parent::Value{ std::array<float, 2> {{ 0.0f, 0.0f }} },
+            uniforms::u_tex_offset::Value{ texOffset },
+            uniforms::u_tex_scale::Value{ texScale },
         },
         rasterVertexBuffer,
         tileTriangleIndexBuffer,
@@ -30,7 +30,9 @@ void Painter::renderSymbol(PaintParameters& parameters,
 
     frameHistory.bind(context, 1);
 
-    auto draw = [&] (auto& program,
+    // The programs are given as members of `Programs`, so that only the one used is compiled.
+    auto draw = [&] (auto program,
+                     auto instancedProgram,
                      auto&& uniformValues,
                      const auto& buffers,
                      const SymbolPropertyValues& values_,
@@ -40,24 +42,45 @@ void Painter::renderSymbol(PaintParameters& parameters,
         // We clip symbols to their tile extent in still mode.
         const bool needsClipping = frame.mapMode == MapMode::Still;
 
-        program.draw(
-            context,
-            gl::Triangles(),
-            values_.pitchAlignment == AlignmentType::Map
-                ? depthModeForSublayer(0, gl::DepthMode::ReadOnly)
-                : gl::DepthMode::disabled(),
-            needsClipping
-                ? stencilModeForClipping(tile.clip)
-                : gl::StencilMode::disabled(),
-            colorModeForRenderPass(),
-            std::move(uniformValues),
-            *buffers.vertexBuffer,
-            *buffers.indexBuffer,
-            buffers.segments,
-            binders,
-            paintProperties,
-            state.getZoom()
-        );
+        const auto depthMode = values_.pitchAlignment == AlignmentType::Map
+            ? depthModeForSublayer(0, gl::DepthMode::ReadOnly)
+            : gl::DepthMode::disabled();
+        const auto stencilMode = needsClipping
+            ? stencilModeForClipping(tile)
+            : gl::StencilMode::disabled();
+
+        if (buffers.instanceBuffer) {
+            (parameters.programs.*instancedProgram)().drawInstanced(
+                context,
+                gl::Triangles(),
+                depthMode,
+                stencilMode,
+                colorModeForRenderPass(),
+                std::move(uniformValues),
+                symbolInstancedLayoutBindings(quadVertexBuffer, *buffers.instanceBuffer, *buffers.placementBuffer),
+                buffers.instanceCount,
+                tileTriangleIndexBuffer,
+                buffers.instancedSegments,
+                binders,
+                paintProperties,
+                state.getZoom()
+            );
+        } else {
+            (parameters.programs.*program)().draw(
+                context,
+                gl::Triangles(),
+                depthMode,
+                stencilMode,
+                colorModeForRenderPass(),
+                std::move(uniformValues),
+                symbolLayoutBindings(*buffers.vertexBuffer, *buffers.placementBuffer),
+                *buffers.indexBuffer,
+                buffers.segments,
+                binders,
+                paintProperties,
+                state.getZoom()
+            );
+        }
     };
 
     if (bucket.hasIconData()) {
@@ -73,7 +96,8 @@ void Painter::renderSymbol(PaintParameters& parameters,
 
         if (bucket.sdfIcons) {
             if (values.hasHalo) {
-                draw(parameters.programs.symbolIconSDF,
+                draw(&Programs::symbolIconSDF,
+                     &Programs::symbolIconSDFInstanced,
                      SymbolSDFIconProgram::uniformValues(values, texsize, pixelsToGLUnits, tile, state, SymbolSDFPart::Halo),
                      bucket.icon,
                      values,
@@ -82,7 +106,8 @@ void Painter::renderSymbol(PaintParameters& parameters,
             }
 
             if (values.hasFill) {
-                draw(parameters.programs.symbolIconSDF,
+                draw(&Programs::symbolIconSDF,
+                     &Programs::symbolIconSDFInstanced,
                      SymbolSDFIconProgram::uniformValues(values, texsize, pixelsToGLUnits, tile, state, SymbolSDFPart::Fill),
                      bucket.icon,
                      values,
@@ -90,7 +115,8 @@ void Painter::renderSymbol(PaintParameters& parameters,
                      paintPropertyValues);
             }
         } else {
-            draw(parameters.programs.symbolIcon,
+            draw(&Programs::symbolIcon,
+                 &Programs::symbolIconInstanced,
                  SymbolIconProgram::uniformValues(values, texsize, pixelsToGLUnits, tile, state),
                  bucket.icon,
                  values,
@@ -108,7 +134,8 @@ void Painter::renderSymbol(PaintParameters& parameters,
         const Size texsize = glyphAtlas->getSize();
 
         if (values.hasHalo) {
-            draw(parameters.programs.symbolGlyph,
+            draw(&Programs::symbolGlyph,
+                 &Programs::symbolGlyphInstanced,
                  SymbolSDFTextProgram::uniformValues(values, texsize, pixelsToGLUnits, tile, state, SymbolSDFPart::Halo),
                  bucket.text,
                  values,
@@ -117,7 +144,8 @@ void Painter::renderSymbol(PaintParameters& parameters,
         }
 
         if (values.hasFill) {
-            draw(parameters.programs.symbolGlyph,
+            draw(&Programs::symbolGlyph,
+                 &Programs::symbolGlyphInstanced,
                  SymbolSDFTextProgram::uniformValues(values, texsize, pixelsToGLUnits, tile, state, SymbolSDFPart::Fill),
                  bucket.text,
                  values,
@@ -130,7 +158,7 @@ void Painter::renderSymbol(PaintParameters& parameters,
         static const style::PaintProperties<>::Evaluated properties {};
         static const CollisionBoxProgram::PaintPropertyBinders paintAttributeData(properties, 0);
 
-        programs->collisionBox.draw(
+        programs->collisionBox().draw(
             context,
             gl::Lines { 1.0f },
             gl::DepthMode::disabled(),
@@ -3,16 +3,49 @@
 #include <mbgl/programs/raster_program.hpp>
 #include <mbgl/renderer/painter.hpp>
 #include <mbgl/gl/context.hpp>
+#include <mbgl/util/logging.hpp>
 
 namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+bool isPowerOfTwo(uint32_t value) {
+    return value && !(value & (value - 1));
+}
+
+} // namespace
+
 RasterBucket::RasterBucket(UnassociatedImage&& image_) : image(std::move(image_)) {
 }
 
+RasterBucket::RasterBucket(CompressedImage&& image_) : compressedImage(std::move(image_)) {
+}
+
 void RasterBucket::upload(gl::Context& context) {
-    texture = context.createTexture(std::move(image));
+    gl::ResourceOwnerScope owner { context, GLResourceStats::Owner::Raster };
+
+    if (!compressedImage) {
+        // Shared textures are mipmapped; the images they hold are square powers of two.
+        sharedTexture = context.createSharedTexture(image);
+        if (sharedTexture) {
+            mipmapped = true;
+            uploaded = true;
+            return;
+        }
+        texture = context.createTexture(std::move(image));
+        if (isPowerOfTwo(image.size.width) && isPowerOfTwo(image.size.height)) {
+            context.generateMipmap(*texture);
+            mipmapped = true;
+        }
+    } else if (context.supportsCompressedTextureFormat(compressedImage->format)) {
+        texture = context.createTexture(*compressedImage);
+        compressedImage = {};
+    } else {
+        Log::Warning(Event::OpenGL, "Unsupported compressed texture format 0x%04x", compressedImage->format);
+        compressedImage = {};
+    }
     uploaded = true;
 }
 
@@ -24,7 +57,35 @@ void RasterBucket::render(Painter& painter,
 }
 
 bool RasterBucket::hasData() const {
-    return true;
+    // Compressed images in a format the context doesn't support aren't drawn.
+    return !uploaded || texture || sharedTexture;
+}
+
+std::size_t RasterBucket::getVertexCount() const {
+    // Drawn with the painter's shared quad.
+    return 0;
+}
+
+void RasterBucket::addMemoryUsage(MemoryStats::Source& source) const {
+    // Compressed images in a format the context doesn't support aren't uploaded.
+    if (!uploaded || texture || sharedTexture) {
+        source.bucket(MemoryStats::BucketType::Raster) += memoryUsage();
+    }
+}
+
+std::size_t RasterBucket::measureByteSize() const {
+    if (compressedImage) {
+        std::size_t result = 0;
+        for (const auto& level : compressedImage->levels) {
+            result += level.size;
+        }
+        return result;
+    }
+    // With a third more for the mipmaps `upload` generates.
+    if (isPowerOfTwo(image.size.width) && isPowerOfTwo(image.size.height)) {
+        return image.bytes() * 4 / 3;
+    }
+    return image.bytes();
 }
 
 } // namespace mbgl
@@ -2,6 +2,7 @@
 
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/ktx.hpp>
 #include <mbgl/util/optional.hpp>
 #include <mbgl/gl/texture.hpp>
 
@@ -10,13 +11,28 @@ namespace mbgl {
 class RasterBucket : public Bucket {
 public:
     RasterBucket(UnassociatedImage&&);
+    RasterBucket(CompressedImage&&);
 
     void upload(gl::Context&) override;
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
     bool hasData() const override;
+    void addMemoryUsage(MemoryStats::Source&) const override;
+    std::size_t getVertexCount() const override;
 
     UnassociatedImage image;
+    optional<CompressedImage> compressedImage;
     optional<gl::Texture> texture;
+
+    // Images that fit a slot of a shared texture are drawn from one instead, so that
+    // neighbouring tiles bind the same texture; see `gl::Context::createSharedTexture`.
+    optional<gl::SharedTexture> sharedTexture;
+
+    // Whether the texture has mipmaps, for drawing it smaller than its size, as tiles are
+    // while zooming out.
+    bool mipmapped = false;
+
+protected:
+    std::size_t measureByteSize() const override;
 };
 
 } // namespace mbgl
@@ -2,6 +2,7 @@
 
 #include <mbgl/util/color.hpp>
 
+#include <cstdint>
 #include <unordered_set>
 #include <vector>
 
@@ -30,6 +31,10 @@ public:
 
 class RenderData {
 public:
+    // Changes whenever the order is rebuilt, and is unique across styles. While it stays the
+    // same, so do the render tiles of the sources and the tiles among them that are used.
+    uint64_t revision = 0;
+
     Color backgroundColor;
     std::unordered_set<style::Source*> sources;
     std::vector<RenderItem> order;
@@ -10,6 +10,8 @@ enum class RenderPass : uint8_t {
     None = 0,
     Opaque = 1 << 0,
     Translucent = 1 << 1,
+    // Draws into an offscreen texture, before the other passes; see `Painter::render3D`.
+    Pass3D = 1 << 2,
 };
 
 constexpr RenderPass operator|(RenderPass a, RenderPass b) {
@@ -26,6 +26,10 @@ public:
     mat4 matrix;
     bool used = false;
 
+    // Whether no other used tile of the source lies within this one, so that `clip` masks
+    // exactly the tile's extent.
+    bool clippedToExtent = false;
+
     mat4 translatedMatrix(const std::array<float, 2>& translate,
                           style::TranslateAnchorType anchor,
                           const TransformState&) const;
@@ -4,6 +4,8 @@
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 
+#include <limits>
+
 namespace mbgl {
 
 using namespace style;
@@ -25,30 +27,112 @@ SymbolBucket::SymbolBucket(style::SymbolLayoutProperties::Evaluated layout_,
     }
 }
 
-void SymbolBucket::upload(gl::Context& context) {
-    if (hasTextData()) {
-        text.vertexBuffer = context.createVertexBuffer(std::move(text.vertices));
-        text.indexBuffer = context.createIndexBuffer(std::move(text.triangles));
+namespace {
+
+template <class Buffer>
+void uploadLayout(gl::Context& context, Buffer& buffer) {
+    if (context.supportsInstancing()) {
+        buffer.instanceBuffer = context.createVertexBuffer(std::move(buffer.instances));
+        buffer.instancedSegments.emplace_back(0, 0, 4, 6);
+        return;
     }
 
-    if (hasIconData()) {
-        icon.vertexBuffer = context.createVertexBuffer(std::move(icon.vertices));
-        icon.indexBuffer = context.createIndexBuffer(std::move(icon.triangles));
+    constexpr const uint16_t vertexLength = 4;
+
+    for (std::size_t i = 0; i < buffer.instances.vertexSize(); ++i) {
+        const auto& quad = buffer.instances.data()[i];
+
+        if (buffer.segments.empty() || buffer.segments.back().vertexLength + vertexLength > std::numeric_limits<uint16_t>::max()) {
+            buffer.segments.emplace_back(buffer.vertices.vertexSize(), buffer.triangles.indexSize());
+        }
+
+        auto& segment = buffer.segments.back();
+        assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
+        uint16_t index = segment.vertexLength;
+
+        // The corners in the order of the painter's quad: tl, tr, bl, br.
+        buffer.vertices.emplace_back(SymbolInstanceAttributes::corner(quad, false, false));
+        buffer.vertices.emplace_back(SymbolInstanceAttributes::corner(quad, true, false));
+        buffer.vertices.emplace_back(SymbolInstanceAttributes::corner(quad, false, true));
+        buffer.vertices.emplace_back(SymbolInstanceAttributes::corner(quad, true, true));
+
+        buffer.triangles.emplace_back(index + 0, index + 1, index + 2);
+        buffer.triangles.emplace_back(index + 1, index + 2, index + 3);
+
+        segment.vertexLength += vertexLength;
+        segment.indexLength += 6;
     }
 
-    if (!collisionBox.vertices.empty()) {
-        collisionBox.vertexBuffer = context.createVertexBuffer(std::move(collisionBox.vertices));
-        collisionBox.indexBuffer = context.createIndexBuffer(std::move(collisionBox.lines));
+    buffer.instances = {};
+
+    buffer.vertexBuffer = context.createVertexBuffer(std::move(buffer.vertices));
+    buffer.indexBuffer = context.createIndexBuffer(std::move(buffer.triangles), buffer.segments);
+}
+
+template <class Buffer>
+void uploadPlacement(gl::Context& context, Buffer& buffer, gl::VertexVector<SymbolPlacementVertex>& placement) {
+    assert(placement.vertexSize() == buffer.instanceCount);
+    if (!buffer.instanceBuffer) {
+        placement.repeatEach(4);
+    }
+    buffer.placementBuffer = context.createVertexBuffer(std::move(placement));
+}
+
+} // namespace
+
+void SymbolBucket::upload(gl::Context& context) {
+    gl::ResourceOwnerScope owner { context, GLResourceStats::Owner::Symbol };
+
+    // After the first upload, only a new placement needs to be uploaded.
+    if (!layoutUploaded) {
+        if (hasTextData()) {
+            uploadLayout(context, text);
+        }
+
+        if (hasIconData()) {
+            uploadLayout(context, icon);
+        }
+
+        // Without instancing, each quad's paint attributes are repeated for its vertices.
+        const bool expanded = !context.supportsInstancing();
+        for (auto& pair : paintPropertyBinders) {
+            if (expanded) {
+                pair.second.first.repeatVertices(4);
+                pair.second.second.repeatVertices(4);
+            }
+            pair.second.first.upload(context);
+            pair.second.second.upload(context);
+        }
+
+        layoutUploaded = true;
     }
 
-    for (auto& pair : paintPropertyBinders) {
-        pair.second.first.upload(context);
-        pair.second.second.upload(context);
+    if (placement) {
+        if (hasTextData()) {
+            uploadPlacement(context, text, placement->text);
+        }
+
+        if (hasIconData()) {
+            uploadPlacement(context, icon, placement->icon);
+        }
+
+        collisionBox.segments = std::move(placement->collisionBox.segments);
+        if (!collisionBox.segments.empty()) {
+            collisionBox.vertexBuffer = context.createVertexBuffer(std::move(placement->collisionBox.vertices));
+            collisionBox.indexBuffer = context.createIndexBuffer(std::move(placement->collisionBox.lines), collisionBox.segments);
+        }
+
+        placement.reset();
     }
 
     uploaded = true;
 }
 
+void SymbolBucket::setPlacement(std::shared_ptr<SymbolBucketPlacement> placement_) {
+    placement = std::move(placement_);
+    uploaded = false;
+}
+
 void SymbolBucket::render(Painter& painter,
                           PaintParameters& parameters,
                           const Layer& layer,
@@ -61,12 +145,37 @@ bool SymbolBucket::hasData() const {
     return false;
 }
 
+std::size_t SymbolBucket::getVertexCount() const {
+    return text.instances.vertexSize() + text.vertices.vertexSize() +
+        icon.instances.vertexSize() + icon.vertices.vertexSize() +
+        collisionBox.vertices.vertexSize();
+}
+
+void SymbolBucket::addMemoryUsage(MemoryStats::Source& source) const {
+    source.bucket(MemoryStats::BucketType::Symbol) += memoryUsage();
+}
+
+std::size_t SymbolBucket::measureByteSize() const {
+    std::size_t result =
+        text.instances.byteSize() + text.vertices.byteSize() + text.triangles.byteSize() +
+        icon.instances.byteSize() + icon.vertices.byteSize() + icon.triangles.byteSize() +
+        collisionBox.vertices.byteSize() + collisionBox.lines.byteSize();
+    if (placement) {
+        result += placement->text.byteSize() + placement->icon.byteSize() +
+            placement->collisionBox.vertices.byteSize() + placement->collisionBox.lines.byteSize();
+    }
+    for (const auto& pair : paintPropertyBinders) {
+        result += pair.second.first.byteSize() + pair.second.second.byteSize();
+    }
+    return result;
+}
+
 bool SymbolBucket::hasTextData() const {
-    return !text.segments.empty();
+    return text.instanceCount > 0;
 }
 
 bool SymbolBucket::hasIconData() const {
-    return !icon.segments.empty();
+    return icon.instanceCount > 0;
 }
 
 bool SymbolBucket::hasCollisionBoxData() const {
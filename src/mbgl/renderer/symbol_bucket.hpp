@@ -10,10 +10,13 @@
 #include <mbgl/text/glyph_range.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 
+#include <memory>
 #include <vector>
 
 namespace mbgl {
 
+class SymbolBucketPlacement;
+
 class SymbolBucket : public Bucket {
 public:
     SymbolBucket(style::SymbolLayoutProperties::Evaluated,
@@ -25,10 +28,16 @@ public:
     void upload(gl::Context&) override;
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
     bool hasData() const override;
+    void addMemoryUsage(MemoryStats::Source&) const override;
+    std::size_t getVertexCount() const override;
     bool hasTextData() const;
     bool hasIconData() const;
     bool hasCollisionBoxData() const;
 
+    // Replaces the placement of the symbols, keeping their layout. The new placement is
+    // uploaded with the next `upload`.
+    void setPlacement(std::shared_ptr<SymbolBucketPlacement>);
+
     const style::SymbolLayoutProperties::Evaluated layout;
     const bool sdfIcons;
     const bool iconsNeedLinear;
@@ -38,21 +47,45 @@ public:
         SymbolSDFTextProgram::PaintPropertyBinders>> paintPropertyBinders;
 
     struct TextBuffer {
+        // One entry per quad, as are the paint property binders' vertex vectors.
+        gl::VertexVector<SymbolInstanceVertex> instances;
+        std::size_t instanceCount = 0;
+
+        // Drawn as instances of the painter's quad, if the context supports it.
+        optional<gl::VertexBuffer<SymbolInstanceVertex>> instanceBuffer;
+        gl::SegmentVector<SymbolTextInstancedAttributes> instancedSegments;
+
+        // Otherwise, each quad is expanded into four vertices of its own on upload.
         gl::VertexVector<SymbolLayoutVertex> vertices;
         gl::IndexVector<gl::Triangles> triangles;
         gl::SegmentVector<SymbolTextAttributes> segments;
 
         optional<gl::VertexBuffer<SymbolLayoutVertex>> vertexBuffer;
         optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
+
+        // Parallel to whichever of the instances or the vertices are uploaded.
+        optional<gl::VertexBuffer<SymbolPlacementVertex>> placementBuffer;
     } text;
 
     struct IconBuffer {
+        // One entry per quad, as are the paint property binders' vertex vectors.
+        gl::VertexVector<SymbolInstanceVertex> instances;
+        std::size_t instanceCount = 0;
+
+        // Drawn as instances of the painter's quad, if the context supports it.
+        optional<gl::VertexBuffer<SymbolInstanceVertex>> instanceBuffer;
+        gl::SegmentVector<SymbolIconInstancedAttributes> instancedSegments;
+
+        // Otherwise, each quad is expanded into four vertices of its own on upload.
         gl::VertexVector<SymbolLayoutVertex> vertices;
         gl::IndexVector<gl::Triangles> triangles;
         gl::SegmentVector<SymbolIconAttributes> segments;
 
         optional<gl::VertexBuffer<SymbolLayoutVertex>> vertexBuffer;
         optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
+
+        // Parallel to whichever of the instances or the vertices are uploaded.
+        optional<gl::VertexBuffer<SymbolPlacementVertex>> placementBuffer;
     } icon;
 
     struct CollisionBoxBuffer {
@@ -63,6 +96,24 @@ public:
         optional<gl::VertexBuffer<CollisionBoxVertex>> vertexBuffer;
         optional<gl::IndexBuffer<gl::Lines>> indexBuffer;
     } collisionBox;
+
+protected:
+    std::size_t measureByteSize() const override;
+
+private:
+    bool layoutUploaded = false;
+
+    // Not uploaded yet.
+    std::shared_ptr<SymbolBucketPlacement> placement;
+};
+
+// The placement of the symbols of a `SymbolBucket`: one vertex for each of its text and
+// icon quads, and the collision boxes to draw in debug mode.
+class SymbolBucketPlacement {
+public:
+    gl::VertexVector<SymbolPlacementVertex> text;
+    gl::VertexVector<SymbolPlacementVertex> icon;
+    SymbolBucket::CollisionBoxBuffer collisionBox;
 };
 
 } // namespace mbgl
@@ -0,0 +1,23 @@
+#include <mbgl/renderer/upload_scheduler.hpp>
+#include <mbgl/tile/tile.hpp>
+
+namespace mbgl {
+
+void UploadScheduler::startFrame() {
+    spent = Duration::zero();
+    deferred = false;
+}
+
+void UploadScheduler::upload(Tile& tile, gl::Context& context) {
+    if (budget != Duration::zero() && spent >= budget) {
+        tile.deferUpload();
+        deferred = true;
+        return;
+    }
+
+    const TimePoint start = Clock::now();
+    tile.upload(context);
+    spent += Clock::now() - start;
+}
+
+} // namespace mbgl
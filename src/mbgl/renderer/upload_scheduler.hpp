@@ -0,0 +1,53 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/constants.hpp>
+
+namespace mbgl {
+
+class Tile;
+
+namespace gl {
+class Context;
+} // namespace gl
+
+/*
+    Spreads the first upload of newly loaded tiles over several frames, so that the dozens
+    of tiles that finish loading after a zoom don't all upload their buckets in the same
+    frame.
+
+    Tiles are uploaded until the time spent uploading in the current frame exceeds the
+    budget. The remaining ones are deferred: they aren't renderable for the time being, so
+    that `updateRenderables` falls back to their parents or children, and are uploaded in
+    a later frame. At least one tile is uploaded in every frame, and a budget of zero
+    uploads all of them at once.
+*/
+class UploadScheduler {
+public:
+    void setBudget(Duration budget_) {
+        budget = budget_;
+    }
+
+    Duration getBudget() const {
+        return budget;
+    }
+
+    // Resets the time spent, and forgets about tiles deferred in earlier frames.
+    void startFrame();
+
+    // Uploads the tile unless this frame's budget is spent, in which case it is deferred.
+    void upload(Tile&, gl::Context&);
+
+    // Returns true when a tile has been deferred in this frame, and another frame is
+    // needed to upload it.
+    bool hasDeferred() const {
+        return deferred;
+    }
+
+private:
+    Duration budget = util::DEFAULT_TILE_UPLOAD_BUDGET;
+    Duration spent = Duration::zero();
+    bool deferred = false;
+};
+
+} // namespace mbgl
@@ -65,6 +65,8 @@ uniform mat4 u_matrix;
 uniform vec2 u_tl_parent;
 uniform float u_scale_parent;
 uniform float u_buffer_scale;
+uniform vec2 u_tex_offset;
+uniform vec2 u_tex_scale;
 
 attribute vec2 a_pos;
 attribute vec2 a_texture_pos;
@@ -74,8 +76,12 @@ varying vec2 v_pos1;
 
 void main() {
     gl_Position = u_matrix * vec4(a_pos, 0, 1);
-    v_pos0 = (((a_texture_pos / 32767.0) - 0.5) / u_buffer_scale ) + 0.5;
-    v_pos1 = (v_pos0 * u_scale_parent) + u_tl_parent;
+    vec2 pos0 = (((a_texture_pos / 32767.0) - 0.5) / u_buffer_scale ) + 0.5;
+    vec2 pos1 = (pos0 * u_scale_parent) + u_tl_parent;
+
+    // Into the slot of a shared texture the tile may be drawn from
+    v_pos0 = u_tex_offset + pos0 * u_tex_scale;
+    v_pos1 = u_tex_offset + pos1 * u_tex_scale;
 }
 
 )MBGL_SHADER";
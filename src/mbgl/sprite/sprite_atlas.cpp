@@ -20,13 +20,53 @@ namespace mbgl {
 
 static SpriteAtlasObserver nullObserver;
 
+constexpr uint32_t SpriteAtlas::maxImageSize;
+
 struct SpriteAtlas::Loader {
+    std::string url;
     std::shared_ptr<const std::string> image;
     std::shared_ptr<const std::string> json;
     std::unique_ptr<AsyncRequest> jsonRequest;
     std::unique_ptr<AsyncRequest> spriteRequest;
 };
 
+// Sprite sheets stay in this process-wide cache for as long as any atlas uses them, so that
+// maps loading styles with the same sprite download and decode it once. The responses they were
+// parsed from are kept to tell whether a sheet that was loaded again changed in the meantime.
+struct SpriteAtlas::SharedSheet {
+    using Key = std::pair<std::string, float>;
+
+    std::shared_ptr<const std::string> image;
+    std::shared_ptr<const std::string> json;
+    std::shared_ptr<const SpriteSheet> sheet;
+
+    static std::shared_ptr<const SharedSheet> find(const Key& key) {
+        std::lock_guard<std::mutex> lock(sheetsMutex);
+        purge();
+        auto it = sheets.find(key);
+        return it == sheets.end() ? nullptr : it->second.lock();
+    }
+
+    static void insert(const Key& key, const std::shared_ptr<const SharedSheet>& sheet) {
+        std::lock_guard<std::mutex> lock(sheetsMutex);
+        purge();
+        sheets[key] = sheet;
+    }
+
+private:
+    static void purge() {
+        for (auto it = sheets.begin(); it != sheets.end();) {
+            it = it->second.expired() ? sheets.erase(it) : std::next(it);
+        }
+    }
+
+    static std::mutex sheetsMutex;
+    static std::map<Key, std::weak_ptr<const SharedSheet>> sheets;
+};
+
+std::mutex SpriteAtlas::SharedSheet::sheetsMutex;
+std::map<SpriteAtlas::SharedSheet::Key, std::weak_ptr<const SpriteAtlas::SharedSheet>> SpriteAtlas::SharedSheet::sheets;
+
 SpriteAtlasElement::SpriteAtlasElement(Rect<uint16_t> rect_,
                                        std::shared_ptr<const SpriteImage> image_,
                                        Size size_, float pixelRatio)
@@ -48,8 +88,7 @@ SpriteAtlas::SpriteAtlas(Size size_, float pixelRatio_)
     : size(std::move(size_)),
       pixelRatio(pixelRatio_),
       observer(&nullObserver),
-      bin(size.width, size.height),
-      dirty(true) {
+      bin(size.width, size.height) {
 }
 
 SpriteAtlas::~SpriteAtlas() = default;
@@ -61,7 +100,20 @@ void SpriteAtlas::load(const std::string& url, FileSource& fileSource) {
         return;
     }
 
+    // A sheet that another atlas is using is taken as it is, without requesting it again.
+    if (auto shared = SharedSheet::find({ url, pixelRatio })) {
+        loaded = true;
+        sharedSheet = std::move(shared);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            _setSpriteSheet(sharedSheet->sheet);
+        }
+        observer->onSpriteLoaded();
+        return;
+    }
+
     loader = std::make_unique<Loader>();
+    loader->url = url;
 
     loader->jsonRequest = fileSource.request(Resource::spriteJSON(url, pixelRatio), [this](Response res) {
         if (res.error) {
@@ -100,14 +152,30 @@ void SpriteAtlas::emitSpriteLoadedIfComplete() {
         return;
     }
 
-    auto result = parseSprite(*loader->image, *loader->json);
-    if (result.is<Sprites>()) {
-        loaded = true;
-        setSprites(result.get<Sprites>());
-        observer->onSpriteLoaded();
-    } else {
-        observer->onSpriteError(result.get<std::exception_ptr>());
+    // Another atlas may have parsed the same responses while they were being loaded for this one.
+    const SharedSheet::Key key { loader->url, pixelRatio };
+    auto shared = SharedSheet::find(key);
+    if (!shared || *shared->image != *loader->image || *shared->json != *loader->json) {
+        auto result = parseSpriteSheet(*loader->image, *loader->json);
+        if (!result.is<SpriteSheet>()) {
+            observer->onSpriteError(result.get<std::exception_ptr>());
+            return;
+        }
+        shared = std::make_shared<const SharedSheet>(SharedSheet {
+            loader->image,
+            loader->json,
+            std::make_shared<const SpriteSheet>(std::move(result.get<SpriteSheet>()))
+        });
+        SharedSheet::insert(key, shared);
+    }
+
+    loaded = true;
+    sharedSheet = std::move(shared);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        _setSpriteSheet(sharedSheet->sheet);
     }
+    observer->onSpriteLoaded();
 }
 
 void SpriteAtlas::setObserver(SpriteAtlasObserver* observer_) {
@@ -125,6 +193,47 @@ void SpriteAtlas::setSprites(const Sprites& newSprites) {
     }
 }
 
+void SpriteAtlas::setSpriteSheet(SpriteSheet sheet) {
+    std::lock_guard<std::mutex> lock(mutex);
+    _setSpriteSheet(std::make_shared<const SpriteSheet>(std::move(sheet)));
+}
+
+void SpriteAtlas::_setSpriteSheet(const std::shared_ptr<const SpriteSheet>& sheet) {
+    for (const auto& pair : sheet->images) {
+        const SpriteSheet::Image& sheetImage = pair.second;
+
+        auto it = entries.find(pair.first);
+        if (it == entries.end()) {
+            entries.emplace(pair.first, Entry { nullptr, {}, {}, sheet, sheetImage });
+            continue;
+        }
+
+        // Images that are in the texture already are replaced there right away.
+        Entry& entry = it->second;
+        if (!entry.iconRect && !entry.patternRect &&
+            imageSize(entry) == Size { sheetImage.width, sheetImage.height }) {
+            entry.spriteImage = nullptr;
+            entry.sheet = sheet;
+            entry.sheetImage = sheetImage;
+        } else {
+            _setSprite(pair.first, sheet->createSpriteImage(sheetImage));
+        }
+    }
+}
+
+const std::shared_ptr<const SpriteImage>& SpriteAtlas::extract(Entry& entry) {
+    if (!entry.spriteImage) {
+        entry.spriteImage = entry.sheet->createSpriteImage(entry.sheetImage);
+        entry.sheet.reset();
+    }
+    return entry.spriteImage;
+}
+
+Size SpriteAtlas::imageSize(const Entry& entry) {
+    return entry.spriteImage ? entry.spriteImage->image.size
+                             : Size { entry.sheetImage.width, entry.sheetImage.height };
+}
+
 void SpriteAtlas::setSprite(const std::string& name, std::shared_ptr<const SpriteImage> sprite) {
     std::lock_guard<std::mutex> lock(mutex);
     _setSprite(name, sprite);
@@ -160,19 +269,20 @@ void SpriteAtlas::_setSprite(const std::string& name,
 
     auto it = entries.find(name);
     if (it == entries.end()) {
-        entries.emplace(name, Entry { sprite, {}, {} });
+        entries.emplace(name, Entry { sprite, {}, {}, {}, {} });
         return;
     }
 
     Entry& entry = it->second;
 
     // There is already a sprite with that name in our store.
-    if (entry.spriteImage->image.size != sprite->image.size) {
+    if (imageSize(entry) != sprite->image.size) {
         Log::Warning(Event::Sprite, "Can't change sprite dimensions for '%s'", name.c_str());
         return;
     }
 
     entry.spriteImage = sprite;
+    entry.sheet.reset();
 
     if (entry.iconRect) {
         copy(entry, &Entry::iconRect);
@@ -187,7 +297,7 @@ std::shared_ptr<const SpriteImage> SpriteAtlas::getSprite(const std::string& nam
     std::lock_guard<std::mutex> lock(mutex);
     const auto it = entries.find(name);
     if (it != entries.end()) {
-        return it->second.spriteImage;
+        return extract(it->second);
     } else {
         if (!entries.empty()) {
             Log::Info(Event::Sprite, "Can't find sprite named '%s'", name.c_str());
@@ -217,6 +327,7 @@ optional<SpriteAtlasElement> SpriteAtlas::getImage(const std::string& name,
     }
 
     Entry& entry = it->second;
+    extract(entry);
 
     if (entry.*entryRect) {
         return SpriteAtlasElement {
@@ -238,6 +349,9 @@ optional<SpriteAtlasElement> SpriteAtlas::getImage(const std::string& name,
 
     // We have to allocate a new area in the bin, and store an empty image in it.
     Rect<uint16_t> rect = bin.allocate(packWidth, packHeight);
+    while (rect.w == 0 && grow()) {
+        rect = bin.allocate(packWidth, packHeight);
+    }
     if (rect.w == 0) {
         if (debug::spriteWarnings) {
             Log::Warning(Event::Sprite, "sprite atlas bitmap overflow");
@@ -282,25 +396,68 @@ void SpriteAtlas::copy(const Entry& entry, optional<Rect<uint16_t>> Entry::*entr
         PremultipliedImage::copy(src, image, { 0,     0 }, { x + w, y }, { 1, h }); // R
     }
 
-    dirty = true;
+    // The pixels that the rect covers, including its padding.
+    const uint32_t x0 = rect.x * pixelRatio;
+    const uint32_t y0 = rect.y * pixelRatio;
+    const uint32_t x1 = std::min<uint32_t>(std::ceil((rect.x + rect.w) * pixelRatio), image.size.width);
+    const uint32_t y1 = std::min<uint32_t>(std::ceil((rect.y + rect.h) * pixelRatio), image.size.height);
+    dirtyRegions.emplace_back(x0, y0, x1 - x0, y1 - y0);
+}
+
+bool SpriteAtlas::grow() {
+    const uint32_t maxSize = maxImageSize / pixelRatio;
+    const Size newSize { std::min(size.width * 2, maxSize), std::min(size.height * 2, maxSize) };
+    if (newSize.width <= size.width && newSize.height <= size.height) {
+        return false;
+    }
+
+    bin.grow(newSize.width, newSize.height);
+    size = newSize;
+
+    if (image.valid()) {
+        PremultipliedImage grown({ static_cast<uint32_t>(std::ceil(size.width * pixelRatio)),
+                                   static_cast<uint32_t>(std::ceil(size.height * pixelRatio)) });
+        grown.fill(0);
+        PremultipliedImage::copy(image, grown, { 0, 0 }, { 0, 0 }, image.size);
+        image = std::move(grown);
+
+        // The texture is recreated at the new size, with all of the image.
+        dirtyRegions.clear();
+    }
+
+    return true;
+}
+
+Size SpriteAtlas::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return size;
+}
+
+MemoryStats::Usage SpriteAtlas::getMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    MemoryStats::Usage result;
+    result.cpuBytes = image.bytes();
+    result.gpuBytes = texture ? texture->size.area() * image.channels : 0;
+    return result;
 }
 
 void SpriteAtlas::upload(gl::Context& context, gl::TextureUnit unit) {
-    if (!texture) {
+    gl::ResourceOwnerScope owner { context, GLResourceStats::Owner::Atlas };
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!texture || texture->size != image.size) {
         texture = context.createTexture(image, unit);
-    } else if (dirty) {
-        context.updateTexture(*texture, image, unit);
+    } else {
+        context.updateTextureRegions(*texture, image, std::move(dirtyRegions), unit);
     }
+    dirtyRegions.clear();
 
 #if not MBGL_USE_GLES2
-//    if (dirty) {
-//        platform::showColorDebugImage("Sprite Atlas",
-//                                      reinterpret_cast<const char*>(image.data.get()), size.width,
-//                                      size.height, image.size.width, image.size.height);
-//    }
+//    platform::showColorDebugImage("Sprite Atlas",
+//                                  reinterpret_cast<const char*>(image.data.get()), size.width,
+//                                  size.height, image.size.width, image.size.height);
 #endif // MBGL_USE_GLES2
-
-    dirty = false;
 }
 
 void SpriteAtlas::bind(bool linear, gl::Context& context, gl::TextureUnit unit) {
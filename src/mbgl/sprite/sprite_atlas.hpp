@@ -1,18 +1,20 @@
 #pragma once
 
 #include <mbgl/geometry/binpack.hpp>
+#include <mbgl/map/memory_stats.hpp>
 #include <mbgl/gl/texture.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/optional.hpp>
 #include <mbgl/sprite/sprite_image.hpp>
+#include <mbgl/sprite/sprite_parser.hpp>
 
-#include <atomic>
 #include <string>
 #include <map>
 #include <mutex>
 #include <unordered_map>
 #include <array>
 #include <memory>
+#include <vector>
 
 namespace mbgl {
 
@@ -65,12 +67,25 @@ public:
     void bind(bool linear, gl::Context&, gl::TextureUnit unit);
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
+    // only the regions of sprites added or changed since the last upload are sent, unless
+    // the atlas has grown since.
     void upload(gl::Context&, gl::TextureUnit unit);
 
-    Size getSize() const { return size; }
+    // The atlas starts out at the size it was created with, and doubles whenever a sprite
+    // doesn't fit, up to `maxImageSize` pixels on each side. Sprites keep their position
+    // when it grows, but their normalized texture coordinates change.
+    Size getSize() const;
+
+    // The bytes of the image on the CPU, and of the texture it was uploaded into.
+    MemoryStats::Usage getMemoryUsage() const;
+
+    static constexpr uint32_t maxImageSize = 4096;
+
     float getPixelRatio() const { return pixelRatio; }
 
+    // Adds the images of a sprite sheet, which are extracted from it as they are first used.
+    void setSpriteSheet(SpriteSheet);
+
     // Only for use in tests.
     void setSprites(const Sprites& sprites);
     const PremultipliedImage& getAtlasImage() const {
@@ -79,15 +94,21 @@ public:
 
 private:
     void _setSprite(const std::string&, const std::shared_ptr<const SpriteImage>& = nullptr);
+    void _setSpriteSheet(const std::shared_ptr<const SpriteSheet>&);
     void emitSpriteLoadedIfComplete();
+    bool grow();
 
-
-    const Size size;
+    Size size;
     const float pixelRatio;
 
     struct Loader;
     std::unique_ptr<Loader> loader;
 
+    // The parsed sprite sheet, shared with the other atlases that loaded it from the same URL
+    // at the same pixel ratio.
+    struct SharedSheet;
+    std::shared_ptr<const SharedSheet> sharedSheet;
+
     bool loaded = false;
 
     SpriteAtlasObserver* observer = nullptr;
@@ -101,17 +122,26 @@ private:
         // pixel border wrapped from the opposite side.
         optional<Rect<uint16_t>> iconRect;
         optional<Rect<uint16_t>> patternRect;
+
+        // Where the sprite image is to be extracted from, until it is.
+        std::shared_ptr<const SpriteSheet> sheet;
+        SpriteSheet::Image sheetImage;
     };
 
+    const std::shared_ptr<const SpriteImage>& extract(Entry&);
+    static Size imageSize(const Entry&);
+
     optional<SpriteAtlasElement> getImage(const std::string& name, optional<Rect<uint16_t>> Entry::*rect);
     void copy(const Entry&, optional<Rect<uint16_t>> Entry::*rect);
 
-    std::mutex mutex;
+    mutable std::mutex mutex;
     std::unordered_map<std::string, Entry> entries;
     BinPack<uint16_t> bin;
     PremultipliedImage image;
     mbgl::optional<gl::Texture> texture;
-    std::atomic<bool> dirty;
+
+    // Regions of the image, in pixels, that changed since the last upload.
+    std::vector<Rect<uint16_t>> dirtyRegions;
 };
 
 } // namespace mbgl
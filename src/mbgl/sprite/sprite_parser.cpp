@@ -13,13 +13,14 @@
 
 namespace mbgl {
 
-SpriteImagePtr createSpriteImage(const PremultipliedImage& image,
-                                 const uint32_t srcX,
-                                 const uint32_t srcY,
-                                 const uint32_t width,
-                                 const uint32_t height,
-                                 const double ratio,
-                                 const bool sdf) {
+namespace {
+
+bool validMetrics(const PremultipliedImage& image,
+                  const uint32_t srcX,
+                  const uint32_t srcY,
+                  const uint32_t width,
+                  const uint32_t height,
+                  const double ratio) {
     // Disallow invalid parameter configurations.
     if (width <= 0 || height <= 0 || width > 1024 || height > 1024 ||
         ratio <= 0 || ratio > 10 ||
@@ -29,6 +30,21 @@ SpriteImagePtr createSpriteImage(const PremultipliedImage& image,
             width, height, srcX, srcY,
             image.size.width, image.size.height,
             util::toString(ratio).c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+SpriteImagePtr createSpriteImage(const PremultipliedImage& image,
+                                 const uint32_t srcX,
+                                 const uint32_t srcY,
+                                 const uint32_t width,
+                                 const uint32_t height,
+                                 const double ratio,
+                                 const bool sdf) {
+    if (!validMetrics(image, srcX, srcY, width, height, ratio)) {
         return nullptr;
     }
 
@@ -40,6 +56,11 @@ SpriteImagePtr createSpriteImage(const PremultipliedImage& image,
     return std::make_unique<const SpriteImage>(std::move(dstImage), ratio, sdf);
 }
 
+SpriteImagePtr SpriteSheet::createSpriteImage(const Image& metrics) const {
+    return mbgl::createSpriteImage(*image, metrics.x, metrics.y, metrics.width, metrics.height,
+                                   metrics.pixelRatio, metrics.sdf);
+}
+
 namespace {
 
 uint16_t getUInt16(const JSValue& value, const char* name, const uint16_t def = 0) {
@@ -84,12 +105,11 @@ bool getBoolean(const JSValue& value, const char* name, const bool def = false)
 
 } // namespace
 
-SpriteParseResult parseSprite(const std::string& image, const std::string& json) {
-    Sprites sprites;
-    PremultipliedImage raster;
+SpriteSheetParseResult parseSpriteSheet(const std::string& image, const std::string& json) {
+    SpriteSheet sheet;
 
     try {
-        raster = decodeImage(image);
+        sheet.image = std::make_shared<const PremultipliedImage>(decodeImage(image));
     } catch (...) {
         return std::current_exception();
     }
@@ -116,14 +136,28 @@ SpriteParseResult parseSprite(const std::string& image, const std::string& json)
                 const double pixelRatio = getDouble(value, "pixelRatio", 1);
                 const bool sdf = getBoolean(value, "sdf", false);
 
-                auto sprite = createSpriteImage(raster, x, y, width, height, pixelRatio, sdf);
-                if (sprite) {
-                    sprites.emplace(name, sprite);
+                if (validMetrics(*sheet.image, x, y, width, height, pixelRatio)) {
+                    sheet.images.emplace(name, SpriteSheet::Image { x, y, width, height, pixelRatio, sdf });
                 }
             }
         }
     }
 
+    return sheet;
+}
+
+SpriteParseResult parseSprite(const std::string& image, const std::string& json) {
+    SpriteSheetParseResult result = parseSpriteSheet(image, json);
+    if (result.is<std::exception_ptr>()) {
+        return result.get<std::exception_ptr>();
+    }
+
+    const SpriteSheet& sheet = result.get<SpriteSheet>();
+
+    Sprites sprites;
+    for (const auto& entry : sheet.images) {
+        sprites.emplace(entry.first, sheet.createSpriteImage(entry.second));
+    }
     return sprites;
 }
 
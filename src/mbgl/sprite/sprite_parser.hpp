@@ -26,12 +26,38 @@ SpriteImagePtr createSpriteImage(const PremultipliedImage&,
 
 using Sprites = std::map<std::string, SpriteImagePtr>;
 
+// The images of a decoded sprite sheet, to be extracted with `createSpriteImage` when they
+// are first used. Images with invalid metrics are left out.
+class SpriteSheet {
+public:
+    struct Image {
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+        uint32_t height;
+        double pixelRatio;
+        bool sdf;
+    };
+
+    std::shared_ptr<const PremultipliedImage> image;
+    std::map<std::string, Image> images;
+
+    SpriteImagePtr createSpriteImage(const Image&) const;
+};
+
 
 using SpriteParseResult = variant<
     Sprites,             // success
     std::exception_ptr>; // error
 
+using SpriteSheetParseResult = variant<
+    SpriteSheet,         // success
+    std::exception_ptr>; // error
+
 // Parses an image and an associated JSON file and returns the sprite objects.
 SpriteParseResult parseSprite(const std::string& image, const std::string& json);
 
+// Like `parseSprite`, without extracting the images.
+SpriteSheetParseResult parseSpriteSheet(const std::string& image, const std::string& json);
+
 } // namespace mbgl
@@ -0,0 +1,50 @@
+#include <mbgl/storage/concurrency_limit.hpp>
+#include <mbgl/math/clamp.hpp>
+#include <mbgl/math/minmax.hpp>
+
+#include <cmath>
+
+namespace mbgl {
+
+namespace {
+
+// Weight of a new sample in the average latency.
+constexpr double latencyWeight = 0.1;
+
+// Weight of a new estimate in the limit, so that it doesn't swing with every request.
+constexpr double limitWeight = 0.2;
+
+constexpr uint32_t samplesPerWindow = 500;
+
+} // namespace
+
+ConcurrencyLimit::ConcurrencyLimit(uint32_t initial, uint32_t minimum_, uint32_t maximum_)
+    : minimum(minimum_),
+      maximum(maximum_),
+      limit(util::clamp<double>(initial, minimum_, maximum_)) {
+}
+
+void ConcurrencyLimit::sample(Duration duration) {
+    const double seconds = std::chrono::duration<double>(duration).count();
+    if (samples++ == 0) {
+        latency = lowestLatency = windowLowestLatency = seconds;
+        return;
+    }
+
+    latency += latencyWeight * (seconds - latency);
+    windowLowestLatency = util::min(windowLowestLatency, latency);
+    if (samples % samplesPerWindow == 0) {
+        lowestLatency = windowLowestLatency;
+        windowLowestLatency = latency;
+    }
+
+    // Getting slower at most halves the limit at once.
+    const double lowest = util::min(lowestLatency, windowLowestLatency);
+    const double gradient = latency > 0 ? util::clamp(lowest / latency, 0.5, 1.0) : 1.0;
+
+    // Leaves room for a few more requests than the link seems to take, to probe for more.
+    const double estimate = limit * gradient + std::sqrt(limit);
+    limit = util::clamp(limit + limitWeight * (estimate - limit), minimum, maximum);
+}
+
+} // namespace mbgl
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+#include <cstdint>
+
+namespace mbgl {
+
+/*
+    The number of requests to keep in flight over the network, adjusted to how it performs.
+    Latencies of completed requests are averaged over the last few requests, and compared to
+    the lowest such average seen lately. While requests are about as fast as they get, neither
+    the round trip nor the bandwidth is saturated, and the limit grows, so that high-latency
+    links keep more requests in flight. Once requests get slower, they are only sharing the
+    same bandwidth, or queueing somewhere on the way, and the limit shrinks in proportion.
+*/
+class ConcurrencyLimit {
+public:
+    ConcurrencyLimit(uint32_t initial, uint32_t minimum, uint32_t maximum);
+
+    // Records the time from starting a request to receiving all of its response.
+    void sample(Duration latency);
+
+    uint32_t get() const {
+        return static_cast<uint32_t>(limit);
+    }
+
+private:
+    const double minimum;
+    const double maximum;
+    double limit;
+
+    // In seconds. The lowest average is kept for two windows of samples, so that it follows
+    // a change of network.
+    double latency = 0;
+    double lowestLatency = 0;
+    double windowLowestLatency = 0;
+    uint32_t samples = 0;
+};
+
+} // namespace mbgl
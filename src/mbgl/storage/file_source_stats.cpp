@@ -0,0 +1,25 @@
+#include <mbgl/storage/file_source_stats.hpp>
+
+namespace mbgl {
+
+void FileSourceStats::Counters::add(const Counters& other) {
+    requests += other.requests;
+    cacheHits += other.cacheHits;
+    cacheMisses += other.cacheMisses;
+    networkRequests += other.networkRequests;
+    sharedRequests += other.sharedRequests;
+    notModified += other.notModified;
+    bytes += other.bytes;
+    pendingTime += other.pendingTime;
+    activeTime += other.activeTime;
+}
+
+FileSourceStats::Counters FileSourceStats::total() const {
+    Counters result;
+    for (const auto& counters : kinds) {
+        result.add(counters);
+    }
+    return result;
+}
+
+} // namespace mbgl
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <mbgl/storage/file_source_stats.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <mutex>
+
+namespace mbgl {
+
+/*
+    `FileSourceStats` recorded by the threads of a file source, e.g. the one calling
+    `DefaultFileSource::request` and the file source thread, and read from any thread.
+*/
+class FileSourceStatsRecorder : private util::noncopyable {
+public:
+    // Calls `fn` with the counters of the kind, which it may update.
+    template <class Fn>
+    void record(Resource::Kind kind, Fn&& fn) {
+        std::lock_guard<std::mutex> lock(mutex);
+        fn(stats.get(kind));
+    }
+
+    FileSourceStats snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+private:
+    mutable std::mutex mutex;
+    FileSourceStats stats;
+};
+
+} // namespace mbgl
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+
+namespace mbgl {
+
+namespace util {
+template <typename T> class Thread;
+} // namespace util
+
+/*
+    Reads tiles right out of MBTiles files, which are opened read-only and memory mapped.
+    A source with the URL `mbtiles:///path/to/tiles.mbtiles` receives a TileJSON made from
+    the metadata of the file, with tile URLs that this file source answers as well. Gzipped
+    vector tiles are left as they are, and decompressed when they are parsed.
+*/
+class MBTilesFileSource : public FileSource {
+public:
+    MBTilesFileSource();
+    ~MBTilesFileSource() override;
+
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+
+    static bool acceptsURL(const std::string& url);
+
+private:
+    class Impl;
+    std::unique_ptr<util::Thread<Impl>> thread;
+};
+
+} // namespace mbgl
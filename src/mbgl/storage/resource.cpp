@@ -39,6 +39,22 @@ static std::string getTileBBox(int32_t x, int32_t y, int8_t z) {
             util::toString(max.x) + "," + util::toString(max.y));
 }
 
+Resource::Priority Resource::defaultPriority(Kind kind) {
+    switch (kind) {
+    case Kind::Style:
+    case Kind::Source:
+        return Highest;
+    case Kind::Glyphs:
+    case Kind::SpriteImage:
+    case Kind::SpriteJSON:
+        return High;
+    case Kind::Tile:
+    case Kind::Unknown:
+        break;
+    }
+    return Regular;
+}
+
 Resource Resource::style(const std::string& url) {
     return Resource {
         Resource::Kind::Style,
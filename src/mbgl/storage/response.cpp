@@ -15,6 +15,7 @@ Response& Response::operator=(const Response& res) {
     noContent = res.noContent;
     notModified = res.notModified;
     data = res.data;
+    compression = res.compression;
     modified = res.modified;
     expires = res.expires;
     etag = res.etag;
@@ -0,0 +1,319 @@
+#include <mbgl/style/binary_style.hpp>
+#include <mbgl/util/compression.hpp>
+
+#include <rapidjson/error/en.h>
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+namespace {
+
+constexpr char magic[] = { 'M', 'B', 'S', 'T' };
+constexpr uint32_t formatVersion = 1;
+constexpr std::size_t headerSize = sizeof(magic) + 8;
+
+enum class Tag : uint8_t {
+    Null,
+    False,
+    True,
+    Uint,
+    Int,
+    Double,
+    String,
+    Array,
+    Object,
+};
+
+void writeUint32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(char(value >> (8 * i)));
+    }
+}
+
+void writeVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(char(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(value));
+}
+
+class Encoder {
+public:
+    std::string strings;
+    std::string values;
+    uint32_t stringCount = 0;
+
+    void encode(const JSValue& value) {
+        if (value.IsNull()) {
+            values.push_back(char(Tag::Null));
+        } else if (value.IsFalse()) {
+            values.push_back(char(Tag::False));
+        } else if (value.IsTrue()) {
+            values.push_back(char(Tag::True));
+        } else if (value.IsDouble()) {
+            const double number = value.GetDouble();
+            uint64_t bits;
+            std::memcpy(&bits, &number, sizeof(bits));
+            values.push_back(char(Tag::Double));
+            writeUint32(values, uint32_t(bits));
+            writeUint32(values, uint32_t(bits >> 32));
+        } else if (value.IsUint64()) {
+            values.push_back(char(Tag::Uint));
+            writeVarint(values, value.GetUint64());
+        } else if (value.IsInt64()) {
+            const int64_t number = value.GetInt64();
+            values.push_back(char(Tag::Int));
+            writeVarint(values, (uint64_t(number) << 1) ^ uint64_t(number >> 63));
+        } else if (value.IsString()) {
+            values.push_back(char(Tag::String));
+            writeVarint(values, stringIndex(value));
+        } else if (value.IsArray()) {
+            values.push_back(char(Tag::Array));
+            writeVarint(values, value.Size());
+            for (const auto& element : value.GetArray()) {
+                encode(element);
+            }
+        } else {
+            values.push_back(char(Tag::Object));
+            writeVarint(values, value.MemberCount());
+            for (const auto& member : value.GetObject()) {
+                writeVarint(values, stringIndex(member.name));
+                encode(member.value);
+            }
+        }
+    }
+
+private:
+    uint32_t stringIndex(const JSValue& value) {
+        std::string key { value.GetString(), value.GetStringLength() };
+        auto it = indices.find(key);
+        if (it == indices.end()) {
+            // Terminated, for values that are read as C strings.
+            writeVarint(strings, key.size());
+            strings.append(key);
+            strings.push_back('\0');
+            it = indices.emplace(std::move(key), stringCount++).first;
+        }
+        return it->second;
+    }
+
+    std::unordered_map<std::string, uint32_t> indices;
+};
+
+class Decoder {
+public:
+    Decoder(const char* begin_, const char* end_, JSDocument::AllocatorType& allocator_)
+        : data(begin_), end(end_), allocator(allocator_) {
+    }
+
+    void decodeStrings() {
+        const uint64_t count = readVarint();
+        // Each string takes at least two bytes.
+        if (count > uint64_t(end - data) / 2) {
+            malformed();
+        }
+        strings.reserve(count);
+        for (uint64_t i = 0; i < count; i++) {
+            const uint64_t length = readVarint();
+            if (length >= uint64_t(end - data) || data[length] != '\0') {
+                malformed();
+            }
+            strings.push_back(rapidjson::StringRef(data, rapidjson::SizeType(length)));
+            data += length + 1;
+        }
+    }
+
+    void decode(JSValue& value) {
+        switch (Tag(readByte())) {
+        case Tag::Null:
+            value.SetNull();
+            break;
+        case Tag::False:
+            value.SetBool(false);
+            break;
+        case Tag::True:
+            value.SetBool(true);
+            break;
+        case Tag::Uint:
+            value.SetUint64(readVarint());
+            break;
+        case Tag::Int: {
+            const uint64_t zigzag = readVarint();
+            value.SetInt64(int64_t(zigzag >> 1) ^ -int64_t(zigzag & 1));
+            break;
+        }
+        case Tag::Double: {
+            if (end - data < 8) {
+                malformed();
+            }
+            uint64_t bits = 0;
+            for (int i = 0; i < 8; i++) {
+                bits |= uint64_t(uint8_t(data[i])) << (8 * i);
+            }
+            data += 8;
+            double number;
+            std::memcpy(&number, &bits, sizeof(number));
+            value.SetDouble(number);
+            break;
+        }
+        case Tag::String:
+            value.SetString(readString());
+            break;
+        case Tag::Array: {
+            const uint64_t size = readCount();
+            value.SetArray();
+            value.Reserve(rapidjson::SizeType(size), allocator);
+            for (uint64_t i = 0; i < size; i++) {
+                JSValue element;
+                decode(element);
+                value.PushBack(element, allocator);
+            }
+            break;
+        }
+        case Tag::Object: {
+            const uint64_t size = readCount();
+            value.SetObject();
+            for (uint64_t i = 0; i < size; i++) {
+                JSValue name { readString() };
+                JSValue member;
+                decode(member);
+                value.AddMember(name, member, allocator);
+            }
+            break;
+        }
+        default:
+            malformed();
+        }
+    }
+
+    bool done() const {
+        return data == end;
+    }
+
+private:
+    [[noreturn]] static void malformed() {
+        throw std::runtime_error("malformed binary style");
+    }
+
+    uint8_t readByte() {
+        if (data == end) {
+            malformed();
+        }
+        return uint8_t(*data++);
+    }
+
+    uint64_t readVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const uint8_t byte = readByte();
+            value |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        malformed();
+    }
+
+    // Of values, each taking at least a byte.
+    uint64_t readCount() {
+        const uint64_t count = readVarint();
+        if (count > uint64_t(end - data)) {
+            malformed();
+        }
+        return count;
+    }
+
+    rapidjson::GenericStringRef<char> readString() {
+        const uint64_t index = readVarint();
+        if (index >= strings.size()) {
+            malformed();
+        }
+        return strings[index];
+    }
+
+    const char* data;
+    const char* const end;
+    JSDocument::AllocatorType& allocator;
+    std::vector<rapidjson::GenericStringRef<char>> strings;
+};
+
+uint32_t readUint32(const char* data) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= uint32_t(uint8_t(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+bool isBinaryStyle(const std::string& data) {
+    return data.size() >= headerSize && std::memcmp(data.data(), magic, sizeof(magic)) == 0;
+}
+
+std::string encodeBinaryStyle(const std::string& json) {
+    JSDocument document;
+    document.Parse<0>(json.c_str());
+
+    if (document.HasParseError()) {
+        std::stringstream message;
+        message << document.GetErrorOffset() << " - "
+            << rapidjson::GetParseError_En(document.GetParseError());
+        throw std::runtime_error(message.str());
+    }
+
+    Encoder encoder;
+    encoder.encode(document);
+
+    std::string result { magic, sizeof(magic) };
+    writeUint32(result, formatVersion);
+
+    std::string body;
+    writeVarint(body, encoder.stringCount);
+    body.append(encoder.strings);
+    body.append(encoder.values);
+
+    writeUint32(result, uint32_t(body.size()));
+    result.append(body);
+    result.append(util::compress(json));
+    return result;
+}
+
+optional<std::string> decodeBinaryStyle(const std::string& data, JSDocument& document) {
+    if (!isBinaryStyle(data)) {
+        throw std::runtime_error("not a binary style");
+    }
+
+    const uint32_t version = readUint32(data.data() + sizeof(magic));
+    const uint32_t length = readUint32(data.data() + sizeof(magic) + 4);
+    if (length > data.size() - headerSize) {
+        throw std::runtime_error("malformed binary style");
+    }
+
+    if (version != formatVersion) {
+        return util::decompress(data.substr(headerSize + length));
+    }
+
+    JSDocument decoded;
+    const char* begin = data.data() + headerSize;
+    Decoder decoder { begin, begin + length, decoded.GetAllocator() };
+    decoder.decodeStrings();
+    decoder.decode(decoded);
+    if (!decoder.done()) {
+        throw std::runtime_error("malformed binary style");
+    }
+
+    document.Swap(decoded);
+    return {};
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <mbgl/util/optional.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+#include <string>
+
+namespace mbgl {
+namespace style {
+
+/*
+    A style JSON document, encoded ahead of time so that loading it doesn't parse any text:
+    strings are stored once, and numbers in binary. The parser converts the decoded document
+    like a parsed one.
+
+    Every encoding also keeps the compressed JSON, which is parsed instead when the document
+    was encoded in another format version. The magic, the version and the length of the
+    document, at the start, are the same in all versions.
+*/
+
+bool isBinaryStyle(const std::string& data);
+
+// Throws std::runtime_error if the JSON doesn't parse.
+std::string encodeBinaryStyle(const std::string& json);
+
+// Decodes into `document`, which points to the strings of `data` and must not outlive it.
+// Returns the JSON of a style in another format version instead, leaving `document` as it
+// is; throws std::runtime_error if the data is malformed.
+optional<std::string> decodeBinaryStyle(const std::string& data, JSDocument& document);
+
+} // namespace style
+} // namespace mbgl
@@ -3,13 +3,28 @@
 #include <mbgl/map/mode.hpp>
 #include <mbgl/tile/tile_id.hpp>
 
+#include <atomic>
+
 namespace mbgl {
+
+class FillTriangulationCache;
+
 namespace style {
 
 class BucketParameters {
 public:
     const OverscaledTileID tileID;
     const MapMode mode;
+
+    // Set on the main thread once the tile being laid out is no longer needed. Per-feature
+    // loops check it so that they can abandon work early.
+    const std::atomic<bool>& obsolete;
+
+    // Kept by the tile's worker across layouts of the same data, if set.
+    FillTriangulationCache* triangulations = nullptr;
+
+    // Device pixels per pixel of the map.
+    float pixelRatio = 1;
 };
 
 } // namespace style
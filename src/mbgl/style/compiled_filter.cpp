@@ -0,0 +1,321 @@
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/filter_evaluator.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace mbgl {
+namespace style {
+
+constexpr std::size_t CompiledFilter::cachedKeys;
+
+class CompiledFilter::Compiler {
+public:
+    CompiledFilter& result;
+
+    void compile(const Filter& filter) {
+        Filter::visit(filter, *this);
+    }
+
+    void operator()(const NullFilter&) {
+        // An `all` without operands is true.
+        emit(Op::All);
+    }
+
+    void operator()(const EqualsFilter& filter) {
+        comparison(Op::Equals, filter.key, filter.value);
+    }
+
+    void operator()(const NotEqualsFilter& filter) {
+        comparison(Op::NotEquals, filter.key, filter.value);
+    }
+
+    void operator()(const LessThanFilter& filter) {
+        comparison(Op::Less, filter.key, filter.value);
+    }
+
+    void operator()(const LessThanEqualsFilter& filter) {
+        comparison(Op::LessEquals, filter.key, filter.value);
+    }
+
+    void operator()(const GreaterThanFilter& filter) {
+        comparison(Op::Greater, filter.key, filter.value);
+    }
+
+    void operator()(const GreaterThanEqualsFilter& filter) {
+        comparison(Op::GreaterEquals, filter.key, filter.value);
+    }
+
+    void operator()(const InFilter& filter) {
+        membership(Op::In, filter.key, filter.values);
+    }
+
+    void operator()(const NotInFilter& filter) {
+        membership(Op::NotIn, filter.key, filter.values);
+    }
+
+    void operator()(const AnyFilter& filter) {
+        logical(Op::Any, filter.filters);
+    }
+
+    void operator()(const AllFilter& filter) {
+        logical(Op::All, filter.filters);
+    }
+
+    void operator()(const NoneFilter& filter) {
+        logical(Op::None, filter.filters);
+    }
+
+    void operator()(const HasFilter& filter) {
+        emit(Op::Has).key = key(filter.key);
+    }
+
+    void operator()(const NotHasFilter& filter) {
+        emit(Op::NotHas).key = key(filter.key);
+    }
+
+    void operator()(const TypeEqualsFilter& filter) {
+        emit(Op::TypeIn).typeMask = typeBit(filter.value);
+    }
+
+    void operator()(const TypeNotEqualsFilter& filter) {
+        emit(Op::TypeIn).typeMask = allTypes & ~typeBit(filter.value);
+    }
+
+    void operator()(const TypeInFilter& filter) {
+        emit(Op::TypeIn).typeMask = typeMask(filter.values);
+    }
+
+    void operator()(const TypeNotInFilter& filter) {
+        emit(Op::TypeIn).typeMask = allTypes & ~typeMask(filter.values);
+    }
+
+    void operator()(const IdentifierEqualsFilter& filter) {
+        emit(Op::IdEquals).operand = identifiers({ filter.value });
+    }
+
+    void operator()(const IdentifierNotEqualsFilter& filter) {
+        emit(Op::IdNotEquals).operand = identifiers({ filter.value });
+    }
+
+    void operator()(const IdentifierInFilter& filter) {
+        Instruction& instruction = emit(Op::IdIn);
+        instruction.operand = identifiers(filter.values);
+        instruction.key = filter.values.size();
+    }
+
+    void operator()(const IdentifierNotInFilter& filter) {
+        Instruction& instruction = emit(Op::IdNotIn);
+        instruction.operand = identifiers(filter.values);
+        instruction.key = filter.values.size();
+    }
+
+    void operator()(const HasIdentifierFilter&) {
+        emit(Op::HasId);
+    }
+
+    void operator()(const NotHasIdentifierFilter&) {
+        emit(Op::NotHasId);
+    }
+
+private:
+    static constexpr uint8_t allTypes = 0xF;
+
+    static uint8_t typeBit(FeatureType type) {
+        return 1u << static_cast<uint8_t>(type);
+    }
+
+    static uint8_t typeMask(const std::vector<FeatureType>& types) {
+        uint8_t mask = 0;
+        for (const auto& type : types) {
+            mask |= typeBit(type);
+        }
+        return mask;
+    }
+
+    // Whether evaluating `filter` may look up a property.
+    static bool readsProperties(const Filter& filter) {
+        return filter.match(
+            [] (const NullFilter&) { return false; },
+            [] (const TypeEqualsFilter&) { return false; },
+            [] (const TypeNotEqualsFilter&) { return false; },
+            [] (const TypeInFilter&) { return false; },
+            [] (const TypeNotInFilter&) { return false; },
+            [] (const IdentifierEqualsFilter&) { return false; },
+            [] (const IdentifierNotEqualsFilter&) { return false; },
+            [] (const IdentifierInFilter&) { return false; },
+            [] (const IdentifierNotInFilter&) { return false; },
+            [] (const HasIdentifierFilter&) { return false; },
+            [] (const NotHasIdentifierFilter&) { return false; },
+            [] (const AnyFilter& f) { return std::any_of(f.filters.begin(), f.filters.end(), readsProperties); },
+            [] (const AllFilter& f) { return std::any_of(f.filters.begin(), f.filters.end(), readsProperties); },
+            [] (const NoneFilter& f) { return std::any_of(f.filters.begin(), f.filters.end(), readsProperties); },
+            [] (const auto&) { return true; }
+        );
+    }
+
+    Instruction& emit(Op op) {
+        const uint32_t index = result.instructions.size();
+        result.instructions.push_back({ op, 0, 0, 0, index + 1 });
+        return result.instructions.back();
+    }
+
+    uint32_t key(const std::string& name) {
+        auto it = std::find(result.keys.begin(), result.keys.end(), name);
+        if (it != result.keys.end()) {
+            return it - result.keys.begin();
+        }
+        result.keys.push_back(name);
+        return result.keys.size() - 1;
+    }
+
+    uint32_t identifiers(const std::vector<FeatureIdentifier>& ids) {
+        const uint32_t index = result.identifiers.size();
+        result.identifiers.insert(result.identifiers.end(), ids.begin(), ids.end());
+        return index;
+    }
+
+    void comparison(Op op, const std::string& name, const Value& value) {
+        Instruction& instruction = emit(op);
+        instruction.key = key(name);
+        instruction.operand = result.values.size();
+        result.values.push_back(value);
+    }
+
+    void membership(Op op, const std::string& name, const std::vector<Value>& values) {
+        ValueSet set;
+        std::vector<std::pair<double, Value>> numbers;
+
+        for (const auto& value : values) {
+            if (value.is<std::string>()) {
+                set.strings.push_back(value.get<std::string>());
+            } else if (value.is<bool>()) {
+                (value.get<bool>() ? set.hasTrue : set.hasFalse) = true;
+            } else if (value.is<uint64_t>()) {
+                numbers.emplace_back(double(value.get<uint64_t>()), value);
+            } else if (value.is<int64_t>()) {
+                numbers.emplace_back(double(value.get<int64_t>()), value);
+            } else if (value.is<double>()) {
+                numbers.emplace_back(value.get<double>(), value);
+            } else {
+                set.others.push_back(value);
+            }
+        }
+
+        std::sort(set.strings.begin(), set.strings.end());
+        set.strings.erase(std::unique(set.strings.begin(), set.strings.end()), set.strings.end());
+
+        std::stable_sort(numbers.begin(), numbers.end(), [] (const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first;
+        });
+        for (auto& number : numbers) {
+            set.numbers.push_back(number.first);
+            set.numberValues.push_back(std::move(number.second));
+        }
+
+        Instruction& instruction = emit(op);
+        instruction.key = key(name);
+        instruction.operand = result.sets.size();
+        result.sets.push_back(std::move(set));
+    }
+
+    void logical(Op op, const std::vector<Filter>& filters) {
+        const uint32_t index = result.instructions.size();
+        emit(op).operand = filters.size();
+
+        // Evaluation order does not change the result, so test the feature type and
+        // identifier first; they are known without a property lookup.
+        std::vector<const Filter*> operands;
+        operands.reserve(filters.size());
+        for (const auto& filter : filters) {
+            operands.push_back(&filter);
+        }
+        std::stable_partition(operands.begin(), operands.end(), [] (const Filter* filter) {
+            return !readsProperties(*filter);
+        });
+
+        for (const Filter* filter : operands) {
+            compile(*filter);
+        }
+
+        // `emit` may have reallocated; don't hold on to the instruction.
+        result.instructions[index].end = result.instructions.size();
+    }
+};
+
+constexpr uint8_t CompiledFilter::Compiler::allTypes;
+
+CompiledFilter::CompiledFilter() = default;
+
+CompiledFilter::CompiledFilter(const Filter& filter) {
+    if (filter.is<NullFilter>()) {
+        return;
+    }
+
+    Compiler { *this }.compile(filter);
+}
+
+bool CompiledFilter::compare(Op op, const Value& actual, const Value& expected) {
+    switch (op) {
+    case Op::Equals:
+    case Op::NotEquals:
+        return filterEqual(actual, expected);
+    case Op::Less:
+        return filterCompare(actual, expected, [] (const auto& lhs, const auto& rhs) { return lhs < rhs; });
+    case Op::LessEquals:
+        return filterCompare(actual, expected, [] (const auto& lhs, const auto& rhs) { return lhs <= rhs; });
+    case Op::Greater:
+        return filterCompare(actual, expected, [] (const auto& lhs, const auto& rhs) { return lhs > rhs; });
+    case Op::GreaterEquals:
+        return filterCompare(actual, expected, [] (const auto& lhs, const auto& rhs) { return lhs >= rhs; });
+    default:
+        assert(false);
+        return false;
+    }
+}
+
+bool CompiledFilter::containsIdentifier(const Instruction& instruction, const optional<FeatureIdentifier>& id) const {
+    const auto begin = identifiers.begin() + instruction.operand;
+    return std::any_of(begin, begin + instruction.key, [&] (const FeatureIdentifier& value) {
+        return id == value;
+    });
+}
+
+bool CompiledFilter::ValueSet::contains(const Value& actual) const {
+    if (actual.is<std::string>()) {
+        return std::binary_search(strings.begin(), strings.end(), actual.get<std::string>());
+    }
+
+    if (actual.is<bool>()) {
+        return actual.get<bool>() ? hasTrue : hasFalse;
+    }
+
+    optional<double> number;
+    if (actual.is<uint64_t>()) {
+        number = double(actual.get<uint64_t>());
+    } else if (actual.is<int64_t>()) {
+        number = double(actual.get<int64_t>());
+    } else if (actual.is<double>()) {
+        number = actual.get<double>();
+    }
+
+    if (number) {
+        // Numbers of the same type compare exactly, so confirm every candidate that is
+        // equal as a double.
+        auto range = std::equal_range(numbers.begin(), numbers.end(), *number);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (filterEqual(actual, numberValues[it - numbers.begin()])) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    return std::any_of(others.begin(), others.end(), [&] (const Value& value) {
+        return filterEqual(actual, value);
+    });
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <mbgl/style/filter.hpp>
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/geometry.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+/*
+   A `Filter` flattened into a list of instructions, for evaluating the same filter
+   against every feature of a source layer.
+
+   Compared to walking the `Filter` variant tree with `FilterEvaluator`:
+
+   * Every distinct property key is looked up at most once per feature, however many
+     times the filter refers to it.
+   * `in` and `!in` values are partitioned by type and sorted, so that string and
+     number membership tests are binary searches.
+   * `$type` and `$id` tests do not read properties; within `all`, `any` and `none`
+     they are evaluated before the tests that do, and `$type` tests are reduced to a
+     bit mask.
+   * Logical operators skip the instructions of their remaining operands once their
+     result is known.
+
+   Results are identical to `Filter::operator()`.
+*/
+class CompiledFilter {
+public:
+    // Matches every feature, like `NullFilter`.
+    CompiledFilter();
+    explicit CompiledFilter(const Filter&);
+
+    template <class GeometryTileFeature>
+    bool operator()(const GeometryTileFeature& feature) const {
+        return operator()(feature.getType(), feature.getID(), [&] (const auto& key) { return feature.getValue(key); });
+    }
+
+    template <class PropertyAccessor>
+    bool operator()(FeatureType type, const optional<FeatureIdentifier>& id, const PropertyAccessor& accessor) const {
+        if (instructions.empty()) {
+            return true;
+        }
+
+        Context<PropertyAccessor> context { type, id, accessor, {}, 0 };
+        std::size_t pc = 0;
+        return evaluate(context, pc);
+    }
+
+private:
+    enum class Op : uint8_t {
+        // Property tests; `key` is an index into `keys`.
+        Equals,
+        NotEquals,
+        Less,
+        LessEquals,
+        Greater,
+        GreaterEquals,
+        In,
+        NotIn,
+        Has,
+        NotHas,
+
+        // Feature type and identifier tests.
+        TypeIn,
+        IdEquals,
+        IdNotEquals,
+        IdIn,
+        IdNotIn,
+        HasId,
+        NotHasId,
+
+        // Logical operators; their operands are the following instructions.
+        Any,
+        All,
+        None,
+    };
+
+    struct Instruction {
+        Op op;
+
+        // One bit per `FeatureType`, for `TypeIn`.
+        uint8_t typeMask;
+
+        // Index into `keys`, for property tests.
+        uint32_t key;
+
+        // Index into `values`, `sets` or `identifiers`, or the operand count of a logical
+        // operator.
+        uint32_t operand;
+
+        // The index of the first instruction after this one's operands.
+        uint32_t end;
+    };
+
+    struct ValueSet {
+        // Sorted, for binary search.
+        std::vector<std::string> strings;
+
+        // Sorted by their value as a double; `numbers[i]` is `numberValues[i]` as a double.
+        std::vector<double> numbers;
+        std::vector<Value> numberValues;
+
+        bool hasTrue = false;
+        bool hasFalse = false;
+
+        // Values of any other type, compared with `filterEqual`.
+        std::vector<Value> others;
+
+        bool contains(const Value&) const;
+    };
+
+    // Keys beyond this many are looked up each time they are tested.
+    static constexpr std::size_t cachedKeys = 8;
+
+    template <class PropertyAccessor>
+    struct Context {
+        const FeatureType type;
+        const optional<FeatureIdentifier>& id;
+        const PropertyAccessor& accessor;
+
+        std::array<optional<Value>, cachedKeys> values;
+        uint32_t fetched;
+    };
+
+    template <class PropertyAccessor>
+    const optional<Value>& lookup(Context<PropertyAccessor>& context, uint32_t key, optional<Value>& uncached) const {
+        if (key >= cachedKeys) {
+            uncached = context.accessor(keys[key]);
+            return uncached;
+        }
+
+        const uint32_t bit = 1u << key;
+        if (!(context.fetched & bit)) {
+            context.values[key] = context.accessor(keys[key]);
+            context.fetched |= bit;
+        }
+        return context.values[key];
+    }
+
+    template <class PropertyAccessor>
+    bool evaluate(Context<PropertyAccessor>& context, std::size_t& pc) const {
+        const Instruction& instruction = instructions[pc++];
+
+        switch (instruction.op) {
+        case Op::Any:
+        case Op::All:
+        case Op::None: {
+            // `Any` stops at the first match, `All` and `None` at the first mismatch.
+            const bool stopOn = instruction.op != Op::All;
+            for (uint32_t i = 0; i < instruction.operand; ++i) {
+                if (evaluate(context, pc) == stopOn) {
+                    pc = instruction.end;
+                    return instruction.op == Op::Any;
+                }
+            }
+            return instruction.op != Op::Any;
+        }
+
+        case Op::TypeIn:
+            return instruction.typeMask & (1u << static_cast<uint8_t>(context.type));
+        case Op::IdEquals:
+            return context.id == identifiers[instruction.operand];
+        case Op::IdNotEquals:
+            return context.id != identifiers[instruction.operand];
+        case Op::IdIn:
+            return containsIdentifier(instruction, context.id);
+        case Op::IdNotIn:
+            return !containsIdentifier(instruction, context.id);
+        case Op::HasId:
+            return bool(context.id);
+        case Op::NotHasId:
+            return !context.id;
+
+        default:
+            break;
+        }
+
+        optional<Value> uncached;
+        const optional<Value>& actual = lookup(context, instruction.key, uncached);
+
+        switch (instruction.op) {
+        case Op::Has:
+            return bool(actual);
+        case Op::NotHas:
+            return !actual;
+        case Op::In:
+            return actual && sets[instruction.operand].contains(*actual);
+        case Op::NotIn:
+            return !actual || !sets[instruction.operand].contains(*actual);
+        case Op::NotEquals:
+            return !actual || !compare(instruction.op, *actual, values[instruction.operand]);
+        default:
+            return actual && compare(instruction.op, *actual, values[instruction.operand]);
+        }
+    }
+
+    static bool compare(Op, const Value& actual, const Value& expected);
+    bool containsIdentifier(const Instruction&, const optional<FeatureIdentifier>&) const;
+
+    class Compiler;
+
+    std::vector<Instruction> instructions;
+    std::vector<std::string> keys;
+    std::vector<Value> values;
+    std::vector<ValueSet> sets;
+
+    // For `IdIn` and `IdNotIn`, `operand` is the index of the first identifier and `key`
+    // is their count.
+    std::vector<FeatureIdentifier> identifiers;
+};
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,156 @@
+#include <mbgl/style/conversion/geojson_reader.hpp>
+#include <mbgl/style/conversion/geojson.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+#include <mapbox/geojson/rapidjson.hpp>
+
+#include <rapidjson/reader.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+namespace conversion {
+
+namespace {
+
+class GeoJSONHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, GeoJSONHandler> {
+public:
+    bool Null() { return add(JSValue()); }
+    bool Bool(bool b) { return add(JSValue(b)); }
+    bool Int(int i) { return add(JSValue(i)); }
+    bool Uint(unsigned u) { return add(JSValue(u)); }
+    bool Int64(int64_t i) { return add(JSValue(i)); }
+    bool Uint64(uint64_t u) { return add(JSValue(u)); }
+    bool Double(double d) { return add(JSValue(d)); }
+
+    bool String(const char* str, rapidjson::SizeType length, bool) {
+        return add(JSValue(str, length, allocator));
+    }
+
+    bool StartObject() {
+        stack.emplace_back(rapidjson::kObjectType);
+        return true;
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool) {
+        keys.emplace_back(str, length, allocator);
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType) {
+        return end();
+    }
+
+    bool StartArray() {
+        // The top-level `features` array is never built; its members are converted one by
+        // one instead.
+        if (stack.size() == 1 && !keys.empty() && keys.back() == "features") {
+            keys.pop_back();
+            streamingFeatures = true;
+            sawFeatures = true;
+            return true;
+        }
+
+        stack.emplace_back(rapidjson::kArrayType);
+        return true;
+    }
+
+    bool EndArray(rapidjson::SizeType) {
+        if (streamingFeatures && stack.size() == 1) {
+            streamingFeatures = false;
+            return true;
+        }
+
+        return end();
+    }
+
+    Result<GeoJSON> result() {
+        const bool isCollection = root.IsObject()
+            && root.HasMember("type")
+            && root["type"] == "FeatureCollection";
+
+        if (isCollection && sawFeatures) {
+            if (featureError) {
+                return Error { *featureError };
+            }
+            return GeoJSON { std::move(features) };
+        }
+
+        // Anything but a FeatureCollection is small enough to be converted as a whole.
+        // Members of a `features` array elsewhere were converted in vain, but GeoJSON has
+        // no other use for them.
+        return convertGeoJSON<JSValue>(root);
+    }
+
+private:
+    bool add(JSValue&& value) {
+        if (stack.empty()) {
+            root = std::move(value);
+        } else if (streamingFeatures && stack.size() == 1) {
+            addFeature(value);
+        } else if (stack.back().IsObject()) {
+            stack.back().AddMember(keys.back(), value, allocator);
+            keys.pop_back();
+        } else {
+            stack.back().PushBack(value, allocator);
+        }
+        return true;
+    }
+
+    bool end() {
+        JSValue value = std::move(stack.back());
+        stack.pop_back();
+        return add(std::move(value));
+    }
+
+    void addFeature(const JSValue& value) {
+        // After an invalid feature, the rest are still read, in case this isn't a
+        // FeatureCollection after all.
+        if (featureError) {
+            return;
+        }
+
+        try {
+            features.push_back(mapbox::geojson::convert<mapbox::geojson::feature>(value));
+        } catch (const std::exception& ex) {
+            featureError = std::string(ex.what());
+        }
+    }
+
+    rapidjson::CrtAllocator allocator;
+
+    // The values still being read, innermost last, and the pending key of each object.
+    std::vector<JSValue> stack;
+    std::vector<JSValue> keys;
+    JSValue root;
+
+    bool streamingFeatures = false;
+    bool sawFeatures = false;
+    mapbox::geojson::feature_collection features;
+    optional<std::string> featureError;
+};
+
+} // namespace
+
+Result<GeoJSON> parseGeoJSON(const std::string& json) {
+    GeoJSONHandler handler;
+    rapidjson::Reader reader;
+    rapidjson::StringStream stream(json.c_str());
+
+    rapidjson::ParseResult parsed = reader.Parse<0>(stream, handler);
+    if (parsed.IsError()) {
+        std::stringstream message;
+        message << parsed.Offset() << " - " << rapidjson::GetParseError_En(parsed.Code());
+        throw std::runtime_error(message.str());
+    }
+
+    return handler.result();
+}
+
+} // namespace conversion
+} // namespace style
+} // namespace mbgl
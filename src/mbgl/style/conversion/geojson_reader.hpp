@@ -0,0 +1,26 @@
+#pragma once
+
+#include <mbgl/style/conversion.hpp>
+#include <mbgl/util/geojson.hpp>
+
+#include <string>
+
+namespace mbgl {
+namespace style {
+namespace conversion {
+
+/*
+   Parses GeoJSON text with the same result as parsing it into a JSON document and
+   converting that with `convertGeoJSON`, but without the document: the reader hands
+   its events to a handler that converts each member of a FeatureCollection's `features`
+   as soon as it is complete, and drops its JSON values. Only the rest of the top-level
+   object, and one feature at a time, are ever held as JSON values.
+
+   Throws `std::runtime_error` if the text isn't well-formed JSON, and returns an `Error`
+   if it isn't valid GeoJSON.
+*/
+Result<GeoJSON> parseGeoJSON(const std::string&);
+
+} // namespace conversion
+} // namespace style
+} // namespace mbgl
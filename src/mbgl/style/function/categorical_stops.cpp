@@ -7,25 +7,32 @@
 namespace mbgl {
 namespace style {
 
-optional<CategoricalValue> categoricalValue(const Value& value) {
-    return value.match(
-        [] (bool t) { return optional<CategoricalValue>(t); },
-        [] (uint64_t t) { return optional<CategoricalValue>(int64_t(t)); },
-        [] (int64_t t) { return optional<CategoricalValue>(t); },
-        [] (double t) { return optional<CategoricalValue>(int64_t(t)); },
-        [] (const std::string& t) { return optional<CategoricalValue>(t); },
-        [] (const auto&) { return optional<CategoricalValue>(); }
-    );
+template <class T>
+void CategoricalStops<T>::index() {
+    for (const auto& stop : stops) {
+        stop.first.match(
+            [&] (bool key) { (key ? trueValue : falseValue) = stop.second; },
+            [&] (int64_t key) { integers.emplace(key, stop.second); },
+            [&] (const std::string& key) { strings.emplace(key, stop.second); }
+        );
+    }
 }
 
 template <class T>
 optional<T> CategoricalStops<T>::evaluate(const Value& value) const {
-    auto v = categoricalValue(value);
-    if (!v) {
-        return {};
-    }
-    auto it = stops.find(*v);
-    return it == stops.end() ? optional<T>() : it->second;
+    auto find = [] (const auto& map, const auto& key) {
+        auto it = map.find(key);
+        return it == map.end() ? optional<T>() : it->second;
+    };
+
+    return value.match(
+        [&] (bool t) { return t ? trueValue : falseValue; },
+        [&] (uint64_t t) { return find(integers, int64_t(t)); },
+        [&] (int64_t t) { return find(integers, t); },
+        [&] (double t) { return find(integers, int64_t(t)); },
+        [&] (const std::string& t) { return find(strings, t); },
+        [&] (const auto&) { return optional<T>(); }
+    );
 }
 
 template class CategoricalStops<float>;
@@ -7,12 +7,15 @@
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
 
+#include <functional>
 #include <unordered_map>
 
 namespace mbgl {
 namespace style {
 
-std::string layoutKey(const Layer& layer) {
+namespace {
+
+std::string serializeLayout(const Layer& layer) {
     using namespace conversion;
 
     rapidjson::StringBuffer s;
@@ -32,10 +35,34 @@ std::string layoutKey(const Layer& layer) {
     return s.GetString();
 }
 
+struct LayoutKeyHash {
+    std::size_t operator()(const LayoutKey* key) const {
+        return key->hash;
+    }
+};
+
+struct LayoutKeyEqual {
+    bool operator()(const LayoutKey* lhs, const LayoutKey* rhs) const {
+        return *lhs == *rhs;
+    }
+};
+
+} // namespace
+
+const LayoutKey& layoutKey(const Layer& layer) {
+    optional<LayoutKey>& key = layer.baseImpl->layoutKey;
+    if (!key || key->revision != layer.baseImpl->revision) {
+        std::string serialized = serializeLayout(layer);
+        const std::size_t hash = std::hash<std::string>()(serialized);
+        key = LayoutKey { std::move(serialized), hash, layer.baseImpl->revision };
+    }
+    return *key;
+}
+
 std::vector<std::vector<const Layer*>> groupByLayout(const std::vector<std::unique_ptr<Layer>>& layers) {
-    std::unordered_map<std::string, std::vector<const Layer*>> map;
+    std::unordered_map<const LayoutKey*, std::vector<const Layer*>, LayoutKeyHash, LayoutKeyEqual> map;
     for (auto& layer : layers) {
-        map[layoutKey(*layer)].push_back(layer.get());
+        map[&layoutKey(*layer)].push_back(layer.get());
     }
 
     std::vector<std::vector<const Layer*>> result;
@@ -1,13 +1,33 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <string>
 
 namespace mbgl {
 namespace style {
 
 class Layer;
 
+class LayoutKey {
+public:
+    std::string key;
+    std::size_t hash;
+
+    // The revision of the layer the key was made for.
+    uint64_t revision;
+
+    bool operator==(const LayoutKey& rhs) const {
+        return hash == rhs.hash && key == rhs.key;
+    }
+};
+
+// Layers with equal keys can share a bucket. A key is made once per revision of a layer, and
+// kept by its clones, so that tile workers don't serialize the layers they lay out.
+const LayoutKey& layoutKey(const Layer&);
+
 std::vector<std::vector<const Layer*>> groupByLayout(const std::vector<std::unique_ptr<Layer>>&);
 
 } // namespace style
@@ -31,6 +31,7 @@ float Layer::getMinZoom() const {
 
 void Layer::setMinZoom(float minZoom) const {
     baseImpl->minZoom = minZoom;
+    baseImpl->bumpRevision();
 }
 
 float Layer::getMaxZoom() const {
@@ -39,6 +40,7 @@ float Layer::getMaxZoom() const {
 
 void Layer::setMaxZoom(float maxZoom) const {
     baseImpl->maxZoom = maxZoom;
+    baseImpl->bumpRevision();
 }
 
 } // namespace style
@@ -1,16 +1,59 @@
 #include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/property_evaluation_parameters.hpp>
+
+#include <atomic>
 
 namespace mbgl {
 namespace style {
 
+namespace {
+
+std::atomic<uint64_t> nextRevision { 0 };
+
+} // namespace
+
+Layer::Impl::Impl()
+    : revision(++nextRevision) {
+}
+
 std::unique_ptr<Layer> Layer::Impl::copy(const std::string& id_,
                                          const std::string& source_) const {
     std::unique_ptr<Layer> result = clone();
     result->baseImpl->id = id_;
     result->baseImpl->source = source_;
+    result->baseImpl->bumpRevision();
     return result;
 }
 
+void Layer::Impl::bumpRevision() {
+    revision = ++nextRevision;
+    rendersNothing = false;
+}
+
+bool Layer::Impl::reevaluate(const PropertyEvaluationParameters& parameters) {
+    if (stableEvaluation && stableEvaluation->zoom == parameters.z && stableEvaluation->revision == revision) {
+        return false;
+    }
+
+    const bool hasTransitions = evaluate(parameters);
+    evaluation = ++nextRevision;
+
+    // Cross-faded properties depend on the time since the last integer zoom was crossed,
+    // until the fade is over.
+    const bool fading = parameters.now - parameters.zoomHistory.lastIntegerZoomTime < parameters.defaultFadeDuration;
+    if (!hasTransitions && !fading) {
+        stableEvaluation = Evaluation { parameters.z, revision };
+    } else {
+        stableEvaluation = {};
+    }
+
+    return hasTransitions;
+}
+
+void Layer::Impl::invalidateEvaluation() {
+    stableEvaluation = {};
+}
+
 bool Layer::Impl::hasRenderPass(RenderPass pass) const {
     return bool(passes & pass);
 }
@@ -18,6 +61,7 @@ bool Layer::Impl::hasRenderPass(RenderPass pass) const {
 bool Layer::Impl::needsRendering(float zoom) const {
     return passes != RenderPass::None
         && visibility != VisibilityType::None
+        && !rendersNothing
         && minZoom <= zoom
         && maxZoom >= zoom;
 }
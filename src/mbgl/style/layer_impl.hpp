@@ -3,14 +3,17 @@
 #include <mbgl/style/layer.hpp>
 #include <mbgl/style/types.hpp>
 #include <mbgl/style/filter.hpp>
+#include <mbgl/style/group_by_layout.hpp>
 #include <mbgl/style/layer_observer.hpp>
 #include <mbgl/renderer/render_pass.hpp>
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <limits>
@@ -61,6 +64,13 @@ public:
     // Returns true if any paint properties have active transitions.
     virtual bool evaluate(const PropertyEvaluationParameters&) = 0;
 
+    // Evaluates like `evaluate`, unless the properties would come out as they are: at the zoom
+    // and revision of the last evaluation, when no transitions or cross-fades were running.
+    bool reevaluate(const PropertyEvaluationParameters&);
+
+    // Marks evaluated properties as out of date, once cascaded again.
+    void invalidateEvaluation();
+
     virtual std::unique_ptr<Bucket> createBucket(const BucketParameters&, const std::vector<const Layer*>&) const = 0;
 
     // Checks whether this layer needs to be rendered in the given render pass.
@@ -69,6 +79,10 @@ public:
     // Checks whether this layer can be rendered.
     bool needsRendering(float zoom) const;
 
+    // Marks a change to state that buckets are built from, so that workers rebuild the
+    // buckets of this layer on their next layout instead of retaining them.
+    void bumpRevision();
+
     virtual float getQueryRadius() const { return 0; }
     virtual bool queryIntersectsGeometry(
             const GeometryCoordinates&,
@@ -87,17 +101,42 @@ public:
     float maxZoom = std::numeric_limits<float>::infinity();
     VisibilityType visibility = VisibilityType::Visible;
 
+    // Set by the style optimizer for layers that can't draw anything as they are, which
+    // are then neither laid out nor rendered; see `optimize`. Cleared by any change to the
+    // layer.
+    bool rendersNothing = false;
+
     LayerObserver nullObserver;
     LayerObserver* observer = &nullObserver;
 
+    // Unique among all layers and their revisions in the process, and kept by `clone()`:
+    // two layers with the same revision and ID produce the same buckets.
+    uint64_t revision;
+
+    // Set by each evaluation of the paint properties that may have changed them, and, like
+    // `revision`, unique among those of all layers.
+    uint64_t evaluation = 0;
+
+    // Made by `layoutKey` for the current revision, or an earlier one.
+    mutable optional<LayoutKey> layoutKey;
+
 protected:
-    Impl() = default;
+    Impl();
     Impl(const Impl&) = default;
     Impl& operator=(const Impl&) = delete;
 
     // Stores what render passes this layer is currently enabled for. This depends on the
     // evaluated StyleProperties object and is updated accordingly.
     RenderPass passes = RenderPass::None;
+
+private:
+    struct Evaluation {
+        float zoom;
+        uint64_t revision;
+    };
+
+    // Set by an evaluation that evaluating again with the same inputs would repeat.
+    optional<Evaluation> stableEvaluation;
 };
 
 } // namespace style
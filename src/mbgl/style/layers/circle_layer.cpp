@@ -43,6 +43,7 @@ const std::string& CircleLayer::getSourceID() const {
 
 void CircleLayer::setSourceLayer(const std::string& sourceLayer) {
     impl->sourceLayer = sourceLayer;
+    impl->bumpRevision();
 }
 
 const std::string& CircleLayer::getSourceLayer() const {
@@ -43,6 +43,7 @@ const std::string& FillExtrusionLayer::getSourceID() const {
 
 void FillExtrusionLayer::setSourceLayer(const std::string& sourceLayer) {
     impl->sourceLayer = sourceLayer;
+    impl->bumpRevision();
 }
 
 const std::string& FillExtrusionLayer::getSourceLayer() const {
@@ -43,6 +43,7 @@ const std::string& FillLayer::getSourceID() const {
 
 void FillLayer::setSourceLayer(const std::string& sourceLayer) {
     impl->sourceLayer = sourceLayer;
+    impl->bumpRevision();
 }
 
 const std::string& FillLayer::getSourceLayer() const {
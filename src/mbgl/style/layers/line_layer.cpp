@@ -44,6 +44,7 @@ const std::string& LineLayer::getSourceID() const {
 
 void LineLayer::setSourceLayer(const std::string& sourceLayer) {
     impl->sourceLayer = sourceLayer;
+    impl->bumpRevision();
 }
 
 const std::string& LineLayer::getSourceLayer() const {
@@ -218,7 +219,8 @@ void LineLayer::setLineWidth(PropertyValue<float> value, const optional<std::str
     if (value == getLineWidth(klass))
         return;
     impl->paint.set<LineWidth>(value, klass);
-    impl->observer->onLayerPaintPropertyChanged(*this);
+    // Buckets tessellate joins and caps for the width of the lines.
+    impl->observer->onLayerDataDrivenPaintPropertyChanged(*this);
 }
 
 void LineLayer::setLineWidthTransition(const TransitionOptions& value, const optional<std::string>& klass) {
@@ -237,11 +239,8 @@ void LineLayer::setLineGapWidth(DataDrivenPropertyValue<float> value, const opti
     if (value == getLineGapWidth(klass))
         return;
     impl->paint.set<LineGapWidth>(value, klass);
-    if (value.isDataDriven()) {
-        impl->observer->onLayerDataDrivenPaintPropertyChanged(*this);
-    } else {
-        impl->observer->onLayerPaintPropertyChanged(*this);
-    }
+    // Buckets tessellate joins and caps for the width of the lines.
+    impl->observer->onLayerDataDrivenPaintPropertyChanged(*this);
 }
 
 void LineLayer::setLineGapWidthTransition(const TransitionOptions& value, const optional<std::string>& klass) {
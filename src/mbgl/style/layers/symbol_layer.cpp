@@ -44,6 +44,7 @@ const std::string& SymbolLayer::getSourceID() const {
 
 void SymbolLayer::setSourceLayer(const std::string& sourceLayer) {
     impl->sourceLayer = sourceLayer;
+    impl->bumpRevision();
 }
 
 const std::string& SymbolLayer::getSourceLayer() const {
@@ -107,6 +107,14 @@ public:
         transitions[klass ? ClassDictionary::Get().lookup(*klass) : ClassID::Default] = transition;
     }
 
+    // Replaces the value of each class with what `fn` returns for it.
+    template <class Fn>
+    void transformValues(Fn&& fn) {
+        for (auto& entry : values) {
+            entry.second = fn(entry.second);
+        }
+    }
+
     template <class UnevaluatedPaintProperty>
     UnevaluatedPaintProperty cascade(const CascadeParameters& params, UnevaluatedPaintProperty prior) const {
         TransitionOptions transition;
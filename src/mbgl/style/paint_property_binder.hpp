@@ -2,12 +2,123 @@
 
 #include <mbgl/programs/attributes.hpp>
 #include <mbgl/gl/attribute.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/half_float.hpp>
 #include <mbgl/gl/uniform.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/util/type_list.hpp>
 
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
 namespace mbgl {
 namespace style {
 
+/*
+    The vertex buffer of a data-driven paint property, holding the attributes `As` of one
+    type. Float attributes are uploaded as half floats where the driver can read those,
+    halving their size: the shaders declare them `lowp` or `mediump`, so they don't keep
+    more precision than that anyway.
+*/
+template <class... As>
+class PaintVertexBuffer {
+public:
+    using Attributes = gl::Attributes<As...>;
+    using Vertex = typename Attributes::Vertex;
+
+    void upload(gl::Context& context, gl::VertexVector<Vertex>&& vertices) {
+        upload(context, std::move(vertices), std::integral_constant<bool, storesFloats>());
+    }
+
+    template <class A>
+    typename A::Binding binding() const {
+        if (halfFloatBuffer) {
+            return typename A::VariableBinding {
+                halfFloatBuffer->buffer,
+                sizeof(HalfFloatVertex),
+                halfFloatBuffer->byteOffset + HalfFloatVertex::attributeOffsets[Attributes::template Index<A>],
+                0,
+                true
+            };
+        }
+        return Attributes::allVariableBindings(*buffer).template get<A>();
+    }
+
+private:
+    using Component = typename std::tuple_element_t<0, std::tuple<As...>>::Value::value_type;
+    static constexpr bool storesFloats = std::is_same<Component, float>::value;
+
+    template <class A>
+    using HalfFloatAttribute = gl::Attribute<gl::HalfFloat, std::tuple_size<typename A::Value>::value>;
+    using HalfFloatVertex = gl::detail::Vertex<HalfFloatAttribute<As>...>;
+
+    void upload(gl::Context& context, gl::VertexVector<Vertex>&& vertices, std::true_type) {
+        if (!context.supportsHalfFloatAttributes()) {
+            upload(context, std::move(vertices), std::false_type());
+            return;
+        }
+
+        // Both vertex types are plain sequences of components.
+        constexpr std::size_t components = sizeof(Vertex) / sizeof(float);
+        static_assert(sizeof(HalfFloatVertex) == components * sizeof(gl::HalfFloat), "unexpected vertex layout");
+
+        gl::VertexVector<HalfFloatVertex> halfFloatVertices;
+        halfFloatVertices.reserveAdditional(vertices.vertexSize());
+        for (std::size_t i = 0; i < vertices.vertexSize(); ++i) {
+            float values[components];
+            std::memcpy(values, &vertices.data()[i], sizeof(Vertex));
+            gl::HalfFloat halfFloats[components];
+            for (std::size_t c = 0; c < components; ++c) {
+                halfFloats[c] = gl::HalfFloat(values[c]);
+            }
+            HalfFloatVertex vertex;
+            std::memcpy(&vertex, halfFloats, sizeof(HalfFloatVertex));
+            halfFloatVertices.emplace_back(vertex);
+        }
+        halfFloatBuffer = context.createVertexBuffer(std::move(halfFloatVertices));
+    }
+
+    void upload(gl::Context& context, gl::VertexVector<Vertex>&& vertices, std::false_type) {
+        buffer = context.createVertexBuffer(std::move(vertices));
+    }
+
+    optional<gl::VertexBuffer<Vertex>> buffer;
+    optional<gl::VertexBuffer<HalfFloatVertex>> halfFloatBuffer;
+};
+
+/*
+    Attribute values by the feature value they were evaluated from. Features of a vector tile
+    layer point to the values they share, so each distinct one is evaluated only once. Values
+    that features copy are evaluated every time, as are those past the maximum size, which
+    finds little to share among features with values of their own, like GeoJSON ones.
+*/
+template <class V>
+class PaintPropertyEvaluationCache {
+public:
+    template <class Evaluate>
+    V get(const GeometryTileFeature& feature, const std::string& property, Evaluate&& evaluate) {
+        optional<Value> storage;
+        const Value* value = feature.findValue(property, storage);
+        if (!value || storage || values.size() >= maximumSize) {
+            return evaluate(value);
+        }
+
+        auto it = values.find(value);
+        if (it == values.end()) {
+            it = values.emplace(value, evaluate(value)).first;
+        }
+        return it->second;
+    }
+
+private:
+    static constexpr std::size_t maximumSize = 1024;
+    std::unordered_map<const Value*, V> values;
+};
+
 template <class T, class A>
 class ConstantPaintPropertyBinder {
 public:
@@ -20,7 +131,9 @@ public:
     }
 
     void populateVertexVector(const GeometryTileFeature&, std::size_t) {}
+    void repeatVertices(std::size_t) {}
     void upload(gl::Context&) {}
+    std::size_t byteSize() const { return 0; }
 
     AttributeBinding minAttributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const {
         return typename Attribute::ConstantBinding {
@@ -47,8 +160,8 @@ public:
     using AttributeValue = typename Attribute::Value;
     using AttributeBinding = typename Attribute::Binding;
 
-    using Attributes = gl::Attributes<Attribute>;
-    using Vertex = typename Attributes::Vertex;
+    using VertexBuffer = PaintVertexBuffer<Attribute>;
+    using Vertex = typename VertexBuffer::Vertex;
 
     SourceFunctionPaintPropertyBinder(SourceFunction<T> function_, T defaultValue_)
         : function(std::move(function_)),
@@ -56,14 +169,22 @@ public:
     }
 
     void populateVertexVector(const GeometryTileFeature& feature, std::size_t length) {
-        AttributeValue value = Attribute::value(function.evaluate(feature, defaultValue));
-        for (std::size_t i = vertexVector.vertexSize(); i < length; ++i) {
-            vertexVector.emplace_back(Vertex { value });
-        }
+        AttributeValue value = cache.get(feature, function.property, [&] (const Value* v) {
+            return Attribute::value(function.evaluate(v, defaultValue));
+        });
+        vertexVector.extend(length, Vertex { value });
+    }
+
+    void repeatVertices(std::size_t n) {
+        vertexVector.repeatEach(n);
+    }
+
+    std::size_t byteSize() const {
+        return vertexVector.byteSize();
     }
 
     void upload(gl::Context& context) {
-        vertexBuffer = context.createVertexBuffer(std::move(vertexVector));
+        vertexBuffer.upload(context, std::move(vertexVector));
     }
 
     AttributeBinding minAttributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const {
@@ -72,8 +193,7 @@ public:
                 Attribute::value(*currentValue.constant())
             };
         } else {
-            return Attributes::allVariableBindings(*vertexBuffer)
-                .template get<Attribute>();
+            return vertexBuffer.template binding<Attribute>();
         }
     }
 
@@ -88,8 +208,9 @@ public:
 private:
     SourceFunction<T> function;
     T defaultValue;
+    PaintPropertyEvaluationCache<AttributeValue> cache;
     gl::VertexVector<Vertex> vertexVector;
-    optional<gl::VertexBuffer<Vertex>> vertexBuffer;
+    VertexBuffer vertexBuffer;
 };
 
 template <class T, class A>
@@ -102,8 +223,8 @@ public:
     using MinAttribute = attributes::Min<Attribute>;
     using MaxAttribute = attributes::Max<Attribute>;
 
-    using Attributes = gl::Attributes<MinAttribute, MaxAttribute>;
-    using Vertex = typename Attributes::Vertex;
+    using VertexBuffer = PaintVertexBuffer<MinAttribute, MaxAttribute>;
+    using Vertex = typename VertexBuffer::Vertex;
 
     CompositeFunctionPaintPropertyBinder(CompositeFunction<T> function_, float zoom, T defaultValue_)
         : function(std::move(function_)),
@@ -112,16 +233,23 @@ public:
     }
 
     void populateVertexVector(const GeometryTileFeature& feature, std::size_t length) {
-        Range<T> range = function.evaluate(std::get<1>(coveringRanges), feature, defaultValue);
-        AttributeValue min = Attribute::value(range.min);
-        AttributeValue max = Attribute::value(range.max);
-        for (std::size_t i = vertexVector.vertexSize(); i < length; ++i) {
-            vertexVector.emplace_back(Vertex { min, max });
-        }
+        Vertex vertex = cache.get(feature, function.property, [&] (const Value* v) {
+            Range<T> range = function.evaluate(std::get<1>(coveringRanges), v, defaultValue);
+            return Vertex { Attribute::value(range.min), Attribute::value(range.max) };
+        });
+        vertexVector.extend(length, vertex);
+    }
+
+    void repeatVertices(std::size_t n) {
+        vertexVector.repeatEach(n);
+    }
+
+    std::size_t byteSize() const {
+        return vertexVector.byteSize();
     }
 
     void upload(gl::Context& context) {
-        vertexBuffer = context.createVertexBuffer(std::move(vertexVector));
+        vertexBuffer.upload(context, std::move(vertexVector));
     }
 
     AttributeBinding minAttributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const {
@@ -130,8 +258,7 @@ public:
                 Attribute::value(*currentValue.constant())
             };
         } else {
-            return Attributes::allVariableBindings(*vertexBuffer)
-                .template get<MinAttribute>();
+            return vertexBuffer.template binding<MinAttribute>();
         }
     }
 
@@ -139,8 +266,7 @@ public:
         if (currentValue.isConstant()) {
             return AttributeBinding();
         } else {
-            return Attributes::allVariableBindings(*vertexBuffer)
-                .template get<MaxAttribute>();
+            return vertexBuffer.template binding<MaxAttribute>();
         }
     }
 
@@ -153,8 +279,9 @@ private:
     CompositeFunction<T> function;
     T defaultValue;
     std::tuple<Range<float>, Range<InnerStops>> coveringRanges;
+    PaintPropertyEvaluationCache<Vertex> cache;
     gl::VertexVector<Vertex> vertexVector;
-    optional<gl::VertexBuffer<Vertex>> vertexBuffer;
+    VertexBuffer vertexBuffer;
 };
 
 template <class PaintProperty>
@@ -189,12 +316,37 @@ public:
         });
     }
 
+    void repeatVertices(std::size_t n) {
+        binder.match([&] (auto& b) {
+            b.repeatVertices(n);
+        });
+    }
+
+    // Whether the property has the same value for every feature, so that this binder holds
+    // no attribute values.
+    bool isConstant() const {
+        return binder.template is<ConstantPaintPropertyBinder<Type, Attribute>>();
+    }
+
+    // Whether the attribute values are interpolated between zoom levels when drawn at the
+    // current value: only those of composite functions that aren't constant at this zoom.
+    bool interpolates(const PropertyValue& currentValue) const {
+        return binder.template is<CompositeFunctionPaintPropertyBinder<Type, Attribute>>() &&
+            !currentValue.isConstant();
+    }
+
     void upload(gl::Context& context) {
         binder.match([&] (auto& b) {
             b.upload(context);
         });
     }
 
+    std::size_t byteSize() const {
+        return binder.match([&] (const auto& b) {
+            return b.byteSize();
+        });
+    }
+
     using MinAttribute = attributes::Min<Attribute>;
     using MaxAttribute = attributes::Max<Attribute>;
     using AttributeBinding = typename Attribute::Binding;
@@ -246,12 +398,61 @@ public:
         });
     }
 
+    // Repeats each vertex's attribute values `n` times, for buckets that populate one entry
+    // per instance but draw without instancing.
+    void repeatVertices(std::size_t n) {
+        util::ignore({
+            (binders.template get<Ps>().repeatVertices(n), 0)...
+        });
+    }
+
     void upload(gl::Context& context) {
         util::ignore({
             (binders.template get<Ps>().upload(context), 0)...
         });
     }
 
+    bool isConstant() const {
+        bool result = true;
+        util::ignore({
+            (result = result && binders.template get<Ps>().isConstant(), 0)...
+        });
+        return result;
+    }
+
+    // One bit for each property, in order, set if it `interpolates`. Programs are specialized
+    // for the properties that don't; see `specializeVertexSource`.
+    using Variant = uint32_t;
+    static_assert(sizeof...(Ps) <= sizeof(Variant) * 8, "too many paint properties for a variant");
+
+    template <class EvaluatedProperties>
+    Variant variant(const EvaluatedProperties& currentProperties) const {
+        Variant result = 0;
+        Variant bit = 1;
+        util::ignore({
+            (result |= (binders.template get<Ps>().interpolates(currentProperties.template get<Ps>()) ? bit : 0),
+             bit <<= 1, 0)...
+        });
+        (void)currentProperties; // Unused without properties.
+        (void)bit;
+        return result;
+    }
+
+    // The names of the properties' attributes in the shaders, in order, without the `_min`
+    // and `_max` suffixes.
+    static std::vector<std::string> attributeNames() {
+        return { std::string(PaintPropertyBinder<Ps>::Attribute::name())... };
+    }
+
+    // Of the attribute values not uploaded yet.
+    std::size_t byteSize() const {
+        std::size_t result = 0;
+        util::ignore({
+            (result += binders.template get<Ps>().byteSize(), 0)...
+        });
+        return result;
+    }
+
     using MinAttributes = gl::Attributes<typename PaintPropertyBinder<Ps>::MinAttribute...>;
     using MaxAttributes = gl::Attributes<typename PaintPropertyBinder<Ps>::MaxAttribute...>;
 
@@ -1,29 +1,76 @@
 #include <mbgl/style/parser.hpp>
+#include <mbgl/style/binary_style.hpp>
 #include <mbgl/style/layer_impl.hpp>
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion.hpp>
 #include <mbgl/style/conversion/source.hpp>
 #include <mbgl/style/conversion/layer.hpp>
 
+#include <mbgl/actor/task_group.hpp>
 #include <mbgl/util/logging.hpp>
 
 #include <mapbox/geojsonvt.hpp>
 
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 
 #include <algorithm>
+#include <cstring>
 #include <set>
 #include <sstream>
 
 namespace mbgl {
 namespace style {
 
+namespace {
+
+std::string stringify(const JSValue& value) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    value.Accept(writer);
+    return { buffer.GetString(), buffer.GetSize() };
+}
+
+// Class names are looked up in a dictionary of the thread that uses them.
+bool hasPaintClasses(const JSValue& layer) {
+    for (const auto& property : layer.GetObject()) {
+        if (property.name.GetStringLength() > 6 && std::strncmp(property.name.GetString(), "paint.", 6) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+Parser::Parser() = default;
+
+Parser::Parser(Scheduler& scheduler_)
+    : scheduler(&scheduler_) {
+}
+
 Parser::~Parser() = default;
 
 StyleParseResult Parser::parse(const std::string& json) {
-    rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> document;
-    document.Parse<0>(json.c_str());
+    JSDocument document;
+
+    if (isBinaryStyle(json)) {
+        optional<std::string> fallback;
+        try {
+            fallback = decodeBinaryStyle(json, document);
+        } catch (...) {
+            return std::current_exception();
+        }
+
+        if (fallback) {
+            Log::Warning(Event::ParseStyle, "binary style is in another format version; parsing its JSON instead");
+            return parse(*fallback);
+        }
+    } else {
+        document.Parse<0>(json.c_str());
+    }
 
     if (document.HasParseError()) {
         std::stringstream message;
@@ -125,6 +172,7 @@ void Parser::parseSources(const JSValue& value) {
 
         sourcesMap.emplace(id, (*source).get());
         sources.emplace_back(std::move(*source));
+        sourceDefinitions.emplace(std::move(id), stringify(property.value));
     }
 }
 
@@ -163,6 +211,34 @@ void Parser::parseLayers(const JSValue& value) {
         ids.push_back(layerID);
     }
 
+    if (scheduler) {
+        // Layers that don't refer to another one are converted in parallel first. Those that
+        // fail are converted again below, to be reported in order.
+        std::vector<std::pair<const JSValue*, std::unique_ptr<Layer>*>> independent;
+        for (const auto& id : ids) {
+            auto& entry = layersMap.find(id)->second;
+            if (!entry.first.HasMember("ref") && !hasPaintClasses(entry.first)) {
+                independent.emplace_back(&entry.first, &entry.second);
+            }
+        }
+
+        std::vector<std::string> definitions(independent.size());
+        TaskGroup(*scheduler).run(independent.size(), [&] (std::size_t i, std::size_t) {
+            conversion::Result<std::unique_ptr<Layer>> converted =
+                conversion::convert<std::unique_ptr<Layer>>(*independent[i].first);
+            if (converted) {
+                *independent[i].second = std::move(*converted);
+                definitions[i] = stringify(*independent[i].first);
+            }
+        });
+
+        for (std::size_t i = 0; i < independent.size(); ++i) {
+            if (*independent[i].second) {
+                layerDefinitions.emplace((*independent[i].second)->getID(), std::move(definitions[i]));
+            }
+        }
+    }
+
     for (const auto& id : ids) {
         auto it = layersMap.find(id);
 
@@ -221,6 +297,7 @@ void Parser::parseLayer(const std::string& id, const JSValue& value, std::unique
 
         layer = reference->baseImpl->cloneRef(id);
         conversion::setPaintProperties(*layer, value);
+        layerDefinitions[id] = stringify(value) + layerDefinitions[ref];
     } else {
         conversion::Result<std::unique_ptr<Layer>> converted = conversion::convert<std::unique_ptr<Layer>>(value);
         if (!converted) {
@@ -228,6 +305,7 @@ void Parser::parseLayer(const std::string& id, const JSValue& value, std::unique
             return;
         }
         layer = std::move(*converted);
+        layerDefinitions[id] = stringify(value);
     }
 }
 
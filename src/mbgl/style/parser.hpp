@@ -15,12 +15,18 @@
 #include <forward_list>
 
 namespace mbgl {
+
+class Scheduler;
+
 namespace style {
 
 using StyleParseResult = std::exception_ptr;
 
 class Parser {
 public:
+    Parser();
+    // Converts layers in parallel, on the calling thread and those of the scheduler.
+    explicit Parser(Scheduler&);
     ~Parser();
 
     StyleParseResult parse(const std::string&);
@@ -31,6 +37,11 @@ public:
     std::vector<std::unique_ptr<Source>> sources;
     std::vector<std::unique_ptr<Layer>> layers;
 
+    // The JSON each source and layer was converted from, with that of the layer a layer
+    // refers to; for telling what another style shares with this one.
+    std::unordered_map<std::string, std::string> sourceDefinitions;
+    std::unordered_map<std::string, std::string> layerDefinitions;
+
     std::string name;
     LatLng latLng;
     double zoom = 0;
@@ -45,6 +56,8 @@ private:
     void parseLayers(const JSValue&);
     void parseLayer(const std::string& id, const JSValue&, std::unique_ptr<Layer>&);
 
+    Scheduler* scheduler = nullptr;
+
     std::unordered_map<std::string, const Source*> sourcesMap;
     std::unordered_map<std::string, std::pair<const JSValue&, std::unique_ptr<Layer>>> layersMap;
 
@@ -18,5 +18,21 @@ optional<std::string> Source::getAttribution() const {
     return baseImpl->getAttribution();
 }
 
+void Source::setSimplificationTolerance(float pixels) {
+    baseImpl->setSimplificationTolerance(pixels);
+}
+
+float Source::getSimplificationTolerance() const {
+    return baseImpl->getSimplificationTolerance();
+}
+
+std::vector<TileTimeline> Source::getTileTimelines() const {
+    return baseImpl->getTileTimelines();
+}
+
+TileLoadStats Source::getTileLoadStats() const {
+    return baseImpl->getTileLoadStats();
+}
+
 } // namespace style
 } // namespace mbgl
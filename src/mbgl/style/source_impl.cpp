@@ -1,8 +1,10 @@
 #include <mbgl/style/source_impl.hpp>
+#include <mbgl/actor/task_group.hpp>
 #include <mbgl/style/source_observer.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/renderer/painter.hpp>
+#include <mbgl/renderer/upload_scheduler.hpp>
 #include <mbgl/style/update_parameters.hpp>
 #include <mbgl/text/placement_config.hpp>
 #include <mbgl/util/logging.hpp>
@@ -18,6 +20,7 @@
 #include <mapbox/geometry/envelope.hpp>
 
 #include <algorithm>
+#include <unordered_set>
 
 namespace mbgl {
 namespace style {
@@ -37,7 +40,7 @@ bool Source::Impl::isLoaded() const {
     if (!loaded) return false;
 
     for (const auto& pair : tiles) {
-        if (!pair.second->isComplete()) {
+        if (!pair.second->isComplete() && !prefetching.count(pair.first)) {
             return false;
         }
     }
@@ -51,26 +54,63 @@ void Source::Impl::detach() {
 
 void Source::Impl::invalidateTiles() {
     tiles.clear();
-    renderTiles.clear();
+    tileIndex.clear();
+    ++tilesRevision;
+    clearRenderTiles();
     cache.clear();
 }
 
-void Source::Impl::startRender(algorithm::ClipIDGenerator& generator,
-                         const mat4& projMatrix,
-                         const TransformState& transform) {
+void Source::Impl::clearRenderTiles() {
+    if (!renderTiles.empty()) {
+        renderTiles.clear();
+        ++renderTilesRevision;
+    }
+}
+
+void Source::Impl::updateClipIDs(algorithm::ClipIDGenerator& generator) {
     if (type == SourceType::Vector ||
         type == SourceType::GeoJSON ||
         type == SourceType::Annotations) {
         generator.update(renderTiles);
+
+        // Children follow their parents in the map.
+        for (auto it = renderTiles.begin(); it != renderTiles.end(); ++it) {
+            it->second.clippedToExtent = it->second.used &&
+                std::none_of(std::next(it), renderTiles.end(), [&] (const auto& other) {
+                    return other.second.used && other.first.isChildOf(it->first);
+                });
+        }
     }
+}
 
+void Source::Impl::startRender(const mat4& projMatrix, const TransformState& transform) {
+    const TimePoint now = Clock::now();
     for (auto& pair : renderTiles) {
         auto& tile = pair.second;
-        transform.matrixFor(tile.matrix, tile.id);
-        matrix::multiply(tile.matrix, projMatrix, tile.matrix);
+        transform.matrixFor(tile.matrix, tile.id, projMatrix);
+
+        // Only used render tiles have buckets in the render order.
+        TileTimeline& timeline = tile.tile.timeline;
+        if (tile.used && !timeline.rendered) {
+            timeline.rendered = now;
+            tileLoadStats.record(timeline);
+        }
     }
 }
 
+bool Source::Impl::tilesClippedToExtent() const {
+    if (type != SourceType::Vector &&
+        type != SourceType::GeoJSON &&
+        type != SourceType::Annotations) {
+        // Tiles of other sources aren't clipped.
+        return true;
+    }
+
+    return std::all_of(renderTiles.begin(), renderTiles.end(), [] (const auto& pair) {
+        return !pair.second.used || pair.second.clippedToExtent;
+    });
+}
+
 void Source::Impl::finishRender(Painter& painter) {
     for (auto& pair : renderTiles) {
         auto& tile = pair.second;
@@ -84,6 +124,16 @@ std::map<UnwrappedTileID, RenderTile>& Source::Impl::getRenderTiles() {
     return renderTiles;
 }
 
+void Source::Impl::uploadTiles(UploadScheduler& scheduler, gl::Context& context) {
+    for (const auto& pair : tiles) {
+        if (pair.second->needsUpload()) {
+            // Uploading, or deferring it, changes whether the tile is renderable.
+            scheduler.upload(*pair.second, context);
+            ++tilesRevision;
+        }
+    }
+}
+
 void Source::Impl::updateTiles(const UpdateParameters& parameters) {
     if (!loaded) {
         return;
@@ -92,21 +142,27 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
     const uint16_t tileSize = getTileSize();
     const Range<uint8_t> zoomRange = getZoomRange();
 
-    // Determine the overzooming/underzooming amounts and required tiles.
-    int32_t overscaledZoom = util::coveringZoomLevel(parameters.transformState.getZoom(), type, tileSize);
-    int32_t tileZoom = overscaledZoom;
+    // Determine the overzooming/underzooming amounts and required tiles of a viewport.
+    auto getIdealTiles = [&] (const TransformState& state, int32_t& tileZoom) {
+        int32_t overscaledZoom = util::coveringZoomLevel(state.getZoom(), type, tileSize);
+        tileZoom = overscaledZoom;
 
-    std::vector<UnwrappedTileID> idealTiles;
-    if (overscaledZoom >= zoomRange.min) {
-        int32_t idealZoom = std::min<int32_t>(zoomRange.max, overscaledZoom);
+        std::vector<UnwrappedTileID> result;
+        if (overscaledZoom >= zoomRange.min) {
+            int32_t idealZoom = std::min<int32_t>(zoomRange.max, overscaledZoom);
 
-        // Make sure we're not reparsing overzoomed raster tiles.
-        if (type == SourceType::Raster) {
-            tileZoom = idealZoom;
+            // Make sure we're not reparsing overzoomed raster tiles.
+            if (type == SourceType::Raster) {
+                tileZoom = idealZoom;
+            }
+
+            result = util::tileCover(state, idealZoom, zoomRange.min, parameters.tileCoverError);
         }
+        return result;
+    };
 
-        idealTiles = util::tileCover(parameters.transformState, idealZoom);
-    }
+    int32_t tileZoom;
+    const std::vector<UnwrappedTileID> idealTiles = getIdealTiles(parameters.transformState, tileZoom);
 
     // Stores a list of all the tiles that we're definitely going to retain. There are two
     // kinds of tiles we need: the ideal tiles determined by the tile cover. They may not yet be in
@@ -119,8 +175,8 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
         tile.setNecessity(necessity);
     };
     auto getTileFn = [this](const OverscaledTileID& tileID) -> Tile* {
-        auto it = tiles.find(tileID);
-        return it == tiles.end() ? nullptr : it->second.get();
+        auto it = tileIndex.find(tileID);
+        return it == tileIndex.end() ? nullptr : it->second;
     };
     auto createTileFn = [this, &parameters](const OverscaledTileID& tileID) -> Tile* {
         std::unique_ptr<Tile> tile = cache.get(tileID);
@@ -133,15 +189,146 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
         if (!tile) {
             return nullptr;
         }
-        return tiles.emplace(tileID, std::move(tile)).first->second.get();
+        tile->setFeatureIndexing(featureIndexing);
+        tile->setSimplificationTolerance(simplificationTolerance);
+        ++tilesRevision;
+        Tile* result = tiles.emplace(tileID, std::move(tile)).first->second.get();
+        tileIndex.emplace(tileID, result);
+        return result;
     };
     auto renderTileFn = [this](const UnwrappedTileID& tileID, Tile& tile) {
-        renderTiles.emplace(tileID, RenderTile{ tileID, tile });
+        selectedTiles.emplace_back(tileID, &tile);
     };
 
-    renderTiles.clear();
-    algorithm::updateRenderables(getTileFn, createTileFn, retainTileFn, renderTileFn,
-                                 idealTiles, zoomRange, tileZoom);
+    // Unless a tile has changed since, the same ideal tiles are covered the same way.
+    if (coverage.tilesRevision == tilesRevision && coverage.tileZoom == tileZoom &&
+        coverage.zoomRange == zoomRange && coverage.idealTiles == idealTiles) {
+        for (const auto& retained : coverage.retainedTiles) {
+            retainTileFn(*retained.first, retained.second);
+        }
+    } else {
+        selectedTiles.clear();
+        coverage.retainedTiles.clear();
+        auto retainAndRecordFn = [&] (Tile& tile, Resource::Necessity necessity) {
+            retainTileFn(tile, necessity);
+            coverage.retainedTiles.emplace_back(&tile, necessity);
+        };
+        algorithm::updateRenderables(getTileFn, createTileFn, retainAndRecordFn, renderTileFn,
+                                     idealTiles, zoomRange, tileZoom);
+        coverage.idealTiles = idealTiles;
+        coverage.tileZoom = tileZoom;
+        coverage.zoomRange = zoomRange;
+        coverage.tilesRevision = tilesRevision;
+    }
+
+    // While the camera is animating, the tiles of the viewports it is headed for are loaded
+    // ahead of it, without being rendered. The tiles of the current frame will soon be passed
+    // by, so their requests wait for those of the predicted tiles.
+    std::set<OverscaledTileID> predicted;
+    for (const auto& state : parameters.transitionStates) {
+        int32_t predictedZoom;
+        for (const auto& idealTileID : getIdealTiles(state, predictedZoom)) {
+            const OverscaledTileID dataTileID(predictedZoom, idealTileID.canonical);
+            Tile* tile = getTileFn(dataTileID);
+            if (!tile) {
+                tile = createTileFn(dataTileID);
+            }
+            if (tile) {
+                retainTileFn(*tile, Resource::Necessity::Required);
+                predicted.insert(dataTileID);
+            }
+        }
+    }
+
+    // While the camera is idle and the ideal tiles are loaded, the tiles around them, and
+    // those of the zoom levels above and below, are loaded ahead of a pan or zoom. They are
+    // not rendered, and are dropped to the cache, cancelling their requests, once the camera
+    // moves.
+    for (const auto& tileID : prefetching) {
+        const Tile* tile = getTileFn(tileID);
+        if (tile && tile->isComplete()) {
+            prefetchedBytes += tile->dataSize;
+        }
+    }
+    prefetching.clear();
+
+    std::set<OverscaledTileID> prefetched;
+    const bool prefetches = parameters.prefetchBytes && parameters.transitionStates.empty() &&
+        (type == SourceType::Vector || type == SourceType::Raster) &&
+        std::all_of(idealTiles.begin(), idealTiles.end(), [&] (const UnwrappedTileID& tileID) {
+            const Tile* tile = getTileFn(OverscaledTileID(tileID.canonical.z == zoomRange.max ? tileZoom : tileID.canonical.z, tileID.canonical));
+            return tile && tile->isComplete();
+        });
+    if (prefetches) {
+        auto prefetchFn = [&] (const CanonicalTileID& tileID) {
+            const OverscaledTileID dataTileID(tileID.z == zoomRange.max ? tileZoom : tileID.z, tileID);
+            if (retain.count(dataTileID)) {
+                return; // Needed anyway, or prefetched already.
+            }
+            Tile* tile = getTileFn(dataTileID);
+            if (!tile) {
+                tile = createTileFn(dataTileID);
+            }
+            if (tile) {
+                retainTileFn(*tile, Resource::Necessity::Required);
+                prefetched.insert(dataTileID);
+                if (!tile->isComplete()) {
+                    prefetching.insert(dataTileID);
+                }
+            }
+        };
+
+        for (const auto& idealTileID : idealTiles) {
+            const CanonicalTileID& canonical = idealTileID.canonical;
+            const int32_t dim = 1 << canonical.z;
+            for (int32_t dy = -1; dy <= 1; ++dy) {
+                for (int32_t dx = -1; dx <= 1; ++dx) {
+                    const int32_t y = canonical.y + dy;
+                    if ((dx || dy) && y >= 0 && y < dim) {
+                        prefetchFn({ canonical.z, uint32_t((canonical.x + dx + dim) % dim), uint32_t(y) });
+                    }
+                }
+            }
+        }
+        for (const auto& idealTileID : idealTiles) {
+            const CanonicalTileID& canonical = idealTileID.canonical;
+            if (canonical.z > zoomRange.min) {
+                prefetchFn(canonical.scaledTo(canonical.z - 1));
+            }
+            if (canonical.z < zoomRange.max) {
+                for (const auto& child : canonical.children()) {
+                    prefetchFn(child);
+                }
+            }
+        }
+    }
+
+    for (auto& pair : tiles) {
+        const bool passedBy = !predicted.empty() && !predicted.count(pair.first);
+        pair.second->setPriority(passedBy || prefetched.count(pair.first) ? Resource::Low : Resource::Regular);
+    }
+
+    // A tile may be selected more than once; the first one wins.
+    std::stable_sort(selectedTiles.begin(), selectedTiles.end(), [] (const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    selectedTiles.erase(std::unique(selectedTiles.begin(), selectedTiles.end(), [] (const auto& a, const auto& b) {
+        return a.first == b.first;
+    }), selectedTiles.end());
+
+    // Keep the render tiles, and the render order built from them, unless the selection
+    // has changed.
+    const bool unchanged = selectedTiles.size() == renderTiles.size() &&
+        std::equal(selectedTiles.begin(), selectedTiles.end(), renderTiles.begin(), [] (const auto& selected, const auto& pair) {
+            return selected.first == pair.first && selected.second == &pair.second.tile;
+        });
+    if (!unchanged) {
+        renderTiles.clear();
+        for (const auto& selected : selectedTiles) {
+            renderTiles.emplace_hint(renderTiles.end(), selected.first, RenderTile{ selected.first, *selected.second });
+        }
+        ++renderTilesRevision;
+    }
 
     if (type != SourceType::Annotations) {
         size_t conservativeCacheSize =
@@ -172,8 +359,10 @@ void Source::Impl::removeStaleTiles(const std::set<OverscaledTileID>& retain) {
     while (tilesIt != tiles.end()) {
         if (retainIt == retain.end() || tilesIt->first < *retainIt) {
             tilesIt->second->setNecessity(Tile::Necessity::Optional);
+            tileIndex.erase(tilesIt->first);
             cache.add(tilesIt->first, std::move(tilesIt->second));
             tiles.erase(tilesIt++);
+            ++tilesRevision;
         } else {
             if (!(*retainIt < tilesIt->first)) {
                 ++tilesIt;
@@ -184,12 +373,25 @@ void Source::Impl::removeStaleTiles(const std::set<OverscaledTileID>& retain) {
 }
 
 void Source::Impl::removeTiles() {
-    renderTiles.clear();
+    clearRenderTiles();
     if (!tiles.empty()) {
         removeStaleTiles({});
     }
 }
 
+void Source::Impl::removeIncompleteTiles() {
+    for (auto it = tiles.begin(); it != tiles.end();) {
+        if (it->second->isComplete()) {
+            ++it;
+            continue;
+        }
+        clearRenderTiles();
+        tileIndex.erase(it->first);
+        it = tiles.erase(it);
+        ++tilesRevision;
+    }
+}
+
 void Source::Impl::updateSymbolDependentTiles() {
     for (auto& pair : tiles) {
         pair.second->symbolDependenciesChanged();
@@ -206,7 +408,9 @@ void Source::Impl::reloadTiles() {
 
 std::unordered_map<std::string, std::vector<Feature>> Source::Impl::queryRenderedFeatures(const ScreenLineString& geometry,
                                            const TransformState& transformState,
-                                           const QueryOptions& options) const {
+                                           const QueryOptions& options,
+                                           FeatureDetail detail,
+                                           TaskGroup& tasks) const {
     std::unordered_map<std::string, std::vector<Feature>> result;
     if (renderTiles.empty() || geometry.empty()) {
         return result;
@@ -231,6 +435,9 @@ std::unordered_map<std::string, std::vector<Feature>> Source::Impl::queryRendere
                    [](const auto& pair) { return std::ref(pair.second); });
     std::sort(sortedTiles.begin(), sortedTiles.end(), sortRenderTiles);
 
+    // The tiles covered by the query, with the query geometry in their coordinates.
+    std::vector<std::pair<Tile*, GeometryCoordinates>> tileQueries;
+
     for (const auto& renderTileRef : sortedTiles) {
         const RenderTile& renderTile = renderTileRef.get();
         GeometryCoordinate tileSpaceBoundsMin = TileCoordinate::toGeometryCoordinate(renderTile.id, box.min);
@@ -249,21 +456,142 @@ std::unordered_map<std::string, std::vector<Feature>> Source::Impl::queryRendere
             tileSpaceQueryGeometry.push_back(TileCoordinate::toGeometryCoordinate(renderTile.id, c));
         }
 
-        renderTile.tile.queryRenderedFeatures(result,
-                                              tileSpaceQueryGeometry,
-                                              transformState,
-                                              options);
+        tileQueries.emplace_back(&renderTile.tile, std::move(tileSpaceQueryGeometry));
+    }
+
+    // Tiles only read their own data and the style while they are queried, so they can be
+    // queried concurrently; their results are then merged in tile order.
+    std::vector<std::unordered_map<std::string, std::vector<Feature>>> tileResults(tileQueries.size());
+    tasks.run(tileQueries.size(), [&] (std::size_t i, std::size_t) {
+        tileQueries[i].first->queryRenderedFeatures(tileResults[i],
+                                                    tileQueries[i].second,
+                                                    transformState,
+                                                    options,
+                                                    detail);
+    });
+
+    for (auto& tileResult : tileResults) {
+        for (auto& layerResult : tileResult) {
+            auto& features = result[layerResult.first];
+            if (features.empty()) {
+                features = std::move(layerResult.second);
+            } else {
+                std::move(layerResult.second.begin(), layerResult.second.end(), std::back_inserter(features));
+            }
+        }
     }
 
     return result;
 }
 
-void Source::Impl::setCacheSize(size_t size) {
-    cache.setSize(size);
+void Source::Impl::querySourceFeatures(const std::vector<std::string>& sourceLayers,
+                                       const CompiledFilter& filter,
+                                       const optional<LatLngBounds>& bounds,
+                                       TaskGroup& tasks,
+                                       const std::function<void (std::vector<Feature>)>& chunk) const {
+    // The tiles to query, with the bounds in their coordinates. A tile rendered in several
+    // copies of the world is queried once.
+    std::vector<std::pair<const Tile*, optional<mapbox::geometry::box<int16_t>>>> tileQueries;
+    std::unordered_set<const Tile*> queried;
+
+    for (const auto& pair : renderTiles) {
+        const Tile& tile = pair.second.tile;
+        if (!queried.insert(&tile).second) {
+            continue;
+        }
+
+        optional<mapbox::geometry::box<int16_t>> tileBounds;
+        if (bounds) {
+            const UnwrappedTileID id { 0, tile.id.canonical };
+            tileBounds = mapbox::geometry::box<int16_t> {
+                TileCoordinate::toGeometryCoordinate(id, TileCoordinate::fromLatLng(0, bounds->northwest()).p),
+                TileCoordinate::toGeometryCoordinate(id, TileCoordinate::fromLatLng(0, bounds->southeast()).p)
+            };
+            if (tileBounds->min.x >= util::EXTENT || tileBounds->min.y >= util::EXTENT ||
+                tileBounds->max.x < 0 || tileBounds->max.y < 0) {
+                continue;
+            }
+        }
+
+        tileQueries.emplace_back(&tile, std::move(tileBounds));
+    }
+
+    // Tiles are queried a batch at a time, so that features are passed on without waiting
+    // for every tile, and only a batch of tiles' worth of them are held at once.
+    const std::size_t batchSize = tasks.lanes();
+    std::vector<std::vector<Feature>> tileResults(std::min(batchSize, tileQueries.size()));
+
+    for (std::size_t first = 0; first < tileQueries.size(); first += batchSize) {
+        const std::size_t count = std::min(batchSize, tileQueries.size() - first);
+        tasks.run(count, [&] (std::size_t i, std::size_t) {
+            const auto& tileQuery = tileQueries[first + i];
+            tileQuery.first->querySourceFeatures(tileResults[i], sourceLayers, filter, tileQuery.second);
+        });
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!tileResults[i].empty()) {
+                chunk(std::move(tileResults[i]));
+                tileResults[i].clear();
+            }
+        }
+    }
 }
 
-void Source::Impl::onLowMemory() {
-    cache.clear();
+void Source::Impl::setCacheBudget(size_t bytes) {
+    cache.setMaximumBytes(bytes);
+}
+
+void Source::Impl::setFeatureIndexing(bool enabled) {
+    featureIndexing = enabled;
+    for (auto& pair : tiles) {
+        pair.second->setFeatureIndexing(enabled);
+    }
+}
+
+void Source::Impl::setSimplificationTolerance(float pixels) {
+    simplificationTolerance = pixels;
+    for (auto& pair : tiles) {
+        pair.second->setSimplificationTolerance(pixels);
+    }
+}
+
+size_t Source::Impl::takePrefetchedBytes() {
+    const size_t result = prefetchedBytes;
+    prefetchedBytes = 0;
+    return result;
+}
+
+size_t Source::Impl::releaseRetainedData() {
+    size_t result = cache.releaseRetainedData();
+    for (auto& pair : tiles) {
+        result += pair.second->releaseRetainedData();
+    }
+    return result;
+}
+
+void Source::Impl::onMemoryPressure(MemoryPressure level, MemoryPressureResult& result) {
+    const size_t cachedBytes = cache.getBytes();
+    if (cachedBytes) {
+        cache.setMaximumBytes(std::min(cache.getMaximumBytes(), cachedBytes / 2));
+        result.tileCache += cachedBytes - cache.getBytes();
+    }
+
+    result.retainedGeometry += releaseRetainedData();
+
+    if (level == MemoryPressure::Critical) {
+        result.offscreenTiles += cache.getBytes();
+        cache.clear();
+    }
+}
+
+MemoryStats::Source Source::Impl::getMemoryUsage() const {
+    MemoryStats::Source result;
+    for (const auto& pair : tiles) {
+        pair.second->addMemoryUsage(result);
+    }
+    result.tiles = tiles.size();
+    cache.addMemoryUsage(result);
+    return result;
 }
 
 void Source::Impl::setObserver(SourceObserver* observer_) {
@@ -271,17 +599,43 @@ void Source::Impl::setObserver(SourceObserver* observer_) {
 }
 
 void Source::Impl::onTileChanged(Tile& tile) {
+    ++tilesRevision;
     observer->onTileChanged(base, tile.id);
 }
 
 void Source::Impl::onTileError(Tile& tile, std::exception_ptr error) {
+    ++tilesRevision;
     observer->onTileError(base, tile.id, error);
 }
 
+std::vector<TileTimeline> Source::Impl::getTileTimelines() const {
+    std::vector<TileTimeline> result;
+    result.reserve(tiles.size());
+    for (const auto& pair : tiles) {
+        result.push_back(pair.second->timeline);
+        result.back().tile = util::toString(pair.first);
+    }
+    return result;
+}
+
 void Source::Impl::dumpDebugLogs() const {
     Log::Info(Event::General, "Source::id: %s", base.getID().c_str());
     Log::Info(Event::General, "Source::loaded: %d", loaded);
 
+    Log::Info(Event::General, "Source::tileLoadStats: %llu tiles rendered, %llu from cache",
+              static_cast<unsigned long long>(tileLoadStats.tiles),
+              static_cast<unsigned long long>(tileLoadStats.fromCache));
+    for (std::size_t phase = 0; phase < TileLoadStats::PhaseCount; ++phase) {
+        const auto& histogram = tileLoadStats.get(TileLoadStats::Phase(phase));
+        Log::Info(Event::General,
+                  "Source::tileLoadStats %s: %llu <1ms, %llu <5ms, %llu <20ms, %llu <50ms, %llu <200ms, %llu <1s, %llu <5s, %llu >=5s",
+                  TileLoadStats::name(TileLoadStats::Phase(phase)),
+                  static_cast<unsigned long long>(histogram[0]), static_cast<unsigned long long>(histogram[1]),
+                  static_cast<unsigned long long>(histogram[2]), static_cast<unsigned long long>(histogram[3]),
+                  static_cast<unsigned long long>(histogram[4]), static_cast<unsigned long long>(histogram[5]),
+                  static_cast<unsigned long long>(histogram[6]), static_cast<unsigned long long>(histogram[7]));
+    }
+
     for (const auto& pair : tiles) {
         pair.second->dumpDebugLogs();
     }
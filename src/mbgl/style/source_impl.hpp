@@ -7,21 +7,30 @@
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/tile/tile_cache.hpp>
 #include <mbgl/style/types.hpp>
+#include <mbgl/map/memory_stats.hpp>
+#include <mbgl/map/mode.hpp>
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/mat4.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/range.hpp>
+#include <mbgl/util/geo.hpp>
 
+#include <functional>
+#include <limits>
 #include <memory>
 #include <unordered_map>
 #include <vector>
 #include <map>
+#include <set>
 
 namespace mbgl {
 
 class Painter;
+class UploadScheduler;
 class FileSource;
+class Scheduler;
+class TaskGroup;
 class TransformState;
 class RenderTile;
 
@@ -29,24 +38,34 @@ namespace algorithm {
 class ClipIDGenerator;
 } // namespace algorithm
 
+namespace gl {
+class Context;
+} // namespace gl
+
 namespace style {
 
 class UpdateParameters;
 class QueryParameters;
 class SourceObserver;
+class CompiledFilter;
 
 class Source::Impl : public TileObserver, private util::noncopyable {
 public:
     Impl(SourceType, std::string id, Source&);
     ~Impl() override;
 
-    virtual void loadDescription(FileSource&) = 0;
-    bool isLoaded() const;
+    virtual void loadDescription(FileSource&, Scheduler&) = 0;
+    virtual bool isLoaded() const;
 
     // Called when the camera has changed. May load new tiles, unload obsolete tiles, or
     // trigger re-placement of existing complete tiles.
     void updateTiles(const UpdateParameters&);
 
+    // Uploads tiles that have data but have never been uploaded, as far as the scheduler's
+    // budget allows. Must be called before `updateTiles`, so that deferred tiles are
+    // replaced by parents or children.
+    void uploadTiles(UploadScheduler&, gl::Context&);
+
     // Called when icons or glyphs are loaded. Triggers further processing of tiles which
     // were waiting on such dependencies.
     void updateSymbolDependentTiles();
@@ -54,24 +73,82 @@ public:
     // Removes all tiles (by putting them into the cache).
     void removeTiles();
 
+    // Destroys the tiles that aren't complete, rather than caching them: their requests are
+    // cancelled and their workers stop.
+    void removeIncompleteTiles();
+
     // Request that all loaded tiles re-run the layout operation on the existing source
     // data with fresh style information.
     void reloadTiles();
 
-    void startRender(algorithm::ClipIDGenerator&,
-                     const mat4& projMatrix,
-                     const TransformState&);
+    // Assigns clip IDs to the used render tiles. They stay valid as long as the render tiles
+    // and their `used` flags.
+    void updateClipIDs(algorithm::ClipIDGenerator&);
+
+    void startRender(const mat4& projMatrix, const TransformState&);
     void finishRender(Painter&);
 
+    // Whether every used tile that is clipped is `clippedToExtent`, as updated by
+    // `updateClipIDs`.
+    bool tilesClippedToExtent() const;
+
     std::map<UnwrappedTileID, RenderTile>& getRenderTiles();
 
+    // Changes whenever the render tiles are replaced. While it stays the same, so do the
+    // `RenderTile` objects, and their `used` flags are kept from one frame to the next.
+    uint64_t getRenderTilesRevision() const {
+        return renderTilesRevision;
+    }
+
+    // Queries the render tiles as tasks of the group, and returns their features by layer
+    // ID, in the same order as if they had been queried one after another.
     std::unordered_map<std::string, std::vector<Feature>>
     queryRenderedFeatures(const ScreenLineString& geometry,
                           const TransformState& transformState,
-                          const QueryOptions& options) const;
-
-    void setCacheSize(size_t);
-    void onLowMemory();
+                          const QueryOptions& options,
+                          FeatureDetail,
+                          TaskGroup&) const;
+
+    // Queries the source layers of the render tiles as tasks of the group, and passes the
+    // features found in each tile to `chunk`, on the calling thread, in tile order.
+    void querySourceFeatures(const std::vector<std::string>& sourceLayers,
+                             const CompiledFilter&,
+                             const optional<LatLngBounds>&,
+                             TaskGroup&,
+                             const std::function<void (std::vector<Feature>)>& chunk) const;
+
+    // Bounds the bytes of the tiles kept for reuse, on top of the number of tiles that
+    // `updateTiles` derives from the viewport.
+    void setCacheBudget(size_t bytes);
+
+    // See `Map::setFeatureIndexing`; cached tiles are set as they are reused.
+    void setFeatureIndexing(bool);
+
+    // See `Source::setSimplificationTolerance`; cached tiles are set as they are reused.
+    void setSimplificationTolerance(float pixels);
+    float getSimplificationTolerance() const {
+        return simplificationTolerance;
+    }
+
+    // The bytes loaded for prefetched tiles since the last call; see
+    // `UpdateParameters::prefetchBytes`.
+    size_t takePrefetchedBytes();
+
+    // Frees what the uploaded buckets of all tiles, cached or not, keep on the CPU. Returns
+    // the bytes freed.
+    size_t releaseRetainedData();
+
+    // Adds the bytes freed at each level to `result`; see `MemoryPressure`.
+    void onMemoryPressure(MemoryPressure, MemoryPressureResult& result);
+
+    // What the source's tiles, cached or not, hold; see `Map::getMemoryStats`.
+    MemoryStats::Source getMemoryUsage() const;
+
+    // See `Source::getTileTimelines` and `Source::getTileLoadStats`.
+    std::vector<TileTimeline> getTileTimelines() const;
+    const TileLoadStats& getTileLoadStats() const {
+        return tileLoadStats;
+    }
 
     void setObserver(SourceObserver*);
     void dumpDebugLogs() const;
@@ -93,6 +170,7 @@ public:
 
 protected:
     void invalidateTiles();
+    void clearRenderTiles();
     void removeStaleTiles(const std::set<OverscaledTileID>&);
 
     Source& base;
@@ -100,6 +178,10 @@ protected:
     std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
     TileCache cache;
 
+    // Bumped whenever a tile is added or removed, or changes in a way that can change how
+    // `updateTiles` covers the ideal tiles: it loads, fails, or is uploaded.
+    uint64_t tilesRevision = 0;
+
 private:
     // TileObserver implementation.
     void onTileChanged(Tile&) override;
@@ -109,7 +191,34 @@ private:
     virtual Range<uint8_t> getZoomRange() = 0;
     virtual std::unique_ptr<Tile> createTile(const OverscaledTileID&, const UpdateParameters&) = 0;
 
+    // The tiles, hashed for the lookups of `updateRenderables`.
+    std::unordered_map<OverscaledTileID, Tile*> tileIndex;
+
+    bool featureIndexing = true;
+    float simplificationTolerance = 0;
+
+    // The prefetched tiles that were still loading at the last `updateTiles`. They are not
+    // waited for by `isLoaded`.
+    std::set<OverscaledTileID> prefetching;
+    size_t prefetchedBytes = 0;
+
+    // The last coverage of the ideal tiles, reused while neither they nor the tiles change.
+    struct Coverage {
+        std::vector<UnwrappedTileID> idealTiles;
+        int32_t tileZoom = 0;
+        Range<uint8_t> zoomRange { 0, 0 };
+        uint64_t tilesRevision = std::numeric_limits<uint64_t>::max();
+        std::vector<std::pair<Tile*, Resource::Necessity>> retainedTiles;
+    } coverage;
+
     std::map<UnwrappedTileID, RenderTile> renderTiles;
+    uint64_t renderTilesRevision = 0;
+
+    // Of the tiles rendered so far, as they're first drawn by `startRender`.
+    TileLoadStats tileLoadStats;
+
+    // The tiles chosen by the last `updateTiles`; kept to reuse its storage.
+    std::vector<std::pair<UnwrappedTileID, Tile*>> selectedTiles;
 };
 
 } // namespace style
@@ -0,0 +1,195 @@
+#include <mbgl/style/sources/geojson_cluster_index.hpp>
+#include <mbgl/math/clamp.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace mbgl {
+namespace style {
+
+namespace {
+
+double numericValue(const Value& value) {
+    return value.match(
+        [] (double number) { return number; },
+        [] (int64_t number) { return double(number); },
+        [] (uint64_t number) { return double(number); },
+        [] (const auto&) { return std::numeric_limits<double>::quiet_NaN(); });
+}
+
+double reduce(GeoJSONOptions::ClusterProperty::Operator op, double a, double b) {
+    if (std::isnan(a)) {
+        return b;
+    }
+    if (std::isnan(b)) {
+        return a;
+    }
+    switch (op) {
+    case GeoJSONOptions::ClusterProperty::Operator::Sum:
+        return a + b;
+    case GeoJSONOptions::ClusterProperty::Operator::Min:
+        return std::min(a, b);
+    case GeoJSONOptions::ClusterProperty::Operator::Max:
+        return std::max(a, b);
+    }
+    return a;
+}
+
+std::string abbreviate(uint32_t count) {
+    if (count >= 10000) {
+        return util::toString(uint32_t(std::round(count / 1000.0))) + "k";
+    }
+    if (count >= 1000) {
+        return util::toString(std::round(count / 100.0) / 10) + "k";
+    }
+    return util::toString(count);
+}
+
+} // namespace
+
+GeoJSONClusterIndex::GeoJSONClusterIndex(const FeatureCollection& features_, const GeoJSONOptions& options)
+    : maxZoom(options.clusterMaxZoom),
+      radius(std::round(util::EXTENT / util::tileSize * options.clusterRadius) / util::EXTENT),
+      properties(options.clusterProperties.begin(), options.clusterProperties.end()),
+      zooms(maxZoom + 2) {
+    Zoom& points = zooms[maxZoom + 1];
+    for (const auto& feature : features_) {
+        if (!feature.geometry.is<Point<double>>()) {
+            continue;
+        }
+
+        const auto& point = feature.geometry.get<Point<double>>();
+        const double sine = std::sin(point.y * M_PI / 180);
+        points.clusters.push_back({
+            point.x / 360 + 0.5,
+            util::clamp(0.5 - 0.25 * std::log((1 + sine) / (1 - sine)) / M_PI, 0.0, 1.0),
+            1,
+            features.size()
+        });
+
+        for (const auto& property : properties) {
+            const auto it = feature.properties.find(property.second.property);
+            points.values.push_back(it != feature.properties.end()
+                ? numericValue(it->second)
+                : std::numeric_limits<double>::quiet_NaN());
+        }
+        features.push_back(feature);
+    }
+
+    auto fill = [] (Zoom& zoom) {
+        std::vector<std::pair<double, double>> positions;
+        positions.reserve(zoom.clusters.size());
+        for (const auto& c : zoom.clusters) {
+            positions.emplace_back(c.x, c.y);
+        }
+        zoom.tree.fill(positions);
+    };
+
+    fill(points);
+    for (int z = maxZoom; z >= 0; z--) {
+        zooms[z] = cluster(zooms[z + 1], z);
+        fill(zooms[z]);
+    }
+}
+
+GeoJSONClusterIndex::Zoom GeoJSONClusterIndex::cluster(const Zoom& previous, uint8_t z) const {
+    const std::size_t propertyCount = properties.size();
+    const double r = radius / std::pow(2, z);
+
+    Zoom result;
+    std::vector<bool> visited(previous.clusters.size(), false);
+    for (std::size_t i = 0; i < previous.clusters.size(); ++i) {
+        if (visited[i]) {
+            continue;
+        }
+        visited[i] = true;
+
+        const Cluster& c = previous.clusters[i];
+        uint32_t pointCount = c.pointCount;
+        double x = c.x * pointCount;
+        double y = c.y * pointCount;
+        const std::size_t values = result.values.size();
+        result.values.insert(result.values.end(),
+                             previous.values.begin() + i * propertyCount,
+                             previous.values.begin() + (i + 1) * propertyCount);
+
+        previous.tree.within(c.x, c.y, r, [&] (const uint32_t id) {
+            if (visited[id]) {
+                return;
+            }
+            visited[id] = true;
+
+            const Cluster& neighbour = previous.clusters[id];
+            x += neighbour.x * neighbour.pointCount;
+            y += neighbour.y * neighbour.pointCount;
+            pointCount += neighbour.pointCount;
+            for (std::size_t p = 0; p < propertyCount; ++p) {
+                double& value = result.values[values + p];
+                value = reduce(properties[p].second.op, value, previous.values[id * propertyCount + p]);
+            }
+        });
+
+        result.clusters.push_back({ x / pointCount, y / pointCount, pointCount, c.feature });
+    }
+    return result;
+}
+
+mapbox::geometry::feature_collection<int16_t> GeoJSONClusterIndex::getTile(uint8_t z, uint32_t x, uint32_t y) const {
+    const Zoom& zoom = zooms[std::min<std::size_t>(z, maxZoom + 1)];
+    const double z2 = std::pow(2, z);
+    const double r = radius;
+    const double extent = util::EXTENT;
+
+    mapbox::geometry::feature_collection<int16_t> result;
+    // The tile the clusters are placed relative to, which is shifted a world over when
+    // looking across the antimeridian.
+    double tileX = x;
+
+    auto visitor = [&] (const uint32_t id) {
+        const Cluster& c = zoom.clusters[id];
+        const Point<int16_t> point {
+            int16_t(std::round(extent * (c.x * z2 - tileX))),
+            int16_t(std::round(extent * (c.y * z2 - y)))
+        };
+
+        if (c.pointCount == 1) {
+            const Feature& feature = features[c.feature];
+            result.push_back({ point, feature.properties, feature.id });
+            return;
+        }
+
+        PropertyMap clusterProperties {
+            { "cluster", true },
+            { "point_count", uint64_t(c.pointCount) },
+            { "point_count_abbreviated", abbreviate(c.pointCount) }
+        };
+        for (std::size_t p = 0; p < properties.size(); ++p) {
+            const double value = zoom.values[id * properties.size() + p];
+            if (!std::isnan(value)) {
+                clusterProperties.emplace(properties[p].first, value);
+            }
+        }
+        result.push_back({ point, std::move(clusterProperties), {} });
+    };
+
+    const double top = (y - r) / z2;
+    const double bottom = (y + 1 + r) / z2;
+    zoom.tree.range((x - r) / z2, top, (x + 1 + r) / z2, bottom, visitor);
+
+    if (x == 0) {
+        tileX = z2;
+        zoom.tree.range(1 - r / z2, top, 1, bottom, visitor);
+    }
+    if (x == z2 - 1) {
+        tileX = -1;
+        zoom.tree.range(0, top, r / z2, bottom, visitor);
+    }
+
+    return result;
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <mbgl/style/sources/geojson_source.hpp>
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <kdbush.hpp>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+/*
+    The clusters of the points of a GeoJSON source, at each zoom level up to the maximum
+    cluster zoom. The hierarchy is built the way Supercluster builds it: from the highest
+    zoom down, each cluster greedily takes in its neighbours within the cluster radius.
+    The cluster properties of the options are reduced along the way, so that each cluster
+    holds them for all of its points, and tiles get them without visiting the points.
+
+    Features other than points are left out.
+*/
+class GeoJSONClusterIndex : private util::noncopyable {
+public:
+    GeoJSONClusterIndex(const FeatureCollection&, const GeoJSONOptions&);
+
+    mapbox::geometry::feature_collection<int16_t> getTile(uint8_t z, uint32_t x, uint32_t y) const;
+
+private:
+    struct Cluster {
+        // In world coordinates, from 0 to 1.
+        double x;
+        double y;
+        uint32_t pointCount;
+        // The feature of the point, for clusters of a single point.
+        std::size_t feature;
+    };
+
+    struct Zoom {
+        std::vector<Cluster> clusters;
+        // The values of the cluster properties, for each cluster in turn; NaN where none
+        // of the points of a cluster have the property.
+        std::vector<double> values;
+        // Queries of KDBush aren't marked const.
+        mutable kdbush::KDBush<std::pair<double, double>, uint32_t> tree;
+    };
+
+    Zoom cluster(const Zoom&, uint8_t z) const;
+
+    FeatureCollection features;
+    const uint8_t maxZoom;
+    // Of the cluster radius to the tile extent.
+    const double radius;
+    std::vector<std::pair<std::string, GeoJSONOptions::ClusterProperty>> properties;
+
+    // By zoom level, from 0 to one beyond the maximum cluster zoom, which has every point.
+    std::vector<Zoom> zooms;
+};
+
+} // namespace style
+} // namespace mbgl
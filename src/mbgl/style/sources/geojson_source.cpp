@@ -18,6 +18,14 @@ void GeoJSONSource::setGeoJSON(const mapbox::geojson::geojson& geoJSON) {
     impl->setGeoJSON(geoJSON);
 }
 
+void GeoJSONSource::updateFeatures(const FeatureCollection& features) {
+    impl->updateFeatures(features, {});
+}
+
+void GeoJSONSource::removeFeatures(const std::vector<FeatureIdentifier>& ids) {
+    impl->updateFeatures({}, ids);
+}
+
 optional<std::string> GeoJSONSource::getURL() const {
     return impl->getURL();
 }
@@ -1,20 +1,19 @@
-#include <mbgl/util/logging.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/style/conversion/geojson.hpp>
 #include <mbgl/style/source_observer.hpp>
 #include <mbgl/style/sources/geojson_source_impl.hpp>
+#include <mbgl/style/sources/geojson_cluster_index.hpp>
 #include <mbgl/tile/geojson_tile.hpp>
 #include <mbgl/util/rapidjson.hpp>
+#include <mbgl/util/run_loop.hpp>
 
 #include <mapbox/geojson.hpp>
 #include <mapbox/geojson/rapidjson.hpp>
 #include <mapbox/geojsonvt.hpp>
 #include <mapbox/geojsonvt/convert.hpp>
-#include <supercluster.hpp>
 
-#include <rapidjson/error/en.h>
-
-#include <sstream>
+#include <algorithm>
+#include <cmath>
 
 namespace mbgl {
 namespace style {
@@ -54,57 +53,107 @@ optional<std::string> GeoJSONSource::Impl::getURL() const {
 
 void GeoJSONSource::Impl::setGeoJSON(const GeoJSON& geoJSON) {
     req.reset();
-    _setGeoJSON(geoJSON);
+
+    if (worker) {
+        resetCorrelationID = ++correlationID;
+        worker->invoke(&GeoJSONSourceWorker::index, geoJSON, correlationID);
+    } else {
+        pendingGeoJSON = geoJSON;
+        pendingUpdates.clear();
+    }
+}
+
+void GeoJSONSource::Impl::updateFeatures(FeatureCollection changed, std::vector<FeatureIdentifier> removed) {
+    if (worker) {
+        worker->invoke(&GeoJSONSourceWorker::update, std::move(changed), std::move(removed), ++correlationID);
+    } else {
+        pendingUpdates.emplace_back(std::move(changed), std::move(removed));
+    }
 }
 
-// Private implementation
-void GeoJSONSource::Impl::_setGeoJSON(const GeoJSON& geoJSON) {
-    double scale = util::EXTENT / util::tileSize;
+void GeoJSONSource::Impl::onIndexed(uint64_t correlationID_) {
+    if (correlationID_ < resetCorrelationID) {
+        return;
+    }
 
+    indexedCorrelationID = correlationID_;
+
+    // Tiles keep what they show until the features of the new data arrive.
     cache.clear();
+    for (auto const &item : tiles) {
+        requestTileData(*static_cast<GeoJSONTile*>(item.second.get()));
+    }
 
-    if (options.cluster
-        && geoJSON.is<mapbox::geometry::feature_collection<double>>()
-        && !geoJSON.get<mapbox::geometry::feature_collection<double>>().empty()) {
-        mapbox::supercluster::Options clusterOptions;
-        clusterOptions.maxZoom = options.clusterMaxZoom;
-        clusterOptions.extent = util::EXTENT;
-        clusterOptions.radius = std::round(scale * options.clusterRadius);
-
-        const auto& features = geoJSON.get<mapbox::geometry::feature_collection<double>>();
-        geoJSONOrSupercluster =
-            std::make_unique<mapbox::supercluster::Supercluster>(features, clusterOptions);
-    } else {
-        mapbox::geojsonvt::Options vtOptions;
-        vtOptions.maxZoom = options.maxzoom;
-        vtOptions.extent = util::EXTENT;
-        vtOptions.buffer = std::round(scale * options.buffer);
-        vtOptions.tolerance = scale * options.tolerance;
-        geoJSONOrSupercluster = std::make_unique<mapbox::geojsonvt::GeoJSONVT>(geoJSON, vtOptions);
+    loaded = true;
+    observer->onSourceLoaded(base);
+}
+
+void GeoJSONSource::Impl::onUpdated(std::vector<GeoJSONUpdateBox> affected, uint64_t correlationID_) {
+    if (correlationID_ < resetCorrelationID) {
+        return;
     }
 
+    indexedCorrelationID = correlationID_;
+
+    // Cached tiles may show the previous features anywhere.
+    cache.clear();
+
+    // A tile also carries the features within its buffer.
+    const double buffer = double(options.buffer) / util::tileSize;
+
     for (auto const &item : tiles) {
-        GeoJSONTile* geoJSONTile = static_cast<GeoJSONTile*>(item.second.get());
-        setTileData(*geoJSONTile, geoJSONTile->id);
+        const CanonicalTileID& id = item.first.canonical;
+        const double scale = std::pow(2.0, id.z);
+        const GeoJSONUpdateBox bounds {
+            { (id.x - buffer) / scale, (id.y - buffer) / scale },
+            { (id.x + 1 + buffer) / scale, (id.y + 1 + buffer) / scale }
+        };
+
+        const bool touched = std::any_of(affected.begin(), affected.end(), [&] (const GeoJSONUpdateBox& box) {
+            return box.min.x <= bounds.max.x && box.max.x >= bounds.min.x &&
+                   box.min.y <= bounds.max.y && box.max.y >= bounds.min.y;
+        });
+
+        if (touched) {
+            requestTileData(*static_cast<GeoJSONTile*>(item.second.get()));
+        }
     }
 }
 
-void GeoJSONSource::Impl::setTileData(GeoJSONTile& tile, const OverscaledTileID& tileID) {
-    if (geoJSONOrSupercluster.is<GeoJSONVTPointer>()) {
-        tile.updateData(geoJSONOrSupercluster.get<GeoJSONVTPointer>()->getTile(tileID.canonical.z,
-                                                                               tileID.canonical.x,
-                                                                               tileID.canonical.y).features);
-    } else {
-        assert(geoJSONOrSupercluster.is<SuperclusterPointer>());
-        tile.updateData(geoJSONOrSupercluster.get<SuperclusterPointer>()->getTile(tileID.canonical.z,
-                                                                                  tileID.canonical.x,
-                                                                                  tileID.canonical.y));
+void GeoJSONSource::Impl::onError(std::exception_ptr error, uint64_t correlationID_) {
+    if (correlationID_ < resetCorrelationID) {
+        return;
     }
+
+    indexedCorrelationID = correlationID_;
+    observer->onSourceError(base, error);
+}
+
+bool GeoJSONSource::Impl::isLoaded() const {
+    return indexedCorrelationID == correlationID && Source::Impl::isLoaded();
 }
 
-void GeoJSONSource::Impl::loadDescription(FileSource& fileSource) {
+void GeoJSONSource::Impl::loadDescription(FileSource& fileSource, Scheduler& scheduler) {
+    if (!worker) {
+        mailbox = std::make_shared<Mailbox>(*util::RunLoop::Get());
+        worker.emplace(scheduler, ActorRef<GeoJSONSource::Impl>(*this, mailbox), options);
+    }
+
+    if (pendingGeoJSON) {
+        resetCorrelationID = ++correlationID;
+        worker->invoke(&GeoJSONSourceWorker::index, std::move(*pendingGeoJSON), correlationID);
+        pendingGeoJSON = {};
+    }
+    for (auto& update : pendingUpdates) {
+        worker->invoke(&GeoJSONSourceWorker::update, std::move(update.first), std::move(update.second), ++correlationID);
+    }
+    pendingUpdates.clear();
+
     if (!url) {
-        loaded = true;
+        // Without data to wait for, the source is loaded, and empty.
+        if (indexedCorrelationID == correlationID) {
+            loaded = true;
+        }
         return;
     }
 
@@ -122,33 +171,8 @@ void GeoJSONSource::Impl::loadDescription(FileSource& fileSource) {
             observer->onSourceError(
                 base, std::make_exception_ptr(std::runtime_error("unexpectedly empty GeoJSON")));
         } else {
-            rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> d;
-            d.Parse<0>(res.data->c_str());
-
-            if (d.HasParseError()) {
-                std::stringstream message;
-                message << d.GetErrorOffset() << " - "
-                        << rapidjson::GetParseError_En(d.GetParseError());
-                observer->onSourceError(base,
-                                        std::make_exception_ptr(std::runtime_error(message.str())));
-                return;
-            }
-
-            invalidateTiles();
-
-            conversion::Result<GeoJSON> geoJSON = conversion::convertGeoJSON<JSValue>(d);
-            if (!geoJSON) {
-                Log::Error(Event::ParseStyle, "Failed to parse GeoJSON data: %s",
-                           geoJSON.error().message.c_str());
-                // Create an empty GeoJSON VT object to make sure we're not infinitely waiting for
-                // tiles to load.
-                _setGeoJSON(GeoJSON{ FeatureCollection{} });
-            } else {
-                _setGeoJSON(*geoJSON);
-            }
-
-            loaded = true;
-            observer->onSourceLoaded(base);
+            resetCorrelationID = ++correlationID;
+            worker->invoke(&GeoJSONSourceWorker::parse, res.data, correlationID);
         }
     });
 }
@@ -162,9 +186,13 @@ std::unique_ptr<Tile> GeoJSONSource::Impl::createTile(const OverscaledTileID& ti
                                                       const UpdateParameters& parameters) {
     assert(loaded);
     auto tilePointer = std::make_unique<GeoJSONTile>(tileID, base.getID(), parameters);
-    setTileData(*tilePointer.get(), tileID);
+    requestTileData(*tilePointer);
     return std::move(tilePointer);
 }
 
+void GeoJSONSource::Impl::requestTileData(GeoJSONTile& tile) {
+    worker->invoke(&GeoJSONSourceWorker::getTile, tile.id.canonical, tile.self());
+}
+
 } // namespace style
 } // namespace mbgl
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <mbgl/actor/actor.hpp>
 #include <mbgl/style/source_impl.hpp>
 #include <mbgl/style/sources/geojson_source.hpp>
+#include <mbgl/style/sources/geojson_source_worker.hpp>
 #include <mbgl/util/variant.hpp>
 #include <mbgl/tile/geojson_tile.hpp>
 
@@ -20,24 +22,47 @@ public:
     optional<std::string> getURL() const;
 
     void setGeoJSON(const GeoJSON&);
-    void setTileData(GeoJSONTile&, const OverscaledTileID& tileID);
+    void updateFeatures(FeatureCollection changed, std::vector<FeatureIdentifier> removed);
 
-    void loadDescription(FileSource&) final;
+    void loadDescription(FileSource&, Scheduler&) final;
+
+    // Also waits for the index of the latest data, so that a still image doesn't show
+    // the data it replaces.
+    bool isLoaded() const final;
 
     uint16_t getTileSize() const final {
         return util::tileSize;
     }
 
-private:
-    void _setGeoJSON(const GeoJSON&);
+    // Messages from the worker, which arrive in the order they were sent. Results for data
+    // that has since been replaced are dropped.
+    void onIndexed(uint64_t correlationID);
+    void onUpdated(std::vector<GeoJSONUpdateBox> affected, uint64_t correlationID);
+    void onError(std::exception_ptr, uint64_t correlationID);
 
+private:
     Range<uint8_t> getZoomRange() final;
     std::unique_ptr<Tile> createTile(const OverscaledTileID&, const UpdateParameters&) final;
 
+    // Asks the worker to slice the tile from the latest data; the features arrive later.
+    void requestTileData(GeoJSONTile&);
+
     GeoJSONOptions options;
     optional<std::string> url;
     std::unique_ptr<AsyncRequest> req;
-    variant<GeoJSONVTPointer, SuperclusterPointer> geoJSONOrSupercluster;
+
+    // The worker is started by the first `loadDescription`; data set before then waits
+    // here.
+    optional<GeoJSON> pendingGeoJSON;
+    std::vector<std::pair<FeatureCollection, std::vector<FeatureIdentifier>>> pendingUpdates;
+    std::shared_ptr<Mailbox> mailbox;
+    optional<Actor<GeoJSONSourceWorker>> worker;
+
+    // The latest message sent to the worker, the latest one that replaced all data, and
+    // the latest one the worker has answered.
+    uint64_t correlationID = 0;
+    uint64_t resetCorrelationID = 0;
+    uint64_t indexedCorrelationID = 0;
 };
 
 } // namespace style
@@ -0,0 +1,229 @@
+#include <mbgl/style/sources/geojson_source_worker.hpp>
+#include <mbgl/style/sources/geojson_cluster_index.hpp>
+#include <mbgl/style/sources/geojson_source_impl.hpp>
+#include <mbgl/style/conversion/geojson_reader.hpp>
+#include <mbgl/tile/geojson_tile.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/logging.hpp>
+#include <mbgl/util/projection.hpp>
+
+#include <mapbox/geojsonvt.hpp>
+#include <mapbox/geometry/envelope.hpp>
+
+#include <cassert>
+#include <cmath>
+
+namespace mbgl {
+namespace style {
+
+namespace {
+
+mapbox::geojsonvt::Options vtOptions(const GeoJSONOptions& options) {
+    const double scale = util::EXTENT / util::tileSize;
+
+    mapbox::geojsonvt::Options result;
+    result.maxZoom = options.maxzoom;
+    result.extent = util::EXTENT;
+    result.buffer = std::round(scale * options.buffer);
+    result.tolerance = scale * options.tolerance;
+    return result;
+}
+
+Point<double> projectToWorld(double latitude, double longitude) {
+    return Projection::project(LatLng(util::clamp(latitude, -util::LATITUDE_MAX, util::LATITUDE_MAX), longitude),
+                               1.0 / util::tileSize);
+}
+
+GeoJSONUpdateBox projectedEnvelope(const Feature& feature) {
+    const mapbox::geometry::box<double> box = mapbox::geometry::envelope(feature.geometry);
+
+    // North is up in latitude, but down in world coordinates.
+    return { projectToWorld(box.max.y, box.min.x), projectToWorld(box.min.y, box.max.x) };
+}
+
+} // namespace
+
+GeoJSONSourceWorker::GeoJSONSourceWorker(ActorRef<GeoJSONSourceWorker>,
+                                         ActorRef<GeoJSONSource::Impl> parent_,
+                                         GeoJSONOptions options_)
+    : parent(std::move(parent_)),
+      options(std::move(options_)) {
+}
+
+void GeoJSONSourceWorker::parse(std::shared_ptr<const std::string> data, uint64_t correlationID) {
+    optional<conversion::Result<GeoJSON>> geoJSON;
+    try {
+        geoJSON = conversion::parseGeoJSON(*data);
+    } catch (...) {
+        parent.invoke(&GeoJSONSource::Impl::onError, std::current_exception(), correlationID);
+        return;
+    }
+
+    if (!*geoJSON) {
+        Log::Error(Event::ParseStyle, "Failed to parse GeoJSON data: %s",
+                   geoJSON->error().message.c_str());
+        // Create an empty GeoJSON VT object to make sure we're not infinitely waiting for
+        // tiles to load.
+        index(GeoJSON{ FeatureCollection{} }, correlationID);
+    } else {
+        index(std::move(**geoJSON), correlationID);
+    }
+}
+
+void GeoJSONSourceWorker::index(GeoJSON geoJSON, uint64_t correlationID) {
+    // Updates replace features by identifier, so keep the data as a collection.
+    if (geoJSON.is<FeatureCollection>()) {
+        features = std::move(geoJSON.get<FeatureCollection>());
+    } else if (geoJSON.is<mapbox::geojson::feature>()) {
+        features = { std::move(geoJSON.get<mapbox::geojson::feature>()) };
+    } else {
+        features = { Feature { std::move(geoJSON.get<mapbox::geojson::geometry>()) } };
+    }
+
+    positions.clear();
+    changes.clear();
+    replaced.clear();
+    for (std::size_t i = 0; i < features.size(); ++i) {
+        if (features[i].id) {
+            positions.emplace(*features[i].id, i);
+        }
+    }
+
+    if (options.cluster && !features.empty()) {
+        geoJSONIndex = std::make_unique<GeoJSONClusterIndex>(features, options);
+    } else {
+        geoJSONIndex = std::make_shared<mapbox::geojsonvt::GeoJSONVT>(features, vtOptions(options));
+    }
+    overlay = {};
+
+    parent.invoke(&GeoJSONSource::Impl::onIndexed, correlationID);
+}
+
+void GeoJSONSourceWorker::update(FeatureCollection changed,
+                                 std::vector<FeatureIdentifier> removed,
+                                 uint64_t correlationID) {
+    std::vector<GeoJSONUpdateBox> affected;
+
+    auto current = [&] (const FeatureIdentifier& id) -> const Feature* {
+        auto change = changes.find(id);
+        if (change != changes.end()) {
+            return &change->second;
+        }
+        auto position = positions.find(id);
+        if (position != positions.end() && !replaced.count(id)) {
+            return &features[position->second];
+        }
+        return nullptr;
+    };
+
+    for (auto& feature : changed) {
+        if (!feature.id) {
+            Log::Warning(Event::General, "Ignoring a GeoJSON feature update without an identifier");
+            continue;
+        }
+
+        const FeatureIdentifier id = *feature.id;
+        if (const Feature* previous = current(id)) {
+            affected.push_back(projectedEnvelope(*previous));
+        }
+        affected.push_back(projectedEnvelope(feature));
+
+        if (positions.count(id)) {
+            replaced.insert(id);
+        }
+        changes[id] = std::move(feature);
+    }
+
+    for (const auto& id : removed) {
+        const Feature* previous = current(id);
+        if (!previous) {
+            continue;
+        }
+        affected.push_back(projectedEnvelope(*previous));
+
+        changes.erase(id);
+        if (positions.count(id)) {
+            replaced.insert(id);
+        }
+    }
+
+    // Clusters depend on every point around them, so they can't be patched. Otherwise,
+    // fold the overlay into a new full index once tiles spend more time merging it than
+    // a rebuild would save.
+    if (options.cluster || changes.size() + replaced.size() > features.size() / 4) {
+        rebuild(correlationID);
+        return;
+    }
+
+    overlay.replaced = replaced;
+    overlay.index = nullptr;
+    if (!changes.empty()) {
+        FeatureCollection collection;
+        collection.reserve(changes.size());
+        for (const auto& change : changes) {
+            collection.push_back(change.second);
+        }
+        overlay.index = std::make_shared<mapbox::geojsonvt::GeoJSONVT>(collection, vtOptions(options));
+    }
+
+    parent.invoke(&GeoJSONSource::Impl::onUpdated, std::move(affected), correlationID);
+}
+
+void GeoJSONSourceWorker::getTile(const CanonicalTileID& id, ActorRef<GeoJSONTile> tile) {
+    tile.invoke(&GeoJSONTile::onData, sliceTile(id));
+}
+
+std::shared_ptr<const mapbox::geometry::feature_collection<int16_t>>
+GeoJSONSourceWorker::sliceTile(const CanonicalTileID& id) {
+    if (geoJSONIndex.is<GeoJSONVTPointer>()) {
+        const auto& geoJSONVT = geoJSONIndex.get<GeoJSONVTPointer>();
+        if (!geoJSONVT) {
+            // The source was loaded without any data.
+            return std::make_shared<const mapbox::geometry::feature_collection<int16_t>>();
+        }
+
+        const auto& tileFeatures = geoJSONVT->getTile(id.z, id.x, id.y).features;
+        if (!overlay.index && overlay.replaced.empty()) {
+            // The tiles of the index stay where they are once sliced, and the index is only
+            // ever replaced as a whole, so the features are shared with it.
+            return std::shared_ptr<const mapbox::geometry::feature_collection<int16_t>>(geoJSONVT, &tileFeatures);
+        }
+
+        // Leave out the features that were replaced or removed since the index was built,
+        // and add the updated ones.
+        mapbox::geometry::feature_collection<int16_t> merged;
+        merged.reserve(tileFeatures.size());
+        for (const auto& feature : tileFeatures) {
+            if (!feature.id || !overlay.replaced.count(*feature.id)) {
+                merged.push_back(feature);
+            }
+        }
+        if (overlay.index) {
+            const auto& updated = overlay.index->getTile(id.z, id.x, id.y).features;
+            merged.insert(merged.end(), updated.begin(), updated.end());
+        }
+        return std::make_shared<const mapbox::geometry::feature_collection<int16_t>>(std::move(merged));
+    } else {
+        assert(geoJSONIndex.is<ClusterIndexPointer>());
+        return std::make_shared<const mapbox::geometry::feature_collection<int16_t>>(
+            geoJSONIndex.get<ClusterIndexPointer>()->getTile(id.z, id.x, id.y));
+    }
+}
+
+void GeoJSONSourceWorker::rebuild(uint64_t correlationID) {
+    FeatureCollection merged;
+    merged.reserve(features.size() + changes.size());
+    for (auto& feature : features) {
+        if (!feature.id || !replaced.count(*feature.id)) {
+            merged.push_back(std::move(feature));
+        }
+    }
+    for (auto& change : changes) {
+        merged.push_back(std::move(change.second));
+    }
+
+    index(GeoJSON { std::move(merged) }, correlationID);
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/style/sources/geojson_source.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/variant.hpp>
+
+#include <mapbox/geometry/box.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+class GeoJSONTile;
+
+namespace style {
+
+using GeoJSONIndex = variant<GeoJSONVTPointer, ClusterIndexPointer>;
+
+// The features added, replaced or removed by identifier since the last full index was
+// built. They are sliced into an index of their own, and tiles are served from both.
+struct GeoJSONOverlay {
+    GeoJSONVTPointer index;
+
+    // Identifiers of the features in the full index that were replaced or removed, and
+    // must be left out of its tiles.
+    std::set<FeatureIdentifier> replaced;
+};
+
+// An area touched by an update, in projected world coordinates from 0 to 1.
+using GeoJSONUpdateBox = mapbox::geometry::box<double>;
+
+// Parses the data of a GeoJSON source, builds its GeoJSON-VT or cluster index, and
+// slices the tiles of the source from it, all of which can take long enough to hold up
+// rendering. The worker owns the index; tiles are sliced in the order they're asked for,
+// so they always come from the latest data the worker has been sent before.
+class GeoJSONSourceWorker {
+public:
+    GeoJSONSourceWorker(ActorRef<GeoJSONSourceWorker>,
+                        ActorRef<GeoJSONSource::Impl>,
+                        GeoJSONOptions);
+
+    void parse(std::shared_ptr<const std::string> data, uint64_t correlationID);
+    void index(GeoJSON, uint64_t correlationID);
+
+    // Only re-slices the changed features, unless the overlay has grown large compared
+    // to the full index, or the source is clustered; the full index is rebuilt then.
+    void update(FeatureCollection changed, std::vector<FeatureIdentifier> removed, uint64_t correlationID);
+
+    // Sends the features of the tile to it.
+    void getTile(const CanonicalTileID&, ActorRef<GeoJSONTile>);
+
+private:
+    void rebuild(uint64_t correlationID);
+    std::shared_ptr<const mapbox::geometry::feature_collection<int16_t>> sliceTile(const CanonicalTileID&);
+
+    ActorRef<GeoJSONSource::Impl> parent;
+    const GeoJSONOptions options;
+
+    // The index of the latest data, and what was updated since it was built.
+    GeoJSONIndex geoJSONIndex;
+    GeoJSONOverlay overlay;
+
+    // The features of the full index, and the positions of those with an identifier.
+    FeatureCollection features;
+    std::map<FeatureIdentifier, std::size_t> positions;
+
+    // Features added or replaced since the full index was built.
+    std::map<FeatureIdentifier, Feature> changes;
+    std::set<FeatureIdentifier> replaced;
+};
+
+} // namespace style
+} // namespace mbgl
@@ -18,5 +18,21 @@ optional<std::string> VectorSource::getURL() const {
     }
 }
 
+void VectorSource::setTileDataShared(bool shared) {
+    impl->setTileDataShared(shared);
+}
+
+bool VectorSource::isTileDataShared() const {
+    return impl->isTileDataShared();
+}
+
+void VectorSource::setTileDataRetained(bool retained) {
+    impl->setTileDataRetained(retained);
+}
+
+bool VectorSource::isTileDataRetained() const {
+    return impl->isTileDataRetained();
+}
+
 } // namespace style
 } // namespace mbgl
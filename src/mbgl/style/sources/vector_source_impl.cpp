@@ -8,9 +8,22 @@ VectorSource::Impl::Impl(std::string id_, Source& base_, variant<std::string, Ti
     : TileSourceImpl(SourceType::Vector, std::move(id_), base_, std::move(urlOrTileset_), util::tileSize) {
 }
 
+void VectorSource::Impl::setTileDataShared(bool shared) {
+    if (shared != tileDataShared) {
+        tileDataShared = shared;
+        dataCache.reset();
+    }
+}
+
 std::unique_ptr<Tile> VectorSource::Impl::createTile(const OverscaledTileID& tileID,
                                                      const UpdateParameters& parameters) {
-    return std::make_unique<VectorTile>(tileID, base.getID(), parameters, tileset);
+    if (!dataCache) {
+        dataCache = tileDataShared ? VectorTileDataCache::shared(tileset)
+                                   : std::make_shared<VectorTileDataCache>();
+    }
+    auto tile = std::make_unique<VectorTile>(tileID, base.getID(), parameters, tileset, dataCache);
+    tile->setRetainsData(tileDataRetained);
+    return std::move(tile);
 }
 
 } // namespace style
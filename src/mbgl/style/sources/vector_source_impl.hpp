@@ -2,6 +2,7 @@
 
 #include <mbgl/style/sources/vector_source.hpp>
 #include <mbgl/style/tile_source_impl.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
 
 namespace mbgl {
 namespace style {
@@ -10,8 +11,26 @@ class VectorSource::Impl : public TileSourceImpl {
 public:
     Impl(std::string id, Source&, variant<std::string, Tileset>);
 
+    void setTileDataShared(bool);
+    bool isTileDataShared() const {
+        return tileDataShared;
+    }
+
+    void setTileDataRetained(bool retained) {
+        tileDataRetained = retained;
+    }
+    bool isTileDataRetained() const {
+        return tileDataRetained;
+    }
+
 private:
     std::unique_ptr<Tile> createTile(const OverscaledTileID&, const UpdateParameters&) final;
+
+    // Held by this source's tiles, and made for the first of them: a shared cache is found
+    // by the tileset, which may only be known once loaded.
+    std::shared_ptr<VectorTileDataCache> dataCache;
+    bool tileDataShared = false;
+    bool tileDataRetained = true;
 };
 
 } // namespace style
@@ -13,7 +13,9 @@
 #include <mbgl/style/layers/circle_layer.hpp>
 #include <mbgl/style/layers/raster_layer.hpp>
 #include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/parser.hpp>
+#include <mbgl/style/style_optimizer.hpp>
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/style/class_dictionary.hpp>
 #include <mbgl/style/update_parameters.hpp>
@@ -21,6 +23,7 @@
 #include <mbgl/style/property_evaluation_parameters.hpp>
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/text/glyph_cache.hpp>
 #include <mbgl/geometry/line_atlas.hpp>
 #include <mbgl/renderer/render_item.hpp>
 #include <mbgl/renderer/render_tile.hpp>
@@ -31,17 +34,22 @@
 #include <mbgl/util/math.hpp>
 #include <mbgl/math/minmax.hpp>
 #include <mbgl/map/query.hpp>
+#include <mbgl/actor/task_group.hpp>
 
 #include <algorithm>
+#include <atomic>
 
 namespace mbgl {
 namespace style {
 
 static Observer nullObserver;
 
-Style::Style(FileSource& fileSource_, float pixelRatio)
-    : fileSource(fileSource_),
-      glyphAtlas(std::make_unique<GlyphAtlas>(Size{ 2048, 2048 }, fileSource)),
+static std::atomic<uint64_t> renderDataRevision { 0 };
+
+Style::Style(Scheduler& scheduler_, FileSource& fileSource_, float pixelRatio)
+    : scheduler(scheduler_),
+      fileSource(fileSource_),
+      glyphAtlas(std::make_unique<GlyphAtlas>(Size{ 2048, 2048 }, fileSource, &GlyphCache::shared(), &scheduler)),
       spriteAtlas(std::make_unique<SpriteAtlas>(Size{ 1024, 1024 }, pixelRatio)),
       lineAtlas(std::make_unique<LineAtlas>(Size{ 256, 512 })),
       observer(&nullObserver) {
@@ -99,14 +107,32 @@ TransitionOptions Style::getTransitionOptions() const {
     return transitionOptions;
 }
 
+struct QueueSourceReloadVisitor {
+    UpdateBatch& updateBatch;
+
+    // No need to reload sources for these types; their visibility can change but
+    // they don't participate in layout.
+    void operator()(CustomLayer&) {}
+    void operator()(RasterLayer&) {}
+    void operator()(BackgroundLayer&) {}
+
+    template <class VectorLayer>
+    void operator()(VectorLayer& layer) {
+        updateBatch.sourceIDs.insert(layer.getSourceID());
+    }
+};
+
 void Style::setJSON(const std::string& json) {
     sources.clear();
     layers.clear();
+    sourceDefinitions.clear();
+    layerDefinitions.clear();
     classes.clear();
     transitionOptions = {};
     updateBatch = {};
+    ++renderOrderRevision;
 
-    Parser parser;
+    Parser parser { scheduler };
     auto error = parser.parse(json);
 
     if (error) {
@@ -116,6 +142,10 @@ void Style::setJSON(const std::string& json) {
         return;
     }
 
+    if (optimizeLayers) {
+        optimize(parser.layers, parser.sources);
+    }
+
     for (auto& source : parser.sources) {
         addSource(std::move(source));
     }
@@ -130,7 +160,12 @@ void Style::setJSON(const std::string& json) {
     defaultBearing = parser.bearing;
     defaultPitch = parser.pitch;
 
+    sourceDefinitions = std::move(parser.sourceDefinitions);
+    layerDefinitions = std::move(parser.layerDefinitions);
+    spriteURL = parser.spriteURL;
+
     glyphAtlas->setURL(parser.glyphURL);
+    glyphAtlas->prefetchGlyphRanges(parser.fontStacks());
     spriteAtlas->load(parser.spriteURL, fileSource);
 
     loaded = true;
@@ -138,6 +173,105 @@ void Style::setJSON(const std::string& json) {
     observer->onStyleLoaded();
 }
 
+static bool sameDefinition(const std::unordered_map<std::string, std::string>& definitions,
+                           const std::unordered_map<std::string, std::string>& nextDefinitions,
+                           const std::string& id) {
+    auto it = definitions.find(id);
+    auto next = nextDefinitions.find(id);
+    return it != definitions.end() && next != nextDefinitions.end() && it->second == next->second;
+}
+
+bool Style::updateJSON(const std::string& json) {
+    if (!loaded) {
+        return false;
+    }
+
+    Parser parser { scheduler };
+    if (parser.parse(json) || parser.glyphURL != glyphAtlas->getURL() || parser.spriteURL != spriteURL) {
+        return false;
+    }
+
+    classes.clear();
+    transitionOptions = {};
+    ++renderOrderRevision;
+
+    std::vector<std::unique_ptr<Source>> previousSources = std::move(sources);
+    sources.clear();
+
+    for (auto& source : parser.sources) {
+        auto it = std::find_if(previousSources.begin(), previousSources.end(), [&](const auto& previous) {
+            return previous && previous->getID() == source->getID();
+        });
+
+        if (it != previousSources.end() && sameDefinition(sourceDefinitions, parser.sourceDefinitions, source->getID())) {
+            sources.push_back(std::move(*it));
+        } else {
+            addSource(std::move(source));
+        }
+    }
+
+    for (auto& source : previousSources) {
+        if (!source) {
+            continue;
+        }
+        if (!sourceDefinitions.count(source->getID()) && !parser.sourceDefinitions.count(source->getID())) {
+            sources.push_back(std::move(source));
+        } else {
+            source->baseImpl->detach();
+        }
+    }
+
+    // Tiles are laid out again for the layers that changed, retaining the buckets of the others.
+    std::vector<std::unique_ptr<Layer>> previousLayers = std::move(layers);
+    layers.clear();
+
+    for (auto& layer : parser.layers) {
+        auto it = std::find_if(previousLayers.begin(), previousLayers.end(), [&](const auto& previous) {
+            return previous && previous->getID() == layer->getID();
+        });
+
+        if (it != previousLayers.end() && sameDefinition(layerDefinitions, parser.layerDefinitions, layer->getID())) {
+            layers.push_back(std::move(*it));
+        } else {
+            layer->accept(QueueSourceReloadVisitor { updateBatch });
+            addLayer(std::move(layer));
+        }
+    }
+
+    for (auto& layer : previousLayers) {
+        if (!layer) {
+            continue;
+        }
+        if (!layerDefinitions.count(layer->getID()) && !parser.layerDefinitions.count(layer->getID())) {
+            layers.push_back(std::move(layer));
+        } else {
+            layer->accept(QueueSourceReloadVisitor { updateBatch });
+            if (CustomLayer* customLayer = layer->as<CustomLayer>()) {
+                customLayer->impl->deinitialize();
+            }
+        }
+    }
+
+    // Again for the layers that were kept, whose sources may have changed.
+    if (optimizeLayers) {
+        optimize(layers, sources);
+    }
+
+    sourceDefinitions = std::move(parser.sourceDefinitions);
+    layerDefinitions = std::move(parser.layerDefinitions);
+
+    name = parser.name;
+    defaultLatLng = parser.latLng;
+    defaultZoom = parser.zoom;
+    defaultBearing = parser.bearing;
+    defaultPitch = parser.pitch;
+
+    glyphAtlas->prefetchGlyphRanges(parser.fontStacks());
+
+    observer->onStyleLoaded();
+    return true;
+}
+
 void Style::addSource(std::unique_ptr<Source> source) {
     // Guard against duplicate source ids
     auto it = std::find_if(sources.begin(), sources.end(), [&](const auto& existing) {
@@ -149,8 +283,19 @@ void Style::addSource(std::unique_ptr<Source> source) {
         throw std::runtime_error(msg.c_str());
     }
 
+    // Layers marked for the zoom levels of a source by that ID may render with this one.
+    for (const auto& layer : layers) {
+        if (layer->baseImpl->source == source->getID()) {
+            layer->baseImpl->rendersNothing = false;
+        }
+    }
+
     source->baseImpl->setObserver(this);
+    source->baseImpl->setCacheBudget(sourceTileCacheBudget);
+    source->baseImpl->setFeatureIndexing(featureIndexing);
+    sourceDefinitions.erase(source->getID());
     sources.emplace_back(std::move(source));
+    ++renderOrderRevision;
 }
 
 std::unique_ptr<Source> Style::removeSource(const std::string& id) {
@@ -164,7 +309,9 @@ std::unique_ptr<Source> Style::removeSource(const std::string& id) {
 
     auto source = std::move(*it);
     sources.erase(it);
+    sourceDefinitions.erase(id);
     updateBatch.sourceIDs.erase(id);
+    ++renderOrderRevision;
 
     source->baseImpl->detach();
     return source;
@@ -222,6 +369,8 @@ Layer* Style::addLayer(std::unique_ptr<Layer> layer, optional<std::string> befor
     }
 
     layer->baseImpl->setObserver(this);
+    layerDefinitions.erase(layer->getID());
+    ++renderOrderRevision;
 
     return layers.emplace(before ? findLayer(*before) : layers.end(), std::move(layer))->get();
 }
@@ -241,6 +390,8 @@ std::unique_ptr<Layer> Style::removeLayer(const std::string& id) {
     }
 
     layers.erase(it);
+    layerDefinitions.erase(id);
+    ++renderOrderRevision;
     return layer;
 }
 
@@ -272,13 +423,52 @@ void Style::updateTiles(const UpdateParameters& parameters) {
     }
 }
 
+void Style::uploadTiles(UploadScheduler& scheduler, gl::Context& context) {
+    for (const auto& source : sources) {
+        if (source->baseImpl->enabled) {
+            source->baseImpl->uploadTiles(scheduler, context);
+        }
+    }
+}
+
 void Style::updateSymbolDependentTiles() {
     for (const auto& source : sources) {
         source->baseImpl->updateSymbolDependentTiles();
     }
 }
 
+void Style::beginUpdateBatch() {
+    ++updateBatchDepth;
+}
+
+void Style::endUpdateBatch() {
+    if (!updateBatchDepth || --updateBatchDepth) {
+        return;
+    }
+
+    Update flags = batchedUpdate;
+    batchedUpdate = Update::Nothing;
+    if (!updateBatch.sourceIDs.empty()) {
+        flags |= Update::Layout;
+    }
+    if (flags != Update::Nothing) {
+        observer->onUpdate(flags);
+    }
+}
+
+void Style::update(Update flags) {
+    if (updateBatchDepth) {
+        batchedUpdate |= flags;
+    } else {
+        observer->onUpdate(flags);
+    }
+}
+
 void Style::relayout() {
+    if (updateBatchDepth) {
+        return;
+    }
+
     for (const auto& sourceID : updateBatch.sourceIDs) {
         Source* source = getSource(sourceID);
         if (source && source->baseImpl->enabled) {
@@ -307,6 +497,7 @@ void Style::cascade(const TimePoint& timePoint, MapMode mode) {
 
     for (const auto& layer : layers) {
         layer->baseImpl->cascade(parameters);
+        layer->baseImpl->invalidateEvaluation();
     }
 }
 
@@ -328,7 +519,8 @@ void Style::recalculate(float z, const TimePoint& timePoint, MapMode mode) {
 
     hasPendingTransitions = false;
     for (const auto& layer : layers) {
-        const bool hasTransitions = layer->baseImpl->evaluate(parameters);
+        // Repaints for other reasons, like moving annotations, leave most layers as they were.
+        const bool hasTransitions = layer->baseImpl->reevaluate(parameters);
 
         // Disable this layer if it doesn't need to be rendered.
         const bool needsRendering = layer->baseImpl->needsRendering(zoomHistory.lastZoom);
@@ -342,7 +534,7 @@ void Style::recalculate(float z, const TimePoint& timePoint, MapMode mode) {
         if (Source* source = getSource(layer->baseImpl->source)) {
             source->baseImpl->enabled = true;
             if (!source->baseImpl->loaded) {
-                source->baseImpl->loadDescription(fileSource);
+                source->baseImpl->loadDescription(fileSource, scheduler);
             }
         }
     }
@@ -403,38 +595,83 @@ bool Style::isLoaded() const {
     return true;
 }
 
-RenderData Style::getRenderData(MapDebugOptions debugOptions, float angle) const {
-    RenderData result;
+bool Style::RenderOrderKey::operator==(const RenderOrderKey& rhs) const {
+    return revision == rhs.revision &&
+           sources == rhs.sources &&
+           layers == rhs.layers &&
+           angle == rhs.angle &&
+           overdraw == rhs.overdraw;
+}
+
+const RenderData& Style::getRenderData(MapDebugOptions debugOptions, float angle) const {
+    RenderOrderKey& key = nextRenderOrderKey;
+    key.revision = renderOrderRevision;
+    key.angle = angle;
+    key.overdraw = debugOptions & MapDebugOptions::Overdraw;
 
+    key.sources.clear();
     for (const auto& source : sources) {
-        if (source->baseImpl->enabled) {
-            result.sources.insert(source.get());
-        }
+        key.sources.emplace_back(source->baseImpl->enabled, source->baseImpl->getRenderTilesRevision());
     }
 
+    // Background paint properties may be transitioning, so the clear color is evaluated
+    // every frame.
+    Color backgroundColor;
+    key.layers.clear();
     for (const auto& layer : layers) {
+        RenderLayerMode mode = RenderLayerMode::Ordered;
         if (!layer->baseImpl->needsRendering(zoomHistory.lastZoom)) {
-            continue;
-        }
-
-        if (const BackgroundLayer* background = layer->as<BackgroundLayer>()) {
-            if (debugOptions & MapDebugOptions::Overdraw) {
-                // We want to skip glClear optimization in overdraw mode.
-                result.order.emplace_back(*layer);
-                continue;
-            }
+            mode = RenderLayerMode::Skipped;
+        } else if (const BackgroundLayer* background = layer->as<BackgroundLayer>()) {
+            // We want to skip glClear optimization in overdraw mode.
             const BackgroundPaintProperties::Evaluated& paint = background->impl->paint.evaluated;
-            if (layer.get() == layers[0].get() && paint.get<BackgroundPattern>().from.empty()) {
+            if (!key.overdraw && layer.get() == layers[0].get() && paint.get<BackgroundPattern>().from.empty()) {
                 // This is a solid background. We can use glClear().
-                result.backgroundColor = paint.get<BackgroundColor>() * paint.get<BackgroundOpacity>();
-            } else {
-                // This is a textured background, or not the bottommost layer. We need to render it with a quad.
-                result.order.emplace_back(*layer);
+                mode = RenderLayerMode::Cleared;
+                backgroundColor = paint.get<BackgroundColor>() * paint.get<BackgroundOpacity>();
             }
+        }
+        key.layers.push_back(mode);
+    }
+
+    if (!renderData || !(key == renderOrderKey)) {
+        std::swap(renderOrderKey, nextRenderOrderKey);
+        if (!renderData) {
+            renderData = std::make_unique<RenderData>();
+        }
+        buildRenderOrder(*renderData);
+        renderData->revision = ++renderDataRevision;
+    }
+
+    renderData->backgroundColor = backgroundColor;
+    return *renderData;
+}
+
+void Style::buildRenderOrder(RenderData& result) const {
+    const float angle = renderOrderKey.angle;
+
+    result.sources.clear();
+    result.order.clear();
+
+    for (const auto& source : sources) {
+        if (source->baseImpl->enabled) {
+            result.sources.insert(source.get());
+        }
+
+        // Render tiles may be kept from one order to the next.
+        for (auto& pair : source->baseImpl->getRenderTiles()) {
+            pair.second.used = false;
+        }
+    }
+
+    for (std::size_t i = 0; i < layers.size(); ++i) {
+        const auto& layer = layers[i];
+        const RenderLayerMode mode = renderOrderKey.layers[i];
+        if (mode != RenderLayerMode::Ordered) {
             continue;
         }
 
-        if (layer->is<CustomLayer>()) {
+        if (layer->is<BackgroundLayer>() || layer->is<CustomLayer>()) {
             result.order.emplace_back(*layer);
             continue;
         }
@@ -499,13 +736,35 @@ RenderData Style::getRenderData(MapDebugOptions debugOptions, float angle) const
             }
         }
     }
-
-    return result;
 }
 
 std::vector<Feature> Style::queryRenderedFeatures(const ScreenLineString& geometry,
                                                   const TransformState& transformState,
                                                   const QueryOptions& options) const {
+    std::vector<Feature> result;
+    for (auto& layerResult : queryRenderedFeaturesByLayer(geometry, transformState, options, FeatureDetail::Full)) {
+        std::move(layerResult.second.begin(), layerResult.second.end(), std::back_inserter(result));
+    }
+    return result;
+}
+
+std::vector<RenderedFeatureID> Style::queryRenderedFeatureIDs(const ScreenLineString& geometry,
+                                                              const TransformState& transformState,
+                                                              const QueryOptions& options) const {
+    std::vector<RenderedFeatureID> result;
+    for (auto& layerResult : queryRenderedFeaturesByLayer(geometry, transformState, options, FeatureDetail::ID)) {
+        for (auto& feature : layerResult.second) {
+            result.push_back({ layerResult.first->getID(), std::move(feature.id) });
+        }
+    }
+    return result;
+}
+
+std::vector<std::pair<const Layer*, std::vector<Feature>>>
+Style::queryRenderedFeaturesByLayer(const ScreenLineString& geometry,
+                                    const TransformState& transformState,
+                                    const QueryOptions& options,
+                                    FeatureDetail detail) const {
     std::unordered_set<std::string> sourceFilter;
 
     if (options.layerIDs) {
@@ -515,15 +774,17 @@ std::vector<Feature> Style::queryRenderedFeatures(const ScreenLineString& geomet
         }
     }
 
-    std::vector<Feature> result;
+    std::vector<std::pair<const Layer*, std::vector<Feature>>> result;
     std::unordered_map<std::string, std::vector<Feature>> resultsByLayer;
 
+    TaskGroup tasks { scheduler };
+
     for (const auto& source : sources) {
         if (!sourceFilter.empty() && sourceFilter.find(source->getID()) == sourceFilter.end()) {
             continue;
         }
 
-        auto sourceResults = source->baseImpl->queryRenderedFeatures(geometry, transformState, options);
+        auto sourceResults = source->baseImpl->queryRenderedFeatures(geometry, transformState, options, detail, tasks);
         std::move(sourceResults.begin(), sourceResults.end(), std::inserter(resultsByLayer, resultsByLayer.begin()));
     }
 
@@ -538,13 +799,40 @@ std::vector<Feature> Style::queryRenderedFeatures(const ScreenLineString& geomet
         }
         auto it = resultsByLayer.find(layer->baseImpl->id);
         if (it != resultsByLayer.end()) {
-            std::move(it->second.begin(), it->second.end(), std::back_inserter(result));
+            result.emplace_back(layer.get(), std::move(it->second));
         }
     }
 
     return result;
 }
 
+void Style::querySourceFeatures(const std::string& sourceID,
+                                const SourceQueryOptions& options,
+                                const std::function<void (std::vector<Feature>)>& chunk) const {
+    const Source* source = getSource(sourceID);
+    if (!source) {
+        return;
+    }
+
+    std::vector<std::string> sourceLayers;
+    if (options.sourceLayers) {
+        sourceLayers = *options.sourceLayers;
+    } else {
+        for (const auto& layer : layers) {
+            const std::string& sourceLayer = layer->baseImpl->sourceLayer;
+            if (layer->baseImpl->source == sourceID &&
+                std::find(sourceLayers.begin(), sourceLayers.end(), sourceLayer) == sourceLayers.end()) {
+                sourceLayers.push_back(sourceLayer);
+            }
+        }
+    }
+
+    const CompiledFilter filter = options.filter ? CompiledFilter(*options.filter) : CompiledFilter();
+
+    TaskGroup tasks { scheduler };
+    source->baseImpl->querySourceFeatures(sourceLayers, filter, options.bounds, tasks, chunk);
+}
+
 float Style::getQueryRadius() const {
     float additionalRadius = 0;
     for (auto& layer : layers) {
@@ -557,16 +845,61 @@ float Style::getQueryRadius() const {
 }
 
 
-void Style::setSourceTileCacheSize(size_t size) {
+void Style::setSourceTileCacheBudget(size_t bytes) {
+    sourceTileCacheBudget = bytes;
+    for (const auto& source : sources) {
+        source->baseImpl->setCacheBudget(bytes);
+    }
+}
+
+void Style::setFeatureIndexing(bool enabled) {
+    featureIndexing = enabled;
+    for (const auto& source : sources) {
+        source->baseImpl->setFeatureIndexing(enabled);
+    }
+}
+
+size_t Style::takePrefetchedBytes() {
+    size_t result = 0;
+    for (const auto& source : sources) {
+        result += source->baseImpl->takePrefetchedBytes();
+    }
+    return result;
+}
+
+void Style::releaseRetainedData() {
+    for (const auto& source : sources) {
+        source->baseImpl->releaseRetainedData();
+    }
+}
+
+void Style::cancelLoading() {
+    for (const auto& source : sources) {
+        source->baseImpl->removeIncompleteTiles();
+    }
+    glyphAtlas->cancelPendingGlyphRanges();
+}
+
+void Style::onMemoryPressure(MemoryPressure level, MemoryPressureResult& result) {
     for (const auto& source : sources) {
-        source->baseImpl->setCacheSize(size);
+        source->baseImpl->onMemoryPressure(level, result);
+    }
+
+    if (level >= MemoryPressure::High) {
+        ShapingCache& shapingCache = glyphAtlas->getShapingCache();
+        result.shapingCache += shapingCache.getSize();
+        shapingCache.clear();
     }
 }
 
-void Style::onLowMemory() {
+void Style::addMemoryUsage(MemoryStats& stats) const {
     for (const auto& source : sources) {
-        source->baseImpl->onLowMemory();
+        stats.sources[source->getID()] = source->baseImpl->getMemoryUsage();
     }
+    stats.glyphAtlas = glyphAtlas->getMemoryUsage();
+    stats.spriteAtlas = spriteAtlas->getMemoryUsage();
+    stats.lineAtlas = lineAtlas->getMemoryUsage();
+    stats.shapingCacheBytes = glyphAtlas->getShapingCache().getSize();
 }
 
 void Style::setObserver(style::Observer* observer_) {
@@ -606,16 +939,19 @@ void Style::onSourceError(Source& source, std::exception_ptr error) {
 void Style::onSourceDescriptionChanged(Source& source) {
     observer->onSourceDescriptionChanged(source);
     if (!source.baseImpl->loaded) {
-        source.baseImpl->loadDescription(fileSource);
+        source.baseImpl->loadDescription(fileSource, scheduler);
     }
 }
 
 void Style::onTileChanged(Source& source, const OverscaledTileID& tileID) {
+    // The tile's buckets may have been replaced.
+    ++renderOrderRevision;
+    // The observer decides when to repaint for it.
     observer->onTileChanged(source, tileID);
-    observer->onUpdate(Update::Repaint);
 }
 
 void Style::onTileError(Source& source, const OverscaledTileID& tileID, std::exception_ptr error) {
+    ++renderOrderRevision;
     lastError = error;
     Log::Error(Event::Style, "Failed to load tile %s for source %s: %s",
                util::toString(tileID).c_str(), source.getID().c_str(), util::toString(error).c_str());
@@ -636,51 +972,48 @@ void Style::onSpriteError(std::exception_ptr error) {
     observer->onResourceError(error);
 }
 
-struct QueueSourceReloadVisitor {
-    UpdateBatch& updateBatch;
-
-    // No need to reload sources for these types; their visibility can change but
-    // they don't participate in layout.
-    void operator()(CustomLayer&) {}
-    void operator()(RasterLayer&) {}
-    void operator()(BackgroundLayer&) {}
-
-    template <class VectorLayer>
-    void operator()(VectorLayer& layer) {
-        updateBatch.sourceIDs.insert(layer.getSourceID());
-    }
-};
-
 void Style::onLayerFilterChanged(Layer& layer) {
+    layer.baseImpl->bumpRevision();
+    layerDefinitions.erase(layer.getID());
     layer.accept(QueueSourceReloadVisitor { updateBatch });
-    observer->onUpdate(Update::Layout);
+    update(Update::Layout);
 }
 
 void Style::onLayerVisibilityChanged(Layer& layer) {
+    layer.baseImpl->bumpRevision();
+    layerDefinitions.erase(layer.getID());
     layer.accept(QueueSourceReloadVisitor { updateBatch });
-    observer->onUpdate(Update::RecalculateStyle | Update::Layout);
+    update(Update::RecalculateStyle | Update::Layout);
 }
 
-void Style::onLayerPaintPropertyChanged(Layer&) {
-    observer->onUpdate(Update::RecalculateStyle | Update::Classes);
+void Style::onLayerPaintPropertyChanged(Layer& layer) {
+    // Doesn't require a relayout by itself, but a bucket built with a data-driven value
+    // must not be retained by the next one.
+    layer.baseImpl->bumpRevision();
+    layerDefinitions.erase(layer.getID());
+    update(Update::RecalculateStyle | Update::Classes);
 }
 
 void Style::onLayerDataDrivenPaintPropertyChanged(Layer& layer) {
+    layer.baseImpl->bumpRevision();
+    layerDefinitions.erase(layer.getID());
     layer.accept(QueueSourceReloadVisitor { updateBatch });
-    observer->onUpdate(Update::RecalculateStyle | Update::Classes | Update::Layout);
+    update(Update::RecalculateStyle | Update::Classes | Update::Layout);
 }
 
 void Style::onLayerLayoutPropertyChanged(Layer& layer, const char * property) {
+    layer.baseImpl->bumpRevision();
+    layerDefinitions.erase(layer.getID());
     layer.accept(QueueSourceReloadVisitor { updateBatch });
 
-    auto update = Update::Layout;
+    auto flags = Update::Layout;
 
     // Recalculate the style for certain properties
     bool needsRecalculation = strcmp(property, "icon-size") == 0 || strcmp(property, "text-size") == 0;
     if (needsRecalculation) {
-        update |= Update::RecalculateStyle;
+        flags |= Update::RecalculateStyle;
     }
-    observer->onUpdate(update);
+    update(flags);
 }
 
 void Style::dumpDebugLogs() const {
@@ -689,6 +1022,7 @@ void Style::dumpDebugLogs() const {
     }
 
     spriteAtlas->dumpDebugLogs();
+    lineAtlas->dumpDebugLogs();
 }
 
 } // namespace style
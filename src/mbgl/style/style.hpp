@@ -17,19 +17,35 @@
 #include <mbgl/util/geo.hpp>
 
 #include <cstdint>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace mbgl {
 
 class FileSource;
+class Scheduler;
+class UploadScheduler;
 class GlyphAtlas;
 class SpriteAtlas;
 class LineAtlas;
+class LayoutCache;
+class LayerProfiler;
+class MemoryStats;
 class RenderData;
 class TransformState;
 class QueryOptions;
+class SourceQueryOptions;
+class RenderedFeatureID;
+enum class FeatureDetail : bool;
+
+namespace gl {
+class Context;
+} // namespace gl
 
 namespace style {
 
@@ -43,11 +59,18 @@ class Style : public GlyphAtlasObserver,
               public LayerObserver,
               public util::noncopyable {
 public:
-    Style(FileSource&, float pixelRatio);
+    Style(Scheduler&, FileSource&, float pixelRatio);
     ~Style() override;
 
     void setJSON(const std::string&);
 
+    // Updates a loaded style to another one, keeping the sources and layers whose definitions
+    // are the same in both, with their tiles and buckets. Sources and layers that weren't
+    // loaded from a style, like those of annotations, are kept too. Returns false, changing
+    // nothing, if the style doesn't parse or loads its glyphs or sprite from other URLs;
+    // `setJSON` then loads it into a new `Style`.
+    bool updateJSON(const std::string&);
+
     void setObserver(Observer*);
 
     bool isLoaded() const;
@@ -56,6 +79,15 @@ public:
     // a tile is ready so observers can render the tile.
     void updateTiles(const UpdateParameters&);
 
+    // Uploads newly loaded tiles within the scheduler's budget; see `UploadScheduler`.
+    void uploadTiles(UploadScheduler&, gl::Context&);
+
+    // Holds back the updates that layer changes request until the batch ends, and then
+    // requests them once: changes made in between are laid out together, even if tiles are
+    // laid out for other reasons meanwhile. Batches nest.
+    void beginUpdateBatch();
+    void endUpdateBatch();
+
     void relayout();
     void cascade(const TimePoint&, MapMode);
     void recalculate(float z, const TimePoint&, MapMode);
@@ -95,30 +127,73 @@ public:
     bool hasClass(const std::string&) const;
     std::vector<std::string> getClasses() const;
 
-    RenderData getRenderData(MapDebugOptions, float angle) const;
+    // The render order is rebuilt only when the layers, the sources or their render tiles
+    // have changed since the last call; the result stays valid until the next one.
+    const RenderData& getRenderData(MapDebugOptions, float angle) const;
 
     std::vector<Feature> queryRenderedFeatures(const ScreenLineString& geometry,
                                                const TransformState& transformState,
                                                const QueryOptions& options) const;
+    std::vector<RenderedFeatureID> queryRenderedFeatureIDs(const ScreenLineString& geometry,
+                                                           const TransformState& transformState,
+                                                           const QueryOptions& options) const;
+    void querySourceFeatures(const std::string& sourceID,
+                             const SourceQueryOptions& options,
+                             const std::function<void (std::vector<Feature>)>& chunk) const;
                   
     float getQueryRadius() const;
 
-    void setSourceTileCacheSize(size_t);
-    void onLowMemory();
+    // Applies to every source, including those added later.
+    void setSourceTileCacheBudget(size_t bytes);
+    void setFeatureIndexing(bool);
+
+    // Summed over the sources; see `Source::Impl::takePrefetchedBytes`.
+    size_t takePrefetchedBytes();
+
+    // See `Source::Impl::releaseRetainedData`.
+    void releaseRetainedData();
+
+    // Drops the tiles and glyph ranges that are still loading, cancelling their requests and
+    // the work their workers have left.
+    void cancelLoading();
+
+    // Adds the bytes freed at each level to `result`; see `MemoryPressure`. The response
+    // cache is up to the file source.
+    void onMemoryPressure(MemoryPressure, MemoryPressureResult& result);
+
+    // Fills in all but the file source's cache; see `Map::getMemoryStats`.
+    void addMemoryUsage(MemoryStats&) const;
 
     void dumpDebugLogs() const;
 
+    Scheduler& scheduler;
     FileSource& fileSource;
     std::unique_ptr<GlyphAtlas> glyphAtlas;
     std::unique_ptr<SpriteAtlas> spriteAtlas;
     std::unique_ptr<LineAtlas> lineAtlas;
 
+    // Given to the tiles that are created while they are set.
+    std::shared_ptr<LayoutCache> layoutCache;
+    std::shared_ptr<LayerProfiler> layerProfiler;
+
+    // Whether `setJSON` and `updateJSON` run the optimizer on the styles they load; see
+    // `optimize`.
+    bool optimizeLayers = false;
+
 private:
     std::vector<std::unique_ptr<Source>> sources;
+    size_t sourceTileCacheBudget = std::numeric_limits<size_t>::max();
+    bool featureIndexing = true;
     std::vector<std::unique_ptr<Layer>> layers;
     std::vector<std::string> classes;
     TransitionOptions transitionOptions;
 
+    // The definitions of the sources and layers loaded from the JSON, kept as long as they
+    // aren't changed after; see `Parser`.
+    std::unordered_map<std::string, std::string> sourceDefinitions;
+    std::unordered_map<std::string, std::string> layerDefinitions;
+    std::string spriteURL;
+
     // Defaults
     std::string name;
     LatLng defaultLatLng;
@@ -126,6 +201,40 @@ private:
     double defaultBearing = 0;
     double defaultPitch = 0;
 
+    enum class RenderLayerMode : uint8_t {
+        Skipped,
+        Ordered,
+        // A solid background drawn by clearing the framebuffer.
+        Cleared,
+    };
+
+    // Everything the render order depends on, other than the buckets of the render tiles;
+    // changes to those bump `renderOrderRevision`.
+    struct RenderOrderKey {
+        uint64_t revision = 0;
+        std::vector<std::pair<bool, uint64_t>> sources;
+        std::vector<RenderLayerMode> layers;
+        float angle = 0;
+        bool overdraw = false;
+
+        bool operator==(const RenderOrderKey&) const;
+    };
+
+    uint64_t renderOrderRevision = 0;
+    mutable RenderOrderKey renderOrderKey;
+    mutable RenderOrderKey nextRenderOrderKey;
+    mutable std::unique_ptr<RenderData> renderData;
+
+    // Rebuilds the render order for `renderOrderKey`.
+    void buildRenderOrder(RenderData&) const;
+
+    // The features found by a query, by layer, in the style layer order.
+    std::vector<std::pair<const Layer*, std::vector<Feature>>>
+    queryRenderedFeaturesByLayer(const ScreenLineString& geometry,
+                                 const TransformState& transformState,
+                                 const QueryOptions& options,
+                                 FeatureDetail) const;
+
     std::vector<std::unique_ptr<Layer>>::const_iterator findLayer(const std::string& layerID) const;
     void reloadLayerSource(Layer&);
     void updateSymbolDependentTiles();
@@ -159,6 +268,11 @@ private:
     std::exception_ptr lastError;
 
     UpdateBatch updateBatch;
+    std::size_t updateBatchDepth = 0;
+    Update batchedUpdate = Update::Nothing;
+
+    // Requests an update from the observer, unless a batch holds it back.
+    void update(Update);
     ZoomHistory zoomHistory;
     bool hasPendingTransitions = false;
 
@@ -0,0 +1,186 @@
+#include <mbgl/style/style_optimizer.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/source_impl.hpp>
+#include <mbgl/style/tile_source_impl.hpp>
+#include <mbgl/style/layers/background_layer_impl.hpp>
+#include <mbgl/style/layers/circle_layer_impl.hpp>
+#include <mbgl/style/layers/custom_layer.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer_impl.hpp>
+#include <mbgl/style/layers/fill_layer_impl.hpp>
+#include <mbgl/style/layers/line_layer_impl.hpp>
+#include <mbgl/style/layers/raster_layer_impl.hpp>
+#include <mbgl/style/layers/symbol_layer_impl.hpp>
+#include <mbgl/util/ignore.hpp>
+#include <mbgl/util/tile_cover.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mbgl {
+namespace style {
+
+namespace {
+
+// The value a camera function takes at every zoom level, if its stops all have the same one.
+template <class T>
+optional<T> constantValue(const CameraFunction<T>& function) {
+    return function.stops.match([&] (const auto& s) -> optional<T> {
+        if (s.stops.empty()) {
+            return {};
+        }
+        const T& first = s.stops.begin()->second;
+        for (const auto& stop : s.stops) {
+            if (!(stop.second == first)) {
+                return {};
+            }
+        }
+        return first;
+    });
+}
+
+template <class Value>
+class FoldConstants {
+public:
+    std::size_t& folded;
+
+    Value operator()(const Undefined&) const {
+        return {};
+    }
+
+    template <class T>
+    Value operator()(const CameraFunction<T>& function) const {
+        if (optional<T> constant = constantValue(function)) {
+            ++folded;
+            return *constant;
+        }
+        return function;
+    }
+
+    template <class Other>
+    Value operator()(const Other& value) const {
+        return value;
+    }
+};
+
+template <class Value>
+Value foldValue(const Value& value, std::size_t& folded) {
+    return value.evaluate(FoldConstants<Value> { folded });
+}
+
+template <class... Ps>
+void foldConstants(LayoutProperties<Ps...>& properties, std::size_t& folded) {
+    util::ignore({ (properties.unevaluated.template get<Ps>() =
+        foldValue(properties.unevaluated.template get<Ps>(), folded), 0)... });
+}
+
+// Of every class.
+template <class Value>
+void foldValues(CascadingPaintProperty<Value>& property, std::size_t& folded) {
+    property.transformValues([&] (const Value& value) {
+        return foldValue(value, folded);
+    });
+}
+
+template <class... Ps>
+void foldConstants(PaintProperties<Ps...>& properties, std::size_t& folded) {
+    util::ignore({ (foldValues(properties.cascading.template get<Ps>(), folded), 0)... });
+}
+
+struct FoldConstantsVisitor {
+    std::size_t& folded;
+
+    void operator()(CustomLayer&) {}
+
+    void operator()(LineLayer& layer) {
+        foldConstants(layer.impl->layout, folded);
+        foldConstants(layer.impl->paint, folded);
+    }
+
+    void operator()(SymbolLayer& layer) {
+        foldConstants(layer.impl->layout, folded);
+        foldConstants(layer.impl->paint, folded);
+    }
+
+    template <class OtherLayer>
+    void operator()(OtherLayer& layer) {
+        foldConstants(layer.impl->paint, folded);
+    }
+};
+
+bool matchesNothing(const Filter&);
+
+bool matchesEverything(const Filter& filter) {
+    return filter.match(
+        [] (const NullFilter&) { return true; },
+        [] (const AllFilter& all) {
+            return std::all_of(all.filters.begin(), all.filters.end(), matchesEverything);
+        },
+        [] (const AnyFilter& any) {
+            return std::any_of(any.filters.begin(), any.filters.end(), matchesEverything);
+        },
+        [] (const NoneFilter& none) {
+            return std::all_of(none.filters.begin(), none.filters.end(), matchesNothing);
+        },
+        [] (const auto&) { return false; });
+}
+
+// Conservatively: a filter for which this is false may still match nothing.
+bool matchesNothing(const Filter& filter) {
+    return filter.match(
+        [] (const InFilter& in) { return in.values.empty(); },
+        [] (const TypeInFilter& in) { return in.values.empty(); },
+        [] (const IdentifierInFilter& in) { return in.values.empty(); },
+        [] (const AllFilter& all) {
+            return std::any_of(all.filters.begin(), all.filters.end(), matchesNothing);
+        },
+        [] (const AnyFilter& any) {
+            return std::all_of(any.filters.begin(), any.filters.end(), matchesNothing);
+        },
+        [] (const NoneFilter& none) {
+            return std::any_of(none.filters.begin(), none.filters.end(), matchesEverything);
+        },
+        [] (const auto&) { return false; });
+}
+
+bool rendersNothing(const Layer::Impl& layer, const std::vector<std::unique_ptr<Source>>& sources) {
+    if (layer.minZoom > layer.maxZoom || matchesNothing(layer.filter)) {
+        return true;
+    }
+
+    // Sources show no tiles below their minimum zoom level; overzooming keeps them showing
+    // above their maximum one.
+    auto it = std::find_if(sources.begin(), sources.end(), [&] (const auto& source) {
+        return source->getID() == layer.source;
+    });
+    if (it == sources.end() || !std::isfinite(layer.maxZoom)) {
+        return false;
+    }
+    const Source::Impl& source = *(*it)->baseImpl;
+    if (source.type != SourceType::Vector && source.type != SourceType::Raster) {
+        return false;
+    }
+    const auto& tileSource = static_cast<const TileSourceImpl&>(source);
+    const auto& urlOrTileset = tileSource.getURLOrTileset();
+    return urlOrTileset.is<Tileset>() &&
+        util::coveringZoomLevel(layer.maxZoom, source.type, tileSource.getTileSize()) < urlOrTileset.get<Tileset>().zoomRange.min;
+}
+
+} // namespace
+
+StyleOptimization optimize(const std::vector<std::unique_ptr<Layer>>& layers,
+                           const std::vector<std::unique_ptr<Source>>& sources) {
+    StyleOptimization result;
+    for (const auto& layer : layers) {
+        layer->accept(FoldConstantsVisitor { result.foldedFunctions });
+
+        layer->baseImpl->rendersNothing = !layer->is<CustomLayer>() && !layer->is<BackgroundLayer>() &&
+            rendersNothing(*layer->baseImpl, sources);
+        if (layer->baseImpl->rendersNothing) {
+            ++result.inertLayers;
+        }
+    }
+    return result;
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+class Layer;
+class Source;
+
+class StyleOptimization {
+public:
+    // Camera functions replaced by the one value they take at every zoom level.
+    std::size_t foldedFunctions = 0;
+
+    // Layers marked as rendering nothing.
+    std::size_t inertLayers = 0;
+};
+
+// Simplifies the layers of a parsed style without changing how it renders. Camera functions
+// whose stops all have the same value, as generated styles often have, become constants, so
+// they are evaluated once and laid out like them. Layers that can't draw anything as they
+// are, for a zoom range that is empty or below the zoom levels of the source's inline
+// tileset, or a filter that matches nothing, are marked with `Layer::Impl::rendersNothing`,
+// so that their tiles are neither laid out nor rendered. Layers hidden with
+// `visibility: none` are skipped that way already.
+StyleOptimization optimize(const std::vector<std::unique_ptr<Layer>>&,
+                           const std::vector<std::unique_ptr<Source>>&);
+
+} // namespace style
+} // namespace mbgl
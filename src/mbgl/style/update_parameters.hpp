@@ -1,10 +1,13 @@
 #pragma once
 
 #include <mbgl/map/mode.hpp>
+#include <mbgl/map/transform_state.hpp>
+
+#include <cstddef>
+#include <vector>
 
 namespace mbgl {
 
-class TransformState;
 class Scheduler;
 class FileSource;
 class AnnotationManager;
@@ -40,6 +43,19 @@ public:
     const MapMode mode;
     AnnotationManager& annotationManager;
 
+    // Where the camera is animating to; see `Transform::getTransitionStates`. Sources load
+    // the tiles of these viewports ahead of time.
+    std::vector<TransformState> transitionStates;
+
+    // The screen-space error allowed for tiles far from the camera in pitched views; see
+    // `util::tileCover`. Zero covers the whole view at one zoom level.
+    double tileCoverError = 0;
+
+    // While the camera is idle, sources with loaded ideal tiles load the tiles around them,
+    // and those of the zoom levels above and below, ahead of a pan or zoom. Zero when the
+    // camera moves, or when the prefetch budget is spent; see `Map::setTilePrefetchBudget`.
+    size_t prefetchBytes = 0;
+
     // TODO: remove
     Style& style;
 };
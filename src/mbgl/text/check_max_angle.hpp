@@ -5,8 +5,10 @@
 namespace mbgl {
 
 class Anchor;
+class LineMeasurements;
 
 bool checkMaxAngle(const GeometryCoordinates& line,
+                   const LineMeasurements&,
                    const Anchor& anchor,
                    const float labelLength,
                    const float windowSize,
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    A uniform grid of axis-aligned boxes, for the collision tests of `CollisionTile`.
+
+    Collision boxes are small compared to a tile, so inserting one touches only a few
+    cells, and a query visits about as many boxes as lie near it. Queries don't allocate:
+    instead of remembering which boxes it has already seen, a query reports a box only
+    from the first of its cells that it shares with the query box.
+*/
+template <class T>
+class CollisionGrid {
+public:
+    struct BBox {
+        float x1;
+        float y1;
+        float x2;
+        float y2;
+    };
+
+    struct Entry {
+        T value;
+        BBox bbox;
+
+        // The first cell of `bbox`.
+        uint32_t cellX;
+        uint32_t cellY;
+    };
+
+    // Spreads `n` × `n` cells over `bounds`. Boxes reaching beyond the bounds are kept in
+    // the cells along the border.
+    CollisionGrid(const BBox& bounds, uint32_t n_)
+        : n(std::max<uint32_t>(n_, 1)),
+          originX(bounds.x1),
+          originY(bounds.y1),
+          scaleX(n / std::max(bounds.x2 - bounds.x1, 1.0f)),
+          scaleY(n / std::max(bounds.y2 - bounds.y1, 1.0f)),
+          cells(n * n) {
+    }
+
+    void insert(T value, const BBox& bbox) {
+        const uint32_t index = entries.size();
+        const uint32_t x1 = cellX(bbox.x1);
+        const uint32_t y1 = cellY(bbox.y1);
+        const uint32_t x2 = cellX(bbox.x2);
+        const uint32_t y2 = cellY(bbox.y2);
+
+        for (uint32_t y = y1; y <= y2; ++y) {
+            for (uint32_t x = x1; x <= x2; ++x) {
+                cells[y * n + x].push_back(index);
+            }
+        }
+
+        entries.push_back({ std::move(value), bbox, x1, y1 });
+    }
+
+    // Calls `fn(entry)` once for every box that intersects or touches `bbox`, in no
+    // particular order, until it returns false. Returns false if it was stopped.
+    template <class Fn>
+    bool query(const BBox& bbox, Fn&& fn) const {
+        const uint32_t x1 = cellX(bbox.x1);
+        const uint32_t y1 = cellY(bbox.y1);
+        const uint32_t x2 = cellX(bbox.x2);
+        const uint32_t y2 = cellY(bbox.y2);
+
+        for (uint32_t y = y1; y <= y2; ++y) {
+            for (uint32_t x = x1; x <= x2; ++x) {
+                for (uint32_t index : cells[y * n + x]) {
+                    const Entry& entry = entries[index];
+                    if (std::max(entry.cellX, x1) != x || std::max(entry.cellY, y1) != y) {
+                        // Reported from another cell.
+                        continue;
+                    }
+                    if (entry.bbox.x1 <= bbox.x2 && entry.bbox.y1 <= bbox.y2 &&
+                        entry.bbox.x2 >= bbox.x1 && entry.bbox.y2 >= bbox.y1 &&
+                        !fn(entry)) {
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // In the order they were inserted.
+    const std::vector<Entry>& getEntries() const {
+        return entries;
+    }
+
+    bool empty() const {
+        return entries.empty();
+    }
+
+private:
+    uint32_t cellX(float x) const {
+        return toCell((x - originX) * scaleX);
+    }
+
+    uint32_t cellY(float y) const {
+        return toCell((y - originY) * scaleY);
+    }
+
+    uint32_t toCell(float coordinate) const {
+        const float cell = std::floor(coordinate);
+        if (!(cell > 0)) {
+            return 0;
+        }
+        return cell < n - 1 ? static_cast<uint32_t>(cell) : n - 1;
+    }
+
+    const uint32_t n;
+    const float originX;
+    const float originY;
+    const float scaleX;
+    const float scaleY;
+
+    std::vector<Entry> entries;
+    std::vector<std::vector<uint32_t>> cells;
+};
+
+} // namespace mbgl
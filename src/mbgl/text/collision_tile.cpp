@@ -9,11 +9,45 @@
 #include <mapbox/geometry/envelope.hpp>
 #include <mapbox/geometry/multi_point.hpp>
 
+#include <array>
+#include <cassert>
 #include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace mbgl {
 
-CollisionTile::CollisionTile(PlacementConfig config_) : config(std::move(config_)) {
+namespace {
+
+// About as many cells along each side of a tile as a tile has 32 pixel squares.
+constexpr uint32_t cellsPerSide = 16;
+
+// The bounds of the tile once rotated by `angle` like the collision boxes.
+template <class BBox>
+BBox rotatedTileBounds(float angle) {
+    const std::array<float, 4> matrix {{ std::cos(angle), -std::sin(angle), std::sin(angle), std::cos(angle) }};
+    BBox bounds {
+        std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(),
+        -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()
+    };
+    for (const auto& corner : { Point<float>(0, 0), Point<float>(util::EXTENT, 0),
+                                Point<float>(0, util::EXTENT), Point<float>(util::EXTENT, util::EXTENT) }) {
+        const Point<float> rotated = util::matrixMultiply(matrix, corner);
+        bounds.x1 = util::min(bounds.x1, rotated.x);
+        bounds.y1 = util::min(bounds.y1, rotated.y);
+        bounds.x2 = util::max(bounds.x2, rotated.x);
+        bounds.y2 = util::max(bounds.y2, rotated.y);
+    }
+    return bounds;
+}
+
+} // namespace
+
+CollisionTile::CollisionTile(PlacementConfig config_)
+    : config(std::move(config_)),
+      grid(rotatedTileBounds<Grid::BBox>(config.angle), cellsPerSide),
+      ignoredGrid(grid) {
     // Compute the transformation matrix.
     const float angle_sin = std::sin(config.angle);
     const float angle_cos = std::cos(config.angle);
@@ -87,13 +121,14 @@ float CollisionTile::placeFeature(const CollisionFeature& feature, bool allowOve
         const auto anchor = util::matrixMultiply(rotationMatrix, box.anchor);
 
         if (!allowOverlap) {
-            for (auto it = tree.qbegin(bgi::intersects(getTreeBox(anchor, box))); it != tree.qend(); ++it) {
-                const CollisionBox& blocking = std::get<1>(*it);
+            const bool blocked = !grid.query(getGridBox(anchor, box), [&] (const Grid::Entry& entry) {
+                const CollisionBox& blocking = entry.value.box;
                 Point<float> blockingAnchor = util::matrixMultiply(rotationMatrix, blocking.anchor);
 
                 minPlacementScale = util::max(minPlacementScale, findPlacementScale(anchor, box, blockingAnchor, blocking));
-                if (minPlacementScale >= maxScale) return minPlacementScale;
-            }
+                return minPlacementScale < maxScale;
+            });
+            if (blocked) return minPlacementScale;
         }
 
         if (avoidEdges) {
@@ -124,24 +159,21 @@ void CollisionTile::insertFeature(CollisionFeature& feature, float minPlacementS
     }
 
     if (minPlacementScale < maxScale) {
-        std::vector<CollisionTreeBox> treeBoxes;
+        const uint32_t index = features.size();
+        features.push_back(feature.indexedFeature);
+
+        Grid& target = ignorePlacement ? ignoredGrid : grid;
         for (auto& box : feature.boxes) {
-            treeBoxes.emplace_back(getTreeBox(util::matrixMultiply(rotationMatrix, box.anchor), box), box, feature.indexedFeature);
-        }
-        if (ignorePlacement) {
-            ignoredTree.insert(treeBoxes.begin(), treeBoxes.end());
-        } else {
-            tree.insert(treeBoxes.begin(), treeBoxes.end());
+            target.insert({ box, index }, getGridBox(util::matrixMultiply(rotationMatrix, box.anchor), box));
         }
     }
-
 }
 
 // +---------------------------+ As you zoom, the size of the symbol changes
 // |(x1,y1)      |             | relative to the tile e.g. when zooming in,
 // |             |             | the symbol gets smaller relative to the tile.
 // |  (x1',y1')  v             |
-// |     +-------+-------+     | The boxes inserted into the tree represents
+// |     +-------+-------+     | The boxes inserted into the grid represents
 // |     |       |       |     | the bounds at the integer zoom level (where
 // |     |       |       |     | the symbol is biggest relative to the tile).
 // |     |       |       |     |
@@ -154,23 +186,19 @@ void CollisionTile::insertFeature(CollisionFeature& feature, float minPlacementS
 // |             |             | calculating the bounds at current zoom level
 // |             |      (x2,y2)| we must unscale the box using its center as
 // +---------------------------+ transform origin.
-Box CollisionTile::getTreeBox(const Point<float>& anchor, const CollisionBox& box, const float scale) {
+CollisionTile::Grid::BBox CollisionTile::getGridBox(const Point<float>& anchor, const CollisionBox& box, const float scale) {
     assert(box.x1 <= box.x2 && box.y1 <= box.y2);
-    return Box{
-        CollisionPoint{
-            anchor.x + box.x1 / scale,
-            anchor.y + box.y1 / scale * yStretch
-        },
-        CollisionPoint{
-            anchor.x + box.x2 / scale,
-            anchor.y + box.y2 / scale * yStretch
-        }
+    return Grid::BBox {
+        anchor.x + box.x1 / scale,
+        anchor.y + box.y1 / scale * yStretch,
+        anchor.x + box.x2 / scale,
+        anchor.y + box.y2 / scale * yStretch
     };
 }
 
 std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const GeometryCoordinates& queryGeometry, float scale) const {
     std::vector<IndexedSubfeature> result;
-    if (queryGeometry.empty() || (tree.empty() && ignoredTree.empty())) {
+    if (queryGeometry.empty() || (grid.empty() && ignoredGrid.empty())) {
         return result;
     }
 
@@ -183,10 +211,10 @@ std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const Geometr
     }
 
     // Predicate for ruling out already seen features.
-    std::unordered_map<std::string, std::unordered_set<std::size_t>> sourceLayerFeatures;
-    auto seenFeature = [&] (const CollisionTreeBox& treeBox) -> bool {
-        const IndexedSubfeature& feature = std::get<2>(treeBox);
-        const auto& seenFeatures = sourceLayerFeatures[feature.sourceLayerName];
+    std::unordered_map<uint32_t, std::unordered_set<std::size_t>> sourceLayerFeatures;
+    auto seenFeature = [&] (const Collider& collider) -> bool {
+        const IndexedSubfeature& feature = features[collider.feature];
+        const auto& seenFeatures = sourceLayerFeatures[feature.sourceLayerID];
         return seenFeatures.find(feature.index) == seenFeatures.end();
     };
 
@@ -194,14 +222,14 @@ std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const Geometr
     const float roundedScale = std::pow(2.0f, std::ceil(util::log2(scale) * 10.0f) / 10.0f);
 
     // Check if feature is rendered (collision free) at current scale.
-    auto visibleAtScale = [&] (const CollisionTreeBox& treeBox) -> bool {
-        const CollisionBox& box = std::get<1>(treeBox);
+    auto visibleAtScale = [&] (const Collider& collider) -> bool {
+        const CollisionBox& box = collider.box;
         return roundedScale >= box.placementScale && roundedScale <= box.maxScale;
     };
 
     // Check if query polygon intersects with the feature box at current scale.
-    auto intersectsAtScale = [&] (const CollisionTreeBox& treeBox) -> bool {
-        const CollisionBox& collisionBox = std::get<1>(treeBox);
+    auto intersectsAtScale = [&] (const Collider& collider) -> bool {
+        const CollisionBox& collisionBox = collider.box;
         const auto anchor = util::matrixMultiply(rotationMatrix, collisionBox.anchor);
         const int16_t x1 = anchor.x + collisionBox.x1 / scale;
         const int16_t y1 = anchor.y + collisionBox.y1 / scale * yStretch;
@@ -213,21 +241,20 @@ std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const Geometr
         return util::polygonIntersectsPolygon(polygon, bbox);
     };
 
-    auto predicates = bgi::satisfies(seenFeature)
-                   && bgi::satisfies(visibleAtScale)
-                   && bgi::satisfies(intersectsAtScale);
-
-    auto queryTree = [&](const auto& tree_) {
-        for (auto it = tree_.qbegin(predicates); it != tree_.qend(); ++it) {
-            const IndexedSubfeature& feature = std::get<2>(*it);
-            auto& seenFeatures = sourceLayerFeatures[feature.sourceLayerName];
-            seenFeatures.insert(feature.index);
-            result.push_back(feature);
+    auto queryGrid = [&](const Grid& grid_) {
+        for (const auto& entry : grid_.getEntries()) {
+            const Collider& collider = entry.value;
+            if (seenFeature(collider) && visibleAtScale(collider) && intersectsAtScale(collider)) {
+                const IndexedSubfeature& feature = features[collider.feature];
+                auto& seenFeatures = sourceLayerFeatures[feature.sourceLayerID];
+                seenFeatures.insert(feature.index);
+                result.push_back(feature);
+            }
         }
     };
 
-    queryTree(tree);
-    queryTree(ignoredTree);
+    queryGrid(grid);
+    queryGrid(ignoredGrid);
 
     return result;
 }
@@ -1,5 +1,6 @@
 #include <mbgl/text/get_anchors.hpp>
 #include <mbgl/text/check_max_angle.hpp>
+#include <mbgl/text/line_measurements.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/interpolate.hpp>
 
@@ -9,6 +10,7 @@
 namespace mbgl {
 
 static Anchors resample(const GeometryCoordinates& line,
+                        const LineMeasurements& measurements,
                         const float offset,
                         const float spacing,
                         const float angleWindowSize,
@@ -17,25 +19,21 @@ static Anchors resample(const GeometryCoordinates& line,
                         const bool continuedLine,
                         const bool placeAtMiddle) {
     const float halfLabelLength = labelLength / 2.0f;
-    float lineLength = 0;
-    for (auto it = line.begin(), end = line.end() - 1; it != end; it++) {
-        lineLength += util::dist<float>(*(it), *(it + 1));
-    }
+    const float lineLength = measurements.length();
 
-    float distance = 0;
     float markedDistance = offset - spacing;
 
     Anchors anchors;
 
     assert(spacing > 0.0);
 
-    int i = 0;
-    for (auto it = line.begin(), end = line.end() - 1; it != end; it++, i++) {
-        const GeometryCoordinate& a = *(it);
-        const GeometryCoordinate& b = *(it + 1);
+    for (std::size_t i = 0; i + 1 < line.size(); i++) {
+        const GeometryCoordinate& a = line[i];
+        const GeometryCoordinate& b = line[i + 1];
 
-        const float segmentDist = util::dist<float>(a, b);
-        const float angle = util::angle_to(b, a);
+        const float distance = measurements.distances[i];
+        const float segmentDist = measurements.distances[i + 1] - distance;
+        const float angle = measurements.angles[i];
 
         while (markedDistance + spacing < distance + segmentDist) {
             markedDistance += spacing;
@@ -52,13 +50,11 @@ static Anchors resample(const GeometryCoordinates& line,
                     markedDistance + halfLabelLength <= lineLength) {
                 Anchor anchor(::round(x), ::round(y), angle, 0.5f, i);
 
-                if (!angleWindowSize || checkMaxAngle(line, anchor, labelLength, angleWindowSize, maxAngle)) {
+                if (!angleWindowSize || checkMaxAngle(line, measurements, anchor, labelLength, angleWindowSize, maxAngle)) {
                     anchors.push_back(anchor);
                 }
             }
         }
-
-        distance += segmentDist;
     }
 
     if (!placeAtMiddle && anchors.empty() && !continuedLine) {
@@ -67,13 +63,14 @@ static Anchors resample(const GeometryCoordinates& line,
         // This has the most effect for short lines in overscaled tiles, since the
         // initial offset used in overscaled tiles is calculated to align labels with positions in
         // parent tiles instead of placing the label as close to the beginning as possible.
-        anchors = resample(line, distance / 2, spacing, angleWindowSize, maxAngle, labelLength, continuedLine, true);
+        anchors = resample(line, measurements, lineLength / 2, spacing, angleWindowSize, maxAngle, labelLength, continuedLine, true);
     }
 
     return anchors;
 }
 
 Anchors getAnchors(const GeometryCoordinates& line,
+                   const LineMeasurements& measurements,
                    float spacing,
                    const float maxAngle,
                    const float textLeft,
@@ -117,7 +114,7 @@ Anchors getAnchors(const GeometryCoordinates& line,
     std::fmod((labelLength / 2 + fixedExtraOffset) * boxScale * overscaling, spacing) :
     std::fmod(spacing / 2 * overscaling, spacing);
 
-    return resample(line, offset, spacing, angleWindowSize, maxAngle, labelLength * boxScale, continuedLine, false);
+    return resample(line, measurements, offset, spacing, angleWindowSize, maxAngle, labelLength * boxScale, continuedLine, false);
 }
 
 } // namespace mbgl
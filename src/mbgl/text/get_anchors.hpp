@@ -6,7 +6,11 @@
 
 namespace mbgl {
 
+class LineMeasurements;
+
+// `measurements` are those of `line`.
 Anchors getAnchors(const GeometryCoordinates& line,
+                   const LineMeasurements& measurements,
                    float spacing,
                    const float maxAngle,
                    const float textLeft,
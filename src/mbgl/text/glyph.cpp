@@ -1,5 +1,8 @@
 #include <mbgl/text/glyph.hpp>
 
+#include <algorithm>
+#include <cassert>
+
 namespace mbgl {
 
 // Note: this only works for the BMP
@@ -11,4 +14,35 @@ GlyphRange getGlyphRange(char16_t glyph) {
     return { start, end };
 }
 
+SDFBitmap::SDFBitmap(Size size_, std::shared_ptr<const std::string> buffer_, std::size_t offset_)
+    : size(std::move(size_)),
+      buffer(std::move(buffer_)),
+      offset(offset_) {
+    assert(!buffer || offset + bytes() <= buffer->size());
+}
+
+SDFBitmap::SDFBitmap(const AlphaImage& image)
+    : size(image.size) {
+    if (image.valid()) {
+        buffer = std::make_shared<const std::string>(reinterpret_cast<const char*>(image.data.get()), image.bytes());
+    }
+}
+
+AlphaImage SDFBitmap::materialize() const {
+    if (!valid()) {
+        return {};
+    }
+    return AlphaImage(size, data(), bytes());
+}
+
+bool operator==(const SDFBitmap& lhs, const SDFBitmap& rhs) {
+    if (lhs.size != rhs.size) {
+        return false;
+    }
+    if (!lhs.valid() || !rhs.valid()) {
+        return lhs.valid() == rhs.valid();
+    }
+    return std::equal(lhs.data(), lhs.data() + lhs.bytes(), rhs.data());
+}
+
 } // namespace mbgl
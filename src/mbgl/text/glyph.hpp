@@ -6,6 +6,7 @@
 #include <mbgl/util/image.hpp>
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
 #include <map>
@@ -80,6 +81,44 @@ class Shaping {
     explicit operator bool() const { return !positionedGlyphs.empty(); }
 };
 
+// The signed distance field of a glyph, as a view into the glyph PBF it was parsed from: the
+// glyphs of a range share its data instead of each holding a copy. Bitmaps are only copied
+// into an image when a glyph is added to an atlas.
+class SDFBitmap {
+public:
+    SDFBitmap() = default;
+    SDFBitmap(Size, std::shared_ptr<const std::string> buffer, std::size_t offset);
+
+    // Copies the image into a buffer of its own.
+    SDFBitmap(const AlphaImage&);
+
+    bool valid() const {
+        return size.width && size.height && buffer;
+    }
+
+    std::size_t bytes() const {
+        return size.area();
+    }
+
+    const uint8_t* data() const {
+        return reinterpret_cast<const uint8_t*>(buffer->data()) + offset;
+    }
+
+    AlphaImage materialize() const;
+
+    Size size;
+
+private:
+    std::shared_ptr<const std::string> buffer;
+    std::size_t offset = 0;
+};
+
+bool operator==(const SDFBitmap&, const SDFBitmap&);
+
+inline bool operator!=(const SDFBitmap& lhs, const SDFBitmap& rhs) {
+    return !(lhs == rhs);
+}
+
 class SDFGlyph {
 public:
     // We're using this value throughout the Mapbox GL ecosystem. If this is different, the glyphs
@@ -89,7 +128,7 @@ public:
     uint32_t id = 0;
 
     // A signed distance field of the glyph with a border (see above).
-    AlphaImage bitmap;
+    SDFBitmap bitmap;
 
     // Glyph metrics
     GlyphMetrics metrics;
@@ -12,12 +12,13 @@ namespace mbgl {
 
 static GlyphAtlasObserver nullObserver;
 
-GlyphAtlas::GlyphAtlas(const Size size, FileSource& fileSource_)
+GlyphAtlas::GlyphAtlas(const Size size, FileSource& fileSource_, GlyphCache* cache_, Scheduler* scheduler_)
     : fileSource(fileSource_),
+      cache(cache_),
+      scheduler(scheduler_),
       observer(&nullObserver),
       bin(size.width, size.height),
-      image(size),
-      dirty(true) {
+      image(size) {
 }
 
 GlyphAtlas::~GlyphAtlas() = default;
@@ -46,6 +47,8 @@ bool GlyphAtlas::hasGlyphRanges(const FontStack& fontStack, const GlyphRangeSet&
 
     bool hasRanges = true;
     for (const auto& range : glyphRanges) {
+        rangeUsage[range]++;
+
         const auto& rangeSetsIt = rangeSets.find(range);
         if (rangeSetsIt == rangeSets.end()) {
             // Push the request to the MapThread, so we can easly cancel
@@ -64,6 +67,45 @@ bool GlyphAtlas::hasGlyphRanges(const FontStack& fontStack, const GlyphRangeSet&
     return hasRanges;
 }
 
+void GlyphAtlas::prefetchGlyphRanges(const std::vector<FontStack>& fontStacks) {
+    if (glyphURL.empty()) {
+        return;
+    }
+
+    GlyphRangeSet ranges = prefetchRanges;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& usage : rangeUsage) {
+            ranges.insert(usage.first);
+        }
+    }
+
+    for (const auto& fontStack : fontStacks) {
+        for (const auto& range : ranges) {
+            requestGlyphRange(fontStack, range);
+        }
+    }
+}
+
+void GlyphAtlas::cancelPendingGlyphRanges() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : entries) {
+        auto& ranges = entry.second.ranges;
+        for (auto it = ranges.begin(); it != ranges.end();) {
+            if (it->second.isParsed()) {
+                ++it;
+            } else {
+                it = ranges.erase(it);
+            }
+        }
+    }
+}
+
+std::map<GlyphRange, uint64_t> GlyphAtlas::getGlyphRangeUsage() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return rangeUsage;
+}
+
 util::exclusive<GlyphSet> GlyphAtlas::getGlyphSet(const FontStack& fontStack) {
     auto lock = std::make_unique<std::lock_guard<std::mutex>>(mutex);
     return { &entries[fontStack].glyphSet, std::move(lock) };
@@ -134,9 +176,12 @@ Rect<uint16_t> GlyphAtlas::addGlyph(uintptr_t tileUID,
 
     face.emplace(glyph.id, GlyphValue { rect, tileUID });
 
-    AlphaImage::copy(glyph.bitmap, image, { 0, 0 }, { rect.x + padding, rect.y + padding }, glyph.bitmap.size);
+    AlphaImage::copy(glyph.bitmap.materialize(), image, { 0, 0 }, { rect.x + padding, rect.y + padding }, glyph.bitmap.size);
 
-    dirty = true;
+    {
+        std::lock_guard<std::mutex> lock(dirtyMutex);
+        dirtyRegions.push_back(rect);
+    }
 
     return rect;
 }
@@ -180,14 +225,28 @@ Size GlyphAtlas::getSize() const {
     return image.size;
 }
 
+MemoryStats::Usage GlyphAtlas::getMemoryUsage() const {
+    MemoryStats::Usage result;
+    result.cpuBytes = image.bytes();
+    result.gpuBytes = texture ? texture->size.area() * image.channels : 0;
+    return result;
+}
+
 void GlyphAtlas::upload(gl::Context& context, gl::TextureUnit unit) {
+    gl::ResourceOwnerScope owner { context, GLResourceStats::Owner::Atlas };
+
+    std::vector<Rect<uint16_t>> regions;
+    {
+        std::lock_guard<std::mutex> lock(dirtyMutex);
+        regions.swap(dirtyRegions);
+    }
+
     if (!texture) {
         texture = context.createTexture(image, unit);
-    } else if (dirty) {
-        context.updateTexture(*texture, image, unit);
+        return;
     }
 
-    dirty = false;
+    context.updateTextureRegions(*texture, image, std::move(regions), unit);
 }
 
 void GlyphAtlas::bind(gl::Context& context, gl::TextureUnit unit) {
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <mbgl/map/memory_stats.hpp>
 #include <mbgl/text/glyph.hpp>
 #include <mbgl/text/glyph_set.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/geometry/binpack.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/optional.hpp>
@@ -12,17 +14,22 @@
 #include <mbgl/gl/texture.hpp>
 #include <mbgl/gl/object.hpp>
 
-#include <atomic>
+#include <map>
+#include <memory>
 #include <string>
 #include <unordered_set>
 #include <unordered_map>
 #include <mutex>
+#include <vector>
 
 namespace mbgl {
 
 class FileSource;
 class GlyphPBF;
 class GlyphAtlasObserver;
+class GlyphCache;
+class LocalGlyphRasterizer;
+class Scheduler;
 
 namespace gl {
 class Context;
@@ -30,7 +37,10 @@ class Context;
 
 class GlyphAtlas : public util::noncopyable {
 public:
-    GlyphAtlas(Size, FileSource&);
+    // Glyph ranges found in the cache, if there is one, aren't requested again, and those
+    // that are requested are added to it. Responses are parsed on the scheduler if there is
+    // one, and on the thread of the request otherwise.
+    GlyphAtlas(Size, FileSource&, GlyphCache* = nullptr, Scheduler* = nullptr);
     ~GlyphAtlas();
 
     util::exclusive<GlyphSet> getGlyphSet(const FontStack&);
@@ -42,6 +52,25 @@ public:
     // can be called from any thread.
     bool hasGlyphRanges(const FontStack&, const GlyphRangeSet&);
 
+    // Requests the ranges labels in these font stacks are likely to need before any tile
+    // asks for them, so that tiles don't wait for another round trip after their layout:
+    // the prefetch ranges, and the ranges tiles asked this atlas for before. Must be called
+    // after the URL is set.
+    void prefetchGlyphRanges(const std::vector<FontStack>&);
+
+    // Defaults to the first range, Basic Latin and Latin-1 Supplement.
+    void setPrefetchGlyphRanges(GlyphRangeSet ranges) {
+        prefetchRanges = std::move(ranges);
+    }
+
+    // Drops the ranges that haven't been parsed yet, cancelling their requests. They are
+    // requested again when tiles ask for them.
+    void cancelPendingGlyphRanges();
+
+    // How often tiles asked for each range, over all font stacks. Embedders may persist it,
+    // e.g. per region, and prefetch the most used ranges of a region the next time.
+    std::map<GlyphRange, uint64_t> getGlyphRangeUsage() const;
+
     void setURL(const std::string &url) {
         glyphURL = url;
     }
@@ -50,6 +79,29 @@ public:
         return glyphURL;
     }
 
+    GlyphCache* getCache() const {
+        return cache;
+    }
+
+    Scheduler* getScheduler() const {
+        return scheduler;
+    }
+
+    // Ranges with code points the rasterizer draws are drawn instead of requested, on the
+    // scheduler if there is one. Ranges already loaded or requested are kept.
+    void setLocalGlyphRasterizer(std::shared_ptr<LocalGlyphRasterizer> rasterizer) {
+        localGlyphRasterizer = std::move(rasterizer);
+    }
+
+    std::shared_ptr<LocalGlyphRasterizer> getLocalGlyphRasterizer() const {
+        return localGlyphRasterizer;
+    }
+
+    // Shared by the tiles of all sources using this atlas.
+    ShapingCache& getShapingCache() {
+        return shapingCache;
+    }
+
     void setObserver(GlyphAtlasObserver* observer);
 
     void addGlyphs(uintptr_t tileUID,
@@ -63,11 +115,14 @@ public:
     void bind(gl::Context&, gl::TextureUnit unit);
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
+    // only the regions of glyphs added since the last upload are sent.
     void upload(gl::Context&, gl::TextureUnit unit);
 
     Size getSize() const;
 
+    // The bytes of the image on the CPU, and of the texture it was uploaded into.
+    MemoryStats::Usage getMemoryUsage() const;
+
 private:
     void requestGlyphRange(const FontStack&, const GlyphRange&);
 
@@ -76,7 +131,10 @@ private:
                             const SDFGlyph&);
 
     FileSource& fileSource;
+    GlyphCache* const cache;
+    Scheduler* const scheduler;
     std::string glyphURL;
+    std::shared_ptr<LocalGlyphRasterizer> localGlyphRasterizer;
 
     struct GlyphValue {
         GlyphValue(Rect<uint16_t> rect_, uintptr_t id)
@@ -92,15 +150,24 @@ private:
     };
 
     std::unordered_map<FontStack, Entry, FontStackHash> entries;
-    std::mutex mutex;
+    std::map<GlyphRange, uint64_t> rangeUsage;
+    GlyphRangeSet prefetchRanges { { 0, 255 } };
+    mutable std::mutex mutex;
+
+    // A few thousand labels.
+    ShapingCache shapingCache { 2 * 1024 * 1024 };
 
     util::WorkQueue workQueue;
     GlyphAtlasObserver* observer = nullptr;
 
     BinPack<uint16_t> bin;
     AlphaImage image;
-    std::atomic<bool> dirty;
     mbgl::optional<gl::Texture> texture;
+
+    // Regions of the image that changed since the last upload. Glyphs are added by the
+    // workers and uploaded on the render thread, so this has a lock of its own.
+    std::vector<Rect<uint16_t>> dirtyRegions;
+    std::mutex dirtyMutex;
 };
 
 } // namespace mbgl
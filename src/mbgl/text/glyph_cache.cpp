@@ -0,0 +1,76 @@
+#include <mbgl/text/glyph_cache.hpp>
+
+namespace mbgl {
+
+GlyphCache::GlyphCache(std::size_t maximumSize_)
+    : maximumSize(maximumSize_) {
+}
+
+GlyphCache& GlyphCache::shared() {
+    // A few dozen ranges, which covers the fonts of a typical pair of styles.
+    static GlyphCache cache { 8 * 1024 * 1024 };
+    return cache;
+}
+
+std::shared_ptr<const GlyphCache::Glyphs> GlyphCache::get(const std::string& url) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(url);
+    if (it == entries.end()) {
+        return nullptr;
+    }
+
+    lru.splice(lru.begin(), lru, it->second.lru);
+    return it->second.glyphs;
+}
+
+void GlyphCache::put(const std::string& url, std::shared_ptr<const Glyphs> glyphs) {
+    std::size_t glyphsSize = sizeof(Glyphs) + glyphs->size() * sizeof(SDFGlyph);
+    for (const auto& glyph : *glyphs) {
+        glyphsSize += glyph.bitmap.bytes();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(url);
+    if (it != entries.end()) {
+        size -= it->second.size;
+        lru.erase(it->second.lru);
+        entries.erase(it);
+    }
+
+    lru.push_front(url);
+    entries.emplace(url, Entry { std::move(glyphs), glyphsSize, lru.begin() });
+    size += glyphsSize;
+
+    evict();
+}
+
+void GlyphCache::setMaximumSize(std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maximumSize = bytes;
+    evict();
+}
+
+std::size_t GlyphCache::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return size;
+}
+
+void GlyphCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    lru.clear();
+    size = 0;
+}
+
+void GlyphCache::evict() {
+    while (size > maximumSize && !lru.empty()) {
+        auto it = entries.find(lru.back());
+        size -= it->second.size;
+        entries.erase(it);
+        lru.pop_back();
+    }
+}
+
+} // namespace mbgl
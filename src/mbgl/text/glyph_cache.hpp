@@ -0,0 +1,59 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    Parsed glyph ranges, kept across styles and maps so that switching to a style with the
+    same fonts doesn't download and parse them again. Ranges are keyed by their URL. Once
+    their bitmaps take up more than the maximum size, the least recently used ranges are
+    evicted; atlases that already copied their glyphs keep them.
+
+    All methods are thread-safe.
+*/
+class GlyphCache : private util::noncopyable {
+public:
+    using Glyphs = std::vector<SDFGlyph>;
+
+    explicit GlyphCache(std::size_t maximumSize);
+
+    // The cache shared by the styles of every map in the process.
+    static GlyphCache& shared();
+
+    std::shared_ptr<const Glyphs> get(const std::string& url);
+    void put(const std::string& url, std::shared_ptr<const Glyphs>);
+
+    void setMaximumSize(std::size_t bytes);
+    std::size_t getSize() const;
+    void clear();
+
+private:
+    void evict();
+
+    struct Entry {
+        std::shared_ptr<const Glyphs> glyphs;
+        std::size_t size;
+        std::list<std::string>::iterator lru;
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+
+    // URLs of the entries, from the most to the least recently used.
+    std::list<std::string> lru;
+
+    std::size_t size = 0;
+    std::size_t maximumSize;
+};
+
+} // namespace mbgl
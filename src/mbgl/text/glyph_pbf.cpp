@@ -1,134 +1,118 @@
 #include <mbgl/text/glyph_pbf.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/glyph_atlas_observer.hpp>
+#include <mbgl/text/glyph_cache.hpp>
 #include <mbgl/text/glyph_set.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/util/exception.hpp>
+#include <mbgl/util/local_glyph_rasterizer.hpp>
+#include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/token.hpp>
 #include <mbgl/util/url.hpp>
 
-#include <protozero/pbf_reader.hpp>
-
 namespace mbgl {
 
 namespace {
 
-void parseGlyphPBF(GlyphSet& glyphSet, const GlyphRange& glyphRange, const std::string& data) {
-    protozero::pbf_reader glyphs_pbf(data);
-
-    while (glyphs_pbf.next(1)) {
-        auto fontstack_pbf = glyphs_pbf.get_message();
-        while (fontstack_pbf.next(3)) {
-            auto glyph_pbf = fontstack_pbf.get_message();
-
-            SDFGlyph glyph;
-            protozero::data_view glyphData;
-
-            bool hasID = false, hasWidth = false, hasHeight = false, hasLeft = false,
-                 hasTop = false, hasAdvance = false;
-
-            while (glyph_pbf.next()) {
-                switch (glyph_pbf.tag()) {
-                case 1: // id
-                    glyph.id = glyph_pbf.get_uint32();
-                    hasID = true;
-                    break;
-                case 2: // bitmap
-                    glyphData = glyph_pbf.get_view();
-                    break;
-                case 3: // width
-                    glyph.metrics.width = glyph_pbf.get_uint32();
-                    hasWidth = true;
-                    break;
-                case 4: // height
-                    glyph.metrics.height = glyph_pbf.get_uint32();
-                    hasHeight = true;
-                    break;
-                case 5: // left
-                    glyph.metrics.left = glyph_pbf.get_sint32();
-                    hasLeft = true;
-                    break;
-                case 6: // top
-                    glyph.metrics.top = glyph_pbf.get_sint32();
-                    hasTop = true;
-                    break;
-                case 7: // advance
-                    glyph.metrics.advance = glyph_pbf.get_uint32();
-                    hasAdvance = true;
-                    break;
-                default:
-                    glyph_pbf.skip();
-                    break;
-                }
-            }
-
-            // Only treat this glyph as a correct glyph if it has all required fields. It also
-            // needs to satisfy a few metrics conditions that ensure that the glyph isn't bogus.
-            // All other glyphs are malformed.  We're also discarding all glyphs that are outside
-            // the expected glyph range.
-            if (!hasID || !hasWidth || !hasHeight || !hasLeft || !hasTop || !hasAdvance ||
-                glyph.metrics.width >= 256 || glyph.metrics.height >= 256 ||
-                glyph.metrics.left < -128 || glyph.metrics.left >= 128 ||
-                glyph.metrics.top < -128 || glyph.metrics.top >= 128 ||
-                glyph.metrics.advance >= 256 ||
-                glyph.id < glyphRange.first || glyph.id > glyphRange.second) {
-                continue;
-            }
-
-            // If the area of width/height is non-zero, we need to adjust the expected size
-            // with the implicit border size, otherwise we expect there to be no bitmap at all.
-            if (glyph.metrics.width && glyph.metrics.height) {
-                const Size size {
-                    glyph.metrics.width + 2 * SDFGlyph::borderSize,
-                    glyph.metrics.height + 2 * SDFGlyph::borderSize
-                };
-
-                if (size.area() != glyphData.size()) {
-                    continue;
-                }
-
-                glyph.bitmap = AlphaImage(size, reinterpret_cast<const uint8_t*>(glyphData.data()), glyphData.size());
-            }
-
-            glyphSet.insert(glyph.id, std::move(glyph));
-        }
+// The glyphs may be shared with the cache; the set's copies share their bitmaps.
+void insertGlyphs(GlyphSet& glyphSet, const GlyphCache::Glyphs& glyphs) {
+    for (const auto& glyph : glyphs) {
+        glyphSet.insert(glyph.id, SDFGlyph(glyph));
     }
 }
 
 } // namespace
 
-GlyphPBF::GlyphPBF(GlyphAtlas* atlas,
-                   const FontStack& fontStack,
-                   const GlyphRange& glyphRange,
+GlyphPBF::GlyphPBF(GlyphAtlas* atlas_,
+                   const FontStack& fontStack_,
+                   const GlyphRange& glyphRange_,
                    GlyphAtlasObserver* observer_,
                    FileSource& fileSource)
     : parsed(false),
+      atlas(atlas_),
+      fontStack(fontStack_),
+      glyphRange(glyphRange_),
       observer(observer_) {
-    req = fileSource.request(Resource::glyphs(atlas->getURL(), fontStack, glyphRange), [this, atlas, fontStack, glyphRange](Response res) {
+    // Drawn glyphs aren't cached: they depend on the fonts of the device, not on the URL.
+    if (auto rasterizer = atlas->getLocalGlyphRasterizer()) {
+        if (isLocalGlyphRange(glyphRange)) {
+            if (Scheduler* scheduler = atlas->getScheduler()) {
+                mailbox = std::make_shared<Mailbox>(*util::RunLoop::Get());
+                worker.emplace(*scheduler, ActorRef<GlyphPBF>(*this, mailbox));
+                worker->invoke(&GlyphPBFWorker::rasterize, fontStack, glyphRange, std::move(rasterizer));
+            } else {
+                req = util::RunLoop::Get()->invokeCancellable([this, rasterizer] {
+                    load(rasterizeLocalGlyphs(*rasterizer, fontStack, glyphRange));
+                });
+            }
+            return;
+        }
+    }
+
+    const Resource resource = Resource::glyphs(atlas->getURL(), fontStack, glyphRange);
+    url = resource.url;
+
+    if (GlyphCache* cache = atlas->getCache()) {
+        if (auto glyphs = cache->get(url)) {
+            // Finish on a later turn of the run loop, like a response would: the atlas is
+            // locked while it requests ranges.
+            req = util::RunLoop::Get()->invokeCancellable([this, glyphs] {
+                load(*glyphs);
+            });
+            return;
+        }
+    }
+
+    req = fileSource.request(resource, [this](Response res) {
         if (res.error) {
             observer->onGlyphsError(fontStack, glyphRange, std::make_exception_ptr(std::runtime_error(res.error->message)));
         } else if (res.notModified) {
             return;
         } else if (res.noContent) {
-            parsed = true;
-            observer->onGlyphsLoaded(fontStack, glyphRange);
+            onParsed(std::make_shared<GlyphCache::Glyphs>());
+        } else if (Scheduler* scheduler = atlas->getScheduler()) {
+            if (!worker) {
+                mailbox = std::make_shared<Mailbox>(*util::RunLoop::Get());
+                worker.emplace(*scheduler, ActorRef<GlyphPBF>(*this, mailbox));
+            }
+            worker->invoke(&GlyphPBFWorker::parse, glyphRange, res.data);
         } else {
+            std::shared_ptr<const GlyphCache::Glyphs> glyphs;
             try {
-                parseGlyphPBF(**atlas->getGlyphSet(fontStack), glyphRange, *res.data);
+                glyphs = std::make_shared<GlyphCache::Glyphs>(parseGlyphPBF(glyphRange, res.data));
             } catch (...) {
-                observer->onGlyphsError(fontStack, glyphRange, std::current_exception());
+                onParseError(std::current_exception());
                 return;
             }
-
-            parsed = true;
-            observer->onGlyphsLoaded(fontStack, glyphRange);
+            onParsed(std::move(glyphs));
         }
     });
 }
 
 GlyphPBF::~GlyphPBF() = default;
 
+void GlyphPBF::onParsed(std::shared_ptr<const GlyphCache::Glyphs> glyphs) {
+    if (GlyphCache* cache = atlas->getCache()) {
+        cache->put(url, glyphs);
+    }
+    load(*glyphs);
+}
+
+void GlyphPBF::onParseError(std::exception_ptr error) {
+    observer->onGlyphsError(fontStack, glyphRange, error);
+}
+
+void GlyphPBF::onRasterized(std::shared_ptr<const GlyphCache::Glyphs> glyphs) {
+    load(*glyphs);
+}
+
+void GlyphPBF::load(const GlyphCache::Glyphs& glyphs) {
+    insertGlyphs(**atlas->getGlyphSet(fontStack), glyphs);
+    parsed = true;
+    observer->onGlyphsLoaded(fontStack, glyphRange);
+}
+
 } // namespace mbgl
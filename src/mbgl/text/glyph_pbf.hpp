@@ -1,10 +1,15 @@
 #pragma once
 
+#include <mbgl/actor/actor.hpp>
 #include <mbgl/text/glyph.hpp>
+#include <mbgl/text/glyph_cache.hpp>
+#include <mbgl/text/glyph_pbf_worker.hpp>
 #include <mbgl/util/font_stack.hpp>
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
 
 #include <atomic>
+#include <exception>
 #include <functional>
 #include <string>
 #include <memory>
@@ -15,6 +20,7 @@ class GlyphAtlas;
 class GlyphAtlasObserver;
 class AsyncRequest;
 class FileSource;
+class Mailbox;
 
 class GlyphPBF : private util::noncopyable {
 public:
@@ -29,10 +35,25 @@ public:
         return parsed;
     }
 
+    // Messages from the worker.
+    void onParsed(std::shared_ptr<const GlyphCache::Glyphs>);
+    void onParseError(std::exception_ptr);
+    void onRasterized(std::shared_ptr<const GlyphCache::Glyphs>);
+
 private:
+    void load(const GlyphCache::Glyphs&);
+
     std::atomic<bool> parsed;
+    GlyphAtlas* const atlas;
+    const FontStack fontStack;
+    const GlyphRange glyphRange;
+    std::string url;
     std::unique_ptr<AsyncRequest> req;
     GlyphAtlasObserver* observer = nullptr;
+
+    // Started with the first response, if the atlas has a scheduler to parse on.
+    std::shared_ptr<Mailbox> mailbox;
+    optional<Actor<GlyphPBFWorker>> worker;
 };
 
 } // namespace mbgl
@@ -0,0 +1,191 @@
+#include <mbgl/text/glyph_pbf_worker.hpp>
+#include <mbgl/text/glyph_pbf.hpp>
+#include <mbgl/util/local_glyph_rasterizer.hpp>
+#include <mbgl/util/tiny_sdf.hpp>
+
+#include <protozero/pbf_reader.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+namespace {
+
+// CJK Unified Ideographs, and Hangul Syllables.
+const GlyphRange localBlocks[] = { { 0x4E00, 0x9FFF }, { 0xAC00, 0xD7AF } };
+
+bool isValid(const GlyphMetrics& metrics) {
+    return metrics.width < 256 && metrics.height < 256 &&
+           metrics.left >= -128 && metrics.left < 128 &&
+           metrics.top >= -128 && metrics.top < 128 &&
+           metrics.advance < 256;
+}
+
+} // namespace
+
+GlyphPBFWorker::GlyphPBFWorker(ActorRef<GlyphPBFWorker>, ActorRef<GlyphPBF> parent_)
+    : parent(std::move(parent_)) {
+}
+
+void GlyphPBFWorker::parse(GlyphRange glyphRange, std::shared_ptr<const std::string> data) {
+    std::shared_ptr<const GlyphCache::Glyphs> glyphs;
+    try {
+        glyphs = std::make_shared<GlyphCache::Glyphs>(parseGlyphPBF(glyphRange, std::move(data)));
+    } catch (...) {
+        parent.invoke(&GlyphPBF::onParseError, std::current_exception());
+        return;
+    }
+    parent.invoke(&GlyphPBF::onParsed, std::move(glyphs));
+}
+
+void GlyphPBFWorker::rasterize(FontStack fontStack, GlyphRange glyphRange, std::shared_ptr<LocalGlyphRasterizer> rasterizer) {
+    parent.invoke(&GlyphPBF::onRasterized,
+                  std::make_shared<GlyphCache::Glyphs>(rasterizeLocalGlyphs(*rasterizer, fontStack, glyphRange)));
+}
+
+GlyphCache::Glyphs parseGlyphPBF(const GlyphRange& glyphRange, std::shared_ptr<const std::string> data) {
+    GlyphCache::Glyphs result;
+    protozero::pbf_reader glyphs_pbf(*data);
+
+    while (glyphs_pbf.next(1)) {
+        auto fontstack_pbf = glyphs_pbf.get_message();
+        while (fontstack_pbf.next(3)) {
+            auto glyph_pbf = fontstack_pbf.get_message();
+
+            SDFGlyph glyph;
+            protozero::data_view glyphData;
+
+            bool hasID = false, hasWidth = false, hasHeight = false, hasLeft = false,
+                 hasTop = false, hasAdvance = false;
+
+            while (glyph_pbf.next()) {
+                switch (glyph_pbf.tag()) {
+                case 1: // id
+                    glyph.id = glyph_pbf.get_uint32();
+                    hasID = true;
+                    break;
+                case 2: // bitmap
+                    glyphData = glyph_pbf.get_view();
+                    break;
+                case 3: // width
+                    glyph.metrics.width = glyph_pbf.get_uint32();
+                    hasWidth = true;
+                    break;
+                case 4: // height
+                    glyph.metrics.height = glyph_pbf.get_uint32();
+                    hasHeight = true;
+                    break;
+                case 5: // left
+                    glyph.metrics.left = glyph_pbf.get_sint32();
+                    hasLeft = true;
+                    break;
+                case 6: // top
+                    glyph.metrics.top = glyph_pbf.get_sint32();
+                    hasTop = true;
+                    break;
+                case 7: // advance
+                    glyph.metrics.advance = glyph_pbf.get_uint32();
+                    hasAdvance = true;
+                    break;
+                default:
+                    glyph_pbf.skip();
+                    break;
+                }
+            }
+
+            // Only treat this glyph as a correct glyph if it has all required fields. It also
+            // needs to satisfy a few metrics conditions that ensure that the glyph isn't bogus.
+            // All other glyphs are malformed.  We're also discarding all glyphs that are outside
+            // the expected glyph range.
+            if (!hasID || !hasWidth || !hasHeight || !hasLeft || !hasTop || !hasAdvance ||
+                !isValid(glyph.metrics) ||
+                glyph.id < glyphRange.first || glyph.id > glyphRange.second) {
+                continue;
+            }
+
+            // If the area of width/height is non-zero, we need to adjust the expected size
+            // with the implicit border size, otherwise we expect there to be no bitmap at all.
+            if (glyph.metrics.width && glyph.metrics.height) {
+                const Size size {
+                    glyph.metrics.width + 2 * SDFGlyph::borderSize,
+                    glyph.metrics.height + 2 * SDFGlyph::borderSize
+                };
+
+                if (size.area() != glyphData.size()) {
+                    continue;
+                }
+
+                glyph.bitmap = SDFBitmap(size, data, glyphData.data() - data->data());
+            }
+
+            result.push_back(std::move(glyph));
+        }
+    }
+
+    return result;
+}
+
+bool isLocalGlyphRange(const GlyphRange& glyphRange) {
+    return std::any_of(std::begin(localBlocks), std::end(localBlocks), [&] (const GlyphRange& block) {
+        return glyphRange.first <= block.second && glyphRange.second >= block.first;
+    });
+}
+
+GlyphCache::Glyphs rasterizeLocalGlyphs(LocalGlyphRasterizer& rasterizer, const FontStack& fontStack, const GlyphRange& glyphRange) {
+    // TinySDF's defaults, which match the distance fields of glyph PBFs.
+    const double radius = 8;
+    const double cutoff = 0.25;
+    const uint32_t border = SDFGlyph::borderSize;
+
+    GlyphCache::Glyphs result;
+    std::vector<AlphaImage> sdfs;
+    std::size_t bytes = 0;
+
+    for (const auto& block : localBlocks) {
+        const uint32_t first = std::max(glyphRange.first, block.first);
+        const uint32_t last = std::min(glyphRange.second, block.second);
+        for (uint32_t id = first; id <= last; id++) {
+            optional<LocalGlyphRasterizer::Glyph> glyph = rasterizer.rasterize(fontStack, char16_t(id));
+            if (!glyph) {
+                continue;
+            }
+
+            SDFGlyph sdfGlyph;
+            sdfGlyph.id = id;
+            sdfGlyph.metrics.width = glyph->image.size.width;
+            sdfGlyph.metrics.height = glyph->image.size.height;
+            sdfGlyph.metrics.left = glyph->left;
+            sdfGlyph.metrics.top = glyph->top;
+            sdfGlyph.metrics.advance = glyph->advance;
+            if (!isValid(sdfGlyph.metrics)) {
+                continue;
+            }
+
+            AlphaImage sdf;
+            if (glyph->image.valid()) {
+                AlphaImage raster({ glyph->image.size.width + 2 * border, glyph->image.size.height + 2 * border });
+                raster.fill(0);
+                AlphaImage::copy(glyph->image, raster, { 0, 0 }, { border, border }, glyph->image.size);
+                sdf = util::transformRasterToSDF(raster, radius, cutoff);
+                bytes += sdf.bytes();
+            }
+
+            result.push_back(std::move(sdfGlyph));
+            sdfs.push_back(std::move(sdf));
+        }
+    }
+
+    auto data = std::make_shared<std::string>();
+    data->reserve(bytes);
+    for (std::size_t i = 0; i < result.size(); i++) {
+        if (sdfs[i].valid()) {
+            const std::size_t offset = data->size();
+            data->append(reinterpret_cast<const char*>(sdfs[i].data.get()), sdfs[i].bytes());
+            result[i].bitmap = SDFBitmap(sdfs[i].size, data, offset);
+        }
+    }
+
+    return result;
+}
+
+} // namespace mbgl
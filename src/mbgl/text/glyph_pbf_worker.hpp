@@ -0,0 +1,38 @@
+#pragma once
+
+#include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/text/glyph_cache.hpp>
+#include <mbgl/text/glyph_range.hpp>
+#include <mbgl/util/font_stack.hpp>
+
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+class GlyphPBF;
+class LocalGlyphRasterizer;
+
+// Parses glyph ranges off the map thread, since a CJK range holds a few hundred glyphs.
+// The ranges of a style's fonts arrive together and are parsed in parallel, one worker each.
+class GlyphPBFWorker {
+public:
+    GlyphPBFWorker(ActorRef<GlyphPBFWorker>, ActorRef<GlyphPBF>);
+
+    void parse(GlyphRange, std::shared_ptr<const std::string> data);
+    void rasterize(FontStack, GlyphRange, std::shared_ptr<LocalGlyphRasterizer>);
+
+private:
+    ActorRef<GlyphPBF> parent;
+};
+
+// The bitmaps of the glyphs are views into `data`. Throws if it isn't a glyph PBF.
+GlyphCache::Glyphs parseGlyphPBF(const GlyphRange&, std::shared_ptr<const std::string> data);
+
+// Whether the range has code points a `LocalGlyphRasterizer` draws.
+bool isLocalGlyphRange(const GlyphRange&);
+
+// The glyphs of the range the rasterizer draws, sharing one buffer for their bitmaps.
+GlyphCache::Glyphs rasterizeLocalGlyphs(LocalGlyphRasterizer&, const FontStack&, const GlyphRange&);
+
+} // namespace mbgl
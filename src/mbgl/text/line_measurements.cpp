@@ -0,0 +1,63 @@
+#include <mbgl/text/line_measurements.hpp>
+#include <mbgl/util/math.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <cmath>
+
+namespace mbgl {
+
+LineMeasurements::LineMeasurements(const GeometryCoordinates& line)
+    : distances(line.size()),
+      angles(line.empty() ? 0 : line.size() - 1),
+      turns(line.size()) {
+    const std::size_t segments = angles.size();
+
+    // Each pass computes independent values, so that compilers can vectorize all but the
+    // arc tangents and the running sum.
+    std::vector<float> lengths(segments);
+    std::vector<float> reversed(segments);
+    for (std::size_t i = 0; i < segments; i++) {
+        lengths[i] = util::dist<float>(line[i], line[i + 1]);
+        angles[i] = util::angle_to(line[i + 1], line[i]);
+        // Turns are measured between the reversed segments, which differs from `angles`
+        // for segments of no length.
+        reversed[i] = util::angle_to(line[i], line[i + 1]);
+    }
+
+    float distance = 0;
+    for (std::size_t i = 0; i < segments; i++) {
+        distances[i] = distance;
+        distance += lengths[i];
+    }
+    if (!line.empty()) {
+        distances[segments] = distance;
+    }
+
+    const float pi = M_PI;
+    for (std::size_t i = 1; i < segments; i++) {
+        float turn = reversed[i - 1] - reversed[i];
+        turn = turn > pi ? turn - 2 * pi : turn;
+        turn = turn < -pi ? turn + 2 * pi : turn;
+        turns[i] = std::fabs(turn);
+    }
+}
+
+std::size_t LineMeasurementCache::LineHash::operator()(const GeometryCoordinates& line) const {
+    std::size_t seed = 0;
+    for (const auto& point : line) {
+        boost::hash_combine(seed, point.x);
+        boost::hash_combine(seed, point.y);
+    }
+    return seed;
+}
+
+const LineMeasurements& LineMeasurementCache::get(const GeometryCoordinates& line) {
+    auto it = entries.find(line);
+    if (it == entries.end()) {
+        it = entries.emplace(line, LineMeasurements(line)).first;
+    }
+    return it->second;
+}
+
+} // namespace mbgl
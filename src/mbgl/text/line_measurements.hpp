@@ -0,0 +1,48 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+// Lengths and angles along a line, measured once for all the anchors placed on it.
+class LineMeasurements {
+public:
+    explicit LineMeasurements(const GeometryCoordinates&);
+
+    float length() const {
+        return distances.empty() ? 0 : distances.back();
+    }
+
+    // The distance along the line to each of its points.
+    std::vector<float> distances;
+
+    // The angle of each segment.
+    std::vector<float> angles;
+
+    // The change of direction at each point, from 0 to pi. None at either end of the line.
+    std::vector<float> turns;
+};
+
+// Measurements of the lines of a tile, shared by the symbol layers labelling the same lines.
+class LineMeasurementCache : private util::noncopyable {
+public:
+    const LineMeasurements& get(const GeometryCoordinates&);
+
+    void clear() {
+        entries.clear();
+    }
+
+private:
+    struct LineHash {
+        std::size_t operator()(const GeometryCoordinates&) const;
+    };
+
+    std::unordered_map<GeometryCoordinates, LineMeasurements, LineHash> entries;
+};
+
+} // namespace mbgl
@@ -0,0 +1,110 @@
+#include <mbgl/text/shaping_cache.hpp>
+
+#include <boost/functional/hash.hpp>
+
+namespace mbgl {
+
+bool ShapingCache::Key::operator==(const Key& rhs) const {
+    return text == rhs.text &&
+           fontStack == rhs.fontStack &&
+           maxWidth == rhs.maxWidth &&
+           lineHeight == rhs.lineHeight &&
+           horizontalAlign == rhs.horizontalAlign &&
+           verticalAlign == rhs.verticalAlign &&
+           justify == rhs.justify &&
+           spacing == rhs.spacing &&
+           translate == rhs.translate &&
+           verticalHeight == rhs.verticalHeight &&
+           writingMode == rhs.writingMode;
+}
+
+std::size_t ShapingCache::KeyHash::operator()(const Key& key) const {
+    std::size_t seed = std::hash<std::u16string>()(key.text);
+    boost::hash_combine(seed, FontStackHash()(key.fontStack));
+    boost::hash_combine(seed, key.maxWidth);
+    boost::hash_combine(seed, key.lineHeight);
+    boost::hash_combine(seed, key.horizontalAlign);
+    boost::hash_combine(seed, key.verticalAlign);
+    boost::hash_combine(seed, key.justify);
+    boost::hash_combine(seed, key.spacing);
+    boost::hash_combine(seed, key.translate.x);
+    boost::hash_combine(seed, key.translate.y);
+    boost::hash_combine(seed, key.verticalHeight);
+    boost::hash_combine(seed, static_cast<uint8_t>(key.writingMode));
+    return seed;
+}
+
+ShapingCache::ShapingCache(std::size_t maximumSize_)
+    : maximumSize(maximumSize_) {
+}
+
+optional<Shaping> ShapingCache::get(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        stats.misses++;
+        return {};
+    }
+
+    stats.hits++;
+    lru.splice(lru.begin(), lru, it->second.lru);
+    return it->second.shaping;
+}
+
+void ShapingCache::put(Key key, Shaping shaping) {
+    // Roughly, with the overhead of a map node and a list node.
+    const std::size_t entrySize = sizeof(Key) + sizeof(Entry) + 64 +
+        key.text.size() * sizeof(char16_t) +
+        shaping.positionedGlyphs.size() * sizeof(PositionedGlyph);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        size -= it->second.size;
+        lru.erase(it->second.lru);
+        entries.erase(it);
+    }
+
+    it = entries.emplace(std::move(key), Entry { std::move(shaping), entrySize, {} }).first;
+    lru.push_front(&it->first);
+    it->second.lru = lru.begin();
+    size += entrySize;
+
+    evict();
+}
+
+void ShapingCache::setMaximumSize(std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maximumSize = bytes;
+    evict();
+}
+
+std::size_t ShapingCache::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return size;
+}
+
+ShapingCache::Stats ShapingCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void ShapingCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    lru.clear();
+    size = 0;
+}
+
+void ShapingCache::evict() {
+    while (size > maximumSize && !lru.empty()) {
+        auto it = entries.find(*lru.back());
+        size -= it->second.size;
+        lru.pop_back();
+        entries.erase(it);
+    }
+}
+
+} // namespace mbgl
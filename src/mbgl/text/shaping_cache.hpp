@@ -0,0 +1,89 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/geometry.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+/*
+    Shaped text, kept across tiles and zoom levels: street names and POI labels repeat
+    across neighbouring tiles, and are shaped the same way wherever their layout matches.
+    A cache belongs to a glyph atlas, since shapings depend on its glyph metrics. Once the
+    entries take up more than the maximum size, the least recently used ones are evicted.
+
+    All methods are thread-safe.
+*/
+class ShapingCache : private util::noncopyable {
+public:
+    // The arguments of `GlyphSet::getShaping`.
+    struct Key {
+        std::u16string text;
+        FontStack fontStack;
+        float maxWidth;
+        float lineHeight;
+        float horizontalAlign;
+        float verticalAlign;
+        float justify;
+        float spacing;
+        Point<float> translate;
+        float verticalHeight;
+        WritingModeType writingMode;
+
+        bool operator==(const Key&) const;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+
+        double hitRate() const {
+            return hits + misses ? double(hits) / (hits + misses) : 0;
+        }
+    };
+
+    explicit ShapingCache(std::size_t maximumSize);
+
+    // Counts a hit or a miss.
+    optional<Shaping> get(const Key&);
+    void put(Key, Shaping);
+
+    void setMaximumSize(std::size_t bytes);
+    std::size_t getSize() const;
+    Stats getStats() const;
+    void clear();
+
+private:
+    void evict();
+
+    struct KeyHash {
+        std::size_t operator()(const Key&) const;
+    };
+
+    struct Entry {
+        Shaping shaping;
+        std::size_t size;
+        std::list<const Key*>::iterator lru;
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+
+    // Keys of the entries, from the most to the least recently used.
+    std::list<const Key*> lru;
+
+    std::size_t size = 0;
+    std::size_t maximumSize;
+    Stats stats;
+};
+
+} // namespace mbgl
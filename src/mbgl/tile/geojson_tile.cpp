@@ -1,8 +1,10 @@
 #include <mbgl/tile/geojson_tile.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/run_loop.hpp>
 
 #include <mapbox/geojsonvt.hpp>
-#include <supercluster.hpp>
+
+#include <cassert>
 
 namespace mbgl {
 
@@ -47,15 +49,23 @@ public:
         }
         return optional<Value>();
     }
+
+    const Value* findValue(const std::string& key, optional<Value>&) const override {
+        auto it = feature.properties.find(key);
+        return it != feature.properties.end() ? &it->second : nullptr;
+    }
 };
 
 class GeoJSONTileData : public GeometryTileData,
                         public GeometryTileLayer {
 public:
-    mapbox::geometry::feature_collection<int16_t> features;
+    // Shared with the index the features come from, or with other copies of the data: the
+    // features are never modified, so the data can be cloned without copying them.
+    std::shared_ptr<const mapbox::geometry::feature_collection<int16_t>> features;
 
-    GeoJSONTileData(mapbox::geometry::feature_collection<int16_t> features_)
+    GeoJSONTileData(std::shared_ptr<const mapbox::geometry::feature_collection<int16_t>> features_)
         : features(std::move(features_)) {
+        assert(features);
     }
 
     std::unique_ptr<GeometryTileData> clone() const override {
@@ -71,24 +81,36 @@ public:
     }
 
     std::size_t featureCount() const override {
-        return features.size();
+        return features->size();
     }
 
     std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override {
-        return std::make_unique<GeoJSONTileFeature>(features[i]);
+        return std::make_unique<GeoJSONTileFeature>((*features)[i]);
     }
 };
 
 GeoJSONTile::GeoJSONTile(const OverscaledTileID& overscaledTileID,
                          std::string sourceID_,
                          const style::UpdateParameters& parameters)
-    : GeometryTile(overscaledTileID, sourceID_, parameters) {
+    : GeometryTile(overscaledTileID, sourceID_, parameters),
+      mailbox(std::make_shared<Mailbox>(*util::RunLoop::Get())) {
 }
 
 void GeoJSONTile::updateData(const mapbox::geometry::feature_collection<int16_t>& features) {
-    setData(std::make_unique<GeoJSONTileData>(features));
+    updateData(std::make_shared<const mapbox::geometry::feature_collection<int16_t>>(features));
+}
+
+void GeoJSONTile::updateData(std::shared_ptr<const mapbox::geometry::feature_collection<int16_t>> features) {
+    setData(std::make_unique<GeoJSONTileData>(std::move(features)));
+}
+
+ActorRef<GeoJSONTile> GeoJSONTile::self() {
+    return ActorRef<GeoJSONTile>(*this, mailbox);
+}
+
+void GeoJSONTile::onData(std::shared_ptr<const mapbox::geometry::feature_collection<int16_t>> features) {
+    updateData(std::move(features));
 }
 
-void GeoJSONTile::setNecessity(Necessity) {}
 
 } // namespace mbgl
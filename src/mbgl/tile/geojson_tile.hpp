@@ -1,8 +1,11 @@
 #pragma once
 
+#include <mbgl/actor/actor_ref.hpp>
 #include <mbgl/tile/geometry_tile.hpp>
 #include <mbgl/util/feature.hpp>
 
+#include <memory>
+
 namespace mbgl {
 
 namespace style {
@@ -17,7 +20,16 @@ public:
 
     void updateData(const mapbox::geometry::feature_collection<int16_t>&);
 
-    void setNecessity(Necessity) final;
+    // Lays out the features without copying them; they must not change from then on.
+    void updateData(std::shared_ptr<const mapbox::geometry::feature_collection<int16_t>>);
+
+    // Where the worker of the source sends the features once it has sliced them. Until the
+    // first arrive, the tile isn't renderable.
+    ActorRef<GeoJSONTile> self();
+    void onData(std::shared_ptr<const mapbox::geometry::feature_collection<int16_t>>);
+
+private:
+    std::shared_ptr<Mailbox> mailbox;
 };
 
 } // namespace mbgl
@@ -4,21 +4,43 @@
 #include <mbgl/tile/tile_observer.hpp>
 #include <mbgl/style/update_parameters.hpp>
 #include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/group_by_layout.hpp>
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/style/layers/custom_layer.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/renderer/symbol_bucket.hpp>
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/map/transform_state.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/map/query.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+
+#include <algorithm>
+#include <unordered_set>
 
 namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+// Layers sharing a bucket count it once.
+std::size_t byteSize(const std::unordered_map<std::string, std::shared_ptr<Bucket>>& buckets) {
+    std::unordered_set<const Bucket*> counted;
+    std::size_t result = 0;
+    for (const auto& pair : buckets) {
+        if (counted.insert(pair.second.get()).second) {
+            result += pair.second->getByteSize();
+        }
+    }
+    return result;
+}
+
+} // namespace
+
 GeometryTile::GeometryTile(const OverscaledTileID& id_,
                            std::string sourceID_,
                            const style::UpdateParameters& parameters)
@@ -28,10 +50,17 @@ GeometryTile::GeometryTile(const OverscaledTileID& id_,
       mailbox(std::make_shared<Mailbox>(*util::RunLoop::Get())),
       worker(parameters.workerScheduler,
              ActorRef<GeometryTile>(*this, mailbox),
+             parameters.workerScheduler,
              id_,
              *parameters.style.glyphAtlas,
              obsolete,
-             parameters.mode) {
+             parameters.mode,
+             parameters.pixelRatio,
+             parameters.style.layoutCache,
+             parameters.style.layerProfiler) {
+    // The worker receives bursts of cheap state-change messages (set{Data,Layers,Placement},
+    // coalesced); process several per turn instead of going through the pool for each.
+    worker.setDrainPolicy({ 16, Milliseconds(1) });
 }
 
 GeometryTile::~GeometryTile() {
@@ -42,6 +71,24 @@ void GeometryTile::cancel() {
     obsolete = true;
 }
 
+void GeometryTile::setNecessity(Necessity necessity) {
+    // Lay out tiles that are needed for the current viewport before fallback and prefetched tiles.
+    worker.setPriority(necessity == Necessity::Required ? Mailbox::Priority::High
+                                                        : Mailbox::Priority::Low);
+}
+
+void GeometryTile::setRetainsData(bool retains) {
+    if (retains != retainsData) {
+        retainsData = retains;
+        worker.invoke(&GeometryTileWorker::setRetainsData, retains);
+    }
+    if (!retainsData && data) {
+        if (auto unparsed = data->unparsed()) {
+            data = std::move(unparsed);
+        }
+    }
+}
+
 void GeometryTile::setError(std::exception_ptr err) {
     observer->onTileError(*this, err);
 }
@@ -94,10 +141,13 @@ void GeometryTile::redoLayout() {
             layer->baseImpl->source != sourceID ||
             id.overscaledZ < std::floor(layer->baseImpl->minZoom) ||
             id.overscaledZ >= std::ceil(layer->baseImpl->maxZoom) ||
-            layer->baseImpl->visibility == VisibilityType::None) {
+            layer->baseImpl->visibility == VisibilityType::None ||
+            layer->baseImpl->rendersNothing) {
             continue;
         }
 
+        // Made on the style's layer, once per revision, for the clones of every tile to keep.
+        layoutKey(*layer);
         copy.push_back(layer->baseImpl->clone());
     }
 
@@ -105,20 +155,85 @@ void GeometryTile::redoLayout() {
     worker.invoke(&GeometryTileWorker::setLayers, std::move(copy), correlationID);
 }
 
+void GeometryTile::setFeatureIndexing(bool enabled) {
+    if (enabled == indexesFeatures) {
+        return;
+    }
+
+    indexesFeatures = enabled;
+    worker.invoke(&GeometryTileWorker::setFeatureIndexing, enabled);
+
+    if (indexesFeatures) {
+        // The worker lays the tile out again, to build the index.
+        if (availableData == DataAvailability::All) {
+            availableData = DataAvailability::Some;
+        }
+    } else if (featureIndex) {
+        layoutByteSize -= featureIndex->getByteSize();
+        featureIndex.reset();
+    }
+}
+
+void GeometryTile::setSimplificationTolerance(float pixels) {
+    if (pixels == simplificationTolerance) {
+        return;
+    }
+
+    simplificationTolerance = pixels;
+    worker.invoke(&GeometryTileWorker::setSimplificationTolerance, pixels);
+
+    // The worker lays the tile out again.
+    if (availableData == DataAvailability::All) {
+        availableData = DataAvailability::Some;
+    }
+}
+
 void GeometryTile::onLayout(LayoutResult result) {
+    if (!timeline.laidOut) {
+        timeline.parsed = result.parsed;
+        timeline.laidOut = Clock::now();
+    }
+
     availableData = DataAvailability::Some;
     nonSymbolBuckets = std::move(result.nonSymbolBuckets);
-    featureIndex = std::move(result.featureIndex);
+    // A layout started before indexing was turned off may still have built one.
+    featureIndex = indexesFeatures ? std::move(result.featureIndex) : nullptr;
     data = std::move(result.tileData);
+    if (!retainsData && data) {
+        if (auto unparsed = data->unparsed()) {
+            data = std::move(unparsed);
+        }
+    }
+    layoutByteSize = byteSize(nonSymbolBuckets) + (featureIndex ? featureIndex->getByteSize() : 0);
     observer->onTileChanged(*this);
 }
 
 void GeometryTile::onPlacement(PlacementResult result) {
+    if (!timeline.placed) {
+        timeline.placed = Clock::now();
+    }
+
     if (result.correlationID == correlationID) {
         availableData = DataAvailability::All;
     }
     symbolBuckets = std::move(result.symbolBuckets);
     collisionTile = std::move(result.collisionTile);
+    placementByteSize = byteSize(symbolBuckets);
+    observer->onTileChanged(*this);
+}
+
+void GeometryTile::onPlacementUpdate(PlacementUpdate update) {
+    if (update.correlationID == correlationID) {
+        availableData = DataAvailability::All;
+    }
+    for (auto& pair : update.symbolPlacements) {
+        const auto it = symbolBuckets.find(pair.first);
+        if (it != symbolBuckets.end()) {
+            // Layers sharing a bucket share its placement.
+            static_cast<SymbolBucket&>(*it->second).setPlacement(pair.second);
+        }
+    }
+    collisionTile = std::move(update.collisionTile);
     observer->onTileChanged(*this);
 }
 
@@ -138,24 +253,127 @@ Bucket* GeometryTile::getBucket(const Layer& layer) {
     return it->second.get();
 }
 
+std::size_t GeometryTile::getByteSize() const {
+    return layoutByteSize + placementByteSize;
+}
+
+void GeometryTile::addMemoryUsage(MemoryStats::Source& source) const {
+    // Layers sharing a bucket count it once.
+    std::unordered_set<const Bucket*> counted;
+    for (const auto& buckets : { &nonSymbolBuckets, &symbolBuckets }) {
+        for (const auto& pair : *buckets) {
+            if (counted.insert(pair.second.get()).second) {
+                pair.second->addMemoryUsage(source);
+            }
+        }
+    }
+    if (featureIndex) {
+        source.featureIndexBytes += featureIndex->getByteSize();
+    }
+    if (data) {
+        source.tileDataBytes += dataSize;
+    }
+}
+
+std::size_t GeometryTile::releaseRetainedData() {
+    std::size_t result = 0;
+    for (const auto& buckets : { &nonSymbolBuckets, &symbolBuckets }) {
+        for (const auto& pair : *buckets) {
+            result += pair.second->releaseRetainedData();
+        }
+    }
+    return result;
+}
+
+void GeometryTile::uploadBuckets(gl::Context& context) {
+    for (const auto& buckets : { &nonSymbolBuckets, &symbolBuckets }) {
+        for (const auto& pair : *buckets) {
+            if (pair.second->needsUpload()) {
+                pair.second->upload(context);
+                context.bucketUploads++;
+            }
+        }
+    }
+}
+
 void GeometryTile::queryRenderedFeatures(
     std::unordered_map<std::string, std::vector<Feature>>& result,
     const GeometryCoordinates& queryGeometry,
     const TransformState& transformState,
-    const QueryOptions& options) {
+    const QueryOptions& options,
+    FeatureDetail detail) {
 
     if (!featureIndex || !data) return;
 
+    // Unretained data is parsed for this query only.
+    const std::unique_ptr<GeometryTileData> parsed = retainsData ? nullptr : data->unparsed();
+
     featureIndex->query(result,
                         queryGeometry,
                         transformState.getAngle(),
                         util::tileSize * id.overscaleFactor(),
                         std::pow(2, transformState.getZoom() - id.overscaledZ),
                         options,
-                        *data,
+                        detail,
+                        parsed ? *parsed : *data,
                         id.canonical,
                         style,
                         collisionTile.get());
 }
 
+// Whether the bounding box of the geometries intersects the box.
+static bool intersects(const GeometryBuffer& geometries, const mapbox::geometry::box<int16_t>& box) {
+    bool empty = true;
+    mapbox::geometry::box<int16_t> envelope { { 0, 0 }, { 0, 0 } };
+    for (const auto& ring : geometries) {
+        for (const auto& point : ring) {
+            if (empty) {
+                envelope = { point, point };
+                empty = false;
+            }
+            envelope.min.x = std::min(envelope.min.x, point.x);
+            envelope.min.y = std::min(envelope.min.y, point.y);
+            envelope.max.x = std::max(envelope.max.x, point.x);
+            envelope.max.y = std::max(envelope.max.y, point.y);
+        }
+    }
+    return !empty &&
+        envelope.min.x <= box.max.x && envelope.max.x >= box.min.x &&
+        envelope.min.y <= box.max.y && envelope.max.y >= box.min.y;
+}
+
+void GeometryTile::querySourceFeatures(
+    std::vector<Feature>& result,
+    const std::vector<std::string>& sourceLayers,
+    const style::CompiledFilter& filter,
+    const optional<mapbox::geometry::box<int16_t>>& bounds) const {
+
+    if (!data) return;
+
+    // Unretained data is parsed for this query only.
+    const std::unique_ptr<GeometryTileData> parsed = retainsData ? nullptr : data->unparsed();
+    const GeometryTileData& queried = parsed ? *parsed : *data;
+
+    GeometryBuffer geometries;
+
+    for (const auto& sourceLayer : sourceLayers) {
+        const GeometryTileLayer* layer = queried.getLayer(sourceLayer);
+        if (!layer) continue;
+
+        const std::size_t featureCount = layer->featureCount();
+        for (std::size_t i = 0; i < featureCount; i++) {
+            auto feature = layer->getFeature(i);
+            if (!filter(*feature)) continue;
+
+            // The filter is cheaper to test than the geometry is to decode.
+            if (bounds) {
+                feature->readGeometries(geometries);
+                if (!intersects(geometries, *bounds)) continue;
+            }
+
+            result.push_back(convertFeature(*feature, id.canonical));
+        }
+    }
+}
+
 } // namespace mbgl
@@ -16,6 +16,7 @@ namespace mbgl {
 class GeometryTileData;
 class FeatureIndex;
 class CollisionTile;
+class SymbolBucketPlacement;
 
 namespace style {
 class Style;
@@ -31,12 +32,21 @@ public:
 
     ~GeometryTile() override;
 
+    void setNecessity(Necessity) override;
+
+    // Whether the tile and its worker keep the parsed tile data after layout. When they don't,
+    // only the buffer it was parsed from is kept, and parsed again for each query and layout.
+    // Retained by default.
+    void setRetainsData(bool);
+
     void setError(std::exception_ptr);
     void setData(std::unique_ptr<const GeometryTileData>);
 
     void setPlacementConfig(const PlacementConfig&) override;
     void symbolDependenciesChanged() override;
     void redoLayout() override;
+    void setFeatureIndexing(bool) override;
+    void setSimplificationTolerance(float) override;
 
     Bucket* getBucket(const style::Layer&) override;
 
@@ -44,7 +54,14 @@ public:
             std::unordered_map<std::string, std::vector<Feature>>& result,
             const GeometryCoordinates& queryGeometry,
             const TransformState&,
-            const QueryOptions& options) override;
+            const QueryOptions& options,
+            FeatureDetail) override;
+
+    void querySourceFeatures(
+            std::vector<Feature>& result,
+            const std::vector<std::string>& sourceLayers,
+            const style::CompiledFilter&,
+            const optional<mapbox::geometry::box<int16_t>>& bounds) const override;
 
     void cancel() override;
 
@@ -54,6 +71,8 @@ public:
         std::unique_ptr<FeatureIndex> featureIndex;
         std::unique_ptr<GeometryTileData> tileData;
         uint64_t correlationID;
+        // When the worker had parsed the layers of the data.
+        TimePoint parsed;
     };
     void onLayout(LayoutResult);
 
@@ -65,8 +84,25 @@ public:
     };
     void onPlacement(PlacementResult);
 
+    // A new placement of the symbol buckets of the last `PlacementResult`, for a new
+    // placement config; the buckets keep their layout.
+    class PlacementUpdate {
+    public:
+        std::unordered_map<std::string, std::shared_ptr<SymbolBucketPlacement>> symbolPlacements;
+        std::unique_ptr<CollisionTile> collisionTile;
+        uint64_t correlationID;
+    };
+    void onPlacementUpdate(PlacementUpdate);
+
     void onError(std::exception_ptr);
 
+    std::size_t getByteSize() const override;
+    void addMemoryUsage(MemoryStats::Source&) const override;
+    std::size_t releaseRetainedData() override;
+
+protected:
+    void uploadBuckets(gl::Context&) override;
+
 private:
     const std::string sourceID;
     style::Style& style;
@@ -80,12 +116,20 @@ private:
     uint64_t correlationID = 0;
     optional<PlacementConfig> requestedConfig;
 
+    bool retainsData = true;
+    bool indexesFeatures = true;
+    float simplificationTolerance = 0;
+
     std::unordered_map<std::string, std::shared_ptr<Bucket>> nonSymbolBuckets;
     std::unique_ptr<FeatureIndex> featureIndex;
     std::unique_ptr<const GeometryTileData> data;
 
     std::unordered_map<std::string, std::shared_ptr<Bucket>> symbolBuckets;
     std::unique_ptr<CollisionTile> collisionTile;
+
+    // Measured as the results arrive, before their buckets are uploaded.
+    std::size_t layoutByteSize = 0;
+    std::size_t placementByteSize = 0;
 };
 
 } // namespace mbgl
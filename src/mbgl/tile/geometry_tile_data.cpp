@@ -3,9 +3,12 @@
 
 #include <clipper/clipper.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
-static double signedArea(const GeometryCoordinates& ring) {
+template <class Ring>
+static double signedArea(const Ring& ring) {
     double sum = 0;
 
     for (std::size_t i = 0, len = ring.size(), j = len - 1; i < len; j = i++) {
@@ -66,7 +69,187 @@ static void processPolynodeBranch(ClipperLib::PolyNode* polynode, GeometryCollec
     }
 }
 
+namespace {
+
+struct Edge {
+    GeometryCoordinate a;
+    GeometryCoordinate b;
+    std::size_t ring;
+    std::size_t index;
+    int16_t minX;
+    int16_t maxX;
+};
+
+int64_t cross(const GeometryCoordinate& o, const GeometryCoordinate& a, const GeometryCoordinate& b) {
+    return int64_t(a.x - o.x) * (b.y - o.y) - int64_t(a.y - o.y) * (b.x - o.x);
+}
+
+bool onSegment(const GeometryCoordinate& p, const GeometryCoordinate& a, const GeometryCoordinate& b) {
+    return std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x) &&
+           std::min(a.y, b.y) <= p.y && p.y <= std::max(a.y, b.y);
+}
+
+// Whether two segments have any point in common, including end points.
+bool touches(const Edge& e, const Edge& f) {
+    const int64_t d1 = cross(f.a, f.b, e.a);
+    const int64_t d2 = cross(f.a, f.b, e.b);
+    const int64_t d3 = cross(e.a, e.b, f.a);
+    const int64_t d4 = cross(e.a, e.b, f.b);
+    if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) {
+        return true;
+    }
+    return (d1 == 0 && onSegment(e.a, f.a, f.b)) || (d2 == 0 && onSegment(e.b, f.a, f.b)) ||
+           (d3 == 0 && onSegment(f.a, e.a, e.b)) || (d4 == 0 && onSegment(f.b, e.a, e.b));
+}
+
+// Even-odd test of a point that is on none of the ring's edges.
+template <class Ring>
+bool contains(const Ring& ring, const GeometryCoordinate& p) {
+    bool inside = false;
+    for (std::size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+        const GeometryCoordinate& a = ring[i];
+        const GeometryCoordinate& b = ring[j];
+        if ((a.y > p.y) != (b.y > p.y) &&
+            (cross(a, b, p) > 0) == (b.y > a.y)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+} // namespace
+
+// Whether the rings are already what `fixupPolygons` would make of them, up to redundant
+// points: closed, strictly simple rings, none touching another, each exterior ring wound
+// positively and followed by its holes. Anything this doesn't recognize is left to Clipper.
+template <class Rings>
+static bool isValidPolygonImpl(const Rings& rings) {
+    // Containment is tested ring against ring; many rings are left to Clipper.
+    constexpr std::size_t maxRings = 32;
+    if (rings.empty() || rings.size() > maxRings) {
+        return false;
+    }
+
+    std::vector<Edge> edges;
+    std::vector<std::size_t> exteriors;
+    for (std::size_t r = 0; r < rings.size(); ++r) {
+        const auto& ring = rings[r];
+        if (ring.size() < 4 || !(ring.front() == ring.back())) {
+            return false;
+        }
+
+        const double area = signedArea(ring);
+        if (area == 0 || (r == 0 && area < 0)) {
+            return false;
+        }
+        if (area > 0) {
+            exteriors.push_back(r);
+        }
+
+        for (std::size_t i = 0; i + 1 < ring.size(); ++i) {
+            const GeometryCoordinate& a = ring[i];
+            const GeometryCoordinate& b = ring[i + 1];
+            if (a == b) {
+                return false;
+            }
+            edges.push_back({ a, b, r, i, std::min(a.x, b.x), std::max(a.x, b.x) });
+        }
+    }
+
+    // Sweeping over x, each edge is tested against the edges whose x ranges overlap its own.
+    // Rings that sweep back and forth over the same x range (and so need many tests) are
+    // left to Clipper.
+    std::sort(edges.begin(), edges.end(), [] (const Edge& e, const Edge& f) { return e.minX < f.minX; });
+    std::size_t tests = 0;
+    const std::size_t maxTests = 16 * edges.size();
+    std::vector<const Edge*> active;
+    for (const Edge& edge : edges) {
+        active.erase(std::remove_if(active.begin(), active.end(), [&] (const Edge* other) {
+            return other->maxX < edge.minX;
+        }), active.end());
+
+        for (const Edge* other : active) {
+            if (++tests > maxTests) {
+                return false;
+            }
+
+            const std::size_t ringEdges = rings[edge.ring].size() - 1;
+            const bool adjacent = edge.ring == other->ring &&
+                ((edge.index + 1) % ringEdges == other->index || (other->index + 1) % ringEdges == edge.index);
+            if (!adjacent) {
+                if (touches(edge, *other)) {
+                    return false;
+                }
+                continue;
+            }
+
+            // Consecutive edges share only their common point, unless they fold back on
+            // each other.
+            const Edge& first = (edge.index + 1) % ringEdges == other->index ? edge : *other;
+            const Edge& second = &first == &edge ? *other : edge;
+            if (cross(first.a, first.b, second.b) == 0 &&
+                int64_t(first.b.x - first.a.x) * (second.b.x - second.a.x) +
+                int64_t(first.b.y - first.a.y) * (second.b.y - second.a.y) < 0) {
+                return false;
+            }
+        }
+        active.push_back(&edge);
+    }
+
+    // With no edges touching, one point of a ring tells which side of another ring it lies
+    // on. Holes lie inside their exterior ring and outside each other; each polygon lies
+    // outside the others, or within one of their holes.
+    const auto polygonEnd = [&] (std::size_t p) {
+        return p + 1 < exteriors.size() ? exteriors[p + 1] : rings.size();
+    };
+    const auto inPolygon = [&] (std::size_t p, const GeometryCoordinate& point) {
+        if (!contains(rings[exteriors[p]], point)) {
+            return false;
+        }
+        for (std::size_t h = exteriors[p] + 1; h < polygonEnd(p); ++h) {
+            if (contains(rings[h], point)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (std::size_t p = 0; p < exteriors.size(); ++p) {
+        const std::size_t begin = exteriors[p];
+        for (std::size_t h = begin + 1; h < polygonEnd(p); ++h) {
+            if (!contains(rings[begin], rings[h].front())) {
+                return false;
+            }
+            for (std::size_t o = begin + 1; o < h; ++o) {
+                if (contains(rings[o], rings[h].front()) || contains(rings[h], rings[o].front())) {
+                    return false;
+                }
+            }
+        }
+
+        for (std::size_t q = 0; q < p; ++q) {
+            if (inPolygon(q, rings[begin].front()) || inPolygon(p, rings[exteriors[q]].front())) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool isValidPolygon(const GeometryCollection& rings) {
+    return isValidPolygonImpl(rings);
+}
+
+bool isValidPolygon(const GeometryBuffer& rings) {
+    return isValidPolygonImpl(rings);
+}
+
 GeometryCollection fixupPolygons(const GeometryCollection& rings) {
+    if (isValidPolygon(rings)) {
+        return rings;
+    }
+
     ClipperLib::Clipper clipper;
     clipper.StrictlySimple(true);
 
@@ -85,17 +268,18 @@ GeometryCollection fixupPolygons(const GeometryCollection& rings) {
     return result;
 }
 
-std::vector<GeometryCollection> classifyRings(const GeometryCollection& rings) {
-    std::vector<GeometryCollection> polygons;
+template <class Polygon, class Rings>
+static std::vector<Polygon> classifyRingsImpl(const Rings& rings) {
+    std::vector<Polygon> polygons;
 
     std::size_t len = rings.size();
 
     if (len <= 1) {
-        polygons.push_back(rings);
+        polygons.emplace_back(rings.begin(), rings.end());
         return polygons;
     }
 
-    GeometryCollection polygon;
+    Polygon polygon;
     int8_t ccw = 0;
 
     for (std::size_t i = 0; i < len; i++) {
@@ -121,7 +305,16 @@ std::vector<GeometryCollection> classifyRings(const GeometryCollection& rings) {
     return polygons;
 }
 
-void limitHoles(GeometryCollection& polygon, uint32_t maxHoles) {
+std::vector<GeometryCollection> classifyRings(const GeometryCollection& rings) {
+    return classifyRingsImpl<GeometryCollection>(rings);
+}
+
+std::vector<GeometryPolygonView> classifyRings(const GeometryBuffer& rings) {
+    return classifyRingsImpl<GeometryPolygonView>(rings);
+}
+
+template <class Polygon>
+static void limitHolesImpl(Polygon& polygon, uint32_t maxHoles) {
     if (polygon.size() > 1 + maxHoles) {
         std::nth_element(polygon.begin() + 1,
                          polygon.begin() + 1 + maxHoles,
@@ -129,8 +322,124 @@ void limitHoles(GeometryCollection& polygon, uint32_t maxHoles) {
                          [] (const auto& a, const auto& b) {
                              return std::fabs(signedArea(a)) > std::fabs(signedArea(b));
                          });
-        polygon.resize(1 + maxHoles);
+        polygon.erase(polygon.begin() + 1 + maxHoles, polygon.end());
+    }
+}
+
+void limitHoles(GeometryCollection& polygon, uint32_t maxHoles) {
+    limitHolesImpl(polygon, maxHoles);
+}
+
+void limitHoles(GeometryPolygonView& polygon, uint32_t maxHoles) {
+    limitHolesImpl(polygon, maxHoles);
+}
+
+void GeometryBuffer::assign(const GeometryCollection& collection) {
+    clear();
+    for (const auto& ring : collection) {
+        addRing();
+        coordinates.insert(coordinates.end(), ring.begin(), ring.end());
+        ringEnds.back() = static_cast<uint32_t>(coordinates.size());
+    }
+}
+
+GeometryCollection GeometryBuffer::toCollection() const {
+    GeometryCollection collection;
+    collection.reserve(size());
+    for (const auto& ring : *this) {
+        collection.emplace_back(ring.begin(), ring.end());
+    }
+    return collection;
+}
+
+static double squaredSegmentDistance(const GeometryCoordinate& p, const GeometryCoordinate& a, const GeometryCoordinate& b) {
+    double x = a.x;
+    double y = a.y;
+    double dx = b.x - x;
+    double dy = b.y - y;
+
+    if (dx != 0 || dy != 0) {
+        const double t = ((p.x - x) * dx + (p.y - y) * dy) / (dx * dx + dy * dy);
+        if (t > 1) {
+            x = b.x;
+            y = b.y;
+        } else if (t > 0) {
+            x += dx * t;
+            y += dy * t;
+        }
     }
+
+    dx = p.x - x;
+    dy = p.y - y;
+    return dx * dx + dy * dy;
+}
+
+void GeometryBuffer::simplify(double tolerance, bool polygon) {
+    const double squaredTolerance = tolerance * tolerance;
+    const uint32_t minPoints = polygon ? 4 : 2;
+
+    std::vector<bool> keep;
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    uint32_t start = 0;
+    uint32_t out = 0;
+
+    for (auto& end : ringEnds) {
+        const GeometryCoordinate* ring = coordinates.data() + start;
+        const uint32_t length = end - start;
+
+        keep.assign(length, length <= minPoints);
+        if (length > minPoints) {
+            keep.front() = keep.back() = true;
+            stack.emplace_back(0, length - 1);
+            while (!stack.empty()) {
+                const uint32_t first = stack.back().first;
+                const uint32_t last = stack.back().second;
+                stack.pop_back();
+
+                double maxDistance = squaredTolerance;
+                uint32_t index = first;
+                for (uint32_t i = first + 1; i < last; i++) {
+                    const double distance = squaredSegmentDistance(ring[i], ring[first], ring[last]);
+                    if (distance > maxDistance) {
+                        index = i;
+                        maxDistance = distance;
+                    }
+                }
+
+                if (index != first) {
+                    keep[index] = true;
+                    stack.emplace_back(first, index);
+                    stack.emplace_back(index, last);
+                }
+            }
+        }
+
+        if (polygon && length > minPoints) {
+            GeometryCoordinates kept;
+            for (uint32_t i = 0; i < length; i++) {
+                if (keep[i]) {
+                    kept.push_back(ring[i]);
+                }
+            }
+            const double area = signedArea(kept);
+            const double originalArea = signedArea(GeometryCoordinatesView { ring, ring + length });
+            if (kept.size() < minPoints || area == 0 || (area > 0) != (originalArea > 0)) {
+                keep.assign(length, true);
+            }
+        }
+
+        // Kept points only move to the front, so they can be moved in place.
+        for (uint32_t i = 0; i < length; i++) {
+            if (keep[i]) {
+                coordinates[out++] = coordinates[start + i];
+            }
+        }
+
+        start = end;
+        end = out;
+    }
+
+    coordinates.resize(out);
 }
 
 static Feature::geometry_type convertGeometry(const GeometryTileFeature& geometryTileFeature, const CanonicalTileID& tileID) {
@@ -207,7 +516,13 @@ static Feature::geometry_type convertGeometry(const GeometryTileFeature& geometr
     return Point<double>();
 }
 
-Feature convertFeature(const GeometryTileFeature& geometryTileFeature, const CanonicalTileID& tileID) {
+Feature convertFeature(const GeometryTileFeature& geometryTileFeature, const CanonicalTileID& tileID, FeatureDetail detail) {
+    if (detail == FeatureDetail::ID) {
+        Feature feature { Point<double>() };
+        feature.id = geometryTileFeature.getID();
+        return feature;
+    }
+
     Feature feature { convertGeometry(geometryTileFeature, tileID) };
     feature.properties = geometryTileFeature.getProperties();
     feature.id = geometryTileFeature.getID();
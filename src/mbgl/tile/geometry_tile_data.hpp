@@ -5,6 +5,7 @@
 #include <mbgl/util/optional.hpp>
 
 #include <cstdint>
+#include <iterator>
 #include <string>
 #include <vector>
 #include <memory>
@@ -30,14 +31,130 @@ public:
     using std::vector<GeometryCoordinates>::vector;
 };
 
+// A non-owning view of a ring of coordinates stored in a GeometryBuffer.
+class GeometryCoordinatesView {
+public:
+    using value_type = GeometryCoordinate;
+    using const_iterator = const GeometryCoordinate*;
+
+    GeometryCoordinatesView(const GeometryCoordinate* begin_, const GeometryCoordinate* end_)
+        : first(begin_), last(end_) {}
+
+    const_iterator begin() const { return first; }
+    const_iterator end() const { return last; }
+    std::size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+
+    const GeometryCoordinate& operator[](std::size_t i) const { return first[i]; }
+    const GeometryCoordinate& front() const { return *first; }
+    const GeometryCoordinate& back() const { return *(last - 1); }
+
+private:
+    const GeometryCoordinate* first;
+    const GeometryCoordinate* last;
+};
+
+// The rings of a polygon, as views into a GeometryBuffer.
+using GeometryPolygonView = std::vector<GeometryCoordinatesView>;
+
+// A flat alternative to GeometryCollection: the coordinates of all rings are stored back to
+// back in a single vector, along with the end offset of each ring. Both vectors keep their
+// capacity across clear(), so a buffer that is reused from one feature to the next stops
+// allocating once it has grown to fit the largest feature.
+class GeometryBuffer {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = GeometryCoordinatesView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = GeometryCoordinatesView;
+
+        const_iterator(const GeometryBuffer& buffer_, std::size_t index_)
+            : buffer(&buffer_), index(index_) {}
+
+        GeometryCoordinatesView operator*() const { return (*buffer)[index]; }
+        const_iterator& operator++() { ++index; return *this; }
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+
+    private:
+        const GeometryBuffer* buffer;
+        std::size_t index;
+    };
+
+    using value_type = GeometryCoordinatesView;
+
+    void clear() {
+        coordinates.clear();
+        ringEnds.clear();
+    }
+
+    // Starts a new, empty ring; subsequent points are appended to it.
+    void addRing() {
+        ringEnds.push_back(static_cast<uint32_t>(coordinates.size()));
+    }
+
+    void addPoint(GeometryCoordinate point) {
+        coordinates.push_back(point);
+        ++ringEnds.back();
+    }
+
+    // Appends `count` zeroed points to the last ring, and returns a pointer to the first.
+    GeometryCoordinate* addPoints(std::size_t count) {
+        coordinates.resize(coordinates.size() + count);
+        ringEnds.back() += static_cast<uint32_t>(count);
+        return coordinates.data() + coordinates.size() - count;
+    }
+
+    std::size_t size() const { return ringEnds.size(); }
+    bool empty() const { return ringEnds.empty(); }
+
+    GeometryCoordinatesView operator[](std::size_t i) const {
+        const uint32_t start = i == 0 ? 0 : ringEnds[i - 1];
+        return { coordinates.data() + start, coordinates.data() + ringEnds[i] };
+    }
+
+    GeometryCoordinatesView back() const { return (*this)[size() - 1]; }
+
+    const_iterator begin() const { return { *this, 0 }; }
+    const_iterator end() const { return { *this, size() }; }
+
+    void assign(const GeometryCollection&);
+    GeometryCollection toCollection() const;
+
+    // Drops the points of each ring that are within `tolerance` of the simplified ring
+    // (Douglas-Peucker), keeping its first and last points. Polygon rings that would collapse,
+    // or turn the other way, are kept as they are.
+    void simplify(double tolerance, bool polygon);
+
+private:
+    std::vector<GeometryCoordinate> coordinates;
+    std::vector<uint32_t> ringEnds;
+};
+
 class GeometryTileFeature {
 public:
     virtual ~GeometryTileFeature() = default;
     virtual FeatureType getType() const = 0;
     virtual optional<Value> getValue(const std::string& key) const = 0;
+
+    // Like getValue(), but points into the values of features that keep their own, instead of
+    // copying them: those stay valid as long as the tile data, and may be shared by features
+    // with the same value. Other features copy the value into `storage`, and point to it there.
+    virtual const Value* findValue(const std::string& key, optional<Value>& storage) const {
+        storage = getValue(key);
+        return storage ? &*storage : nullptr;
+    }
+
     virtual PropertyMap getProperties() const { return PropertyMap(); }
     virtual optional<FeatureIdentifier> getID() const { return {}; }
     virtual GeometryCollection getGeometries() const = 0;
+
+    // Replaces the contents of `buffer` with the geometry of this feature. The default
+    // implementation copies the result of getGeometries().
+    virtual void readGeometries(GeometryBuffer& buffer) const { buffer.assign(getGeometries()); }
 };
 
 class GeometryTileLayer {
@@ -53,21 +170,43 @@ public:
     virtual ~GeometryTileData() = default;
     virtual std::unique_ptr<GeometryTileData> clone() const = 0;
     virtual const GeometryTileLayer* getLayer(const std::string&) const = 0;
+
+    // Returns a copy that holds only what this data is parsed from, and parses it again on
+    // first access, or null if this data can't be parsed again. Unlike clones, it doesn't keep
+    // the parsed layers of this data alive.
+    virtual std::unique_ptr<GeometryTileData> unparsed() const { return nullptr; }
+
+    // The bytes this data is parsed from, if it is, which identify it across processes.
+    virtual const std::string* encoded() const { return nullptr; }
 };
 
 // classifies an array of rings into polygons with outer rings and holes
 std::vector<GeometryCollection> classifyRings(const GeometryCollection&);
+std::vector<GeometryPolygonView> classifyRings(const GeometryBuffer&);
 
 // Truncate polygon to the largest `maxHoles` inner rings by area.
 void limitHoles(GeometryCollection&, uint32_t maxHoles);
+void limitHoles(GeometryPolygonView&, uint32_t maxHoles);
+
+// How much of a feature to convert: queries for feature IDs skip the geometry and properties.
+enum class FeatureDetail : bool {
+    ID,
+    Full,
+};
 
 // convert from GeometryTileFeature to Feature (eventually we should eliminate GeometryTileFeature)
-Feature convertFeature(const GeometryTileFeature&, const CanonicalTileID&);
+Feature convertFeature(const GeometryTileFeature&, const CanonicalTileID&, FeatureDetail = FeatureDetail::Full);
 
 // Fix up possibly-non-V2-compliant polygon geometry using angus clipper.
 // The result is guaranteed to have correctly wound, strictly simple rings.
+// Geometry that `isValidPolygon` accepts is returned as it is.
 GeometryCollection fixupPolygons(const GeometryCollection&);
 
+// A cheap check for polygon geometry that is already correctly wound and strictly simple,
+// and needs no fixup. It may reject valid geometry, but never accepts invalid geometry.
+bool isValidPolygon(const GeometryCollection&);
+bool isValidPolygon(const GeometryBuffer&);
+
 struct ToGeometryCollection {
     GeometryCollection operator()(const mapbox::geometry::point<int16_t>& geom) const {
         return { { geom } };
@@ -1,13 +1,15 @@
 #include <mbgl/tile/geometry_tile_worker.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/tile/geometry_tile.hpp>
+#include <mbgl/tile/layout_cache.hpp>
+#include <mbgl/tile/layer_profiler.hpp>
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/layout/symbol_layout.hpp>
 #include <mbgl/style/bucket_parameters.hpp>
 #include <mbgl/style/group_by_layout.hpp>
-#include <mbgl/style/filter.hpp>
-#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/renderer/symbol_bucket.hpp>
@@ -15,25 +17,94 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/exception.hpp>
+#include <mbgl/util/interned_string.hpp>
+#include <mbgl/util/trace.hpp>
 
+#include <algorithm>
+#include <mutex>
 #include <unordered_set>
 
 namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+std::atomic<uint64_t> cancelledLayouts { 0 };
+std::atomic<uint64_t> cancelledPlacements { 0 };
+std::atomic<uint64_t> skippedFeatures { 0 };
+
+// Buffers for the geometry of one feature at a time, shared by the layouts of all tiles.
+// Each grows to the largest feature read into it; kept here rather than with a worker, they
+// stay allocated while tiles come and go.
+class ScratchGeometries {
+public:
+    std::vector<GeometryBuffer> take(std::size_t count) {
+        std::vector<GeometryBuffer> result;
+        result.reserve(count);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (result.size() < count && !buffers.empty()) {
+                result.push_back(std::move(buffers.back()));
+                buffers.pop_back();
+            }
+        }
+        result.resize(count);
+        return result;
+    }
+
+    void put(std::vector<GeometryBuffer>& used) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& buffer : used) {
+            if (buffers.size() == maxBuffers) {
+                break;
+            }
+            buffers.push_back(std::move(buffer));
+        }
+    }
+
+private:
+    static constexpr std::size_t maxBuffers = 32;
+
+    std::mutex mutex;
+    std::vector<GeometryBuffer> buffers;
+};
+
+ScratchGeometries& scratchGeometries() {
+    static ScratchGeometries scratch;
+    return scratch;
+}
+
+} // namespace
+
+GeometryTileWorker::CancellationStats GeometryTileWorker::getCancellationStats() {
+    CancellationStats stats;
+    stats.cancelledLayouts = cancelledLayouts;
+    stats.cancelledPlacements = cancelledPlacements;
+    stats.skippedFeatures = skippedFeatures;
+    return stats;
+}
+
 GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
                                        ActorRef<GeometryTile> parent_,
+                                       Scheduler& scheduler,
                                        OverscaledTileID id_,
                                        GlyphAtlas& glyphAtlas_,
                                        const std::atomic<bool>& obsolete_,
-                                       const MapMode mode_)
+                                       const MapMode mode_,
+                                       const float pixelRatio_,
+                                       std::shared_ptr<LayoutCache> layoutCache_,
+                                       std::shared_ptr<LayerProfiler> profiler_)
     : self(std::move(self_)),
       parent(std::move(parent_)),
       id(std::move(id_)),
       glyphAtlas(glyphAtlas_),
       obsolete(obsolete_),
-      mode(mode_) {
+      mode(mode_),
+      pixelRatio(pixelRatio_),
+      layoutCache(std::move(layoutCache_)),
+      profiler(std::move(profiler_)),
+      layoutTasks(scheduler) {
 }
 
 GeometryTileWorker::~GeometryTileWorker() {
@@ -77,6 +148,10 @@ void GeometryTileWorker::setData(std::unique_ptr<const GeometryTileData> data_,
     try {
         data = std::move(data_);
         correlationID = correlationID_;
+        dataKey = {};
+        retainedGroups.clear();
+        triangulations.clear();
+        lineMeasurements.clear();
 
         switch (state) {
         case Idle:
@@ -168,6 +243,82 @@ void GeometryTileWorker::symbolDependenciesChanged() {
     }
 }
 
+void GeometryTileWorker::setRetainsData(bool retains) {
+    retainsData = retains;
+    if (!retainsData && data && *data) {
+        if (auto unparsed = (*data)->unparsed()) {
+            *data = std::move(unparsed);
+        }
+    }
+}
+
+void GeometryTileWorker::setFeatureIndexing(bool enabled) {
+    try {
+        if (enabled == indexesFeatures) {
+            return;
+        }
+        indexesFeatures = enabled;
+
+        if (!indexesFeatures) {
+            // Retained buckets stay valid without their subfeatures.
+            for (auto& pair : retainedGroups) {
+                pair.second.index = {};
+            }
+            return;
+        }
+
+        // Every group is laid out again, to collect its subfeatures.
+        retainedGroups.clear();
+
+        switch (state) {
+        case Idle:
+            redoLayout();
+            coalesce();
+            break;
+
+        case Coalescing:
+        case NeedPlacement:
+            state = NeedLayout;
+            break;
+
+        case NeedLayout:
+            break;
+        }
+    } catch (...) {
+        parent.invoke(&GeometryTile::onError, std::current_exception());
+    }
+}
+
+void GeometryTileWorker::setSimplificationTolerance(float pixels) {
+    try {
+        if (pixels == simplificationTolerance) {
+            return;
+        }
+        simplificationTolerance = pixels;
+
+        // Every group is laid out again, from the geometry simplified the new way.
+        retainedGroups.clear();
+        triangulations.clear();
+
+        switch (state) {
+        case Idle:
+            redoLayout();
+            coalesce();
+            break;
+
+        case Coalescing:
+        case NeedPlacement:
+            state = NeedLayout;
+            break;
+
+        case NeedLayout:
+            break;
+        }
+    } catch (...) {
+        parent.invoke(&GeometryTile::onError, std::current_exception());
+    }
+}
+
 void GeometryTileWorker::coalesced() {
     try {
         switch (state) {
@@ -199,11 +350,46 @@ void GeometryTileWorker::coalesce() {
     self.invoke(&GeometryTileWorker::coalesced);
 }
 
+struct GeometryTileWorker::GroupLayout {
+    GroupLayout(const std::vector<const Layer*>& group_,
+                const BucketParameters& parameters_)
+        : group(group_), parameters(parameters_) {}
+
+    const std::vector<const Layer*>& group;
+    const BucketParameters& parameters;
+
+    // Only set for groups that are laid out.
+    const GeometryTileLayer* geometryLayer = nullptr;
+
+    std::string signature;
+
+    // The previous results for the same signature, if any; the group is then not laid out.
+    const RetainedGroup* retained = nullptr;
+
+    // Set if the results of this group are read from, or written to, `layoutCache`.
+    std::string cacheKey;
+
+    // Whether the results were read from `layoutCache`; the group is then not laid out.
+    bool cached = false;
+
+    // Results; a group has either a symbol layout or a bucket.
+    std::unique_ptr<SymbolLayout> symbolLayout;
+    std::shared_ptr<Bucket> bucket;
+    FeatureIndex::Pending index;
+    std::size_t skippedFeatures = 0;
+
+    // The features that passed the filter; the time is only measured while profiling.
+    std::size_t features = 0;
+    Duration layoutTime = Duration::zero();
+};
+
 void GeometryTileWorker::redoLayout() {
     if (!data || !layers) {
         return;
     }
 
+    MBGL_TRACE_SCOPE("tile", "layout");
+
     std::vector<std::string> symbolOrder;
     for (auto it = layers->rbegin(); it != layers->rend(); it++) {
         if ((*it)->is<SymbolLayer>()) {
@@ -213,12 +399,18 @@ void GeometryTileWorker::redoLayout() {
 
     std::unordered_map<std::string, std::unique_ptr<SymbolLayout>> symbolLayoutMap;
     std::unordered_map<std::string, std::shared_ptr<Bucket>> buckets;
-    auto featureIndex = std::make_unique<FeatureIndex>();
-    BucketParameters parameters { id, mode };
+    auto featureIndex = indexesFeatures ? std::make_unique<FeatureIndex>() : nullptr;
+    BucketParameters parameters { id, mode, obsolete, &triangulations, pixelRatio };
+
+    // Layer groups don't depend on each other, so they are laid out as separate tasks and
+    // merged in style order afterwards, which keeps the feature index ordered as if they
+    // were laid out one after the other.
+    std::vector<GroupLayout> groupLayouts;
 
     std::vector<std::vector<const Layer*>> groups = groupByLayout(*layers);
     for (auto& group : groups) {
         if (obsolete) {
+            layoutCancelled(0);
             return;
         }
 
@@ -228,48 +420,142 @@ void GeometryTileWorker::redoLayout() {
 
         const Layer& leader = *group.at(0);
 
-        auto geometryLayer = (*data)->getLayer(leader.baseImpl->sourceLayer);
-        if (!geometryLayer) {
-            continue;
-        }
+        groupLayouts.emplace_back(group, parameters);
+        GroupLayout& groupLayout = groupLayouts.back();
 
-        std::vector<std::string> layerIDs;
+        groupLayout.signature = layoutKey(leader).key;
         for (const auto& layer : group) {
-            layerIDs.push_back(layer->getID());
+            groupLayout.signature += '\n' + layer->getID() + '\n' + util::toString(layer->baseImpl->revision);
         }
 
-        featureIndex->setBucketLayerIDs(leader.getID(), layerIDs);
+        // Groups are only retained if they had a source layer.
+        auto retained = retainedGroups.find(groupLayout.signature);
+        if (retained != retainedGroups.end()) {
+            groupLayout.retained = &retained->second;
+        } else if (layoutCache && !leader.is<SymbolLayer>()) {
+            // The data is only parsed if a group isn't in the cache.
+            groupLayout.cacheKey = cacheKey(groupLayout);
+            groupLayout.cached = !groupLayout.cacheKey.empty() && readGroup(groupLayout);
+        }
 
-        if (leader.is<SymbolLayer>()) {
-            symbolLayoutMap.emplace(leader.getID(),
-                leader.as<SymbolLayer>()->impl->createLayout(parameters, group, *geometryLayer));
-        } else {
-            const Filter& filter = leader.baseImpl->filter;
-            const std::string& sourceLayerID = leader.baseImpl->sourceLayer;
-            std::shared_ptr<Bucket> bucket = leader.baseImpl->createBucket(parameters, group);
+        if (!groupLayout.retained && !groupLayout.cached) {
+            groupLayout.geometryLayer = (*data)->getLayer(leader.baseImpl->sourceLayer);
+            if (!groupLayout.geometryLayer) {
+                if (!groupLayout.cacheKey.empty()) {
+                    writeGroup(groupLayout, nullptr);
+                }
+                groupLayouts.pop_back();
+                continue;
+            }
+        }
 
-            for (std::size_t i = 0; !obsolete && i < geometryLayer->featureCount(); i++) {
-                std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
+        if (featureIndex) {
+            std::vector<std::string> layerIDs;
+            for (const auto& layer : group) {
+                layerIDs.push_back(layer->getID());
+            }
+            featureIndex->setBucketLayerIDs(leader.getID(), layerIDs);
+        }
+    }
+
+    // The layers the groups read from have been parsed; their features are parsed as they're
+    // laid out.
+    const TimePoint parsed = Clock::now();
+
+    // Only lay out the groups that changed.
+    std::vector<GroupLayout*> changed;
+    for (auto& groupLayout : groupLayouts) {
+        if (!groupLayout.retained && !groupLayout.cached) {
+            changed.push_back(&groupLayout);
+        }
+    }
 
-                if (!filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); }))
-                    continue;
+    std::vector<GeometryBuffer> geometries = scratchGeometries().take(layoutTasks.lanes());
+    layoutTasks.run(changed.size(), [&] (std::size_t i, std::size_t lane) {
+        layoutGroup(*changed[i], geometries[lane]);
+    });
+    scratchGeometries().put(geometries);
+
+    std::size_t skipped = 0;
+    for (auto& groupLayout : groupLayouts) {
+        skipped += groupLayout.skippedFeatures;
+    }
+
+    // Tasks, including symbol layouts collecting their features, stop early once the tile
+    // is obsolete; don't report a partial layout.
+    if (obsolete) {
+        layoutCancelled(skipped);
+        return;
+    }
 
-                GeometryCollection geometries = feature->getGeometries();
-                bucket->addFeature(*feature, geometries);
-                featureIndex->insert(geometries, i, sourceLayerID, leader.getID());
+    if (profiler) {
+        for (const auto* groupLayout : changed) {
+            LayerProfile::Layer cost;
+            cost.layouts = 1;
+            cost.cpuTime = groupLayout->layoutTime;
+            cost.features = groupLayout->features;
+            if (groupLayout->bucket) {
+                cost.vertices = groupLayout->bucket->getVertexCount();
+                cost.bytes = groupLayout->bucket->getByteSize();
             }
+            profiler->add(groupLayout->group.at(0)->getID(), cost);
+        }
+    }
 
-            if (!bucket->hasData()) {
-                continue;
+    if (!retainedGroups.empty()) {
+        // Take back the symbol layouts of retained groups from the previous layout; the
+        // others are discarded with it below.
+        for (auto& symbolLayout : symbolLayouts) {
+            for (auto& groupLayout : groupLayouts) {
+                if (groupLayout.retained && groupLayout.retained->symbolLayout == symbolLayout.get()) {
+                    groupLayout.symbolLayout = std::move(symbolLayout);
+                    groupLayout.symbolLayout->updatePaintProperties(groupLayout.group);
+                    break;
+                }
             }
+        }
 
-            for (const auto& layer : group) {
-                buckets.emplace(layer->getID(), bucket);
+        // Retained buckets have been handed to the tile and may be uploaded by now, so they
+        // are not inspected again; only those that had data were kept.
+        for (auto& groupLayout : groupLayouts) {
+            if (groupLayout.retained) {
+                groupLayout.bucket = groupLayout.retained->bucket;
+                groupLayout.index = groupLayout.retained->index;
             }
         }
     }
 
+    std::unordered_map<std::string, RetainedGroup> retaining;
+
+    for (auto& groupLayout : groupLayouts) {
+        const Layer& leader = *groupLayout.group.at(0);
+        RetainedGroup& retained = retaining[groupLayout.signature];
+
+        if (groupLayout.symbolLayout) {
+            retained.symbolLayout = groupLayout.symbolLayout.get();
+            symbolLayoutMap.emplace(leader.getID(), std::move(groupLayout.symbolLayout));
+            continue;
+        }
+
+        if (featureIndex) {
+            featureIndex->insert(groupLayout.index);
+        }
+        retained.index = std::move(groupLayout.index);
+
+        if (!groupLayout.bucket || (!groupLayout.retained && !groupLayout.bucket->hasData())) {
+            continue;
+        }
+
+        retained.bucket = groupLayout.bucket;
+        for (const auto& layer : groupLayout.group) {
+            buckets.emplace(layer->getID(), groupLayout.bucket);
+        }
+    }
+
+    retainedGroups = std::move(retaining);
+
     symbolLayouts.clear();
+    symbolBucketsPlaced = false;
     for (const auto& symbolLayerID : symbolOrder) {
         auto it = symbolLayoutMap.find(symbolLayerID);
         if (it != symbolLayoutMap.end()) {
@@ -281,12 +567,158 @@ void GeometryTileWorker::redoLayout() {
         std::move(buckets),
         std::move(featureIndex),
         *data ? (*data)->clone() : nullptr,
-        correlationID
+        correlationID,
+        parsed
     });
 
+    // The next layout parses the data again, if it still needs to read any of it.
+    if (!retainsData && *data) {
+        if (auto unparsed = (*data)->unparsed()) {
+            *data = std::move(unparsed);
+        }
+    }
+
     attemptPlacement();
 }
 
+// Runs as a task of `layoutTasks`, concurrently with other groups: it must only touch its
+// own `GroupLayout` and `geometries`, and may only read the layers and the tile data.
+void GeometryTileWorker::layoutGroup(GroupLayout& layout, GeometryBuffer& geometries) const {
+    if (obsolete) {
+        return;
+    }
+
+    const Layer& leader = *layout.group.at(0);
+    MBGL_TRACE_SCOPE("tile", "layout/" + leader.getID());
+
+    const TimePoint start = profiler ? Clock::now() : TimePoint();
+
+    if (leader.is<SymbolLayer>()) {
+        layout.symbolLayout = leader.as<SymbolLayer>()->impl->createLayout(layout.parameters, layout.group, *layout.geometryLayer);
+        if (profiler) {
+            layout.layoutTime = Clock::now() - start;
+            layout.features = layout.symbolLayout->featureCount();
+        }
+        return;
+    }
+
+    const CompiledFilter filter(leader.baseImpl->filter);
+    const uint32_t sourceLayerID = util::internString(leader.baseImpl->sourceLayer);
+    const uint32_t bucketID = util::internString(leader.getID());
+    std::shared_ptr<Bucket> bucket = leader.baseImpl->createBucket(layout.parameters, layout.group);
+
+    // In tile units, for a tile drawn at its own zoom level; it is drawn smaller at lower ones.
+    const double tolerance = simplificationTolerance * util::EXTENT / (util::tileSize * id.overscaleFactor());
+
+    const std::size_t featureCount = layout.geometryLayer->featureCount();
+    for (std::size_t i = 0; i < featureCount; i++) {
+        if (obsolete) {
+            // Don't report a partially built bucket.
+            layout.skippedFeatures = featureCount - i;
+            return;
+        }
+
+        std::unique_ptr<GeometryTileFeature> feature = layout.geometryLayer->getFeature(i);
+
+        if (!filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); }))
+            continue;
+
+        feature->readGeometries(geometries);
+        if (tolerance > 0 && feature->getType() != FeatureType::Point) {
+            geometries.simplify(tolerance, feature->getType() == FeatureType::Polygon);
+        }
+        bucket->addFeature(*feature, geometries, i);
+        layout.features++;
+        if (indexesFeatures) {
+            layout.index.insert(geometries, i, sourceLayerID, bucketID);
+        }
+    }
+
+    if (profiler) {
+        layout.layoutTime = Clock::now() - start;
+    }
+
+    if (!layout.cacheKey.empty()) {
+        writeGroup(layout, bucket->hasData() ? bucket.get() : nullptr);
+    }
+
+    layout.bucket = std::move(bucket);
+}
+
+std::string GeometryTileWorker::cacheKey(const GroupLayout& layout) {
+    if (!dataKey) {
+        const std::string* encoded = (*data)->encoded();
+        dataKey = encoded ? util::toString(LayoutCache::hash(encoded->data(), encoded->size())) + ":" +
+                            util::toString(encoded->size())
+                          : std::string();
+    }
+    if (dataKey->empty()) {
+        return {};
+    }
+
+    // Everything a bucket and its subfeatures are built from, apart from paint properties:
+    // buckets check those they depend on when they are read. The first line is bumped when
+    // the entries change.
+    std::string key = "layout 1\n" + *dataKey + "\n" + util::toString(id) + "\n" +
+        util::toString(static_cast<uint32_t>(mode)) + " " + util::toString(pixelRatio) + " " +
+        util::toString(simplificationTolerance) + " " + util::toString(indexesFeatures) + "\n" +
+        layoutKey(*layout.group.at(0)).key;
+    for (const auto& layer : layout.group) {
+        key += '\n' + layer->getID();
+    }
+    return key;
+}
+
+bool GeometryTileWorker::readGroup(GroupLayout& layout) const {
+    optional<std::string> entry = layoutCache->get(layout.cacheKey);
+    if (!entry) {
+        return false;
+    }
+
+    const Layer& leader = *layout.group.at(0);
+    LayoutReader reader(*entry);
+
+    bool hasBucket;
+    if (!reader.read(hasBucket)) {
+        return false;
+    }
+
+    std::shared_ptr<Bucket> bucket;
+    if (hasBucket) {
+        bucket = leader.baseImpl->createBucket(layout.parameters, layout.group);
+        if (!bucket->read(reader)) {
+            return false;
+        }
+    }
+
+    FeatureIndex::Pending index;
+    if (indexesFeatures && !index.read(reader, util::internString(leader.baseImpl->sourceLayer),
+                                       util::internString(leader.getID()))) {
+        return false;
+    }
+
+    if (!reader.atEnd()) {
+        return false;
+    }
+
+    layout.bucket = std::move(bucket);
+    layout.index = std::move(index);
+    return true;
+}
+
+// Called from layout tasks too; `LayoutCache` is thread-safe.
+void GeometryTileWorker::writeGroup(const GroupLayout& layout, const Bucket* bucket) const {
+    LayoutWriter writer;
+    writer.write(bool(bucket));
+    if (bucket && !bucket->write(writer)) {
+        return;
+    }
+    if (indexesFeatures) {
+        layout.index.write(writer);
+    }
+    layoutCache->put(layout.cacheKey, writer.data);
+}
+
 bool GeometryTileWorker::hasPendingSymbolDependencies() const {
     bool result = false;
 
@@ -304,19 +736,34 @@ void GeometryTileWorker::attemptPlacement() {
         return;
     }
 
+    MBGL_TRACE_SCOPE("tile", "placement");
+
     bool canPlace = true;
 
     // Prepare as many SymbolLayouts as possible.
     for (auto& symbolLayout : symbolLayouts) {
         if (obsolete) {
+            placementCancelled();
             return;
         }
 
         if (symbolLayout->state == SymbolLayout::Pending) {
             if (symbolLayout->canPrepare(glyphAtlas)) {
+                const TimePoint start = profiler ? Clock::now() : TimePoint();
                 symbolLayout->state = SymbolLayout::Prepared;
                 symbolLayout->prepare(reinterpret_cast<uintptr_t>(this),
-                                      glyphAtlas);
+                                      glyphAtlas,
+                                      lineMeasurements);
+                if (obsolete) {
+                    // The layout was only partially prepared; it can't be reused.
+                    placementCancelled();
+                    return;
+                }
+                if (profiler) {
+                    LayerProfile::Layer cost;
+                    cost.cpuTime = Clock::now() - start;
+                    profiler->add(symbolLayout->getBucketName(), cost);
+                }
             } else {
                 canPlace = false;
             }
@@ -328,10 +775,58 @@ void GeometryTileWorker::attemptPlacement() {
     }
 
     auto collisionTile = std::make_unique<CollisionTile>(*placementConfig);
+
+    // While the tile holds the buckets of the current symbol layouts, only the placement
+    // of their symbols has to be recomputed for a new config.
+    const bool updatePlacement = symbolBucketsPlaced &&
+        std::all_of(symbolLayouts.begin(), symbolLayouts.end(), [&] (const auto& symbolLayout) {
+            return symbolLayout->canUpdatePlacement(*placementConfig);
+        });
+
+    if (updatePlacement) {
+        std::unordered_map<std::string, std::shared_ptr<SymbolBucketPlacement>> placements;
+
+        for (auto& symbolLayout : symbolLayouts) {
+            if (obsolete) {
+                placementCancelled();
+                return;
+            }
+
+            if (!symbolLayout->hasSymbolInstances()) {
+                continue;
+            }
+
+            const TimePoint start = profiler ? Clock::now() : TimePoint();
+            std::shared_ptr<SymbolBucketPlacement> placement = symbolLayout->updatePlacement(*collisionTile);
+            if (!placement) {
+                placementCancelled();
+                return;
+            }
+            if (profiler) {
+                LayerProfile::Layer cost;
+                cost.cpuTime = Clock::now() - start;
+                profiler->add(symbolLayout->getBucketName(), cost);
+            }
+
+            for (const auto& pair : symbolLayout->layerPaintProperties) {
+                placements.emplace(pair.first, placement);
+            }
+        }
+
+        parent.invoke(&GeometryTile::onPlacementUpdate, GeometryTile::PlacementUpdate {
+            std::move(placements),
+            std::move(collisionTile),
+            correlationID
+        });
+        return;
+    }
+
+    symbolBucketsPlaced = false;
     std::unordered_map<std::string, std::shared_ptr<Bucket>> buckets;
 
     for (auto& symbolLayout : symbolLayouts) {
         if (obsolete) {
+            placementCancelled();
             return;
         }
 
@@ -340,7 +835,20 @@ void GeometryTileWorker::attemptPlacement() {
             continue;
         }
 
+        const TimePoint start = profiler ? Clock::now() : TimePoint();
         std::shared_ptr<Bucket> bucket = symbolLayout->place(*collisionTile);
+        if (!bucket) {
+            placementCancelled();
+            return;
+        }
+        if (profiler) {
+            LayerProfile::Layer cost;
+            cost.cpuTime = Clock::now() - start;
+            cost.vertices = bucket->getVertexCount();
+            cost.bytes = bucket->getByteSize();
+            profiler->add(symbolLayout->getBucketName(), cost);
+        }
+
         for (const auto& pair : symbolLayout->layerPaintProperties) {
             buckets.emplace(pair.first, bucket);
         }
@@ -351,6 +859,17 @@ void GeometryTileWorker::attemptPlacement() {
         std::move(collisionTile),
         correlationID
     });
+    symbolBucketsPlaced = true;
+}
+
+void GeometryTileWorker::layoutCancelled(std::size_t skipped) {
+    // A cancelled layout is not an error: the tile is going away, so nothing is reported to it.
+    cancelledLayouts++;
+    skippedFeatures += skipped;
+}
+
+void GeometryTileWorker::placementCancelled() {
+    cancelledPlacements++;
 }
 
 } // namespace mbgl
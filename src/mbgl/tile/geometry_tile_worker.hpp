@@ -4,17 +4,28 @@
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/text/placement_config.hpp>
 #include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/actor/task_group.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/renderer/fill_triangulation_cache.hpp>
+#include <mbgl/text/line_measurements.hpp>
 #include <mbgl/util/optional.hpp>
 
 #include <atomic>
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
+class Bucket;
+class GeometryBuffer;
 class GeometryTile;
 class GeometryTileData;
 class GlyphAtlas;
+class LayoutCache;
+class LayerProfiler;
+class Scheduler;
 class SymbolLayout;
 
 namespace style {
@@ -25,16 +36,34 @@ class GeometryTileWorker {
 public:
     GeometryTileWorker(ActorRef<GeometryTileWorker> self,
                        ActorRef<GeometryTile> parent,
+                       Scheduler&,
                        OverscaledTileID,
                        GlyphAtlas&,
                        const std::atomic<bool>&,
-                       const MapMode);
+                       const MapMode,
+                       const float pixelRatio,
+                       std::shared_ptr<LayoutCache>,
+                       std::shared_ptr<LayerProfiler>);
     ~GeometryTileWorker();
 
     void setLayers(std::vector<std::unique_ptr<style::Layer>>, uint64_t correlationID);
     void setData(std::unique_ptr<const GeometryTileData>, uint64_t correlationID);
     void setPlacementConfig(PlacementConfig, uint64_t correlationID);
     void symbolDependenciesChanged();
+    void setRetainsData(bool);
+    void setFeatureIndexing(bool);
+    void setSimplificationTolerance(float pixels);
+
+    // Work abandoned because a tile became obsolete while it was being laid out or placed,
+    // summed over all workers in the process.
+    struct CancellationStats {
+        uint64_t cancelledLayouts = 0;
+        uint64_t cancelledPlacements = 0;
+        // Features of non-symbol layers that were never processed by a cancelled layout.
+        uint64_t skippedFeatures = 0;
+    };
+
+    static CancellationStats getCancellationStats();
 
 private:
     void coalesce();
@@ -43,6 +72,17 @@ private:
     void attemptPlacement();
     bool hasPendingSymbolDependencies() const;
 
+    struct GroupLayout;
+    void layoutGroup(GroupLayout&, GeometryBuffer&) const;
+
+    // Entries of `layoutCache`.
+    std::string cacheKey(const GroupLayout&);
+    bool readGroup(GroupLayout&) const;
+    void writeGroup(const GroupLayout&, const Bucket*) const;
+
+    void layoutCancelled(std::size_t skippedFeatures);
+    void placementCancelled();
+
     ActorRef<GeometryTileWorker> self;
     ActorRef<GeometryTile> parent;
 
@@ -50,6 +90,20 @@ private:
     GlyphAtlas& glyphAtlas;
     const std::atomic<bool>& obsolete;
     const MapMode mode;
+    const float pixelRatio;
+
+    // Null unless the map has one; see `Map::setLayoutCacheDirectory`.
+    const std::shared_ptr<LayoutCache> layoutCache;
+
+    // Null unless the map is profiling layers; see `Map::setLayerProfiling`.
+    const std::shared_ptr<LayerProfiler> profiler;
+
+    // Identifies `data` in the keys of `layoutCache`, or is empty if it can't be identified.
+    // Made on first use; cleared with new data.
+    optional<std::string> dataKey;
+
+    // Lays out independent layer groups concurrently, on otherwise idle worker threads.
+    TaskGroup layoutTasks;
 
     enum State {
         Idle,
@@ -66,7 +120,38 @@ private:
     optional<std::unique_ptr<const GeometryTileData>> data;
     optional<PlacementConfig> placementConfig;
 
+    // When false, `data` is swapped for an unparsed copy after each layout; see
+    // `GeometryTile::setRetainsData`.
+    bool retainsData = true;
+
+    // When false, layouts build no feature index; see `GeometryTile::setFeatureIndexing`.
+    bool indexesFeatures = true;
+
+    // See `style::Source::setSimplificationTolerance`.
+    float simplificationTolerance = 0;
+
     std::vector<std::unique_ptr<SymbolLayout>> symbolLayouts;
+
+    // Whether the tile was sent the buckets of all of `symbolLayouts`, so that a new
+    // placement config only needs their placement to be updated.
+    bool symbolBucketsPlaced = false;
+
+    // The results of the last layout, by the signature of the layer group they were built
+    // for: its layout key and the IDs and revisions of its layers. A group whose signature
+    // is unchanged when layers are set again is not laid out again. Cleared with new data.
+    struct RetainedGroup {
+        // Only set for non-symbol groups that produced any data.
+        std::shared_ptr<Bucket> bucket;
+        FeatureIndex::Pending index;
+        // Owned by `symbolLayouts`.
+        SymbolLayout* symbolLayout = nullptr;
+    };
+
+    std::unordered_map<std::string, RetainedGroup> retainedGroups;
+
+    // Cleared with new data.
+    FillTriangulationCache triangulations;
+    LineMeasurementCache lineMeasurements;
 };
 
 } // namespace mbgl
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <mbgl/map/layer_profile.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <mutex>
+#include <string>
+
+namespace mbgl {
+
+/*
+    The `LayerProfile` recorded by the workers of the tiles it is given to, on any thread;
+    see `Map::setLayerProfiling`.
+*/
+class LayerProfiler : private util::noncopyable {
+public:
+    void add(const std::string& layerID, const LayerProfile::Layer& layer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        profile.layers[layerID] += layer;
+    }
+
+    LayerProfile snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return profile;
+    }
+
+private:
+    mutable std::mutex mutex;
+    LayerProfile profile;
+};
+
+} // namespace mbgl
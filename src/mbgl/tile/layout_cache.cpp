@@ -0,0 +1,75 @@
+#include <mbgl/tile/layout_cache.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+
+namespace mbgl {
+
+constexpr std::size_t LayoutCache::files;
+
+namespace {
+
+// Tells apart the temporary files of concurrent writes.
+std::atomic<uint64_t> nextWrite { 0 };
+
+} // namespace
+
+LayoutCache::LayoutCache(std::string directory_)
+    : directory(std::move(directory_)) {
+}
+
+uint64_t LayoutCache::hash(const char* data, std::size_t length) {
+    // 64-bit FNV-1a.
+    uint64_t result = 0xcbf29ce484222325ull;
+    for (std::size_t i = 0; i < length; i++) {
+        result ^= uint8_t(data[i]);
+        result *= 0x100000001b3ull;
+    }
+    return result;
+}
+
+std::string LayoutCache::path(const std::string& key) const {
+    return directory + "/" + util::toString(hash(key.data(), key.size()) % files) + ".layout";
+}
+
+optional<std::string> LayoutCache::get(const std::string& key) const {
+    optional<std::string> file = util::readFile(path(key));
+    if (!file) {
+        return {};
+    }
+
+    // The file starts with the key of its entry, and its length.
+    uint64_t length;
+    LayoutReader reader(*file);
+    if (!reader.read(length) || length != key.size() ||
+        file->compare(sizeof(length), length, key) != 0) {
+        return {};
+    }
+
+    file->erase(0, sizeof(length) + length);
+    return file;
+}
+
+void LayoutCache::put(const std::string& key, const std::string& value) {
+    LayoutWriter writer;
+    writer.data.reserve(sizeof(uint64_t) + key.size() + value.size());
+    writer.write<uint64_t>(key.size());
+    writer.data += key;
+    writer.data += value;
+
+    const std::string file = path(key);
+    const std::string temporary = file + "." + util::toString(nextWrite++) + ".tmp";
+    try {
+        util::write_file(temporary, writer.data);
+    } catch (const std::runtime_error&) {
+        return;
+    }
+    if (std::rename(temporary.c_str(), file.c_str()) != 0) {
+        std::remove(temporary.c_str());
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace mbgl {
+
+/*
+   Laid out buckets, kept on disk so that the tiles of the last viewport are drawn from them
+   when the app starts again, without laying out their data, or parsing it if the tile has no
+   symbol layers. Entries are keyed by the bytes of the tile data, the layout of a layer group
+   and the parameters it was laid out with; see `GeometryTileWorker`.
+
+   Each key goes to one of a fixed number of files in the directory, which keeps the cache
+   bounded without keeping track of its entries: a key whose file holds another entry is a
+   miss, and takes the file over once it is laid out. Files hold their whole key, so entries
+   are never mistaken for each other.
+
+   All methods are thread-safe, and files are replaced atomically.
+*/
+class LayoutCache : private util::noncopyable {
+public:
+    // The directory must exist. It can sit next to the offline database, and be cleared with it.
+    explicit LayoutCache(std::string directory);
+
+    optional<std::string> get(const std::string& key) const;
+
+    // Errors are ignored: the bucket is laid out again next time.
+    void put(const std::string& key, const std::string& value);
+
+    // Stable across processes and platforms, unlike `std::hash`.
+    static uint64_t hash(const char* data, std::size_t length);
+
+    static constexpr std::size_t files = 4096;
+
+private:
+    std::string path(const std::string& key) const;
+
+    const std::string directory;
+};
+
+// Writes the values of an entry, in the byte order of the platform; entries aren't meant to
+// be moved between devices.
+class LayoutWriter {
+public:
+    template <class T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "written as bytes");
+        data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <class T>
+    void writeArray(const T* values, std::size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "written as bytes");
+        write<uint64_t>(count);
+        data.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+    }
+
+    // Of a `gl::SegmentVector`, without their vertex arrays.
+    template <class Segments>
+    void writeSegments(const Segments& segments) {
+        write<uint64_t>(segments.size());
+        for (const auto& segment : segments) {
+            write<uint64_t>(segment.vertexOffset);
+            write<uint64_t>(segment.indexOffset);
+            write<uint64_t>(segment.vertexLength);
+            write<uint64_t>(segment.indexLength);
+        }
+    }
+
+    std::string data;
+};
+
+// Reads what a `LayoutWriter` wrote. Reads past the end of the entry, e.g. of a truncated
+// file, fail instead.
+class LayoutReader {
+public:
+    explicit LayoutReader(const std::string& data_)
+        : data(data_) {
+    }
+
+    template <class T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "read as bytes");
+        if (data.size() - position < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    template <class T>
+    bool readArray(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "read as bytes");
+        uint64_t count;
+        if (!read(count) || count > (data.size() - position) / sizeof(T)) {
+            return false;
+        }
+        values.resize(count);
+        std::memcpy(values.data(), data.data() + position, count * sizeof(T));
+        position += count * sizeof(T);
+        return true;
+    }
+
+    template <class Segments>
+    bool readSegments(Segments& segments) {
+        uint64_t count;
+        if (!read(count) || count > (data.size() - position) / (4 * sizeof(uint64_t))) {
+            return false;
+        }
+        segments.reserve(count);
+        for (uint64_t i = 0; i < count; i++) {
+            uint64_t offsets[4];
+            read(offsets);
+            segments.emplace_back(offsets[0], offsets[1], offsets[2], offsets[3]);
+        }
+        return true;
+    }
+
+    bool atEnd() const {
+        return position == data.size();
+    }
+
+private:
+    const std::string& data;
+    std::size_t position = 0;
+};
+
+} // namespace mbgl
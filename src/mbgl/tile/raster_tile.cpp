@@ -10,16 +10,30 @@
 #include <mbgl/renderer/raster_bucket.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <cmath>
+
 namespace mbgl {
 
+namespace {
+
+// The size in pixels of the tile when it's drawn at its own zoom level.
+Size displaySize(const OverscaledTileID& id, const uint16_t tileSize, const float pixelRatio) {
+    const auto size = static_cast<uint32_t>(std::ceil(tileSize * pixelRatio * id.overscaleFactor()));
+    return { size, size };
+}
+
+} // namespace
+
 RasterTile::RasterTile(const OverscaledTileID& id_,
                        const style::UpdateParameters& parameters,
-                       const Tileset& tileset)
+                       const Tileset& tileset,
+                       const uint16_t tileSize)
     : Tile(id_),
       loader(*this, id_, parameters, tileset),
       mailbox(std::make_shared<Mailbox>(*util::RunLoop::Get())),
       worker(parameters.workerScheduler,
-             ActorRef<RasterTile>(*this, mailbox)) {
+             ActorRef<RasterTile>(*this, mailbox),
+             displaySize(id_, tileSize, parameters.pixelRatio)) {
 }
 
 RasterTile::~RasterTile() = default;
@@ -33,20 +47,28 @@ void RasterTile::setError(std::exception_ptr err) {
 
 void RasterTile::setData(std::shared_ptr<const std::string> data,
                              optional<Timestamp> modified_,
-                             optional<Timestamp> expires_) {
+                             optional<Timestamp> expires_,
+                             util::Compression compression) {
     modified = modified_;
     expires = expires_;
-    worker.invoke(&RasterTileWorker::parse, data);
+    dataSize = data ? data->size() : 0;
+    worker.invoke(&RasterTileWorker::parse, data, compression);
 }
 
 void RasterTile::onParsed(std::unique_ptr<Bucket> result) {
+    if (result && !timeline.parsed) {
+        timeline.parsed = Clock::now();
+    }
+
     bucket = std::move(result);
+    byteSize = bucket ? bucket->getByteSize() : 0;
     availableData = bucket ? DataAvailability::All : DataAvailability::None;
     observer->onTileChanged(*this);
 }
 
 void RasterTile::onError(std::exception_ptr err) {
     bucket.reset();
+    byteSize = 0;
     availableData = DataAvailability::None;
     observer->onTileError(*this, err);
 }
@@ -55,8 +77,31 @@ Bucket* RasterTile::getBucket(const style::Layer&) {
     return bucket.get();
 }
 
+std::size_t RasterTile::getByteSize() const {
+    return byteSize;
+}
+
+void RasterTile::addMemoryUsage(MemoryStats::Source& source) const {
+    if (bucket) {
+        bucket->addMemoryUsage(source);
+    }
+}
+
+void RasterTile::uploadBuckets(gl::Context& context) {
+    if (bucket && bucket->needsUpload()) {
+        bucket->upload(context);
+        context.bucketUploads++;
+    }
+}
+
 void RasterTile::setNecessity(Necessity necessity) {
+    worker.setPriority(necessity == Necessity::Required ? Mailbox::Priority::High
+                                                        : Mailbox::Priority::Low);
     loader.setNecessity(necessity);
 }
 
+void RasterTile::setPriority(Resource::Priority priority) {
+    loader.setPriority(priority);
+}
+
 } // namespace mbgl
@@ -18,15 +18,18 @@ class RasterTile : public Tile {
 public:
     RasterTile(const OverscaledTileID&,
                    const style::UpdateParameters&,
-                   const Tileset&);
+                   const Tileset&,
+                   uint16_t tileSize);
     ~RasterTile() final;
 
     void setNecessity(Necessity) final;
+    void setPriority(Resource::Priority) final;
 
     void setError(std::exception_ptr);
     void setData(std::shared_ptr<const std::string> data,
                  optional<Timestamp> modified_,
-                 optional<Timestamp> expires_);
+                 optional<Timestamp> expires_,
+                 util::Compression = util::Compression::None);
 
     void cancel() override;
     Bucket* getBucket(const style::Layer&) override;
@@ -34,6 +37,12 @@ public:
     void onParsed(std::unique_ptr<Bucket> result);
     void onError(std::exception_ptr);
 
+    std::size_t getByteSize() const override;
+    void addMemoryUsage(MemoryStats::Source&) const override;
+
+protected:
+    void uploadBuckets(gl::Context&) override;
+
 private:
     TileLoader<RasterTile> loader;
 
@@ -43,6 +52,9 @@ private:
     // Contains the Bucket object for the tile. Buckets are render
     // objects and they get added by tile parsing operations.
     std::unique_ptr<Bucket> bucket;
+
+    // Measured as the bucket arrives, before it is uploaded.
+    std::size_t byteSize = 0;
 };
 
 } // namespace mbgl
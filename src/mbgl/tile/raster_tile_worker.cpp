@@ -2,22 +2,27 @@
 #include <mbgl/tile/raster_tile.hpp>
 #include <mbgl/renderer/raster_bucket.hpp>
 #include <mbgl/actor/actor.hpp>
-#include <mbgl/util/premultiply.hpp>
+#include <mbgl/util/ktx.hpp>
 
 namespace mbgl {
 
-RasterTileWorker::RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile> parent_)
-    : parent(std::move(parent_)) {
+RasterTileWorker::RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile> parent_, Size displaySize_)
+    : parent(std::move(parent_)),
+      displaySize(displaySize_) {
 }
 
-void RasterTileWorker::parse(std::shared_ptr<const std::string> data) {
+void RasterTileWorker::parse(std::shared_ptr<const std::string> data, util::Compression compression) {
     if (!data) {
         parent.invoke(&RasterTile::onParsed, nullptr); // No data; empty tile.
         return;
     }
 
     try {
-        auto bucket = std::make_unique<RasterBucket>(util::unpremultiply(decodeImage(*data)));
+        data = util::decompress(std::move(data), compression);
+
+        // GPU compressed textures are uploaded as they are.
+        auto bucket = isKTX(*data) ? std::make_unique<RasterBucket>(decodeKTX(data))
+                                   : std::make_unique<RasterBucket>(decodeUnassociatedImage(*data, displaySize));
         parent.invoke(&RasterTile::onParsed, std::move(bucket));
     } catch (...) {
         parent.invoke(&RasterTile::onError, std::current_exception());
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/size.hpp>
 
 #include <memory>
 #include <string>
@@ -11,12 +13,16 @@ class RasterTile;
 
 class RasterTileWorker {
 public:
-    RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile>);
+    // Images larger than the tile is displayed are decoded at a reduced size where the
+    // decoder supports it.
+    RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile>, Size displaySize);
 
-    void parse(std::shared_ptr<const std::string> data);
+    // Data compressed as the cache stored it is inflated first.
+    void parse(std::shared_ptr<const std::string> data, util::Compression);
 
 private:
     ActorRef<RasterTile> parent;
+    const Size displaySize;
 };
 
 } // namespace mbgl
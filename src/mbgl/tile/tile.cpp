@@ -18,6 +18,19 @@ void Tile::setObserver(TileObserver* observer_) {
     observer = observer_;
 }
 
+void Tile::upload(gl::Context& context) {
+    uploadBuckets(context);
+    if (!timeline.uploaded) {
+        timeline.uploaded = Clock::now();
+    }
+    uploaded = true;
+    uploadDeferred = false;
+}
+
+void Tile::deferUpload() {
+    uploadDeferred = true;
+}
+
 void Tile::setTriedOptional() {
     triedOptional = true;
     observer->onTileChanged(*this);
@@ -33,6 +46,13 @@ void Tile::queryRenderedFeatures(
         std::unordered_map<std::string, std::vector<Feature>>&,
         const GeometryCoordinates&,
         const TransformState&,
-        const QueryOptions&) {}
+        const QueryOptions&,
+        FeatureDetail) {}
+
+void Tile::querySourceFeatures(
+        std::vector<Feature>&,
+        const std::vector<std::string>&,
+        const style::CompiledFilter&,
+        const optional<mapbox::geometry::box<int16_t>>&) const {}
 
 } // namespace mbgl
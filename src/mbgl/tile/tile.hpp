@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mbgl/map/memory_stats.hpp>
+#include <mbgl/map/tile_load_stats.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/optional.hpp>
@@ -23,8 +25,13 @@ class TileObserver;
 class PlacementConfig;
 class QueryOptions;
 
+namespace gl {
+class Context;
+} // namespace gl
+
 namespace style {
 class Layer;
+class CompiledFilter;
 } // namespace style
 
 class Tile : private util::noncopyable {
@@ -43,6 +50,10 @@ public:
 
     virtual void setNecessity(Necessity) = 0;
 
+    // Orders the network requests of required tiles: while the camera is animating, the tiles
+    // of the viewport it is headed for come before those it is only passing through.
+    virtual void setPriority(Resource::Priority) {}
+
     // Mark this tile as no longer needed and cancel any pending work.
     virtual void cancel() = 0;
 
@@ -52,11 +63,41 @@ public:
     virtual void symbolDependenciesChanged() {};
     virtual void redoLayout() {}
 
+    // Whether the tile indexes its features for `queryRenderedFeatures`; see
+    // `Map::setFeatureIndexing`.
+    virtual void setFeatureIndexing(bool) {}
+
+    // See `style::Source::setSimplificationTolerance`.
+    virtual void setSimplificationTolerance(float) {}
+
     virtual void queryRenderedFeatures(
             std::unordered_map<std::string, std::vector<Feature>>& result,
             const GeometryCoordinates& queryGeometry,
             const TransformState&,
-            const QueryOptions& options);
+            const QueryOptions& options,
+            FeatureDetail);
+
+    // Appends the features of the given source layers that match the filter and, if bounds
+    // are given, whose bounding box intersects them, in tile coordinates. Only reads the
+    // tile's data, so tiles can be queried concurrently.
+    virtual void querySourceFeatures(
+            std::vector<Feature>& result,
+            const std::vector<std::string>& sourceLayers,
+            const style::CompiledFilter&,
+            const optional<mapbox::geometry::box<int16_t>>& bounds) const;
+
+    // Uploads the tile's buckets for the first time; see `UploadScheduler`. Buckets that
+    // change after that are uploaded when they are rendered.
+    void upload(gl::Context&);
+
+    // Postpones the first upload to a later frame. Until then, the tile isn't renderable,
+    // and parents or children are rendered in its place.
+    void deferUpload();
+
+    // Returns true when the tile has data that has never been uploaded.
+    bool needsUpload() const {
+        return availableData != DataAvailability::None && !uploaded;
+    }
 
     void setTriedOptional();
 
@@ -70,24 +111,46 @@ public:
     // partial state is still waiting for network resources but can also
     // be rendered, although layers will be missing.
     bool isRenderable() const {
-        return availableData != DataAvailability::None;
+        return availableData != DataAvailability::None && !uploadDeferred;
     }
 
     bool isComplete() const {
-        return availableData == DataAvailability::All;
+        return availableData == DataAvailability::All && !uploadDeferred;
     }
 
+    // Roughly, the memory the tile's buckets and indices hold on to, once they are uploaded;
+    // what a `TileCache` budget is spent on.
+    virtual std::size_t getByteSize() const { return 0; }
+
+    // Frees what the tile's uploaded buckets keep on the CPU; see `Bucket::releaseRetainedData`.
+    // Returns the bytes freed.
+    virtual std::size_t releaseRetainedData() { return 0; }
+
+    // Adds what the tile's buckets, feature index and data hold to the usage of its source;
+    // see `Map::getMemoryStats`.
+    virtual void addMemoryUsage(MemoryStats::Source&) const {}
+
     void dumpDebugLogs() const;
 
     const OverscaledTileID id;
     optional<Timestamp> modified;
     optional<Timestamp> expires;
 
+    // The bytes of the last data the tile was given, as loaded.
+    std::size_t dataSize = 0;
+
+    // When the tile first went through each phase of loading; `tile` is left empty.
+    TileTimeline timeline;
+
     // Contains the tile ID string for painting debug information.
     std::unique_ptr<DebugBucket> debugBucket;
 
 protected:
+    virtual void uploadBuckets(gl::Context&) {}
+
     bool triedOptional = false;
+    bool uploaded = false;
+    bool uploadDeferred = false;
 
     enum class DataAvailability : uint8_t {
         // Still waiting for data to load or parse.
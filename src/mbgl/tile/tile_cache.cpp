@@ -1,20 +1,20 @@
 #include <mbgl/tile/tile_cache.hpp>
 #include <mbgl/tile/tile.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 
 namespace mbgl {
 
 void TileCache::setSize(size_t size_) {
     size = size_;
+    evict();
+}
 
-    while (orderedKeys.size() > size) {
-        auto key = orderedKeys.front();
-        orderedKeys.pop_front();
-        tiles.erase(key);
-    }
-
-    assert(orderedKeys.size() <= size);
+void TileCache::setMaximumBytes(size_t maximumBytes_) {
+    maximumBytes = maximumBytes_;
+    evict();
 }
 
 void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
@@ -22,45 +22,73 @@ void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
         return;
     }
 
-    // insert new or query existing tile
-    if (tiles.emplace(key, std::move(tile)).second) {
-        // remove existing tile key
-        orderedKeys.remove(key);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        // Keep the existing tile, as the newest.
+        entries.splice(entries.end(), entries, it->second);
+    } else {
+        const size_t tileBytes = tile->getByteSize();
+        entries.push_back({ key, std::move(tile), tileBytes });
+        index.emplace(key, std::prev(entries.end()));
+        bytes += tileBytes;
     }
 
-    // (re-)insert tile key as newest
-    orderedKeys.push_back(key);
-
-    // purge oldest key/tile if necessary
-    if (orderedKeys.size() > size) {
-        get(orderedKeys.front());
-    }
-
-    assert(orderedKeys.size() <= size);
+    evict();
 }
 
 std::unique_ptr<Tile> TileCache::get(const OverscaledTileID& key) {
-
-    std::unique_ptr<Tile> tile;
-
-    auto it = tiles.find(key);
-    if (it != tiles.end()) {
-        tile = std::move(it->second);
-        tiles.erase(it);
-        orderedKeys.remove(key);
-        assert(tile->isRenderable());
+    auto it = index.find(key);
+    if (it == index.end()) {
+        return {};
     }
 
+    std::unique_ptr<Tile> tile = std::move(it->second->tile);
+    bytes -= it->second->bytes;
+    entries.erase(it->second);
+    index.erase(it);
+    assert(tile->isRenderable());
     return tile;
 }
 
 bool TileCache::has(const OverscaledTileID& key) {
-    return tiles.find(key) != tiles.end();
+    return index.find(key) != index.end();
 }
 
 void TileCache::clear() {
-    orderedKeys.clear();
-    tiles.clear();
+    index.clear();
+    entries.clear();
+    bytes = 0;
+}
+
+size_t TileCache::releaseRetainedData() {
+    size_t result = 0;
+    for (auto& entry : entries) {
+        const size_t released = std::min(entry.tile->releaseRetainedData(), entry.bytes);
+        entry.bytes -= released;
+        bytes -= released;
+        result += released;
+    }
+    return result;
+}
+
+void TileCache::addMemoryUsage(MemoryStats::Source& source) const {
+    for (const auto& entry : entries) {
+        MemoryStats::Source tile;
+        entry.tile->addMemoryUsage(tile);
+        source.cache += tile.tileTotal();
+    }
+    source.cachedTiles += entries.size();
+}
+
+void TileCache::evict() {
+    while (!entries.empty() && (entries.size() > size || bytes > maximumBytes)) {
+        bytes -= entries.front().bytes;
+        index.erase(entries.front().key);
+        entries.pop_front();
+    }
+
+    assert(entries.size() <= size);
+    assert(bytes <= maximumBytes);
 }
 
 } // namespace mbgl
@@ -1,31 +1,62 @@
 #pragma once
 
+#include <mbgl/map/memory_stats.hpp>
 #include <mbgl/tile/tile_id.hpp>
 
+#include <cstddef>
+#include <limits>
 #include <list>
 #include <memory>
-#include <map>
+#include <unordered_map>
 
 namespace mbgl {
 
 class Tile;
 
+// Renderable tiles that are no longer needed, kept to be used again. Once there are more
+// of them than the size, or their bytes exceed the budget, the least recently added ones
+// are evicted. Each operation takes constant time.
 class TileCache {
 public:
     TileCache(size_t size_ = 0) : size(size_) {}
 
     void setSize(size_t);
     size_t getSize() const { return size; };
+
+    // The budget for the tiles' `getByteSize`, as measured when they are added.
+    void setMaximumBytes(size_t);
+    size_t getMaximumBytes() const { return maximumBytes; }
+    size_t getBytes() const { return bytes; }
+
     void add(const OverscaledTileID& key, std::unique_ptr<Tile> data);
     std::unique_ptr<Tile> get(const OverscaledTileID& key);
     bool has(const OverscaledTileID& key);
     void clear();
 
+    // Calls `releaseRetainedData` on every tile, and no longer counts what they freed.
+    // Returns the bytes freed.
+    size_t releaseRetainedData();
+
+    // Adds the number of tiles, and what they hold, to the `cachedTiles` and `cache` of the
+    // usage of their source.
+    void addMemoryUsage(MemoryStats::Source&) const;
+
 private:
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
-    std::list<OverscaledTileID> orderedKeys;
+    void evict();
+
+    struct Entry {
+        OverscaledTileID key;
+        std::unique_ptr<Tile> tile;
+        size_t bytes;
+    };
+
+    // From the oldest to the newest.
+    std::list<Entry> entries;
+    std::unordered_map<OverscaledTileID, std::list<Entry>::iterator> index;
 
     size_t size;
+    size_t maximumBytes = std::numeric_limits<size_t>::max();
+    size_t bytes = 0;
 };
 
 } // namespace mbgl
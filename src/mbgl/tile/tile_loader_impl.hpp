@@ -52,6 +52,9 @@ void TileLoader<T>::loadOptional() {
     assert(!request);
 
     resource.necessity = Resource::Optional;
+    if (!tile.timeline.requested) {
+        tile.timeline.requested = Clock::now();
+    }
     request = fileSource.request(resource, [this](Response res) {
         request.reset();
 
@@ -72,6 +75,16 @@ void TileLoader<T>::loadOptional() {
     });
 }
 
+template <typename T>
+void TileLoader<T>::setPriority(Resource::Priority priority) {
+    if (priority != resource.priority) {
+        resource.priority = priority;
+        if (request) {
+            fileSource.setPriority(*request, priority);
+        }
+    }
+}
+
 template <typename T>
 void TileLoader<T>::makeRequired() {
     if (!request) {
@@ -89,17 +102,23 @@ void TileLoader<T>::makeOptional() {
 
 template <typename T>
 void TileLoader<T>::loadedData(const Response& res) {
+    if (!tile.timeline.responded) {
+        tile.timeline.responded = Clock::now();
+        tile.timeline.fromCache = resource.necessity == Resource::Optional;
+    }
+
     if (res.error && res.error->reason != Response::Error::Reason::NotFound) {
         tile.setError(std::make_exception_ptr(std::runtime_error(res.error->message)));
     } else if (res.notModified) {
         resource.priorExpires = res.expires;
         // Do not notify the tile; when we get this message, it already has the current
-        // version of the data.
+        // version of the data, and only its expiry changes. It keeps its buckets.
+        tile.expires = res.expires;
     } else {
         resource.priorModified = res.modified;
         resource.priorExpires = res.expires;
         resource.priorEtag = res.etag;
-        tile.setData(res.noContent ? nullptr : res.data, res.modified, res.expires);
+        tile.setData(res.noContent ? nullptr : res.data, res.modified, res.expires, res.compression);
     }
 }
 
@@ -108,6 +127,9 @@ void TileLoader<T>::loadRequired() {
     assert(!request);
 
     resource.necessity = Resource::Required;
+    if (!tile.timeline.requested) {
+        tile.timeline.requested = Clock::now();
+    }
     request = fileSource.request(resource, [this](Response res) { loadedData(res); });
 }
 
@@ -2,10 +2,12 @@
 
 #include <mbgl/tile/geometry_tile.hpp>
 #include <mbgl/tile/tile_loader.hpp>
+#include <mbgl/util/compression.hpp>
 
 namespace mbgl {
 
 class Tileset;
+class VectorTileDataCache;
 
 namespace style {
 class UpdateParameters;
@@ -16,15 +18,23 @@ public:
     VectorTile(const OverscaledTileID&,
                std::string sourceID,
                const style::UpdateParameters&,
-               const Tileset&);
+               const Tileset&,
+               std::shared_ptr<VectorTileDataCache>);
 
     void setNecessity(Necessity) final;
+    void setPriority(Resource::Priority) final;
     void setData(std::shared_ptr<const std::string> data,
                  optional<Timestamp> modified,
-                 optional<Timestamp> expires);
+                 optional<Timestamp> expires,
+                 util::Compression = util::Compression::None);
 
 private:
     TileLoader<VectorTile> loader;
+    const std::shared_ptr<VectorTileDataCache> dataCache;
+
+    // The bytes of the current data, which it shares.
+    std::shared_ptr<const std::string> buffer;
+    util::Compression bufferCompression = util::Compression::None;
 };
 
 } // namespace mbgl
@@ -0,0 +1,418 @@
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/tileset.hpp>
+#include <mbgl/util/trace.hpp>
+#include <mbgl/util/varint.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <tuple>
+#include <utility>
+
+namespace mbgl {
+
+Value parseValue(protozero::pbf_reader data) {
+    while (data.next())
+    {
+        switch (data.tag()) {
+        case 1: // string_value
+            return data.get_string();
+        case 2: // float_value
+            return static_cast<double>(data.get_float());
+        case 3: // double_value
+            return data.get_double();
+        case 4: // int_value
+            return data.get_int64();
+        case 5: // uint_value
+            return data.get_uint64();
+        case 6: // sint_value
+            return data.get_sint64();
+        case 7: // bool_value
+            return data.get_bool();
+        default:
+            data.skip();
+            break;
+        }
+    }
+    return false;
+}
+
+VectorTileFeature::VectorTileFeature(protozero::pbf_reader feature_pbf, std::shared_ptr<VectorTileLayerData> layerData_)
+    : layerData(std::move(layerData_)) {
+    while (feature_pbf.next()) {
+        switch (feature_pbf.tag()) {
+        case 1: // id
+            id = { feature_pbf.get_uint64() };
+            break;
+        case 2: // tags
+            tags_iter = feature_pbf.get_packed_uint32();
+            break;
+        case 3: // type
+            type = static_cast<FeatureType>(feature_pbf.get_enum());
+            break;
+        case 4: // geometry
+            {
+                auto geometry = feature_pbf.get_data();
+                geometryBegin = geometry.first;
+                geometryEnd = geometry.first + geometry.second;
+            }
+            break;
+        default:
+            feature_pbf.skip();
+            break;
+        }
+    }
+}
+
+optional<Value> VectorTileFeature::getValue(const std::string& key) const {
+    optional<Value> storage;
+    const Value* value = findValue(key, storage);
+    return value ? optional<Value>(*value) : optional<Value>();
+}
+
+const Value* VectorTileFeature::findValue(const std::string& key, optional<Value>&) const {
+    auto keyIter = layerData->keysMap.find(key);
+    if (keyIter == layerData->keysMap.end()) {
+        return nullptr;
+    }
+
+    auto start_itr = tags_iter.begin();
+    const auto & end_itr = tags_iter.end();
+    while (start_itr != end_itr) {
+        uint32_t tag_key = static_cast<uint32_t>(*start_itr++);
+
+        if (layerData->keysMap.size() <= tag_key) {
+            throw std::runtime_error("feature referenced out of range key");
+        }
+
+        if (start_itr == end_itr) {
+            throw std::runtime_error("uneven number of feature tag ids");
+        }
+
+        uint32_t tag_val = static_cast<uint32_t>(*start_itr++);
+        if (tag_key == keyIter->second) {
+            return &layerData->getValue(tag_val);
+        }
+    }
+
+    return nullptr;
+}
+
+std::unordered_map<std::string,Value> VectorTileFeature::getProperties() const {
+    std::unordered_map<std::string,Value> properties;
+    properties.reserve(std::distance(tags_iter.begin(), tags_iter.end()) / 2);
+    auto start_itr = tags_iter.begin();
+    const auto & end_itr = tags_iter.end();
+    while (start_itr != end_itr) {
+        uint32_t tag_key = static_cast<uint32_t>(*start_itr++);
+        if (start_itr == end_itr) {
+            throw std::runtime_error("uneven number of feature tag ids");
+        }
+        uint32_t tag_val = static_cast<uint32_t>(*start_itr++);
+        properties[layerData->keys.at(tag_key)] = layerData->getValue(tag_val);
+    }
+    return properties;
+}
+
+optional<FeatureIdentifier> VectorTileFeature::getID() const {
+    return id;
+}
+
+GeometryCollection VectorTileFeature::getGeometries() const {
+    GeometryBuffer buffer;
+    readGeometries(buffer);
+    return buffer.toCollection();
+}
+
+void VectorTileFeature::readGeometries(GeometryBuffer& buffer) const {
+    // Command parameters are decoded in batches of up to `batch` points.
+    constexpr std::size_t batch = 64;
+    uint32_t deltas[2 * batch];
+    int32_t positions[2 * batch];
+
+    int32_t x = 0;
+    int32_t y = 0;
+    const float scale = float(util::EXTENT) / layerData->extent;
+
+    buffer.clear();
+    buffer.addRing();
+
+    const char* data = geometryBegin;
+    while (data != geometryEnd) {
+        uint32_t cmd_length;
+        if (util::decodeVarints(data, geometryEnd, &cmd_length, 1) != 1) {
+            throw std::runtime_error("malformed geometry");
+        }
+
+        const uint32_t cmd = cmd_length & 0x7;
+        uint32_t length = cmd_length >> 3;
+
+        if (cmd == 1 || cmd == 2) {
+            while (length > 0) {
+                // Every point of a MoveTo starts a new ring.
+                const std::size_t count = cmd == 1 ? 1 : std::min<std::size_t>(length, batch);
+                if (util::decodeVarints(data, geometryEnd, deltas, 2 * count) != 2 * count) {
+                    throw std::runtime_error("malformed geometry");
+                }
+                util::accumulateDeltas(deltas, count, x, y, positions);
+
+                if (cmd == 1 && !buffer.back().empty()) { // moveTo
+                    buffer.addRing();
+                }
+
+                GeometryCoordinate* points = buffer.addPoints(count);
+                if (scale == 1.0f) {
+                    for (std::size_t i = 0; i < count; ++i) {
+                        points[i] = { static_cast<int16_t>(positions[2 * i]), static_cast<int16_t>(positions[2 * i + 1]) };
+                    }
+                } else {
+                    for (std::size_t i = 0; i < count; ++i) {
+                        points[i] = { static_cast<int16_t>(::round(positions[2 * i] * scale)),
+                                      static_cast<int16_t>(::round(positions[2 * i + 1] * scale)) };
+                    }
+                }
+
+                length -= count;
+            }
+
+        } else if (cmd == 7) { // closePolygon
+            for (; length > 0; --length) {
+                const GeometryCoordinatesView line = buffer.back();
+                if (!line.empty()) {
+                    buffer.addPoint(line.front());
+                }
+            }
+
+        } else {
+            throw std::runtime_error("unknown command");
+        }
+    }
+
+    // Version 2 tiles are required to have valid polygons; older ones are checked first,
+    // since most of them are valid too.
+    if (layerData->version < 2 && type == FeatureType::Polygon && !isValidPolygon(buffer)) {
+        buffer.assign(fixupPolygons(buffer.toCollection()));
+    }
+}
+
+struct VectorTileData::Layers {
+    Layers(std::shared_ptr<const std::string> data_, util::Compression compression_)
+        : data(std::move(data_)),
+          compression(compression_) {
+    }
+
+    const std::shared_ptr<const std::string> data;
+    const util::Compression compression;
+
+    // A layer of the tile, whose features, keys and values are only collected once it is
+    // asked for, since styles usually use a fraction of the layers in a tile.
+    struct Layer {
+        Layer(protozero::pbf_reader message_)
+            : message(std::move(message_)) {
+        }
+
+        const protozero::pbf_reader message;
+        std::atomic<bool> parsed { false };
+        std::unique_ptr<VectorTileLayer> layer;
+    };
+
+    // Indexed on first access, which may happen on several threads at once, as may parsing
+    // a layer.
+    std::atomic<bool> indexed { false };
+    std::mutex parseMutex;
+    std::shared_ptr<const std::string> pbf;
+    std::unordered_map<std::string, Layer> layers;
+};
+
+VectorTileData::VectorTileData(std::shared_ptr<const std::string> data_, util::Compression compression)
+    : layers(std::make_shared<Layers>(std::move(data_), compression)) {
+}
+
+VectorTileData::VectorTileData(std::shared_ptr<Layers> layers_)
+    : layers(std::move(layers_)) {
+}
+
+std::unique_ptr<GeometryTileData> VectorTileData::clone() const {
+    return std::unique_ptr<GeometryTileData>(new VectorTileData(layers));
+}
+
+std::unique_ptr<GeometryTileData> VectorTileData::unparsed() const {
+    return std::make_unique<VectorTileData>(layers->data, layers->compression);
+}
+
+const std::string* VectorTileData::encoded() const {
+    return layers->data.get();
+}
+
+const GeometryTileLayer* VectorTileData::getLayer(const std::string& name) const {
+    if (!layers->indexed.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(layers->parseMutex);
+        if (!layers->indexed.load(std::memory_order_relaxed)) {
+            MBGL_TRACE_SCOPE("tile", "parse");
+
+            // Tiles read from MBTiles files, or served without a content encoding, may still be
+            // gzipped.
+            layers->pbf = util::decompress(layers->data, layers->compression);
+            if (layers->pbf->compare(0, 2, "\037\213") == 0) {
+                layers->pbf = std::make_shared<const std::string>(util::decompress(*layers->pbf));
+            }
+
+            // Only the name of each layer is read here; the rest of its message is skipped.
+            protozero::pbf_reader tile_pbf(*layers->pbf);
+            while (tile_pbf.next(3)) {
+                protozero::pbf_reader layer_pbf = tile_pbf.get_message();
+                protozero::pbf_reader name_pbf = layer_pbf;
+                std::string layerName;
+                if (name_pbf.next(1)) {
+                    layerName = name_pbf.get_string();
+                }
+                layers->layers.emplace(std::piecewise_construct,
+                                       std::forward_as_tuple(std::move(layerName)),
+                                       std::forward_as_tuple(std::move(layer_pbf)));
+            }
+            layers->indexed.store(true, std::memory_order_release);
+        }
+    }
+
+    auto it = layers->layers.find(name);
+    if (it == layers->layers.end()) {
+        return nullptr;
+    }
+
+    Layers::Layer& entry = it->second;
+    if (!entry.parsed.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(layers->parseMutex);
+        if (!entry.parsed.load(std::memory_order_relaxed)) {
+            MBGL_TRACE_SCOPE("tile", "parse layer");
+            entry.layer = std::make_unique<VectorTileLayer>(entry.message, layers->pbf);
+            entry.parsed.store(true, std::memory_order_release);
+        }
+    }
+    return entry.layer.get();
+}
+
+std::shared_ptr<VectorTileDataCache> VectorTileDataCache::shared(const Tileset& tileset) {
+    static std::mutex registryMutex;
+    static std::unordered_map<std::string, std::weak_ptr<VectorTileDataCache>> registry;
+
+    std::string key = tileset.scheme == Tileset::Scheme::TMS ? "tms" : "xyz";
+    for (const auto& url : tileset.tiles) {
+        key += '\n';
+        key += url;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto it = registry.begin(); it != registry.end();) {
+        if (it->second.expired()) {
+            it = registry.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    auto& entry = registry[key];
+    auto cache = entry.lock();
+    if (!cache) {
+        cache = std::make_shared<VectorTileDataCache>();
+        entry = cache;
+    }
+    return cache;
+}
+
+std::unique_ptr<VectorTileData> VectorTileDataCache::get(const CanonicalTileID& id,
+                                                         std::shared_ptr<const std::string> buffer,
+                                                         util::Compression compression) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.expired()) {
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    auto it = entries.find(id);
+    if (it != entries.end()) {
+        // Tiles loaded for different overscaled IDs, or by different maps, make separate
+        // requests, which usually yield separate copies of the same buffer. Comparing them
+        // is much cheaper than parsing and decoding one again, and unlike an etag, doesn't
+        // depend on the server providing one.
+        auto shared = it->second.lock();
+        if (shared && shared->compression == compression &&
+            (shared->data == buffer || *shared->data == *buffer)) {
+            return std::unique_ptr<VectorTileData>(new VectorTileData(std::move(shared)));
+        }
+    }
+
+    auto layers = std::make_shared<VectorTileData::Layers>(std::move(buffer), compression);
+    entries[id] = layers;
+    return std::unique_ptr<VectorTileData>(new VectorTileData(std::move(layers)));
+}
+
+VectorTileLayerData::VectorTileLayerData(std::shared_ptr<const std::string> pbfData) :
+    data(std::move(pbfData))
+{}
+
+const Value& VectorTileLayerData::getValue(uint32_t index) const {
+    if (valueMessages.size() <= index) {
+        throw std::runtime_error("feature referenced out of range value");
+    }
+
+    if (!decoded[index].load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(decodeMutex);
+        if (!decoded[index].load(std::memory_order_relaxed)) {
+            values[index] = parseValue(valueMessages[index]);
+            decoded[index].store(true, std::memory_order_release);
+        }
+    }
+    return *values[index];
+}
+
+VectorTileLayer::VectorTileLayer(protozero::pbf_reader layer_pbf, std::shared_ptr<const std::string> pbfData)
+    : data(std::make_shared<VectorTileLayerData>(std::move(pbfData)))
+{
+    while (layer_pbf.next()) {
+        switch (layer_pbf.tag()) {
+        case 1: // name
+            name = layer_pbf.get_string();
+            break;
+        case 2: // feature
+            features.push_back(layer_pbf.get_message());
+            break;
+        case 3: // keys
+            {
+                auto iter = data->keysMap.emplace(layer_pbf.get_string(), data->keysMap.size());
+                data->keys.emplace_back(std::reference_wrapper<const std::string>(iter.first->first));
+            }
+            break;
+        case 4: // values
+            data->valueMessages.push_back(layer_pbf.get_message());
+            break;
+        case 5: // extent
+            data->extent = layer_pbf.get_uint32();
+            break;
+        case 15: // version
+            data->version = layer_pbf.get_uint32();
+            break;
+        default:
+            layer_pbf.skip();
+            break;
+        }
+    }
+
+    data->values.resize(data->valueMessages.size());
+    data->decoded = std::make_unique<std::atomic<bool>[]>(data->valueMessages.size());
+}
+
+std::unique_ptr<GeometryTileFeature> VectorTileLayer::getFeature(std::size_t i) const {
+    return std::make_unique<VectorTileFeature>(features.at(i), data);
+}
+
+std::string VectorTileLayer::getName() const {
+    return name;
+}
+
+} // namespace mbgl
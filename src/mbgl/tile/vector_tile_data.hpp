@@ -0,0 +1,140 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <protozero/pbf_reader.hpp>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+class Tileset;
+class VectorTileLayer;
+
+using packed_iter_type = protozero::iterator_range<protozero::pbf_reader::const_uint32_iterator>;
+
+struct VectorTileLayerData {
+    VectorTileLayerData(std::shared_ptr<const std::string>);
+    
+    // Hold a reference to the underlying pbf data that backs the lazily-built
+    // components of the owning VectorTileLayer and VectorTileFeature objects
+    std::shared_ptr<const std::string> data;
+    
+    uint32_t version = 1;
+    uint32_t extent = 4096;
+    std::unordered_map<std::string, uint32_t> keysMap;
+    std::vector<std::reference_wrapper<const std::string>> keys;
+
+    // Values are decoded on first reference by any feature of the layer, and then shared
+    // by all of them. Decoding is thread-safe, so that layers sharing a source layer can be
+    // laid out concurrently, and clones of VectorTileData handed to other threads can share them.
+    const Value& getValue(uint32_t index) const;
+
+    std::vector<protozero::pbf_reader> valueMessages;
+    mutable std::vector<optional<Value>> values;
+    mutable std::unique_ptr<std::atomic<bool>[]> decoded;
+    mutable std::mutex decodeMutex;
+};
+
+class VectorTileFeature : public GeometryTileFeature {
+public:
+    VectorTileFeature(protozero::pbf_reader, std::shared_ptr<VectorTileLayerData> layerData);
+
+    FeatureType getType() const override { return type; }
+    optional<Value> getValue(const std::string&) const override;
+    const Value* findValue(const std::string&, optional<Value>&) const override;
+    std::unordered_map<std::string,Value> getProperties() const override;
+    optional<FeatureIdentifier> getID() const override;
+    GeometryCollection getGeometries() const override;
+    void readGeometries(GeometryBuffer&) const override;
+
+private:
+    std::shared_ptr<VectorTileLayerData> layerData;
+    optional<FeatureIdentifier> id;
+    FeatureType type = FeatureType::Unknown;
+    packed_iter_type tags_iter;
+    const char* geometryBegin = nullptr;
+    const char* geometryEnd = nullptr;
+};
+    
+class VectorTileLayer : public GeometryTileLayer {
+public:
+    VectorTileLayer(protozero::pbf_reader, std::shared_ptr<const std::string>);
+
+    std::size_t featureCount() const override { return features.size(); }
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const override;
+    std::string getName() const override;
+
+private:
+    friend class VectorTileData;
+    friend class VectorTileFeature;
+
+    std::string name;
+    std::vector<protozero::pbf_reader> features;
+    std::shared_ptr<VectorTileLayerData> data;
+};
+
+class VectorTileData : public GeometryTileData {
+public:
+    // Data compressed as the cache stored it is inflated when the tile is first parsed.
+    VectorTileData(std::shared_ptr<const std::string> data, util::Compression = util::Compression::None);
+
+    // Clones share the lazily decoded layers of this object. Parsing and decoding are
+    // thread-safe, so clones can be handed to other threads.
+    std::unique_ptr<GeometryTileData> clone() const override;
+    std::unique_ptr<GeometryTileData> unparsed() const override;
+    const std::string* encoded() const override;
+
+    const GeometryTileLayer* getLayer(const std::string&) const override;
+
+private:
+    friend class VectorTileDataCache;
+
+    struct Layers;
+    explicit VectorTileData(std::shared_ptr<Layers>);
+
+    std::shared_ptr<Layers> layers;
+};
+
+/*
+   The parsed tiles of a source, keyed by canonical tile ID, so that tiles that are loaded
+   for several overscaled IDs past the source's maxzoom are parsed and decoded only once.
+   Entries are held weakly, by the `VectorTileData` objects sharing them, and are dropped
+   once the last of those is destroyed.
+
+   Sources that opt in share a process-wide cache with every other source, in any map,
+   loading the same tiles. Methods are thread-safe, since maps can run on different threads.
+*/
+class VectorTileDataCache : private util::noncopyable {
+public:
+    // Returns the cache shared by the sources of `tileset`, which is kept as long as any
+    // of them uses it. Tilesets with the same tile URLs and scheme load the same tiles.
+    static std::shared_ptr<VectorTileDataCache> shared(const Tileset&);
+
+    // Returns data for `buffer`, sharing parsed layers with the data previously returned for
+    // the same tile if that is still alive and was made from an identical buffer.
+    std::unique_ptr<VectorTileData> get(const CanonicalTileID&,
+                                        std::shared_ptr<const std::string> buffer,
+                                        util::Compression = util::Compression::None);
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::map<CanonicalTileID, std::weak_ptr<VectorTileData::Layers>> entries;
+};
+
+} // namespace mbgl
@@ -0,0 +1,355 @@
+#pragma once
+
+#include <mbgl/util/optional.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+namespace mbgl {
+namespace util {
+
+template <class T>
+class Async;
+
+namespace detail {
+
+struct AsyncVoid {};
+
+template <class T>
+using AsyncValue = std::conditional_t<std::is_void<T>::value, AsyncVoid, T>;
+
+template <class T>
+class AsyncState;
+
+template <class T>
+class AsyncContinuation {
+public:
+    virtual ~AsyncContinuation() = default;
+
+    // Called on the RunLoop that registered the continuation, once `state` is settled.
+    virtual void resume(AsyncState<T>& state) = 0;
+};
+
+// The shared state of an `Async<T>`. It is settled exactly once, from any thread, and
+// has at most one continuation. The continuation is held weakly, so that dropping the
+// last `Async` of a chain cancels the continuations that have not yet run.
+template <class T>
+class AsyncState : public std::enable_shared_from_this<AsyncState<T>> {
+public:
+    using Value = AsyncValue<T>;
+
+    virtual ~AsyncState() = default;
+
+    void resolve(Value value_) {
+        settle(std::move(value_), nullptr);
+    }
+
+    void reject(std::exception_ptr error_) {
+        settle({}, std::move(error_));
+    }
+
+    bool isSettled() const {
+        return settled;
+    }
+
+    void await(RunLoop& loop_, std::weak_ptr<AsyncContinuation<T>> continuation_) {
+        std::unique_lock<std::mutex> lock(mutex);
+        assert(!loop);
+        loop = &loop_;
+        continuation = std::move(continuation_);
+        if (settled) {
+            lock.unlock();
+            post();
+        }
+    }
+
+    // Moves the value out, or rethrows the error.
+    Value take() {
+        assert(settled);
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*value);
+    }
+
+private:
+    void settle(optional<Value> value_, std::exception_ptr error_) {
+        std::unique_lock<std::mutex> lock(mutex);
+        assert(!settled);
+        value = std::move(value_);
+        error = std::move(error_);
+        settled = true;
+        if (loop) {
+            lock.unlock();
+            post();
+        }
+    }
+
+    void post() {
+        loop->invoke([self = this->shared_from_this(), weak = continuation] () {
+            if (auto continuation_ = weak.lock()) {
+                continuation_->resume(*self);
+            }
+        });
+    }
+
+    std::mutex mutex;
+    std::atomic<bool> settled { false };
+    optional<Value> value;
+    std::exception_ptr error;
+
+    RunLoop* loop = nullptr;
+    std::weak_ptr<AsyncContinuation<T>> continuation;
+};
+
+// Resolves `state` with the result of `fn(args...)`, or rejects it with the exception thrown.
+template <class T>
+struct AsyncSettle {
+    template <class Fn, class... Args>
+    static void run(AsyncState<T>& state, Fn&& fn, Args&&... args) {
+        try {
+            state.resolve(std::forward<Fn>(fn)(std::forward<Args>(args)...));
+        } catch (...) {
+            state.reject(std::current_exception());
+        }
+    }
+};
+
+template <>
+struct AsyncSettle<void> {
+    template <class Fn, class... Args>
+    static void run(AsyncState<void>& state, Fn&& fn, Args&&... args) {
+        try {
+            std::forward<Fn>(fn)(std::forward<Args>(args)...);
+            state.resolve({});
+        } catch (...) {
+            state.reject(std::current_exception());
+        }
+    }
+};
+
+// Calls `fn` with the value of a settled state, or without arguments for `void`.
+template <class Fn, class T>
+struct AsyncApply {
+    using Result = std::result_of_t<Fn(T)>;
+
+    static Result run(Fn& fn, AsyncState<T>& state) {
+        return fn(state.take());
+    }
+};
+
+template <class Fn>
+struct AsyncApply<Fn, void> {
+    using Result = std::result_of_t<Fn()>;
+
+    static Result run(Fn& fn, AsyncState<void>& state) {
+        state.take();
+        return fn();
+    }
+};
+
+template <class R>
+struct AsyncFlatten {
+    using Type = R;
+};
+
+template <class U>
+struct AsyncFlatten<Async<U>> {
+    using Type = U;
+};
+
+// The state of `upstream.then(fn)`. It owns `upstream`, so that a chain stays alive for
+// as long as its last stage is referenced, and is also the continuation of `upstream`.
+template <class T, class Fn, class R = typename AsyncApply<Fn, T>::Result>
+class AsyncThen : public AsyncState<R>, public AsyncContinuation<T> {
+public:
+    AsyncThen(std::shared_ptr<AsyncState<T>> upstream_, Fn fn_)
+        : upstream(std::move(upstream_)), fn(std::move(fn_)) {
+    }
+
+    void resume(AsyncState<T>& state) override {
+        AsyncSettle<R>::run(*this, [&] { return AsyncApply<Fn, T>::run(fn, state); });
+        upstream.reset();
+    }
+
+private:
+    std::shared_ptr<AsyncState<T>> upstream;
+    Fn fn;
+};
+
+// A stage whose function itself returns an `Async<U>` settles with that inner result.
+template <class T, class Fn, class U>
+class AsyncThen<T, Fn, Async<U>> : public AsyncState<U>, public AsyncContinuation<T> {
+public:
+    AsyncThen(std::shared_ptr<AsyncState<T>> upstream_, Fn fn_)
+        : upstream(std::move(upstream_)), fn(std::move(fn_)), forward(*this) {
+    }
+
+    void resume(AsyncState<T>& state) override {
+        upstream.reset();
+        try {
+            inner = AsyncApply<Fn, T>::run(fn, state).state;
+        } catch (...) {
+            this->reject(std::current_exception());
+            return;
+        }
+
+        assert(inner);
+        std::shared_ptr<AsyncState<U>> self =
+            std::static_pointer_cast<AsyncState<U>>(this->shared_from_this());
+        inner->await(*RunLoop::Get(), std::shared_ptr<AsyncContinuation<U>>(self, &forward));
+    }
+
+private:
+    struct Forward : AsyncContinuation<U> {
+        Forward(AsyncThen& outer_) : outer(outer_) {}
+
+        void resume(AsyncState<U>& state) override {
+            outer.inner.reset();
+            AsyncSettle<U>::run(outer, [&] { return state.take(); });
+        }
+
+        AsyncThen& outer;
+    };
+
+    std::shared_ptr<AsyncState<T>> upstream;
+    std::shared_ptr<AsyncState<U>> inner;
+    Fn fn;
+    Forward forward;
+};
+
+// The state of `upstream.catchError(fn)`: passes values through, and settles with the
+// result of `fn(error)` otherwise.
+template <class T, class Fn>
+class AsyncCatch : public AsyncState<T>, public AsyncContinuation<T> {
+public:
+    AsyncCatch(std::shared_ptr<AsyncState<T>> upstream_, Fn fn_)
+        : upstream(std::move(upstream_)), fn(std::move(fn_)) {
+    }
+
+    void resume(AsyncState<T>& state) override {
+        std::exception_ptr error;
+        try {
+            this->resolve(state.take());
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        if (error) {
+            AsyncSettle<T>::run(*this, fn, std::move(error));
+        }
+        upstream.reset();
+    }
+
+private:
+    std::shared_ptr<AsyncState<T>> upstream;
+    Fn fn;
+};
+
+// Resumes a suspended coroutine; used by `Async<T>::await_suspend`.
+template <class T, class Handle>
+class AsyncResume : public AsyncContinuation<T> {
+public:
+    AsyncResume(Handle handle_) : handle(std::move(handle_)) {}
+
+    void resume(AsyncState<T>&) override {
+        handle.resume();
+    }
+
+private:
+    Handle handle;
+};
+
+} // namespace detail
+
+/*
+    A single-shot asynchronous result, returned by `Thread<Object>::invokeAsync` and
+    `WorkQueue::pushAsync`.
+
+    `then(fn)` runs `fn(value)` on the RunLoop of the thread that called `then`, once the
+    value is available, and returns an `Async` for its result. If `fn` returns an `Async`
+    itself, the chain waits for it. Exceptions propagate down the chain, skipping stages,
+    until handled by `catchError` or rethrown by `await_resume`. Each stage is a single allocation that holds both
+    the stage function and its result; no `std::function` is involved.
+
+    An `Async` is also awaitable: in a coroutine, `co_await` suspends until the value is
+    available and resumes on the RunLoop of the awaiting thread.
+
+    Like `AsyncRequest`, an `Async` cancels on destruction: continuations that have not
+    yet run are dropped along with the last `Async` of the chain. The work already
+    posted to the other thread still runs.
+*/
+template <class T>
+class Async {
+public:
+    Async() = default;
+
+    explicit Async(std::shared_ptr<detail::AsyncState<T>> state_)
+        : state(std::move(state_)) {
+    }
+
+    bool valid() const {
+        return bool(state);
+    }
+
+    bool ready() const {
+        return state && state->isSettled();
+    }
+
+    template <class Fn>
+    auto then(Fn&& fn) && {
+        using Stage = detail::AsyncThen<T, std::decay_t<Fn>>;
+        using R = typename detail::AsyncFlatten<typename detail::AsyncApply<std::decay_t<Fn>, T>::Result>::Type;
+
+        assert(state);
+        auto upstream = state;
+        auto stage = std::make_shared<Stage>(std::move(state), std::forward<Fn>(fn));
+        upstream->await(*RunLoop::Get(), std::shared_ptr<detail::AsyncContinuation<T>>(stage));
+        return Async<R>(std::move(stage));
+    }
+
+    // Handles an error raised by this or an earlier stage. `fn(std::exception_ptr)` runs on
+    // the RunLoop of the calling thread and provides a replacement value, or may rethrow.
+    template <class Fn>
+    Async<T> catchError(Fn&& fn) && {
+        using Stage = detail::AsyncCatch<T, std::decay_t<Fn>>;
+
+        assert(state);
+        auto upstream = state;
+        auto stage = std::make_shared<Stage>(std::move(state), std::forward<Fn>(fn));
+        upstream->await(*RunLoop::Get(), std::shared_ptr<detail::AsyncContinuation<T>>(stage));
+        return Async<T>(std::move(stage));
+    }
+
+    bool await_ready() const {
+        return ready();
+    }
+
+    template <class Handle>
+    void await_suspend(Handle handle) {
+        auto resume = std::make_shared<detail::AsyncResume<T, Handle>>(std::move(handle));
+        state->await(*RunLoop::Get(), resume);
+        awaiter = std::move(resume);
+    }
+
+    T await_resume() {
+        awaiter.reset();
+        return static_cast<T>(state->take());
+    }
+
+private:
+    template <class, class, class>
+    friend class detail::AsyncThen;
+
+    std::shared_ptr<detail::AsyncState<T>> state;
+    std::shared_ptr<void> awaiter;
+};
+
+} // namespace util
+} // namespace mbgl
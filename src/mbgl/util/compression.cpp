@@ -1,7 +1,9 @@
 #include <mbgl/util/compression.hpp>
+#include <mbgl/util/trace.hpp>
 
 #include <zlib.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <stdexcept>
@@ -22,7 +24,7 @@ const static bool zlibVersionCheck __attribute__((unused)) = []() {
 namespace mbgl {
 namespace util {
 
-std::string compress(const std::string &raw) {
+std::string compress(const std::string &raw, const std::string &dictionary) {
     z_stream deflate_stream;
     memset(&deflate_stream, 0, sizeof(deflate_stream));
 
@@ -31,6 +33,13 @@ std::string compress(const std::string &raw) {
         throw std::runtime_error("failed to initialize deflate");
     }
 
+    if (!dictionary.empty() &&
+        deflateSetDictionary(&deflate_stream, reinterpret_cast<const Bytef *>(dictionary.data()),
+                             uInt(dictionary.size())) != Z_OK) {
+        deflateEnd(&deflate_stream);
+        throw std::runtime_error("failed to set deflate dictionary");
+    }
+
     deflate_stream.next_in = (Bytef *)raw.data();
     deflate_stream.avail_in = uInt(raw.size());
 
@@ -57,39 +66,109 @@ std::string compress(const std::string &raw) {
     return result;
 }
 
-std::string decompress(const std::string &raw) {
+std::string decompress(const std::string &raw, const std::string &dictionary) {
+    MBGL_TRACE_SCOPE("data", "decompress");
+
     z_stream inflate_stream;
     memset(&inflate_stream, 0, sizeof(inflate_stream));
 
     // TODO: reuse z_streams
-    if (inflateInit(&inflate_stream) != Z_OK) {
+    // Accepts both zlib and gzip headers.
+    if (inflateInit2(&inflate_stream, 32 + MAX_WBITS) != Z_OK) {
         throw std::runtime_error("failed to initialize inflate");
     }
 
     inflate_stream.next_in = (Bytef *)raw.data();
     inflate_stream.avail_in = uInt(raw.size());
 
-    std::string result;
-    char out[15384];
+    // Inflates right into the result, which is sized for the usual ratio of tiles and grows as
+    // needed.
+    std::string result(std::max<std::size_t>(raw.size() * 3, 16384), '\0');
 
     int code;
     do {
-        inflate_stream.next_out = reinterpret_cast<Bytef *>(out);
-        inflate_stream.avail_out = sizeof(out);
+        if (inflate_stream.total_out == result.size()) {
+            result.resize(result.size() * 2);
+        }
+        inflate_stream.next_out = reinterpret_cast<Bytef *>(&result[inflate_stream.total_out]);
+        inflate_stream.avail_out = uInt(result.size() - inflate_stream.total_out);
         code = inflate(&inflate_stream, 0);
-        // result.append(out, sizeof(out) - inflate_stream.avail_out);
-        if (result.size() < inflate_stream.total_out) {
-            result.append(out, inflate_stream.total_out - result.size());
+        if (code == Z_NEED_DICT && !dictionary.empty()) {
+            code = inflateSetDictionary(&inflate_stream, reinterpret_cast<const Bytef *>(dictionary.data()),
+                                        uInt(dictionary.size()));
         }
     } while (code == Z_OK);
 
+    const std::size_t size = inflate_stream.total_out;
     inflateEnd(&inflate_stream);
 
     if (code != Z_STREAM_END) {
         throw std::runtime_error(inflate_stream.msg ? inflate_stream.msg : "decompression error");
     }
 
+    // Results are often kept in caches, which shouldn't hold on to much unused space.
+    const bool wasteful = result.size() - size > size / 4;
+    result.resize(size);
+    if (wasteful) {
+        result.shrink_to_fit();
+    }
+
     return result;
 }
+
+const std::string& tileDictionary() {
+    // Encoded layer names, keys and common values of Mapbox Streets vector tiles, the most
+    // frequent last.
+    static const std::string dictionary {
+        "\042\017\012\015motorway_link" "\042\007\012\005trunk" "\042\012\012\010tertiary"
+        "\042\013\012\011secondary" "\042\011\012\007primary" "\042\012\012\010motorway"
+        "\042\010\012\006street" "\042\020\012\016street_limited" "\042\011\012\007service"
+        "\042\006\012\004path" "\042\014\012\012major_rail" "\042\014\012\012minor_rail"
+        "\042\007\012\005ferry" "\042\006\012\004link" "\042\007\012\005track"
+        "\042\014\012\012pedestrian" "\042\016\012\014construction" "\042\006\012\004wood"
+        "\042\007\012\005scrub" "\042\007\012\005grass" "\042\006\012\004crop" "\042\006\012\004snow"
+        "\042\006\012\004sand" "\042\006\012\004rock" "\042\006\012\004park" "\042\007\012\005pitch"
+        "\042\010\012\006school" "\042\012\012\010hospital" "\042\012\012\010cemetery"
+        "\042\014\012\012industrial" "\042\011\012\007parking" "\042\011\012\007glacier"
+        "\042\011\012\007wetland" "\042\017\012\015national_park" "\042\015\012\013agriculture"
+        "\042\007\012\005river" "\042\010\012\006stream" "\042\007\012\005canal" "\042\007\012\005drain"
+        "\042\007\012\005ditch" "\042\010\012\006runway" "\042\011\012\007taxiway"
+        "\042\007\012\005apron" "\042\011\012\007helipad" "\042\006\012\004city" "\042\006\012\004town"
+        "\042\011\012\007village" "\042\010\012\006hamlet" "\042\010\012\006suburb"
+        "\042\017\012\015neighbourhood" "\042\011\012\007country" "\042\007\012\005state"
+        "\042\007\012\005ocean" "\042\005\012\003sea" "\042\005\012\003bay" "\042\006\012\004none"
+        "\042\010\012\006bridge" "\042\010\012\006tunnel" "\042\006\012\004ford" "\042\006\012\004true"
+        "\042\007\012\005false" "\032\006shield" "\032\006reflen" "\032\003len" "\032\004ldir"
+        "\032\012iso_3166_2" "\032\012iso_3166_1" "\032\004maki" "\032\004area" "\032\011structure"
+        "\032\006oneway" "\032\005index" "\032\003ele" "\032\005level" "\032\010disputed"
+        "\032\010maritime" "\032\013admin_level" "\032\003ref" "\032\011scalerank" "\032\011localrank"
+        "\032\006osm_id" "\032\007name_zh" "\032\007name_ru" "\032\007name_fr" "\032\007name_es"
+        "\032\007name_de" "\032\007name_en" "\032\004name" "\032\004type" "\032\005class"
+        "\012\007contour" "\012\011hillshade" "\012\011landcover" "\012\007aeroway"
+        "\012\014barrier_line" "\012\010building" "\012\016housenum_label" "\012\021motorway_junction"
+        "\012\015airport_label" "\012\014marine_label" "\012\013state_label" "\012\015country_label"
+        "\012\023mountain_peak_label" "\012\022rail_station_label" "\012\016waterway_label"
+        "\012\013water_label" "\012\012road_label" "\012\011poi_label" "\012\013place_label"
+        "\012\017landuse_overlay" "\012\007landuse" "\012\010waterway" "\012\005admin" "\012\004road"
+        "\012\005water" "(\200 x\002"
+    };
+    return dictionary;
+}
+
+std::shared_ptr<const std::string> decompress(std::shared_ptr<const std::string> data, Compression compression) {
+    if (!data) {
+        return data;
+    }
+    switch (compression) {
+    case Compression::Deflate:
+        return std::make_shared<const std::string>(decompress(*data));
+    case Compression::DeflateWithTileDictionary:
+        return std::make_shared<const std::string>(decompress(*data, tileDictionary()));
+    case Compression::None:
+        break;
+    }
+    return data;
+}
+
 } // namespace util
 } // namespace mbgl
@@ -2,8 +2,6 @@
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/math/minmax.hpp>
 
-#include <unordered_set>
-
 namespace mbgl {
 
 
@@ -43,39 +41,23 @@ void GridIndex<T>::insert(T&& t, const BBox& bbox) {
 template <class T>
 std::vector<T> GridIndex<T>::query(const BBox& queryBBox) const {
     std::vector<T> result;
-    std::unordered_set<size_t> seenUids;
-
-    auto cx1 = convertToCellCoord(queryBBox.min.x);
-    auto cy1 = convertToCellCoord(queryBBox.min.y);
-    auto cx2 = convertToCellCoord(queryBBox.max.x);
-    auto cy2 = convertToCellCoord(queryBBox.max.y);
-
-    int32_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = d * y + x;
-            for (auto uid : cells[cellIndex]) {
-                if (seenUids.count(uid) == 0) {
-                    seenUids.insert(uid);
+    query(queryBBox, [&] (const T& t) {
+        result.push_back(t);
+        return true;
+    });
+    return result;
+}
 
-                    auto& pair = elements.at(uid);
-                    auto& bbox = pair.second;
-                    if (queryBBox.min.x <= bbox.max.x &&
-                        queryBBox.min.y <= bbox.max.y &&
-                        queryBBox.max.x >= bbox.min.x &&
-                        queryBBox.max.y >= bbox.min.y) {
 
-                        result.push_back(pair.first);
-                    }
-                }
-            }
-        }
+template <class T>
+std::size_t GridIndex<T>::byteSize() const {
+    std::size_t result = elements.capacity() * sizeof(elements[0]) + cells.capacity() * sizeof(cells[0]);
+    for (const auto& cell : cells) {
+        result += cell.capacity() * sizeof(size_t);
     }
-
     return result;
 }
 
-
 template <class T>
 int32_t GridIndex<T>::convertToCellCoord(int32_t x) const {
     return util::max(0.0, util::min(d - 1.0, std::floor(x * scale) + padding));
@@ -3,6 +3,7 @@
 #include <mapbox/geometry/point.hpp>
 #include <mapbox/geometry/box.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
 #include <vector>
@@ -19,6 +20,14 @@ public:
     void insert(T&& t, const BBox&);
     std::vector<T> query(const BBox&) const;
 
+    // Calls `fn` with each element whose box intersects `bbox`, once, in the order of
+    // `query`, until it returns false. Doesn't allocate.
+    template <class Fn>
+    void query(const BBox&, Fn&& fn) const;
+
+    // Of the elements and the cells, without allocator overhead.
+    std::size_t byteSize() const;
+
 private:
     int32_t convertToCellCoord(int32_t x) const;
 
@@ -35,4 +44,40 @@ private:
 
 };
 
+template <class T>
+template <class Fn>
+void GridIndex<T>::query(const BBox& queryBBox, Fn&& fn) const {
+    auto cx1 = convertToCellCoord(queryBBox.min.x);
+    auto cy1 = convertToCellCoord(queryBBox.min.y);
+    auto cx2 = convertToCellCoord(queryBBox.max.x);
+    auto cy2 = convertToCellCoord(queryBBox.max.y);
+
+    int32_t x, y, cellIndex;
+    for (x = cx1; x <= cx2; ++x) {
+        for (y = cy1; y <= cy2; ++y) {
+            cellIndex = d * y + x;
+            for (auto uid : cells[cellIndex]) {
+                auto& pair = elements[uid];
+                auto& bbox = pair.second;
+
+                // An element covers a rectangle of cells; it is only visited in the first of
+                // them that the query covers too.
+                if (x != std::max(cx1, convertToCellCoord(bbox.min.x)) ||
+                    y != std::max(cy1, convertToCellCoord(bbox.min.y))) {
+                    continue;
+                }
+
+                if (queryBBox.min.x <= bbox.max.x &&
+                    queryBBox.min.y <= bbox.max.y &&
+                    queryBBox.max.x >= bbox.min.x &&
+                    queryBBox.max.y >= bbox.min.y) {
+                    if (!fn(pair.first)) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
 } // namespace mbgl
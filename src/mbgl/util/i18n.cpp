@@ -1,6 +1,10 @@
 #include "i18n.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <map>
+#include <vector>
 
 namespace {
 
@@ -310,13 +314,8 @@ const std::map<char16_t, char16_t> verticalPunctuation = {
     { u'｛', u'︷' }, { u'｜', u'―' },  { u'｝', u'︸' }, { u'｟', u'︵' }, { u'｠', u'︶' },
     { u'｡', u'︒' },  { u'｢', u'﹁' },  { u'｣', u'﹂' },
 };
-}
-
-namespace mbgl {
-namespace util {
-namespace i18n {
 
-bool allowsWordBreaking(char16_t chr) {
+bool isWordBreaking(char16_t chr) {
     return (chr == 0x0a      /* newline */
             || chr == 0x20   /* space */
             || chr == 0x26   /* ampersand */
@@ -332,16 +331,7 @@ bool allowsWordBreaking(char16_t chr) {
             || chr == 0x2013 /* en dash */);
 }
 
-bool allowsIdeographicBreaking(const std::u16string& string) {
-    for (char16_t chr : string) {
-        if (!allowsIdeographicBreaking(chr)) {
-            return false;
-        }
-    }
-    return true;
-}
-
-bool allowsIdeographicBreaking(char16_t chr) {
+bool isIdeographicBreaking(char16_t chr) {
     // Allow U+2027 "Interpunct" for hyphenation of Chinese words
     if (chr == 0x2027)
         return true;
@@ -374,22 +364,13 @@ bool allowsIdeographicBreaking(char16_t chr) {
     //        || isInCJKCompatibilityIdeographsSupplement(chr));
 }
 
-bool allowsVerticalWritingMode(const std::u16string& string) {
-    for (char32_t chr : string) {
-        if (hasUprightVerticalOrientation(chr)) {
-            return true;
-        }
-    }
-    return false;
-}
-
 // The following logic comes from
 // <http://www.unicode.org/Public/vertical/revision-16/VerticalOrientation-16.txt>.
 // The data file denotes with “U” or “Tu” any codepoint that may be drawn
 // upright in vertical text but does not distinguish between upright and
 // “neutral” characters.
 
-bool hasUprightVerticalOrientation(char16_t chr) {
+bool isUpright(char16_t chr) {
     if (chr == u'˪' || chr == u'˫')
         return true;
 
@@ -474,7 +455,7 @@ bool hasUprightVerticalOrientation(char16_t chr) {
     return false;
 }
 
-bool hasNeutralVerticalOrientation(char16_t chr) {
+bool isNeutral(char16_t chr) {
     if (isInLatin1Supplement(chr)) {
         if (chr == u'§' || chr == u'©' || chr == u'®' || chr == u'±' || chr == u'¼' ||
             chr == u'½' || chr == u'¾' || chr == u'×' || chr == u'÷') {
@@ -525,22 +506,136 @@ bool hasNeutralVerticalOrientation(char16_t chr) {
     return false;
 }
 
+// Properties of codepoints, as evaluated by the functions above.
+enum Property : uint8_t {
+    WordBreaking = 1 << 0,
+    IdeographicBreaking = 1 << 1,
+    UprightVerticalOrientation = 1 << 2,
+    NeutralVerticalOrientation = 1 << 3,
+    VerticalPunctuation = 1 << 4,
+};
+
+/*
+    The properties of every codepoint in the Basic Multilingual Plane, so that each lookup
+    takes constant time rather than a walk through the block ranges. The table has two
+    levels: the high byte of a codepoint selects a block of 256 entries, and blocks with
+    identical entries are stored once, which leaves the table small enough to stay in cache.
+*/
+class PropertyTable {
+public:
+    PropertyTable() {
+        std::array<uint8_t, 256> block;
+        for (uint32_t high = 0; high < 256; ++high) {
+            for (uint32_t low = 0; low < 256; ++low) {
+                const char16_t chr = high << 8 | low;
+                block[low] = (isWordBreaking(chr) ? WordBreaking : 0) |
+                             (isIdeographicBreaking(chr) ? IdeographicBreaking : 0) |
+                             (isUpright(chr) ? UprightVerticalOrientation : 0) |
+                             (isNeutral(chr) ? NeutralVerticalOrientation : 0) |
+                             (verticalPunctuation.count(chr) ? VerticalPunctuation : 0);
+            }
+            auto it = std::find(blocks.begin(), blocks.end(), block);
+            blockIndices[high] = it - blocks.begin();
+            if (it == blocks.end()) {
+                blocks.push_back(block);
+            }
+        }
+    }
+
+    // Whether the codepoint has any of the given properties.
+    bool has(char16_t chr, uint8_t properties) const {
+        return blocks[blockIndices[chr >> 8]][chr & 0xFF] & properties;
+    }
+
+private:
+    std::array<uint8_t, 256> blockIndices;
+    std::vector<std::array<uint8_t, 256>> blocks;
+};
+
+const PropertyTable& propertyTable() {
+    static const PropertyTable table;
+    return table;
+}
+
+// Whether all code units of the string are ASCII. Written without branches, so that
+// compilers vectorize it.
+bool isASCII(const std::u16string& string) {
+    char16_t bits = 0;
+    for (char16_t chr : string) {
+        bits |= chr;
+    }
+    return bits < 0x80;
+}
+
+} // namespace
+
+namespace mbgl {
+namespace util {
+namespace i18n {
+
+bool allowsWordBreaking(char16_t chr) {
+    return propertyTable().has(chr, WordBreaking);
+}
+
+bool allowsIdeographicBreaking(const std::u16string& string) {
+    for (char16_t chr : string) {
+        if (!allowsIdeographicBreaking(chr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool allowsIdeographicBreaking(char16_t chr) {
+    return propertyTable().has(chr, IdeographicBreaking);
+}
+
+bool allowsVerticalWritingMode(const std::u16string& string) {
+    // No ASCII character is upright in vertical writing mode.
+    if (isASCII(string)) {
+        return false;
+    }
+
+    const PropertyTable& table = propertyTable();
+    for (char16_t chr : string) {
+        if (table.has(chr, UprightVerticalOrientation)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool hasUprightVerticalOrientation(char16_t chr) {
+    return propertyTable().has(chr, UprightVerticalOrientation);
+}
+
+bool hasNeutralVerticalOrientation(char16_t chr) {
+    return propertyTable().has(chr, NeutralVerticalOrientation);
+}
+
 bool hasRotatedVerticalOrientation(char16_t chr) {
     return !(hasUprightVerticalOrientation(chr) || hasNeutralVerticalOrientation(chr));
 }
 
 std::u16string verticalizePunctuation(const std::u16string& input) {
+    const PropertyTable& table = propertyTable();
+
+    // Whether punctuation next to the character may be verticalized: it must not be rotated,
+    // unless it is punctuation itself.
+    auto allowsVerticalNeighbor = [&] (char16_t chr) {
+        return table.has(chr, UprightVerticalOrientation | NeutralVerticalOrientation | VerticalPunctuation);
+    };
+
     std::u16string output;
+    output.reserve(input.size());
 
     for (size_t i = 0; i < input.size(); i++) {
-        char16_t nextCharCode = i < input.size() ? input[i + 1] : 0;
+        char16_t nextCharCode = i + 1 < input.size() ? input[i + 1] : 0;
         char16_t prevCharCode = i ? input[i - 1] : 0;
 
         bool canReplacePunctuation =
-            ((!nextCharCode || !hasRotatedVerticalOrientation(nextCharCode) ||
-              verticalPunctuation.count(input[i + 1])) &&
-             (!prevCharCode || !hasRotatedVerticalOrientation(prevCharCode) ||
-              verticalPunctuation.count(input[i - 1])));
+            (!nextCharCode || allowsVerticalNeighbor(nextCharCode)) &&
+            (!prevCharCode || allowsVerticalNeighbor(prevCharCode));
 
         if (char16_t repl = canReplacePunctuation ? verticalizePunctuation(input[i]) : 0) {
             output += repl;
@@ -553,7 +648,10 @@ std::u16string verticalizePunctuation(const std::u16string& input) {
 }
 
 char16_t verticalizePunctuation(char16_t chr) {
-    return verticalPunctuation.count(chr) ? verticalPunctuation.at(chr) : 0;
+    if (!propertyTable().has(chr, VerticalPunctuation)) {
+        return 0;
+    }
+    return verticalPunctuation.find(chr)->second;
 }
 
 } // namespace i18n
@@ -0,0 +1,52 @@
+#include <mbgl/util/interned_string.hpp>
+
+#include <cassert>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+struct InternedStrings {
+    std::mutex mutex;
+    std::unordered_map<std::string, uint32_t> ids;
+
+    // Elements of a deque stay in place as it grows.
+    std::deque<std::string> strings;
+};
+
+InternedStrings& internedStrings() {
+    static InternedStrings instance;
+    return instance;
+}
+
+} // namespace
+
+uint32_t internString(const std::string& string) {
+    InternedStrings& interned = internedStrings();
+    std::lock_guard<std::mutex> lock(interned.mutex);
+
+    auto it = interned.ids.find(string);
+    if (it != interned.ids.end()) {
+        return it->second;
+    }
+
+    const uint32_t id = interned.strings.size();
+    interned.strings.push_back(string);
+    interned.ids.emplace(string, id);
+    return id;
+}
+
+const std::string& internedString(uint32_t id) {
+    InternedStrings& interned = internedStrings();
+    std::lock_guard<std::mutex> lock(interned.mutex);
+
+    assert(id < interned.strings.size());
+    return interned.strings[id];
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace mbgl {
+namespace util {
+
+// Maps each distinct string to an ID for the lifetime of the process, so that records
+// naming layers can be copied and compared without touching strings. Interned strings are
+// never released; this is meant for bounded sets of names, such as those of layers.
+// Thread-safe.
+uint32_t internString(const std::string&);
+const std::string& internedString(uint32_t id);
+
+} // namespace util
+} // namespace mbgl
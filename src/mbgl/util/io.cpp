@@ -32,6 +32,16 @@ std::string read_file(const std::string &filename) {
     }
 }
 
+optional<std::string> readFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (file.good()) {
+        std::stringstream data;
+        data << file.rdbuf();
+        return data.str();
+    }
+    return {};
+}
+
 void deleteFile(const std::string& filename) {
     const int ret = unlink(filename.c_str());
     if (ret == -1) {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mbgl/util/optional.hpp>
+
 #include <string>
 #include <stdexcept>
 
@@ -15,6 +17,9 @@ struct IOException : std::runtime_error {
 void write_file(const std::string &filename, const std::string &data);
 std::string read_file(const std::string &filename);
 
+// Returns nothing if the file can't be opened, rather than throwing.
+optional<std::string> readFile(const std::string& filename);
+
 void deleteFile(const std::string& filename);
 
 } // namespace util
@@ -0,0 +1,112 @@
+#include <mbgl/util/ktx.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace mbgl {
+
+namespace {
+
+constexpr std::array<uint8_t, 12> identifier {{
+    0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+}};
+
+constexpr uint32_t endianness = 0x04030201;
+constexpr uint32_t swappedEndianness = 0x01020304;
+
+// The fields that follow the identifier, in order.
+enum Field {
+    Endianness,
+    GLType,
+    GLTypeSize,
+    GLFormat,
+    GLInternalFormat,
+    GLBaseInternalFormat,
+    PixelWidth,
+    PixelHeight,
+    PixelDepth,
+    NumberOfArrayElements,
+    NumberOfFaces,
+    NumberOfMipmapLevels,
+    BytesOfKeyValueData,
+    FieldCount
+};
+
+uint32_t read(const uint8_t* data, bool swap) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    if (swap) {
+        value = (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+    }
+    return value;
+}
+
+} // namespace
+
+bool isKTX(const std::string& data) {
+    return data.size() >= identifier.size() &&
+        std::memcmp(data.data(), identifier.data(), identifier.size()) == 0;
+}
+
+CompressedImage decodeKTX(std::shared_ptr<const std::string> container) {
+    const std::size_t headerSize = identifier.size() + FieldCount * sizeof(uint32_t);
+    if (!isKTX(*container) || container->size() < headerSize) {
+        throw std::runtime_error("invalid KTX header");
+    }
+
+    const uint8_t* begin = reinterpret_cast<const uint8_t*>(container->data());
+    const uint8_t* end = begin + container->size();
+
+    const uint32_t order = read(begin + identifier.size(), false);
+    if (order != endianness && order != swappedEndianness) {
+        throw std::runtime_error("invalid KTX endianness");
+    }
+    const bool swap = order == swappedEndianness;
+
+    std::array<uint32_t, FieldCount> header;
+    for (std::size_t i = 0; i < FieldCount; ++i) {
+        header[i] = read(begin + identifier.size() + i * sizeof(uint32_t), swap);
+    }
+
+    // Compressed formats have neither a type nor a format of their own.
+    if (header[GLType] != 0 || header[GLFormat] != 0) {
+        throw std::runtime_error("KTX texture is not compressed");
+    }
+    if (header[PixelWidth] == 0 || header[PixelHeight] == 0 || header[PixelDepth] != 0 ||
+        header[NumberOfArrayElements] != 0 || header[NumberOfFaces] != 1) {
+        throw std::runtime_error("KTX texture is not a single 2D texture");
+    }
+
+    CompressedImage image;
+    image.format = header[GLInternalFormat];
+    image.size = { header[PixelWidth], header[PixelHeight] };
+
+    const uint8_t* position = begin + headerSize;
+    if (std::size_t(end - position) < header[BytesOfKeyValueData]) {
+        throw std::runtime_error("truncated KTX key and value data");
+    }
+    position += header[BytesOfKeyValueData];
+
+    // Zero levels means a full mipmap chain is to be generated, from the one that's there.
+    const uint32_t levels = header[NumberOfMipmapLevels] ? header[NumberOfMipmapLevels] : 1;
+    for (uint32_t level = 0; level < levels; ++level) {
+        if (end - position < 4) {
+            throw std::runtime_error("truncated KTX image data");
+        }
+        const uint32_t size = read(position, swap);
+        position += 4;
+        if (std::size_t(end - position) < size) {
+            throw std::runtime_error("truncated KTX image data");
+        }
+        image.levels.push_back({ position, size });
+        // Each level is padded to four bytes.
+        position += std::min<std::size_t>(end - position, (std::size_t(size) + 3) & ~std::size_t(3));
+    }
+
+    image.container = std::move(container);
+    return image;
+}
+
+} // namespace mbgl
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <mbgl/util/size.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// A texture in a GPU compressed format, such as ETC2, ASTC or BC, as read from a KTX
+// container. Its levels point into the container, which it keeps.
+class CompressedImage {
+public:
+    struct Level {
+        const uint8_t* data;
+        std::size_t size;
+    };
+
+    // The OpenGL internal format, e.g. GL_COMPRESSED_RGB8_ETC2.
+    uint32_t format = 0;
+    Size size;
+
+    // The mipmap levels that are present, from the full size down.
+    std::vector<Level> levels;
+
+    std::shared_ptr<const std::string> container;
+};
+
+bool isKTX(const std::string&);
+
+// Reads a KTX 1.1 container of a single 2D texture in a compressed format. Throws if it is
+// malformed, or something else.
+CompressedImage decodeKTX(std::shared_ptr<const std::string>);
+
+} // namespace mbgl
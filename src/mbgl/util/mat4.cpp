@@ -24,6 +24,12 @@
 
 #include <cmath>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace mbgl {
 
 namespace matrix {
@@ -304,6 +310,37 @@ void scale(mat4& out, const mat4& a, double x, double y, double z) {
 }
 
 void multiply(mat4& out, const mat4& a, const mat4& b) {
+#if defined(__SSE2__)
+    // Each column of the result sums the columns of `a`, weighted by a column of `b`, two
+    // rows at a time; the sums are formed in the same order as the scalar code.
+    const __m128d a0l = _mm_loadu_pd(&a[0]), a0h = _mm_loadu_pd(&a[2]);
+    const __m128d a1l = _mm_loadu_pd(&a[4]), a1h = _mm_loadu_pd(&a[6]);
+    const __m128d a2l = _mm_loadu_pd(&a[8]), a2h = _mm_loadu_pd(&a[10]);
+    const __m128d a3l = _mm_loadu_pd(&a[12]), a3h = _mm_loadu_pd(&a[14]);
+
+    for (std::size_t i = 0; i < 16; i += 4) {
+        const __m128d b0 = _mm_set1_pd(b[i]), b1 = _mm_set1_pd(b[i + 1]),
+                      b2 = _mm_set1_pd(b[i + 2]), b3 = _mm_set1_pd(b[i + 3]);
+        _mm_storeu_pd(&out[i], _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(b0, a0l), _mm_mul_pd(b1, a1l)),
+                                                     _mm_mul_pd(b2, a2l)), _mm_mul_pd(b3, a3l)));
+        _mm_storeu_pd(&out[i + 2], _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(b0, a0h), _mm_mul_pd(b1, a1h)),
+                                                         _mm_mul_pd(b2, a2h)), _mm_mul_pd(b3, a3h)));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    // See above. Multiplies and adds are kept apart, rather than fused, for the same results.
+    const float64x2_t a0l = vld1q_f64(&a[0]), a0h = vld1q_f64(&a[2]);
+    const float64x2_t a1l = vld1q_f64(&a[4]), a1h = vld1q_f64(&a[6]);
+    const float64x2_t a2l = vld1q_f64(&a[8]), a2h = vld1q_f64(&a[10]);
+    const float64x2_t a3l = vld1q_f64(&a[12]), a3h = vld1q_f64(&a[14]);
+
+    for (std::size_t i = 0; i < 16; i += 4) {
+        const double b0 = b[i], b1 = b[i + 1], b2 = b[i + 2], b3 = b[i + 3];
+        vst1q_f64(&out[i], vaddq_f64(vaddq_f64(vaddq_f64(vmulq_n_f64(a0l, b0), vmulq_n_f64(a1l, b1)),
+                                               vmulq_n_f64(a2l, b2)), vmulq_n_f64(a3l, b3)));
+        vst1q_f64(&out[i + 2], vaddq_f64(vaddq_f64(vaddq_f64(vmulq_n_f64(a0h, b0), vmulq_n_f64(a1h, b1)),
+                                                   vmulq_n_f64(a2h, b2)), vmulq_n_f64(a3h, b3)));
+    }
+#else
     double a00 = a[0], a01 = a[1], a02 = a[2], a03 = a[3],
           a10 = a[4], a11 = a[5], a12 = a[6], a13 = a[7],
           a20 = a[8], a21 = a[9], a22 = a[10], a23 = a[11],
@@ -333,6 +370,7 @@ void multiply(mat4& out, const mat4& a, const mat4& b) {
     out[13] = b0 * a01 + b1 * a11 + b2 * a21 + b3 * a31;
     out[14] = b0 * a02 + b1 * a12 + b2 * a22 + b3 * a32;
     out[15] = b0 * a03 + b1 * a13 + b2 * a23 + b3 * a33;
+#endif
 }
 
 void transformMat4(vec4& out, const vec4& a, const mat4& m) {
@@ -8,14 +8,19 @@ namespace mbgl {
 
 class OffscreenTexture::Impl {
 public:
-    Impl(gl::Context& context_, const Size size_) : context(context_), size(std::move(size_)) {
+    Impl(gl::Context& context_, const Size size_,
+         gl::Renderbuffer<gl::RenderbufferType::DepthStencil>* depthStencil_ = nullptr)
+        : context(context_), size(std::move(size_)), depthStencil(depthStencil_) {
         assert(size);
+        assert(!depthStencil || depthStencil->size == size);
     }
 
     void bind() {
         if (!framebuffer) {
+            gl::ResourceOwnerScope owner { context, GLResourceStats::Owner::Offscreen };
             texture = context.createTexture(size);
-            framebuffer = context.createFramebuffer(*texture);
+            framebuffer = depthStencil ? context.createFramebuffer(*texture, *depthStencil)
+                                       : context.createFramebuffer(*texture);
         } else {
             context.bindFramebuffer = framebuffer->framebuffer;
         }
@@ -39,6 +44,7 @@ public:
 private:
     gl::Context& context;
     const Size size;
+    gl::Renderbuffer<gl::RenderbufferType::DepthStencil>* depthStencil;
     optional<gl::Framebuffer> framebuffer;
     optional<gl::Texture> texture;
 };
@@ -48,6 +54,13 @@ OffscreenTexture::OffscreenTexture(gl::Context& context, const Size size)
     assert(size);
 }
 
+OffscreenTexture::OffscreenTexture(gl::Context& context,
+                                   const Size size,
+                                   gl::Renderbuffer<gl::RenderbufferType::DepthStencil>& depthStencil)
+    : impl(std::make_unique<Impl>(context, std::move(size), &depthStencil)) {
+    assert(size);
+}
+
 OffscreenTexture::~OffscreenTexture() = default;
 
 void OffscreenTexture::bind() {
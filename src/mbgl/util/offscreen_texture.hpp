@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/map/view.hpp>
+#include <mbgl/gl/renderbuffer.hpp>
 #include <mbgl/util/image.hpp>
 
 namespace mbgl {
@@ -13,6 +14,10 @@ class Texture;
 class OffscreenTexture : public View {
 public:
     OffscreenTexture(gl::Context&, Size size = { 256, 256 });
+
+    // Renders with the given depth and stencil buffer, which must be of the same size, and
+    // may be shared by textures that are rendered into one after the other.
+    OffscreenTexture(gl::Context&, Size size, gl::Renderbuffer<gl::RenderbufferType::DepthStencil>&);
     ~OffscreenTexture();
 
     void bind() override;
@@ -2,9 +2,19 @@
 
 #include <cmath>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace mbgl {
 namespace util {
 
+// The vector kernels compute the same results as the scalar loops, which finish each image.
+// Dividing by 255 is (x + 1 + (x >> 8)) >> 8, exact for x < 65535, and dividing by the
+// alpha is done in single precision, exact for these operands.
+
 PremultipliedImage premultiply(UnassociatedImage&& src) {
     PremultipliedImage dst;
 
@@ -12,7 +22,47 @@ PremultipliedImage premultiply(UnassociatedImage&& src) {
     dst.data = std::move(src.data);
 
     uint8_t* data = dst.data.get();
-    for (size_t i = 0; i < dst.bytes(); i += 4) {
+    const size_t bytes = dst.bytes();
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i half = _mm_set1_epi16(127);
+    // Alpha is multiplied by 255 to stay as it is.
+    const __m128i colors = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    const __m128i opaque = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+
+    auto premultiplyPixels = [&] (__m128i pixels) {
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        alpha = _mm_or_si128(_mm_and_si128(alpha, colors), opaque);
+        const __m128i x = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), half);
+        return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8)), 8);
+    };
+
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i* pixels = reinterpret_cast<__m128i*>(data + i);
+        const __m128i rgba = _mm_loadu_si128(pixels);
+        _mm_storeu_si128(pixels, _mm_packus_epi16(premultiplyPixels(_mm_unpacklo_epi8(rgba, zero)),
+                                                  premultiplyPixels(_mm_unpackhi_epi8(rgba, zero))));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    auto premultiplyChannel = [] (uint8x8_t color, uint8x8_t alpha) {
+        const uint16x8_t x = vaddq_u16(vmull_u8(color, alpha), vdupq_n_u16(127));
+        return vshrn_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+    };
+
+    for (; i + 64 <= bytes; i += 64) {
+        uint8x16x4_t rgba = vld4q_u8(data + i);
+        for (int c = 0; c < 3; ++c) {
+            rgba.val[c] = vcombine_u8(premultiplyChannel(vget_low_u8(rgba.val[c]), vget_low_u8(rgba.val[3])),
+                                      premultiplyChannel(vget_high_u8(rgba.val[c]), vget_high_u8(rgba.val[3])));
+        }
+        vst4q_u8(data + i, rgba);
+    }
+#endif
+
+    for (; i < bytes; i += 4) {
         uint8_t& r = data[i + 0];
         uint8_t& g = data[i + 1];
         uint8_t& b = data[i + 2];
@@ -32,7 +82,72 @@ UnassociatedImage unpremultiply(PremultipliedImage&& src) {
     dst.data = std::move(src.data);
 
     uint8_t* data = dst.data.get();
-    for (size_t i = 0; i < dst.bytes(); i += 4) {
+    const size_t bytes = dst.bytes();
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i byte = _mm_set1_epi32(0xFF);
+    const __m128i alphas = _mm_set1_epi32(int32_t(0xFF000000));
+
+    // Four channels of a pixel, widened to 32 bits. Transparent pixels, and alpha, are kept
+    // as they are, dividing by one. Results wrap around like the scalar stores do.
+    auto unpremultiplyPixel = [&] (__m128i pixel) {
+        const __m128i alpha = _mm_shuffle_epi32(pixel, _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128i keep = _mm_or_si128(_mm_cmpeq_epi32(alpha, zero), _mm_set_epi32(-1, 0, 0, 0));
+        const __m128i scaled = _mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(pixel, 8), pixel), _mm_srli_epi32(alpha, 1));
+        const __m128 quotient = _mm_div_ps(_mm_cvtepi32_ps(_mm_or_si128(_mm_and_si128(keep, pixel), _mm_andnot_si128(keep, scaled))),
+                                           _mm_cvtepi32_ps(_mm_or_si128(_mm_and_si128(keep, one), _mm_andnot_si128(keep, alpha))));
+        return _mm_and_si128(_mm_cvttps_epi32(quotient), byte);
+    };
+
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i* pixels = reinterpret_cast<__m128i*>(data + i);
+        const __m128i rgba = _mm_loadu_si128(pixels);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(rgba, alphas), alphas)) == 0xFFFF) {
+            // Opaque pixels are the same either way.
+            continue;
+        }
+
+        const __m128i lo = _mm_unpacklo_epi8(rgba, zero);
+        const __m128i hi = _mm_unpackhi_epi8(rgba, zero);
+        _mm_storeu_si128(pixels, _mm_packus_epi16(
+            _mm_packs_epi32(unpremultiplyPixel(_mm_unpacklo_epi16(lo, zero)), unpremultiplyPixel(_mm_unpackhi_epi16(lo, zero))),
+            _mm_packs_epi32(unpremultiplyPixel(_mm_unpacklo_epi16(hi, zero)), unpremultiplyPixel(_mm_unpackhi_epi16(hi, zero)))));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    auto unpremultiplyChannel = [] (uint16x8_t color, uint16x8_t alpha) {
+        auto divide = [] (uint16x4_t c, uint16x4_t a) {
+            const uint32x4_t scaled = vaddq_u32(vmull_n_u16(c, 255), vmovl_u16(vshr_n_u16(a, 1)));
+            const float32x4_t quotient = vdivq_f32(vcvtq_f32_u32(scaled), vcvtq_f32_u32(vmovl_u16(a)));
+            return vmovn_u32(vcvtq_u32_f32(quotient));
+        };
+        return vmovn_u16(vcombine_u16(divide(vget_low_u16(color), vget_low_u16(alpha)),
+                                      divide(vget_high_u16(color), vget_high_u16(alpha))));
+    };
+
+    for (; i + 64 <= bytes; i += 64) {
+        uint8x16x4_t rgba = vld4q_u8(data + i);
+        if (vminvq_u8(rgba.val[3]) == 255) {
+            // Opaque pixels are the same either way.
+            continue;
+        }
+
+        // Transparent pixels are kept as they are.
+        const uint8x16_t transparent = vceqq_u8(rgba.val[3], vdupq_n_u8(0));
+        const uint8x16_t alpha = vmaxq_u8(rgba.val[3], vdupq_n_u8(1));
+        for (int c = 0; c < 3; ++c) {
+            const uint8x16_t color = vcombine_u8(
+                unpremultiplyChannel(vmovl_u8(vget_low_u8(rgba.val[c])), vmovl_u8(vget_low_u8(alpha))),
+                unpremultiplyChannel(vmovl_u8(vget_high_u8(rgba.val[c])), vmovl_u8(vget_high_u8(alpha))));
+            rgba.val[c] = vbslq_u8(transparent, rgba.val[c], color);
+        }
+        vst4q_u8(data + i, rgba);
+    }
+#endif
+
+    for (; i < bytes; i += 4) {
         uint8_t& r = data[i + 0];
         uint8_t& g = data[i + 1];
         uint8_t& b = data[i + 2];
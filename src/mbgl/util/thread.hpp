@@ -7,6 +7,7 @@
 #include <utility>
 #include <functional>
 
+#include <mbgl/util/async.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/thread_context.hpp>
 #include <mbgl/util/platform.hpp>
@@ -46,6 +47,21 @@ public:
         return loop->invokeWithCallback(bind(fn), std::forward<Args>(args)...);
     }
 
+    // Invoke object->fn(args...) asynchronously. The returned Async resolves with the result,
+    // and continuations attached to it run on the RunLoop of the thread that attaches them.
+    template <typename Fn, class... Args>
+    auto invokeAsync(Fn fn, Args&&... args) {
+        using R = decltype((std::declval<Object&>().*fn)(std::forward<Args>(args)...));
+
+        auto state = std::make_shared<detail::AsyncState<R>>();
+        loop->invoke([state, fn, this] (auto&&... params) {
+            detail::AsyncSettle<R>::run(*state, [&] {
+                return (object->*fn)(std::forward<decltype(params)>(params)...);
+            });
+        }, std::forward<Args>(args)...);
+        return Async<R>(std::move(state));
+    }
+
     // Invoke object->fn(args...) asynchronously, but wait for the result.
     template <typename Fn, class... Args>
     auto invokeSync(Fn fn, Args&&... args) {
@@ -1,9 +1,15 @@
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/interpolate.hpp>
+#include <mbgl/util/mat4.hpp>
+#include <mbgl/util/projection.hpp>
 #include <mbgl/map/transform_state.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
+#include <limits>
+#include <unordered_set>
 
 namespace mbgl {
 
@@ -135,24 +141,116 @@ int32_t coveringZoomLevel(double zoom, SourceType type, uint16_t size) {
     }
 }
 
-std::vector<UnwrappedTileID> tileCover(const LatLngBounds& bounds_, int32_t z) {
+namespace {
+
+// Columns [x0, x1) and rows [y0, y1) of tiles.
+struct TileRange {
+    int32_t x0, x1, y0, y1;
+};
+
+TileRange tileRange(const LatLngBounds& bounds_, int32_t z) {
     if (bounds_.isEmpty() ||
         bounds_.south() >  util::LATITUDE_MAX ||
         bounds_.north() < -util::LATITUDE_MAX) {
-        return {};
+        return { 0, 0, 0, 0 };
     }
 
     LatLngBounds bounds = LatLngBounds::hull(
         { std::max(bounds_.south(), -util::LATITUDE_MAX), bounds_.west() },
         { std::min(bounds_.north(),  util::LATITUDE_MAX), bounds_.east() });
 
-    return tileCover(
-        TileCoordinate::fromLatLng(z, bounds.northwest()).p,
-        TileCoordinate::fromLatLng(z, bounds.northeast()).p,
-        TileCoordinate::fromLatLng(z, bounds.southeast()).p,
-        TileCoordinate::fromLatLng(z, bounds.southwest()).p,
-        TileCoordinate::fromLatLng(z, bounds.center()).p,
-        z);
+    // Bounds are a rectangle in tile coordinates, so rather than scanning them as a polygon,
+    // the tiles are those between its edges. Columns aren't wrapped.
+    const Point<double> nw = TileCoordinate::fromLatLng(z, bounds.northwest()).p;
+    const Point<double> se = TileCoordinate::fromLatLng(z, bounds.southeast()).p;
+    if (nw.y == se.y) {
+        return { 0, 0, 0, 0 };
+    }
+
+    TileRange result {
+        int32_t(std::floor(nw.x)),
+        int32_t(std::ceil(se.x)),
+        int32_t(std::max(0.0, std::floor(nw.y))),
+        int32_t(std::min(double(1 << z), std::ceil(se.y)))
+    };
+    if (result.x0 >= result.x1 || result.y0 >= result.y1) {
+        return { 0, 0, 0, 0 };
+    }
+    return result;
+}
+
+} // namespace
+
+TileCover::TileCover(const LatLngBounds& bounds_, int32_t minZoom, int32_t maxZoom_)
+    : bounds(bounds_),
+      z(minZoom),
+      maxZoom(maxZoom_) {
+    if (z <= maxZoom) {
+        startZoom();
+    }
+}
+
+void TileCover::startZoom() {
+    const TileRange tiles = tileRange(bounds, z);
+    x0 = tiles.x0;
+    x1 = tiles.x1;
+    y0 = tiles.y0;
+    y1 = tiles.y1;
+    x = x0;
+    y = y0;
+}
+
+optional<UnwrappedTileID> TileCover::next() {
+    while (z <= maxZoom) {
+        if (y < y1) {
+            UnwrappedTileID id { uint8_t(z), x, y };
+            if (++x == x1) {
+                x = x0;
+                y++;
+            }
+            return id;
+        }
+        if (++z <= maxZoom) {
+            startZoom();
+        }
+    }
+    return {};
+}
+
+std::vector<UnwrappedTileID> tileCover(const LatLngBounds& bounds, int32_t z) {
+    const TileRange tiles = tileRange(bounds, z);
+    const Point<double> c = TileCoordinate::fromLatLng(z, bounds.center()).p;
+
+    struct ID {
+        int32_t x, y;
+        double sqDist;
+    };
+
+    std::vector<ID> t;
+    t.reserve(tileCount(bounds, z));
+    for (int32_t y = tiles.y0; y < tiles.y1; ++y) {
+        for (int32_t x = tiles.x0; x < tiles.x1; ++x) {
+            const auto dx = x + 0.5 - c.x, dy = y + 0.5 - c.y;
+            t.emplace_back(ID{ x, y, dx * dx + dy * dy });
+        }
+    }
+
+    // Sort first by distance, then by x/y.
+    std::sort(t.begin(), t.end(), [](const ID& a, const ID& b) {
+        return std::tie(a.sqDist, a.x, a.y) < std::tie(b.sqDist, b.x, b.y);
+    });
+
+    std::vector<UnwrappedTileID> result;
+    result.reserve(t.size());
+    for (const auto& id : t) {
+        result.emplace_back(z, id.x, id.y);
+    }
+    return result;
+}
+
+uint64_t tileCount(const LatLngBounds& bounds, int32_t z) {
+    const TileRange tiles = tileRange(bounds, z);
+    return uint64_t(tiles.x1 - tiles.x0) * uint64_t(tiles.y1 - tiles.y0);
 }
 
 std::vector<UnwrappedTileID> tileCover(const TransformState& state, int32_t z) {
@@ -167,5 +265,79 @@ std::vector<UnwrappedTileID> tileCover(const TransformState& state, int32_t z) {
         z);
 }
 
+std::vector<UnwrappedTileID> tileCover(const TransformState& state, int32_t z, int32_t minZoom, double maxError) {
+    std::vector<UnwrappedTileID> cover = tileCover(state, z);
+    if (state.getPitch() == 0 || maxError < 1 || minZoom >= z) {
+        return cover;
+    }
+
+    // Tiles are drawn at a size inversely proportional to their depth, the w of the clip
+    // coordinates, which is linear on the ground: a tile is nearest at one of its corners.
+    mat4 projMatrix;
+    state.getProjMatrix(projMatrix);
+    const double worldSize = Projection::worldSize(state.getScale());
+    const double centerDepth = state.getCameraToCenterDistance();
+
+    auto isDetailedEnough = [&] (const UnwrappedTileID& id) {
+        const double size = worldSize / (1ull << id.canonical.z);
+        const double x0 = (id.canonical.x + double(id.wrap) * (1ull << id.canonical.z)) * size;
+        const double y0 = id.canonical.y * size;
+        double nearest = std::numeric_limits<double>::infinity();
+        for (const double x : { x0, x0 + size }) {
+            for (const double y : { y0, y0 + size }) {
+                nearest = std::min(nearest, projMatrix[3] * x + projMatrix[7] * y + projMatrix[15]);
+            }
+        }
+        return nearest > 0 && std::pow(2.0, z - id.canonical.z) * centerDepth / nearest <= maxError;
+    };
+
+    // The tiles at `z`, and each of their parents down to `minZoom`. From those at
+    // `minZoom`, the first tile on the way to `z` that is detailed enough is used in place of
+    // its descendants.
+    std::unordered_set<UnwrappedTileID> covered;
+    std::vector<UnwrappedTileID> stack;
+    for (const auto& id : cover) {
+        for (int32_t parentZ = z; parentZ >= minZoom; --parentZ) {
+            const UnwrappedTileID parent { id.wrap, id.canonical.scaledTo(parentZ) };
+            if (!covered.insert(parent).second) {
+                break;
+            }
+            if (parentZ == minZoom) {
+                stack.push_back(parent);
+            }
+        }
+    }
+
+    std::vector<UnwrappedTileID> result;
+    while (!stack.empty()) {
+        const UnwrappedTileID id = stack.back();
+        stack.pop_back();
+        if (id.canonical.z == z || isDetailedEnough(id)) {
+            result.push_back(id);
+        } else {
+            for (const auto& child : id.children()) {
+                if (covered.count(child)) {
+                    stack.push_back(child);
+                }
+            }
+        }
+    }
+
+    // Sort by the distance of their centers to the center of the screen, as the cover at `z` is.
+    const Point<double> c = TileCoordinate::fromScreenCoordinate(
+        state, z, { state.getSize().width / 2.0, state.getSize().height / 2.0 }).p;
+    auto sqDist = [&] (const UnwrappedTileID& id) {
+        const double scale = std::pow(2.0, z - id.canonical.z);
+        const double dx = (id.canonical.x + double(id.wrap) * (1ull << id.canonical.z) + 0.5) * scale - c.x;
+        const double dy = (id.canonical.y + 0.5) * scale - c.y;
+        return dx * dx + dy * dy;
+    };
+    std::sort(result.begin(), result.end(), [&] (const UnwrappedTileID& a, const UnwrappedTileID& b) {
+        const double da = sqDist(a), db = sqDist(b);
+        return da < db || (da == db && a < b);
+    });
+    return result;
+}
+
 } // namespace util
 } // namespace mbgl
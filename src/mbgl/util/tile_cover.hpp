@@ -2,6 +2,8 @@
 
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/style/types.hpp>
+#include <mbgl/util/geo.hpp>
+#include <mbgl/util/optional.hpp>
 #include <mbgl/util/tile_coordinate.hpp>
 
 #include <vector>
@@ -9,14 +11,44 @@
 namespace mbgl {
 
 class TransformState;
-class LatLngBounds;
 
 namespace util {
 
 int32_t coveringZoomLevel(double z, SourceType type, uint16_t tileSize);
 
 std::vector<UnwrappedTileID> tileCover(const TransformState&, int32_t z);
+
+// Like the cover at `z`, but in a pitched view, tiles far from the camera are of lower zoom
+// levels, down to `minZoom`: a tile is used as long as, at its nearest point, it isn't drawn
+// more than `maxError` times as large as tiles at `z` are at the center of the screen. The
+// tiles don't overlap, and come closest to the center first. A `maxError` below one, or a
+// flat view, gives the cover at `z`.
+std::vector<UnwrappedTileID> tileCover(const TransformState&, int32_t z, int32_t minZoom, double maxError);
 std::vector<UnwrappedTileID> tileCover(const LatLngBounds&, int32_t z);
 
+// The number of tiles that tileCover returns for the bounds, without enumerating them.
+uint64_t tileCount(const LatLngBounds&, int32_t z);
+
+// Goes through the tiles covering the bounds at each zoom level of a range, one at a time and
+// row by row, without keeping them: regions can hold millions of tiles at high zoom levels.
+class TileCover {
+public:
+    TileCover(const LatLngBounds&, int32_t minZoom, int32_t maxZoom);
+
+    // Returns nothing once all tiles are done.
+    optional<UnwrappedTileID> next();
+
+private:
+    void startZoom();
+
+    const LatLngBounds bounds;
+    int32_t z;
+    const int32_t maxZoom;
+
+    // Columns [x0, x1) and rows [y0, y1) of the current zoom level.
+    int32_t x0 = 0, x1 = 0, y0 = 0, y1 = 0;
+    int32_t x = 0, y = 0;
+};
+
 } // namespace util
 } // namespace mbgl
@@ -0,0 +1,101 @@
+#include <mbgl/util/tiny_sdf.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+constexpr double INF = 1e20;
+
+// The squared distances along one row or column, in place, from the lower envelope of the
+// parabolas rooted at each pixel.
+void edt1d(std::vector<double>& grid, std::size_t offset, std::size_t stride, std::size_t length,
+           std::vector<double>& f, std::vector<std::size_t>& v, std::vector<double>& z) {
+    v[0] = 0;
+    z[0] = -INF;
+    z[1] = INF;
+    f[0] = grid[offset];
+
+    for (std::size_t q = 1, k = 0; q < length; q++) {
+        f[q] = grid[offset + q * stride];
+        const double q2 = double(q) * q;
+        double s;
+        // Drops the parabolas this one hides, stopping at the first, since z[0] is -INF.
+        while (true) {
+            const std::size_t r = v[k];
+            s = (f[q] - f[r] + q2 - double(r) * r) / (double(q) - r) / 2;
+            if (s > z[k]) {
+                break;
+            }
+            k--;
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = INF;
+    }
+
+    for (std::size_t q = 0, k = 0; q < length; q++) {
+        while (z[k + 1] < q) {
+            k++;
+        }
+        const std::size_t r = v[k];
+        const double d = double(q) - r;
+        grid[offset + q * stride] = f[r] + d * d;
+    }
+}
+
+void edt(std::vector<double>& grid, std::size_t width, std::size_t height,
+         std::vector<double>& f, std::vector<std::size_t>& v, std::vector<double>& z) {
+    for (std::size_t x = 0; x < width; x++) {
+        edt1d(grid, x, width, height, f, v, z);
+    }
+    for (std::size_t y = 0; y < height; y++) {
+        edt1d(grid, y * width, 1, width, f, v, z);
+    }
+}
+
+} // namespace
+
+AlphaImage transformRasterToSDF(const AlphaImage& raster, double radius, double cutoff) {
+    const std::size_t width = raster.size.width;
+    const std::size_t height = raster.size.height;
+    const std::size_t area = width * height;
+    const std::size_t maxDimension = std::max(width, height);
+
+    AlphaImage sdf(raster.size);
+    if (!area) {
+        return sdf;
+    }
+
+    std::vector<double> gridOuter(area);
+    std::vector<double> gridInner(area);
+    std::vector<double> f(maxDimension);
+    std::vector<std::size_t> v(maxDimension);
+    std::vector<double> z(maxDimension + 1);
+
+    // Partly covered pixels are taken to have their edge at half their coverage.
+    for (std::size_t i = 0; i < area; i++) {
+        const double a = raster.data[i] / 255.0;
+        gridOuter[i] = a == 1 ? 0 : a == 0 ? INF : std::pow(std::max(0.0, 0.5 - a), 2);
+        gridInner[i] = a == 1 ? INF : a == 0 ? 0 : std::pow(std::max(0.0, a - 0.5), 2);
+    }
+
+    edt(gridOuter, width, height, f, v, z);
+    edt(gridInner, width, height, f, v, z);
+
+    for (std::size_t i = 0; i < area; i++) {
+        const double distance = std::sqrt(gridOuter[i]) - std::sqrt(gridInner[i]);
+        const double value = std::round(255 - 255 * (distance / radius + cutoff));
+        sdf.data[i] = static_cast<uint8_t>(std::max(0.0, std::min(255.0, value)));
+    }
+
+    return sdf;
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <mbgl/util/image.hpp>
+
+namespace mbgl {
+namespace util {
+
+// The signed distance field of a coverage image, in the encoding of glyph PBFs: the edge is
+// at 255 * (1 - cutoff), and each unit of distance, in pixels, is 255 / radius (see TinySDF).
+// Distances are exact, from the Euclidean distance transform of Felzenszwalb and Huttenlocher.
+AlphaImage transformRasterToSDF(const AlphaImage& raster, double radius, double cutoff);
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,260 @@
+#include <mbgl/util/trace.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/platform.hpp>
+#include <mbgl/util/thread_local.hpp>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+namespace trace {
+
+#if MBGL_TRACING
+
+namespace {
+
+struct Event {
+    char phase;
+    const char* category;
+    std::string name;
+    double timestamp;
+    double duration;
+    uint64_t id;
+};
+
+// Only locked by its own thread, except when the events are collected.
+struct ThreadBuffer {
+    uint64_t tid = 0;
+    std::string threadName;
+    std::mutex mutex;
+    std::vector<Event> events;
+};
+
+std::atomic<bool> recording { false };
+std::atomic<uint64_t> ids { 0 };
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    uint64_t nextTID = 1;
+};
+
+// Intentionally leaked, so that threads can still record during static destruction.
+Registry& registry = *new Registry;
+
+struct BufferHandle {
+    std::shared_ptr<ThreadBuffer> buffer;
+};
+
+util::ThreadLocal<BufferHandle>& currentBuffer = *new util::ThreadLocal<BufferHandle>;
+
+ThreadBuffer& threadBuffer() {
+    BufferHandle* handle = currentBuffer.get();
+    if (!handle) {
+        // Deleted by ThreadLocal when the thread exits; the registry keeps the buffer.
+        handle = new BufferHandle { std::make_shared<ThreadBuffer>() };
+        handle->buffer->threadName = platform::getCurrentThreadName();
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            handle->buffer->tid = registry.nextTID++;
+            registry.buffers.push_back(handle->buffer);
+        }
+        currentBuffer.set(handle);
+    }
+    return *handle->buffer;
+}
+
+// In microseconds, as the format expects.
+double now() {
+    return std::chrono::duration<double, std::micro>(Clock::now().time_since_epoch()).count();
+}
+
+void record(char phase, const char* category, std::string name, double timestamp, double duration, uint64_t id) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events.push_back({ phase, category, std::move(name), timestamp, duration, id });
+}
+
+} // namespace
+
+bool available() {
+    return true;
+}
+
+void start() {
+    recording = true;
+}
+
+void stop() {
+    recording = false;
+}
+
+bool isRecording() {
+    return recording.load(std::memory_order_relaxed);
+}
+
+std::string flush() {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        buffers = registry.buffers;
+    }
+
+    rapidjson::StringBuffer output;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(output);
+    writer.StartObject();
+    writer.Key("displayTimeUnit");
+    writer.String("ms");
+    writer.Key("traceEvents");
+    writer.StartArray();
+
+    for (const auto& buffer : buffers) {
+        std::vector<Event> events;
+        {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            events.swap(buffer->events);
+        }
+
+        writer.StartObject();
+        writer.Key("ph");
+        writer.String("M");
+        writer.Key("name");
+        writer.String("thread_name");
+        writer.Key("pid");
+        writer.Uint(1);
+        writer.Key("tid");
+        writer.Uint64(buffer->tid);
+        writer.Key("args");
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(buffer->threadName);
+        writer.EndObject();
+        writer.EndObject();
+
+        for (const auto& event : events) {
+            writer.StartObject();
+            writer.Key("ph");
+            writer.String(&event.phase, 1);
+            writer.Key("cat");
+            writer.String(event.category);
+            writer.Key("name");
+            writer.String(event.name);
+            writer.Key("pid");
+            writer.Uint(1);
+            writer.Key("tid");
+            writer.Uint64(buffer->tid);
+            writer.Key("ts");
+            writer.Double(event.timestamp);
+            if (event.phase == 'X') {
+                writer.Key("dur");
+                writer.Double(event.duration);
+            } else {
+                writer.Key("id");
+                writer.Uint64(event.id);
+            }
+            if (event.phase == 'f') {
+                // Ends the arrow at the span enclosing the event rather than the next one.
+                writer.Key("bp");
+                writer.String("e");
+            }
+            writer.EndObject();
+        }
+    }
+
+    writer.EndArray();
+    writer.EndObject();
+    return output.GetString();
+}
+
+uint64_t nextID() {
+    return ++ids;
+}
+
+Scope::Scope(const char* category_, const char* name_)
+    : category(category_), staticName(name_) {
+    if (isRecording()) {
+        start = now();
+    }
+}
+
+Scope::Scope(const char* category_, std::string name_)
+    : category(category_) {
+    if (isRecording()) {
+        name = std::move(name_);
+        start = now();
+    }
+}
+
+Scope::~Scope() {
+    if (start >= 0) {
+        const double end = now();
+        record('X', category, staticName ? std::string(staticName) : std::move(name), start, end - start, 0);
+    }
+}
+
+void asyncBegin(const char* category, std::string name, uint64_t id) {
+    if (isRecording()) {
+        record('b', category, std::move(name), now(), 0, id);
+    }
+}
+
+void asyncEnd(const char* category, std::string name, uint64_t id) {
+    if (isRecording()) {
+        record('e', category, std::move(name), now(), 0, id);
+    }
+}
+
+void flowStart(const char* category, const char* name, uint64_t id) {
+    if (isRecording()) {
+        record('s', category, name, now(), 0, id);
+    }
+}
+
+void flowEnd(const char* category, const char* name, uint64_t id) {
+    if (isRecording()) {
+        record('f', category, name, now(), 0, id);
+    }
+}
+
+#else
+
+bool available() {
+    return false;
+}
+
+void start() {
+}
+
+void stop() {
+}
+
+bool isRecording() {
+    return false;
+}
+
+std::string flush() {
+    return R"({"displayTimeUnit":"ms","traceEvents":[]})";
+}
+
+#endif
+
+bool write(const std::string& path) {
+    try {
+        util::write_file(path, flush());
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+} // namespace trace
+} // namespace util
+} // namespace mbgl
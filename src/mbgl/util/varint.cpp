@@ -0,0 +1,127 @@
+#include <mbgl/util/varint.hpp>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace mbgl {
+namespace util {
+
+static inline bool decodeVarint(const char*& data, const char* end, uint32_t& value) {
+    uint64_t result = 0;
+    for (unsigned shift = 0; data != end && shift < 64; shift += 7) {
+        const uint8_t byte = static_cast<uint8_t>(*data++);
+        result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            value = static_cast<uint32_t>(result);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t decodeVarints(const char*& data, const char* end, uint32_t* out, std::size_t count) {
+    std::size_t n = 0;
+
+    while (n < count) {
+#if defined(__SSE2__)
+        if (count - n >= 16 && end - data >= 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+            const int continued = _mm_movemask_epi8(bytes);
+            if (continued == 0) {
+                // Sixteen single-byte varints: widen them to 32 bits.
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+                const __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + n), _mm_unpacklo_epi16(lo, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + n + 4), _mm_unpackhi_epi16(lo, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + n + 8), _mm_unpacklo_epi16(hi, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + n + 12), _mm_unpackhi_epi16(hi, zero));
+                data += 16;
+                n += 16;
+                continue;
+            }
+
+            // Copy the single-byte varints that precede the first multi-byte one.
+            const int single = __builtin_ctz(continued);
+            for (int i = 0; i < single; ++i) {
+                out[n++] = static_cast<uint8_t>(*data++);
+            }
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        if (count - n >= 16 && end - data >= 16) {
+            const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(data));
+            if (vmaxvq_u8(bytes) < 0x80) {
+                // Sixteen single-byte varints: widen them to 32 bits.
+                const uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+                const uint16x8_t hi = vmovl_u8(vget_high_u8(bytes));
+                vst1q_u32(out + n, vmovl_u16(vget_low_u16(lo)));
+                vst1q_u32(out + n + 4, vmovl_u16(vget_high_u16(lo)));
+                vst1q_u32(out + n + 8, vmovl_u16(vget_low_u16(hi)));
+                vst1q_u32(out + n + 12, vmovl_u16(vget_high_u16(hi)));
+                data += 16;
+                n += 16;
+                continue;
+            }
+        }
+#endif
+
+        if (n == count || !decodeVarint(data, end, out[n])) {
+            break;
+        }
+        ++n;
+    }
+
+    return n;
+}
+
+void accumulateDeltas(const uint32_t* in, std::size_t count, int32_t& x, int32_t& y, int32_t* out) {
+    std::size_t i = 0;
+
+#if defined(__SSE2__)
+    // Two (x, y) pairs per iteration: zigzag-decode, prefix-sum with a stride of two lanes,
+    // then add the position carried over from the previous iteration.
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i carry = _mm_set_epi32(y, x, y, x);
+    for (; i + 2 <= count; i += 2) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+        v = _mm_xor_si128(_mm_srli_epi32(v, 1), _mm_sub_epi32(zero, _mm_and_si128(v, one)));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi32(v, carry);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), v);
+        carry = _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    x = _mm_cvtsi128_si32(carry);
+    y = _mm_cvtsi128_si32(_mm_shuffle_epi32(carry, _MM_SHUFFLE(1, 1, 1, 1)));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const uint32x4_t one = vdupq_n_u32(1);
+    const uint32x4_t zero = vdupq_n_u32(0);
+    const int32_t start[4] = { x, y, x, y };
+    int32x4_t carry = vld1q_s32(start);
+    for (; i + 2 <= count; i += 2) {
+        const uint32x4_t u = vld1q_u32(in + 2 * i);
+        int32x4_t v = vreinterpretq_s32_u32(veorq_u32(vshrq_n_u32(u, 1), vsubq_u32(zero, vandq_u32(u, one))));
+        v = vaddq_s32(v, vextq_s32(vreinterpretq_s32_u32(zero), v, 2));
+        v = vaddq_s32(v, carry);
+        vst1q_s32(out + 2 * i, v);
+        carry = vcombine_s32(vget_high_s32(v), vget_high_s32(v));
+    }
+    x = vgetq_lane_s32(carry, 0);
+    y = vgetq_lane_s32(carry, 1);
+#endif
+
+    for (; i < count; ++i) {
+        const uint32_t dx = in[2 * i];
+        const uint32_t dy = in[2 * i + 1];
+        x += static_cast<int32_t>((dx >> 1) ^ (~(dx & 1) + 1));
+        y += static_cast<int32_t>((dy >> 1) ^ (~(dy & 1) + 1));
+        out[2 * i] = x;
+        out[2 * i + 1] = y;
+    }
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mbgl {
+namespace util {
+
+// Decodes up to `count` protobuf varints from [data, end) into `out`, truncating each to
+// 32 bits, and advances `data` past them. Returns the number of values decoded, which is
+// less than `count` only if the input ends or is malformed. Runs of single-byte varints
+// are decoded 16 at a time on SSE2 and AArch64 NEON.
+std::size_t decodeVarints(const char*& data, const char* end, uint32_t* out, std::size_t count);
+
+// Zigzag-decodes `count` interleaved (dx, dy) pairs from `in` and accumulates them onto
+// (x, y), writing the resulting absolute positions to `out` as interleaved (x, y) pairs.
+// This is the parameter encoding of MoveTo and LineTo commands in vector tile geometry.
+void accumulateDeltas(const uint32_t* in, std::size_t count, int32_t& x, int32_t& y, int32_t* out);
+
+} // namespace util
+} // namespace mbgl
@@ -19,17 +19,12 @@ WorkQueue::~WorkQueue() {
 }
 
 void WorkQueue::push(std::function<void()>&& fn) {
-    std::lock_guard<std::mutex> lock(queueMutex);
-
-    auto workRequest = runLoop->invokeCancellable(std::bind(&WorkQueue::pop, this, std::move(fn)));
-    queue.push(std::move(workRequest));
+    enqueue(std::move(fn));
 }
 
-void WorkQueue::pop(const std::function<void()>& fn) {
+void WorkQueue::pop() {
     assert(runLoop == RunLoop::Get());
 
-    fn();
-
     std::lock_guard<std::mutex> lock(queueMutex);
     queue.pop();
 }
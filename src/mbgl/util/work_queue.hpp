@@ -1,7 +1,9 @@
 #pragma once
 
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/async.hpp>
 #include <mbgl/util/async_request.hpp>
+#include <mbgl/util/run_loop.hpp>
 
 #include <functional>
 #include <memory>
@@ -11,8 +13,6 @@
 namespace mbgl {
 namespace util {
 
-class RunLoop;
-
 // The WorkQueue will manage a queue of closures
 // and it will make sure they get executed on the
 // thread that created the WorkQueue. All pending
@@ -27,8 +27,32 @@ public:
     // that owns the queue to avoid use after free errors.
     void push(std::function<void()>&&);
 
+    // Push a closure and return an Async for its result. Continuations attached to
+    // it run on the RunLoop of the thread that attaches them. The Async is never
+    // settled if the queue is destructed before the closure runs.
+    template <class Fn>
+    auto pushAsync(Fn&& fn) {
+        using R = std::result_of_t<std::decay_t<Fn>()>;
+
+        auto state = std::make_shared<detail::AsyncState<R>>();
+        enqueue([state, fn = std::forward<Fn>(fn)] () mutable {
+            detail::AsyncSettle<R>::run(*state, fn);
+        });
+        return Async<R>(std::move(state));
+    }
+
 private:
-    void pop(const std::function<void()>&);
+    template <class Fn>
+    void enqueue(Fn&& fn) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+
+        queue.push(runLoop->invokeCancellable([this, fn = std::forward<Fn>(fn)] () mutable {
+            fn();
+            pop();
+        }));
+    }
+
+    void pop();
 
     std::queue<std::unique_ptr<AsyncRequest>> queue;
     std::mutex queueMutex;
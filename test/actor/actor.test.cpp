@@ -1,5 +1,7 @@
 #include <mbgl/actor/actor.hpp>
+#include <mbgl/actor/scheduler_stats.hpp>
 #include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/platform.hpp>
 
 #include <mbgl/test/util.hpp>
 
@@ -137,3 +139,353 @@ TEST(Actor, NonConcurrentMailbox) {
     test.invoke(&Test::end);
     endedFuture.wait();
 }
+
+TEST(Actor, WorkStealingOrderedMailboxes) {
+    // Work stealing preserves per-mailbox ordering and non-concurrency.
+
+    struct Test {
+        int last = 0;
+        std::atomic<bool> receiving { false };
+        std::promise<void> promise;
+
+        Test(ActorRef<Test>, std::promise<void> promise_)
+            : promise(std::move(promise_))  {
+        }
+
+        void receive(int i) {
+            EXPECT_FALSE(receiving.exchange(true));
+            EXPECT_EQ(i, last + 1);
+            last = i;
+            receiving = false;
+        }
+
+        void end() {
+            promise.set_value();
+        }
+    };
+
+    ThreadPool pool { 4, ThreadPool::Strategy::WorkStealing };
+
+    std::vector<std::future<void>> endedFutures;
+    std::vector<std::unique_ptr<Actor<Test>>> actors;
+
+    for (auto n = 0; n < 8; ++n) {
+        std::promise<void> endedPromise;
+        endedFutures.push_back(endedPromise.get_future());
+        actors.push_back(std::make_unique<Actor<Test>>(pool, std::move(endedPromise)));
+    }
+
+    for (auto i = 1; i <= 100; ++i) {
+        for (auto& actor : actors) {
+            actor->invoke(&Test::receive, i);
+        }
+    }
+
+    for (auto& actor : actors) {
+        actor->invoke(&Test::end);
+    }
+
+    for (auto& future : endedFutures) {
+        future.wait();
+    }
+}
+
+TEST(Actor, MailboxPriority) {
+    // Higher-priority mailboxes are processed first.
+
+    struct Blocker {
+        Blocker(ActorRef<Blocker>) {}
+
+        void block(std::promise<void> entered, std::shared_future<void> release) {
+            entered.set_value();
+            release.wait();
+        }
+    };
+
+    struct Test {
+        std::vector<int>& order;
+        std::mutex& mutex;
+
+        Test(ActorRef<Test>, std::vector<int>& order_, std::mutex& mutex_)
+            : order(order_), mutex(mutex_) {
+        }
+
+        void receive(int i, std::promise<void> done) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(i);
+            }
+            done.set_value();
+        }
+    };
+
+    for (auto strategy : { ThreadPool::Strategy::SharedQueue, ThreadPool::Strategy::WorkStealing }) {
+        ThreadPool pool { 1, strategy };
+
+        std::vector<int> order;
+        std::mutex mutex;
+
+        Actor<Blocker> blocker(pool);
+        Actor<Test> low(pool, std::ref(order), std::ref(mutex));
+        Actor<Test> high(pool, std::ref(order), std::ref(mutex));
+        low.setPriority(Mailbox::Priority::Low);
+        high.setPriority(Mailbox::Priority::High);
+
+        std::promise<void> entered;
+        std::future<void> enteredFuture = entered.get_future();
+        std::promise<void> release;
+        blocker.invoke(&Blocker::block, std::move(entered), release.get_future().share());
+        enteredFuture.wait();
+
+        std::promise<void> lowDone;
+        std::future<void> lowFuture = lowDone.get_future();
+        std::promise<void> highDone;
+        std::future<void> highFuture = highDone.get_future();
+        low.invoke(&Test::receive, 1, std::move(lowDone));
+        high.invoke(&Test::receive, 2, std::move(highDone));
+
+        release.set_value();
+        lowFuture.wait();
+        highFuture.wait();
+
+        EXPECT_EQ((std::vector<int> { 2, 1 }), order);
+    }
+}
+
+TEST(Actor, DrainPolicy) {
+    // A mailbox with a drain policy processes several messages per turn.
+
+    struct Blocker {
+        Blocker(ActorRef<Blocker>) {}
+
+        void block(std::promise<void> entered, std::shared_future<void> release) {
+            entered.set_value();
+            release.wait();
+        }
+    };
+
+    struct Test {
+        std::vector<int>& order;
+
+        Test(ActorRef<Test>, std::vector<int>& order_)
+            : order(order_) {
+        }
+
+        void receive(int i) {
+            order.push_back(i);
+        }
+
+        void end(std::promise<void> done) {
+            done.set_value();
+        }
+    };
+
+    ThreadPool pool { 1 };
+
+    std::vector<int> order;
+
+    Actor<Blocker> blocker(pool);
+    Actor<Test> chatty(pool, std::ref(order));
+    Actor<Test> other(pool, std::ref(order));
+    chatty.setDrainPolicy({ 3, Duration::zero() });
+
+    std::promise<void> entered;
+    std::future<void> enteredFuture = entered.get_future();
+    std::promise<void> release;
+    blocker.invoke(&Blocker::block, std::move(entered), release.get_future().share());
+    enteredFuture.wait();
+
+    for (auto i = 1; i <= 4; ++i) {
+        chatty.invoke(&Test::receive, i);
+    }
+    other.invoke(&Test::receive, 10);
+
+    std::promise<void> chattyDone;
+    std::future<void> chattyFuture = chattyDone.get_future();
+    std::promise<void> otherDone;
+    std::future<void> otherFuture = otherDone.get_future();
+    chatty.invoke(&Test::end, std::move(chattyDone));
+    other.invoke(&Test::end, std::move(otherDone));
+
+    release.set_value();
+    chattyFuture.wait();
+    otherFuture.wait();
+
+    EXPECT_EQ((std::vector<int> { 1, 2, 3, 10, 4 }), order);
+}
+
+TEST(Actor, SchedulerStats) {
+    struct Test {
+        Test(ActorRef<Test>) {}
+
+        void receive() {
+        }
+
+        void end(std::promise<void> done) {
+            done.set_value();
+        }
+    };
+
+    ThreadPool pool { 1 };
+    pool.getStats()->setEnabled(true);
+
+    Actor<Test> test(pool);
+    for (auto i = 0; i < 10; ++i) {
+        test.invoke(&Test::receive);
+    }
+
+    std::promise<void> done;
+    std::future<void> future = done.get_future();
+    test.invoke(&Test::end, std::move(done));
+    future.wait();
+
+    const auto stats = pool.getStats()->snapshot();
+    EXPECT_GE(stats.maxQueueDepth, 1u);
+
+    uint64_t latencies = 0;
+    for (auto count : stats.latency) {
+        latencies += count;
+    }
+    EXPECT_EQ(11u, latencies);
+
+    ASSERT_EQ(1u, stats.actors.size());
+    EXPECT_EQ(std::string(typeid(Test).name()), stats.actors.begin()->first);
+    EXPECT_LE(10u, stats.actors.begin()->second.messages);
+}
+
+TEST(Actor, ThreadPoolOptions) {
+    struct Test {
+        Test(ActorRef<Test>) {}
+
+        void name(std::promise<std::string> promise) {
+            promise.set_value(platform::getCurrentThreadName());
+        }
+    };
+
+    ThreadPool::Options options;
+    options.namePrefix = "Layout ";
+    options.affinity = { 1 };
+    ThreadPool pool { 1, ThreadPool::Strategy::SharedQueue, options };
+
+    Actor<Test> test(pool);
+    std::promise<std::string> promise;
+    std::future<std::string> future = promise.get_future();
+    test.invoke(&Test::name, std::move(promise));
+
+    EXPECT_EQ("Layout 1", future.get());
+}
+
+TEST(Actor, ThreadPoolGroupFairShare) {
+    // Groups are served in deficit round-robin order according to their weight.
+
+    struct Blocker {
+        Blocker(ActorRef<Blocker>) {}
+
+        void block(std::promise<void> entered, std::shared_future<void> release) {
+            entered.set_value();
+            release.wait();
+        }
+    };
+
+    struct Test {
+        std::vector<int>& order;
+        std::mutex& mutex;
+
+        Test(ActorRef<Test>, std::vector<int>& order_, std::mutex& mutex_)
+            : order(order_), mutex(mutex_) {
+        }
+
+        void receive(int i, std::promise<void> done) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(i);
+            }
+            done.set_value();
+        }
+    };
+
+    ThreadPool pool { 1 };
+    ThreadPool::Group heavy(pool, { 2, 0 });
+    ThreadPool::Group light(pool);
+
+    std::vector<int> order;
+    std::mutex mutex;
+
+    Actor<Blocker> blocker(pool);
+    std::vector<std::unique_ptr<Actor<Test>>> actors;
+    for (auto i = 0; i < 4; ++i) {
+        actors.push_back(std::make_unique<Actor<Test>>(heavy, std::ref(order), std::ref(mutex)));
+    }
+    for (auto i = 0; i < 2; ++i) {
+        actors.push_back(std::make_unique<Actor<Test>>(light, std::ref(order), std::ref(mutex)));
+    }
+
+    std::promise<void> entered;
+    std::future<void> enteredFuture = entered.get_future();
+    std::promise<void> release;
+    blocker.invoke(&Blocker::block, std::move(entered), release.get_future().share());
+    enteredFuture.wait();
+
+    std::vector<std::future<void>> futures;
+    for (std::size_t i = 0; i < actors.size(); ++i) {
+        std::promise<void> done;
+        futures.push_back(done.get_future());
+        actors[i]->invoke(&Test::receive, int(i), std::move(done));
+    }
+
+    release.set_value();
+    for (auto& future : futures) {
+        future.wait();
+    }
+
+    EXPECT_EQ((std::vector<int> { 0, 1, 4, 2, 3, 5 }), order);
+
+    const auto usage = heavy.getUsage();
+    EXPECT_EQ(4u, usage.scheduled);
+    EXPECT_EQ(4u, usage.turns);
+    EXPECT_EQ(0u, usage.queued);
+    EXPECT_EQ(2u, light.getUsage().turns);
+}
+
+TEST(Actor, ThreadPoolGroupMaxThreads) {
+    // A group never occupies more threads than its quota allows.
+
+    struct Test {
+        std::atomic<int>& concurrent;
+        std::atomic<int>& peak;
+
+        Test(ActorRef<Test>, std::atomic<int>& concurrent_, std::atomic<int>& peak_)
+            : concurrent(concurrent_), peak(peak_) {
+        }
+
+        void receive(std::promise<void> done) {
+            const int now = ++concurrent;
+            int previous = peak;
+            while (now > previous && !peak.compare_exchange_weak(previous, now)) {}
+            std::this_thread::sleep_for(1ms);
+            --concurrent;
+            done.set_value();
+        }
+    };
+
+    ThreadPool pool { 4 };
+    ThreadPool::Group group(pool, { 1, 1 });
+
+    std::atomic<int> concurrent { 0 };
+    std::atomic<int> peak { 0 };
+
+    std::vector<std::unique_ptr<Actor<Test>>> actors;
+    std::vector<std::future<void>> futures;
+    for (auto i = 0; i < 8; ++i) {
+        actors.push_back(std::make_unique<Actor<Test>>(group, std::ref(concurrent), std::ref(peak)));
+        std::promise<void> done;
+        futures.push_back(done.get_future());
+        actors.back()->invoke(&Test::receive, std::move(done));
+    }
+
+    for (auto& future : futures) {
+        future.wait();
+    }
+
+    EXPECT_EQ(1, peak.load());
+}
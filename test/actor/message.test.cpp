@@ -0,0 +1,61 @@
+#include <mbgl/actor/message.hpp>
+
+#include <mbgl/test/util.hpp>
+
+#include <array>
+#include <string>
+
+using namespace mbgl;
+
+namespace {
+
+struct Receiver {
+    void receive(int i) {
+        sum += i;
+    }
+
+    void receiveLarge(std::array<char, 512>) {
+        ++large;
+    }
+
+    int sum = 0;
+    int large = 0;
+};
+
+} // namespace
+
+TEST(Message, Invoke) {
+    Receiver receiver;
+    auto message = actor::makeMessage(receiver, &Receiver::receive, 5);
+    (*message)();
+    EXPECT_EQ(5, receiver.sum);
+}
+
+TEST(Message, RecyclesBlocks) {
+    Receiver receiver;
+
+    // Warm up the pool so that subsequent allocations can be served from it.
+    actor::makeMessage(receiver, &Receiver::receive, 1).reset();
+
+    const auto before = actor::messageAllocationStats();
+    for (int i = 0; i < 100; ++i) {
+        auto message = actor::makeMessage(receiver, &Receiver::receive, i);
+        (*message)();
+    }
+    const auto after = actor::messageAllocationStats();
+
+    EXPECT_GE(after.allocations - before.allocations, 100u);
+    EXPECT_GE(after.reused - before.reused, 100u);
+}
+
+TEST(Message, OversizedFallsBackToHeap) {
+    Receiver receiver;
+
+    const auto before = actor::messageAllocationStats();
+    auto message = actor::makeMessage(receiver, &Receiver::receiveLarge, std::array<char, 512>());
+    (*message)();
+    const auto after = actor::messageAllocationStats();
+
+    EXPECT_EQ(1, receiver.large);
+    EXPECT_GE(after.oversized - before.oversized, 1u);
+}
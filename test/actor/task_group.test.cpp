@@ -0,0 +1,112 @@
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/actor/task_group.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+
+#include <mbgl/test/util.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(TaskGroup, RunsEveryTaskOnce) {
+    ThreadPool pool { 4 };
+    TaskGroup group(pool);
+    EXPECT_EQ(4u, group.lanes());
+
+    std::vector<std::atomic<int>> runs(100);
+    std::vector<std::atomic<bool>> busy(group.lanes());
+
+    group.run(runs.size(), [&] (std::size_t i, std::size_t lane) {
+        // A lane never runs two tasks at once.
+        EXPECT_FALSE(busy[lane].exchange(true));
+        ++runs[i];
+        std::this_thread::yield();
+        busy[lane] = false;
+    });
+
+    for (const auto& count : runs) {
+        EXPECT_EQ(1, count.load());
+    }
+}
+
+TEST(TaskGroup, UsesIdleThreads) {
+    ThreadPool pool { 4 };
+    TaskGroup group(pool);
+
+    // Each task waits until another lane has started one; this only completes if tasks run
+    // concurrently.
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::atomic<std::size_t> started { 0 };
+
+    group.run(2, [&] (std::size_t, std::size_t) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+        }
+        ++started;
+        while (started < 2) {
+            std::this_thread::yield();
+        }
+    });
+
+    EXPECT_EQ(2u, threads.size());
+}
+
+TEST(TaskGroup, CompletesOnBusyScheduler) {
+    // The caller occupies the pool's only thread, so it runs every task itself.
+
+    struct Test {
+        Test(ActorRef<Test>, Scheduler& scheduler_)
+            : group(scheduler_) {
+        }
+
+        void run(std::promise<std::size_t> promise) {
+            std::size_t count = 0;
+            group.run(10, [&] (std::size_t, std::size_t lane) {
+                EXPECT_EQ(0u, lane);
+                ++count;
+            });
+            promise.set_value(count);
+        }
+
+        TaskGroup group;
+    };
+
+    ThreadPool pool { 1 };
+    Actor<Test> test(pool, std::ref(pool));
+
+    std::promise<std::size_t> promise;
+    auto future = promise.get_future();
+    test.invoke(&Test::run, std::move(promise));
+    EXPECT_EQ(10u, future.get());
+}
+
+TEST(TaskGroup, RethrowsFirstError) {
+    ThreadPool pool { 4 };
+    TaskGroup group(pool);
+
+    std::atomic<std::size_t> runs { 0 };
+    EXPECT_THROW(group.run(1000, [&] (std::size_t i, std::size_t) {
+        ++runs;
+        if (i == 10) {
+            throw std::runtime_error("failed");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }), std::runtime_error);
+
+    // Tasks claimed after the failure are skipped.
+    EXPECT_LT(runs.load(), 1000u);
+
+    // The group can be reused.
+    runs = 0;
+    group.run(10, [&] (std::size_t, std::size_t) { ++runs; });
+    EXPECT_EQ(10u, runs.load());
+}
@@ -417,6 +417,36 @@ TEST(Annotations, VisibleFeatures) {
     EXPECT_EQ(features.size(), ids.size());
 }
 
+TEST(Annotations, AddRemoveMultiple) {
+    AnnotationTest test;
+
+    test.map.setStyleJSON(util::read_file("test/fixtures/api/empty.json"));
+    test.map.addAnnotationIcon("default_marker", namedMarker("default_marker.png"));
+
+    std::vector<Annotation> annotations;
+    for (int longitude = 0; longitude < 10; ++longitude) {
+        annotations.push_back(SymbolAnnotation { Point<double> { double(longitude), 0 }, "default_marker" });
+    }
+    annotations.push_back(LineAnnotation { LineString<double> {{ { 0, 0 }, { 45, 45 } }} });
+
+    const AnnotationIDs ids = test.map.addAnnotations(annotations);
+    ASSERT_EQ(11u, ids.size());
+
+    // Added one by one after a bulk load, and queried along with it.
+    const AnnotationID last = test.map.addAnnotation(SymbolAnnotation { Point<double> { 5.5, 0 }, "default_marker" });
+
+    const LatLngBounds bounds = LatLngBounds::hull({ -1, 4.5 }, { 1, 6.5 });
+    EXPECT_EQ(AnnotationIDs({ ids[5], ids[6], last }), test.map.queryPointAnnotations(bounds));
+
+    // Removing most of them bulk loads the rest.
+    test.map.removeAnnotations({ ids.begin(), ids.begin() + 6 });
+    test.map.removeAnnotations({ ids[10] });
+    EXPECT_EQ(AnnotationIDs({ ids[6], last }), test.map.queryPointAnnotations(bounds));
+
+    test.map.removeAnnotation(last);
+    EXPECT_EQ(AnnotationIDs({ ids[6] }), test.map.queryPointAnnotations(bounds));
+}
+
 
 TEST(Annotations, DebugEmpty) {
     // This test should render nothing, not even the tile borders. Tile borders are only rendered
@@ -46,6 +46,18 @@ TEST(Query, QueryRenderedFeatures) {
     EXPECT_EQ(features2.size(), 0u);
 }
 
+TEST(Query, QueryRenderedFeaturesWithoutIndexing) {
+    QueryTest test;
+
+    test.map.setFeatureIndexing(false);
+    test::render(test.map, test.view);
+    EXPECT_EQ(test.map.queryRenderedFeatures(test.map.pixelForLatLng({ 0, 0 })).size(), 0u);
+
+    test.map.setFeatureIndexing(true);
+    test::render(test.map, test.view);
+    EXPECT_EQ(test.map.queryRenderedFeatures(test.map.pixelForLatLng({ 0, 0 })).size(), 4u);
+}
+
 TEST(Query, QueryRenderedFeaturesFilterLayer) {
     QueryTest test;
 
@@ -81,3 +93,46 @@ TEST(Query, QueryRenderedFeaturesFilter) {
     auto features3 = test.map.queryRenderedFeatures(zz, {{ }, { gtFilter }});
     EXPECT_EQ(features3.size(), 1u);
 }
+
+TEST(Query, QueryRenderedFeatureIDs) {
+    QueryTest test;
+
+    auto zz = test.map.pixelForLatLng({ 0, 0 });
+
+    // The same features as a full query, in the style layer order.
+    auto features = test.map.queryRenderedFeatureIDs(zz);
+    ASSERT_EQ(features.size(), 4u);
+    EXPECT_EQ(features[0].layerID, "layer1");
+    EXPECT_FALSE(bool(features[0].featureID));
+    EXPECT_EQ(features[3].layerID, "layer4");
+    ASSERT_TRUE(bool(features[3].featureID));
+    EXPECT_EQ(*features[3].featureID, FeatureIdentifier(std::string("feature1")));
+
+    auto features2 = test.map.queryRenderedFeatureIDs(zz, {{{ "layer1", "layer2" }}, {}});
+    ASSERT_EQ(features2.size(), 2u);
+    EXPECT_EQ(features2[1].layerID, "layer2");
+}
+
+TEST(Query, QuerySourceFeatures) {
+    QueryTest test;
+
+    auto features1 = test.map.querySourceFeatures("source4");
+    ASSERT_EQ(features1.size(), 1u);
+    EXPECT_EQ(*features1[0].id, FeatureIdentifier(std::string("feature1")));
+
+    const EqualsFilter eqFilter = { "key1", std::string("value2") };
+    auto features2 = test.map.querySourceFeatures("source4", {{}, { eqFilter }, {}});
+    EXPECT_EQ(features2.size(), 0u);
+
+    auto features3 = test.map.querySourceFeatures("source4", {{}, {}, { LatLngBounds::hull({ 10, 10 }, { 20, 20 }) }});
+    EXPECT_EQ(features3.size(), 0u);
+
+    std::size_t chunks = 0;
+    test.map.querySourceFeatures("source1", {{}, {}, { LatLngBounds::hull({ -1, -1 }, { 1, 1 }) }}, [&] (std::vector<Feature> features) {
+        EXPECT_FALSE(features.empty());
+        chunks++;
+    });
+    EXPECT_GE(chunks, 1u);
+
+    EXPECT_EQ(test.map.querySourceFeatures("foobar").size(), 0u);
+}
@@ -0,0 +1,49 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/geometry/line_atlas.hpp>
+
+using namespace mbgl;
+
+TEST(LineAtlas, Grows) {
+    LineAtlas atlas({ 8, 2 });
+
+    const auto first = atlas.getDashPosition({ 1, 1 }, LinePatternCap::Square);
+    atlas.getDashPosition({ 2, 1 }, LinePatternCap::Square);
+    EXPECT_FLOAT_EQ(0.5f / 2, first.y);
+    EXPECT_EQ(Size(8, 2), atlas.getSize());
+
+    // The third pattern doesn't fit, so the atlas doubles in height.
+    const auto third = atlas.getDashPosition({ 3, 1 }, LinePatternCap::Square);
+    EXPECT_EQ(Size(8, 4), atlas.getSize());
+    EXPECT_FLOAT_EQ(2.5f / 4, third.y);
+
+    // Patterns keep their row, which is now relative to the new height.
+    EXPECT_FLOAT_EQ(0.5f / 4, atlas.getDashPosition({ 1, 1 }, LinePatternCap::Square).y);
+
+    // Round caps take 15 rows.
+    const auto round = atlas.getDashPosition({ 1, 1 }, LinePatternCap::Round);
+    EXPECT_EQ(Size(8, 32), atlas.getSize());
+    EXPECT_FLOAT_EQ((3 + 7 + 0.5f) / 32, round.y);
+    EXPECT_FLOAT_EQ(14.0f / 32, round.height);
+}
+
+TEST(LineAtlas, EvictsLeastRecentlyUsed) {
+    const uint32_t rows = LineAtlas::maxHeight;
+    LineAtlas atlas({ 8, rows });
+
+    for (uint32_t i = 1; i <= rows; ++i) {
+        atlas.getDashPosition({ 1, float(i) }, LinePatternCap::Square);
+    }
+
+    // Using the first pattern again leaves the second one as the least recently used,
+    // so the next new pattern takes its row.
+    const auto first = atlas.getDashPosition({ 1, 1 }, LinePatternCap::Square);
+    const auto added = atlas.getDashPosition({ 1, float(rows + 1) }, LinePatternCap::Square);
+    EXPECT_EQ(Size(8, rows), atlas.getSize());
+    EXPECT_FLOAT_EQ(1.5f / rows, added.y);
+    EXPECT_FLOAT_EQ(first.y, atlas.getDashPosition({ 1, 1 }, LinePatternCap::Square).y);
+
+    // The evicted pattern is drawn again when it's needed.
+    const auto second = atlas.getDashPosition({ 1, 2 }, LinePatternCap::Square);
+    EXPECT_FLOAT_EQ(2.5f / rows, second.y);
+}
@@ -1,31 +1,248 @@
 #include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
 
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/map/backend_scope.hpp>
 #include <mbgl/renderer/circle_bucket.hpp>
 #include <mbgl/renderer/fill_bucket.hpp>
+#include <mbgl/renderer/fill_extrusion_bucket.hpp>
 #include <mbgl/renderer/line_bucket.hpp>
 #include <mbgl/renderer/symbol_bucket.hpp>
 #include <mbgl/style/bucket_parameters.hpp>
+#include <mbgl/style/cascade_parameters.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/style/layers/line_layer_impl.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 
 #include <mbgl/map/mode.hpp>
 
+#include <atomic>
+
 using namespace mbgl;
 
+namespace {
+
+const std::atomic<bool> notObsolete { false };
+
+} // namespace
+
 TEST(Buckets, CircleBucket) {
-    CircleBucket bucket { { {0, 0, 0}, MapMode::Still }, {} };
+    CircleBucket bucket { { {0, 0, 0}, MapMode::Still, notObsolete }, {} };
     ASSERT_FALSE(bucket.hasData());
 }
 
+TEST(Buckets, CircleBucketInstances) {
+    CircleBucket bucket { { {0, 0, 0}, MapMode::Continuous, notObsolete }, {} };
+
+    StubGeometryTileFeature feature({});
+    GeometryBuffer geometry;
+    // The last point is outside the tile, and skipped outside of Still mode.
+    geometry.assign({ { {0, 0}, {10, 20}, {-1, 0} } });
+    bucket.addFeature(feature, geometry, 0);
+
+    // One entry per circle; the quads are only built if instancing is unsupported.
+    ASSERT_TRUE(bucket.hasData());
+    EXPECT_EQ(2u, bucket.instanceCount);
+    ASSERT_EQ(2u, bucket.instances.vertexSize());
+    EXPECT_EQ((std::array<int16_t, 2> {{ 20, 40 }}), bucket.instances.data()[1].a1);
+    EXPECT_EQ(0u, bucket.vertices.vertexSize());
+    EXPECT_TRUE(bucket.segments.empty());
+}
+
 TEST(Buckets, FillBucket) {
-    FillBucket bucket { { {0, 0, 0}, MapMode::Still }, {} };
+    FillBucket bucket { { {0, 0, 0}, MapMode::Still, notObsolete }, {} };
+    ASSERT_FALSE(bucket.hasData());
+}
+
+TEST(Buckets, FillBucketTriangulation) {
+    FillTriangulationCache cache;
+    style::BucketParameters parameters { {0, 0, 0}, MapMode::Still, notObsolete, &cache };
+
+    StubGeometryTileFeature feature({});
+    GeometryBuffer geometry;
+    geometry.assign({
+        // A square, triangulated as a fan.
+        { {0, 0}, {10, 0}, {10, 10}, {0, 10}, {0, 0} },
+        // A concave polygon, triangulated by earcut.
+        { {20, 0}, {30, 0}, {30, 5}, {25, 5}, {25, 10}, {20, 10}, {20, 0} },
+    });
+
+    FillBucket bucket { parameters, {} };
+    bucket.addFeature(feature, geometry, 3);
+    EXPECT_EQ((2u + 4u) * 3u, bucket.triangles.indexSize());
+
+    const FillTriangulationCache::Triangulation* cached = cache.find("", 3);
+    ASSERT_NE(nullptr, cached);
+    ASSERT_EQ(2u, cached->size());
+    EXPECT_EQ((std::vector<uint32_t> { 0, 1, 2, 0, 2, 3 }), cached->at(0));
+    EXPECT_EQ(4u * 3u, cached->at(1).size());
+
+    // Another bucket for the same feature reuses the triangulation.
+    FillBucket relaidOut { parameters, {} };
+    relaidOut.addFeature(feature, geometry, 3);
+    EXPECT_EQ(bucket.triangles.indexSize(), relaidOut.triangles.indexSize());
+    EXPECT_EQ(cached, cache.find("", 3));
+    EXPECT_EQ(nullptr, cache.find("", 4));
+}
+
+TEST(Buckets, FillBucketCoversExtent) {
+    auto covers = [] (GeometryCoordinates ring) {
+        FillBucket bucket { { {0, 0, 0}, MapMode::Still, notObsolete }, {} };
+        StubGeometryTileFeature feature({});
+        GeometryBuffer geometry;
+        geometry.assign({ ring });
+        bucket.addFeature(feature, geometry, 0);
+        return bucket.coversExtent;
+    };
+
+    // A rectangle reaching into the tile's buffer, with an extra vertex on one side.
+    EXPECT_TRUE(covers({ {-128, -128}, {4096, -128}, {8320, -128}, {8320, 8320}, {-128, 8320}, {-128, -128} }));
+    EXPECT_TRUE(covers({ {0, 0}, {8192, 0}, {8192, 8192}, {0, 8192}, {0, 0} }));
+
+    // Short of the extent.
+    EXPECT_FALSE(covers({ {0, 0}, {8191, 0}, {8191, 8192}, {0, 8192}, {0, 0} }));
+
+    // A corner is cut off.
+    EXPECT_FALSE(covers({ {-128, -128}, {8320, -128}, {8320, 8000}, {8000, 8320}, {-128, 8320}, {-128, -128} }));
+}
+
+TEST(Buckets, FillExtrusionBucket) {
+    FillExtrusionBucket bucket { { {0, 0, 0}, MapMode::Still, notObsolete }, {} };
     ASSERT_FALSE(bucket.hasData());
 }
 
+TEST(Buckets, FillExtrusionBucketGeometry) {
+    FillExtrusionBucket bucket { { {0, 0, 0}, MapMode::Still, notObsolete }, {} };
+    StubGeometryTileFeature feature({});
+    GeometryBuffer geometry;
+    geometry.assign({ { {0, 0}, {10, 0}, {10, 10}, {0, 10}, {0, 0} } });
+    bucket.addFeature(feature, geometry, 0);
+
+    // Five roof vertices, and a quad for each of the four walls.
+    ASSERT_TRUE(bucket.hasData());
+    EXPECT_EQ(5u + 4u * 4u, bucket.vertices.vertexSize());
+    EXPECT_EQ(2u * 3u + 4u * 6u, bucket.indices.indexSize());
+
+    // The first wall's bottom and top corners, facing away from the polygon.
+    const auto& vertices = bucket.vertices;
+    EXPECT_EQ(0, vertices.data()[5].a2[0]);
+    EXPECT_EQ(16384, vertices.data()[5].a2[1]);
+    EXPECT_EQ(1, vertices.data()[6].a2[0]);
+    EXPECT_EQ(10, vertices.data()[7].a2[3]);
+}
+
+TEST(Buckets, FillExtrusionBucketSkipsTileBoundaryWalls) {
+    FillExtrusionBucket bucket { { {0, 0, 0}, MapMode::Still, notObsolete }, {} };
+    StubGeometryTileFeature feature({});
+    GeometryBuffer geometry;
+    geometry.assign({ { {-128, -128}, {8320, -128}, {8320, 8320}, {-128, 8320}, {-128, -128} } });
+    bucket.addFeature(feature, geometry, 0);
+
+    // Only the roof: every edge runs along the tile's buffer.
+    EXPECT_EQ(5u, bucket.vertices.vertexSize());
+    EXPECT_EQ(2u * 3u, bucket.indices.indexSize());
+}
+
 TEST(Buckets, LineBucket) {
-    LineBucket bucket { { {0, 0, 0}, MapMode::Still }, {}, {} };
+    LineBucket bucket { { {0, 0, 0}, MapMode::Still, notObsolete }, {}, {} };
     ASSERT_FALSE(bucket.hasData());
 }
 
+TEST(Buckets, LineBucketSegments) {
+    LineBucket bucket { { {0, 0, 0}, MapMode::Still, notObsolete }, {}, {} };
+
+    StubGeometryTileFeature feature({});
+    GeometryBuffer geometry;
+    geometry.assign({ { {0, 0}, {10, 0} } });
+
+    // A straight line with butt caps is a quad.
+    bucket.addFeature(feature, geometry, 0);
+    bucket.addFeature(feature, geometry, 1);
+
+    ASSERT_EQ(1u, bucket.segments.size());
+    EXPECT_EQ(8u, bucket.segments[0].vertexLength);
+    EXPECT_EQ(12u, bucket.segments[0].indexLength);
+
+    // The second line's triangles refer to its own vertices.
+    const uint16_t* indices = bucket.triangles.data();
+    EXPECT_EQ((std::vector<uint16_t> { 0, 1, 2, 1, 2, 3, 4, 5, 6, 5, 6, 7 }),
+              std::vector<uint16_t>(indices, indices + bucket.triangles.indexSize()));
+}
+
+TEST(Buckets, LineBucketMergesSegments) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+    gl::Context& context = backend.getContext();
+
+    auto makeBucket = [] {
+        auto bucket = std::make_unique<LineBucket>(
+            style::BucketParameters { {0, 0, 0}, MapMode::Still, notObsolete }, std::vector<const style::Layer*>(), style::LineLayoutProperties());
+
+        StubGeometryTileFeature feature({});
+        GeometryBuffer geometry;
+        geometry.assign({ { {0, 0}, {10, 0} } });
+
+        // 80000 vertices need two segments of 16 bit indices.
+        for (std::size_t i = 0; i < 20000; ++i) {
+            bucket->addFeature(feature, geometry, i);
+        }
+        EXPECT_EQ(2u, bucket->segments.size());
+        return bucket;
+    };
+
+    context.disableWideIndexExtension = true;
+    auto narrow = makeBucket();
+    narrow->upload(context);
+    EXPECT_EQ(2u, narrow->segments.size());
+    EXPECT_EQ(gl::DataType::UnsignedShort, narrow->indexBuffer->indexType);
+
+    context.disableWideIndexExtension = false;
+    if (!context.supportsWideIndices()) {
+        return;
+    }
+
+    auto wide = makeBucket();
+    wide->upload(context);
+    ASSERT_EQ(1u, wide->segments.size());
+    EXPECT_EQ(0u, wide->segments[0].vertexOffset);
+    EXPECT_EQ(80000u, wide->segments[0].vertexLength);
+    EXPECT_EQ(120000u, wide->segments[0].indexLength);
+    EXPECT_EQ(gl::DataType::UnsignedInteger, wide->indexBuffer->indexType);
+}
+
+TEST(Buckets, LineBucketJoinDetail) {
+    StubGeometryTileFeature feature({});
+    GeometryBuffer geometry;
+    geometry.assign({ { {0, 0}, {100, 0}, {100, 100}, {0, 120} } });
+
+    auto countVertices = [&] (float width, float pixelRatio, style::LineJoinType join, style::LineCapType cap) {
+        style::LineLayer layer("line", "source");
+        layer.setLineWidth(width);
+        layer.baseImpl->cascade({ { style::ClassID::Default }, TimePoint(), style::TransitionOptions() });
+
+        style::LineLayoutProperties layout;
+        layout.unevaluated.get<style::LineJoin>() = join;
+        layout.unevaluated.get<style::LineCap>() = cap;
+
+        LineBucket bucket { { {0, 0, 0}, MapMode::Still, notObsolete, nullptr, pixelRatio }, { &layer }, layout };
+        bucket.addFeature(feature, geometry, 0);
+        return bucket.vertices.vertexSize();
+    };
+
+    const auto round = style::LineJoinType::Round;
+    const auto miter = style::LineJoinType::Miter;
+
+    // Lines too narrow for round joins and caps to show get miter joins and butt caps instead.
+    EXPECT_EQ(countVertices(10, 1, miter, style::LineCapType::Butt),
+              countVertices(1, 1, round, style::LineCapType::Round));
+    EXPECT_LT(countVertices(1, 1, round, style::LineCapType::Round),
+              countVertices(10, 1, round, style::LineCapType::Round));
+
+    // Widths are in pixels of the map, so the same lines on a denser screen keep them.
+    EXPECT_EQ(countVertices(10, 1, round, style::LineCapType::Round),
+              countVertices(1, 2, round, style::LineCapType::Round));
+}
+
 TEST(Buckets, SymbolBucket) {
     style::SymbolLayoutProperties::Evaluated layout;
     bool sdfIcons = false;
@@ -36,3 +253,25 @@ TEST(Buckets, SymbolBucket) {
     ASSERT_FALSE(bucket.hasTextData());
     ASSERT_FALSE(bucket.hasCollisionBoxData());
 }
+
+TEST(Buckets, SymbolBucketQuadCorners) {
+    // A quad turned by 90°, drawn without instancing.
+    const auto quad = SymbolInstanceAttributes::vertex({ 100, 200 }, { 0, 0 }, { 0, 8 }, { -4, 0 },
+                                                       16, 32, 40, 20, 18, 64);
+
+    const auto expect = [] (const SymbolLayoutVertex& expected, const SymbolLayoutVertex& actual) {
+        EXPECT_EQ(expected.a1, actual.a1);
+        EXPECT_EQ(expected.a2, actual.a2);
+        EXPECT_EQ(expected.a3, actual.a3);
+        EXPECT_EQ(expected.a4, actual.a4);
+    };
+
+    expect(SymbolLayoutAttributes::vertex({ 100, 200 }, { 0, 0 }, 16, 32, 18, 64),
+           SymbolInstanceAttributes::corner(quad, false, false));
+    expect(SymbolLayoutAttributes::vertex({ 100, 200 }, { 0, 8 }, 56, 32, 18, 64),
+           SymbolInstanceAttributes::corner(quad, true, false));
+    expect(SymbolLayoutAttributes::vertex({ 100, 200 }, { -4, 0 }, 16, 52, 18, 64),
+           SymbolInstanceAttributes::corner(quad, false, true));
+    expect(SymbolLayoutAttributes::vertex({ 100, 200 }, { -4, 8 }, 56, 52, 18, 64),
+           SymbolInstanceAttributes::corner(quad, true, true));
+}
@@ -0,0 +1,29 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/gl/half_float.hpp>
+
+#include <cmath>
+#include <limits>
+
+using namespace mbgl;
+using gl::HalfFloat;
+
+TEST(HalfFloat, RoundTrips) {
+    for (float value : { 0.0f, 1.0f, -1.0f, 0.5f, 0.25f, 1000.5f, 2047.0f, 65504.0f }) {
+        EXPECT_EQ(value, HalfFloat(value).toFloat());
+    }
+}
+
+TEST(HalfFloat, Rounds) {
+    EXPECT_EQ(2050.0f, HalfFloat(2049.0f).toFloat());
+    EXPECT_NEAR(3.1416f, HalfFloat(3.1416f).toFloat(), 0.002f);
+    EXPECT_NEAR(1e-5f, HalfFloat(1e-5f).toFloat(), 1e-7f);
+    EXPECT_EQ(0.0f, HalfFloat(1e-8f).toFloat());
+}
+
+TEST(HalfFloat, Clamps) {
+    EXPECT_EQ(65504.0f, HalfFloat(70000.0f).toFloat());
+    EXPECT_EQ(-65504.0f, HalfFloat(-70000.0f).toFloat());
+    EXPECT_TRUE(std::isinf(HalfFloat(std::numeric_limits<float>::infinity()).toFloat()));
+    EXPECT_TRUE(std::isnan(HalfFloat(std::numeric_limits<float>::quiet_NaN()).toFloat()));
+}
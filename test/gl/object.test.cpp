@@ -5,6 +5,10 @@
 #include <mbgl/gl/offscreen_view.hpp>
 
 #include <mbgl/gl/context.hpp>
+#include <mbgl/programs/attributes.hpp>
+#include <mbgl/programs/uniforms.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/mat4.hpp>
 
 #include <memory>
 
@@ -60,6 +64,46 @@ TEST(GLObject, Value) {
     EXPECT_TRUE(setFlag);
 }
 
+TEST(GLObject, SkipsUnchangedUniforms) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+    gl::Context& context = backend.getContext();
+
+    auto vertexShader = context.createShader(gl::ShaderType::Vertex,
+        "uniform mat4 u_matrix;\n"
+        "attribute vec2 a_pos;\n"
+        "void main() { gl_Position = u_matrix * vec4(a_pos, 0, 1); }\n");
+    auto fragmentShader = context.createShader(gl::ShaderType::Fragment,
+        "#ifdef GL_ES\n"
+        "precision mediump float;\n"
+        "#endif\n"
+        "uniform vec4 u_color;\n"
+        "void main() { gl_FragColor = u_color; }\n");
+    auto program = context.createProgram(vertexShader, fragmentShader);
+    context.linkProgram(program);
+    context.program = program;
+
+    using Uniforms = gl::Uniforms<uniforms::u_matrix, uniforms::u_color>;
+    auto state = Uniforms::state(program);
+
+    mat4 matrix;
+    matrix::identity(matrix);
+
+    EXPECT_EQ(2u, Uniforms::bind(state, Uniforms::Values {
+        uniforms::u_matrix::Value{ matrix }, uniforms::u_color::Value{ Color::red() } }));
+    EXPECT_EQ(0u, Uniforms::bind(state, Uniforms::Values {
+        uniforms::u_matrix::Value{ matrix }, uniforms::u_color::Value{ Color::red() } }));
+
+    matrix[12] = 1;
+    EXPECT_EQ(1u, Uniforms::bind(state, Uniforms::Values {
+        uniforms::u_matrix::Value{ matrix }, uniforms::u_color::Value{ Color::red() } }));
+
+    gl::UniformCounts counts;
+    counts.record(Uniforms::count, 1);
+    EXPECT_EQ(1u, counts.bound);
+    EXPECT_EQ(1u, counts.skipped);
+}
+
 TEST(GLObject, Store) {
     HeadlessBackend backend { test::sharedDisplay() };
     OffscreenView view(backend.getContext());
@@ -80,3 +124,257 @@ TEST(GLObject, Store) {
     context.reset();
     EXPECT_TRUE(context.empty());
 }
+
+TEST(GLObject, SharedResources) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    OffscreenView view(backend.getContext());
+    BackendScope scope { backend };
+
+    gl::Context context;
+    gl::Context other;
+    EXPECT_FALSE(context.sharesResources());
+
+    std::size_t created = 0;
+    const auto create = [&] {
+        created++;
+        return std::make_shared<int>(0);
+    };
+
+    // Contexts have registries of their own, until they share with others.
+    auto resource = context.getSharedResource<int>("resource", create);
+    EXPECT_EQ(resource, context.getSharedResource<int>("resource", create));
+    EXPECT_NE(resource, other.getSharedResource<int>("resource", create));
+    EXPECT_EQ(2u, created);
+
+    other.shareWith(context);
+    EXPECT_TRUE(context.sharesResources());
+    EXPECT_TRUE(other.sharesResources());
+    EXPECT_EQ(resource, other.getSharedResource<int>("resource", create));
+    EXPECT_EQ(2u, created);
+
+    // Programs abandoned by one of them are deleted by whichever cleans up first.
+    {
+        auto vertexShader = other.createShader(gl::ShaderType::Vertex,
+            "void main() { gl_Position = vec4(0, 0, 0, 1); }\n");
+        auto fragmentShader = other.createShader(gl::ShaderType::Fragment,
+            "#ifdef GL_ES\n"
+            "precision mediump float;\n"
+            "#endif\n"
+            "void main() { gl_FragColor = vec4(1); }\n");
+        auto program = other.createProgram(vertexShader, fragmentShader);
+    }
+    EXPECT_FALSE(context.empty());
+    context.performCleanup();
+    EXPECT_TRUE(context.empty());
+
+    // Registered objects are dropped once nobody holds them.
+    std::weak_ptr<int> weak = resource;
+    resource.reset();
+    EXPECT_TRUE(weak.expired());
+    other.getSharedResource<int>("resource", create);
+    EXPECT_EQ(3u, created);
+
+    other.reset();
+}
+
+TEST(GLObject, SharedBuffers) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    OffscreenView view(backend.getContext());
+    BackendScope scope { backend };
+
+    gl::Context context;
+
+    auto makeVertices = [] (std::size_t count) {
+        gl::VertexVector<gl::detail::Vertex<attributes::a_pos>> vertices;
+        for (std::size_t i = 0; i < count; ++i) {
+            vertices.emplace_back(gl::detail::Vertex<attributes::a_pos> {{{ int16_t(i), int16_t(i) }}});
+        }
+        return vertices;
+    };
+
+    // Small data of an owner is packed into one buffer.
+    auto first = context.createVertexBuffer(makeVertices(3));
+    auto second = context.createVertexBuffer(makeVertices(2));
+    EXPECT_EQ(first.buffer.get(), second.buffer.get());
+    EXPECT_EQ(0u, first.byteOffset);
+    EXPECT_EQ(12u, second.byteOffset);
+
+    // Large data gets a buffer of its own.
+    auto large = context.createVertexBuffer(makeVertices(gl::SharedBufferRangeMax / 4 + 1));
+    EXPECT_NE(first.buffer.get(), large.buffer.get());
+    EXPECT_EQ(0u, large.byteOffset);
+
+    // Freed ranges are reused.
+    first.buffer.reset();
+    auto third = context.createVertexBuffer(makeVertices(1));
+    EXPECT_EQ(second.buffer.get(), third.buffer.get());
+    EXPECT_EQ(0u, third.byteOffset);
+
+    second.buffer.reset();
+    third.buffer.reset();
+    large.buffer.reset();
+    context.reset();
+    EXPECT_TRUE(context.empty());
+}
+
+TEST(GLObject, SharedTextures) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    OffscreenView view(backend.getContext());
+    BackendScope scope { backend };
+
+    gl::Context context;
+
+    // Square images of a power-of-two size share a texture.
+    auto first = context.createSharedTexture(PremultipliedImage({ 256, 256 }));
+    auto second = context.createSharedTexture(PremultipliedImage({ 256, 256 }));
+    ASSERT_TRUE(first && second);
+    EXPECT_EQ(first->texture.get(), second->texture.get());
+    EXPECT_NE(first->offset, second->offset);
+    EXPECT_FLOAT_EQ(0.5f / 1024, first->offset[0]);
+    EXPECT_FLOAT_EQ(255.0f / 1024, first->scale[0]);
+
+    // Images of another size share another one, and others get none.
+    auto small = context.createSharedTexture(PremultipliedImage({ 128, 128 }));
+    ASSERT_TRUE(bool(small));
+    EXPECT_NE(first->texture.get(), small->texture.get());
+    EXPECT_FALSE(context.createSharedTexture(PremultipliedImage({ 256, 128 })));
+    EXPECT_FALSE(context.createSharedTexture(PremultipliedImage({ 300, 300 })));
+    EXPECT_FALSE(context.createSharedTexture(PremultipliedImage({ 1024, 1024 })));
+
+    // Freed slots are reused.
+    const auto offset = first->offset;
+    first = {};
+    auto third = context.createSharedTexture(PremultipliedImage({ 256, 256 }));
+    ASSERT_TRUE(bool(third));
+    EXPECT_EQ(second->texture.get(), third->texture.get());
+    EXPECT_EQ(offset, third->offset);
+
+    context.bindTexture(*third, 0, gl::TextureFilter::Linear, gl::TextureMipMap::Yes);
+
+    second = {};
+    third = {};
+    small = {};
+    context.reset();
+    EXPECT_TRUE(context.empty());
+}
+
+TEST(GLObject, StreamBuffers) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    OffscreenView view(backend.getContext());
+    BackendScope scope { backend };
+
+    gl::Context context;
+
+    gl::VertexVector<gl::detail::Vertex<attributes::a_pos>> vertices;
+    vertices.emplace_back(gl::detail::Vertex<attributes::a_pos> {{{ 0, 0 }}});
+    auto buffer = context.createStreamVertexBuffer(std::move(vertices));
+    const gl::BufferID id = buffer.buffer.get();
+    EXPECT_EQ(4u, context.getResourceStats().get(GLResourceStats::Owner::Other, GLResourceStats::Type::Buffer).bytes);
+
+    // Updates keep the buffer, with storage of the new size.
+    gl::VertexVector<gl::detail::Vertex<attributes::a_pos>> more;
+    more.emplace_back(gl::detail::Vertex<attributes::a_pos> {{{ 0, 0 }}});
+    more.emplace_back(gl::detail::Vertex<attributes::a_pos> {{{ 1, 1 }}});
+    context.updateVertexBuffer(buffer, std::move(more));
+    EXPECT_EQ(id, buffer.buffer.get());
+    EXPECT_EQ(2u, buffer.vertexCount);
+    EXPECT_EQ(8u, context.getResourceStats().get(GLResourceStats::Owner::Other, GLResourceStats::Type::Buffer).bytes);
+}
+
+TEST(GLObject, PoolsVertexArrays) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    OffscreenView view(backend.getContext());
+    BackendScope scope { backend };
+
+    gl::Context context;
+    if (!context.supportsVertexArrays()) {
+        return;
+    }
+
+    auto vao = context.createVertexArray(3);
+    const gl::VertexArrayID id = vao.get();
+    vao.reset();
+    EXPECT_FALSE(context.empty());
+
+    // Arrays are reused once released, for users binding as many attributes.
+    context.performCleanup();
+    auto other = context.createVertexArray(2);
+    EXPECT_NE(id, other.get());
+    auto same = context.createVertexArray(3);
+    EXPECT_EQ(id, same.get());
+
+    same.reset();
+    other.reset();
+    context.reset();
+    EXPECT_TRUE(context.empty());
+}
+
+TEST(GLObject, ResourceStats) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    OffscreenView view(backend.getContext());
+    BackendScope scope { backend };
+
+    gl::Context context;
+    using Owner = GLResourceStats::Owner;
+    using Type = GLResourceStats::Type;
+
+    optional<gl::Texture> texture;
+    {
+        gl::ResourceOwnerScope owner { context, Owner::Atlas };
+        texture = context.createTexture(PremultipliedImage({ 16, 8 }));
+    }
+    auto renderbuffer = context.createRenderbuffer<gl::RenderbufferType::RGBA>({ 4, 4 });
+
+    const GLResourceStats& stats = context.getResourceStats();
+    EXPECT_EQ(1u, stats.get(Owner::Atlas, Type::Texture).objects);
+    EXPECT_EQ(16u * 8 * 4, stats.get(Owner::Atlas, Type::Texture).bytes);
+    EXPECT_EQ(1u, stats.get(Owner::Other, Type::Renderbuffer).objects);
+    EXPECT_EQ(4u * 4 * 4, stats.total().bytes - stats.total(Owner::Atlas).bytes);
+
+    // Objects stop being counted once abandoned; the high-water mark stays.
+    texture = {};
+    EXPECT_EQ(0u, stats.total(Owner::Atlas).objects);
+    EXPECT_EQ(4u * 4 * 4, stats.total().bytes);
+    EXPECT_EQ(16u * 8 * 4 + 4 * 4 * 4, stats.highWaterBytes);
+}
+
+TEST(GLObject, CoalesceTextureRegions) {
+    // Neighbouring images merge into their bounding box.
+    auto regions = gl::Context::coalesceRegions({
+        { 8, 0, 8, 8 }, { 0, 0, 8, 8 }, { 16, 0, 8, 12 }, { 0, 8, 8, 8 }
+    });
+    ASSERT_EQ(1u, regions.size());
+    EXPECT_EQ(Rect<uint16_t>(0, 0, 24, 16), regions[0]);
+
+    // Regions that are apart, or whose bounding box would mostly be unchanged, stay
+    // separate.
+    regions = gl::Context::coalesceRegions({ { 0, 0, 64, 4 }, { 100, 100, 4, 4 }, { 64, 4, 4, 64 } });
+    EXPECT_EQ(3u, regions.size());
+}
+
+TEST(GLObject, ReadStillImageAsync) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+    OffscreenView view(backend.getContext(), { 4, 4 });
+    gl::Context& context = backend.getContext();
+
+    auto render = [&] (const Color& color) {
+        view.bind();
+        context.clear(color, {}, {});
+    };
+
+    render(Color::red());
+    view.startReadStillImage();
+    render(Color::blue());
+    view.startReadStillImage();
+    render(Color::black());
+
+    // Pending images come back in the order they were rendered; with none left, the
+    // current one is read.
+    EXPECT_EQ(255u, view.readStillImage().data[0]);
+    EXPECT_EQ(255u, view.readStillImage().data[2]);
+    const auto image = view.readStillImage();
+    EXPECT_EQ(0u, image.data[0]);
+    EXPECT_EQ(0u, image.data[2]);
+    EXPECT_EQ(255u, image.data[3]);
+}
@@ -0,0 +1,82 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_file_source.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/layout/symbol_layout.hpp>
+#include <mbgl/renderer/symbol_bucket.hpp>
+#include <mbgl/sprite/sprite_atlas.hpp>
+#include <mbgl/sprite/sprite_image.hpp>
+#include <mbgl/style/bucket_parameters.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/text/line_measurements.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+class StubGeometryTileLayer : public GeometryTileLayer {
+public:
+    std::vector<StubGeometryTileFeature> features;
+
+    std::size_t featureCount() const override {
+        return features.size();
+    }
+
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override {
+        return std::make_unique<StubGeometryTileFeature>(features.at(i));
+    }
+
+    std::string getName() const override {
+        return "layer";
+    }
+};
+
+StubGeometryTileFeature point(const std::string& icon, GeometryCoordinate coordinate) {
+    StubGeometryTileFeature feature { {{ "icon", icon }} };
+    feature.geometry = { GeometryCoordinates { coordinate } };
+    return feature;
+}
+
+std::size_t laidOutIcons(style::SymbolLayer& layer, const GeometryTileLayer& sourceLayer) {
+    util::RunLoop loop;
+    StubFileSource fileSource;
+    GlyphAtlas glyphAtlas { { 32, 32 }, fileSource };
+    SpriteAtlas spriteAtlas { { 32, 32 }, 1 };
+    spriteAtlas.setSprite("a", std::make_shared<SpriteImage>(PremultipliedImage({ 8, 8 }), 1));
+    spriteAtlas.setSprite("b", std::make_shared<SpriteImage>(PremultipliedImage({ 8, 8 }), 1));
+
+    const std::atomic<bool> obsolete { false };
+    const style::BucketParameters parameters { OverscaledTileID(0, 0, 0), MapMode::Continuous, obsolete };
+    SymbolLayout layout(parameters, { &layer }, sourceLayer, spriteAtlas);
+
+    LineMeasurementCache lineMeasurements;
+    layout.prepare(0, glyphAtlas, lineMeasurements);
+
+    CollisionTile collisionTile(PlacementConfig {});
+    return layout.place(collisionTile)->icon.instanceCount;
+}
+
+} // namespace
+
+TEST(SymbolLayout, HiddenDuplicates) {
+    StubGeometryTileLayer sourceLayer;
+    sourceLayer.features = {
+        point("a", { 100, 100 }),
+        point("a", { 100, 100 }),
+        point("b", { 100, 100 }),
+        point("a", { 2000, 2000 }),
+    };
+
+    style::SymbolLayer layer("symbol", "source");
+    layer.setIconImage(std::string("{icon}"));
+
+    // A symbol like one before it at the same anchor can never be placed, and isn't laid out.
+    EXPECT_EQ(3u, laidOutIcons(layer, sourceLayer));
+
+    // When symbols may overlap, all of them are.
+    layer.setIconAllowOverlap(true);
+    EXPECT_EQ(4u, laidOutIcons(layer, sourceLayer));
+}
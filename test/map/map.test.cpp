@@ -14,6 +14,7 @@
 #include <mbgl/storage/default_file_source.hpp>
 #include <mbgl/storage/online_file_source.hpp>
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/exception.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/async_task.hpp>
@@ -130,6 +131,48 @@ TEST(Map, SetStyleInvalidURL) {
     test.runLoop.run();
 }
 
+TEST(Map, StillImageTimeout) {
+    MapTest test;
+    FakeFileSource fileSource;
+
+    Map map(test.backend, test.view.getSize(), 1, fileSource, test.threadPool, MapMode::Still);
+    map.setStyleURL("mapbox://styles/test");
+
+    // The style never arrives.
+    map.renderStill(test.view, [&](std::exception_ptr error) {
+        ASSERT_TRUE(bool(error));
+        EXPECT_THROW(std::rethrow_exception(error), util::StillImageTimeoutException);
+        test.runLoop.stop();
+    }, Milliseconds(10));
+
+    test.runLoop.run();
+
+    EXPECT_FALSE(map.getStillImageStats().partial);
+    EXPECT_GE(map.getStillImageStats().total, Milliseconds(10));
+    EXPECT_EQ(Duration::zero(), map.getStillImageStats().rendering);
+}
+
+TEST(Map, StillImageCancelled) {
+    MapTest test;
+    FakeFileSource fileSource;
+
+    Map map(test.backend, test.view.getSize(), 1, fileSource, test.threadPool, MapMode::Still);
+    map.setStyleURL("mapbox://styles/test");
+
+    bool cancelled = false;
+    map.renderStill(test.view, [&](std::exception_ptr error) {
+        ASSERT_TRUE(bool(error));
+        EXPECT_THROW(std::rethrow_exception(error), util::StillImageCancelledException);
+        cancelled = true;
+    });
+    map.cancelStill();
+    EXPECT_TRUE(cancelled);
+
+    // Another image can be rendered right away.
+    map.renderStill(test.view, [&](std::exception_ptr) {});
+    map.cancelStill();
+}
+
 TEST(Map, DoubleStyleLoad) {
     MapTest test;
 
@@ -307,6 +350,152 @@ TEST(Map, AddLayer) {
     test::checkImage("test/fixtures/map/add_layer", test::render(map, test.view));
 }
 
+TEST(Map, RenderStats) {
+    MapTest test;
+
+    Map map(test.backend, test.view.getSize(), 1, test.fileSource, test.threadPool, MapMode::Still);
+    map.setStyleJSON(util::read_file("test/fixtures/api/empty.json"));
+
+    auto layer = std::make_unique<BackgroundLayer>("background");
+    layer->setBackgroundColor({ { 1, 0, 0, 1 } });
+    map.addLayer(std::move(layer));
+
+    test::render(map, test.view);
+
+    const RenderStats stats = map.getRenderStats();
+    EXPECT_GT(stats.drawCalls, 0u);
+    EXPECT_GT(stats.stateChanges, 0u);
+    EXPECT_GT(stats.programSwitches, 0u);
+    EXPECT_TRUE(stats.tiles.empty());
+    EXPECT_EQ(0u, stats.bucketUploads);
+    EXPECT_GT(stats.painter, Duration::zero());
+}
+
+TEST(Map, TileRenderCache) {
+    MapTest test;
+
+#ifdef MBGL_ASSET_ZIP
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets.zip");
+#else
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets");
+#endif
+
+    Map map(test.backend, test.view.getSize(), 1, fileSource, test.threadPool, MapMode::Still);
+    EXPECT_FALSE(map.getTileRenderCache());
+    map.setTileRenderCache(true);
+    EXPECT_TRUE(map.getTileRenderCache());
+    map.setStyleJSON(util::read_file("test/fixtures/api/water.json"));
+
+    test::render(map, test.view);
+
+    // Still images are rendered without the cache.
+    EXPECT_EQ(0u, map.getRenderStats().cachedTiles);
+    EXPECT_EQ(0u, map.onMemoryPressure(MemoryPressure::High).tileRenderCache);
+}
+
+TEST(Map, PartialRedraw) {
+    MapTest test;
+
+    Map map(test.backend, test.view.getSize(), 1, test.fileSource, test.threadPool, MapMode::Still);
+    EXPECT_FALSE(map.getPartialRedraw());
+    map.setPartialRedraw(true);
+    EXPECT_TRUE(map.getPartialRedraw());
+    map.setStyleJSON(util::read_file("test/fixtures/api/empty.json"));
+
+    auto layer = std::make_unique<BackgroundLayer>("background");
+    layer->setBackgroundColor({ { 1, 0, 0, 1 } });
+    map.addLayer(std::move(layer));
+
+    // Still images are drawn in full.
+    test::render(map, test.view);
+    EXPECT_EQ(test.view.getSize().area(), map.getRenderStats().drawnPixels);
+    test::render(map, test.view);
+    EXPECT_EQ(test.view.getSize().area(), map.getRenderStats().drawnPixels);
+}
+
+TEST(Map, RenderingPolicy) {
+    MapTest test;
+
+#ifdef MBGL_ASSET_ZIP
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets.zip");
+#else
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets");
+#endif
+
+    Map map(test.backend, test.view.getSize(), 1, fileSource, test.threadPool, MapMode::Still);
+    EXPECT_EQ(Duration::zero(), map.getRenderingPolicy().lowPriorityFrameInterval);
+    EXPECT_EQ(Duration::zero(), map.getRenderingPolicy().tileArrivalDelay);
+
+    RenderingPolicy policy;
+    policy.lowPriorityFrameInterval = Seconds(10);
+    policy.tileArrivalDelay = Seconds(10);
+    map.setRenderingPolicy(policy);
+    EXPECT_EQ(Seconds(10), map.getRenderingPolicy().tileArrivalDelay);
+
+    // Still images don't wait for the arriving tiles.
+    const TimePoint start = Clock::now();
+    map.setStyleJSON(util::read_file("test/fixtures/api/water.json"));
+    test::render(map, test.view);
+    EXPECT_LT(Clock::now() - start, Seconds(10));
+}
+
+TEST(Map, MemoryStats) {
+    MapTest test;
+
+#ifdef MBGL_ASSET_ZIP
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets.zip");
+#else
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets");
+#endif
+
+    Map map(test.backend, test.view.getSize(), 1, fileSource, test.threadPool, MapMode::Still);
+    map.setStyleJSON(util::read_file("test/fixtures/api/water.json"));
+
+    test::render(map, test.view);
+
+    const MemoryStats stats = map.getMemoryStats();
+    ASSERT_EQ(1u, stats.sources.count("mapbox"));
+    const MemoryStats::Source& source = stats.sources.at("mapbox");
+    EXPECT_GT(source.tiles, 0u);
+    EXPECT_GT(source.tileDataBytes, 0u);
+    EXPECT_GT(source.bucket(MemoryStats::BucketType::Fill).gpuBytes, 0u);
+    EXPECT_EQ(0u, source.bucket(MemoryStats::BucketType::Line).total());
+    EXPECT_EQ(0u, source.cachedTiles);
+    EXPECT_GT(stats.glyphAtlas.cpuBytes, 0u);
+    EXPECT_GE(stats.total().gpuBytes, source.total().gpuBytes);
+}
+
+TEST(Map, LayerProfiling) {
+    MapTest test;
+
+#ifdef MBGL_ASSET_ZIP
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets.zip");
+#else
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets");
+#endif
+
+    Map map(test.backend, test.view.getSize(), 1, fileSource, test.threadPool, MapMode::Still);
+    EXPECT_FALSE(map.getLayerProfiling());
+    map.setLayerProfiling(true);
+    EXPECT_TRUE(map.getLayerProfiling());
+    map.setStyleJSON(util::read_file("test/fixtures/api/water.json"));
+
+    test::render(map, test.view);
+
+    const LayerProfile profile = map.getLayerProfile();
+    ASSERT_EQ(1u, profile.layers.count("water"));
+    const LayerProfile::Layer& water = profile.layers.at("water");
+    EXPECT_GT(water.layouts, 0u);
+    EXPECT_GT(water.features, 0u);
+    EXPECT_GT(water.vertices, 0u);
+    EXPECT_GT(water.bytes, 0u);
+    EXPECT_GT(water.cpuTime, Duration::zero());
+    EXPECT_EQ(std::vector<std::string> { "water" }, profile.byCPUTime());
+
+    map.setLayerProfiling(false);
+    EXPECT_TRUE(map.getLayerProfile().layers.empty());
+}
+
 TEST(Map, WithoutVAOExtension) {
     MapTest test;
 
@@ -0,0 +1,49 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/map/tile_load_stats.hpp>
+
+using namespace mbgl;
+
+TEST(TileLoadStats, Record) {
+    const TimePoint start = Clock::now();
+
+    TileTimeline timeline;
+    timeline.requested = start;
+    timeline.responded = start + Milliseconds(100);
+    timeline.fromCache = true;
+    timeline.parsed = start + Milliseconds(102);
+    timeline.laidOut = start + Milliseconds(110);
+    timeline.uploaded = start + Milliseconds(129);
+    timeline.rendered = start + Milliseconds(131);
+
+    TileLoadStats stats;
+    stats.record(timeline);
+
+    EXPECT_EQ(1u, stats.tiles);
+    EXPECT_EQ(1u, stats.fromCache);
+    EXPECT_EQ((TileLoadStats::Histogram {{ 0, 0, 0, 0, 1, 0, 0, 0 }}), stats.get(TileLoadStats::Phase::Request));
+    EXPECT_EQ((TileLoadStats::Histogram {{ 0, 1, 0, 0, 0, 0, 0, 0 }}), stats.get(TileLoadStats::Phase::Parse));
+    EXPECT_EQ((TileLoadStats::Histogram {{ 0, 0, 1, 0, 0, 0, 0, 0 }}), stats.get(TileLoadStats::Phase::Layout));
+    EXPECT_EQ((TileLoadStats::Histogram {{ 0, 0, 0, 0, 0, 0, 0, 0 }}), stats.get(TileLoadStats::Phase::Placement));
+    EXPECT_EQ((TileLoadStats::Histogram {{ 0, 0, 1, 0, 0, 0, 0, 0 }}), stats.get(TileLoadStats::Phase::Upload));
+    EXPECT_EQ((TileLoadStats::Histogram {{ 0, 1, 0, 0, 0, 0, 0, 0 }}), stats.get(TileLoadStats::Phase::Render));
+    EXPECT_EQ((TileLoadStats::Histogram {{ 0, 0, 0, 0, 1, 0, 0, 0 }}), stats.get(TileLoadStats::Phase::Total));
+}
+
+TEST(TileLoadStats, RasterTile) {
+    const TimePoint start = Clock::now();
+
+    // Raster tiles have no layout; their upload follows the decoding of the image.
+    TileTimeline timeline;
+    timeline.parsed = start;
+    timeline.uploaded = start + Seconds(2);
+    timeline.rendered = start + Seconds(2);
+
+    TileLoadStats stats;
+    stats.record(timeline);
+
+    EXPECT_EQ((TileLoadStats::Histogram {{ 0, 0, 0, 0, 0, 0, 1, 0 }}), stats.get(TileLoadStats::Phase::Upload));
+    EXPECT_EQ((TileLoadStats::Histogram {{ 1, 0, 0, 0, 0, 0, 0, 0 }}), stats.get(TileLoadStats::Phase::Render));
+    EXPECT_EQ((TileLoadStats::Histogram {{ 0, 0, 0, 0, 0, 0, 1, 0 }}), stats.get(TileLoadStats::Phase::Total));
+    EXPECT_EQ(0u, stats.fromCache);
+}
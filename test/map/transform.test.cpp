@@ -1,6 +1,7 @@
 #include <mbgl/test/util.hpp>
 
 #include <mbgl/map/transform.hpp>
+#include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/geo.hpp>
 
 using namespace mbgl;
@@ -504,6 +505,42 @@ TEST(Transform, Camera) {
     ASSERT_FALSE(transform.inTransition());
 }
 
+TEST(Transform, TransitionStates) {
+    Transform transform;
+    transform.resize({ 1000, 1000 });
+    CameraOptions start;
+    start.center = LatLng { 0, 0 };
+    start.zoom = 10;
+    transform.jumpTo(start);
+    EXPECT_TRUE(transform.getTransitionStates().empty());
+
+    const LatLng latLng { 45, 90 };
+    CameraOptions camera;
+    camera.center = latLng;
+    camera.zoom = 12;
+    transform.flyTo(camera, AnimationOptions(Seconds(1)));
+
+    // The destination comes first, then a viewport on the way, zoomed out to fly there.
+    const auto& states = transform.getTransitionStates();
+    ASSERT_EQ(2u, states.size());
+    EXPECT_NEAR(latLng.latitude, states[0].getLatLng().latitude, 0.001);
+    EXPECT_NEAR(latLng.longitude, states[0].getLatLng().longitude, 0.001);
+    EXPECT_NEAR(12, states[0].getZoom(), 0.00001);
+    EXPECT_LT(states[1].getZoom(), 10);
+
+    // Predicting them leaves the camera where it is.
+    EXPECT_NEAR(0, transform.getLatLng().latitude, 0.000001);
+    EXPECT_NEAR(10, transform.getZoom(), 0.000001);
+
+    transform.updateTransitions(transform.getTransitionStart() + transform.getTransitionDuration());
+    EXPECT_TRUE(transform.getTransitionStates().empty());
+
+    transform.easeTo(camera, AnimationOptions(Seconds(1)));
+    EXPECT_EQ(2u, transform.getTransitionStates().size());
+    transform.cancelTransitions();
+    EXPECT_TRUE(transform.getTransitionStates().empty());
+}
+
 TEST(Transform, DefaultTransform) {
     Transform transform;
     const TransformState& state = transform.getState();
@@ -543,3 +580,40 @@ TEST(Transform, DefaultTransform) {
     ASSERT_FALSE(transform.resize({ max, max }));
     testConversions(nullIsland, center);
 }
+
+TEST(Transform, CachedMatrices) {
+    Transform transform;
+    transform.resize({ 1000, 1000 });
+    transform.setScale(2 << 9);
+    transform.setLatLng(LatLng(38, -77));
+
+    const LatLng before = transform.getState().screenCoordinateToLatLng({ 0, 1000 });
+
+    // Conversions follow changes of the state.
+    transform.setPitch(0.9);
+    const TransformState& state = transform.getState();
+    const LatLng after = state.screenCoordinateToLatLng({ 0, 1000 });
+    EXPECT_NE(before.latitude, after.latitude);
+    ASSERT_NEAR(-77.59198961199148, after.longitude, 0.0002);
+    ASSERT_NEAR(38.74661326302018, after.latitude, 0.0001);
+
+    const std::vector<ScreenCoordinate> points = state.latLngsToScreenCoordinates({ after, { 38, -77 } });
+    ASSERT_EQ(2u, points.size());
+    EXPECT_EQ(state.latLngToScreenCoordinate(after), points[0]);
+    EXPECT_EQ(state.latLngToScreenCoordinate({ 38, -77 }), points[1]);
+
+    const std::vector<LatLng> latLngs = state.screenCoordinatesToLatLngs({ { 0, 1000 } });
+    ASSERT_EQ(1u, latLngs.size());
+    EXPECT_EQ(after, latLngs[0]);
+
+    // Tile matrices can skip most of their multiplication with the projection matrix.
+    mat4 projMatrix;
+    state.getProjMatrix(projMatrix);
+    const UnwrappedTileID tileID { 11, 585, 783 };
+    mat4 expected;
+    state.matrixFor(expected, tileID);
+    matrix::multiply(expected, projMatrix, expected);
+    mat4 actual;
+    state.matrixFor(actual, tileID, projMatrix);
+    EXPECT_EQ(expected, actual);
+}
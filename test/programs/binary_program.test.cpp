@@ -0,0 +1,23 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/programs/binary_program.hpp>
+
+using namespace mbgl;
+
+TEST(BinaryProgram, ObtainValues) {
+    const BinaryProgram binaryProgram{ 42, "binary code", "identifier" };
+
+    EXPECT_EQ(42u, binaryProgram.format());
+    EXPECT_EQ("binary code", binaryProgram.code());
+    EXPECT_EQ("identifier", binaryProgram.identifier());
+
+    auto serialized = binaryProgram.serialize();
+
+    const BinaryProgram binaryProgram2(std::move(serialized));
+
+    EXPECT_EQ(binaryProgram.format(), binaryProgram2.format());
+    EXPECT_EQ(binaryProgram.code(), binaryProgram2.code());
+    EXPECT_EQ(binaryProgram.identifier(), binaryProgram2.identifier());
+
+    EXPECT_THROW(BinaryProgram(""), std::runtime_error);
+}
@@ -0,0 +1,46 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/programs/shader_variant.hpp>
+#include <mbgl/shaders/fill.hpp>
+
+using namespace mbgl;
+
+TEST(ShaderVariant, Specialize) {
+    const std::string source = shaders::fill::vertexSource;
+    const std::string specialized = specializeVertexSource(source, { "a_color" });
+
+    EXPECT_NE(std::string::npos, specialized.find("color = a_color_min;"));
+    EXPECT_NE(std::string::npos, specialized.find("attribute lowp vec4 a_color_min;"));
+    EXPECT_EQ(std::string::npos, specialized.find("a_color_max"));
+    EXPECT_EQ(std::string::npos, specialized.find("a_color_t"));
+
+    // Other properties are still interpolated.
+    EXPECT_NE(std::string::npos, specialized.find("mix(a_opacity_min, a_opacity_max, a_opacity_t)"));
+    EXPECT_NE(std::string::npos, specialized.find("uniform lowp float a_opacity_t;"));
+}
+
+TEST(ShaderVariant, KeepsUsedDeclarations) {
+    const std::string source =
+        "uniform lowp float a_size_t;\n"
+        "attribute float a_size_min;\n"
+        "attribute float a_size_max;\n"
+        "void main() {\n"
+        "    float size = mix(a_size_min, a_size_max, a_size_t);\n"
+        "    float t = a_size_t;\n"
+        "}\n";
+
+    const std::string specialized = specializeVertexSource(source, { "a_size", "a_other" });
+
+    EXPECT_EQ("uniform lowp float a_size_t;\n"
+              "attribute float a_size_min;\n"
+              "void main() {\n"
+              "    float size = a_size_min;\n"
+              "    float t = a_size_t;\n"
+              "}\n", specialized);
+}
+
+TEST(ShaderVariant, Unchanged) {
+    const std::string source = shaders::fill::vertexSource;
+    EXPECT_EQ(source, specializeVertexSource(source, {}));
+    EXPECT_EQ(source, specializeVertexSource(source, { "a_width" }));
+}
@@ -0,0 +1,70 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/map/backend_scope.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/programs/fill_program.hpp>
+#include <mbgl/renderer/fill_batch.hpp>
+#include <mbgl/renderer/fill_bucket.hpp>
+#include <mbgl/style/bucket_parameters.hpp>
+
+#include <atomic>
+
+using namespace mbgl;
+
+namespace {
+
+const std::atomic<bool> notObsolete { false };
+
+std::unique_ptr<FillBucket> makeBucket(gl::Context& context, int16_t size) {
+    auto bucket = std::make_unique<FillBucket>(
+        style::BucketParameters { { 0, 0, 0 }, MapMode::Continuous, notObsolete }, std::vector<const style::Layer*>());
+
+    StubGeometryTileFeature feature({});
+    GeometryBuffer geometry;
+    geometry.assign({ { { 0, 0 }, { size, 0 }, { size, size }, { 0, size }, { 0, 0 } } });
+    bucket->addFeature(feature, geometry, 0);
+    bucket->upload(context);
+    return bucket;
+}
+
+} // namespace
+
+TEST(FillBatch, MergesBuckets) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+    gl::Context& context = backend.getContext();
+
+    auto a = makeBucket(context, 10);
+    auto b = makeBucket(context, 20);
+    ASSERT_TRUE(a->retainsGeometry);
+    ASSERT_TRUE(b->retainsGeometry);
+    EXPECT_NE(a->serial, b->serial);
+
+    FillBatch batch;
+    batch.update(context, { a.get(), b.get() });
+    ASSERT_TRUE(bool(batch.vertexBuffer));
+    EXPECT_EQ(10u, batch.vertexBuffer->vertexCount);
+    ASSERT_EQ(1u, batch.segments.size());
+    EXPECT_EQ(10u, batch.segments[0].vertexLength);
+    EXPECT_EQ(12u, batch.segments[0].indexLength);
+
+    // The same buckets keep the buffers.
+    const gl::BufferID buffer = batch.vertexBuffer->buffer.get();
+    batch.update(context, { a.get(), b.get() });
+    EXPECT_EQ(buffer, batch.vertexBuffer->buffer.get());
+
+    // Any change of the tiles rebuilds them.
+    batch.update(context, { b.get() });
+    EXPECT_EQ(5u, batch.vertexBuffer->vertexCount);
+    ASSERT_EQ(1u, batch.segments.size());
+    EXPECT_EQ(6u, batch.segments[0].indexLength);
+}
+
+TEST(FillBatch, ProgramLinks) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+
+    FillBatchedProgram program { backend.getContext(), ProgramParameters {} };
+    FillBatchedProgram overdraw { backend.getContext(), ProgramParameters { 1.0, true } };
+}
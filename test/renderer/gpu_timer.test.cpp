@@ -0,0 +1,44 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/map/backend_scope.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/renderer/gpu_timer.hpp>
+#include <mbgl/util/logging.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace mbgl;
+
+TEST(GPUTimer, ReportsSections) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+    gl::Context& context = backend.getContext();
+
+    if (!context.supportsTimerQueries()) {
+        Log::Warning(Event::OpenGL, "timer queries are not supported; skipping");
+        return;
+    }
+
+    GPUTimer timer(context);
+    timer.startSection("first");
+    context.clear(Color::black(), {}, {});
+    timer.startSection("second");
+    context.clear(Color::white(), {}, {});
+    timer.endFrame();
+
+    // A frame without sections isn't reported.
+    timer.endFrame();
+
+    std::vector<FrameStats> stats;
+    for (int i = 0; i < 1000 && stats.empty(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        stats = timer.collect();
+    }
+
+    ASSERT_EQ(1u, stats.size());
+    ASSERT_EQ(2u, stats[0].sections.size());
+    EXPECT_EQ("first", stats[0].sections[0].name);
+    EXPECT_EQ("second", stats[0].sections[1].name);
+    EXPECT_TRUE(timer.collect().empty());
+}
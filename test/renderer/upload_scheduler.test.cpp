@@ -0,0 +1,85 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/map/backend_scope.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/renderer/upload_scheduler.hpp>
+#include <mbgl/tile/tile.hpp>
+
+#include <thread>
+
+using namespace mbgl;
+
+namespace {
+
+class StubTile : public Tile {
+public:
+    StubTile() : Tile(OverscaledTileID { 0, 0, 0 }) {
+        availableData = DataAvailability::All;
+    }
+
+    void setNecessity(Necessity) override {}
+    void cancel() override {}
+    Bucket* getBucket(const style::Layer&) override { return nullptr; }
+
+    std::size_t uploads = 0;
+
+private:
+    void uploadBuckets(gl::Context&) override {
+        ++uploads;
+        std::this_thread::sleep_for(Milliseconds(2));
+    }
+};
+
+} // namespace
+
+TEST(UploadScheduler, DefersTilesOverBudget) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+
+    UploadScheduler scheduler;
+    scheduler.setBudget(Milliseconds(1));
+
+    StubTile first;
+    StubTile second;
+
+    // The first tile is always uploaded, however long it takes.
+    scheduler.startFrame();
+    scheduler.upload(first, backend.getContext());
+    scheduler.upload(second, backend.getContext());
+    EXPECT_TRUE(scheduler.hasDeferred());
+    EXPECT_EQ(1u, first.uploads);
+    EXPECT_FALSE(first.needsUpload());
+    EXPECT_TRUE(first.isRenderable());
+    EXPECT_EQ(0u, second.uploads);
+    EXPECT_TRUE(second.needsUpload());
+    EXPECT_FALSE(second.isRenderable());
+    EXPECT_FALSE(second.isComplete());
+
+    scheduler.startFrame();
+    scheduler.upload(second, backend.getContext());
+    EXPECT_FALSE(scheduler.hasDeferred());
+    EXPECT_EQ(1u, second.uploads);
+    EXPECT_FALSE(second.needsUpload());
+    EXPECT_TRUE(second.isRenderable());
+    EXPECT_TRUE(second.isComplete());
+}
+
+TEST(UploadScheduler, ZeroBudgetUploadsEverything) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+
+    UploadScheduler scheduler;
+    scheduler.setBudget(Duration::zero());
+
+    StubTile tiles[3];
+    scheduler.startFrame();
+    for (auto& tile : tiles) {
+        scheduler.upload(tile, backend.getContext());
+    }
+
+    EXPECT_FALSE(scheduler.hasDeferred());
+    for (auto& tile : tiles) {
+        EXPECT_EQ(1u, tile.uploads);
+        EXPECT_TRUE(tile.isRenderable());
+    }
+}
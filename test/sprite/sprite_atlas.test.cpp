@@ -70,6 +70,39 @@ TEST(SpriteAtlas, Basic) {
     test::checkImage("test/fixtures/sprite_atlas/basic", atlas.getAtlasImage());
 }
 
+TEST(SpriteAtlas, SpriteSheet) {
+    FixtureLog log;
+
+    auto spriteSheetParseResult = parseSpriteSheet(util::read_file("test/fixtures/annotations/emerald.png"),
+                                                   util::read_file("test/fixtures/annotations/emerald.json"));
+    SpriteSheet& sheet = spriteSheetParseResult.get<SpriteSheet>();
+    std::weak_ptr<const PremultipliedImage> sheetImage = sheet.image;
+    const std::size_t images = sheet.images.size();
+
+    SpriteAtlas atlas({ 63, 112 }, 1);
+    atlas.setSpriteSheet(std::move(sheet));
+
+    // Images are extracted from the sheet as they are used, the same as all at once.
+    atlas.getIcon("metro");
+    atlas.getPattern("metro");
+    test::checkImage("test/fixtures/sprite_atlas/basic", atlas.getAtlasImage());
+
+    auto metro = atlas.getSprite("metro");
+    ASSERT_TRUE(metro);
+    EXPECT_EQ(18u, metro->image.size.width);
+    EXPECT_EQ(18u, metro->image.size.height);
+
+    // The sheet is kept until every image was.
+    EXPECT_FALSE(sheetImage.expired());
+    auto sprites = parseSprite(util::read_file("test/fixtures/annotations/emerald.png"),
+                               util::read_file("test/fixtures/annotations/emerald.json"));
+    ASSERT_EQ(images, sprites.get<Sprites>().size());
+    for (const auto& sprite : sprites.get<Sprites>()) {
+        atlas.getSprite(sprite.first);
+    }
+    EXPECT_TRUE(sheetImage.expired());
+}
+
 TEST(SpriteAtlas, Size) {
     auto spriteParseResult = parseSprite(util::read_file("test/fixtures/annotations/emerald.png"),
                                          util::read_file("test/fixtures/annotations/emerald.json"));
@@ -200,6 +233,29 @@ TEST(SpriteAtlas, RemoveReleasesBinPackRect) {
     EXPECT_TRUE(log.empty());
 }
 
+TEST(SpriteAtlas, Grows) {
+    FixtureLog log;
+
+    SpriteAtlas atlas({ 32, 32 }, 1);
+
+    const auto sprite = std::make_shared<SpriteImage>(PremultipliedImage({ 28, 28 }), 1);
+    atlas.setSprite("one", sprite);
+    atlas.setSprite("two", sprite);
+
+    auto one = *atlas.getIcon("one");
+    EXPECT_EQ(Size({ 32, 32 }), atlas.getSize());
+
+    // The second icon doesn't fit, so the atlas doubles, and the first one stays in place.
+    auto two = *atlas.getIcon("two");
+    EXPECT_EQ(Size({ 64, 64 }), atlas.getSize());
+    EXPECT_EQ(Size({ 64, 64 }), atlas.getAtlasImage().size);
+    EXPECT_EQ(Rect<uint16_t>(0, 0, 32, 32), one.pos);
+    EXPECT_EQ(Rect<uint16_t>(32, 0, 32, 32), two.pos);
+    EXPECT_FLOAT_EQ(1.0f / 64, atlas.getIcon("one")->tl[0]);
+
+    EXPECT_TRUE(log.empty());
+}
+
 TEST(SpriteAtlas, OtherPixelRatio) {
     FixtureLog log;
 
@@ -331,6 +387,45 @@ TEST(SpriteAtlas, LoadingSuccess) {
     test.run();
 }
 
+TEST(SpriteAtlas, LoadingShared) {
+    SpriteAtlasTest test;
+
+    test.fileSource.spriteImageResponse = successfulSpriteImageResponse;
+    test.fileSource.spriteJSONResponse = successfulSpriteJSONResponse;
+    test.observer.spriteLoaded = [&] () {
+        test.end();
+    };
+    test.run();
+    ASSERT_TRUE(test.spriteAtlas.isLoaded());
+
+    // Another atlas uses the sheet that is loaded already, without requesting it again.
+    test.fileSource.spriteImageResponse = failedSpriteResponse;
+    test.fileSource.spriteJSONResponse = failedSpriteResponse;
+    bool loaded = false;
+    StubStyleObserver observer;
+    observer.spriteLoaded = [&] () {
+        loaded = true;
+    };
+
+    SpriteAtlas other { { 32, 32 }, 1 };
+    other.setObserver(&observer);
+    other.load("test/fixtures/resources/sprite", test.fileSource);
+    EXPECT_TRUE(loaded);
+    EXPECT_TRUE(other.isLoaded());
+    ASSERT_NE(nullptr, other.getSprite("airport-15"));
+    EXPECT_EQ(21, other.getSprite("airport-15")->getWidth());
+
+    // A sheet at another pixel ratio is loaded on its own.
+    observer.spriteError = [&] (std::exception_ptr) {
+        test.end();
+    };
+    SpriteAtlas retina { { 32, 32 }, 2 };
+    retina.setObserver(&observer);
+    retina.load("test/fixtures/resources/sprite", test.fileSource);
+    test.loop.run();
+    EXPECT_FALSE(retina.isLoaded());
+}
+
 TEST(SpriteAtlas, JSONLoadingFail) {
     SpriteAtlasTest test;
 
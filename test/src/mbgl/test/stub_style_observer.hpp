@@ -55,6 +55,10 @@ public:
         if (resourceError) resourceError(error);
     };
 
+    void onUpdate(Update flags) override {
+        if (update) update(flags);
+    }
+
     std::function<void (const FontStack&, const GlyphRange&)> glyphsLoaded;
     std::function<void (const FontStack&, const GlyphRange&, std::exception_ptr)> glyphsError;
     std::function<void ()> spriteLoaded;
@@ -66,4 +70,5 @@ public:
     std::function<void (Source&, const OverscaledTileID&)> tileChanged;
     std::function<void (Source&, const OverscaledTileID&, std::exception_ptr)> tileError;
     std::function<void (std::exception_ptr)> resourceError;
+    std::function<void (Update)> update;
 };
@@ -0,0 +1,30 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/storage/concurrency_limit.hpp>
+
+using namespace mbgl;
+
+TEST(ConcurrencyLimit, GrowsWhileLatencyIsSteady) {
+    ConcurrencyLimit limit { 20, 5, 80 };
+    EXPECT_EQ(20u, limit.get());
+
+    // A high-latency link that isn't saturated: requests take as long however many there are.
+    for (int i = 0; i < 100; i++) {
+        limit.sample(Milliseconds(600));
+    }
+    EXPECT_EQ(80u, limit.get());
+}
+
+TEST(ConcurrencyLimit, ShrinksWhenSaturated) {
+    ConcurrencyLimit limit { 20, 5, 80 };
+    for (int i = 0; i < 100; i++) {
+        limit.sample(Milliseconds(100));
+    }
+
+    // Once the bandwidth is shared, every request in flight makes the others slower.
+    for (int i = 0; i < 300; i++) {
+        limit.sample(Milliseconds(5 * limit.get()));
+    }
+    EXPECT_GT(40u, limit.get());
+    EXPECT_LE(5u, limit.get());
+}
@@ -1,5 +1,6 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 
 using namespace mbgl;
@@ -307,6 +308,63 @@ TEST(DefaultFileSource, OptionalNotFound) {
     loop.run();
 }
 
+TEST(DefaultFileSource, TEST_REQUIRES_WRITE(WriteAheadLoggingReaders)) {
+    util::RunLoop loop;
+
+    const std::string path = "test/fixtures/offline_database/readers.db";
+    try {
+        util::deleteFile(path);
+    } catch (const util::IOException&) {
+    }
+
+    DefaultFileSource fs(path, ".");
+
+    const Resource optionalResource { Resource::Unknown, "http://127.0.0.1:3000/test", {}, Resource::Optional };
+    const Resource missingResource { Resource::Unknown, "http://127.0.0.1:3000/missing", {}, Resource::Optional };
+
+    using namespace std::chrono_literals;
+
+    Response response;
+    response.data = std::make_shared<std::string>("Cached value");
+    response.expires = util::now() + 1h;
+    fs.put(optionalResource, response);
+
+    // Requests are read from the database by the readers, rather than the memory cache.
+    fs.setWriteAheadLogging(true);
+    fs.purgeMemoryCache();
+
+    std::unique_ptr<AsyncRequest> req1;
+    std::unique_ptr<AsyncRequest> req2;
+    bool found = false;
+    bool notFound = false;
+
+    req1 = fs.request(optionalResource, [&](Response res) {
+        req1.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Cached value", *res.data);
+        found = true;
+        if (notFound) {
+            loop.stop();
+        }
+    });
+
+    req2 = fs.request(missingResource, [&](Response res) {
+        req2.reset();
+        ASSERT_TRUE(res.error.get());
+        EXPECT_EQ(Response::Error::Reason::NotFound, res.error->reason);
+        notFound = true;
+        if (found) {
+            loop.stop();
+        }
+    });
+
+    loop.run();
+
+    EXPECT_EQ(1u, fs.getStats().total().cacheHits);
+    fs.setWriteAheadLogging(false);
+}
+
 // Test that we can make a request with etag data that doesn't first try to load
 // from cache like a regular request
 TEST(DefaultFileSource, TEST_REQUIRES_SERVER(NoCacheRefreshEtagNotModified)) {
@@ -506,3 +564,40 @@ TEST(DefaultFileSource, TEST_REQUIRES_SERVER(SetResourceTransform)) {
 
     loop.run();
 }
+
+TEST(DefaultFileSource, Stats) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    const Resource cached { Resource::Tile, "http://127.0.0.1:3000/cached", {}, Resource::Optional };
+    const Resource missing { Resource::Tile, "http://127.0.0.1:3000/missing", {}, Resource::Optional };
+
+    using namespace std::chrono_literals;
+
+    Response response;
+    response.data = std::make_shared<std::string>("Cached value");
+    response.expires = util::now() + 1h;
+    fs.put(cached, response);
+
+    std::unique_ptr<AsyncRequest> req1;
+    std::unique_ptr<AsyncRequest> req2;
+    req1 = fs.request(cached, [&](Response) {
+        req1.reset();
+        req2 = fs.request(missing, [&](Response) {
+            req2.reset();
+            loop.stop();
+        });
+    });
+
+    loop.run();
+
+    const FileSourceStats stats = fs.getStats();
+    EXPECT_EQ(2u, stats.get(Resource::Tile).requests);
+    EXPECT_EQ(1u, stats.get(Resource::Tile).cacheHits);
+    EXPECT_EQ(1u, stats.get(Resource::Tile).cacheMisses);
+
+    // Optional requests don't go to the network.
+    EXPECT_EQ(0u, stats.get(Resource::Tile).networkRequests);
+    EXPECT_EQ(0u, stats.get(Resource::Style).requests);
+    EXPECT_EQ(2u, stats.total().requests);
+}
@@ -0,0 +1,85 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/storage/mbtiles_file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <gtest/gtest.h>
+#include <sqlite3.hpp>
+
+#include <cerrno>
+#include <unistd.h>
+
+using namespace mbgl;
+using namespace std::literals::string_literals;
+
+namespace {
+
+const char* path = "test/fixtures/storage/test.mbtiles";
+
+void createMBTiles() {
+    if (unlink(path) == -1) {
+        ASSERT_EQ(ENOENT, errno);
+    }
+
+    mapbox::sqlite::Database db(path, mapbox::sqlite::ReadWrite | mapbox::sqlite::Create);
+    db.exec("CREATE TABLE metadata (name TEXT, value TEXT)");
+    db.exec("CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB)");
+    db.exec("INSERT INTO metadata VALUES ('name', 'test'), ('minzoom', '0'), ('maxzoom', '1')");
+    // The top left tile of zoom level 1, in the TMS scheme.
+    db.exec("INSERT INTO tiles VALUES (1, 0, 1, 'tile')");
+}
+
+} // namespace
+
+TEST(MBTilesFileSource, AcceptsURL) {
+    EXPECT_TRUE(MBTilesFileSource::acceptsURL("mbtiles:///tiles.mbtiles"));
+    EXPECT_FALSE(MBTilesFileSource::acceptsURL("file:///tiles.mbtiles"));
+}
+
+TEST(MBTilesFileSource, TEST_REQUIRES_WRITE(TileJSONAndTiles)) {
+    util::RunLoop loop;
+    createMBTiles();
+
+    MBTilesFileSource fs;
+    const std::string url = "mbtiles://"s + path;
+    const std::string tileURL = url + "/{z}/{x}/{y}";
+    std::unique_ptr<AsyncRequest> tileJSONRequest, tileRequest, missingRequest;
+
+    tileJSONRequest = fs.request(Resource::source(url), [&](Response res) {
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ(R"({"tilejson":"2.1.0","scheme":"xyz","tiles":["mbtiles://test/fixtures/storage/test.mbtiles/{z}/{x}/{y}"],)"
+                  R"("minzoom":0,"maxzoom":1,"name":"test"})", *res.data);
+
+        tileRequest = fs.request(Resource::tile(tileURL, 1.0, 0, 0, 1, Tileset::Scheme::XYZ), [&](Response tile) {
+            EXPECT_EQ(nullptr, tile.error);
+            ASSERT_TRUE(tile.data.get());
+            EXPECT_EQ("tile", *tile.data);
+
+            // Tiles missing from the file have no content.
+            missingRequest = fs.request(Resource::tile(tileURL, 1.0, 1, 0, 1, Tileset::Scheme::XYZ), [&](Response missing) {
+                EXPECT_EQ(nullptr, missing.error);
+                EXPECT_TRUE(missing.noContent);
+                loop.stop();
+            });
+        });
+    });
+
+    loop.run();
+}
+
+TEST(MBTilesFileSource, NonExistentFile) {
+    util::RunLoop loop;
+
+    MBTilesFileSource fs;
+
+    std::unique_ptr<AsyncRequest> req = fs.request(Resource::source("mbtiles://test/fixtures/storage/does_not_exist.mbtiles"), [&](Response res) {
+        req.reset();
+        ASSERT_NE(nullptr, res.error);
+        EXPECT_EQ(Response::Error::Reason::NotFound, res.error->reason);
+        loop.stop();
+    });
+
+    loop.run();
+}
@@ -52,3 +52,13 @@ TEST(OfflineTilePyramidRegionDefinition, TileCoverWrapped) {
     EXPECT_EQ((std::vector<CanonicalTileID>{ { 0, 0, 0 } }),
               region.tileCover(SourceType::Vector, 512, { 0, 22 }));
 }
+
+TEST(OfflineTilePyramidRegionDefinition, TileCount) {
+    OfflineTilePyramidRegionDefinition region("", sanFrancisco, 0, 16, 1.0);
+
+    EXPECT_EQ(region.tileCover(SourceType::Vector, 512, { 0, 22 }).size(),
+              region.tileCount(SourceType::Vector, 512, { 0, 22 }));
+    EXPECT_EQ(region.tileCover(SourceType::Raster, 256, { 4, 12 }).size(),
+              region.tileCount(SourceType::Raster, 256, { 4, 12 }));
+    EXPECT_EQ(0u, region.tileCount(SourceType::Vector, 512, { 17, 22 }));
+}
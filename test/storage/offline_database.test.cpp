@@ -4,6 +4,7 @@
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/util/compression.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/string.hpp>
 
@@ -343,6 +344,30 @@ TEST(OfflineDatabase, DeleteRegion) {
     ASSERT_EQ(0u, db.listRegions().size());
 }
 
+TEST(OfflineDatabase, DeleteRegionEvictsInBackground) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:", 1024 * 100);
+    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+
+    Response response;
+    response.data = randomString(1024);
+
+    for (uint32_t i = 1; i <= 100; i++) {
+        db.putRegionResource(region.getID(), Resource::style("http://example.com/"s + util::toString(i)), response);
+    }
+
+    // The resources of the region are left in the cache until they are evicted in the background.
+    db.deleteRegion(std::move(region));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/1"))));
+    ASSERT_TRUE(db.needsEviction());
+
+    EXPECT_FALSE(db.evictInBackground(Seconds(10)));
+    EXPECT_FALSE(db.needsEviction());
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
+}
+
 TEST(OfflineDatabase, CreateRegionInfiniteMaxZoom) {
     using namespace mbgl;
 
@@ -415,6 +440,54 @@ TEST(OfflineDatabase, PutReturnsSize) {
     EXPECT_EQ(0u, db.put(Resource::style("http://example.com/noContent"), noContent).second);
 }
 
+TEST(OfflineDatabase, PutCompressesTilesWithDictionary) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+
+    Resource tile = Resource::tile("http://example.com/{z}-{x}-{y}.vector.pbf", 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
+    Response response;
+    response.data = std::make_shared<std::string>(util::read_file("test/fixtures/offline_download/0-0-0.vector.pbf"));
+
+    EXPECT_EQ(util::compress(*response.data, OfflineDatabase::tileDictionary()).size(), db.put(tile, response).second);
+    auto res = db.get(tile);
+    ASSERT_TRUE(bool(res));
+    EXPECT_EQ(*response.data, *res->data);
+
+    // Data in a compressed format, here with a gzip header, isn't deflated again.
+    Response gzipped;
+    gzipped.data = std::make_shared<std::string>("\037\213" + std::string(1024, 0));
+    EXPECT_EQ(1026u, db.put(Resource::style("http://example.com/gzipped"), gzipped).second);
+}
+
+TEST(OfflineDatabase, GetCompressedTile) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+
+    Resource tile = Resource::tile("http://example.com/{z}-{x}-{y}.vector.pbf", 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
+    Response response;
+    response.data = std::make_shared<std::string>(util::read_file("test/fixtures/offline_download/0-0-0.vector.pbf"));
+    db.put(tile, response);
+
+    // Tiles are returned as they are stored, for the tile workers to inflate.
+    auto res = db.getCompressed(tile);
+    ASSERT_TRUE(bool(res));
+    EXPECT_EQ(util::Compression::DeflateWithTileDictionary, res->compression);
+    EXPECT_EQ(*response.data, *util::decompress(res->data, res->compression));
+    EXPECT_EQ(util::Compression::None, db.get(tile)->compression);
+
+    // Other resources are inflated as before.
+    Resource style = Resource::style("http://example.com/style");
+    Response styleResponse;
+    styleResponse.data = std::make_shared<std::string>(std::string(1024, 'a'));
+    db.put(style, styleResponse);
+    res = db.getCompressed(style);
+    ASSERT_TRUE(bool(res));
+    EXPECT_EQ(util::Compression::None, res->compression);
+    EXPECT_EQ(*styleResponse.data, *res->data);
+}
+
 TEST(OfflineDatabase, PutEvictsLeastRecentlyUsedResources) {
     using namespace mbgl;
 
@@ -432,6 +505,27 @@ TEST(OfflineDatabase, PutEvictsLeastRecentlyUsedResources) {
     EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
 }
 
+TEST(OfflineDatabase, EvictInBackground) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:", 1024 * 100);
+
+    Response response;
+    response.data = randomString(1024);
+
+    uint32_t i = 0;
+    while (!db.needsEviction() && i < 100) {
+        db.put(Resource::style("http://example.com/"s + util::toString(++i)), response);
+    }
+    ASSERT_TRUE(db.needsEviction());
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/1"))));
+
+    // Eviction goes on until the cache is well below the maximum size, and then some vacuuming.
+    EXPECT_FALSE(db.evictInBackground(Seconds(10)));
+    EXPECT_FALSE(db.needsEviction());
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
+}
+
 TEST(OfflineDatabase, PutRegionResourceDoesNotEvict) {
     using namespace mbgl;
 
@@ -450,6 +544,33 @@ TEST(OfflineDatabase, PutRegionResourceDoesNotEvict) {
     EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/20"))));
 }
 
+TEST(OfflineDatabase, PutRegionResources) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+
+    Response response;
+    response.data = randomString(1024);
+
+    std::vector<std::pair<Resource, Response>> tiles;
+    for (int32_t x = 0; x < 4; x++) {
+        tiles.emplace_back(Resource::tile("mapbox://{z}-{x}-{y}.vector.pbf", 1.0, x, 0, 2, Tileset::Scheme::XYZ), response);
+    }
+    // Puts in a batch behave as separate puts: a resource put twice is only counted once.
+    tiles.push_back(tiles.front());
+
+    const std::vector<uint64_t> sizes = db.putRegionResources(region.getID(), tiles);
+    ASSERT_EQ(5u, sizes.size());
+    EXPECT_EQ(1024u, sizes.front());
+    EXPECT_EQ(4u, db.getOfflineMapboxTileCount());
+
+    OfflineRegionStatus status = db.getRegionCompletedStatus(region.getID());
+    EXPECT_EQ(4u, status.completedTileCount);
+    EXPECT_TRUE(bool(db.get(tiles[2].first)));
+}
+
 TEST(OfflineDatabase, PutFailsWhenEvictionInsuffices) {
     using namespace mbgl;
 
@@ -496,6 +617,32 @@ TEST(OfflineDatabase, GetRegionCompletedStatus) {
     EXPECT_EQ(tileSize, status3.completedTileSize);
 }
 
+TEST(OfflineDatabase, GetRegionTiles) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion region1 = db.createRegion(definition, OfflineRegionMetadata());
+    OfflineRegion region2 = db.createRegion(definition, OfflineRegionMetadata());
+
+    const std::string urlTemplate = "http://example.com/{z}-{x}-{y}.vector.pbf";
+    Resource tile = Resource::tile(urlTemplate, 1.0, 1, 2, 3, Tileset::Scheme::XYZ);
+    Resource otherTile = Resource::tile(urlTemplate, 1.0, 2, 2, 3, Tileset::Scheme::XYZ);
+    Resource retinaTile = Resource::tile(urlTemplate + "{ratio}", 2.0, 1, 2, 3, Tileset::Scheme::XYZ);
+
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+    db.putRegionResource(region1.getID(), tile, response);
+    db.putRegionResource(region2.getID(), otherTile, response);
+
+    OfflineRegionTiles tiles = db.getRegionTiles(region1.getID());
+    EXPECT_EQ(1u, tiles.size());
+    ASSERT_TRUE(bool(tiles.find(*tile.tileData)));
+    EXPECT_EQ(4u, *tiles.find(*tile.tileData));
+    EXPECT_FALSE(bool(tiles.find(*otherTile.tileData)));
+    EXPECT_FALSE(bool(tiles.find(*retinaTile.tileData)));
+}
+
 TEST(OfflineDatabase, HasRegionResource) {
     using namespace mbgl;
 
@@ -698,3 +845,151 @@ TEST(OfflineDatabase, MigrateFromV4Schema) {
     // Synchronous setting should be FULL (2) after migration to v5.
     EXPECT_EQ(2, databaseSyncMode("test/fixtures/offline_database/v5.db"));
 }
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(WriteAheadLogging)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    Resource resource { Resource::Style, "http://example.com/" };
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+
+    {
+        OfflineDatabase db("test/fixtures/offline_database/offline.db");
+        db.setWriteAheadLogging(true);
+        db.put(resource, response);
+        EXPECT_EQ("wal", databaseJournalMode("test/fixtures/offline_database/offline.db"));
+
+        // Resources are readable from another connection before any checkpoint.
+        OfflineDatabase other("test/fixtures/offline_database/offline.db");
+        auto res = other.get(resource);
+        ASSERT_TRUE(bool(res));
+        EXPECT_EQ("data", *res->data);
+    }
+
+    {
+        OfflineDatabase db("test/fixtures/offline_database/offline.db");
+        db.setWriteAheadLogging(true);
+        db.setWriteAheadLogging(false);
+        EXPECT_EQ("delete", databaseJournalMode("test/fixtures/offline_database/offline.db"));
+        EXPECT_TRUE(bool(db.get(resource)));
+    }
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ReadOnlyConnection)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    Resource resource { Resource::Style, "http://example.com/" };
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+    db.setWriteAheadLogging(true);
+    db.put(resource, response);
+
+    OfflineDatabase reader("test/fixtures/offline_database/offline.db", OfflineDatabase::ReadOnly());
+    auto res = reader.get(resource);
+    ASSERT_TRUE(bool(res));
+    EXPECT_EQ("data", *res->data);
+    EXPECT_FALSE(bool(reader.get(Resource { Resource::Style, "http://example.com/missing" })));
+
+    // What the writer puts later is read too.
+    Resource other { Resource::Style, "http://example.com/other" };
+    db.put(other, response);
+    EXPECT_TRUE(bool(reader.get(other)));
+
+    EXPECT_ANY_THROW(reader.put(other, response));
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(AccessTimesAreWrittenLater)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+    const std::string path = "test/fixtures/offline_database/offline.db";
+
+    const Resource resource { Resource::Style, "http://example.com/" };
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+
+    auto accessed = [&] {
+        mapbox::sqlite::Database other(path, mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement stmt = other.prepare("SELECT accessed FROM resources");
+        stmt.run();
+        return stmt.get<int64_t>(0);
+    };
+
+    {
+        OfflineDatabase db(path);
+        db.put(resource, response);
+        {
+            mapbox::sqlite::Database other(path, mapbox::sqlite::ReadWrite);
+            other.exec("UPDATE resources SET accessed = 0");
+        }
+
+        // Reading doesn't write...
+        EXPECT_TRUE(bool(db.get(resource)));
+        EXPECT_EQ(0, accessed());
+    }
+
+    // ...until later, at the latest when the database is closed.
+    EXPECT_LT(0, accessed());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ExportImportRegion)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    const std::string path = "test/fixtures/offline_database/export.db";
+
+    OfflineRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
+    OfflineRegionMetadata metadata {{ 1, 2, 3 }};
+
+    const Resource style = Resource::style("http://example.com/style");
+    const Resource tile = Resource::tile("http://example.com/{z}-{x}-{y}.pbf", 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+
+    {
+        OfflineDatabase db(":memory:");
+        OfflineRegion region = db.createRegion(definition, metadata);
+        db.putRegionResource(region.getID(), style, response);
+        db.putRegionResource(region.getID(), tile, response);
+        db.put(Resource::style("http://example.com/ambient"), response);
+        db.exportRegion(region.getID(), path);
+    }
+
+    OfflineDatabase db(":memory:");
+    Response stored;
+    stored.data = std::make_shared<std::string>("stored");
+    db.put(style, stored);
+    db.createRegion(definition, metadata);
+
+    std::vector<OfflineRegion> regions = db.importRegions(path);
+    ASSERT_EQ(1u, regions.size());
+    EXPECT_EQ(2u, db.listRegions().size());
+    EXPECT_EQ(metadata, regions[0].getMetadata());
+    EXPECT_EQ(definition.styleURL, regions[0].getDefinition().styleURL);
+
+    OfflineRegionStatus status = db.getRegionCompletedStatus(regions[0].getID());
+    EXPECT_EQ(2u, status.completedResourceCount);
+    EXPECT_EQ(1u, status.completedTileCount);
+
+    // Resources that were already stored are kept.
+    EXPECT_EQ("stored", *db.get(style)->data);
+    EXPECT_EQ("data", *db.get(tile)->data);
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/ambient"))));
+
+    // Files that aren't offline databases aren't imported.
+    writeFile(path.c_str(), "not a database");
+    EXPECT_ANY_THROW(db.importRegions(path));
+    EXPECT_EQ(2u, db.listRegions().size());
+
+    deleteFile(path.c_str());
+    EXPECT_ANY_THROW(db.importRegions(path));
+}
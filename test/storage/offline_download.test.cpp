@@ -48,14 +48,18 @@ public:
         return db.createRegion(definition, metadata);
     }
 
-    Response response(const std::string& path) {
+    Response response(const std::string& path, const std::string& dictionary = {}) {
         Response result;
         result.data = std::make_shared<std::string>(util::read_file("test/fixtures/offline_download/"s + path));
         size_t uncompressed = result.data->size();
-        size_t compressed = util::compress(*result.data).size();
+        size_t compressed = util::compress(*result.data, dictionary).size();
         size += std::min(uncompressed, compressed);
         return result;
     }
+
+    Response tile(const std::string& path) {
+        return response(path, OfflineDatabase::tileDictionary());
+    }
 };
 
 TEST(OfflineDownload, NoSubresources) {
@@ -118,7 +122,7 @@ TEST(OfflineDownload, InlineSource) {
         EXPECT_EQ(0, tile.x);
         EXPECT_EQ(0, tile.y);
         EXPECT_EQ(0, tile.z);
-        return test.response("0-0-0.vector.pbf");
+        return test.tile("0-0-0.vector.pbf");
     };
 
     auto observer = std::make_unique<MockObserver>();
@@ -212,7 +216,7 @@ TEST(OfflineDownload, Activate) {
         EXPECT_EQ(0, tile.x);
         EXPECT_EQ(0, tile.y);
         EXPECT_EQ(0, tile.z);
-        return test.response("0-0-0.vector.pbf");
+        return test.tile("0-0-0.vector.pbf");
     };
 
     auto observer = std::make_unique<MockObserver>();
@@ -242,6 +246,70 @@ TEST(OfflineDownload, Activate) {
     test.loop.run();
 }
 
+TEST(OfflineDownload, UsedGlyphRanges) {
+    OfflineTest test;
+    OfflineRegion region = test.createRegion();
+    OfflineDownload download(
+        region.getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 0.0, 1.0,
+                                           OfflineRegionGlyphs::Used),
+        test.db, test.fileSource);
+
+    bool tileRequested = false;
+
+    test.fileSource.styleResponse = [&] (const Resource&) {
+        return test.response("style.json");
+    };
+
+    test.fileSource.spriteImageResponse = [&] (const Resource&) {
+        return test.response("sprite.png");
+    };
+
+    test.fileSource.spriteJSONResponse = [&] (const Resource&) {
+        return test.response("sprite.json");
+    };
+
+    std::vector<std::string> glyphRequests;
+    test.fileSource.glyphsResponse = [&] (const Resource& resource) {
+        // Only once the text of the tiles is known.
+        EXPECT_TRUE(tileRequested);
+        glyphRequests.push_back(resource.url);
+        return test.response("glyph.pbf");
+    };
+
+    test.fileSource.sourceResponse = [&] (const Resource&) {
+        return test.response("streets.json");
+    };
+
+    test.fileSource.tileResponse = [&] (const Resource&) {
+        tileRequested = true;
+        return test.tile("0-0-0.vector.pbf");
+    };
+
+    auto observer = std::make_unique<MockObserver>();
+
+    observer->statusChangedFn = [&] (OfflineRegionStatus status) {
+        if (status.complete()) {
+            // The constant text of the symbol layer only needs the first range of its font stack.
+            EXPECT_EQ(6u, status.completedResourceCount);
+            EXPECT_EQ(std::vector<std::string> { "http://127.0.0.1:3000/Helvetica/0-255.pbf" }, glyphRequests);
+            EXPECT_TRUE(status.requiredResourceCountIsPrecise);
+
+            download.setState(OfflineRegionDownloadState::Inactive);
+            OfflineRegionStatus computedStatus = download.getStatus();
+            EXPECT_EQ(status.requiredResourceCount, computedStatus.requiredResourceCount);
+            EXPECT_TRUE(computedStatus.requiredResourceCountIsPrecise);
+
+            test.loop.stop();
+        }
+    };
+
+    download.setObserver(std::move(observer));
+    download.setState(OfflineRegionDownloadState::Active);
+
+    test.loop.run();
+}
+
 TEST(OfflineDownload, DoesNotFloodTheFileSourceWithRequests) {
     FakeFileSource fileSource;
     OfflineTest test;
@@ -457,7 +525,7 @@ TEST(OfflineDownload, TileCountLimitExceededWithTileResponse) {
         EXPECT_EQ(0, tile.x);
         EXPECT_EQ(0, tile.y);
         EXPECT_EQ(0, tile.z);
-        return test.response("0-0-0.vector.pbf");
+        return test.tile("0-0-0.vector.pbf");
     };
 
     auto observer = std::make_unique<MockObserver>();
@@ -502,7 +570,7 @@ TEST(OfflineDownload, WithPreviouslyExistingTile) {
 
     test.db.put(
         Resource::tile("http://127.0.0.1:3000/{z}-{x}-{y}.vector.pbf", 1, 0, 0, 0, Tileset::Scheme::XYZ),
-        test.response("0-0-0.vector.pbf"));
+        test.tile("0-0-0.vector.pbf"));
 
     auto observer = std::make_unique<MockObserver>();
 
@@ -536,7 +604,7 @@ TEST(OfflineDownload, ReactivatePreviouslyCompletedDownload) {
 
     test.db.put(
         Resource::tile("http://127.0.0.1:3000/{z}-{x}-{y}.vector.pbf", 1, 0, 0, 0, Tileset::Scheme::XYZ),
-        test.response("0-0-0.vector.pbf"));
+        test.tile("0-0-0.vector.pbf"));
 
     auto observer = std::make_unique<MockObserver>();
     observer->statusChangedFn = [&] (OfflineRegionStatus status) {
@@ -616,3 +684,53 @@ TEST(OfflineDownload, Deactivate) {
 
     test.loop.run();
 }
+
+TEST(OfflineDownload, Refresh) {
+    OfflineTest test;
+    OfflineRegion region = test.createRegion();
+    OfflineDownload download(
+        region.getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 0.0, 1.0),
+        test.db, test.fileSource);
+
+    const Resource tile = Resource::tile("http://127.0.0.1:3000/{z}-{x}-{y}.vector.pbf", 1, 0, 0, 0, Tileset::Scheme::XYZ);
+    const Timestamp expires = util::now() + Seconds(3600);
+
+    Response style = test.response("inline_source.style.json");
+    style.expires = expires;
+    test.db.putRegionResource(region.getID(), Resource::style("http://127.0.0.1:3000/style.json"), style);
+
+    Response expired = test.tile("0-0-0.vector.pbf");
+    expired.etag = "v1"s;
+    expired.expires = util::now() - Seconds(3600);
+    test.db.putRegionResource(region.getID(), tile, expired);
+
+    // The style is still fresh; only the tile is revalidated.
+    test.fileSource.tileResponse = [&] (const Resource& resource) {
+        EXPECT_EQ("v1", *resource.priorEtag);
+        Response response;
+        response.notModified = true;
+        response.expires = expires;
+        return response;
+    };
+
+    auto observer = std::make_unique<MockObserver>();
+    observer->statusChangedFn = [&] (OfflineRegionStatus status) {
+        if (status.complete()) {
+            EXPECT_EQ(2u, status.completedResourceCount);
+            EXPECT_EQ(test.size, status.completedResourceSize);
+            test.loop.stop();
+        }
+    };
+
+    download.setObserver(std::move(observer));
+    download.refresh();
+
+    test.loop.run();
+
+    auto stored = test.db.get(tile);
+    ASSERT_TRUE(bool(stored));
+    EXPECT_EQ(expires, *stored->expires);
+    EXPECT_EQ("v1", *stored->etag);
+    EXPECT_EQ(util::read_file("test/fixtures/offline_download/0-0-0.vector.pbf"), *stored->data);
+}
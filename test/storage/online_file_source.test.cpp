@@ -1,5 +1,6 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/storage/online_file_source.hpp>
+#include <mbgl/storage/http_file_source.hpp>
 #include <mbgl/storage/network_status.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/run_loop.hpp>
@@ -45,6 +46,77 @@ TEST(OnlineFileSource, TEST_REQUIRES_SERVER(CancelMultiple)) {
     loop.run();
 }
 
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(CoalesceIdentical)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/coalesce" };
+    int responses = 0;
+
+    // The server numbers the requests it gets: every request here shares the first one,
+    // including the ones left after another is cancelled.
+    auto callback = [&](Response res) {
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Response 1", *res.data);
+        if (++responses == 2) {
+            loop.stop();
+        }
+    };
+
+    std::unique_ptr<AsyncRequest> req1 = fs.request(resource, callback);
+    std::unique_ptr<AsyncRequest> req2 = fs.request(resource, [&](Response) {
+        ADD_FAILURE() << "Callback should not be called";
+    });
+    std::unique_ptr<AsyncRequest> req3 = fs.request(resource, callback);
+
+    util::Timer cancel;
+    cancel.start(Milliseconds(20), Duration::zero(), [&] {
+        req2.reset();
+    });
+
+    loop.run();
+    EXPECT_EQ(2, responses);
+}
+
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(Priority)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    // Take up every connection, so that the next requests have to wait.
+    std::vector<std::unique_ptr<AsyncRequest>> delayed;
+    for (uint32_t i = 0; i < HTTPFileSource::maximumConcurrentRequests(); i++) {
+        delayed.push_back(fs.request({ Resource::Unknown, "http://127.0.0.1:3000/delayed?" + std::to_string(i) },
+                                     [&](Response) {}));
+    }
+
+    std::vector<std::string> order;
+    auto request = [&](const std::string& path, Resource::Priority priority) {
+        Resource resource { Resource::Unknown, "http://127.0.0.1:3000/load/" + path };
+        resource.priority = priority;
+        return fs.request(resource, [&, path](Response res) {
+            EXPECT_EQ(nullptr, res.error);
+            order.push_back(path);
+            if (order.size() == 3) {
+                loop.stop();
+            }
+        });
+    };
+
+    auto low = request("1", Resource::Low);
+    auto regular = request("2", Resource::Regular);
+    auto raised = request("3", Resource::Low);
+
+    // Let the requests queue up before raising the priority of one of them.
+    util::Timer timer;
+    timer.start(Milliseconds(50), Duration::zero(), [&] {
+        fs.setPriority(*raised, Resource::Highest);
+    });
+
+    loop.run();
+    EXPECT_EQ((std::vector<std::string> { "3", "2", "1" }), order);
+}
+
 TEST(OnlineFileSource, TEST_REQUIRES_SERVER(TemporaryError)) {
     util::RunLoop loop;
     OnlineFileSource fs;
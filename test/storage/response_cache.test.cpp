@@ -0,0 +1,86 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/storage/response_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+Response makeResponse(const std::string& data) {
+    Response response;
+    response.data = std::make_shared<std::string>(data);
+    return response;
+}
+
+} // namespace
+
+TEST(ResponseCache, Hit) {
+    ResponseCache cache { 1024 * 1024 };
+    const Resource style { Resource::Style, "http://example.com/style.json" };
+
+    EXPECT_FALSE(cache.get(style));
+
+    Response response = makeResponse("{}");
+    cache.put(style, response);
+
+    auto cached = cache.get(style);
+    ASSERT_TRUE(bool(cached));
+    EXPECT_EQ(response.data, cached->data);
+
+    EXPECT_EQ(1u, cache.getStats().hits);
+    EXPECT_EQ(1u, cache.getStats().misses);
+    EXPECT_DOUBLE_EQ(0.5, cache.getStats().hitRate());
+}
+
+TEST(ResponseCache, Expiration) {
+    ResponseCache cache { 1024 * 1024 };
+    const Resource style { Resource::Style, "http://example.com/style.json" };
+
+    // Stale and failed responses aren't kept.
+    Response expired = makeResponse("{}");
+    expired.expires = util::now() - Seconds(1);
+    cache.put(style, expired);
+    EXPECT_FALSE(cache.get(style));
+
+    Response error;
+    error.error = std::make_unique<Response::Error>(Response::Error::Reason::Server);
+    cache.put(style, error);
+    EXPECT_FALSE(cache.get(style));
+    EXPECT_EQ(0u, cache.getSize());
+
+    // A 304 Not Modified response sets the expiration of the cached response.
+    Response fresh = makeResponse("{}");
+    fresh.expires = util::now() + Seconds(100);
+    cache.put(style, fresh);
+    EXPECT_TRUE(bool(cache.get(style)));
+
+    Response notModified;
+    notModified.notModified = true;
+    notModified.expires = util::now() - Seconds(1);
+    cache.put(style, notModified);
+    EXPECT_FALSE(cache.get(style));
+    EXPECT_EQ(0u, cache.getSize());
+}
+
+TEST(ResponseCache, EvictsLeastRecentlyUsed) {
+    ResponseCache cache { 1024 * 1024 };
+    const Resource a { Resource::Style, "http://example.com/a.json" };
+    const Resource b { Resource::Style, "http://example.com/b.json" };
+
+    cache.put(a, makeResponse(std::string(1000, 'a')));
+    cache.put(b, makeResponse(std::string(1000, 'b')));
+    const std::size_t size = cache.getSize();
+
+    // Using "a" leaves "b" as the one to go once the cache is over its size.
+    EXPECT_TRUE(bool(cache.get(a)));
+    cache.setMaximumSize(size - 1);
+    EXPECT_TRUE(bool(cache.get(a)));
+    EXPECT_FALSE(cache.get(b));
+    EXPECT_EQ(size / 2, cache.getSize());
+
+    cache.clear();
+    EXPECT_FALSE(cache.get(a));
+    EXPECT_EQ(0u, cache.getSize());
+}
@@ -164,6 +164,13 @@ app.get('/delayed', function(req, res) {
     }, 200);
 });
 
+var coalesceCounter = 0;
+app.get('/coalesce', function(req, res) {
+    var current = ++coalesceCounter;
+    setTimeout(function() {
+        res.status(200).send('Response ' + current);
+    }, 100);
+});
 
 app.get('/load/:number(\\d+)', function(req, res) {
     res.send('Request ' + req.params.number);
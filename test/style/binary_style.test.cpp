@@ -0,0 +1,85 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/binary_style.hpp>
+#include <mbgl/style/parser.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <rapidjson/document.h>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+TEST(BinaryStyle, RoundTrip) {
+    const std::string json = util::read_file("test/fixtures/style_parser/font_stacks.json");
+    const std::string binary = encodeBinaryStyle(json);
+    ASSERT_TRUE(isBinaryStyle(binary));
+    EXPECT_FALSE(isBinaryStyle(json));
+
+    JSDocument expected;
+    expected.Parse<0>(json.c_str());
+
+    JSDocument decoded;
+    EXPECT_FALSE(decodeBinaryStyle(binary, decoded));
+    EXPECT_TRUE(expected == decoded);
+}
+
+TEST(BinaryStyle, Numbers) {
+    const std::string binary = encodeBinaryStyle("[0, 1, -1, 4294967296, -9007199254740993, 1.0, 0.1, 1e300]");
+
+    JSDocument document;
+    decodeBinaryStyle(binary, document);
+    ASSERT_TRUE(document.IsArray());
+    ASSERT_EQ(8u, document.Size());
+    EXPECT_TRUE(document[0].IsUint());
+    EXPECT_EQ(-1, document[2].GetInt());
+    EXPECT_EQ(4294967296u, document[3].GetUint64());
+    EXPECT_EQ(-9007199254740993, document[4].GetInt64());
+    EXPECT_TRUE(document[5].IsDouble());
+    EXPECT_EQ(0.1, document[6].GetDouble());
+    EXPECT_EQ(1e300, document[7].GetDouble());
+}
+
+TEST(BinaryStyle, Parse) {
+    const std::string json = util::read_file("test/fixtures/style_parser/font_stacks.json");
+
+    Parser text;
+    ASSERT_FALSE(text.parse(json));
+
+    Parser binary;
+    ASSERT_FALSE(binary.parse(encodeBinaryStyle(json)));
+    EXPECT_EQ(text.sources.size(), binary.sources.size());
+    EXPECT_EQ(text.layers.size(), binary.layers.size());
+    EXPECT_EQ(text.fontStacks(), binary.fontStacks());
+}
+
+TEST(BinaryStyle, OtherVersion) {
+    const std::string json = util::read_file("test/fixtures/style_parser/font_stacks.json");
+    std::string binary = encodeBinaryStyle(json);
+    binary[4]++;
+
+    JSDocument document;
+    auto fallback = decodeBinaryStyle(binary, document);
+    ASSERT_TRUE(bool(fallback));
+    EXPECT_EQ(json, *fallback);
+
+    Parser parser;
+    ASSERT_FALSE(parser.parse(binary));
+    EXPECT_EQ(3u, parser.fontStacks().size());
+}
+
+TEST(BinaryStyle, Malformed) {
+    const std::string binary = encodeBinaryStyle("{\"version\": 8, \"layers\": []}");
+
+    // Every truncation of the document is rejected.
+    const std::size_t end = 12 + uint8_t(binary[8]);
+    for (std::size_t length = 12; length < end; ++length) {
+        std::string truncated = binary.substr(0, length);
+        truncated[8] = char(length - 12);
+        truncated[9] = truncated[10] = truncated[11] = 0;
+        JSDocument document;
+        EXPECT_ANY_THROW(decodeBinaryStyle(truncated, document));
+    }
+
+    Parser parser;
+    EXPECT_TRUE(bool(parser.parse(binary.substr(0, 20))));
+}
@@ -66,3 +66,23 @@ TEST(GeoJSONOptions, FullConversion) {
     ASSERT_EQ(converted.clusterRadius, 4);
     ASSERT_EQ(converted.clusterMaxZoom, 5);
 }
+
+TEST(GeoJSONOptions, ClusterProperties) {
+    ValueMap properties {
+        {"total", ValueVector { std::string("+"), ValueVector { std::string("get"), std::string("value") } }},
+        {"lowest", ValueVector { std::string("min"), ValueVector { std::string("get"), std::string("rank") } }}
+    };
+    ValueMap map {{"clusterProperties", properties}};
+    GeoJSONOptions converted = *convert<GeoJSONOptions>(Value(map));
+
+    ASSERT_EQ(2u, converted.clusterProperties.size());
+    EXPECT_EQ(GeoJSONOptions::ClusterProperty::Operator::Sum, converted.clusterProperties.at("total").op);
+    EXPECT_EQ("value", converted.clusterProperties.at("total").property);
+    EXPECT_EQ(GeoJSONOptions::ClusterProperty::Operator::Min, converted.clusterProperties.at("lowest").op);
+    EXPECT_EQ("rank", converted.clusterProperties.at("lowest").property);
+
+    ValueMap invalid {{"clusterProperties", ValueMap {
+        {"total", ValueVector { std::string("*"), ValueVector { std::string("get"), std::string("value") } }}
+    }}};
+    EXPECT_FALSE((bool) convert<GeoJSONOptions>(Value(invalid)));
+}
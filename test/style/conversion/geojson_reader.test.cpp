@@ -0,0 +1,71 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/conversion/geojson.hpp>
+#include <mbgl/style/conversion/geojson_reader.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+#include <stdexcept>
+
+using namespace mbgl;
+using namespace mbgl::style::conversion;
+
+namespace {
+
+Result<GeoJSON> convertDocument(const std::string& json) {
+    JSDocument document;
+    document.Parse<0>(json.c_str());
+    return convertGeoJSON<JSValue>(document);
+}
+
+} // namespace
+
+TEST(GeoJSONReader, MatchesDocument) {
+    const std::string inputs[] = {
+        R"({ "type": "FeatureCollection", "features": [
+            { "type": "Feature", "id": 1, "properties": { "name": "a", "tags": [1, true, null] },
+              "geometry": { "type": "Point", "coordinates": [1, 2] } },
+            { "type": "Feature", "id": "b", "properties": { "nested": { "x": -1.5 } },
+              "geometry": { "type": "Polygon", "coordinates": [[[0, 0], [1, 0], [1, 1], [0, 0]]] } }
+        ] })",
+        // `type` after `features`.
+        R"({ "features": [ { "type": "Feature", "properties": {},
+            "geometry": { "type": "LineString", "coordinates": [[0, 0], [1, 1]] } } ],
+            "type": "FeatureCollection" })",
+        R"({ "type": "FeatureCollection", "features": [] })",
+        R"({ "type": "Feature", "properties": { "features": [] },
+            "geometry": { "type": "MultiPoint", "coordinates": [[0, 0], [1, 1]] } })",
+        R"({ "type": "GeometryCollection", "geometries": [
+            { "type": "Point", "coordinates": [0, 0] } ] })",
+    };
+
+    for (const auto& input : inputs) {
+        Result<GeoJSON> expected = convertDocument(input);
+        Result<GeoJSON> actual = parseGeoJSON(input);
+        ASSERT_TRUE(bool(expected)) << input;
+        ASSERT_TRUE(bool(actual)) << input;
+        EXPECT_TRUE(*expected == *actual) << input;
+    }
+}
+
+TEST(GeoJSONReader, InvalidGeoJSON) {
+    const std::string inputs[] = {
+        R"({ "type": "FeatureCollection" })",
+        R"({ "type": "FeatureCollection", "features": [ { "type": "Feature" } ] })",
+        R"({ "type": "FeatureCollection", "features": [ 1 ] })",
+        R"({ "features": [] })",
+        R"([])",
+    };
+
+    for (const auto& input : inputs) {
+        Result<GeoJSON> expected = convertDocument(input);
+        Result<GeoJSON> actual = parseGeoJSON(input);
+        ASSERT_FALSE(bool(expected)) << input;
+        ASSERT_FALSE(bool(actual)) << input;
+        EXPECT_EQ(expected.error().message, actual.error().message) << input;
+    }
+}
+
+TEST(GeoJSONReader, InvalidJSON) {
+    EXPECT_THROW(parseGeoJSON(R"({ "type": "FeatureCollection", "features": [ )"), std::runtime_error);
+    EXPECT_THROW(parseGeoJSON(""), std::runtime_error);
+}
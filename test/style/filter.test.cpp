@@ -3,6 +3,7 @@
 #include <mbgl/util/geometry.hpp>
 
 #include <mbgl/style/filter.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/filter_evaluator.hpp>
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion.hpp>
@@ -123,3 +124,72 @@ TEST(Filter, ID) {
 
     ASSERT_FALSE(parse("[\"==\", \"$id\", 1234]")(feature2));
 }
+
+TEST(Filter, Compiled) {
+    const std::vector<Feature> features = {
+        feature({{}}),
+        feature({{ "foo", std::string("bar") }}),
+        feature({{ "foo", std::string("baz") }, { "n", int64_t(3) }}, LineString<double>()),
+        feature({{ "foo", int64_t(1) }, { "n", uint64_t(18446744073709551615ull) }}, Polygon<double>()),
+        feature({{ "foo", uint64_t(1) }, { "n", double(2.5) }}),
+        feature({{ "foo", double(1) }, { "n", false }}, LineString<double>()),
+        feature({{ "foo", true }, { "bar", std::string("1") }}, Polygon<double>()),
+    };
+
+    const std::vector<const char*> filters = {
+        R"(["==", "foo", "bar"])",
+        R"(["!=", "foo", 1])",
+        R"(["<", "n", 3])",
+        R"([">=", "n", 2.5])",
+        R"(["in", "foo", "baz", 1, true])",
+        R"(["in", "n", 18446744073709551615, 3])",
+        R"(["!in", "foo", "bar", false, 1.0])",
+        R"(["in", "$type", "LineString", "Polygon"])",
+        R"(["!=", "$type", "Point"])",
+        R"(["!in", "$type", "Point"])",
+        R"(["all", ["has", "n"], ["==", "$type", "LineString"], ["!has", "bar"]])",
+        R"(["any", ["==", "foo", true], ["in", "foo", "bar", "baz"], ["==", "$type", "Polygon"]])",
+        R"(["none", ["<", "n", 3], ["==", "foo", 1]])",
+        R"(["all", ["any"], ["all"], ["none"]])",
+        R"(["any", ["all", ["==", "foo", 1], [">", "n", 2]], ["!has", "foo"]])",
+        R"(["all", ["==", "a", 1], ["==", "b", 1], ["==", "c", 1], ["==", "d", 1], ["==", "e", 1],
+                   ["==", "f", 1], ["==", "g", 1], ["==", "h", 1], ["!has", "i"], ["has", "foo"]])",
+    };
+
+    for (const auto expression : filters) {
+        const Filter filter = parse(expression);
+        const CompiledFilter compiled(filter);
+
+        for (const auto& f : features) {
+            const FeatureType type = apply_visitor(ToFeatureType(), f.geometry);
+            auto accessor = [&] (const std::string& key) -> optional<Value> {
+                auto it = f.properties.find(key);
+                if (it == f.properties.end())
+                    return {};
+                return it->second;
+            };
+            EXPECT_EQ(filter(type, f.id, accessor), compiled(type, f.id, accessor)) << expression;
+        }
+    }
+
+    EXPECT_TRUE(CompiledFilter()(FeatureType::Point, {}, [] (const std::string&) { return optional<Value>(); }));
+}
+
+TEST(Filter, CompiledID) {
+    Feature feature1 { Point<double>() };
+    feature1.id = { uint64_t(1234) };
+    Feature feature2 { Point<double>() };
+
+    auto compiled = [] (const char* expression, const Feature& f) {
+        return CompiledFilter(parse(expression))(FeatureType::Point, f.id, [] (const std::string&) {
+            return optional<Value>();
+        });
+    };
+
+    ASSERT_TRUE(compiled(R"(["==", "$id", 1234])", feature1));
+    ASSERT_FALSE(compiled(R"(["==", "$id", "1234"])", feature1));
+    ASSERT_TRUE(compiled(R"(["in", "$id", 1, 1234])", feature1));
+    ASSERT_FALSE(compiled(R"(["in", "$id", 1, 1234])", feature2));
+    ASSERT_TRUE(compiled(R"(["!in", "$id", 1, 1234])", feature2));
+    ASSERT_TRUE(compiled(R"(["!has", "$id"])", feature2));
+}
@@ -0,0 +1,48 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/style/function/composite_function.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+static StubGeometryTileFeature five {
+    PropertyMap {{ "property", uint64_t(5) }}
+};
+
+TEST(CompositeFunction, ExponentialStops) {
+    CompositeFunction<float> fn("property", CompositeExponentialStops<float>({
+        { 0.0f, {{ 0.0f, 0.0f }, { 10.0f, 10.0f }} },
+        { 10.0f, {{ 0.0f, 10.0f }, { 10.0f, 20.0f }} }
+    }));
+
+    EXPECT_EQ(5.0f, fn.evaluate(0.0f, five, 0.0f));
+    EXPECT_EQ(10.0f, fn.evaluate(5.0f, five, 0.0f));
+    EXPECT_EQ(15.0f, fn.evaluate(10.0f, five, 0.0f));
+
+    auto ranges = fn.coveringRanges(5.0f);
+    EXPECT_EQ(0.0f, std::get<0>(ranges).min);
+    EXPECT_EQ(10.0f, std::get<0>(ranges).max);
+}
+
+TEST(CompositeFunction, IntervalStops) {
+    CompositeFunction<float> fn("property", CompositeIntervalStops<float>({
+        { 0.0f, {{ 0.0f, 1.0f }, { 10.0f, 2.0f }} },
+        { 10.0f, {{ 0.0f, 3.0f }, { 10.0f, 4.0f }} }
+    }));
+
+    EXPECT_EQ(1.0f, fn.evaluate(0.0f, five, 0.0f));
+    EXPECT_EQ(2.0f, fn.evaluate(5.0f, five, 0.0f));
+    EXPECT_EQ(3.0f, fn.evaluate(10.0f, five, 0.0f));
+}
+
+TEST(CompositeFunction, CategoricalStops) {
+    CompositeFunction<float> fn("property", CompositeCategoricalStops<float>({
+        { 0.0f, {{ int64_t(5), 1.0f }} },
+        { 10.0f, {{ int64_t(5), 3.0f }} }
+    }));
+
+    EXPECT_EQ(1.0f, fn.evaluate(0.0f, five, 0.0f));
+    EXPECT_EQ(2.0f, fn.evaluate(5.0f, five, 0.0f));
+    EXPECT_EQ(3.0f, fn.evaluate(10.0f, five, 0.0f));
+}
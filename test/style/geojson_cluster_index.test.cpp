@@ -0,0 +1,49 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/sources/geojson_cluster_index.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+Feature point(double longitude, double latitude, double value) {
+    Feature feature { Point<double> { longitude, latitude } };
+    feature.properties["value"] = value;
+    return feature;
+}
+
+} // namespace
+
+TEST(GeoJSONClusterIndex, ReducesProperties) {
+    GeoJSONOptions options;
+    options.cluster = true;
+    options.clusterProperties.emplace("total", GeoJSONOptions::ClusterProperty { GeoJSONOptions::ClusterProperty::Operator::Sum, "value" });
+    options.clusterProperties.emplace("highest", GeoJSONOptions::ClusterProperty { GeoJSONOptions::ClusterProperty::Operator::Max, "value" });
+
+    FeatureCollection features {
+        point(10, 10, 1),
+        point(10.001, 10.001, 2),
+        point(10.002, 10, 4),
+        point(-100, -40, 8)
+    };
+    features.push_back(Feature { Point<double> { -100.001, -40 } });
+
+    GeoJSONClusterIndex index { features, options };
+
+    // At zoom 0, the points close to each other are clustered.
+    const auto tile = index.getTile(0, 0, 0);
+    ASSERT_EQ(2u, tile.size());
+    for (const auto& feature : tile) {
+        ASSERT_TRUE(feature.properties.count("cluster"));
+        const uint64_t count = feature.properties.at("point_count").get<uint64_t>();
+        if (count == 3) {
+            EXPECT_EQ(7.0, feature.properties.at("total").get<double>());
+            EXPECT_EQ(4.0, feature.properties.at("highest").get<double>());
+        } else {
+            // Points without the property are left out.
+            EXPECT_EQ(2u, count);
+            EXPECT_EQ(8.0, feature.properties.at("total").get<double>());
+        }
+    }
+}
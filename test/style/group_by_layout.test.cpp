@@ -1,6 +1,7 @@
 #include <mbgl/test/util.hpp>
 
 #include <mbgl/style/group_by_layout.hpp>
+#include <mbgl/style/layer_impl.hpp>
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/style/layers/circle_layer.hpp>
 #include <mbgl/style/layers/line_layer.hpp>
@@ -42,3 +43,21 @@ TEST(GroupByLayout, UnrelatedLayout) {
     auto result = groupByLayout(layers);
     ASSERT_EQ(2u, result.size());
 }
+
+TEST(GroupByLayout, KeyPerRevision) {
+    auto layer = std::make_unique<LineLayer>("a", "source");
+    const LayoutKey key = layoutKey(*layer);
+    EXPECT_EQ(&layoutKey(*layer), &layoutKey(*layer));
+
+    // Clones keep the key made for their revision.
+    auto clone = layer->baseImpl->clone();
+    EXPECT_EQ(key, layoutKey(*clone));
+
+    layer->setLineCap(LineCapType::Square);
+    layer->baseImpl->bumpRevision();
+    EXPECT_NE(key.key, layoutKey(*layer).key);
+    EXPECT_FALSE(layoutKey(*layer) == layoutKey(*clone));
+
+    layer->setSourceLayer("b");
+    EXPECT_NE(std::string::npos, layoutKey(*layer).key.find("\"b\""));
+}
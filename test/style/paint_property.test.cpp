@@ -1,4 +1,5 @@
 #include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
 
 #include <mbgl/style/paint_property.hpp>
 
@@ -86,3 +87,41 @@ TEST(UnevaluatedPaintProperty, EvaluateTransitionedConstantWithDelay) {
     ASSERT_FLOAT_EQ(0.823099f, evaluate(t1, 1500ms));
     ASSERT_FLOAT_EQ(1.0f, evaluate(t1, 2500ms));
 }
+
+namespace {
+
+// Points to its values, like vector tile features do.
+class SharingFeature : public StubGeometryTileFeature {
+public:
+    using StubGeometryTileFeature::StubGeometryTileFeature;
+
+    const Value* findValue(const std::string& key, optional<Value>&) const override {
+        auto it = properties.find(key);
+        return it == properties.end() ? nullptr : &it->second;
+    }
+};
+
+} // namespace
+
+TEST(PaintPropertyEvaluationCache, EvaluatesSharedValuesOnce) {
+    SharingFeature sharing { PropertyMap {{ "property", 1.0 }} };
+    StubGeometryTileFeature copying { PropertyMap {{ "property", 1.0 }} };
+
+    PaintPropertyEvaluationCache<float> cache;
+    std::size_t evaluations = 0;
+    auto evaluate = [&] (const Value* value) {
+        evaluations++;
+        return value ? float(*numericValue<float>(*value)) : 0.0f;
+    };
+
+    EXPECT_EQ(1.0f, cache.get(sharing, "property", evaluate));
+    EXPECT_EQ(1.0f, cache.get(sharing, "property", evaluate));
+    EXPECT_EQ(1u, evaluations);
+
+    EXPECT_EQ(1.0f, cache.get(copying, "property", evaluate));
+    EXPECT_EQ(1.0f, cache.get(copying, "property", evaluate));
+    EXPECT_EQ(3u, evaluations);
+
+    EXPECT_EQ(0.0f, cache.get(sharing, "missing", evaluate));
+    EXPECT_EQ(4u, evaluations);
+}
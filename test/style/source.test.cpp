@@ -17,6 +17,8 @@
 #include <mbgl/map/transform.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/update_parameters.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/tile/tile.hpp>
 #include <mbgl/style/layers/line_layer.hpp>
 #include <mbgl/annotation/annotation_manager.hpp>
 
@@ -33,7 +35,7 @@ public:
     TransformState transformState;
     ThreadPool threadPool { 1 };
     AnnotationManager annotationManager { 1.0 };
-    style::Style style { fileSource, 1.0 };
+    style::Style style { threadPool, fileSource, 1.0 };
 
     style::UpdateParameters updateParameters {
         1.0,
@@ -85,7 +87,7 @@ TEST(Source, LoadingFail) {
 
     VectorSource source("source", "url");
     source.baseImpl->setObserver(&test.observer);
-    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
 
     test.run();
 }
@@ -108,7 +110,7 @@ TEST(Source, LoadingCorrupt) {
 
     VectorSource source("source", "url");
     source.baseImpl->setObserver(&test.observer);
-    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
 
     test.run();
 }
@@ -136,7 +138,7 @@ TEST(Source, RasterTileEmpty) {
 
     RasterSource source("source", tileset, 512);
     source.baseImpl->setObserver(&test.observer);
-    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
     source.baseImpl->updateTiles(test.updateParameters);
 
     test.run();
@@ -165,12 +167,95 @@ TEST(Source, VectorTileEmpty) {
 
     VectorSource source("source", tileset);
     source.baseImpl->setObserver(&test.observer);
-    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
     source.baseImpl->updateTiles(test.updateParameters);
 
     test.run();
 }
 
+TEST(Source, RenderTilesKeptWhileUnchanged) {
+    SourceTest test;
+
+    test.fileSource.tileResponse = [&] (const Resource&) {
+        Response response;
+        response.noContent = true;
+        return response;
+    };
+
+    Tileset tileset;
+    tileset.tiles = { "tiles" };
+
+    VectorSource source("source", tileset);
+
+    test.observer.tileChanged = [&] (Source&, const OverscaledTileID&) {
+        auto& impl = *source.baseImpl;
+        impl.updateTiles(test.updateParameters);
+        if (impl.getRenderTiles().empty()) {
+            // Not renderable yet.
+            return;
+        }
+
+        const RenderTile* renderTile = &impl.getRenderTiles().begin()->second;
+        const uint64_t revision = impl.getRenderTilesRevision();
+
+        impl.updateTiles(test.updateParameters);
+        EXPECT_EQ(revision, impl.getRenderTilesRevision());
+        EXPECT_EQ(renderTile, &impl.getRenderTiles().begin()->second);
+
+        impl.removeTiles();
+        EXPECT_TRUE(impl.getRenderTiles().empty());
+        EXPECT_NE(revision, impl.getRenderTilesRevision());
+
+        test.end();
+    };
+
+    source.baseImpl->setObserver(&test.observer);
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
+    source.baseImpl->updateTiles(test.updateParameters);
+
+    test.run();
+}
+
+TEST(Source, VectorTilePrefetch) {
+    SourceTest test;
+
+    const std::string data = util::read_file("test/fixtures/resources/vector.tile");
+    std::set<CanonicalTileID> requested;
+    test.fileSource.tileResponse = [&] (const Resource& resource) {
+        requested.emplace(resource.tileData->z, resource.tileData->x, resource.tileData->y);
+        Response response;
+        response.data = std::make_shared<std::string>(data);
+        return response;
+    };
+
+    Tileset tileset;
+    tileset.tiles = { "tiles" };
+
+    VectorSource source("source", tileset);
+    auto& impl = *source.baseImpl;
+
+    // Once the root tile is loaded, its children are loaded, but not rendered.
+    size_t prefetchedBytes = 0;
+    test.updateParameters.prefetchBytes = std::numeric_limits<size_t>::max();
+    test.observer.tileChanged = [&] (Source&, const OverscaledTileID&) {
+        impl.updateTiles(test.updateParameters);
+        EXPECT_LE(impl.getRenderTiles().size(), 1u);
+
+        prefetchedBytes += impl.takePrefetchedBytes();
+        if (prefetchedBytes == 4 * data.size()) {
+            EXPECT_EQ(5u, requested.size());
+            EXPECT_TRUE(impl.isLoaded());
+            test.end();
+        }
+    };
+
+    impl.setObserver(&test.observer);
+    impl.loadDescription(test.fileSource, test.threadPool);
+    impl.updateTiles(test.updateParameters);
+
+    test.run();
+}
+
 TEST(Source, RasterTileFail) {
     SourceTest test;
 
@@ -194,7 +279,7 @@ TEST(Source, RasterTileFail) {
 
     RasterSource source("source", tileset, 512);
     source.baseImpl->setObserver(&test.observer);
-    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
     source.baseImpl->updateTiles(test.updateParameters);
 
     test.run();
@@ -223,7 +308,7 @@ TEST(Source, VectorTileFail) {
 
     VectorSource source("source", tileset);
     source.baseImpl->setObserver(&test.observer);
-    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
     source.baseImpl->updateTiles(test.updateParameters);
 
     test.run();
@@ -251,7 +336,7 @@ TEST(Source, RasterTileCorrupt) {
 
     RasterSource source("source", tileset, 512);
     source.baseImpl->setObserver(&test.observer);
-    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
     source.baseImpl->updateTiles(test.updateParameters);
 
     test.run();
@@ -283,7 +368,7 @@ TEST(Source, VectorTileCorrupt) {
 
     VectorSource source("source", tileset);
     source.baseImpl->setObserver(&test.observer);
-    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
     source.baseImpl->updateTiles(test.updateParameters);
 
     test.run();
@@ -310,7 +395,7 @@ TEST(Source, RasterTileCancel) {
 
     RasterSource source("source", tileset, 512);
     source.baseImpl->setObserver(&test.observer);
-    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
     source.baseImpl->updateTiles(test.updateParameters);
 
     test.run();
@@ -337,7 +422,7 @@ TEST(Source, VectorTileCancel) {
 
     VectorSource source("source", tileset);
     source.baseImpl->setObserver(&test.observer);
-    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
     source.baseImpl->updateTiles(test.updateParameters);
 
     test.run();
@@ -376,7 +461,7 @@ TEST(Source, RasterTileAttribution) {
 
     RasterSource source("source", "url", 512);
     source.baseImpl->setObserver(&test.observer);
-    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
     source.baseImpl->updateTiles(test.updateParameters);
 
     test.run();
@@ -405,7 +490,7 @@ TEST(Source, GeoJSonSourceUrlUpdate) {
     source.baseImpl->setObserver(&test.observer);
 
     // Load initial, so the source state will be loaded=true
-    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
 
     // Schedule an update
     test.loop.invoke([&] () {
@@ -415,3 +500,114 @@ TEST(Source, GeoJSonSourceUrlUpdate) {
 
     test.run();
 }
+
+TEST(Source, GeoJSONSourceIndexesOnWorker) {
+    SourceTest test;
+
+    GeoJSONSource source("source");
+    source.baseImpl->setObserver(&test.observer);
+    source.setGeoJSON(mapbox::geojson::geometry{ mapbox::geometry::point<double>{ 1.1, 1.1 } });
+
+    // The index is built on the worker, so the source isn't loaded until it arrives.
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
+    EXPECT_FALSE(source.baseImpl->isLoaded());
+
+    test.observer.sourceLoaded = [&] (Source& source_) {
+        EXPECT_EQ(&source, &source_);
+        EXPECT_TRUE(source.baseImpl->isLoaded());
+        test.end();
+    };
+
+    test.run();
+}
+
+TEST(Source, GeoJSONSourceSlicesTilesOnWorker) {
+    SourceTest test;
+
+    GeoJSONSource source("source");
+    source.baseImpl->setObserver(&test.observer);
+    source.setGeoJSON(mapbox::geojson::geometry{ mapbox::geometry::point<double>{ 1.1, 1.1 } });
+
+    test.observer.sourceLoaded = [&] (Source&) {
+        // Tiles are created without their features, which the worker sends them later.
+        source.baseImpl->updateTiles(test.updateParameters);
+        EXPECT_FALSE(source.baseImpl->isLoaded());
+        EXPECT_TRUE(source.baseImpl->getRenderTiles().empty());
+    };
+
+    test.observer.tileChanged = [&] (Source&, const OverscaledTileID&) {
+        if (source.baseImpl->isLoaded()) {
+            source.baseImpl->updateTiles(test.updateParameters);
+            EXPECT_EQ(1u, source.baseImpl->getRenderTiles().size());
+            test.end();
+        }
+    };
+
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
+
+    test.run();
+}
+
+TEST(Source, GeoJSONSourceUpdatesTouchedTiles) {
+    SourceTest test;
+    test.transform.setLatLngZoom({ 0, 0 }, 1);
+    test.transformState = test.transform.getState();
+
+    // Two points near the middle of each zoom 1 tile.
+    FeatureCollection features;
+    uint64_t id = 0;
+    for (double longitude : { -90.0, 90.0 }) {
+        for (double latitude : { -45.0, 45.0 }) {
+            for (double offset : { 0.0, 5.0 }) {
+                Feature feature { mapbox::geometry::point<double> { longitude + offset, latitude } };
+                feature.id = ++id;
+                features.push_back(feature);
+            }
+        }
+    }
+
+    GeoJSONSource source("source");
+    source.baseImpl->setObserver(&test.observer);
+    source.setGeoJSON(features);
+
+    const OverscaledTileID touched { 1, 0, 0 };
+    bool updated = false;
+
+    test.observer.sourceLoaded = [&] (Source&) {
+        source.baseImpl->updateTiles(test.updateParameters);
+    };
+
+    test.observer.tileChanged = [&] (Source&, const OverscaledTileID& tileID) {
+        if (!updated) {
+            if (source.baseImpl->isLoaded()) {
+                // Now that every tile is renderable, they are all render tiles.
+                source.baseImpl->updateTiles(test.updateParameters);
+
+                // Move the first point within the north western tile.
+                Feature moved { mapbox::geometry::point<double> { -100, 50 } };
+                moved.id = uint64_t(1);
+                source.updateFeatures({ moved });
+                updated = true;
+            }
+            return;
+        }
+
+        ASSERT_EQ(touched, tileID);
+
+        auto& renderTiles = source.baseImpl->getRenderTiles();
+        EXPECT_EQ(4u, renderTiles.size());
+        for (auto& pair : renderTiles) {
+            if (pair.second.tile.id == touched && !pair.second.tile.isComplete()) {
+                return;
+            }
+        }
+        for (auto& pair : renderTiles) {
+            EXPECT_TRUE(pair.second.tile.isComplete());
+        }
+        test.end();
+    };
+
+    source.baseImpl->loadDescription(test.fileSource, test.threadPool);
+
+    test.run();
+}
@@ -1,11 +1,15 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/test/stub_file_source.hpp>
+#include <mbgl/test/stub_style_observer.hpp>
 
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/source_impl.hpp>
 #include <mbgl/style/sources/vector_source.hpp>
 #include <mbgl/style/layer.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/util/io.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/run_loop.hpp>
 
 #include <memory>
@@ -16,8 +20,9 @@ using namespace mbgl::style;
 TEST(Style, UnusedSource) {
     util::RunLoop loop;
 
+    ThreadPool threadPool { 1 };
     StubFileSource fileSource;
-    Style style { fileSource, 1.0 };
+    Style style { threadPool, fileSource, 1.0 };
 
     auto now = Clock::now();
 
@@ -53,8 +58,9 @@ TEST(Style, UnusedSource) {
 TEST(Style, UnusedSourceActiveViaClassUpdate) {
     util::RunLoop loop;
 
+    ThreadPool threadPool { 1 };
     StubFileSource fileSource;
-    Style style { fileSource, 1.0 };
+    Style style { threadPool, fileSource, 1.0 };
 
     style.setJSON(util::read_file("test/fixtures/resources/style-unused-sources.json"));
     EXPECT_TRUE(style.addClass("visible"));
@@ -86,8 +92,9 @@ TEST(Style, UnusedSourceActiveViaClassUpdate) {
 TEST(Style, Properties) {
     util::RunLoop loop;
 
+    ThreadPool threadPool { 1 };
     StubFileSource fileSource;
-    Style style { fileSource, 1.0 };
+    Style style { threadPool, fileSource, 1.0 };
 
     style.setJSON(R"STYLE({"name": "Test"})STYLE");
     ASSERT_EQ("Test", style.getName());
@@ -120,8 +127,9 @@ TEST(Style, Properties) {
 TEST(Style, DuplicateSource) {
     util::RunLoop loop;
 
+    ThreadPool threadPool { 1 };
     StubFileSource fileSource;
-    Style style { fileSource, 1.0 };
+    Style style { threadPool, fileSource, 1.0 };
 
     style.setJSON(util::read_file("test/fixtures/resources/style-unused-sources.json"));
 
@@ -134,3 +142,103 @@ TEST(Style, DuplicateSource) {
         // Expected
     }
 }
+
+TEST(Style, UpdateJSON) {
+    util::RunLoop loop;
+
+    ThreadPool threadPool { 1 };
+    StubFileSource fileSource;
+    Style style { threadPool, fileSource, 1.0 };
+
+    const std::string day = R"STYLE({
+        "version": 8,
+        "sources": {
+            "streets": { "type": "vector", "tiles": ["http://example.com/streets/{z}-{x}-{y}.pbf"] },
+            "terrain": { "type": "vector", "tiles": ["http://example.com/terrain/{z}-{x}-{y}.pbf"] }
+        },
+        "layers": [
+            { "id": "water", "type": "fill", "source": "streets", "source-layer": "water", "paint": { "fill-color": "#ffffff" } },
+            { "id": "roads", "type": "line", "source": "streets", "source-layer": "roads" },
+            { "id": "contours", "type": "line", "source": "terrain", "source-layer": "contours" }
+        ]
+    })STYLE";
+
+    const std::string night = R"STYLE({
+        "version": 8,
+        "sources": {
+            "streets": { "type": "vector", "tiles": ["http://example.com/streets/{z}-{x}-{y}.pbf"] }
+        },
+        "layers": [
+            { "id": "roads", "type": "line", "source": "streets", "source-layer": "roads" },
+            { "id": "water", "type": "fill", "source": "streets", "source-layer": "water", "paint": { "fill-color": "#000000" } }
+        ]
+    })STYLE";
+
+    // Only a loaded style is updated.
+    EXPECT_FALSE(style.updateJSON(night));
+
+    style.setJSON(day);
+    const Source* streets = style.getSource("streets");
+    const Layer* roads = style.getLayer("roads");
+
+    ASSERT_TRUE(style.updateJSON(night));
+    EXPECT_EQ(streets, style.getSource("streets"));
+    EXPECT_FALSE(style.getSource("terrain"));
+
+    auto layers = style.getLayers();
+    ASSERT_EQ(2u, layers.size());
+    EXPECT_EQ(roads, layers[0]);
+    EXPECT_EQ("water", layers[1]->getID());
+    EXPECT_EQ(DataDrivenPropertyValue<Color>(Color::black()), layers[1]->as<FillLayer>()->getFillColor());
+
+    // A layer changed since isn't kept.
+    style.getLayer("roads")->setVisibility(VisibilityType::None);
+    ASSERT_TRUE(style.updateJSON(night));
+    EXPECT_EQ(VisibilityType::Visible, style.getLayer("roads")->getVisibility());
+    EXPECT_EQ(streets, style.getSource("streets"));
+
+    // Neither is a style that doesn't parse, or loads glyphs from elsewhere.
+    EXPECT_FALSE(style.updateJSON("invalid"));
+    EXPECT_FALSE(style.updateJSON(R"STYLE({ "version": 8, "glyphs": "http://example.com/{fontstack}/{range}.pbf" })STYLE"));
+    EXPECT_EQ(2u, style.getLayers().size());
+}
+
+TEST(Style, UpdateBatch) {
+    util::RunLoop loop;
+
+    ThreadPool threadPool { 1 };
+    StubFileSource fileSource;
+    Style style { threadPool, fileSource, 1.0 };
+    style.setJSON(util::read_file("test/fixtures/resources/style-unused-sources.json"));
+
+    std::size_t updates = 0;
+    Update flags = Update::Nothing;
+
+    StubStyleObserver observer;
+    observer.update = [&] (Update update) {
+        updates++;
+        flags |= update;
+    };
+    style.setObserver(&observer);
+
+    style.beginUpdateBatch();
+    style.getLayer("usedlayer")->setVisibility(VisibilityType::None);
+    style.beginUpdateBatch();
+    style.getLayer("classylayer")->as<SymbolLayer>()->setIconOpacity(0.5f);
+    style.getLayer("unusedlayervisibility")->as<SymbolLayer>()->setFilter(NullFilter());
+    style.endUpdateBatch();
+    EXPECT_EQ(0u, updates);
+
+    style.endUpdateBatch();
+    EXPECT_EQ(1u, updates);
+    EXPECT_TRUE(flags & Update::Layout);
+    EXPECT_TRUE(flags & Update::Classes);
+
+    // An unmatched end changes nothing.
+    style.endUpdateBatch();
+    EXPECT_EQ(1u, updates);
+
+    style.getLayer("usedlayer")->setVisibility(VisibilityType::Visible);
+    style.getLayer("classylayer")->as<SymbolLayer>()->setIconOpacity(1.0f);
+    EXPECT_EQ(3u, updates);
+}
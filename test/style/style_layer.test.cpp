@@ -2,6 +2,8 @@
 #include <mbgl/test/stub_layer_observer.hpp>
 #include <mbgl/test/stub_file_source.hpp>
 #include <mbgl/style/style.hpp>
+#include <mbgl/style/cascade_parameters.hpp>
+#include <mbgl/style/property_evaluation_parameters.hpp>
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/style/layers/background_layer_impl.hpp>
 #include <mbgl/style/layers/circle_layer.hpp>
@@ -17,6 +19,7 @@
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/util/color.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/io.hpp>
 
@@ -279,8 +282,9 @@ TEST(Layer, DuplicateLayer) {
     util::RunLoop loop;
 
     // Setup style
+    ThreadPool threadPool { 1 };
     StubFileSource fileSource;
-    Style style { fileSource, 1.0 };
+    Style style { threadPool, fileSource, 1.0 };
     style.setJSON(util::read_file("test/fixtures/resources/style-unused-sources.json"));
 
     // Add initial layer
@@ -296,3 +300,72 @@ TEST(Layer, DuplicateLayer) {
     }
 }
 
+TEST(Layer, Revision) {
+    util::RunLoop loop;
+
+    ThreadPool threadPool { 1 };
+    StubFileSource fileSource;
+    Style style { threadPool, fileSource, 1.0 };
+    style.setJSON(util::read_file("test/fixtures/resources/style-unused-sources.json"));
+
+    style.addLayer(std::make_unique<LineLayer>("line", "unusedsource"));
+    auto layer = style.getLayer("line")->as<LineLayer>();
+
+    // Clones made for tile workers keep the revision.
+    const uint64_t initial = layer->baseImpl->revision;
+    EXPECT_EQ(initial, layer->baseImpl->clone()->baseImpl->revision);
+    EXPECT_NE(initial, std::make_unique<LineLayer>("line", "unusedsource")->baseImpl->revision);
+
+    // Changes that buckets depend on bump it.
+    layer->setFilter(EqualsFilter { "foo", std::string("bar") });
+    const uint64_t filtered = layer->baseImpl->revision;
+    EXPECT_NE(initial, filtered);
+
+    layer->setLineCap(lineCap);
+    EXPECT_NE(filtered, layer->baseImpl->revision);
+
+    const uint64_t laidOut = layer->baseImpl->revision;
+    layer->setLineWidth(width);
+    EXPECT_NE(laidOut, layer->baseImpl->revision);
+
+    // No-op changes don't.
+    const uint64_t painted = layer->baseImpl->revision;
+    layer->setLineWidth(width);
+    EXPECT_EQ(painted, layer->baseImpl->revision);
+}
+
+TEST(Layer, Reevaluate) {
+    auto layer = std::make_unique<BackgroundLayer>("background");
+    layer->setBackgroundOpacity(CameraFunction<float>(ExponentialStops<float>({ { 0, 0 }, { 10, 1 } })));
+
+    const TimePoint now { Duration::zero() };
+    layer->baseImpl->cascade({ { ClassID::Default }, now, TransitionOptions() });
+
+    auto evaluate = [&] (float z) {
+        ZoomHistory zoomHistory;
+        zoomHistory.update(z, now);
+        return layer->baseImpl->reevaluate({ z, now, zoomHistory, Duration::zero() });
+    };
+
+    EXPECT_FALSE(evaluate(5));
+    EXPECT_FLOAT_EQ(0.5f, layer->impl->paint.evaluated.get<BackgroundOpacity>());
+
+    // The same zoom keeps the evaluated properties.
+    layer->impl->paint.evaluated.get<BackgroundOpacity>() = 0.0f;
+    evaluate(5);
+    EXPECT_EQ(0.0f, layer->impl->paint.evaluated.get<BackgroundOpacity>());
+
+    // Another zoom, a new cascade, or a new revision doesn't.
+    evaluate(6);
+    EXPECT_FLOAT_EQ(0.6f, layer->impl->paint.evaluated.get<BackgroundOpacity>());
+
+    layer->impl->paint.evaluated.get<BackgroundOpacity>() = 0.0f;
+    layer->baseImpl->invalidateEvaluation();
+    evaluate(6);
+    EXPECT_FLOAT_EQ(0.6f, layer->impl->paint.evaluated.get<BackgroundOpacity>());
+
+    layer->impl->paint.evaluated.get<BackgroundOpacity>() = 0.0f;
+    layer->baseImpl->bumpRevision();
+    evaluate(6);
+    EXPECT_FLOAT_EQ(0.6f, layer->impl->paint.evaluated.get<BackgroundOpacity>());
+}
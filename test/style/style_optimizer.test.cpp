@@ -0,0 +1,80 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/style_optimizer.hpp>
+#include <mbgl/style/parser.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+const char* styleJSON = R"STYLE({
+    "version": 8,
+    "sources": {
+        "streets": { "type": "vector", "tiles": [ "http://example.com/{z}/{x}/{y}.pbf" ], "minzoom": 10 }
+    },
+    "layers": [{
+        "id": "roads", "type": "line", "source": "streets", "source-layer": "road",
+        "layout": { "line-cap": { "stops": [[5, "round"], [10, "round"]] } },
+        "paint": {
+            "line-width": { "stops": [[10, 2]] },
+            "line-opacity": { "stops": [[10, 0.5], [15, 1]] }
+        }
+    }, {
+        "id": "water", "type": "fill", "source": "streets", "source-layer": "water",
+        "paint": { "fill-color": { "base": 1.5, "stops": [[0, "#00f"], [20, "#00f"]] } }
+    }, {
+        "id": "empty-range", "type": "fill", "source": "streets", "source-layer": "water",
+        "minzoom": 14, "maxzoom": 12
+    }, {
+        "id": "below-source", "type": "fill", "source": "streets", "source-layer": "water",
+        "maxzoom": 8
+    }, {
+        "id": "no-matches", "type": "fill", "source": "streets", "source-layer": "water",
+        "filter": [ "all", [ "==", "class", "lake" ], [ "in", "class" ] ]
+    }, {
+        "id": "hidden", "type": "fill", "source": "streets", "source-layer": "water",
+        "layout": { "visibility": "none" }
+    }]
+})STYLE";
+
+} // namespace
+
+TEST(StyleOptimizer, FoldsConstantFunctions) {
+    Parser parser;
+    ASSERT_FALSE(parser.parse(styleJSON));
+    const StyleOptimization result = optimize(parser.layers, parser.sources);
+    EXPECT_EQ(3u, result.foldedFunctions);
+
+    const LineLayer& roads = *parser.layers[0]->as<LineLayer>();
+    ASSERT_TRUE(roads.getLineCap().isConstant());
+    EXPECT_EQ(LineCapType::Round, roads.getLineCap().asConstant());
+    ASSERT_TRUE(roads.getLineWidth().isConstant());
+    EXPECT_EQ(2.0f, roads.getLineWidth().asConstant());
+    EXPECT_EQ(DataDrivenPropertyValue<float>(CameraFunction<float>(ExponentialStops<float>({ { 10, 0.5f }, { 15, 1.0f } }))),
+              roads.getLineOpacity());
+
+    EXPECT_EQ(DataDrivenPropertyValue<Color>(Color::blue()), parser.layers[1]->as<FillLayer>()->getFillColor());
+}
+
+TEST(StyleOptimizer, MarksLayersThatRenderNothing) {
+    Parser parser;
+    ASSERT_FALSE(parser.parse(styleJSON));
+    const StyleOptimization result = optimize(parser.layers, parser.sources);
+    EXPECT_EQ(3u, result.inertLayers);
+
+    EXPECT_FALSE(parser.layers[0]->baseImpl->rendersNothing);
+    EXPECT_FALSE(parser.layers[1]->baseImpl->rendersNothing);
+    EXPECT_TRUE(parser.layers[2]->baseImpl->rendersNothing);
+    EXPECT_TRUE(parser.layers[3]->baseImpl->rendersNothing);
+    EXPECT_TRUE(parser.layers[4]->baseImpl->rendersNothing);
+    EXPECT_FALSE(parser.layers[5]->baseImpl->rendersNothing);
+    EXPECT_FALSE(parser.layers[2]->baseImpl->needsRendering(13));
+
+    // Changing a layer may let it render again.
+    parser.layers[2]->setMinZoom(10);
+    EXPECT_FALSE(parser.layers[2]->baseImpl->rendersNothing);
+}
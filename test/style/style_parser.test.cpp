@@ -3,6 +3,7 @@
 
 #include <mbgl/style/parser.hpp>
 #include <mbgl/util/io.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/enum.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/tileset.hpp>
@@ -102,3 +103,26 @@ TEST(StyleParser, FontStacks) {
     ASSERT_EQ(FontStack({"a", "b"}), result[1]);
     ASSERT_EQ(FontStack({"a", "b", "c"}), result[2]);
 }
+
+TEST(StyleParser, ParallelLayers) {
+    ThreadPool threadPool { 4 };
+
+    for (const auto& file : { "test/fixtures/resources/style_vector.json",
+                              "test/fixtures/resources/style-unused-sources.json" }) {
+        const std::string json = util::read_file(file);
+
+        style::Parser serial;
+        ASSERT_FALSE(serial.parse(json));
+
+        style::Parser parallel { threadPool };
+        ASSERT_FALSE(parallel.parse(json));
+
+        ASSERT_EQ(serial.layers.size(), parallel.layers.size());
+        for (std::size_t i = 0; i < serial.layers.size(); ++i) {
+            EXPECT_EQ(serial.layers[i]->getID(), parallel.layers[i]->getID());
+            EXPECT_EQ(serial.layers[i]->getVisibility(), parallel.layers[i]->getVisibility());
+        }
+        EXPECT_EQ(serial.layerDefinitions, parallel.layerDefinitions);
+        EXPECT_EQ(serial.fontStacks(), parallel.fontStacks());
+    }
+}
@@ -0,0 +1,27 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/bidi.hpp>
+
+using namespace mbgl;
+
+using Lines = std::vector<std::u16string>;
+
+TEST(BiDi, LeftToRight) {
+    BiDi bidi;
+    EXPECT_EQ((Lines { u"Main ", u"Street" }), bidi.processText(u"Main Street", { 5 }));
+    EXPECT_EQ((Lines { u"Église ", u"(Saint-Éloi)" }), bidi.processText(u"Église (Saint-Éloi)", { 7 }));
+
+    // Newlines end paragraphs.
+    EXPECT_EQ((Lines { u"Main\n", u"Street" }), bidi.processText(u"Main\nStreet", {}));
+    EXPECT_EQ((Lines { u"" }), bidi.processText(u"", {}));
+
+    EXPECT_EQ(u"Main Street", applyArabicShaping(u"Main Street"));
+}
+
+TEST(BiDi, RightToLeft) {
+    BiDi bidi;
+    EXPECT_EQ((Lines { u"םולש" }), bidi.processText(u"שלום", {}));
+
+    // Brackets are mirrored in right-to-left runs.
+    EXPECT_EQ((Lines { u"x (בא)" }), bidi.processText(u"(אב) x", {}));
+}
@@ -0,0 +1,94 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/text/collision_grid.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace mbgl;
+
+using Grid = CollisionGrid<int>;
+
+namespace {
+
+std::vector<int> query(const Grid& grid, const Grid::BBox& bbox) {
+    std::vector<int> result;
+    grid.query(bbox, [&] (const Grid::Entry& entry) {
+        result.push_back(entry.value);
+        return true;
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // namespace
+
+TEST(CollisionGrid, ReportsEachBoxOnce) {
+    Grid grid({ 0, 0, 100, 100 }, 10);
+    grid.insert(0, { 5, 5, 95, 95 });
+    grid.insert(1, { 50, 50, 51, 51 });
+    grid.insert(2, { 80, 10, 90, 20 });
+
+    EXPECT_EQ((std::vector<int> { 0, 1 }), query(grid, { 40, 40, 60, 60 }));
+    EXPECT_EQ((std::vector<int> { 0, 1, 2 }), query(grid, { 0, 0, 100, 100 }));
+    EXPECT_EQ((std::vector<int> { 0 }), query(grid, { 20, 20, 30, 30 }));
+    EXPECT_EQ((std::vector<int> {}), query(grid, { 96, 96, 99, 99 }));
+
+    // Touching boxes intersect.
+    EXPECT_EQ((std::vector<int> { 0, 2 }), query(grid, { 90, 20, 92, 22 }));
+}
+
+TEST(CollisionGrid, KeepsBoxesOutsideOfBounds) {
+    Grid grid({ 0, 0, 100, 100 }, 4);
+    grid.insert(0, { -500, -500, -400, -400 });
+    grid.insert(1, { 150, -20, 300, 120 });
+
+    EXPECT_EQ((std::vector<int> { 0 }), query(grid, { -450, -450, -450, -450 }));
+    EXPECT_EQ((std::vector<int> {}), query(grid, { -300, -300, -200, -200 }));
+    EXPECT_EQ((std::vector<int> { 1 }), query(grid, { 200, 50, 1000, 60 }));
+    EXPECT_EQ((std::vector<int> { 0, 1 }), query(grid, { -1000, -1000, 1000, 1000 }));
+}
+
+TEST(CollisionGrid, StopsQuery) {
+    Grid grid({ 0, 0, 100, 100 }, 4);
+    for (int i = 0; i < 10; ++i) {
+        grid.insert(i, { 0, 0, 100, 100 });
+    }
+
+    int calls = 0;
+    EXPECT_FALSE(grid.query({ 10, 10, 20, 20 }, [&] (const Grid::Entry&) {
+        return ++calls < 3;
+    }));
+    EXPECT_EQ(3, calls);
+}
+
+TEST(CollisionGrid, MatchesBruteForce) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> position(-200, 1200);
+    std::uniform_real_distribution<float> size(0, 150);
+
+    auto randomBox = [&] {
+        const float x = position(generator);
+        const float y = position(generator);
+        return Grid::BBox { x, y, x + size(generator), y + size(generator) };
+    };
+
+    Grid grid({ 0, 0, 1000, 1000 }, 16);
+    std::vector<Grid::BBox> boxes;
+    for (int i = 0; i < 500; ++i) {
+        boxes.push_back(randomBox());
+        grid.insert(i, boxes.back());
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        const Grid::BBox bbox = randomBox();
+        std::vector<int> expected;
+        for (int j = 0; j < int(boxes.size()); ++j) {
+            if (boxes[j].x1 <= bbox.x2 && boxes[j].y1 <= bbox.y2 &&
+                boxes[j].x2 >= bbox.x1 && boxes[j].y2 >= bbox.y1) {
+                expected.push_back(j);
+            }
+        }
+        EXPECT_EQ(expected, query(grid, bbox));
+    }
+}
@@ -7,6 +7,7 @@
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/io.hpp>
+#include <mbgl/util/local_glyph_rasterizer.hpp>
 #include <mbgl/util/logging.hpp>
 
 using namespace mbgl;
@@ -175,3 +176,97 @@ TEST(GlyphAtlas, InvalidSDFGlyph) {
     ASSERT_EQ((Rect<uint16_t>{ 0, 0, 0, 0 }), positions[67].rect);
 
 }
+
+TEST(GlyphAtlas, Prefetch) {
+    GlyphAtlasTest test;
+
+    std::size_t requests = 0;
+    test.fileSource.glyphsResponse = [&] (const Resource&) {
+        requests++;
+        Response response;
+        response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        return response;
+    };
+
+    // Ranges tiles asked for are prefetched along with the configured ones.
+    test.glyphAtlas.setURL("test/fixtures/resources/glyphs.pbf");
+    test.glyphAtlas.setObserver(&test.observer);
+    test.glyphAtlas.hasGlyphRanges({{"Test Stack"}}, {{256, 511}});
+    EXPECT_EQ(1u, (test.glyphAtlas.getGlyphRangeUsage()[{256, 511}]));
+
+    test.observer.glyphsLoaded = [&] (const FontStack&, const GlyphRange&) {
+        // No tile needs to wait for the ranges of the other stack.
+        if (test.glyphAtlas.hasGlyphRanges({{"Other Stack"}}, {{0, 255}, {256, 511}})) {
+            test.end();
+        }
+    };
+
+    test.glyphAtlas.prefetchGlyphRanges({ {"Test Stack"}, {"Other Stack"} });
+    test.loop.run();
+
+    // Each range of each stack is requested once.
+    EXPECT_EQ(4u, requests);
+}
+
+TEST(GlyphAtlas, LocalGlyphs) {
+    GlyphAtlasTest test;
+
+    class SquareRasterizer : public LocalGlyphRasterizer {
+    public:
+        optional<Glyph> rasterize(const FontStack&, char16_t id) override {
+            // Only the first ideograph has pixels.
+            Glyph glyph;
+            if (id == 0x4E00) {
+                glyph.image = AlphaImage({ 10, 10 });
+                glyph.image.fill(255);
+            }
+            glyph.top = 20;
+            glyph.advance = 24;
+            return glyph;
+        }
+    };
+
+    std::size_t requests = 0;
+    test.fileSource.glyphsResponse = [&] (const Resource&) {
+        requests++;
+        Response response;
+        response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        return response;
+    };
+
+    test.glyphAtlas.setLocalGlyphRasterizer(std::make_shared<SquareRasterizer>());
+
+    test.observer.glyphsLoaded = [&] (const FontStack&, const GlyphRange&) {
+        if (test.glyphAtlas.hasGlyphRanges({{"Test Stack"}}, {{0, 255}, {0x4E00, 0x4EFF}})) {
+            test.end();
+        }
+    };
+
+    test.run(
+        "test/fixtures/resources/glyphs.pbf",
+        {{"Test Stack"}},
+        {{0, 255}, {0x4E00, 0x4EFF}});
+
+    // Only the range outside of the ideographs is requested.
+    EXPECT_EQ(1u, requests);
+
+    auto glyphSet = test.glyphAtlas.getGlyphSet({{"Test Stack"}});
+    const auto& sdfs = glyphSet->getSDFs();
+    ASSERT_EQ(1u, sdfs.count(0x4E01));
+    EXPECT_FALSE(sdfs.at(0x4E01).bitmap.valid());
+    EXPECT_EQ(24u, sdfs.at(0x4E01).metrics.advance);
+
+    ASSERT_EQ(1u, sdfs.count(0x4E00));
+    const SDFGlyph& glyph = sdfs.at(0x4E00);
+    EXPECT_EQ(10u, glyph.metrics.width);
+    EXPECT_EQ(20, glyph.metrics.top);
+    ASSERT_EQ((Size{ 16, 16 }), glyph.bitmap.size);
+
+    // Inside, on the edge, and outside of the square.
+    const uint8_t* sdf = glyph.bitmap.data();
+    EXPECT_EQ(255, sdf[8 * 16 + 8]);
+    EXPECT_GT(sdf[8 * 16 + 3], 191);
+    EXPECT_LT(sdf[8 * 16 + 2], 191);
+    EXPECT_EQ(sdf[8 * 16 + 2], sdf[2 * 16 + 8]);
+    EXPECT_LT(sdf[0], sdf[8 * 16]);
+}
@@ -0,0 +1,82 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_file_source.hpp>
+#include <mbgl/test/stub_style_observer.hpp>
+
+#include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/text/glyph_cache.hpp>
+#include <mbgl/text/glyph_set.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+std::shared_ptr<const GlyphCache::Glyphs> makeGlyphs(uint32_t count) {
+    auto glyphs = std::make_shared<GlyphCache::Glyphs>(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        (*glyphs)[i].id = i;
+        (*glyphs)[i].bitmap = AlphaImage({ 10, 10 });
+    }
+    return glyphs;
+}
+
+} // namespace
+
+TEST(GlyphCache, EvictsLeastRecentlyUsed) {
+    GlyphCache cache { 1024 * 1024 };
+
+    cache.put("a", makeGlyphs(10));
+    cache.put("b", makeGlyphs(10));
+    const std::size_t size = cache.getSize();
+    EXPECT_LT(2000u, size);
+
+    // Using "a" leaves "b" as the one to go once the cache is over its size.
+    EXPECT_TRUE(cache.get("a"));
+    cache.setMaximumSize(size - 1);
+    EXPECT_TRUE(cache.get("a"));
+    EXPECT_FALSE(cache.get("b"));
+    EXPECT_EQ(size / 2, cache.getSize());
+
+    cache.clear();
+    EXPECT_FALSE(cache.get("a"));
+    EXPECT_EQ(0u, cache.getSize());
+}
+
+TEST(GlyphCache, SharedBetweenAtlases) {
+    util::RunLoop loop;
+    StubFileSource fileSource;
+    StubStyleObserver observer;
+    GlyphCache cache { 1024 * 1024 };
+
+    std::size_t requests = 0;
+    fileSource.glyphsResponse = [&] (const Resource&) {
+        ++requests;
+        Response response;
+        response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        return response;
+    };
+
+    auto load = [&] (GlyphAtlas& atlas) {
+        atlas.setObserver(&observer);
+        atlas.setURL("test/fixtures/resources/glyphs.pbf");
+        observer.glyphsLoaded = [&] (const FontStack&, const GlyphRange&) {
+            loop.stop();
+        };
+        atlas.hasGlyphRanges({{ "Test Stack" }}, { { 0, 255 } });
+        loop.run();
+        EXPECT_TRUE(atlas.hasGlyphRanges({{ "Test Stack" }}, { { 0, 255 } }));
+        EXPECT_FALSE(atlas.getGlyphSet({{ "Test Stack" }})->getSDFs().empty());
+    };
+
+    GlyphAtlas first { { 32, 32 }, fileSource, &cache };
+    load(first);
+    EXPECT_EQ(1u, requests);
+
+    // A second atlas gets the same glyphs without a request.
+    GlyphAtlas second { { 32, 32 }, fileSource, &cache };
+    load(second);
+    EXPECT_EQ(1u, requests);
+    EXPECT_EQ(first.getGlyphSet({{ "Test Stack" }})->getSDFs().size(),
+              second.getGlyphSet({{ "Test Stack" }})->getSDFs().size());
+}
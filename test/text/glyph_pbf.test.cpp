@@ -5,6 +5,7 @@
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/glyph_pbf.hpp>
 #include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/string.hpp>
 
@@ -71,3 +72,36 @@ TEST(GlyphPBF, Parsing) {
 
     loop.run();
 }
+
+TEST(GlyphPBF, ParsingOnScheduler) {
+    util::RunLoop loop;
+    ThreadPool threadPool { 1 };
+    DefaultFileSource fileSource{ ":memory:", "." };
+    GlyphAtlas glyphAtlas{ { 1024, 1024 }, fileSource, nullptr, &threadPool };
+    FontStack fontStack{ "fake_glyphs" };
+    GlyphRange glyphRange{ 0, 255 };
+
+    glyphAtlas.setURL("asset://test/fixtures/resources/{fontstack}-{range}.pbf");
+
+    MockGlyphAtlasObserver glyphAtlasObserver;
+    glyphAtlasObserver.glyphsLoaded = [&](const FontStack&, const GlyphRange&) {
+        loop.stop();
+
+        const auto& sdfs = glyphAtlas.getGlyphSet(fontStack)->getSDFs();
+        ASSERT_EQ(1u, sdfs.size());
+
+        // The bitmap is only copied out of the response when it's needed.
+        AlphaImage expected({7, 7});
+        expected.fill('x');
+        EXPECT_EQ(expected, sdfs.at(69).bitmap.materialize());
+    };
+
+    glyphAtlasObserver.glyphsError = [&](const FontStack&, const GlyphRange&, std::exception_ptr error) {
+        loop.stop();
+        FAIL() << util::toString(error);
+    };
+
+    GlyphPBF pbf(&glyphAtlas, fontStack, glyphRange, &glyphAtlasObserver, fileSource);
+
+    loop.run();
+}
@@ -0,0 +1,90 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/shaping_cache.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+ShapingCache::Key makeKey(std::u16string text, WritingModeType writingMode = WritingModeType::Horizontal) {
+    return ShapingCache::Key {
+        std::move(text), { "Open Sans Regular" }, 240.0f, 28.8f, 0.5f, 0.5f, 0.5f, 0.0f, { 0.0f, 0.0f }, 24.0f, writingMode
+    };
+}
+
+Shaping makeShaping(uint32_t glyphs) {
+    Shaping shaping { 0, 0, WritingModeType::Horizontal };
+    for (uint32_t i = 0; i < glyphs; ++i) {
+        shaping.positionedGlyphs.emplace_back(i, i * 10.0f, 0.0f, 0.0f);
+    }
+    return shaping;
+}
+
+} // namespace
+
+TEST(ShapingCache, Hit) {
+    ShapingCache cache { 1024 * 1024 };
+
+    EXPECT_FALSE(cache.get(makeKey(u"Broadway")));
+    cache.put(makeKey(u"Broadway"), makeShaping(8));
+
+    auto shaping = cache.get(makeKey(u"Broadway"));
+    ASSERT_TRUE(bool(shaping));
+    EXPECT_EQ(8u, shaping->positionedGlyphs.size());
+    EXPECT_EQ(70.0f, shaping->positionedGlyphs.back().x);
+
+    // Any difference in layout is a different shaping.
+    EXPECT_FALSE(cache.get(makeKey(u"Broadway", WritingModeType::Vertical)));
+    auto key = makeKey(u"Broadway");
+    key.fontStack = { "Open Sans Bold" };
+    EXPECT_FALSE(cache.get(key));
+
+    EXPECT_EQ(1u, cache.getStats().hits);
+    EXPECT_EQ(3u, cache.getStats().misses);
+    EXPECT_DOUBLE_EQ(0.25, cache.getStats().hitRate());
+}
+
+TEST(ShapingCache, EvictsLeastRecentlyUsed) {
+    ShapingCache cache { 1024 * 1024 };
+
+    cache.put(makeKey(u"a"), makeShaping(10));
+    cache.put(makeKey(u"b"), makeShaping(10));
+    const std::size_t size = cache.getSize();
+
+    // Using "a" leaves "b" as the one to go once the cache is over its size.
+    EXPECT_TRUE(bool(cache.get(makeKey(u"a"))));
+    cache.setMaximumSize(size - 1);
+    EXPECT_TRUE(bool(cache.get(makeKey(u"a"))));
+    EXPECT_FALSE(cache.get(makeKey(u"b")));
+    EXPECT_EQ(size / 2, cache.getSize());
+
+    cache.clear();
+    EXPECT_FALSE(cache.get(makeKey(u"a")));
+    EXPECT_EQ(0u, cache.getSize());
+}
+
+TEST(ShapingCache, ThreadSafe) {
+    ShapingCache cache { 16 * 1024 };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (char16_t i = 0; i < 500; ++i) {
+                const std::u16string text(1, u'a' + i % 50);
+                if (!cache.get(makeKey(text))) {
+                    cache.put(makeKey(text), makeShaping(5));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto stats = cache.getStats();
+    EXPECT_EQ(2000u, stats.hits + stats.misses);
+    EXPECT_LE(cache.getSize(), 16u * 1024);
+}
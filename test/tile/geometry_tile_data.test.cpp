@@ -105,3 +105,108 @@ TEST(GeometryTileData, limitHoles3) {
     ASSERT_EQ(original.at(3), polygon.at(2));
 
 }
+
+TEST(GeometryTileData, GeometryBuffer) {
+    const GeometryCollection collection = {
+      { {0, 0}, {0, 40}, {40, 40}, {40, 0}, {0, 0} },
+      { {10, 10}, {20, 10}, {20, 20}, {10, 10} },
+      { {100, 100}, {100, 140}, {140, 140}, {100, 100} }
+    };
+
+    GeometryBuffer buffer;
+    buffer.assign(collection);
+
+    ASSERT_EQ(buffer.size(), 3u);
+    ASSERT_EQ(buffer[1].size(), 4u);
+    ASSERT_EQ(buffer[1][0].x, 10);
+    ASSERT_EQ(buffer.toCollection(), collection);
+
+    std::vector<GeometryPolygonView> polygons = classifyRings(buffer);
+
+    // output: 2 polygons, the first with 1 exterior and 1 interior
+    ASSERT_EQ(polygons.size(), 2u);
+    ASSERT_EQ(polygons[0].size(), 2u);
+    ASSERT_EQ(polygons[1].size(), 1u);
+
+    limitHoles(polygons[0], 0);
+    ASSERT_EQ(polygons[0].size(), 1u);
+
+    buffer.clear();
+    buffer.addRing();
+    buffer.addPoint({ 1, 2 });
+    buffer.addRing();
+    ASSERT_EQ(buffer.size(), 2u);
+    ASSERT_EQ(buffer[0].size(), 1u);
+    ASSERT_TRUE(buffer[1].empty());
+}
+
+TEST(GeometryTileData, GeometryBufferSimplify) {
+    GeometryBuffer buffer;
+    buffer.assign({
+        // A line with a slight bend, and one with a sharp one.
+        { {0, 0}, {10, 1}, {20, 0}, {30, 1}, {40, 0} },
+        { {0, 0}, {10, 20}, {20, 0} },
+        // Too short to simplify.
+        { {0, 0}, {100, 0} }
+    });
+
+    buffer.simplify(2, false);
+    EXPECT_EQ((GeometryCollection {
+        { {0, 0}, {40, 0} },
+        { {0, 0}, {10, 20}, {20, 0} },
+        { {0, 0}, {100, 0} }
+    }), buffer.toCollection());
+
+    const GeometryCollection polygon = {
+        // A square with a point on one side, and a hole that would collapse.
+        { {0, 0}, {20, 1}, {40, 0}, {40, 40}, {0, 40}, {0, 0} },
+        { {10, 10}, {11, 10}, {11, 11}, {10, 11}, {10, 10} }
+    };
+    buffer.assign(polygon);
+
+    buffer.simplify(2, true);
+    EXPECT_EQ((GeometryCollection {
+        { {0, 0}, {40, 0}, {40, 40}, {0, 40}, {0, 0} },
+        polygon[1]
+    }), buffer.toCollection());
+}
+
+TEST(GeometryTileData, isValidPolygon) {
+    const GeometryCollection valid = {
+      { {0, 0}, {40, 0}, {40, 40}, {0, 40}, {0, 0} },
+      { {10, 10}, {20, 10}, {20, 20}, {10, 10} }
+    };
+    EXPECT_TRUE(isValidPolygon(valid));
+    EXPECT_EQ(valid, fixupPolygons(valid));
+
+    // Mis-wound.
+    const GeometryCollection reversed = {
+      { {0, 0}, {0, 40}, {40, 40}, {40, 0}, {0, 0} }
+    };
+    EXPECT_FALSE(isValidPolygon(reversed));
+    const GeometryCollection fixed = fixupPolygons(reversed);
+    ASSERT_EQ(1u, fixed.size());
+    EXPECT_GT(_signedArea(fixed[0]), 0);
+
+    // Self-intersecting.
+    EXPECT_FALSE(isValidPolygon({
+      { {0, 0}, {40, 40}, {40, 0}, {0, 40}, {0, 0} }
+    }));
+
+    // A hole outside of its exterior ring, and touching it.
+    EXPECT_FALSE(isValidPolygon({
+      { {0, 0}, {40, 0}, {40, 40}, {0, 40}, {0, 0} },
+      { {50, 10}, {60, 10}, {60, 20}, {50, 10} }
+    }));
+    EXPECT_FALSE(isValidPolygon({
+      { {0, 0}, {40, 0}, {40, 40}, {0, 40}, {0, 0} },
+      { {0, 0}, {20, 10}, {20, 20}, {0, 0} }
+    }));
+
+    // A polygon within the hole of another.
+    EXPECT_TRUE(isValidPolygon({
+      { {0, 0}, {40, 0}, {40, 40}, {0, 40}, {0, 0} },
+      { {5, 5}, {5, 35}, {35, 35}, {35, 5}, {5, 5} },
+      { {10, 10}, {30, 10}, {30, 30}, {10, 30}, {10, 10} }
+    }));
+}
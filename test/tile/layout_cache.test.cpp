@@ -0,0 +1,93 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/layout_cache.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/string.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+const std::string directory = "test/fixtures/offline_database";
+
+void removeEntry(const std::string& key) {
+    try {
+        util::deleteFile(directory + "/" +
+            util::toString(LayoutCache::hash(key.data(), key.size()) % LayoutCache::files) + ".layout");
+    } catch (const util::IOException&) {
+    }
+}
+
+} // namespace
+
+TEST(LayoutCache, PutGet) {
+    LayoutCache cache { directory };
+    removeEntry("a");
+
+    EXPECT_FALSE(cache.get("a"));
+
+    const std::string value("\0\1\2", 3);
+    cache.put("a", value);
+    ASSERT_TRUE(bool(cache.get("a")));
+    EXPECT_EQ(value, *cache.get("a"));
+
+    // Other processes find the entry too.
+    EXPECT_EQ(value, *LayoutCache(directory).get("a"));
+
+    cache.put("a", "b");
+    EXPECT_EQ("b", *cache.get("a"));
+
+    removeEntry("a");
+}
+
+TEST(LayoutCache, KeyMismatch) {
+    LayoutCache cache { directory };
+
+    // Find another key that goes to the same file.
+    const uint64_t file = LayoutCache::hash("a", 1) % LayoutCache::files;
+    std::string other;
+    for (uint32_t i = 0; other.empty(); i++) {
+        const std::string key = util::toString(i);
+        if (LayoutCache::hash(key.data(), key.size()) % LayoutCache::files == file) {
+            other = key;
+        }
+    }
+
+    cache.put("a", "value");
+    EXPECT_FALSE(cache.get(other));
+
+    // It takes the file over.
+    cache.put(other, "other");
+    EXPECT_FALSE(cache.get("a"));
+    EXPECT_EQ("other", *cache.get(other));
+
+    removeEntry("a");
+}
+
+TEST(LayoutCache, ReadWrite) {
+    struct Vertex {
+        int16_t x, y;
+    };
+
+    LayoutWriter writer;
+    writer.write(true);
+    const std::vector<Vertex> vertices { { 1, 2 }, { 3, 4 } };
+    writer.writeArray(vertices.data(), vertices.size());
+
+    LayoutReader reader(writer.data);
+    bool flag = false;
+    std::vector<Vertex> read;
+    ASSERT_TRUE(reader.read(flag));
+    ASSERT_TRUE(reader.readArray(read));
+    EXPECT_TRUE(flag);
+    ASSERT_EQ(2u, read.size());
+    EXPECT_EQ(3, read[1].x);
+    EXPECT_TRUE(reader.atEnd());
+    EXPECT_FALSE(reader.read(flag));
+
+    // Truncated entries fail to read.
+    const std::string truncated = writer.data.substr(0, writer.data.size() - 1);
+    LayoutReader truncatedReader(truncated);
+    ASSERT_TRUE(truncatedReader.read(flag));
+    EXPECT_FALSE(truncatedReader.readArray(read));
+}
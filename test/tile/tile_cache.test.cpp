@@ -0,0 +1,104 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/tile.hpp>
+#include <mbgl/tile/tile_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+class StubTile : public Tile {
+public:
+    StubTile(const OverscaledTileID& id_, std::size_t bytes_, std::size_t retained_ = 0)
+        : Tile(id_), bytes(bytes_), retained(retained_) {
+        availableData = DataAvailability::All;
+    }
+
+    void setNecessity(Necessity) override {}
+    void cancel() override {}
+    Bucket* getBucket(const style::Layer&) override { return nullptr; }
+    std::size_t getByteSize() const override { return bytes; }
+
+    std::size_t releaseRetainedData() override {
+        const std::size_t result = retained;
+        retained = 0;
+        return result;
+    }
+
+private:
+    const std::size_t bytes;
+    std::size_t retained;
+};
+
+std::unique_ptr<Tile> makeTile(uint32_t x, std::size_t bytes, std::size_t retained = 0) {
+    return std::make_unique<StubTile>(OverscaledTileID { 4, x, 0 }, bytes, retained);
+}
+
+} // namespace
+
+TEST(TileCache, EvictsOldestOverSize) {
+    TileCache cache { 2 };
+
+    cache.add({ 4, 0, 0 }, makeTile(0, 100));
+    cache.add({ 4, 1, 0 }, makeTile(1, 100));
+    cache.add({ 4, 2, 0 }, makeTile(2, 100));
+    EXPECT_FALSE(cache.has({ 4, 0, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 1, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 2, 0 }));
+    EXPECT_EQ(200u, cache.getBytes());
+
+    // Adding a tile that is cached already keeps it, as the newest.
+    cache.add({ 4, 1, 0 }, makeTile(1, 50));
+    cache.add({ 4, 3, 0 }, makeTile(3, 100));
+    EXPECT_FALSE(cache.has({ 4, 2, 0 }));
+    EXPECT_EQ(200u, cache.getBytes());
+
+    auto tile = cache.get({ 4, 1, 0 });
+    ASSERT_TRUE(bool(tile));
+    EXPECT_EQ(100u, tile->getByteSize());
+    EXPECT_FALSE(cache.has({ 4, 1, 0 }));
+    EXPECT_EQ(100u, cache.getBytes());
+}
+
+TEST(TileCache, EvictsOldestOverBudget) {
+    TileCache cache { 10 };
+    cache.setMaximumBytes(250);
+
+    cache.add({ 4, 0, 0 }, makeTile(0, 100));
+    cache.add({ 4, 1, 0 }, makeTile(1, 100));
+    cache.add({ 4, 2, 0 }, makeTile(2, 100));
+    EXPECT_FALSE(cache.has({ 4, 0, 0 }));
+    EXPECT_EQ(200u, cache.getBytes());
+
+    // A tile over the budget by itself isn't kept.
+    cache.add({ 4, 3, 0 }, makeTile(3, 300));
+    EXPECT_FALSE(cache.has({ 4, 3, 0 }));
+    EXPECT_EQ(0u, cache.getBytes());
+
+    cache.add({ 4, 0, 0 }, makeTile(0, 100));
+    cache.add({ 4, 1, 0 }, makeTile(1, 100));
+    cache.setMaximumBytes(150);
+    EXPECT_FALSE(cache.has({ 4, 0, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 1, 0 }));
+
+    cache.clear();
+    EXPECT_FALSE(cache.has({ 4, 1, 0 }));
+    EXPECT_EQ(0u, cache.getBytes());
+}
+
+TEST(TileCache, ReleasesRetainedData) {
+    TileCache cache { 10 };
+
+    cache.add({ 4, 0, 0 }, makeTile(0, 100, 40));
+    cache.add({ 4, 1, 0 }, makeTile(1, 100));
+    EXPECT_EQ(200u, cache.getBytes());
+
+    // What the tiles release is no longer counted against the budget.
+    EXPECT_EQ(40u, cache.releaseRetainedData());
+    EXPECT_EQ(160u, cache.getBytes());
+    EXPECT_EQ(0u, cache.releaseRetainedData());
+
+    cache.setMaximumBytes(100);
+    EXPECT_FALSE(cache.has({ 4, 0, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 1, 0 }));
+}
@@ -1,10 +1,16 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/test/fake_file_source.hpp>
 #include <mbgl/tile/vector_tile.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
+#include <mbgl/tile/tile_observer.hpp>
 
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/map/backend_scope.hpp>
 #include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/compression.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/update_parameters.hpp>
@@ -25,8 +31,9 @@ public:
     util::RunLoop loop;
     ThreadPool threadPool { 1 };
     AnnotationManager annotationManager { 1.0 };
-    style::Style style { fileSource, 1.0 };
+    style::Style style { threadPool, fileSource, 1.0 };
     Tileset tileset { { "https://example.com" }, { 0, 22 }, "none" };
+    std::shared_ptr<VectorTileDataCache> dataCache = std::make_shared<VectorTileDataCache>();
 
     style::UpdateParameters updateParameters {
         1.0,
@@ -42,21 +49,21 @@ public:
 
 TEST(VectorTile, setError) {
     VectorTileTest test;
-    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset, test.dataCache);
     tile.setError(std::make_exception_ptr(std::runtime_error("test")));
     EXPECT_FALSE(tile.isRenderable());
 }
 
 TEST(VectorTile, onError) {
     VectorTileTest test;
-    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset, test.dataCache);
     tile.onError(std::make_exception_ptr(std::runtime_error("test")));
     EXPECT_TRUE(tile.isRenderable());
 }
 
 TEST(VectorTile, Issue7615) {
     VectorTileTest test;
-    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset, test.dataCache);
 
     style::SymbolLayer symbolLayer("symbol", "source");
     auto symbolBucket = std::make_shared<SymbolBucket>(
@@ -81,8 +88,195 @@ TEST(VectorTile, Issue7615) {
         {},
         nullptr,
         nullptr,
+        0,
+        Clock::now()
+    });
+
+    EXPECT_EQ(symbolBucket.get(), tile.getBucket(symbolLayer));
+}
+
+TEST(VectorTile, PlacementUpdate) {
+    VectorTileTest test;
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset, test.dataCache);
+
+    style::SymbolLayer symbolLayer("symbol", "source");
+    auto symbolBucket = std::make_shared<SymbolBucket>(
+        style::SymbolLayoutProperties::Evaluated(),
+        std::unordered_map<
+            std::string,
+            std::pair<style::IconPaintProperties::Evaluated, style::TextPaintProperties::Evaluated>>(),
+        0.0f, false, false);
+
+    tile.onPlacement(GeometryTile::PlacementResult {
+        {{
+            symbolLayer.getID(),
+            symbolBucket
+        }},
+        nullptr,
+        0
+    });
+
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+    symbolBucket->upload(backend.getContext());
+    ASSERT_FALSE(symbolBucket->needsUpload());
+
+    // A new placement is uploaded to the existing bucket.
+    tile.onPlacementUpdate(GeometryTile::PlacementUpdate {
+        {{
+            symbolLayer.getID(),
+            std::make_shared<SymbolBucketPlacement>()
+        }},
+        std::make_unique<CollisionTile>(PlacementConfig { 1.0f }),
         0
     });
 
     EXPECT_EQ(symbolBucket.get(), tile.getBucket(symbolLayer));
+    EXPECT_TRUE(symbolBucket->needsUpload());
+}
+
+TEST(VectorTile, SameDataNotLaidOutAgain) {
+    VectorTileTest test;
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset, test.dataCache);
+
+    class Observer : public TileObserver {
+    public:
+        void onTileChanged(Tile& tile_) override {
+            if (tile_.isComplete()) {
+                util::RunLoop::Get()->stop();
+            }
+        }
+    } observer;
+    tile.setObserver(&observer);
+
+    auto buffer = std::make_shared<const std::string>(util::read_file("test/fixtures/map/offline/0-0-0.vector.pbf"));
+    tile.setPlacementConfig({});
+    tile.setData(buffer, {}, {});
+    test.loop.run();
+    ASSERT_TRUE(tile.isComplete());
+
+    // Revalidated data that didn't change only updates the expiry.
+    const Timestamp expires = util::now() + Seconds(60);
+    tile.setData(std::make_shared<const std::string>(*buffer), {}, expires);
+    EXPECT_TRUE(tile.isComplete());
+    EXPECT_EQ(expires, *tile.expires);
+
+    tile.setData(std::make_shared<const std::string>(), {}, {});
+    EXPECT_FALSE(tile.isComplete());
+}
+
+TEST(VectorTile, SharedData) {
+    VectorTileDataCache cache;
+    const CanonicalTileID id { 0, 0, 0 };
+    auto buffer = std::make_shared<const std::string>(util::read_file("test/fixtures/map/offline/0-0-0.vector.pbf"));
+
+    // Tiles loaded for different overscaled IDs share the layers parsed from identical buffers.
+    auto data = cache.get(id, buffer);
+    auto copy = cache.get(id, std::make_shared<const std::string>(*buffer));
+    ASSERT_NE(nullptr, data->getLayer("water"));
+    EXPECT_EQ(data->getLayer("water"), copy->getLayer("water"));
+    EXPECT_EQ(data->getLayer("water"), data->clone()->getLayer("water"));
+    EXPECT_EQ(1u, cache.size());
+
+    // Different data for the same tile, e.g. after it expired, is parsed anew.
+    auto empty = cache.get(id, std::make_shared<const std::string>());
+    EXPECT_EQ(nullptr, empty->getLayer("water"));
+    EXPECT_NE(nullptr, data->getLayer("water"));
+
+    // Entries are dropped along with the last data sharing them.
+    data.reset();
+    copy.reset();
+    empty.reset();
+    auto other = cache.get({ 1, 0, 0 }, buffer);
+    EXPECT_EQ(1u, cache.size());
+}
+
+TEST(VectorTile, SharedDataAcrossSources) {
+    const Tileset tileset { { "https://example.com/{z}/{x}/{y}.pbf" }, { 0, 22 }, "none" };
+    const CanonicalTileID id { 0, 0, 0 };
+    auto buffer = std::make_shared<const std::string>(util::read_file("test/fixtures/map/offline/0-0-0.vector.pbf"));
+
+    // Sources loading the same tiles use the same cache, as long as any of them holds it.
+    auto cache = VectorTileDataCache::shared(tileset);
+    EXPECT_EQ(cache, VectorTileDataCache::shared(tileset));
+    EXPECT_NE(cache, VectorTileDataCache::shared(Tileset { { "https://example.com/other/{z}/{x}/{y}.pbf" }, { 0, 22 }, "none" }));
+
+    auto data = cache->get(id, buffer);
+    auto copy = VectorTileDataCache::shared(tileset)->get(id, std::make_shared<const std::string>(*buffer));
+    ASSERT_NE(nullptr, data->getLayer("water"));
+    EXPECT_EQ(data->getLayer("water"), copy->getLayer("water"));
+
+    // Data outlives the cache it was made by.
+    std::weak_ptr<VectorTileDataCache> weak = cache;
+    cache.reset();
+    EXPECT_TRUE(weak.expired());
+    EXPECT_NE(nullptr, data->getLayer("water"));
+}
+
+TEST(VectorTile, LazyLayers) {
+    VectorTileDataCache cache;
+    auto buffer = std::make_shared<const std::string>(util::read_file("test/fixtures/map/offline/0-0-0.vector.pbf"));
+    auto data = cache.get({ 0, 0, 0 }, buffer);
+
+    // Layers are parsed as they are asked for, once.
+    EXPECT_EQ(nullptr, data->getLayer("nonexistent"));
+    const GeometryTileLayer* water = data->getLayer("water");
+    ASSERT_NE(nullptr, water);
+    EXPECT_EQ("water", water->getName());
+    EXPECT_GT(water->featureCount(), 0u);
+    EXPECT_EQ(water, data->getLayer("water"));
+    EXPECT_EQ(water, data->clone()->getLayer("water"));
+}
+
+TEST(VectorTile, CompressedData) {
+    VectorTileDataCache cache;
+    const std::string raw = util::read_file("test/fixtures/map/offline/0-0-0.vector.pbf");
+    auto buffer = std::make_shared<const std::string>(util::compress(raw, util::tileDictionary()));
+
+    // Data passed along as the cache stored it is inflated when it is first parsed.
+    auto data = cache.get({ 0, 0, 0 }, buffer, util::Compression::DeflateWithTileDictionary);
+    ASSERT_NE(nullptr, data->getLayer("water"));
+    EXPECT_EQ(data->getLayer("water"), data->clone()->getLayer("water"));
+    ASSERT_NE(nullptr, data->unparsed()->getLayer("water"));
+
+    // The same tile received uncompressed is parsed anew.
+    auto plain = cache.get({ 0, 0, 0 }, std::make_shared<const std::string>(raw));
+    EXPECT_NE(data->getLayer("water"), plain->getLayer("water"));
+    EXPECT_EQ(data->getLayer("water")->featureCount(), plain->getLayer("water")->featureCount());
+}
+
+TEST(VectorTile, UnparsedData) {
+    VectorTileDataCache cache;
+    auto buffer = std::make_shared<const std::string>(util::read_file("test/fixtures/map/offline/0-0-0.vector.pbf"));
+    auto data = cache.get({ 0, 0, 0 }, buffer);
+    ASSERT_NE(nullptr, data->getLayer("water"));
+
+    // Unparsed copies parse the same layers again, without sharing them.
+    auto unparsed = data->unparsed();
+    ASSERT_NE(nullptr, unparsed);
+    ASSERT_NE(nullptr, unparsed->getLayer("water"));
+    EXPECT_NE(data->getLayer("water"), unparsed->getLayer("water"));
+    EXPECT_EQ(data->getLayer("water")->featureCount(), unparsed->getLayer("water")->featureCount());
+
+    // They don't keep the layers of the cache alive.
+    data.reset();
+    cache.get({ 1, 0, 0 }, buffer);
+    EXPECT_EQ(1u, cache.size());
+}
+
+TEST(VectorTile, Timeline) {
+    VectorTileTest test;
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset, test.dataCache);
+    EXPECT_FALSE(tile.timeline.requested);
+
+    tile.setNecessity(Tile::Necessity::Required);
+    ASSERT_TRUE(tile.timeline.requested);
+    EXPECT_FALSE(tile.timeline.responded);
+
+    Response response;
+    response.noContent = true;
+    test.fileSource.respond(Resource::Kind::Tile, response);
+    ASSERT_TRUE(tile.timeline.responded);
+    EXPECT_LE(*tile.timeline.requested, *tile.timeline.responded);
+    EXPECT_FALSE(tile.timeline.fromCache);
 }
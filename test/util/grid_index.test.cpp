@@ -0,0 +1,35 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/util/grid_index.hpp>
+
+using namespace mbgl;
+
+TEST(GridIndex, Query) {
+    GridIndex<IndexedSubfeature> grid(100, 10, 0);
+    grid.insert(IndexedSubfeature { 0, "roads", "road-label", 0 }, { { 5, 5 }, { 45, 8 } });
+    grid.insert(IndexedSubfeature { 1, "roads", "road-label", 1 }, { { 50, 50 }, { 55, 55 } });
+    grid.insert(IndexedSubfeature { 2, "water", "water", 2 }, { { 0, 0 }, { 100, 100 } });
+
+    // Elements spanning several cells are only visited once.
+    std::vector<std::size_t> visited;
+    grid.query({ { 0, 0 }, { 40, 40 } }, [&] (const IndexedSubfeature& feature) {
+        visited.push_back(feature.index);
+        return true;
+    });
+    EXPECT_EQ((std::vector<std::size_t> { 0, 2 }), visited);
+
+    const auto result = grid.query({ { 0, 0 }, { 40, 40 } });
+    ASSERT_EQ(2u, result.size());
+    EXPECT_EQ("road-label", result[0].bucketName());
+    EXPECT_EQ("water", result[1].sourceLayerName());
+    EXPECT_EQ(result[0].sourceLayerID, IndexedSubfeature(1, "roads", "", 0).sourceLayerID);
+
+    // Returning false ends the query.
+    visited.clear();
+    grid.query({ { 0, 0 }, { 100, 100 } }, [&] (const IndexedSubfeature& feature) {
+        visited.push_back(feature.index);
+        return false;
+    });
+    EXPECT_EQ(1u, visited.size());
+}
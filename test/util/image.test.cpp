@@ -4,6 +4,8 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
 
+#include <algorithm>
+
 using namespace mbgl;
 
 TEST(Image, PNGRoundTrip) {
@@ -50,6 +52,14 @@ TEST(Image, PNGReadNoProfileAlpha) {
     EXPECT_EQ(128, image.data[3]);
 }
 
+TEST(Image, PNGReadNoProfileAlphaUnassociated) {
+    UnassociatedImage image = decodeUnassociatedImage(util::read_file("test/fixtures/image/no_profile_alpha.png"));
+    EXPECT_EQ(128, image.data[0]);
+    EXPECT_EQ(0, image.data[1]);
+    EXPECT_EQ(0, image.data[2]);
+    EXPECT_EQ(128, image.data[3]);
+}
+
 TEST(Image, PNGReadProfile) {
     PremultipliedImage image = decodeImage(util::read_file("test/fixtures/image/profile.png"));
     EXPECT_EQ(128, image.data[0]);
@@ -72,6 +82,19 @@ TEST(Image, PNGTile) {
     EXPECT_EQ(256u, image.size.height);
 }
 
+TEST(Image, DecodeIntoImage) {
+    const std::string png = util::read_file("test/fixtures/image/tile.png");
+    const PremultipliedImage expected = decodeImage(png);
+
+    // Images of the same size are decoded over, and others replaced.
+    for (const Size size : { Size(256, 256), Size(512, 512), Size() }) {
+        PremultipliedImage image(size);
+        decodeImage(png, image);
+        ASSERT_EQ(expected.size, image.size);
+        EXPECT_TRUE(std::equal(expected.data.get(), expected.data.get() + expected.bytes(), image.data.get()));
+    }
+}
+
 TEST(Image, JPEGTile) {
     PremultipliedImage image = decodeImage(util::read_file("test/fixtures/image/tile.jpeg"));
     EXPECT_EQ(256u, image.size.width);
@@ -84,6 +107,15 @@ TEST(Image, WebPTile) {
     EXPECT_EQ(256u, image.size.width);
     EXPECT_EQ(256u, image.size.height);
 }
+
+TEST(Image, ScaledTile) {
+    // Decoders that scale images down keep them at least as large as they're asked to.
+    for (const auto& path : { "test/fixtures/image/tile.jpeg", "test/fixtures/image/tile.webp" }) {
+        UnassociatedImage image = decodeUnassociatedImage(util::read_file(path), { 100, 100 });
+        EXPECT_TRUE(image.size == Size(128, 128) || image.size == Size(256, 256)) << path;
+        EXPECT_EQ(Size(256, 256), decodeUnassociatedImage(util::read_file(path), { 256, 256 }).size) << path;
+    }
+}
 #endif // !defined(__ANDROID__) && !defined(__APPLE__) && !defined(QT_IMAGE_DECODERS)
 
 TEST(Image, Copy) {
@@ -128,3 +160,35 @@ TEST(Image, Premultiply) {
     EXPECT_EQ(127, image.data[2]);
     EXPECT_EQ(128, image.data[3]);
 }
+
+TEST(Image, PremultiplyEveryValue) {
+    // Every color with every alpha, over enough pixels for vector kernels to leave some over.
+    UnassociatedImage rgba({ 257, 256 });
+    for (uint32_t i = 0; i < 257 * 256; ++i) {
+        rgba.data[4 * i + 0] = i % 256;
+        rgba.data[4 * i + 1] = 255 - i % 256;
+        rgba.data[4 * i + 2] = i % 256 / 2;
+        rgba.data[4 * i + 3] = i / 256 % 256;
+    }
+    UnassociatedImage original({ 257, 256 }, rgba.data.get(), rgba.bytes());
+
+    PremultipliedImage image = util::premultiply(std::move(rgba));
+    for (std::size_t i = 0; i < image.bytes(); i += 4) {
+        const uint8_t a = original.data[i + 3];
+        for (std::size_t c = 0; c < 3; ++c) {
+            ASSERT_EQ((original.data[i + c] * a + 127) / 255, image.data[i + c]);
+        }
+        ASSERT_EQ(a, image.data[i + 3]);
+    }
+
+    PremultipliedImage premultiplied({ 257, 256 }, original.data.get(), original.bytes());
+    UnassociatedImage result = util::unpremultiply(std::move(premultiplied));
+    for (std::size_t i = 0; i < result.bytes(); i += 4) {
+        const uint8_t a = original.data[i + 3];
+        for (std::size_t c = 0; c < 3; ++c) {
+            const uint8_t color = original.data[i + c];
+            ASSERT_EQ(a ? uint8_t((255 * color + a / 2) / a) : color, result.data[i + c]);
+        }
+        ASSERT_EQ(a, result.data[i + 3]);
+    }
+}
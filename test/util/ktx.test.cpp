@@ -0,0 +1,68 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/ktx.hpp>
+
+#include <cstring>
+
+using namespace mbgl;
+
+namespace {
+
+constexpr uint32_t GL_COMPRESSED_RGB8_ETC2 = 0x9274;
+
+// A container of an ETC2 texture, 8 by 4 pixels, with the given levels of 8 bytes per 4x4 block.
+std::string ktx(std::vector<std::string> levels, std::string keyValueData = "") {
+    std::string result("\xABKTX 11\xBB\r\n\x1A\n", 12);
+    auto write = [&] (uint32_t value) {
+        result.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    write(0x04030201);
+    write(0); // glType
+    write(1); // glTypeSize
+    write(0); // glFormat
+    write(GL_COMPRESSED_RGB8_ETC2);
+    write(0x1907); // GL_RGB
+    write(8);
+    write(4);
+    write(0);
+    write(0);
+    write(1);
+    write(levels.size());
+    write(keyValueData.size());
+    result += keyValueData;
+    for (const auto& level : levels) {
+        write(level.size());
+        result += level;
+        result.append((4 - level.size() % 4) % 4, '\0');
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(KTX, Decode) {
+    auto data = std::make_shared<const std::string>(ktx({ std::string(16, 'a'), std::string(8, 'b') }, "abcd"));
+    ASSERT_TRUE(isKTX(*data));
+
+    CompressedImage image = decodeKTX(data);
+    EXPECT_EQ(GL_COMPRESSED_RGB8_ETC2, image.format);
+    EXPECT_EQ(Size(8, 4), image.size);
+    ASSERT_EQ(2u, image.levels.size());
+    EXPECT_EQ(std::string(16, 'a'), std::string(reinterpret_cast<const char*>(image.levels[0].data), image.levels[0].size));
+    EXPECT_EQ(std::string(8, 'b'), std::string(reinterpret_cast<const char*>(image.levels[1].data), image.levels[1].size));
+    EXPECT_EQ(data, image.container);
+}
+
+TEST(KTX, Invalid) {
+    EXPECT_FALSE(isKTX("\x89PNG\r\n\x1A\n"));
+    EXPECT_THROW(decodeKTX(std::make_shared<const std::string>("\xABKTX 11\xBB\r\n\x1A\n")), std::runtime_error);
+
+    std::string truncated = ktx({ std::string(16, 'a') });
+    truncated.resize(truncated.size() - 1);
+    EXPECT_THROW(decodeKTX(std::make_shared<const std::string>(truncated)), std::runtime_error);
+
+    // Uncompressed textures have a type.
+    std::string uncompressed = ktx({ std::string(16, 'a') });
+    uncompressed[16] = 1;
+    EXPECT_THROW(decodeKTX(std::make_shared<const std::string>(uncompressed)), std::runtime_error);
+}
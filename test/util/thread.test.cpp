@@ -60,6 +60,15 @@ public:
         cb(tid == std::this_thread::get_id());
     }
 
+    int square(int val) {
+        EXPECT_EQ(tid, std::this_thread::get_id());
+        return val * val;
+    }
+
+    void fail() {
+        throw std::runtime_error("failed");
+    }
+
     const std::thread::id tid;
 };
 
@@ -131,6 +140,87 @@ TEST(Thread, context) {
     loop.run();
 }
 
+TEST(Thread, invokeAsync) {
+    const std::thread::id tid = std::this_thread::get_id();
+
+    RunLoop loop;
+    Thread<TestObject> thread({"Test"}, tid);
+
+    auto result = thread.invokeAsync(&TestObject::square, 3)
+        .then([&] (int val) {
+            EXPECT_EQ(tid, std::this_thread::get_id());
+            return std::make_unique<int>(val + 1);
+        })
+        .then([&] (std::unique_ptr<int> val) {
+            EXPECT_EQ(tid, std::this_thread::get_id());
+            EXPECT_EQ(*val, 10);
+            loop.stop();
+        });
+
+    loop.run();
+    EXPECT_TRUE(result.ready());
+}
+
+TEST(Thread, invokeAsyncChained) {
+    const std::thread::id tid = std::this_thread::get_id();
+
+    RunLoop loop;
+    Thread<TestObject> thread({"Test"}, tid);
+
+    auto result = thread.invokeAsync(&TestObject::square, 2)
+        .then([&] (int val) {
+            return thread.invokeAsync(&TestObject::square, val);
+        })
+        .then([&] (int val) {
+            EXPECT_EQ(val, 16);
+            loop.stop();
+        });
+
+    loop.run();
+}
+
+TEST(Thread, invokeAsyncError) {
+    const std::thread::id tid = std::this_thread::get_id();
+
+    RunLoop loop;
+    Thread<TestObject> thread({"Test"}, tid);
+
+    auto result = thread.invokeAsync(&TestObject::fail)
+        .then([&] {
+            ADD_FAILURE() << "Should not run after an error";
+            return 1;
+        })
+        .catchError([&] (std::exception_ptr error) {
+            EXPECT_EQ(tid, std::this_thread::get_id());
+            EXPECT_THROW(std::rethrow_exception(error), std::runtime_error);
+            return 2;
+        })
+        .then([&] (int val) {
+            EXPECT_EQ(val, 2);
+            loop.stop();
+        });
+
+    loop.run();
+}
+
+TEST(Thread, invokeAsyncCancel) {
+    const std::thread::id tid = std::this_thread::get_id();
+
+    RunLoop loop;
+    Thread<TestObject> thread({"Test"}, tid);
+
+    // Dropping the Async cancels the continuation, but not the invocation.
+    thread.invokeAsync(&TestObject::square, 1).then([&] (int) {
+        ADD_FAILURE() << "Cancelled continuation should not run";
+    });
+
+    auto result = thread.invokeAsync(&TestObject::square, 2).then([&] (int) {
+        loop.stop();
+    });
+
+    loop.run();
+}
+
 class TestWorker {
 public:
     TestWorker() = default;
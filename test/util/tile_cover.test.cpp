@@ -4,6 +4,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 using namespace mbgl;
 
 TEST(TileCover, Empty) {
@@ -41,6 +43,36 @@ TEST(TileCover, Pitch) {
               util::tileCover(transform.getState(), 2));
 }
 
+TEST(TileCover, PitchedLevelOfDetail) {
+    Transform transform;
+    transform.resize({ 1024, 768 });
+    transform.setLatLng({ 37.7749, -122.4194 });
+    transform.setZoom(14);
+
+    // A flat view is covered at one zoom level.
+    EXPECT_EQ(util::tileCover(transform.getState(), 14),
+              util::tileCover(transform.getState(), 14, 0, 1));
+
+    transform.setPitch(60.0 * M_PI / 180.0);
+    const auto full = util::tileCover(transform.getState(), 14);
+    const auto cover = util::tileCover(transform.getState(), 14, 0, 1);
+    EXPECT_LT(cover.size(), full.size());
+    EXPECT_EQ(full.front(), cover.front());
+
+    // Each tile of the full cover is covered by exactly one tile, of its zoom level or lower.
+    for (const auto& id : full) {
+        EXPECT_EQ(1, std::count_if(cover.begin(), cover.end(), [&] (const UnwrappedTileID& lod) {
+            return lod == id || id.isChildOf(lod);
+        }));
+    }
+    EXPECT_TRUE(std::any_of(cover.begin(), cover.end(), [] (const UnwrappedTileID& id) {
+        return id.canonical.z < 14;
+    }));
+
+    // Allowing no error keeps the zoom level everywhere.
+    EXPECT_EQ(full, util::tileCover(transform.getState(), 14, 0, 0));
+}
+
 TEST(TileCover, WorldZ1) {
     EXPECT_EQ((std::vector<UnwrappedTileID>{
                   { 1, 0, 0 }, { 1, 0, 1 }, { 1, 1, 0 }, { 1, 1, 1 },
@@ -83,3 +115,31 @@ TEST(TileCover, SanFranciscoZ0Wrapped) {
     EXPECT_EQ((std::vector<UnwrappedTileID>{ { 0, 1, 0 } }),
               util::tileCover(sanFranciscoWrapped, 0));
 }
+
+TEST(TileCover, Count) {
+    for (int32_t z = 0; z <= 16; z++) {
+        EXPECT_EQ(util::tileCover(sanFrancisco, z).size(), util::tileCount(sanFrancisco, z)) << z;
+        EXPECT_EQ(util::tileCover(sanFranciscoWrapped, z).size(), util::tileCount(sanFranciscoWrapped, z)) << z;
+    }
+    EXPECT_EQ(0u, util::tileCount(LatLngBounds::empty(), 4));
+    EXPECT_EQ(1ull << 40, util::tileCount(LatLngBounds::world(), 20));
+}
+
+TEST(TileCover, Iterator) {
+    std::vector<UnwrappedTileID> expected = util::tileCover(sanFrancisco, 10);
+    for (const auto& tile : util::tileCover(sanFrancisco, 11)) {
+        expected.push_back(tile);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<UnwrappedTileID> tiles;
+    util::TileCover cover(sanFrancisco, 10, 11);
+    while (optional<UnwrappedTileID> tile = cover.next()) {
+        tiles.push_back(*tile);
+    }
+    std::sort(tiles.begin(), tiles.end());
+
+    EXPECT_EQ(expected, tiles);
+    EXPECT_FALSE(bool(cover.next()));
+    EXPECT_FALSE(bool(util::TileCover(LatLngBounds::empty(), 0, 4).next()));
+}
@@ -48,3 +48,24 @@ TEST(Token, replaceTokens) {
         return "";
     }));
 }
+
+TEST(Token, TokenString) {
+    const auto lookup = [](const std::string& token) -> std::string {
+        if (token == "name") return "14th St NW";
+        if (token == "ref") return "US 29";
+        return "";
+    };
+
+    EXPECT_FALSE(mbgl::util::TokenString("literal").hasTokens());
+    EXPECT_EQ("literal", mbgl::util::TokenString("literal").replace(lookup));
+    EXPECT_EQ("", mbgl::util::TokenString("").replace(lookup));
+
+    const mbgl::util::TokenString string("{ref}: {name} {unset}!");
+    EXPECT_TRUE(string.hasTokens());
+    EXPECT_EQ("US 29: 14th St NW !", string.replace(lookup));
+
+    // Unclosed or nested braces are left as they are, as by replaceTokens.
+    for (const std::string source : { "{name", "{{name}}", "{na{me}", "}{name}{", "{}" }) {
+        EXPECT_EQ(mbgl::util::replaceTokens(source, lookup), mbgl::util::TokenString(source).replace(lookup));
+    }
+}
@@ -0,0 +1,84 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/varint.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+static void encode(std::string& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+static uint32_t zigzag(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+TEST(Varint, Decode) {
+    std::mt19937 random(1);
+    std::vector<uint32_t> values;
+
+    // Mix long runs of single-byte values, which take the vectorized path, with larger ones.
+    for (int i = 0; i < 1000; ++i) {
+        const uint32_t bits = i % 50 < 40 ? 7 : random() % 32 + 1;
+        values.push_back(bits == 32 ? random() : random() % (1u << bits));
+    }
+
+    std::string encoded;
+    for (uint32_t value : values) {
+        encode(encoded, value);
+    }
+
+    std::vector<uint32_t> decoded(values.size());
+    const char* data = encoded.data();
+    const char* end = data + encoded.size();
+    ASSERT_EQ(values.size(), util::decodeVarints(data, end, decoded.data(), decoded.size()));
+    EXPECT_EQ(end, data);
+    EXPECT_EQ(values, decoded);
+}
+
+TEST(Varint, DecodeTruncated) {
+    std::string encoded;
+    encode(encoded, 1);
+    encode(encoded, 300);
+    encoded.pop_back();
+
+    uint32_t decoded[2];
+    const char* data = encoded.data();
+    EXPECT_EQ(1u, util::decodeVarints(data, data + encoded.size(), decoded, 2));
+    EXPECT_EQ(1u, decoded[0]);
+}
+
+TEST(Varint, AccumulateDeltas) {
+    std::mt19937 random(2);
+    std::vector<int32_t> expected;
+    std::vector<uint32_t> deltas;
+
+    int32_t x = 100;
+    int32_t y = -100;
+    for (int i = 0; i < 37; ++i) {
+        const int32_t dx = static_cast<int32_t>(random() % 8192) - 4096;
+        const int32_t dy = static_cast<int32_t>(random() % 8192) - 4096;
+        deltas.push_back(zigzag(dx));
+        deltas.push_back(zigzag(dy));
+        x += dx;
+        y += dy;
+        expected.push_back(x);
+        expected.push_back(y);
+    }
+
+    int32_t ax = 100;
+    int32_t ay = -100;
+    std::vector<int32_t> positions(expected.size());
+    util::accumulateDeltas(deltas.data(), deltas.size() / 2, ax, ay, positions.data());
+
+    EXPECT_EQ(expected, positions);
+    EXPECT_EQ(x, ax);
+    EXPECT_EQ(y, ay);
+}
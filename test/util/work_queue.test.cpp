@@ -42,6 +42,21 @@ TEST(WorkQueue, push) {
     loop.run();
 }
 
+TEST(WorkQueue, pushAsync) {
+    RunLoop loop;
+
+    WorkQueue queue;
+
+    auto result = queue.pushAsync([] {
+        return std::make_unique<int>(42);
+    }).then([&] (std::unique_ptr<int> val) {
+        EXPECT_EQ(*val, 42);
+        loop.stop();
+    });
+
+    loop.run();
+}
+
 TEST(WorkQueue, cancel) {
     RunLoop loop;
 